@@ -239,6 +239,9 @@ int ogs_app_parse_global_conf(ogs_yaml_iter_t *parent)
                             "no_time_zone_information")) {
                     global_conf.parameter.no_time_zone_information =
                         ogs_yaml_iter_bool(&parameter_iter);
+                } else if (!strcmp(parameter_key, "timer_wheel")) {
+                    global_conf.parameter.timer_wheel =
+                        ogs_yaml_iter_bool(&parameter_iter);
                 } else
                     ogs_warn("unknown key `%s`", parameter_key);
             }
@@ -715,6 +718,27 @@ int ogs_app_parse_sockopt_config(
         } else if (!strcmp(sockopt_key, "so_bindtodevice")) {
             option->so_bindtodevice = ogs_yaml_iter_value(&sockopt_iter);
 
+        } else if (!strcmp(sockopt_key, "mmsg_batch")) {
+            const char *v = ogs_yaml_iter_value(&sockopt_iter);
+            if (v) option->mmsg_batch = atoi(v);
+            if (option->mmsg_batch < 0 ||
+                option->mmsg_batch > OGS_MAX_NUM_OF_SOCKMSG) {
+                ogs_error("mmsg_batch[%d] should be 0..%d",
+                        option->mmsg_batch, OGS_MAX_NUM_OF_SOCKMSG);
+                return OGS_ERROR;
+            }
+
+        } else if (!strcmp(sockopt_key, "packet_ring")) {
+            const char *v = ogs_yaml_iter_value(&sockopt_iter);
+            if (!v || !strcmp(v, "none")) {
+                option->packet_ring = OGS_PACKET_RING_NONE;
+            } else if (!strcmp(v, "tpacket")) {
+                option->packet_ring = OGS_PACKET_RING_TPACKET;
+            } else {
+                ogs_error("packet_ring[%s] should be none or tpacket", v);
+                return OGS_ERROR;
+            }
+
         } else {
             ogs_error("unknown key `%s`", sockopt_key);
             return OGS_ERROR;
@@ -63,6 +63,9 @@ typedef struct ogs_global_conf_s {
 
         int no_pfcp_rr_select;
         int no_time_zone_information;
+
+        /* Timer */
+        int timer_wheel;
     } parameter;
 
     struct {
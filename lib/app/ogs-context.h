@@ -45,6 +45,7 @@ typedef struct ogs_app_context_s {
         const char *level;
         const char *domain;
         ogs_log_ts_e timestamp;
+        int async;
     } logger;
 
     ogs_queue_t *queue;
@@ -117,6 +117,14 @@ int ogs_app_initialize(
     ogs_log_set_timestamp(ogs_app()->logger_default.timestamp,
                           ogs_app()->logger.timestamp);
 
+    if (ogs_app()->logger.async) {
+        rv = ogs_log_async_start();
+        if (rv != OGS_OK) {
+            ogs_error("ogs_log_async_start() failed");
+            ogs_app()->logger.async = 0;
+        }
+    }
+
     /**************************************************************************
      * Stage 5 : Setup Database Module
      */
@@ -148,7 +156,11 @@ int ogs_app_initialize(
      */
     ogs_app()->queue = ogs_queue_create(ogs_app()->pool.event);
     ogs_assert(ogs_app()->queue);
-    ogs_app()->timer_mgr = ogs_timer_mgr_create(ogs_app()->pool.timer);
+    if (ogs_global_conf()->parameter.timer_wheel)
+        ogs_app()->timer_mgr =
+            ogs_timer_mgr_create_wheel(ogs_app()->pool.timer);
+    else
+        ogs_app()->timer_mgr = ogs_timer_mgr_create(ogs_app()->pool.timer);
     ogs_assert(ogs_app()->timer_mgr);
     ogs_app()->pollset = ogs_pollset_create(ogs_app()->pool.socket);
     ogs_assert(ogs_app()->pollset);
@@ -158,6 +170,8 @@ int ogs_app_initialize(
 
 void ogs_app_terminate(void)
 {
+    ogs_log_async_stop();
+
     ogs_app_config_final();
     ogs_app_context_final();
 
@@ -339,6 +353,9 @@ static int parse_config(void)
                 } else if (!strcmp(logger_key, "domain")) {
                     ogs_app()->logger.domain =
                         ogs_yaml_iter_value(&logger_iter);
+                } else if (!strcmp(logger_key, "async")) {
+                    ogs_app()->logger.async =
+                        ogs_yaml_iter_bool(&logger_iter);
                 }
             }
         } else if (!strcmp(root_key, "global")) {
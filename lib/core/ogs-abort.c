@@ -44,12 +44,16 @@ OGS_GNUC_NORETURN void ogs_abort(void)
         free(strings);
     }
 
+    /* Lines logged by other threads meanwhile */
+    ogs_log_async_flush();
+
     abort();
 #elif defined(_WIN32)
     DebugBreak();
     abort();
     ExitProcess(127);
 #else
+    ogs_log_async_flush();
     abort();
 #endif
 }
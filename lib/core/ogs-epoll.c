@@ -33,6 +33,7 @@ static void epoll_cleanup(ogs_pollset_t *pollset);
 static int epoll_add(ogs_poll_t *poll);
 static int epoll_remove(ogs_poll_t *poll);
 static int epoll_process(ogs_pollset_t *pollset, ogs_time_t timeout);
+static int epoll_rearm(ogs_poll_t *poll);
 
 const ogs_pollset_actions_t ogs_epoll_actions = {
     epoll_init,
@@ -43,6 +44,7 @@ const ogs_pollset_actions_t ogs_epoll_actions = {
     epoll_process,
 
     ogs_notify_pollset,
+    epoll_rearm,
 };
 
 struct epoll_map_s {
@@ -50,13 +52,63 @@ struct epoll_map_s {
     ogs_poll_t *write;
 };
 
+/*
+ * The maps are indexed by fd, so an event is dispatched
+ * without any lookup. The array grows when a larger fd is added.
+ */
 struct epoll_context_s {
     int epfd;
 
-    ogs_hash_t *map_hash;
+    struct epoll_map_s *map_list;
+    int num_of_map;
     struct epoll_event *event_list;
 };
 
+static struct epoll_map_s *epoll_map(
+        struct epoll_context_s *context, ogs_socket_t fd)
+{
+    struct epoll_map_s *map_list = NULL;
+    int num_of_map;
+
+    if (fd < context->num_of_map)
+        return &context->map_list[fd];
+
+    num_of_map = context->num_of_map;
+    while (num_of_map <= fd)
+        num_of_map *= 2;
+
+    map_list = ogs_realloc(context->map_list,
+            num_of_map * sizeof(struct epoll_map_s));
+    if (!map_list) {
+        ogs_error("ogs_realloc() failed");
+        return NULL;
+    }
+    memset(&map_list[context->num_of_map], 0,
+            (num_of_map - context->num_of_map) * sizeof(struct epoll_map_s));
+
+    context->map_list = map_list;
+    context->num_of_map = num_of_map;
+
+    return &context->map_list[fd];
+}
+
+static uint32_t epoll_map_events(struct epoll_map_s *map)
+{
+    uint32_t events = 0;
+
+    if (map->read)
+        events |= (EPOLLIN|EPOLLRDHUP);
+    if (map->write)
+        events |= EPOLLOUT;
+
+    /* Edge-triggered only if every poll on the fd asks for it */
+    if ((!map->read || (map->read->when & OGS_POLLET)) &&
+        (!map->write || (map->write->when & OGS_POLLET)))
+        events |= EPOLLET;
+
+    return events;
+}
+
 static void epoll_init(ogs_pollset_t *pollset)
 {
     struct epoll_context_s *context = NULL;
@@ -70,8 +122,10 @@ static void epoll_init(ogs_pollset_t *pollset)
             pollset->capacity, sizeof(struct epoll_event));
     ogs_assert(context->event_list);
 
-    context->map_hash = ogs_hash_make();
-    ogs_assert(context->map_hash);
+    context->num_of_map = ogs_max(pollset->capacity, 64);
+    context->map_list = ogs_calloc(
+            context->num_of_map, sizeof(struct epoll_map_s));
+    ogs_assert(context->map_list);
 
     context->epfd = epoll_create(pollset->capacity);
     if (context->epfd < 0) {
@@ -94,7 +148,7 @@ static void epoll_cleanup(ogs_pollset_t *pollset)
     ogs_notify_final(pollset);
     close(context->epfd);
     ogs_free(context->event_list);
-    ogs_hash_destroy(context->map_hash);
+    ogs_free(context->map_list);
 
     ogs_free(context);
 }
@@ -113,19 +167,14 @@ static int epoll_add(ogs_poll_t *poll)
     context = pollset->context;
     ogs_assert(context);
 
-    map = ogs_hash_get(context->map_hash, &poll->fd, sizeof(poll->fd));
-    if (!map) {
-        map = ogs_calloc(1, sizeof(*map));
-        if (!map) {
-            ogs_error("ogs_calloc() failed");
-            return OGS_ERROR;
-        }
+    map = epoll_map(context, poll->fd);
+    if (!map)
+        return OGS_ERROR;
 
+    if (!map->read && !map->write)
         op = EPOLL_CTL_ADD;
-        ogs_hash_set(context->map_hash, &poll->fd, sizeof(poll->fd), map);
-    } else {
+    else
         op = EPOLL_CTL_MOD;
-    }
 
     if (poll->when & OGS_POLLIN)
         map->read = poll;
@@ -134,17 +183,17 @@ static int epoll_add(ogs_poll_t *poll)
 
     memset(&ee, 0, sizeof ee);
 
-    ee.events = 0;
-    if (map->read)
-        ee.events |= (EPOLLIN|EPOLLRDHUP);
-    if (map->write)
-        ee.events |= EPOLLOUT;
+    ee.events = epoll_map_events(map);
     ee.data.fd = poll->fd;
 
     rv = epoll_ctl(context->epfd, op, poll->fd, &ee);
     if (rv < 0) {
         ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
                 "epoll_ctl[%d] failed", op);
+        if (poll->when & OGS_POLLIN)
+            map->read = NULL;
+        if (poll->when & OGS_POLLOUT)
+            map->write = NULL;
         return OGS_ERROR;
     }
 
@@ -165,8 +214,8 @@ static int epoll_remove(ogs_poll_t *poll)
     context = pollset->context;
     ogs_assert(context);
 
-    map = ogs_hash_get(context->map_hash, &poll->fd, sizeof(poll->fd));
-    ogs_assert(map);
+    ogs_assert(poll->fd < context->num_of_map);
+    map = &context->map_list[poll->fd];
 
     if (poll->when & OGS_POLLIN)
         map->read = NULL;
@@ -175,21 +224,13 @@ static int epoll_remove(ogs_poll_t *poll)
 
     memset(&ee, 0, sizeof ee);
 
-    ee.events = 0;
-    if (map->read)
-        ee.events |= (EPOLLIN|EPOLLRDHUP);
-    if (map->write)
-        ee.events |= EPOLLOUT;
-
     if (map->read || map->write) {
         op = EPOLL_CTL_MOD;
+        ee.events = epoll_map_events(map);
         ee.data.fd = poll->fd;
     } else {
         op = EPOLL_CTL_DEL;
         ee.data.fd = INVALID_SOCKET;
-
-        ogs_hash_set(context->map_hash, &poll->fd, sizeof(poll->fd), NULL);
-        ogs_free(map);
     }
 
     rv = epoll_ctl(context->epfd, op, poll->fd, &ee);
@@ -202,6 +243,41 @@ static int epoll_remove(ogs_poll_t *poll)
     return OGS_OK;
 }
 
+/*
+ * EPOLL_CTL_MOD checks the fd again, so an edge-triggered fd
+ * that is still readable is reported by the next epoll_wait().
+ */
+static int epoll_rearm(ogs_poll_t *poll)
+{
+    int rv;
+    ogs_pollset_t *pollset = NULL;
+    struct epoll_context_s *context = NULL;
+    struct epoll_map_s *map = NULL;
+    struct epoll_event ee;
+
+    ogs_assert(poll);
+    pollset = poll->pollset;
+    ogs_assert(pollset);
+    context = pollset->context;
+    ogs_assert(context);
+
+    ogs_assert(poll->fd < context->num_of_map);
+    map = &context->map_list[poll->fd];
+
+    memset(&ee, 0, sizeof ee);
+    ee.events = epoll_map_events(map);
+    ee.data.fd = poll->fd;
+
+    rv = epoll_ctl(context->epfd, EPOLL_CTL_MOD, poll->fd, &ee);
+    if (rv < 0) {
+        ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
+                "epoll_rearm failed");
+        return OGS_ERROR;
+    }
+
+    return OGS_OK;
+}
+
 static int epoll_process(ogs_pollset_t *pollset, ogs_time_t timeout)
 {
     struct epoll_context_s *context = NULL;
@@ -267,9 +343,9 @@ static int epoll_process(ogs_pollset_t *pollset, ogs_time_t timeout)
 
         fd = context->event_list[i].data.fd;
         ogs_assert(fd != INVALID_SOCKET);
+        ogs_assert(fd < context->num_of_map);
 
-        map = ogs_hash_get(context->map_hash, &fd, sizeof(fd));
-        if (!map) continue;
+        map = &context->map_list[fd];
 
         if (map->read && map->write && map->read == map->write) {
             map->read->handler(when, map->read->fd, map->read->data);
@@ -278,11 +354,10 @@ static int epoll_process(ogs_pollset_t *pollset, ogs_time_t timeout)
                 map->read->handler(when, map->read->fd, map->read->data);
 
             /*
-             * map->read->handler() can call ogs_remove_epoll()
-             * So, we need to check map instance
+             * map->read->handler() can remove the poll or add another fd,
+             * which may move the map list. So, we need to look it up again
              */
-            map = ogs_hash_get(context->map_hash, &fd, sizeof(fd));
-            if (!map) continue;
+            map = &context->map_list[fd];
 
             if ((when & OGS_POLLOUT) && map->write)
                 map->write->handler(when, map->write->fd, map->write->data);
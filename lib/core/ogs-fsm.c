@@ -147,3 +147,32 @@ void ogs_fsm_fini(void *fsm, void *event)
 
     sm->init = sm->state = sm->fini = NULL;
 }
+
+int ogs_fsm_dispatch_queue(void *fsm, ogs_queue_t *queue, void *event_free)
+{
+    ogs_fsm_event_free_t free_func = event_free;
+    int rv, i;
+
+    ogs_assert(fsm);
+    ogs_assert(queue);
+    ogs_assert(free_func);
+
+    for ( ;; ) {
+        void *e[OGS_QUEUE_MAX_BATCH];
+
+        rv = ogs_queue_trypop_batch(queue, e, OGS_QUEUE_MAX_BATCH);
+        ogs_assert(rv != OGS_ERROR);
+
+        if (rv == OGS_DONE)
+            return OGS_DONE;
+
+        if (rv == OGS_RETRY)
+            return OGS_OK;
+
+        for (i = 0; i < rv; i++) {
+            ogs_assert(e[i]);
+            ogs_fsm_dispatch(fsm, e[i]);
+            (*free_func)(e[i]);
+        }
+    }
+}
@@ -39,6 +39,7 @@ typedef enum {
 } ogs_fsm_signal_e;
 
 typedef void (*ogs_fsm_handler_t)(void *sm, void *event);
+typedef void (*ogs_fsm_event_free_t)(void *event);
 
 typedef struct _ogs_fsm_t {
     ogs_fsm_handler_t init;
@@ -51,6 +52,13 @@ void ogs_fsm_tran(void *fsm, void *state, void *event);
 void ogs_fsm_dispatch(void *fsm, void *event);
 void ogs_fsm_fini(void *fsm, void *event);
 
+/*
+ * Dispatch the events waiting in the queue, OGS_QUEUE_MAX_BATCH at a time,
+ * and free each one with event_free(). Returns OGS_DONE once the queue
+ * is terminated, OGS_OK when it is empty.
+ */
+int ogs_fsm_dispatch_queue(void *fsm, ogs_queue_t *queue, void *event_free);
+
 #define OGS_FSM_TRAN(__s, __target) \
     ((ogs_fsm_t *)__s)->state = (ogs_fsm_handler_t)(__target)
 
@@ -34,172 +34,201 @@
 
 #include "ogs-core.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*
+ * Open addressing with SIMD probing, in the manner of the Swiss table.
+ *
+ * Each slot has a control byte: EMPTY, DELETED, or the low 7 bits of
+ * the hash of its key. The control bytes are probed a group at a time,
+ * so a lookup compares 16 (SSE2) or 8 (portable) slots at once and
+ * only touches the entries whose 7 bits match. Groups are aligned and
+ * visited in triangular order, which reaches every group since their
+ * number is a power of 2.
+ *
+ * A lookup ends at the first group with an EMPTY slot. A deleted entry
+ * therefore becomes EMPTY only if its group already had one, and
+ * DELETED otherwise; the DELETED slots are reclaimed on the next
+ * resize.
+ *
+ * Keys of 4 and 8 bytes (TEID, SEID, IPv4 address, ...) are hashed and
+ * compared as integers. Other keys use a wyhash-style function.
+ */
+#define CTRL_EMPTY          ((uint8_t)0x80)
+#define CTRL_DELETED        ((uint8_t)0xfe)
+
+#define MAX_LOAD(capacity)  ((capacity) - (capacity) / 8)
+
 typedef struct ogs_hash_entry_t ogs_hash_entry_t;
 struct ogs_hash_entry_t {
-    ogs_hash_entry_t    *next;
-    unsigned int        hash;
     const void          *key;
-    int                 klen;
     const void          *val;
+    int                 klen;
+    uint32_t            h1;     /* To find a slot again on resize */
 };
 
 struct ogs_hash_index_t {
     ogs_hash_t          *ht;
-    ogs_hash_entry_t    *this, *next;
+    ogs_hash_entry_t    *this;
     unsigned int        index;
 };
 
 struct ogs_hash_t {
-    ogs_hash_entry_t    **array;
+    uint8_t             *ctrl;
+    ogs_hash_entry_t    *array;
     ogs_hash_index_t    iterator;  /* For ogs_hash_first(NULL, ...) */
-    unsigned int        count, max, seed;
+    unsigned int        count, capacity, growth_left;
+    uint64_t            seed;
     ogs_hashfunc_t      hash_func;
-    ogs_hash_entry_t    *free;  /* List of recycled entries */
 };
 
-#define INITIAL_MAX 15 /* tunable == 2^n - 1 */
+#if defined(__SSE2__)
+#define GROUP_WIDTH 16
 
-static ogs_hash_entry_t **alloc_array(ogs_hash_t *ht, unsigned int max)
-{
-    ogs_hash_entry_t **ptr = ogs_calloc(1, sizeof(*ht->array) * (max + 1));
-    ogs_assert(ptr);
-    return ptr;
-}
+typedef uint32_t group_mask_t;
 
-ogs_hash_t *ogs_hash_make(void)
+static ogs_inline group_mask_t group_match(const uint8_t *ctrl, uint8_t h2)
 {
-    ogs_hash_t *ht;
-    ogs_time_t now = ogs_get_monotonic_time();
-
-    ht = ogs_malloc(sizeof(ogs_hash_t));
-    if (!ht) {
-        ogs_error("ogs_malloc() failed");
-        return NULL;
-    }
-
-    ht->free = NULL;
-    ht->count = 0;
-    ht->max = INITIAL_MAX;
-    ht->seed = (unsigned int)((now >> 32) ^ now ^ 
-                              (uintptr_t)ht ^ (uintptr_t)&now) - 1;
-    ht->array = alloc_array(ht, ht->max);
-    ht->hash_func = NULL;
-
-    return ht;
+    __m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(h2)));
 }
 
-ogs_hash_t *ogs_hash_make_custom(ogs_hashfunc_t hash_func)
+static ogs_inline group_mask_t group_match_empty(const uint8_t *ctrl)
 {
-    ogs_hash_t *ht = ogs_hash_make();
-    if (!ht) {
-        ogs_error("ogs_hash_make() failed");
-        return NULL;
-    }
-    ht->hash_func = hash_func;
-    return ht;
+    return group_match(ctrl, CTRL_EMPTY);
 }
 
-void ogs_hash_destroy(ogs_hash_t *ht)
+/* EMPTY or DELETED, the only ones with the top bit set */
+static ogs_inline group_mask_t group_match_free(const uint8_t *ctrl)
 {
-    ogs_hash_entry_t *he = NULL, *next_he = NULL;
-
-    ogs_assert(ht);
-    ogs_assert(ht->array);
+    __m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+    return _mm_movemask_epi8(group);
+}
 
-    ogs_hash_clear(ht);
+#define group_mask_first(mask) __builtin_ctz(mask)
+#else
+#define GROUP_WIDTH 8
 
-    he = ht->free;
-    while(he) {
-        next_he = he->next;
+/* The top bit of each matching byte is set */
+typedef uint64_t group_mask_t;
 
-        ogs_free(he);
-        he = next_he;
-    }
+#define GROUP_LSBS 0x0101010101010101ULL
+#define GROUP_MSBS 0x8080808080808080ULL
 
-    ogs_free(ht->array);
-    ogs_free(ht);
+static ogs_inline uint64_t group_load(const uint8_t *ctrl)
+{
+    uint64_t group;
+    memcpy(&group, ctrl, sizeof(group));
+    return le64toh(group);
 }
 
-ogs_hash_index_t *ogs_hash_next(ogs_hash_index_t *hi)
+/* May match a full slot next to a real match; keys are compared anyway */
+static ogs_inline group_mask_t group_match(const uint8_t *ctrl, uint8_t h2)
 {
-    ogs_assert(hi);
-
-    hi->this = hi->next;
-    while (!hi->this) {
-        if (hi->index > hi->ht->max)
-            return NULL;
+    uint64_t x = group_load(ctrl) ^ (GROUP_LSBS * h2);
+    return (x - GROUP_LSBS) & ~x & GROUP_MSBS;
+}
 
-        hi->this = hi->ht->array[hi->index++];
-    }
-    hi->next = hi->this->next;
-    return hi;
+static ogs_inline group_mask_t group_match_empty(const uint8_t *ctrl)
+{
+    uint64_t group = group_load(ctrl);
+    return group & ~(group << 6) & GROUP_MSBS;
 }
 
-ogs_hash_index_t *ogs_hash_first(ogs_hash_t *ht)
+static ogs_inline group_mask_t group_match_free(const uint8_t *ctrl)
 {
-    ogs_hash_index_t *hi;
+    uint64_t group = group_load(ctrl);
+    return group & ~(group << 7) & GROUP_MSBS;
+}
 
-    ogs_assert(ht);
+#define group_mask_first(mask) (__builtin_ctzll(mask) >> 3)
+#endif
 
-    hi = &ht->iterator;
+#define INITIAL_CAPACITY GROUP_WIDTH /* tunable == 2^n * GROUP_WIDTH */
 
-    hi->ht = ht;
-    hi->index = 0;
-    hi->this = NULL;
-    hi->next = NULL;
-    return ogs_hash_next(hi);
-}
+#define HASH_P0 0xa0761d6478bd642fULL
+#define HASH_P1 0xe7037ed1a0b428dbULL
 
-void ogs_hash_this(ogs_hash_index_t *hi,
-        const void **key, int *klen, void **val)
+static ogs_inline void hash_mum(uint64_t *a, uint64_t *b)
 {
-    ogs_assert(hi);
-
-    if (key)  *key  = hi->this->key;
-    if (klen) *klen = hi->this->klen;
-    if (val)  *val  = (void *)hi->this->val;
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = (__uint128_t)*a * *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32;
+    uint64_t la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32), c = t < rl, lo;
+    lo = t + (rm1 << 32);
+    c += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
 }
 
-const void *ogs_hash_this_key(ogs_hash_index_t *hi)
+static ogs_inline uint64_t hash_mix(uint64_t a, uint64_t b)
 {
-    const void *key;
-
-    ogs_hash_this(hi, &key, NULL, NULL);
-    return key;
+    hash_mum(&a, &b);
+    return a ^ b;
 }
 
-int ogs_hash_this_key_len(ogs_hash_index_t *hi)
+static ogs_inline uint64_t hash_read4(const uint8_t *p)
 {
-    int klen;
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
 
-    ogs_hash_this(hi, NULL, &klen, NULL);
-    return klen;
+static ogs_inline uint64_t hash_read8(const uint8_t *p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
 }
 
-void *ogs_hash_this_val(ogs_hash_index_t *hi)
+static ogs_inline uint64_t hash_u64(uint64_t key, uint64_t seed)
 {
-    void *val;
+    uint64_t a = key ^ HASH_P0, b = seed ^ HASH_P1;
 
-    ogs_hash_this(hi, NULL, NULL, &val);
-    return val;
+    hash_mum(&a, &b);
+    return hash_mix(a ^ HASH_P0, b ^ HASH_P1);
 }
 
-static void expand_array(ogs_hash_t *ht)
+static uint64_t hash_bytes(const uint8_t *p, size_t len, uint64_t seed)
 {
-    ogs_hash_index_t *hi;
-    ogs_hash_entry_t **new_array;
-    unsigned int new_max;
-
-    new_max = ht->max * 2 + 1;
-    new_array = alloc_array(ht, new_max);
-    for (hi = ogs_hash_first(ht); hi; hi = ogs_hash_next(hi)) {
-        unsigned int i = hi->this->hash & new_max;
-        hi->this->next = new_array[i];
-        new_array[i] = hi->this;
+    uint64_t a, b;
+    size_t i = len;
+
+    seed ^= HASH_P0;
+    if (len <= 16) {
+        if (len >= 4) {
+            a = (hash_read4(p) << 32) | hash_read4(p + ((len >> 3) << 2));
+            b = (hash_read4(p + len - 4) << 32) |
+                hash_read4(p + len - 4 - ((len >> 3) << 2));
+        } else if (len > 0) {
+            a = ((uint64_t)p[0] << 16) |
+                ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        while (i > 16) {
+            seed = hash_mix(hash_read8(p) ^ HASH_P1, hash_read8(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        a = hash_read8(p + i - 16);
+        b = hash_read8(p + i - 8);
     }
-    ogs_free(ht->array);
-    ht->array = new_array;
-    ht->max = new_max;
+
+    a ^= HASH_P1;
+    b ^= seed;
+    hash_mum(&a, &b);
+    return hash_mix(a ^ HASH_P0 ^ len, b ^ HASH_P1);
 }
 
 static unsigned int hashfunc_default(
@@ -267,57 +296,276 @@ unsigned int ogs_hashfunc_default(const char *char_key, int *klen)
     return hashfunc_default(char_key, klen, 0);
 }
 
-static ogs_hash_entry_t **find_entry(ogs_hash_t *ht,
-        const void *key, int klen, const void *val, const char *file_line)
+static void alloc_array(ogs_hash_t *ht, unsigned int capacity)
+{
+    ht->ctrl = ogs_malloc(capacity);
+    ogs_assert(ht->ctrl);
+    memset(ht->ctrl, CTRL_EMPTY, capacity);
+
+    ht->array = ogs_malloc(sizeof(*ht->array) * capacity);
+    ogs_assert(ht->array);
+
+    ht->capacity = capacity;
+    ht->growth_left = MAX_LOAD(capacity) - ht->count;
+}
+
+ogs_hash_t *ogs_hash_make(void)
+{
+    ogs_hash_t *ht;
+    ogs_time_t now = ogs_get_monotonic_time();
+
+    ht = ogs_malloc(sizeof(ogs_hash_t));
+    if (!ht) {
+        ogs_error("ogs_malloc() failed");
+        return NULL;
+    }
+
+    ht->count = 0;
+    ht->seed = (uint64_t)now ^ (uintptr_t)ht ^ ((uint64_t)(uintptr_t)&now << 32);
+    alloc_array(ht, INITIAL_CAPACITY);
+    ht->hash_func = NULL;
+
+    return ht;
+}
+
+ogs_hash_t *ogs_hash_make_custom(ogs_hashfunc_t hash_func)
+{
+    ogs_hash_t *ht = ogs_hash_make();
+    if (!ht) {
+        ogs_error("ogs_hash_make() failed");
+        return NULL;
+    }
+    ht->hash_func = hash_func;
+    return ht;
+}
+
+void ogs_hash_destroy(ogs_hash_t *ht)
+{
+    ogs_assert(ht);
+    ogs_assert(ht->array);
+
+    ogs_free(ht->ctrl);
+    ogs_free(ht->array);
+    ogs_free(ht);
+}
+
+ogs_hash_index_t *ogs_hash_next(ogs_hash_index_t *hi)
 {
-    ogs_hash_entry_t **hep, *he;
-    unsigned int hash;
+    ogs_hash_t *ht;
+
+    ogs_assert(hi);
 
+    ht = hi->ht;
+    while (hi->index < ht->capacity) {
+        if (!(ht->ctrl[hi->index] & CTRL_EMPTY)) {
+            hi->this = &ht->array[hi->index++];
+            return hi;
+        }
+        hi->index++;
+    }
+
+    return NULL;
+}
+
+ogs_hash_index_t *ogs_hash_first(ogs_hash_t *ht)
+{
+    ogs_hash_index_t *hi;
+
+    ogs_assert(ht);
+
+    hi = &ht->iterator;
+
+    hi->ht = ht;
+    hi->index = 0;
+    hi->this = NULL;
+    return ogs_hash_next(hi);
+}
+
+void ogs_hash_this(ogs_hash_index_t *hi,
+        const void **key, int *klen, void **val)
+{
+    ogs_assert(hi);
+
+    if (key)  *key  = hi->this->key;
+    if (klen) *klen = hi->this->klen;
+    if (val)  *val  = (void *)hi->this->val;
+}
+
+const void *ogs_hash_this_key(ogs_hash_index_t *hi)
+{
+    const void *key;
+
+    ogs_hash_this(hi, &key, NULL, NULL);
+    return key;
+}
+
+int ogs_hash_this_key_len(ogs_hash_index_t *hi)
+{
+    int klen;
+
+    ogs_hash_this(hi, NULL, &klen, NULL);
+    return klen;
+}
+
+void *ogs_hash_this_val(ogs_hash_index_t *hi)
+{
+    void *val;
+
+    ogs_hash_this(hi, NULL, NULL, &val);
+    return val;
+}
+
+/* First EMPTY or DELETED slot on the probe sequence of 'h1' */
+static unsigned int find_free(ogs_hash_t *ht, uint32_t h1)
+{
+    unsigned int mask = ht->capacity / GROUP_WIDTH - 1;
+    unsigned int group = h1 & mask, step = 0;
+    group_mask_t match;
+
+    for (;;) {
+        match = group_match_free(ht->ctrl + group * GROUP_WIDTH);
+        if (match)
+            return group * GROUP_WIDTH + group_mask_first(match);
+
+        group = (group + ++step) & mask;
+    }
+}
+
+static void expand_array(ogs_hash_t *ht)
+{
+    uint8_t *old_ctrl = ht->ctrl;
+    ogs_hash_entry_t *old_array = ht->array;
+    unsigned int old_capacity = ht->capacity, new_capacity, i, j;
+
+    /* Only clean up DELETED slots if the table is not that full */
+    new_capacity = old_capacity;
+    if (ht->count > MAX_LOAD(old_capacity) / 2)
+        new_capacity = old_capacity * 2;
+
+    alloc_array(ht, new_capacity);
+    for (i = 0; i < old_capacity; i++) {
+        if (old_ctrl[i] & CTRL_EMPTY)
+            continue;
+
+        j = find_free(ht, old_array[i].h1);
+        ht->ctrl[j] = old_ctrl[i];
+        ht->array[j] = old_array[i];
+    }
+
+    ogs_free(old_ctrl);
+    ogs_free(old_array);
+}
+
+static uint64_t hash_key(ogs_hash_t *ht, const void *key, int *klen)
+{
     if (ht->hash_func)
-        hash = ht->hash_func(key, &klen);
-    else
-        hash = hashfunc_default(key, &klen, ht->seed);
-
-    /* scan linked list */
-    for (hep = &ht->array[hash & ht->max], he = *hep;
-         he; hep = &he->next, he = *hep) {
-        if (he->hash == hash
-            && he->klen == klen
-            && memcmp(he->key, key, klen) == 0)
-            break;
+        return hash_u64(ht->hash_func(key, klen), ht->seed);
+
+    if (*klen == OGS_HASH_KEY_STRING)
+        *klen = strlen(key);
+
+    switch (*klen) {
+    case 4:
+        return hash_u64(hash_read4(key), ht->seed);
+    case 8:
+        return hash_u64(hash_read8(key), ht->seed);
+    default:
+        return hash_bytes(key, *klen, ht->seed);
+    }
+}
+
+static ogs_inline int key_equal(
+        ogs_hash_entry_t *he, const void *key, int klen)
+{
+    if (he->klen != klen)
+        return 0;
+
+    switch (klen) {
+    case 4:
+        return hash_read4(he->key) == hash_read4(key);
+    case 8:
+        return hash_read8(he->key) == hash_read8(key);
+    default:
+        return memcmp(he->key, key, klen) == 0;
     }
-    if (he || !val)
-        return hep;
+}
 
-    /* add a new entry for non-NULL values */
-    if ((he = ht->free) != NULL)
-        ht->free = he->next;
-    else {
-        he = ogs_malloc(sizeof(*he));
-        ogs_assert(he);
+/* Returns the slot of the key, or -1 */
+static int find_entry(ogs_hash_t *ht, const void *key, int klen,
+        uint64_t hash, const char *file_line)
+{
+    unsigned int mask = ht->capacity / GROUP_WIDTH - 1;
+    unsigned int group = (uint32_t)(hash >> 7) & mask, step = 0, i;
+    uint8_t *ctrl;
+    group_mask_t match;
+
+    for (;;) {
+        ctrl = ht->ctrl + group * GROUP_WIDTH;
+
+        for (match = group_match(ctrl, hash & 0x7f);
+                match; match &= match - 1) {
+            i = group * GROUP_WIDTH + group_mask_first(match);
+            if (key_equal(&ht->array[i], key, klen))
+                return i;
+        }
+        if (group_match_empty(ctrl))
+            return -1;
+
+        group = (group + ++step) & mask;
     }
-    he->next = NULL;
-    he->hash = hash;
+}
+
+static void add_entry(ogs_hash_t *ht,
+        const void *key, int klen, uint64_t hash, const void *val)
+{
+    ogs_hash_entry_t *he;
+    uint32_t h1 = hash >> 7;
+    unsigned int i;
+
+    i = find_free(ht, h1);
+    if (ht->ctrl[i] == CTRL_EMPTY && !ht->growth_left) {
+        expand_array(ht);
+        i = find_free(ht, h1);
+    }
+
+    if (ht->ctrl[i] == CTRL_EMPTY)
+        ht->growth_left--;
+    ht->ctrl[i] = hash & 0x7f;
+
+    he = &ht->array[i];
     he->key  = key;
     he->klen = klen;
     he->val  = val;
-    *hep = he;
+    he->h1   = h1;
     ht->count++;
-    return hep;
+}
+
+static void delete_entry(ogs_hash_t *ht, unsigned int i)
+{
+    /* Nothing was probed past a group with an EMPTY slot */
+    if (group_match_empty(ht->ctrl + i / GROUP_WIDTH * GROUP_WIDTH)) {
+        ht->ctrl[i] = CTRL_EMPTY;
+        ht->growth_left++;
+    } else {
+        ht->ctrl[i] = CTRL_DELETED;
+    }
+    ht->count--;
 }
 
 void *ogs_hash_get_debug(ogs_hash_t *ht,
         const void *key, int klen, const char *file_line)
 {
-    ogs_hash_entry_t *he;
+    uint64_t hash;
+    int i;
 
     ogs_assert(ht);
     ogs_assert(key);
     ogs_assert(klen);
 
-    he = *find_entry(ht, key, klen, NULL, file_line);
-    if (he)
-        return (void *)he->val;
+    hash = hash_key(ht, key, &klen);
+    i = find_entry(ht, key, klen, hash, file_line);
+    if (i >= 0)
+        return (void *)ht->array[i].val;
     else
         return NULL;
 }
@@ -325,29 +573,26 @@ void *ogs_hash_get_debug(ogs_hash_t *ht,
 void ogs_hash_set_debug(ogs_hash_t *ht,
         const void *key, int klen, const void *val, const char *file_line)
 {
-    ogs_hash_entry_t **hep;
+    uint64_t hash;
+    int i;
 
     ogs_assert(ht);
     ogs_assert(key);
     ogs_assert(klen);
 
-    hep = find_entry(ht, key, klen, val, file_line);
-    if (*hep) {
+    hash = hash_key(ht, key, &klen);
+    i = find_entry(ht, key, klen, hash, file_line);
+    if (i >= 0) {
         if (!val) {
             /* delete entry */
-            ogs_hash_entry_t *old = *hep;
-            *hep = (*hep)->next;
-            old->next = ht->free;
-            ht->free = old;
-            --ht->count;
+            delete_entry(ht, i);
         } else {
             /* replace entry */
-            (*hep)->val = val;
-            /* check that the collision rate isn't too high */
-            if (ht->count > ht->max) {
-                expand_array(ht);
-            }
+            ht->array[i].val = val;
         }
+    } else if (val) {
+        /* add a new entry for non-NULL values */
+        add_entry(ht, key, klen, hash, val);
     }
     /* else key not present and val==NULL */
 }
@@ -355,19 +600,20 @@ void ogs_hash_set_debug(ogs_hash_t *ht,
 void *ogs_hash_get_or_set_debug(ogs_hash_t *ht,
         const void *key, int klen, const void *val, const char *file_line)
 {
-    ogs_hash_entry_t **hep;
+    uint64_t hash;
+    int i;
 
     ogs_assert(ht);
     ogs_assert(key);
     ogs_assert(klen);
 
-    hep = find_entry(ht, key, klen, val, file_line);
-    if (*hep) {
-        val = (*hep)->val;
-        /* check that the collision rate isn't too high */
-        if (ht->count > ht->max) {
-            expand_array(ht);
-        }
+    hash = hash_key(ht, key, &klen);
+    i = find_entry(ht, key, klen, hash, file_line);
+    if (i >= 0)
+        return (void *)ht->array[i].val;
+
+    if (val) {
+        add_entry(ht, key, klen, hash, val);
         return (void *)val;
     }
     /* else key not present and val==NULL */
@@ -382,12 +628,11 @@ unsigned int ogs_hash_count(ogs_hash_t *ht)
 
 void ogs_hash_clear(ogs_hash_t *ht)
 {
-    ogs_hash_index_t *hi;
-
     ogs_assert(ht);
 
-    for (hi = ogs_hash_first(ht); hi; hi = ogs_hash_next(hi))
-        ogs_hash_set(ht, hi->this->key, hi->this->klen, NULL);
+    memset(ht->ctrl, CTRL_EMPTY, ht->capacity);
+    ht->count = 0;
+    ht->growth_left = MAX_LOAD(ht->capacity);
 }
 
 /* This is basically the following...
@@ -408,7 +653,6 @@ int ogs_hash_do(ogs_hash_do_callback_fn_t *comp,
     hix.ht    = (ogs_hash_t *)ht;
     hix.index = 0;
     hix.this  = NULL;
-    hix.next  = NULL;
 
     if ((hi = ogs_hash_next(&hix))) {
         /* Scan the entire table */
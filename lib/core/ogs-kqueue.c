@@ -47,6 +47,7 @@ const ogs_pollset_actions_t ogs_kqueue_actions = {
     kqueue_process,
 
     kqueue_notify_pollset,
+    kqueue_add, /* EV_ADD on an existing event checks it again */
 };
 
 struct kqueue_context_s {
@@ -135,7 +136,8 @@ static int kqueue_add(ogs_poll_t *poll)
         filter = EVFILT_WRITE;
     }
 
-    return kqueue_set(poll, filter, EV_ADD|EV_ENABLE);
+    return kqueue_set(poll, filter, EV_ADD|EV_ENABLE|
+            ((poll->when & OGS_POLLET) ? EV_CLEAR : 0));
 }
 
 #if 0 /* ogs_pollset_remove() is not working, SHOULD remove the below code */
@@ -289,7 +291,7 @@ static int kqueue_process(ogs_pollset_t *pollset, ogs_time_t timeout)
         } else if (context->event_list[i].filter == EVFILT_WRITE) {
             when |= OGS_POLLOUT;
         } else if (context->event_list[i].filter == EVFILT_USER) {
-            /* Nothing */
+            __atomic_exchange_n(&pollset->notify.pending, 0, __ATOMIC_ACQ_REL);
         } else {
             ogs_warn("kevent() unknown filter = 0x%x\n",
                 context->event_list[i].filter);
@@ -349,9 +351,14 @@ static int kqueue_notify_pollset(ogs_pollset_t *pollset)
     kev.filter = EVFILT_USER;
     kev.fflags = NOTE_TRIGGER;
 
+    /* A burst of notifications costs one kevent() */
+    if (__atomic_exchange_n(&pollset->notify.pending, 1, __ATOMIC_ACQ_REL))
+        return OGS_OK;
+
     rc = kevent(context->kqueue, &kev, 1, NULL, 0, &timeout);
     if (rc == -1) {
         ogs_warn("kevent() failed");
+        __atomic_store_n(&pollset->notify.pending, 0, __ATOMIC_RELEASE);
         return OGS_ERROR;
     }
 
@@ -27,6 +27,14 @@
 #include <stdarg.h>
 #endif
 
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+#if HAVE_SYS_UIO_H
+#include <sys/uio.h>
+#endif
+
 #include "ogs-core.h"
 
 #define TA_NOR              "\033[0m"       /* all off */
@@ -95,11 +103,66 @@ static OGS_LIST(log_list);
 static OGS_POOL(domain_pool, ogs_log_domain_t);
 static OGS_LIST(domain_list);
 
+/*
+ * Asynchronous logging
+ *
+ * The caller only formats the message content and copies it, with the
+ * time and the source location, into a ring of its own thread. A writer
+ * thread renders the rest of each line and writes what the rings hold
+ * with one writev() per target. A message that does not fit in the ring
+ * is dropped and counted instead of blocking the caller.
+ *
+ * FATAL messages are still written by the caller, since an abort
+ * usually follows. The rings are drained first, so that the messages
+ * leading up to it are not lost.
+ */
+#define OGS_LOG_RING_SIZE       (256 * 1024)
+#define OGS_LOG_WRITER_INTERVAL ogs_time_from_msec(10)
+#define OGS_LOG_WRITER_IOV      192
+
+typedef struct ogs_log_ring_s ogs_log_ring_t;
+
+static struct {
+    bool started;
+
+    /* Protects the rings and the writer state */
+    ogs_thread_mutex_t mutex;
+    ogs_thread_cond_t cond;
+    ogs_thread_t *thread;
+    bool stop;
+    bool wakeup;
+
+    ogs_list_t ring_list;
+    uint64_t reported;
+
+    /* Keeps the targets still while the writer uses them */
+    ogs_thread_mutex_t target_mutex;
+} async;
+
+/* Set while this thread holds a log mutex, so that it cannot flush */
+static OGS_THREAD_LOCAL int async_locked = 0;
+
+static void async_lock(void)
+{
+    if (async.started) {
+        ogs_thread_mutex_lock(&async.target_mutex);
+        async_locked++;
+    }
+}
+
+static void async_unlock(void)
+{
+    if (async.started) {
+        async_locked--;
+        ogs_thread_mutex_unlock(&async.target_mutex);
+    }
+}
+
 static ogs_log_t *add_log(ogs_log_type_e type);
 static int file_cycle(ogs_log_t *log);
 
 static char *log_timestamp(char *buf, char *last,
-        int use_color);
+        struct timeval *tv, int use_color);
 static char *log_domain(char *buf, char *last,
         const char *name, int use_color);
 static char *log_content(char *buf, char *last,
@@ -111,6 +174,12 @@ static char *log_linefeed(char *buf, char *last);
 static void file_writer(
         ogs_log_t *log, ogs_log_level_e level, const char *string);
 
+#if !defined(_WIN32)
+static bool async_log(ogs_log_level_e level, ogs_log_domain_t *domain,
+    ogs_err_t err, const char *file, int line, const char *func,
+    int content_only, const char *format, va_list ap);
+#endif
+
 void ogs_log_init(void)
 {
     ogs_pool_init(&log_pool, ogs_core()->log.pool);
@@ -125,6 +194,8 @@ void ogs_log_final(void)
     ogs_log_t *log, *saved_log;
     ogs_log_domain_t *domain, *saved_domain;
 
+    ogs_log_async_stop();
+
     ogs_list_for_each_safe(&log_list, saved_log, log)
         ogs_log_remove(log);
     ogs_pool_final(&log_pool);
@@ -138,6 +209,7 @@ void ogs_log_cycle(void)
 {
     ogs_log_t *log = NULL;
 
+    async_lock();
     ogs_list_for_each(&log_list, log) {
         switch(log->type) {
         case OGS_LOG_FILE_TYPE:
@@ -146,6 +218,7 @@ void ogs_log_cycle(void)
             break;
         }
     }
+    async_unlock();
 }
 
 ogs_log_t *ogs_log_add_stderr(void)
@@ -189,7 +262,9 @@ void ogs_log_remove(ogs_log_t *log)
 {
     ogs_assert(log);
 
+    async_lock();
     ogs_list_remove(&log_list, log);
+    async_unlock();
 
     if (log->type == OGS_LOG_FILE_TYPE) {
         ogs_assert(log->file.out);
@@ -410,6 +485,25 @@ void ogs_log_vprintf(ogs_log_level_e level, int id,
 
     int wrote_stderr = 0;
 
+#if !defined(_WIN32)
+    if (level == OGS_LOG_FATAL) {
+        /* Whatever was logged before goes out first */
+        ogs_log_async_flush();
+    } else if (__atomic_load_n(&async.started, __ATOMIC_ACQUIRE)) {
+        domain = ogs_pool_find(&domain_pool, id);
+        if (!domain) {
+            fprintf(stderr, "No LogDomain[id:%d] in %s:%d", id, file, line);
+            ogs_assert_if_reached();
+        }
+        if (domain->level < level)
+            return;
+
+        if (async_log(level, domain,
+                    err, file, line, func, content_only, format, ap))
+            return;
+    }
+#endif
+
     ogs_list_for_each(&log_list, log) {
         domain = ogs_pool_find(&domain_pool, id);
         if (!domain) {
@@ -424,7 +518,7 @@ void ogs_log_vprintf(ogs_log_level_e level, int id,
 
         if (!content_only) {
             if (log->print.timestamp)
-                p = log_timestamp(p, last, log->print.color);
+                p = log_timestamp(p, last, NULL, log->print.color);
             if (log->print.domain)
                 p = log_domain(p, last, domain->name, log->print.color);
             if (log->print.level)
@@ -465,7 +559,7 @@ void ogs_log_vprintf(ogs_log_level_e level, int id,
         last = logstr + OGS_HUGE_LEN;
 
         if (!content_only) {
-            p = log_timestamp(p, last, use_color);
+            p = log_timestamp(p, last, NULL, use_color);
             p = log_level(p, last, level, use_color);
         }
         p = log_content(p, last, format, ap);
@@ -541,7 +635,9 @@ static ogs_log_t *add_log(ogs_log_type_e type)
     log->print.fileline = 1;
     log->print.linefeed = 1;
 
+    async_lock();
     ogs_list_add(&log_list, log);
+    async_unlock();
 
     return log;
 }
@@ -559,20 +655,24 @@ static int file_cycle(ogs_log_t *log)
     return 0;
 }
 
+/* Now, unless 'tv' is given */
 static char *log_timestamp(char *buf, char *last,
-        int use_color)
+        struct timeval *tv, int use_color)
 {
-    struct timeval tv;
+    struct timeval now;
     struct tm tm;
     char nowstr[32];
 
-    ogs_gettimeofday(&tv);
-    ogs_localtime(tv.tv_sec, &tm);
+    if (!tv) {
+        ogs_gettimeofday(&now);
+        tv = &now;
+    }
+    ogs_localtime(tv->tv_sec, &tm);
     strftime(nowstr, sizeof nowstr, "%m/%d %H:%M:%S", &tm);
 
     buf = ogs_slprintf(buf, last, "%s%s.%03d%s: ",
             use_color ? TA_FGC_GREEN : "",
-            nowstr, (int)(tv.tv_usec/1000),
+            nowstr, (int)(tv->tv_usec/1000),
             use_color ? TA_NOR : "");
 
     return buf;
@@ -645,3 +745,472 @@ static void file_writer(
     fflush(log->file.out);
 }
 
+#if !defined(_WIN32)
+/*
+ * A ring is written by one thread and read by the writer. Records are
+ * aligned to 8 bytes. A record with size 0 means the rest of the ring
+ * is unused and the next one starts at the beginning.
+ */
+typedef struct ogs_log_record_s {
+    uint32_t size;
+    uint32_t length;        /* of the content following the record */
+    uint8_t level;
+    uint8_t content_only;
+    int domain_id;
+    int line;
+    const char *file;
+    const char *func;
+    struct timeval tv;
+} ogs_log_record_t;
+
+#define OGS_LOG_RECORD_ALIGN(size) (((size) + 7) & ~(size_t)7)
+
+typedef struct ogs_log_ring_s {
+    ogs_lnode_t lnode;
+
+    char buf[OGS_LOG_RING_SIZE];
+    uint64_t head;          /* Written by the thread */
+    uint64_t tail;          /* Written by the writer */
+    uint64_t dropped;
+
+    bool idle;
+} ogs_log_ring_t;
+
+static OGS_THREAD_LOCAL ogs_log_ring_t *self_ring = NULL;
+static pthread_key_t ring_key;
+
+/* The next thread takes over the ring of an exited one */
+static void ring_exit(void *data)
+{
+    ogs_log_ring_t *ring = data;
+
+    ogs_assert(ring);
+
+    ogs_thread_mutex_lock(&async.mutex);
+    ring->idle = true;
+    ogs_thread_mutex_unlock(&async.mutex);
+
+    self_ring = NULL;
+}
+
+static ogs_log_ring_t *ring_self(void)
+{
+    ogs_log_ring_t *ring = NULL;
+
+    if (ogs_likely(self_ring))
+        return self_ring;
+
+    ogs_thread_mutex_lock(&async.mutex);
+
+    ogs_list_for_each(&async.ring_list, ring) {
+        if (ring->idle)
+            break;
+    }
+    if (ring) {
+        ring->idle = false;
+    } else {
+        ring = calloc(1, sizeof(*ring));
+        if (ring)
+            ogs_list_add(&async.ring_list, ring);
+    }
+
+    ogs_thread_mutex_unlock(&async.mutex);
+
+    if (!ring)
+        return NULL;
+
+    pthread_setspecific(ring_key, ring);
+    self_ring = ring;
+
+    return ring;
+}
+
+/*
+ * The mutex is also held while the rings are drained. If it is busy,
+ * a drain is under way or the writer is about to look again, so the
+ * caller does not wait for it.
+ */
+static void writer_wakeup(void)
+{
+    if (pthread_mutex_trylock(&async.mutex) != 0)
+        return;
+    async.wakeup = true;
+    ogs_thread_cond_signal(&async.cond);
+    ogs_thread_mutex_unlock(&async.mutex);
+}
+
+static bool async_log(ogs_log_level_e level, ogs_log_domain_t *domain,
+    ogs_err_t err, const char *file, int line, const char *func,
+    int content_only, const char *format, va_list ap)
+{
+    ogs_log_ring_t *ring = NULL;
+    ogs_log_record_t *record = NULL;
+
+    char content[OGS_HUGE_LEN];
+    char *p, *last;
+    size_t length, size, skip, offset;
+    uint64_t head, tail;
+
+    ring = ring_self();
+    if (!ring)
+        return false;
+
+    p = content;
+    last = content + OGS_HUGE_LEN;
+
+    p = log_content(p, last, format, ap);
+    if (err) {
+        char errbuf[OGS_HUGE_LEN];
+        p = ogs_slprintf(p, last, " (%d:%s)",
+                (int)err, ogs_strerror(err, errbuf, OGS_HUGE_LEN));
+    }
+    length = p - content;
+
+    size = OGS_LOG_RECORD_ALIGN(sizeof(*record) + length);
+
+    head = ring->head;
+    tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+
+    offset = head % OGS_LOG_RING_SIZE;
+    skip = 0;
+    if (offset + size > OGS_LOG_RING_SIZE)
+        skip = OGS_LOG_RING_SIZE - offset;
+
+    if (head + skip + size - tail > OGS_LOG_RING_SIZE) {
+        __atomic_store_n(&ring->dropped, ring->dropped + 1, __ATOMIC_RELAXED);
+        return true;
+    }
+
+    if (skip) {
+        ((ogs_log_record_t *)(ring->buf + offset))->size = 0;
+        offset = 0;
+    }
+
+    record = (ogs_log_record_t *)(ring->buf + offset);
+    record->size = size;
+    record->length = length;
+    record->level = level;
+    record->content_only = content_only;
+    record->domain_id = domain->id;
+    record->file = file;
+    record->line = line;
+    record->func = func;
+    ogs_gettimeofday(&record->tv);
+    memcpy(record + 1, content, length);
+
+    __atomic_store_n(&ring->head, head + skip + size, __ATOMIC_RELEASE);
+
+    /* Do not wait for the interval once the ring is half full */
+    if (head - tail <= OGS_LOG_RING_SIZE / 2 &&
+        head + skip + size - tail > OGS_LOG_RING_SIZE / 2)
+        writer_wakeup();
+
+    return true;
+}
+
+typedef struct ogs_log_batch_s {
+    int fd;
+    struct iovec iov[OGS_LOG_WRITER_IOV];
+    int num_of_iov;
+
+    char buf[OGS_HUGE_LEN];
+    char *p;
+} ogs_log_batch_t;
+
+static void batch_flush(ogs_log_batch_t *batch)
+{
+    struct iovec *iov = batch->iov;
+    int num_of_iov = batch->num_of_iov;
+    ssize_t r;
+
+    while (num_of_iov) {
+        r = writev(batch->fd, iov, num_of_iov);
+        if (r < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        while (num_of_iov && (size_t)r >= iov->iov_len) {
+            r -= iov->iov_len;
+            iov++;
+            num_of_iov--;
+        }
+        if (num_of_iov) {
+            iov->iov_base = (char *)iov->iov_base + r;
+            iov->iov_len -= r;
+        }
+    }
+
+    batch->num_of_iov = 0;
+    batch->p = batch->buf;
+}
+
+static void batch_add(ogs_log_batch_t *batch, const char *data, size_t len)
+{
+    if (!len)
+        return;
+
+    batch->iov[batch->num_of_iov].iov_base = (void *)data;
+    batch->iov[batch->num_of_iov].iov_len = len;
+    batch->num_of_iov++;
+}
+
+/* Prefixes and suffixes are rendered into the batch buffer */
+static void batch_add_record(ogs_log_batch_t *batch,
+        ogs_log_t *log, ogs_log_record_t *record)
+{
+    ogs_log_domain_t *domain = NULL;
+    char *p, *last;
+    int use_color, timestamp, fileline, function, linefeed;
+
+    /* Room for the longest prefix and suffix of a record */
+    if (batch->num_of_iov + 3 > OGS_LOG_WRITER_IOV ||
+        batch->buf + sizeof(batch->buf) - batch->p < 1024)
+        batch_flush(batch);
+
+    if (log) {
+        use_color = log->print.color;
+        timestamp = log->print.timestamp;
+        fileline = log->print.fileline;
+        function = log->print.function;
+        linefeed = log->print.linefeed;
+    } else {
+        /* No stderr target, as in ogs_log_vprintf() */
+        use_color = 1;
+        timestamp = fileline = function = linefeed = 1;
+    }
+
+    last = batch->buf + sizeof(batch->buf);
+
+    if (!record->content_only) {
+        p = batch->p;
+        if (timestamp)
+            p = log_timestamp(p, last, &record->tv, use_color);
+        if (log && log->print.domain) {
+            domain = ogs_pool_find(&domain_pool, record->domain_id);
+            if (domain)
+                p = log_domain(p, last, domain->name, use_color);
+        }
+        if (!log || log->print.level)
+            p = log_level(p, last, record->level, use_color);
+        batch_add(batch, batch->p, p - batch->p);
+        batch->p = p;
+    }
+
+    batch_add(batch, (const char *)(record + 1), record->length);
+
+    if (!record->content_only) {
+        p = batch->p;
+        if (fileline)
+            p = ogs_slprintf(p, last, " (%s:%d)", record->file, record->line);
+        if (function)
+            p = ogs_slprintf(p, last, " %s()", record->func);
+        if (linefeed)
+            p = log_linefeed(p, last);
+        batch_add(batch, batch->p, p - batch->p);
+        batch->p = p;
+    }
+}
+
+static void batch_add_ring(ogs_log_batch_t *batch, ogs_log_t *log,
+        ogs_log_ring_t *ring, uint64_t tail, uint64_t head)
+{
+    ogs_log_record_t *record = NULL;
+    size_t offset;
+
+    while (tail < head) {
+        offset = tail % OGS_LOG_RING_SIZE;
+        record = (ogs_log_record_t *)(ring->buf + offset);
+        if (!record->size) {
+            tail += OGS_LOG_RING_SIZE - offset;
+            continue;
+        }
+
+        batch_add_record(batch, log, record);
+        tail += record->size;
+    }
+}
+
+/* Only used with async.mutex held */
+static ogs_log_batch_t drain_batch;
+
+/*
+ * Writes what the rings hold. Called with async.mutex held, which makes
+ * the caller the only reader of the rings. Returns the number of bytes
+ * taken from them.
+ */
+static uint64_t writer_drain(void)
+{
+    ogs_log_batch_t *batch = &drain_batch;
+    ogs_log_ring_t *ring = NULL, *rings[OGS_LOG_WRITER_IOV];
+    ogs_log_t *log = NULL;
+    uint64_t head[OGS_LOG_WRITER_IOV], dropped = 0, drained = 0;
+    char dropstr[64];
+    int i, n;
+    bool wrote_stderr = false;
+
+    if (!batch->p)
+        batch->p = batch->buf;
+
+    async_locked++;
+
+    n = 0;
+    ogs_list_for_each(&async.ring_list, ring) {
+        if (n == OGS_LOG_WRITER_IOV)
+            break;
+        rings[n] = ring;
+        head[n++] = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        dropped += __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+    }
+
+    dropstr[0] = 0;
+    if (dropped > async.reported) {
+        ogs_snprintf(dropstr, sizeof(dropstr),
+                "%llu log messages dropped\n",
+                (unsigned long long)(dropped - async.reported));
+        async.reported = dropped;
+    }
+
+    ogs_thread_mutex_lock(&async.target_mutex);
+
+    /* Without a stderr target, stderr still gets everything */
+    for (log = ogs_list_first(&log_list); ; log = ogs_list_next(log)) {
+        if (!log) {
+            if (wrote_stderr)
+                break;
+            batch->fd = STDERR_FILENO;
+        } else {
+            ogs_assert(log->file.out);
+            batch->fd = fileno(log->file.out);
+            if (log->type == OGS_LOG_STDERR_TYPE)
+                wrote_stderr = true;
+        }
+
+        for (i = 0; i < n; i++)
+            batch_add_ring(batch, log, rings[i], rings[i]->tail, head[i]);
+        batch_add(batch, dropstr, strlen(dropstr));
+        batch_flush(batch);
+
+        if (!log)
+            break;
+    }
+
+    ogs_thread_mutex_unlock(&async.target_mutex);
+
+    for (i = 0; i < n; i++) {
+        drained += head[i] - rings[i]->tail;
+        __atomic_store_n(&rings[i]->tail, head[i], __ATOMIC_RELEASE);
+    }
+
+    async_locked--;
+
+    return drained;
+}
+
+static void writer_main(void *data)
+{
+    bool stop = false;
+
+    ogs_thread_mutex_lock(&async.mutex);
+    while (!stop) {
+        if (writer_drain()) {
+            /* Let a flush or a new thread in between two drains */
+            ogs_thread_mutex_unlock(&async.mutex);
+            ogs_thread_mutex_lock(&async.mutex);
+            continue;
+        }
+
+        if (!async.stop && !async.wakeup)
+            ogs_thread_cond_timedwait(&async.cond,
+                    &async.mutex, OGS_LOG_WRITER_INTERVAL);
+        async.wakeup = false;
+        stop = async.stop;
+    }
+
+    /* Whatever was logged before stopping */
+    writer_drain();
+    ogs_thread_mutex_unlock(&async.mutex);
+}
+#endif
+
+void ogs_log_async_flush(void)
+{
+#if !defined(_WIN32)
+    if (!__atomic_load_n(&async.started, __ATOMIC_ACQUIRE))
+        return;
+
+    /* A FATAL from inside the logger itself cannot wait for it */
+    if (async_locked)
+        return;
+
+    ogs_thread_mutex_lock(&async.mutex);
+    writer_drain();
+    ogs_thread_mutex_unlock(&async.mutex);
+#endif
+}
+
+int ogs_log_async_start(void)
+{
+#if !defined(_WIN32)
+    if (async.started)
+        return OGS_OK;
+
+    ogs_thread_mutex_init(&async.mutex);
+    ogs_thread_mutex_init(&async.target_mutex);
+    ogs_thread_cond_init(&async.cond);
+    ogs_list_init(&async.ring_list);
+    async.stop = false;
+    async.wakeup = false;
+    async.reported = 0;
+    ogs_assert(pthread_key_create(&ring_key, ring_exit) == 0);
+
+    async.thread = ogs_thread_create(writer_main, NULL);
+    if (!async.thread) {
+        pthread_key_delete(ring_key);
+        ogs_thread_cond_destroy(&async.cond);
+        ogs_thread_mutex_destroy(&async.target_mutex);
+        ogs_thread_mutex_destroy(&async.mutex);
+        return OGS_ERROR;
+    }
+
+    __atomic_store_n(&async.started, true, __ATOMIC_RELEASE);
+
+    return OGS_OK;
+#else
+    ogs_warn("Asynchronous logging is not supported");
+    return OGS_ERROR;
+#endif
+}
+
+void ogs_log_async_stop(void)
+{
+#if !defined(_WIN32)
+    ogs_log_ring_t *ring = NULL, *next_ring = NULL;
+
+    if (!async.started)
+        return;
+
+    /* From now on, messages are written at once */
+    __atomic_store_n(&async.started, false, __ATOMIC_RELEASE);
+
+    ogs_thread_mutex_lock(&async.mutex);
+    async.stop = true;
+    ogs_thread_cond_signal(&async.cond);
+    ogs_thread_mutex_unlock(&async.mutex);
+
+    ogs_thread_destroy(async.thread);
+    async.thread = NULL;
+
+    pthread_key_delete(ring_key);
+    ogs_list_for_each_safe(&async.ring_list, next_ring, ring) {
+        ogs_list_remove(&async.ring_list, ring);
+        free(ring);
+    }
+    self_ring = NULL;
+
+    ogs_thread_cond_destroy(&async.cond);
+    ogs_thread_mutex_destroy(&async.target_mutex);
+    ogs_thread_mutex_destroy(&async.mutex);
+#endif
+}
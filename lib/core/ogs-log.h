@@ -98,6 +98,19 @@ int ogs_log_config_domain(const char *domain, const char *level);
 void ogs_log_set_mask_level(const char *mask, ogs_log_level_e level);
 void ogs_log_set_timestamp(ogs_log_ts_e ts_default, ogs_log_ts_e ts_file);
 
+/*
+ * Write messages from a background thread. Calling threads copy them
+ * into per-thread rings and never block; on overflow they are dropped
+ * and counted. FATAL messages are still written at once.
+ *
+ * ogs_log_async_stop() writes whatever is left. No other thread may
+ * be logging by then. ogs_log_async_flush() writes what the rings hold
+ * before returning; FATAL messages and ogs_abort() call it.
+ */
+int ogs_log_async_start(void);
+void ogs_log_async_stop(void);
+void ogs_log_async_flush(void);
+
 void ogs_log_vprintf(ogs_log_level_e level, int id,
     ogs_err_t err, const char *file, int line, const char *func,
     int content_only, const char *format, va_list ap);
@@ -0,0 +1,340 @@
+/*
+ * Copyright (C) 2019-2023 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ogs-core.h"
+
+#define OGS_LPM_STRIDE      8
+#define OGS_LPM_FANOUT      (1 << OGS_LPM_STRIDE)
+#define OGS_LPM_MAX_BITS    128
+#define OGS_LPM_MAX_DEPTH   (OGS_LPM_MAX_BITS / OGS_LPM_STRIDE)
+
+/*
+ * A node covers one byte of the address.
+ *
+ * slot[].data is the longest prefix ending in this node that covers
+ * the slot, and plen[] its length in bits past the node (1..8, 0 if
+ * none). Prefixes of 1..7 bits are also kept in shorter[], indexed
+ * by (1 << bits) + value, so a slot can fall back to the next longest
+ * one when a prefix is removed.
+ */
+typedef struct ogs_lpm_slot_s {
+    struct ogs_lpm_node_s *child;
+    void *data;
+} ogs_lpm_slot_t;
+
+typedef struct ogs_lpm_node_s {
+    ogs_lpm_slot_t slot[OGS_LPM_FANOUT];
+    uint8_t plen[OGS_LPM_FANOUT];
+
+    void **shorter;
+
+    int num_of_child;
+    int num_of_prefix;
+} ogs_lpm_node_t;
+
+struct ogs_lpm_s {
+    int max_bits;
+
+    ogs_lpm_node_t *root;
+    void *default_data;         /* Prefix length 0 */
+
+    unsigned int count;
+};
+
+static ogs_lpm_node_t *node_alloc(void)
+{
+    ogs_lpm_node_t *node = ogs_calloc(1, sizeof(*node));
+    ogs_assert(node);
+
+    return node;
+}
+
+static void node_free(ogs_lpm_node_t *node)
+{
+    int i;
+
+    if (!node)
+        return;
+
+    for (i = 0; i < OGS_LPM_FANOUT; i++)
+        node_free(node->slot[i].child);
+
+    if (node->shorter)
+        ogs_free(node->shorter);
+    ogs_free(node);
+}
+
+ogs_lpm_t *ogs_lpm_create(int max_bits)
+{
+    ogs_lpm_t *lpm = NULL;
+
+    ogs_assert(max_bits > 0 && max_bits <= OGS_LPM_MAX_BITS);
+    ogs_assert((max_bits % OGS_LPM_STRIDE) == 0);
+
+    lpm = ogs_calloc(1, sizeof(*lpm));
+    ogs_assert(lpm);
+
+    lpm->max_bits = max_bits;
+    lpm->root = node_alloc();
+
+    return lpm;
+}
+
+void ogs_lpm_destroy(ogs_lpm_t *lpm)
+{
+    ogs_assert(lpm);
+
+    node_free(lpm->root);
+    ogs_free(lpm);
+}
+
+/*
+ * Walk down to the node holding a prefix of 'prefixlen' bits.
+ * On return, 'path' holds the nodes from the root, and the prefix
+ * has 1..8 bits in the last one.
+ */
+static int prefix_walk(ogs_lpm_t *lpm, const uint8_t *key, int prefixlen,
+        bool create, ogs_lpm_node_t **path)
+{
+    ogs_lpm_node_t *node = lpm->root;
+    int depth = 0;
+
+    path[0] = node;
+    while (prefixlen - depth * OGS_LPM_STRIDE > OGS_LPM_STRIDE) {
+        ogs_lpm_slot_t *slot = &node->slot[key[depth]];
+
+        if (!slot->child) {
+            if (!create)
+                return -1;
+            slot->child = node_alloc();
+            node->num_of_child++;
+        }
+
+        node = slot->child;
+        path[++depth] = node;
+    }
+
+    return depth;
+}
+
+/* Longest prefix shorter than 'bits' covering the slot */
+static int covering_prefix(ogs_lpm_node_t *node, int index, int bits)
+{
+    int k;
+
+    if (!node->shorter)
+        return 0;
+
+    for (k = bits - 1; k > 0; k--) {
+        if (node->shorter[(1 << k) + (index >> (OGS_LPM_STRIDE - k))])
+            return k;
+    }
+
+    return 0;
+}
+
+int ogs_lpm_add(ogs_lpm_t *lpm, const void *addr, int prefixlen, void *data)
+{
+    ogs_lpm_node_t *path[OGS_LPM_MAX_DEPTH];
+    ogs_lpm_node_t *node = NULL;
+    const uint8_t *key = addr;
+    int depth, bits, base, i;
+
+    ogs_assert(lpm);
+    ogs_assert(addr);
+    ogs_assert(data);
+
+    if (prefixlen < 0 || prefixlen > lpm->max_bits) {
+        ogs_error("Invalid prefix length [%d/%d]", prefixlen, lpm->max_bits);
+        return OGS_ERROR;
+    }
+
+    if (prefixlen == 0) {
+        if (!lpm->default_data)
+            lpm->count++;
+        lpm->default_data = data;
+        return OGS_OK;
+    }
+
+    depth = prefix_walk(lpm, key, prefixlen, true, path);
+    node = path[depth];
+
+    bits = prefixlen - depth * OGS_LPM_STRIDE;
+    base = key[depth] & (0xff << (OGS_LPM_STRIDE - bits)) & 0xff;
+
+    if (bits < OGS_LPM_STRIDE) {
+        int index = (1 << bits) + (base >> (OGS_LPM_STRIDE - bits));
+
+        if (!node->shorter) {
+            node->shorter = ogs_calloc(OGS_LPM_FANOUT, sizeof(void *));
+            ogs_assert(node->shorter);
+        }
+        if (!node->shorter[index]) {
+            node->num_of_prefix++;
+            lpm->count++;
+        }
+        node->shorter[index] = data;
+    } else if (node->plen[base] != OGS_LPM_STRIDE) {
+        node->num_of_prefix++;
+        lpm->count++;
+    }
+
+    for (i = base; i < base + (1 << (OGS_LPM_STRIDE - bits)); i++) {
+        if (node->plen[i] <= bits) {
+            node->plen[i] = bits;
+            node->slot[i].data = data;
+        }
+    }
+
+    return OGS_OK;
+}
+
+int ogs_lpm_remove(ogs_lpm_t *lpm, const void *addr, int prefixlen)
+{
+    ogs_lpm_node_t *path[OGS_LPM_MAX_DEPTH];
+    ogs_lpm_node_t *node = NULL;
+    const uint8_t *key = addr;
+    int depth, bits, base, i;
+
+    ogs_assert(lpm);
+    ogs_assert(addr);
+
+    if (prefixlen < 0 || prefixlen > lpm->max_bits) {
+        ogs_error("Invalid prefix length [%d/%d]", prefixlen, lpm->max_bits);
+        return OGS_ERROR;
+    }
+
+    if (prefixlen == 0) {
+        if (!lpm->default_data)
+            return OGS_ERROR;
+        lpm->default_data = NULL;
+        lpm->count--;
+        return OGS_OK;
+    }
+
+    depth = prefix_walk(lpm, key, prefixlen, false, path);
+    if (depth < 0)
+        return OGS_ERROR;
+    node = path[depth];
+
+    bits = prefixlen - depth * OGS_LPM_STRIDE;
+    base = key[depth] & (0xff << (OGS_LPM_STRIDE - bits)) & 0xff;
+
+    if (bits < OGS_LPM_STRIDE) {
+        int index = (1 << bits) + (base >> (OGS_LPM_STRIDE - bits));
+
+        if (!node->shorter || !node->shorter[index])
+            return OGS_ERROR;
+        node->shorter[index] = NULL;
+    } else if (node->plen[base] != OGS_LPM_STRIDE) {
+        return OGS_ERROR;
+    }
+
+    node->num_of_prefix--;
+    lpm->count--;
+
+    for (i = base; i < base + (1 << (OGS_LPM_STRIDE - bits)); i++) {
+        int k;
+
+        if (node->plen[i] != bits)
+            continue;
+
+        k = covering_prefix(node, i, bits);
+        node->plen[i] = k;
+        node->slot[i].data = k ?
+            node->shorter[(1 << k) + (i >> (OGS_LPM_STRIDE - k))] : NULL;
+    }
+
+    /* Release the nodes left empty, but keep the root */
+    while (depth > 0 && !node->num_of_child && !node->num_of_prefix) {
+        ogs_lpm_node_t *parent = path[depth - 1];
+
+        parent->slot[key[depth - 1]].child = NULL;
+        parent->num_of_child--;
+        node_free(node);
+
+        node = parent;
+        depth--;
+    }
+
+    return OGS_OK;
+}
+
+void *ogs_lpm_get(ogs_lpm_t *lpm, const void *addr, int prefixlen)
+{
+    ogs_lpm_node_t *path[OGS_LPM_MAX_DEPTH];
+    ogs_lpm_node_t *node = NULL;
+    const uint8_t *key = addr;
+    int depth, bits, base;
+
+    ogs_assert(lpm);
+    ogs_assert(addr);
+
+    if (prefixlen < 0 || prefixlen > lpm->max_bits)
+        return NULL;
+
+    if (prefixlen == 0)
+        return lpm->default_data;
+
+    depth = prefix_walk(lpm, key, prefixlen, false, path);
+    if (depth < 0)
+        return NULL;
+    node = path[depth];
+
+    bits = prefixlen - depth * OGS_LPM_STRIDE;
+    base = key[depth] & (0xff << (OGS_LPM_STRIDE - bits)) & 0xff;
+
+    if (bits < OGS_LPM_STRIDE)
+        return node->shorter ?
+            node->shorter[(1 << bits) + (base >> (OGS_LPM_STRIDE - bits))] :
+            NULL;
+
+    return node->plen[base] == OGS_LPM_STRIDE ? node->slot[base].data : NULL;
+}
+
+void *ogs_lpm_find(ogs_lpm_t *lpm, const void *addr)
+{
+    ogs_lpm_node_t *node = NULL;
+    const uint8_t *key = addr;
+    void *data = NULL;
+    int depth;
+
+    ogs_assert(lpm);
+    ogs_assert(addr);
+
+    data = lpm->default_data;
+    node = lpm->root;
+
+    for (depth = 0; node; depth++) {
+        ogs_lpm_slot_t *slot = &node->slot[key[depth]];
+
+        /* A prefix found deeper is always longer */
+        if (slot->data)
+            data = slot->data;
+        node = slot->child;
+    }
+
+    return data;
+}
+
+unsigned int ogs_lpm_count(ogs_lpm_t *lpm)
+{
+    ogs_assert(lpm);
+    return lpm->count;
+}
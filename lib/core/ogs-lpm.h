@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2019-2023 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined(OGS_CORE_INSIDE) && !defined(OGS_CORE_COMPILATION)
+#error "This header cannot be included directly."
+#endif
+
+#ifndef OGS_LPM_H
+#define OGS_LPM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Longest prefix match table
+ *
+ * A multibit trie with an 8-bit stride. Prefixes are expanded
+ * into the slots of one node, so a lookup reads at most one slot
+ * per address byte: 4 for IPv4, 16 for IPv6.
+ *
+ * Addresses are in network byte order. Nodes are allocated only
+ * for populated prefixes and freed when they become empty.
+ */
+typedef struct ogs_lpm_s ogs_lpm_t;
+
+ogs_lpm_t *ogs_lpm_create(int max_bits);
+void ogs_lpm_destroy(ogs_lpm_t *lpm);
+
+/* An existing entry with the same prefix is replaced */
+int ogs_lpm_add(ogs_lpm_t *lpm, const void *addr, int prefixlen, void *data);
+int ogs_lpm_remove(ogs_lpm_t *lpm, const void *addr, int prefixlen);
+
+/* Exact match on the prefix, NULL if it was not added */
+void *ogs_lpm_get(ogs_lpm_t *lpm, const void *addr, int prefixlen);
+/* Longest prefix match on the address */
+void *ogs_lpm_find(ogs_lpm_t *lpm, const void *addr);
+
+unsigned int ogs_lpm_count(ogs_lpm_t *lpm);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OGS_LPM_H */
@@ -50,6 +50,12 @@ extern "C" {
 #define OGS_FUNC __func__
 #endif
 
+#if defined(_MSC_VER)
+#define OGS_THREAD_LOCAL __declspec(thread)
+#else
+#define OGS_THREAD_LOCAL __thread
+#endif
+
 #if defined(__GNUC__)
 #define ogs_likely(x) __builtin_expect (!!(x), 1)
 #define ogs_unlikely(x) __builtin_expect (!!(x), 0)
@@ -30,6 +30,9 @@ void *__ogs_talloc_core;
 
 static ogs_thread_mutex_t mutex;
 
+static void cache_init(void);
+static void cache_final(void);
+
 void ogs_mem_init(void)
 {
     ogs_thread_mutex_init(&mutex);
@@ -38,10 +41,17 @@ void ogs_mem_init(void)
 
 #define TALLOC_MEMSIZE 1
     __ogs_talloc_core = talloc_named_const(NULL, TALLOC_MEMSIZE, "core");
+
+    cache_init();
 }
 
 void ogs_mem_final(void)
 {
+    if (ogs_mem_total_blocks())
+        ogs_mem_report_full(stderr);
+
+    cache_final();
+
     if (talloc_total_size(__ogs_talloc_core) != TALLOC_MEMSIZE)
         talloc_report_full(__ogs_talloc_core, stderr);
 
@@ -111,6 +121,548 @@ int ogs_talloc_free(void *ptr, const char *location)
     return ret;
 }
 
+/*****************************************
+ * Memory Pool - Use per-thread size classes
+ *****************************************/
+
+/*
+ * Blocks up to 32KB come from fixed size classes. Each thread keeps
+ * a magazine of free blocks per class, refilled from and spilled to
+ * a global depot in bulk, so the depot lock is taken once per
+ * OGS_MEM_BULK blocks at most. A block freed on another thread
+ * just goes into the magazine of that thread.
+ *
+ * Larger blocks come from malloc() and are kept in a list.
+ *
+ * Every block starts with a header naming the allocation site,
+ * which ogs_mem_report_full() prints for each live block.
+ */
+#define OGS_MEM_NUM_OF_CLASS 22
+#define OGS_MEM_MAX_SIZE 32768
+#define OGS_MEM_INDEX_SIZE 4096
+
+#define OGS_MEM_CACHE_SIZE 64
+#define OGS_MEM_CACHE_BYTES (64*1024)
+#define OGS_MEM_SLAB_SIZE (64*1024)
+#define OGS_MEM_SLAB_MIN_BLOCK 8
+
+#define OGS_MEM_MAGIC 0x6f67
+#define OGS_MEM_CLASS_LARGE 0xff
+
+#define OGS_MEM_ALIGN(__sIZE) (((__sIZE) + 15) & ~((size_t)15))
+
+typedef struct ogs_mem_hdr_s {
+    const char *location;
+    uint32_t size;
+    uint8_t class;
+    uint8_t allocated;
+    uint16_t magic;
+} ogs_mem_hdr_t;
+
+#define OGS_MEM_HDR_SIZE OGS_MEM_ALIGN(sizeof(ogs_mem_hdr_t))
+#define OGS_MEM_HDR(__pTR) \
+    ((ogs_mem_hdr_t *)((unsigned char *)(__pTR) - OGS_MEM_HDR_SIZE))
+#define OGS_MEM_PTR(__hDR) ((unsigned char *)(__hDR) + OGS_MEM_HDR_SIZE)
+
+/* A block freed to the depot is linked through its data */
+#define OGS_MEM_NEXT(__hDR) (*(ogs_mem_hdr_t **)OGS_MEM_PTR(__hDR))
+
+typedef struct ogs_mem_slab_s {
+    struct ogs_mem_slab_s *next;
+    int num;
+} ogs_mem_slab_t;
+
+#define OGS_MEM_SLAB_HDR_SIZE OGS_MEM_ALIGN(sizeof(ogs_mem_slab_t))
+
+typedef struct ogs_mem_large_s {
+    ogs_lnode_t lnode;
+} ogs_mem_large_t;
+
+#define OGS_MEM_LARGE_HDR_SIZE OGS_MEM_ALIGN(sizeof(ogs_mem_large_t))
+
+static const uint32_t class_size[OGS_MEM_NUM_OF_CLASS] = {
+    16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768,
+    1024, 1536, 2048, 3072, 4096, 6144, 8192, 12288, 16384, 24576, 32768
+};
+static uint8_t class_index[(OGS_MEM_INDEX_SIZE >> 4) + 1];
+static int class_depth[OGS_MEM_NUM_OF_CLASS];
+
+static struct {
+    ogs_thread_mutex_t mutex;
+    ogs_mem_hdr_t *free;
+    ogs_mem_slab_t *slab;
+} depot[OGS_MEM_NUM_OF_CLASS];
+
+typedef struct ogs_mem_cache_s {
+    ogs_lnode_t lnode;
+
+    struct {
+        int num;
+        ogs_mem_hdr_t *hdr[OGS_MEM_CACHE_SIZE];
+    } mag[OGS_MEM_NUM_OF_CLASS];
+
+    /* Allocated minus freed by the threads using this cache */
+    int64_t size;
+    int64_t blocks;
+
+    bool idle;
+} ogs_mem_cache_t;
+
+static OGS_LIST(cache_list);
+static ogs_thread_mutex_t cache_mutex;
+static OGS_THREAD_LOCAL ogs_mem_cache_t *self_cache = NULL;
+#if !defined(_WIN32)
+static pthread_key_t cache_key;
+#endif
+
+static OGS_LIST(large_list);
+static ogs_thread_mutex_t large_mutex;
+
+static void depot_put(int class, ogs_mem_hdr_t **hdr, int num);
+
+#if !defined(_WIN32)
+/* The next thread takes over the cache of an exited one */
+static void cache_exit(void *data)
+{
+    ogs_mem_cache_t *cache = data;
+    int class;
+
+    ogs_assert(cache);
+
+    for (class = 0; class < OGS_MEM_NUM_OF_CLASS; class++) {
+        depot_put(class, cache->mag[class].hdr, cache->mag[class].num);
+        cache->mag[class].num = 0;
+    }
+
+    ogs_thread_mutex_lock(&cache_mutex);
+    cache->idle = true;
+    ogs_thread_mutex_unlock(&cache_mutex);
+
+    self_cache = NULL;
+}
+#endif
+
+static void cache_init(void)
+{
+    int class, i;
+
+    for (class = 0, i = 0; i <= (OGS_MEM_INDEX_SIZE >> 4); i++) {
+        if ((i << 4) > class_size[class])
+            class++;
+        class_index[i] = class;
+    }
+
+    for (class = 0; class < OGS_MEM_NUM_OF_CLASS; class++) {
+        class_depth[class] = ogs_min(OGS_MEM_CACHE_SIZE,
+                ogs_max(4, OGS_MEM_CACHE_BYTES / (int)class_size[class]));
+
+        ogs_thread_mutex_init(&depot[class].mutex);
+        depot[class].free = NULL;
+        depot[class].slab = NULL;
+    }
+
+    ogs_list_init(&cache_list);
+    ogs_thread_mutex_init(&cache_mutex);
+#if !defined(_WIN32)
+    ogs_assert(pthread_key_create(&cache_key, cache_exit) == 0);
+#endif
+
+    ogs_list_init(&large_list);
+    ogs_thread_mutex_init(&large_mutex);
+}
+
+static void cache_final(void)
+{
+    ogs_mem_cache_t *cache = NULL, *next_cache = NULL;
+    ogs_mem_large_t *large = NULL, *next_large = NULL;
+    int class;
+
+#if !defined(_WIN32)
+    pthread_key_delete(cache_key);
+#endif
+    ogs_list_for_each_safe(&cache_list, next_cache, cache) {
+        ogs_list_remove(&cache_list, cache);
+        free(cache);
+    }
+    self_cache = NULL;
+    ogs_thread_mutex_destroy(&cache_mutex);
+
+    for (class = 0; class < OGS_MEM_NUM_OF_CLASS; class++) {
+        while (depot[class].slab) {
+            ogs_mem_slab_t *slab = depot[class].slab;
+            depot[class].slab = slab->next;
+            free(slab);
+        }
+        depot[class].free = NULL;
+        ogs_thread_mutex_destroy(&depot[class].mutex);
+    }
+
+    ogs_list_for_each_safe(&large_list, next_large, large) {
+        ogs_list_remove(&large_list, large);
+        free(large);
+    }
+    ogs_thread_mutex_destroy(&large_mutex);
+}
+
+static ogs_mem_cache_t *cache_self(void)
+{
+    ogs_mem_cache_t *cache = NULL;
+
+    if (ogs_likely(self_cache))
+        return self_cache;
+
+    ogs_thread_mutex_lock(&cache_mutex);
+
+    ogs_list_for_each(&cache_list, cache) {
+        if (cache->idle)
+            break;
+    }
+    if (cache) {
+        cache->idle = false;
+    } else {
+        cache = calloc(1, sizeof(*cache));
+        ogs_assert(cache);
+        ogs_list_add(&cache_list, cache);
+    }
+
+    ogs_thread_mutex_unlock(&cache_mutex);
+
+#if !defined(_WIN32)
+    pthread_setspecific(cache_key, cache);
+#endif
+    self_cache = cache;
+
+    return cache;
+}
+
+static int size_class(size_t size)
+{
+    int class;
+
+    if (ogs_likely(size <= OGS_MEM_INDEX_SIZE))
+        return class_index[(size + 15) >> 4];
+
+    for (class = class_index[OGS_MEM_INDEX_SIZE >> 4];
+            class < OGS_MEM_NUM_OF_CLASS; class++) {
+        if (size <= class_size[class])
+            return class;
+    }
+
+    return -1;
+}
+
+/* Carve a new slab into free blocks; the depot must be locked */
+static bool depot_grow(int class)
+{
+    ogs_mem_slab_t *slab = NULL;
+    size_t block_size = OGS_MEM_HDR_SIZE + class_size[class];
+    size_t slab_size;
+    int i;
+
+    slab_size = ogs_max(OGS_MEM_SLAB_SIZE, OGS_MEM_SLAB_HDR_SIZE +
+            OGS_MEM_SLAB_MIN_BLOCK * block_size);
+
+    slab = malloc(slab_size);
+    if (!slab) {
+        ogs_error("malloc() failed [size=%d]", (int)slab_size);
+        return false;
+    }
+
+    slab->num = (slab_size - OGS_MEM_SLAB_HDR_SIZE) / block_size;
+    slab->next = depot[class].slab;
+    depot[class].slab = slab;
+
+    for (i = slab->num - 1; i >= 0; i--) {
+        ogs_mem_hdr_t *hdr = (ogs_mem_hdr_t *)((unsigned char *)slab +
+                OGS_MEM_SLAB_HDR_SIZE + i * block_size);
+
+        hdr->location = NULL;
+        hdr->size = 0;
+        hdr->class = class;
+        hdr->allocated = 0;
+        hdr->magic = OGS_MEM_MAGIC;
+
+        OGS_MEM_NEXT(hdr) = depot[class].free;
+        depot[class].free = hdr;
+    }
+
+    return true;
+}
+
+static int depot_get(int class, ogs_mem_hdr_t **hdr, int num)
+{
+    int n;
+
+    ogs_thread_mutex_lock(&depot[class].mutex);
+
+    for (n = 0; n < num; n++) {
+        if (!depot[class].free && !depot_grow(class))
+            break;
+
+        hdr[n] = depot[class].free;
+        depot[class].free = OGS_MEM_NEXT(hdr[n]);
+    }
+
+    ogs_thread_mutex_unlock(&depot[class].mutex);
+
+    return n;
+}
+
+static void depot_put(int class, ogs_mem_hdr_t **hdr, int num)
+{
+    int i;
+
+    if (!num)
+        return;
+
+    for (i = 0; i < num - 1; i++)
+        OGS_MEM_NEXT(hdr[i]) = hdr[i+1];
+
+    ogs_thread_mutex_lock(&depot[class].mutex);
+
+    OGS_MEM_NEXT(hdr[num-1]) = depot[class].free;
+    depot[class].free = hdr[0];
+
+    ogs_thread_mutex_unlock(&depot[class].mutex);
+}
+
+static ogs_mem_hdr_t *large_alloc(size_t size)
+{
+    ogs_mem_large_t *large = NULL;
+
+    large = malloc(OGS_MEM_LARGE_HDR_SIZE + OGS_MEM_HDR_SIZE + size);
+    if (!large) {
+        ogs_error("malloc() failed [size=%d]", (int)size);
+        return NULL;
+    }
+
+    ogs_thread_mutex_lock(&large_mutex);
+    ogs_list_add(&large_list, large);
+    ogs_thread_mutex_unlock(&large_mutex);
+
+    return (ogs_mem_hdr_t *)((unsigned char *)large + OGS_MEM_LARGE_HDR_SIZE);
+}
+
+static ogs_mem_large_t *large_of(ogs_mem_hdr_t *hdr)
+{
+    return (ogs_mem_large_t *)((unsigned char *)hdr - OGS_MEM_LARGE_HDR_SIZE);
+}
+
+void *ogs_mem_malloc(size_t size, const char *location)
+{
+    ogs_mem_cache_t *cache = NULL;
+    ogs_mem_hdr_t *hdr = NULL;
+    int class;
+
+    if (ogs_unlikely(size > UINT32_MAX)) {
+        ogs_error("Invalid size [%lu] in (%s)", (unsigned long)size, location);
+        return NULL;
+    }
+
+    cache = cache_self();
+
+    class = size_class(size);
+    if (ogs_likely(class >= 0)) {
+#define mag cache->mag[class]
+        if (ogs_unlikely(!mag.num)) {
+            mag.num = depot_get(class, mag.hdr, class_depth[class] / 2);
+            if (!mag.num) {
+                ogs_error("ogs_mem_malloc() failed [size=%d] in (%s)",
+                        (int)size, location);
+                return NULL;
+            }
+        }
+
+        hdr = mag.hdr[--mag.num];
+#undef mag
+        ogs_assert(hdr->magic == OGS_MEM_MAGIC);
+        ogs_assert(!hdr->allocated);
+    } else {
+        hdr = large_alloc(size);
+        if (!hdr)
+            return NULL;
+
+        hdr->class = OGS_MEM_CLASS_LARGE;
+        hdr->magic = OGS_MEM_MAGIC;
+    }
+
+    hdr->location = location;
+    hdr->size = size;
+    hdr->allocated = 1;
+
+    cache->size += size;
+    cache->blocks++;
+
+    return OGS_MEM_PTR(hdr);
+}
+
+void *ogs_mem_calloc(size_t nmemb, size_t size, const char *location)
+{
+    void *ptr = NULL;
+
+    if (size && nmemb > SIZE_MAX / size) {
+        ogs_error("Invalid size [%lu*%lu] in (%s)",
+                (unsigned long)nmemb, (unsigned long)size, location);
+        return NULL;
+    }
+
+    ptr = ogs_mem_malloc(nmemb * size, location);
+    if (!ptr)
+        return NULL;
+
+    memset(ptr, 0, nmemb * size);
+    return ptr;
+}
+
+void *ogs_mem_realloc(void *ptr, size_t size, const char *location)
+{
+    ogs_mem_cache_t *cache = NULL;
+    ogs_mem_hdr_t *hdr = NULL;
+    void *new = NULL;
+
+    if (!ptr)
+        return ogs_mem_malloc(size, location);
+
+    if (!size) {
+        ogs_mem_free(ptr);
+        return NULL;
+    }
+
+    hdr = OGS_MEM_HDR(ptr);
+    ogs_assert(hdr->magic == OGS_MEM_MAGIC);
+    ogs_assert(hdr->allocated);
+
+    if (hdr->class != OGS_MEM_CLASS_LARGE && size <= class_size[hdr->class]) {
+        cache = cache_self();
+        cache->size += (int64_t)size - hdr->size;
+
+        hdr->location = location;
+        hdr->size = size;
+        return ptr;
+    }
+
+    new = ogs_mem_malloc(size, location);
+    if (!new)
+        return NULL;
+
+    memcpy(new, ptr, ogs_min(hdr->size, size));
+    ogs_mem_free(ptr);
+
+    return new;
+}
+
+int ogs_mem_free(void *ptr)
+{
+    ogs_mem_cache_t *cache = NULL;
+    ogs_mem_hdr_t *hdr = NULL;
+    int class;
+
+    if (!ptr)
+        return OGS_ERROR;
+
+    hdr = OGS_MEM_HDR(ptr);
+    ogs_assert(hdr->magic == OGS_MEM_MAGIC);
+    /* Double free */
+    ogs_assert(hdr->allocated);
+
+    hdr->allocated = 0;
+
+    cache = cache_self();
+    cache->size -= hdr->size;
+    cache->blocks--;
+
+    class = hdr->class;
+    if (ogs_unlikely(class == OGS_MEM_CLASS_LARGE)) {
+        ogs_mem_large_t *large = large_of(hdr);
+
+        ogs_thread_mutex_lock(&large_mutex);
+        ogs_list_remove(&large_list, large);
+        ogs_thread_mutex_unlock(&large_mutex);
+
+        free(large);
+        return OGS_OK;
+    }
+
+#define mag cache->mag[class]
+    if (ogs_unlikely(mag.num == class_depth[class])) {
+        mag.num -= class_depth[class] / 2;
+        depot_put(class, &mag.hdr[mag.num], class_depth[class] / 2);
+    }
+
+    mag.hdr[mag.num++] = hdr;
+#undef mag
+
+    return OGS_OK;
+}
+
+size_t ogs_mem_total_size(void)
+{
+    ogs_mem_cache_t *cache = NULL;
+    int64_t size = 0;
+
+    ogs_thread_mutex_lock(&cache_mutex);
+    ogs_list_for_each(&cache_list, cache)
+        size += cache->size;
+    ogs_thread_mutex_unlock(&cache_mutex);
+
+    return size;
+}
+
+size_t ogs_mem_total_blocks(void)
+{
+    ogs_mem_cache_t *cache = NULL;
+    int64_t blocks = 0;
+
+    ogs_thread_mutex_lock(&cache_mutex);
+    ogs_list_for_each(&cache_list, cache)
+        blocks += cache->blocks;
+    ogs_thread_mutex_unlock(&cache_mutex);
+
+    return blocks;
+}
+
+static void report_block(ogs_mem_hdr_t *hdr, FILE *f)
+{
+    if (hdr->allocated)
+        fprintf(f, "    %-30s contains %6lu bytes\n",
+                hdr->location, (unsigned long)hdr->size);
+}
+
+/*
+ * Live blocks are read while other threads may allocate and free,
+ * so a report taken at run time is only a snapshot.
+ */
+void ogs_mem_report_full(FILE *f)
+{
+    ogs_mem_large_t *large = NULL;
+    int class, i;
+
+    ogs_assert(f);
+
+    fprintf(f, "full memory report (total %6lu bytes in %3lu blocks)\n",
+            (unsigned long)ogs_mem_total_size(),
+            (unsigned long)ogs_mem_total_blocks());
+
+    for (class = 0; class < OGS_MEM_NUM_OF_CLASS; class++) {
+        ogs_mem_slab_t *slab = NULL;
+        size_t block_size = OGS_MEM_HDR_SIZE + class_size[class];
+
+        ogs_thread_mutex_lock(&depot[class].mutex);
+        for (slab = depot[class].slab; slab; slab = slab->next) {
+            for (i = 0; i < slab->num; i++)
+                report_block((ogs_mem_hdr_t *)((unsigned char *)slab +
+                            OGS_MEM_SLAB_HDR_SIZE + i * block_size), f);
+        }
+        ogs_thread_mutex_unlock(&depot[class].mutex);
+    }
+
+    ogs_thread_mutex_lock(&large_mutex);
+    ogs_list_for_each(&large_list, large)
+        report_block((ogs_mem_hdr_t *)
+                ((unsigned char *)large + OGS_MEM_LARGE_HDR_SIZE), f);
+    ogs_thread_mutex_unlock(&large_mutex);
+}
+
 /*****************************************
  * Memory Pool - Use pkbuf library
  *****************************************/
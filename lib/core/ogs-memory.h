@@ -51,6 +51,15 @@ void *ogs_talloc_realloc_size(
         const void *context, void *oldptr, size_t size, const char *name);
 int ogs_talloc_free(void *ptr, const char *location);
 
+void *ogs_mem_malloc(size_t size, const char *location);
+void *ogs_mem_calloc(size_t nmemb, size_t size, const char *location);
+void *ogs_mem_realloc(void *ptr, size_t size, const char *location);
+int ogs_mem_free(void *ptr);
+
+size_t ogs_mem_total_size(void);
+size_t ogs_mem_total_blocks(void);
+void ogs_mem_report_full(FILE *f);
+
 void *ogs_malloc_debug(size_t size, const char *file_line);
 void *ogs_calloc_debug(
         size_t nmemb, size_t size, const char *file_line);
@@ -61,16 +70,18 @@ int ogs_free_debug(void *ptr);
 #if OGS_USE_TALLOC == 1
 
 /*****************************************
- * Memory Pool - Use talloc library
+ * Memory Pool - Use per-thread size classes
+ *
+ * ogs_malloc() does not use talloc or its mutex. Memory from
+ * ogs_malloc() must not be passed to talloc functions, and memory
+ * from ogs_talloc_size() must be freed with ogs_talloc_free().
  *****************************************/
 
-#define ogs_malloc(size) \
-    ogs_talloc_size(__ogs_talloc_core, size, __location__)
-#define ogs_calloc(nmemb, size) \
-    ogs_talloc_zero_size(__ogs_talloc_core, (nmemb) * (size), __location__)
+#define ogs_malloc(size) ogs_mem_malloc(size, __location__)
+#define ogs_calloc(nmemb, size) ogs_mem_calloc(nmemb, size, __location__)
 #define ogs_realloc(oldptr, size) \
-    ogs_talloc_realloc_size(__ogs_talloc_core, oldptr, size, __location__)
-#define ogs_free(ptr) ogs_talloc_free(ptr, __location__)
+    ogs_mem_realloc(oldptr, size, __location__)
+#define ogs_free(ptr) ogs_mem_free(ptr)
 
 #else
 
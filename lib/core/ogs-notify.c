@@ -48,7 +48,7 @@ void ogs_notify_init(ogs_pollset_t *pollset)
 #endif
 
     pollset->notify.poll = ogs_pollset_add(pollset, OGS_POLLIN,
-            pollset->notify.fd[0], ogs_drain_pollset, NULL);
+            pollset->notify.fd[0], ogs_drain_pollset, pollset);
     ogs_assert(pollset->notify.poll);
 }
 
@@ -76,6 +76,10 @@ int ogs_notify_pollset(ogs_pollset_t *pollset)
 
     ogs_assert(pollset);
 
+    /* A burst of notifications costs one write */
+    if (__atomic_exchange_n(&pollset->notify.pending, 1, __ATOMIC_ACQ_REL))
+        return OGS_OK;
+
 #if defined(HAVE_EVENTFD)
     r = write(pollset->notify.fd[0], (void*)&msg, sizeof(msg));
 #else
@@ -84,6 +88,7 @@ int ogs_notify_pollset(ogs_pollset_t *pollset)
 
     if (r < 0) {
         ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno, "notify failed");
+        __atomic_store_n(&pollset->notify.pending, 0, __ATOMIC_RELEASE);
         return OGS_ERROR;
     }
 
@@ -92,6 +97,7 @@ int ogs_notify_pollset(ogs_pollset_t *pollset)
 
 static void ogs_drain_pollset(short when, ogs_socket_t fd, void *data)
 {
+    ogs_pollset_t *pollset = data;
     ssize_t r;
 #if defined(HAVE_EVENTFD)
     uint64_t msg;
@@ -109,4 +115,10 @@ static void ogs_drain_pollset(short when, ogs_socket_t fd, void *data)
     if (r < 0) {
         ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno, "drain failed");
     }
+
+    /*
+     * Cleared only after draining. Anything notified in between is
+     * still seen by the loop after ogs_pollset_poll() returns.
+     */
+    __atomic_exchange_n(&pollset->notify.pending, 0, __ATOMIC_ACQ_REL);
 }
@@ -86,6 +86,53 @@ static ogs_cluster_t *cluster_alloc(
 static void cluster_free(ogs_pkbuf_pool_t *pool, ogs_cluster_t *cluster);
 #endif
 
+/*
+ * Per-thread pkbuf cache
+ *
+ * Freed pkbufs of an explicit pool are kept per thread
+ * in a magazine for each size class, and handed out again without
+ * taking any mutex. An empty magazine is refilled from the pool, and
+ * a full one spilled back, OGS_PKBUF_CACHE_BULK pkbufs under one lock.
+ *
+ * The default pool (NULL) is not cached. pkbufs of a cached pool
+ * are allocated with the size rounded up to the class.
+ */
+#define OGS_PKBUF_CACHE_NUM_OF_POOL     4
+#define OGS_PKBUF_CACHE_NUM_OF_CLASS    5   /* 128 .. 2048 */
+#define OGS_PKBUF_CACHE_SIZE            64
+#define OGS_PKBUF_CACHE_BULK            32
+
+#define OGS_PKBUF_CACHE_CLASS_SIZE(__cLASS) (128 << (__cLASS))
+
+typedef struct ogs_pkbuf_cache_s {
+    ogs_lnode_t lnode;
+
+    struct {
+        ogs_pkbuf_pool_t *pool;
+
+        struct {
+            int num;
+            ogs_pkbuf_t *pkbuf[OGS_PKBUF_CACHE_SIZE];
+        } mag[OGS_PKBUF_CACHE_NUM_OF_CLASS];
+
+        ogs_pkbuf_pool_stat_t stat;
+    } slot[OGS_PKBUF_CACHE_NUM_OF_POOL];
+} ogs_pkbuf_cache_t;
+
+static ogs_list_t cache_list;
+static ogs_thread_mutex_t cache_mutex;
+static OGS_THREAD_LOCAL ogs_pkbuf_cache_t *self_cache = NULL;
+#if !defined(_WIN32)
+static pthread_key_t cache_key;
+#endif
+
+static ogs_pkbuf_t *cache_alloc(ogs_pkbuf_pool_t *pool, unsigned int size);
+static bool cache_free(ogs_pkbuf_t *pkbuf);
+static void cache_purge(ogs_pkbuf_pool_t *pool);
+#if !defined(_WIN32)
+static void cache_exit(void *data);
+#endif
+
 void *ogs_pkbuf_put_data(
         ogs_pkbuf_t *pkbuf, const void *data, unsigned int len)
 {
@@ -100,11 +147,31 @@ void ogs_pkbuf_init(void)
 #if OGS_USE_TALLOC == 0
     ogs_pool_init(&pkbuf_pool, ogs_core()->pkbuf.pool);
 
+#endif
+    ogs_list_init(&cache_list);
+    ogs_thread_mutex_init(&cache_mutex);
+#if !defined(_WIN32)
+    ogs_assert(pthread_key_create(&cache_key, cache_exit) == 0);
 #endif
 }
 
 void ogs_pkbuf_final(void)
 {
+    ogs_pkbuf_cache_t *cache = NULL, *next_cache = NULL;
+
+    /* Pools that were not destroyed */
+    cache_purge(NULL);
+
+#if !defined(_WIN32)
+    pthread_key_delete(cache_key);
+#endif
+    ogs_list_for_each_safe(&cache_list, next_cache, cache) {
+        ogs_list_remove(&cache_list, cache);
+        free(cache);
+    }
+    self_cache = NULL;
+    ogs_thread_mutex_destroy(&cache_mutex);
+
 #if OGS_USE_TALLOC == 0
     ogs_pool_final(&pkbuf_pool);
 #endif
@@ -196,6 +263,10 @@ ogs_pkbuf_pool_t *ogs_pkbuf_pool_create(ogs_pkbuf_config_t *config)
 
 void ogs_pkbuf_pool_destroy(ogs_pkbuf_pool_t *pool)
 {
+    /* No other thread may use the pool any more */
+    if (pool)
+        cache_purge(pool);
+
 #if OGS_USE_TALLOC == 0
     ogs_assert(pool);
 
@@ -223,12 +294,25 @@ ogs_pkbuf_t *ogs_pkbuf_alloc_debug(
 #if OGS_USE_TALLOC == 1
     ogs_pkbuf_t *pkbuf = NULL;
 
-    pkbuf = ogs_talloc_zero_size(pool, sizeof(*pkbuf) + size, file_line);
+    if (pool) {
+        pkbuf = cache_alloc(pool, size);
+        if (pkbuf) {
+            pkbuf->file_line = file_line; /* For debug */
+            return pkbuf;
+        }
+    }
+
+    if (pool)
+        pkbuf = ogs_talloc_zero_size(pool, sizeof(*pkbuf) + size, file_line);
+    else
+        pkbuf = ogs_mem_calloc(1, sizeof(*pkbuf) + size, file_line);
     if (!pkbuf) {
         ogs_error("ogs_pkbuf_alloc() failed [size=%d]", size);
         return NULL;
     }
 
+    pkbuf->pool = pool;
+
     pkbuf->head = pkbuf->_data;
     pkbuf->end = pkbuf->_data + size;
 
@@ -244,6 +328,14 @@ ogs_pkbuf_t *ogs_pkbuf_alloc_debug(
     ogs_pkbuf_t *pkbuf = NULL;
     ogs_cluster_t *cluster = NULL;
 
+    if (pool) {
+        pkbuf = cache_alloc(pool, size);
+        if (pkbuf) {
+            pkbuf->file_line = file_line; /* For debug */
+            return pkbuf;
+        }
+    }
+
     if (pool == NULL)
         pool = default_pool;
     ogs_assert(pool);
@@ -289,12 +381,24 @@ ogs_pkbuf_t *ogs_pkbuf_alloc_debug(
 void ogs_pkbuf_free(ogs_pkbuf_t *pkbuf)
 {
 #if OGS_USE_TALLOC == 1
-    ogs_talloc_free(pkbuf, OGS_FILE_LINE);
+    if (!pkbuf)
+        return;
+
+    if (cache_free(pkbuf))
+        return;
+
+    if (pkbuf->pool)
+        ogs_talloc_free(pkbuf, OGS_FILE_LINE);
+    else
+        ogs_mem_free(pkbuf);
 #else
     ogs_pkbuf_pool_t *pool = NULL;
     ogs_cluster_t *cluster = NULL;
     ogs_assert(pkbuf);
 
+    if (cache_free(pkbuf))
+        return;
+
     pool = pkbuf->pool;
     ogs_assert(pool);
 
@@ -340,13 +444,13 @@ ogs_pkbuf_t *ogs_pkbuf_copy_debug(ogs_pkbuf_t *pkbuf, const char *file_line)
     }
 
     /* copy data */
-    memcpy(newbuf->_data, pkbuf->_data, size);
+    memcpy(newbuf->_data, pkbuf->head, size);
 
     /* copy header */
     newbuf->len = pkbuf->len;
 
-    newbuf->tail += pkbuf->tail - pkbuf->_data;
-    newbuf->data += pkbuf->data - pkbuf->_data;
+    newbuf->tail += pkbuf->tail - pkbuf->head;
+    newbuf->data += pkbuf->data - pkbuf->head;
 
     return newbuf;
 #else
@@ -491,3 +595,362 @@ static void cluster_free(ogs_pkbuf_pool_t *pool, ogs_cluster_t *cluster)
     ogs_pool_free(&pool->cluster, cluster);
 }
 #endif
+
+static ogs_pkbuf_cache_t *cache_self(void)
+{
+    if (ogs_unlikely(!self_cache)) {
+        /* Not from ogs_calloc(), which may itself use a pkbuf */
+        self_cache = calloc(1, sizeof(*self_cache));
+        ogs_assert(self_cache);
+
+        ogs_thread_mutex_lock(&cache_mutex);
+        ogs_list_add(&cache_list, self_cache);
+        ogs_thread_mutex_unlock(&cache_mutex);
+#if !defined(_WIN32)
+        pthread_setspecific(cache_key, self_cache);
+#endif
+    }
+
+    return self_cache;
+}
+
+static int cache_slot(ogs_pkbuf_cache_t *cache, ogs_pkbuf_pool_t *pool)
+{
+    int i, empty = -1;
+
+    for (i = 0; i < OGS_PKBUF_CACHE_NUM_OF_POOL; i++) {
+        if (cache->slot[i].pool == pool)
+            return i;
+        if (empty < 0 && !cache->slot[i].pool)
+            empty = i;
+    }
+
+    if (empty >= 0)
+        cache->slot[empty].pool = pool;
+
+    return empty;
+}
+
+static int cache_class(unsigned int size)
+{
+    int class;
+
+    for (class = 0; class < OGS_PKBUF_CACHE_NUM_OF_CLASS; class++) {
+        if (size <= OGS_PKBUF_CACHE_CLASS_SIZE(class))
+            return class;
+    }
+
+    return -1;
+}
+
+/* Size class of a pkbuf that came from the cache, or -1 */
+static int cache_class_of(ogs_pkbuf_t *pkbuf)
+{
+#if OGS_USE_TALLOC == 1
+    int class;
+
+    if (!pkbuf->pool)
+        return -1;
+
+    class = cache_class(talloc_get_size(pkbuf) - sizeof(*pkbuf));
+    if (class < 0 || talloc_get_size(pkbuf) !=
+            sizeof(*pkbuf) + OGS_PKBUF_CACHE_CLASS_SIZE(class))
+        return -1;
+
+    return class;
+#else
+    if (pkbuf->pool == default_pool)
+        return -1;
+    /* Shared with a copy */
+    if (OGS_OBJECT_IS_REF(pkbuf->cluster))
+        return -1;
+
+    return cache_class(pkbuf->cluster->size);
+#endif
+}
+
+static int cache_refill(ogs_pkbuf_pool_t *pool, int class,
+        ogs_pkbuf_t **pkbuf, int num)
+{
+    unsigned int size = OGS_PKBUF_CACHE_CLASS_SIZE(class);
+    int n;
+#if OGS_USE_TALLOC == 1
+    ogs_thread_mutex_lock(ogs_mem_get_mutex());
+
+    for (n = 0; n < num; n++) {
+        pkbuf[n] = talloc_named_const(
+                pool, sizeof(ogs_pkbuf_t) + size, OGS_FILE_LINE);
+        if (!pkbuf[n])
+            break;
+        pkbuf[n]->pool = pool;
+    }
+
+    ogs_thread_mutex_unlock(ogs_mem_get_mutex());
+#else
+    ogs_thread_mutex_lock(&pool->mutex);
+
+    for (n = 0; n < num; n++) {
+        ogs_cluster_t *cluster = cluster_alloc(pool, size);
+        if (!cluster)
+            break;
+
+        ogs_pool_alloc(&pool->pkbuf, &pkbuf[n]);
+        if (!pkbuf[n]) {
+            cluster_free(pool, cluster);
+            break;
+        }
+
+        OGS_OBJECT_REF(cluster);
+        pkbuf[n]->cluster = cluster;
+        pkbuf[n]->pool = pool;
+    }
+
+    ogs_thread_mutex_unlock(&pool->mutex);
+#endif
+
+    return n;
+}
+
+static void cache_spill(ogs_pkbuf_pool_t *pool, ogs_pkbuf_t **pkbuf, int num)
+{
+    int i;
+#if OGS_USE_TALLOC == 1
+    ogs_thread_mutex_lock(ogs_mem_get_mutex());
+
+    for (i = 0; i < num; i++)
+        _talloc_free(pkbuf[i], OGS_FILE_LINE);
+
+    ogs_thread_mutex_unlock(ogs_mem_get_mutex());
+#else
+    ogs_thread_mutex_lock(&pool->mutex);
+
+    for (i = 0; i < num; i++) {
+        cluster_free(pool, pkbuf[i]->cluster);
+        ogs_pool_free(&pool->pkbuf, pkbuf[i]);
+    }
+
+    ogs_thread_mutex_unlock(&pool->mutex);
+#endif
+}
+
+static void cache_reset(ogs_pkbuf_t *pkbuf, unsigned int size)
+{
+    ogs_pkbuf_pool_t *pool = pkbuf->pool;
+#if OGS_USE_TALLOC == 1
+    memset(pkbuf, 0, sizeof(*pkbuf));
+
+    pkbuf->head = pkbuf->_data;
+#else
+    ogs_cluster_t *cluster = pkbuf->cluster;
+
+    memset(pkbuf, 0, sizeof(*pkbuf));
+
+    pkbuf->cluster = cluster;
+    pkbuf->head = cluster->buffer;
+#endif
+    pkbuf->data = pkbuf->head;
+    pkbuf->tail = pkbuf->head;
+    pkbuf->end = pkbuf->head + size;
+
+    pkbuf->pool = pool;
+}
+
+static ogs_pkbuf_t *cache_alloc(ogs_pkbuf_pool_t *pool, unsigned int size)
+{
+    ogs_pkbuf_cache_t *cache = NULL;
+    ogs_pkbuf_t *pkbuf = NULL;
+    int slot, class;
+
+    class = cache_class(size);
+    if (class < 0)
+        return NULL;
+
+    cache = cache_self();
+    slot = cache_slot(cache, pool);
+    if (slot < 0)
+        return NULL;
+
+#define mag cache->slot[slot].mag[class]
+    if (ogs_unlikely(!mag.num)) {
+        cache->slot[slot].stat.alloc_miss++;
+        mag.num = cache_refill(pool, class, mag.pkbuf, OGS_PKBUF_CACHE_BULK);
+        if (!mag.num)
+            return NULL;
+    }
+
+    cache->slot[slot].stat.alloc_hit++;
+    pkbuf = mag.pkbuf[--mag.num];
+#undef mag
+
+    cache_reset(pkbuf, size);
+
+    return pkbuf;
+}
+
+static bool cache_free(ogs_pkbuf_t *pkbuf)
+{
+    ogs_pkbuf_cache_t *cache = NULL;
+    int slot, class;
+
+    class = cache_class_of(pkbuf);
+    if (class < 0)
+        return false;
+
+    cache = cache_self();
+    slot = cache_slot(cache, pkbuf->pool);
+    if (slot < 0)
+        return false;
+
+#define mag cache->slot[slot].mag[class]
+    if (ogs_unlikely(mag.num == OGS_PKBUF_CACHE_SIZE)) {
+        cache->slot[slot].stat.free_miss++;
+        mag.num -= OGS_PKBUF_CACHE_BULK;
+        cache_spill(pkbuf->pool,
+                &mag.pkbuf[mag.num], OGS_PKBUF_CACHE_BULK);
+    }
+
+    cache->slot[slot].stat.free_hit++;
+    mag.pkbuf[mag.num++] = pkbuf;
+#undef mag
+
+    return true;
+}
+
+#if !defined(_WIN32)
+/* An exiting thread gives its pkbufs back to their pools */
+static void cache_exit(void *data)
+{
+    ogs_pkbuf_cache_t *cache = data;
+    int i, j;
+
+    ogs_assert(cache);
+
+    ogs_thread_mutex_lock(&cache_mutex);
+
+    for (i = 0; i < OGS_PKBUF_CACHE_NUM_OF_POOL; i++) {
+        if (!cache->slot[i].pool)
+            continue;
+
+        for (j = 0; j < OGS_PKBUF_CACHE_NUM_OF_CLASS; j++)
+            cache_spill(cache->slot[i].pool, cache->slot[i].mag[j].pkbuf,
+                    cache->slot[i].mag[j].num);
+    }
+    ogs_list_remove(&cache_list, cache);
+
+    ogs_thread_mutex_unlock(&cache_mutex);
+
+    free(cache);
+    self_cache = NULL;
+}
+#endif
+
+/* Give back every cached pkbuf of the pool, or of all pools if NULL */
+static void cache_purge(ogs_pkbuf_pool_t *pool)
+{
+    ogs_pkbuf_cache_t *cache = NULL;
+    int i, j;
+
+    ogs_thread_mutex_lock(&cache_mutex);
+
+    ogs_list_for_each(&cache_list, cache) {
+        for (i = 0; i < OGS_PKBUF_CACHE_NUM_OF_POOL; i++) {
+            if (!cache->slot[i].pool)
+                continue;
+            if (pool && cache->slot[i].pool != pool)
+                continue;
+
+            for (j = 0; j < OGS_PKBUF_CACHE_NUM_OF_CLASS; j++)
+                cache_spill(cache->slot[i].pool, cache->slot[i].mag[j].pkbuf,
+                        cache->slot[i].mag[j].num);
+
+            memset(&cache->slot[i], 0, sizeof(cache->slot[i]));
+        }
+    }
+
+    ogs_thread_mutex_unlock(&cache_mutex);
+}
+
+int ogs_pkbuf_alloc_batch_debug(ogs_pkbuf_pool_t *pool, unsigned int size,
+        ogs_pkbuf_t **pkbuf, int num, const char *file_line)
+{
+    ogs_pkbuf_cache_t *cache = NULL;
+    int i = 0, slot = -1, class;
+
+    ogs_assert(pkbuf);
+
+    class = cache_class(size);
+    if (pool && class >= 0) {
+        cache = cache_self();
+        slot = cache_slot(cache, pool);
+    }
+
+    if (slot >= 0) {
+#define mag cache->slot[slot].mag[class]
+        while (i < num) {
+            int n;
+
+            if (!mag.num) {
+                cache->slot[slot].stat.alloc_miss++;
+                mag.num = cache_refill(
+                        pool, class, mag.pkbuf, OGS_PKBUF_CACHE_BULK);
+                if (!mag.num)
+                    break;
+            }
+
+            n = ogs_min(mag.num, num - i);
+            cache->slot[slot].stat.alloc_hit += n;
+            while (n--) {
+                pkbuf[i] = mag.pkbuf[--mag.num];
+                cache_reset(pkbuf[i], size);
+                pkbuf[i]->file_line = file_line; /* For debug */
+                i++;
+            }
+        }
+#undef mag
+        return i;
+    }
+
+    for (i = 0; i < num; i++) {
+        pkbuf[i] = ogs_pkbuf_alloc_debug(pool, size, file_line);
+        if (!pkbuf[i])
+            break;
+    }
+
+    return i;
+}
+
+void ogs_pkbuf_free_batch(ogs_pkbuf_t **pkbuf, int num)
+{
+    int i;
+
+    ogs_assert(pkbuf);
+
+    for (i = 0; i < num; i++)
+        ogs_pkbuf_free(pkbuf[i]);
+}
+
+void ogs_pkbuf_pool_stat(ogs_pkbuf_pool_t *pool, ogs_pkbuf_pool_stat_t *stat)
+{
+    ogs_pkbuf_cache_t *cache = NULL;
+    int i;
+
+    ogs_assert(stat);
+    memset(stat, 0, sizeof(*stat));
+
+    ogs_thread_mutex_lock(&cache_mutex);
+
+    /* The counters of other threads may be slightly behind */
+    ogs_list_for_each(&cache_list, cache) {
+        for (i = 0; i < OGS_PKBUF_CACHE_NUM_OF_POOL; i++) {
+            if (!cache->slot[i].pool || cache->slot[i].pool != pool)
+                continue;
+
+            stat->alloc_hit += cache->slot[i].stat.alloc_hit;
+            stat->alloc_miss += cache->slot[i].stat.alloc_miss;
+            stat->free_hit += cache->slot[i].stat.free_hit;
+            stat->free_miss += cache->slot[i].stat.free_miss;
+        }
+    }
+
+    ogs_thread_mutex_unlock(&cache_mutex);
+}
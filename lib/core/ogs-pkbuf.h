@@ -83,12 +83,35 @@ void ogs_pkbuf_default_destroy(void);
 ogs_pkbuf_pool_t *ogs_pkbuf_pool_create(ogs_pkbuf_config_t *config);
 void ogs_pkbuf_pool_destroy(ogs_pkbuf_pool_t *pool);
 
+/*
+ * pkbufs of an explicit pool, i.e. not NULL, go through a per-thread
+ * cache, and their data is not zeroed. Up to 2048 bytes, they are
+ * allocated and freed without taking a lock.
+ */
 #define ogs_pkbuf_alloc(pool, size) \
     ogs_pkbuf_alloc_debug(pool, size, OGS_FILE_LINE)
 ogs_pkbuf_t *ogs_pkbuf_alloc_debug(
         ogs_pkbuf_pool_t *pool, unsigned int size, const char *file_line);
 void ogs_pkbuf_free(ogs_pkbuf_t *pkbuf);
 
+/* Returns the number of pkbufs allocated, less than 'num' on failure */
+#define ogs_pkbuf_alloc_batch(pool, size, pkbuf, num) \
+    ogs_pkbuf_alloc_batch_debug(pool, size, pkbuf, num, OGS_FILE_LINE)
+int ogs_pkbuf_alloc_batch_debug(ogs_pkbuf_pool_t *pool, unsigned int size,
+        ogs_pkbuf_t **pkbuf, int num, const char *file_line);
+void ogs_pkbuf_free_batch(ogs_pkbuf_t **pkbuf, int num);
+
+typedef struct ogs_pkbuf_pool_stat_s {
+    /* pkbufs handed out from / kept in the per-thread cache */
+    uint64_t alloc_hit;
+    uint64_t free_hit;
+    /* Refills from / spills to the pool, each taking its lock once */
+    uint64_t alloc_miss;
+    uint64_t free_miss;
+} ogs_pkbuf_pool_stat_t;
+
+void ogs_pkbuf_pool_stat(ogs_pkbuf_pool_t *pool, ogs_pkbuf_pool_stat_t *stat);
+
 void *ogs_pkbuf_put_data(
         ogs_pkbuf_t *pkbuf, const void *data, unsigned int len);
 #define ogs_pkbuf_copy(pkbuf) \
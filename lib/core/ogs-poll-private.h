@@ -47,6 +47,8 @@ typedef struct ogs_pollset_s {
     struct {
         ogs_socket_t fd[2];
         ogs_poll_t *poll;
+        /* Set from the first notify until the loop wakes up */
+        int pending;
     } notify;
 
     unsigned int capacity;
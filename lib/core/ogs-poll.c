@@ -127,6 +127,17 @@ void ogs_pollset_remove(ogs_poll_t *poll)
     ogs_pool_free(&pollset->pool, poll);
 }
 
+int ogs_pollset_rearm(ogs_poll_t *poll)
+{
+    ogs_assert(poll);
+
+    /* A level-triggered poll is reported again anyway */
+    if (!(poll->when & OGS_POLLET))
+        return OGS_OK;
+
+    return ogs_pollset_actions.rearm(poll);
+}
+
 void *ogs_pollset_self_handler_data(void)
 {
     return &self_handler_data;
@@ -35,10 +35,22 @@ void ogs_pollset_destroy(ogs_pollset_t *pollset);
 
 #define OGS_POLLIN      0x01
 #define OGS_POLLOUT     0x02
+/*
+ * Edge-triggered: the handler is called only when new data arrives,
+ * so it has to read until the socket would block. Backends without
+ * edge triggering keep calling it while data remains, which is also
+ * correct for such a handler.
+ *
+ * A handler that stops early, so as not to starve the other fds, calls
+ * ogs_pollset_rearm() to be called again on the next poll if data
+ * is still left.
+ */
+#define OGS_POLLET      0x04
 
 ogs_poll_t *ogs_pollset_add(ogs_pollset_t *pollset, short when,
         ogs_socket_t fd, ogs_poll_handler_f handler, void *data);
 void ogs_pollset_remove(ogs_poll_t *poll);
+int ogs_pollset_rearm(ogs_poll_t *poll);
 
 void *ogs_pollset_self_handler_data(void);
 
@@ -51,6 +63,7 @@ typedef struct ogs_pollset_actions_s {
 
     int (*poll)(ogs_pollset_t *pollset, ogs_time_t timeout);
     int (*notify)(ogs_pollset_t *pollset);
+    int (*rearm)(ogs_poll_t *poll);
 } ogs_pollset_actions_t;
 
 extern ogs_pollset_actions_t ogs_pollset_actions;
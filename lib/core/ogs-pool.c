@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2019-2023 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ogs-core.h"
+
+#undef OGS_LOG_DOMAIN
+#define OGS_LOG_DOMAIN __ogs_mem_domain
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
+#endif
+
+/*
+ * Address space for the vectors of ogs_pool_init(). Nothing is touched
+ * here, so pages are committed by the kernel one by one as the pool
+ * hands out slots, and no swap is reserved for the rest.
+ */
+void *ogs_pool_reserve(size_t size)
+{
+    void *ptr = NULL;
+
+    if (!size)
+        size = 1;
+
+#if defined(_WIN32)
+    ptr = VirtualAlloc(NULL, size, MEM_RESERVE|MEM_COMMIT, PAGE_READWRITE);
+    ogs_assert(ptr);
+#else
+    ptr = mmap(NULL, size, PROT_READ|PROT_WRITE,
+            MAP_PRIVATE|MAP_ANONYMOUS|MAP_NORESERVE, -1, 0);
+    if (ptr == MAP_FAILED) {
+        ogs_log_message(OGS_LOG_FATAL, ogs_errno,
+                "mmap(%lu) failed", (unsigned long)size);
+        ogs_assert_if_reached();
+    }
+#endif
+
+    return ptr;
+}
+
+void ogs_pool_release(void *ptr, size_t size)
+{
+    if (!ptr)
+        return;
+
+    if (!size)
+        size = 1;
+
+#if defined(_WIN32)
+    VirtualFree(ptr, 0, MEM_RELEASE);
+#else
+    munmap(ptr, size);
+#endif
+}
@@ -30,69 +30,70 @@ extern "C" {
 
 typedef uint32_t ogs_pool_id_t;
 
+/*
+ * Slots are handed out in order until all of them have been used once,
+ * then freed slots are reused in the order they were freed.
+ *
+ * 'next' is the first slot that has never been used. Nothing beyond it
+ * is ever written, so a large pool costs no memory until it grows.
+ */
 #define OGS_POOL(pool, type) \
     struct { \
         const char *name; \
         int head, tail; \
         int size, avail; \
+        int next; \
         type **free, *array, **index; \
     } pool
 
+void *ogs_pool_reserve(size_t size);
+void ogs_pool_release(void *ptr, size_t size);
+
 /*
  * ogs_pool_init() shall be used in the initialization routine.
- * Otherwise, memory will be fragment since this function uses system malloc()
+ * It only reserves address space, so it takes the same time
+ * whatever the size of the pool.
  */
 #define ogs_pool_init(pool, _size) do { \
-    int i; \
     (pool)->name = #pool; \
-    (pool)->free = malloc(sizeof(*(pool)->free) * _size); \
-    ogs_assert((pool)->free); \
-    (pool)->array = malloc(sizeof(*(pool)->array) * _size); \
-    ogs_assert((pool)->array); \
-    (pool)->index = malloc(sizeof(*(pool)->index) * _size); \
-    ogs_assert((pool)->index); \
-    (pool)->size = (pool)->avail = _size; \
+    (pool)->free = ogs_pool_reserve(sizeof(*(pool)->free) * (_size)); \
+    (pool)->array = ogs_pool_reserve(sizeof(*(pool)->array) * (_size)); \
+    (pool)->index = ogs_pool_reserve(sizeof(*(pool)->index) * (_size)); \
+    (pool)->size = (pool)->avail = (_size); \
     (pool)->head = (pool)->tail = 0; \
-    for (i = 0; i < _size; i++) { \
-        (pool)->free[i] = &((pool)->array[i]); \
-        (pool)->index[i] = NULL; \
-    } \
+    (pool)->next = 0; \
 } while (0)
 
 /*
  * ogs_pool_final() shall be used in the finalization routine.
- * Otherwise, memory will be fragment since this function uses system free()
  */
 #define ogs_pool_final(pool) do { \
     if (((pool)->size != (pool)->avail)) \
         ogs_error("%d in '%s[%d]' were not released.", \
                 (pool)->size - (pool)->avail, (pool)->name, (pool)->size); \
-    free((pool)->free); \
-    free((pool)->array); \
-    free((pool)->index); \
+    ogs_pool_release((pool)->free, sizeof(*(pool)->free) * (pool)->size); \
+    ogs_pool_release((pool)->array, sizeof(*(pool)->array) * (pool)->size); \
+    ogs_pool_release((pool)->index, sizeof(*(pool)->index) * (pool)->size); \
 } while (0)
 
 /*
  * COMPARED WITH ogs_pool_init()
  *
  * ogs_pool_create() could be called while the process is running,
- * so this function should use ogs_malloc() instead of system malloc()
+ * so this function should use ogs_malloc() instead of reserving
+ * address space
  */
 #define ogs_pool_create(pool, _size) do { \
-    int i; \
     (pool)->name = #pool; \
-    (pool)->free = ogs_malloc(sizeof(*(pool)->free) * _size); \
+    (pool)->free = ogs_malloc(sizeof(*(pool)->free) * (_size)); \
     ogs_assert((pool)->free); \
-    (pool)->array = ogs_malloc(sizeof(*(pool)->array) * _size); \
+    (pool)->array = ogs_malloc(sizeof(*(pool)->array) * (_size)); \
     ogs_assert((pool)->array); \
-    (pool)->index = ogs_malloc(sizeof(*(pool)->index) * _size); \
+    (pool)->index = ogs_malloc(sizeof(*(pool)->index) * (_size)); \
     ogs_assert((pool)->index); \
-    (pool)->size = (pool)->avail = _size; \
+    (pool)->size = (pool)->avail = (_size); \
     (pool)->head = (pool)->tail = 0; \
-    for (i = 0; i < _size; i++) { \
-        (pool)->free[i] = &((pool)->array[i]); \
-        (pool)->index[i] = NULL; \
-    } \
+    (pool)->next = 0; \
 } while (0)
 
 /*
@@ -112,7 +113,7 @@ typedef uint32_t ogs_pool_id_t;
 
 #define ogs_pool_index(pool, node) (((node) - (pool)->array)+1)
 #define ogs_pool_find(pool, _index) \
-    (_index > 0 && _index <= (pool)->size) ? (pool)->index[_index-1] : NULL
+    (_index > 0 && _index <= (pool)->next) ? (pool)->index[_index-1] : NULL
 #define ogs_pool_cycle(pool, node) \
     ogs_pool_find((pool), ogs_pool_index((pool), (node)))
 
@@ -120,9 +121,13 @@ typedef uint32_t ogs_pool_id_t;
     *(node) = NULL; \
     if ((pool)->avail > 0) { \
         (pool)->avail--; \
-        *(node) = (void*)(pool)->free[(pool)->head]; \
-        (pool)->free[(pool)->head] = NULL; \
-        (pool)->head = ((pool)->head + 1) % ((pool)->size); \
+        if ((pool)->next < (pool)->size) { \
+            *(node) = (void*)&(pool)->array[(pool)->next++]; \
+        } else { \
+            *(node) = (void*)(pool)->free[(pool)->head]; \
+            (pool)->free[(pool)->head] = NULL; \
+            (pool)->head = ((pool)->head + 1) % ((pool)->size); \
+        } \
         (pool)->index[ogs_pool_index(pool, *(node))-1] = *(node); \
     } \
 } while (0)
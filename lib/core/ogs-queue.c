@@ -32,17 +32,45 @@
  * limitations under the License.
  */
 
+
 #include "ogs-core.h"
 
 #undef OGS_LOG_DOMAIN
 #define OGS_LOG_DOMAIN __ogs_event_domain
 
+/*
+ * Bounded lock-free queue
+ *
+ * Every slot has a sequence number that says whose turn it is
+ * (D. Vyukov's bounded MPMC queue). A producer claims the position 'in'
+ * with a compare-and-swap when the sequence of its slot equals the
+ * position, stores the data and publishes it with position + 1.
+ * A consumer claims 'out' once the sequence says the slot is filled,
+ * and hands the slot back to the producers with position + capacity.
+ *
+ * Pushing and popping take no lock. Only a thread that has to wait in
+ * a full or an empty queue takes the mutex, and the other side signals
+ * it only if someone is waiting.
+ */
+typedef struct ogs_queue_slot_s {
+    uint64_t            sequence;
+    void                *data;
+} ogs_queue_slot_t;
+
 typedef struct ogs_queue_s {
-    void              **data;
-    unsigned int        nelts; /**< # elements */
-    unsigned int        in;    /**< next empty location */
-    unsigned int        out;   /**< next filled location */
+    ogs_queue_slot_t    *slot;
     unsigned int        bounds;/**< max size of queue */
+
+    /* Producers and consumers do not share a cache line */
+    char                pad0[64];
+    uint64_t            in;    /**< next position to push */
+    char                pad1[64];
+    uint64_t            out;   /**< next position to pop */
+    char                pad2[64];
+
+    unsigned int        high_water;
+    uint64_t            full;
+
     unsigned int        full_waiters;
     unsigned int        empty_waiters;
     ogs_thread_mutex_t  one_big_mutex;
@@ -51,48 +79,31 @@ typedef struct ogs_queue_s {
     int                 terminated;
 } ogs_queue_t;
 
-/**
- * Detects when the ogs_queue_t is full. This utility function is expected
- * to be called from within critical sections, and is not threadsafe.
- */
-#define ogs_queue_full(queue) ((queue)->nelts == (queue)->bounds)
-
-/**
- * Detects when the ogs_queue_t is empty. This utility function is expected
- * to be called from within critical sections, and is not threadsafe.
- */
-#define ogs_queue_empty(queue) ((queue)->nelts == 0)
-
-/**
- * Callback routine that is called to destroy this
- * ogs_queue_t when its pool is destroyed.
- */
 ogs_queue_t *ogs_queue_create(unsigned int capacity)
 {
+    unsigned int i;
     ogs_queue_t *queue = ogs_calloc(1, sizeof *queue);
     if (!queue) {
         ogs_error("ogs_calloc() failed");
         return NULL;
     }
     ogs_assert(queue);
+    ogs_assert(capacity);
 
     ogs_thread_mutex_init(&queue->one_big_mutex);
     ogs_thread_cond_init(&queue->not_empty);
     ogs_thread_cond_init(&queue->not_full);
 
-    queue->data = ogs_calloc(1, capacity * sizeof(void*));
-    if (!queue->data) {
-        ogs_error("ogs_calloc[capacity:%d, sizeof(void*):%d] failed",
-                (int)capacity, (int)sizeof(void*));
+    queue->slot = ogs_calloc(capacity, sizeof(ogs_queue_slot_t));
+    if (!queue->slot) {
+        ogs_error("ogs_calloc[capacity:%d, sizeof(ogs_queue_slot_t):%d] "
+                "failed", (int)capacity, (int)sizeof(ogs_queue_slot_t));
         return NULL;
     }
+    for (i = 0; i < capacity; i++)
+        queue->slot[i].sequence = i;
+
     queue->bounds = capacity;
-    queue->nelts = 0;
-    queue->in = 0;
-    queue->out = 0;
-    queue->terminated = 0;
-    queue->full_waiters = 0;
-    queue->empty_waiters = 0;
 
     return queue;
 }
@@ -101,7 +112,7 @@ void ogs_queue_destroy(ogs_queue_t *queue)
 {
     ogs_assert(queue);
 
-    ogs_free(queue->data);
+    ogs_free(queue->slot);
 
     ogs_thread_cond_destroy(&queue->not_empty);
     ogs_thread_cond_destroy(&queue->not_full);
@@ -110,23 +121,134 @@ void ogs_queue_destroy(ogs_queue_t *queue)
     ogs_free(queue);
 }
 
+static unsigned int queue_size(ogs_queue_t *queue)
+{
+    uint64_t in, out;
+
+    out = __atomic_load_n(&queue->out, __ATOMIC_RELAXED);
+    in = __atomic_load_n(&queue->in, __ATOMIC_RELAXED);
+
+    return in > out ? ogs_min(in - out, queue->bounds) : 0;
+}
+
+static int queue_trypush(ogs_queue_t *queue, void *data)
+{
+    ogs_queue_slot_t *slot = NULL;
+    uint64_t pos, sequence;
+    unsigned int size, high_water;
+
+    pos = __atomic_load_n(&queue->in, __ATOMIC_RELAXED);
+    for ( ;; ) {
+        slot = &queue->slot[pos % queue->bounds];
+        sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+
+        if (sequence == pos) {
+            if (__atomic_compare_exchange_n(&queue->in, &pos, pos + 1,
+                    true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                break;
+        } else if ((int64_t)(sequence - pos) < 0) {
+            /* The slot has not been popped since the last round */
+            __atomic_add_fetch(&queue->full, 1, __ATOMIC_RELAXED);
+            return OGS_RETRY;
+        } else {
+            pos = __atomic_load_n(&queue->in, __ATOMIC_RELAXED);
+        }
+    }
+
+    slot->data = data;
+    __atomic_store_n(&slot->sequence, pos + 1, __ATOMIC_RELEASE);
+
+    size = queue_size(queue);
+    high_water = __atomic_load_n(&queue->high_water, __ATOMIC_RELAXED);
+    while (size > high_water &&
+            !__atomic_compare_exchange_n(&queue->high_water, &high_water,
+                size, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    return OGS_OK;
+}
+
+/*
+ * Claims up to 'max' filled slots with one compare-and-swap.
+ * Filled slots stay filled until a consumer pops them.
+ */
+static int queue_trypop(ogs_queue_t *queue, void **data, int max)
+{
+    ogs_queue_slot_t *slot = NULL;
+    uint64_t pos, sequence;
+    int i, n;
+
+    pos = __atomic_load_n(&queue->out, __ATOMIC_RELAXED);
+    for ( ;; ) {
+        for (n = 0; n < max && n < queue->bounds; n++) {
+            slot = &queue->slot[(pos + n) % queue->bounds];
+            sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+            if (sequence != pos + n + 1)
+                break;
+        }
+
+        if (n == 0) {
+            slot = &queue->slot[pos % queue->bounds];
+            sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+            if ((int64_t)(sequence - (pos + 1)) < 0)
+                return OGS_RETRY; /* Empty */
+
+            /* Another consumer got ahead */
+            pos = __atomic_load_n(&queue->out, __ATOMIC_RELAXED);
+            continue;
+        }
+
+        if (__atomic_compare_exchange_n(&queue->out, &pos, pos + n,
+                true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            break;
+    }
+
+    for (i = 0; i < n; i++) {
+        slot = &queue->slot[(pos + i) % queue->bounds];
+        data[i] = slot->data;
+        __atomic_store_n(&slot->sequence,
+                pos + i + queue->bounds, __ATOMIC_RELEASE);
+    }
+
+    return n;
+}
+
+/*
+ * A waiter increments the counter before checking the queue again,
+ * and the other side checks the counter after publishing, with a full
+ * barrier in between on both sides. So either the waiter sees the
+ * change, or the other side sees the waiter and signals it under
+ * the mutex.
+ */
+static void queue_signal(ogs_queue_t *queue,
+        unsigned int *waiters, ogs_thread_cond_t *cond)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(waiters, __ATOMIC_RELAXED)) {
+        ogs_thread_mutex_lock(&queue->one_big_mutex);
+        ogs_thread_cond_signal(cond);
+        ogs_thread_mutex_unlock(&queue->one_big_mutex);
+    }
+}
+
 static int queue_push(ogs_queue_t *queue, void *data, ogs_time_t timeout)
 {
     int rv;
 
-    if (queue->terminated) {
+    if (__atomic_load_n(&queue->terminated, __ATOMIC_ACQUIRE)) {
         return OGS_DONE; /* no more elements ever again */
     }
 
-    ogs_thread_mutex_lock(&queue->one_big_mutex);
-
-    if (ogs_queue_full(queue)) {
-        if (!timeout) {
-            ogs_thread_mutex_unlock(&queue->one_big_mutex);
+    rv = queue_trypush(queue, data);
+    if (rv == OGS_RETRY) {
+        if (!timeout)
             return OGS_RETRY;
-        }
-        if (!queue->terminated) {
-            queue->full_waiters++;
+
+        ogs_thread_mutex_lock(&queue->one_big_mutex);
+
+        __atomic_add_fetch(&queue->full_waiters, 1, __ATOMIC_SEQ_CST);
+        rv = queue_trypush(queue, data);
+        if (rv == OGS_RETRY && !queue->terminated) {
             if (timeout > 0) {
                 rv = ogs_thread_cond_timedwait(&queue->not_full,
                                                &queue->one_big_mutex,
@@ -136,16 +258,18 @@ static int queue_push(ogs_queue_t *queue, void *data, ogs_time_t timeout)
                 rv = ogs_thread_cond_wait(&queue->not_full,
                                           &queue->one_big_mutex);
             }
-            queue->full_waiters--;
-            if (rv != OGS_OK) {
-                ogs_thread_mutex_unlock(&queue->one_big_mutex);
-                return rv;
-            }
+            if (rv == OGS_OK)
+                rv = queue_trypush(queue, data);
+            else
+                rv = rv == OGS_RETRY ? OGS_ERROR : rv;
         }
-        /* If we wake up and it's still empty, then we were interrupted */
-        if (ogs_queue_full(queue)) {
+        __atomic_sub_fetch(&queue->full_waiters, 1, __ATOMIC_SEQ_CST);
+
+        ogs_thread_mutex_unlock(&queue->one_big_mutex);
+
+        /* If we wake up and it's still full, then we were interrupted */
+        if (rv == OGS_RETRY) {
             ogs_warn("queue full (intr)");
-            ogs_thread_mutex_unlock(&queue->one_big_mutex);
             if (queue->terminated) {
                 return OGS_DONE; /* no more elements ever again */
             }
@@ -153,20 +277,12 @@ static int queue_push(ogs_queue_t *queue, void *data, ogs_time_t timeout)
                 return OGS_ERROR;
             }
         }
+        if (rv != OGS_OK)
+            return rv;
     }
 
-    queue->data[queue->in] = data;
-    queue->in++;
-    if (queue->in >= queue->bounds)
-        queue->in -= queue->bounds;
-    queue->nelts++;
+    queue_signal(queue, &queue->empty_waiters, &queue->not_empty);
 
-    if (queue->empty_waiters) {
-        ogs_trace("signal !empty");
-        ogs_thread_cond_signal(&queue->not_empty);
-    }
-
-    ogs_thread_mutex_unlock(&queue->one_big_mutex);
     return OGS_OK;
 }
 
@@ -191,10 +307,10 @@ int ogs_queue_timedpush(ogs_queue_t *queue, void *data, ogs_time_t timeout)
 }
 
 /**
- * not thread safe
+ * not exact while other threads are pushing or popping
  */
 unsigned int ogs_queue_size(ogs_queue_t *queue) {
-    return queue->nelts;
+    return queue_size(queue);
 }
 
 /**
@@ -208,20 +324,21 @@ static int queue_pop(ogs_queue_t *queue, void **data, ogs_time_t timeout)
 {
     int rv;
 
-    if (queue->terminated) {
+    if (__atomic_load_n(&queue->terminated, __ATOMIC_ACQUIRE)) {
         return OGS_DONE; /* no more elements ever again */
     }
 
-    ogs_thread_mutex_lock(&queue->one_big_mutex);
-
-    /* Keep waiting until we wake up and find that the queue is not empty. */
-    if (ogs_queue_empty(queue)) {
-        if (!timeout) {
-            ogs_thread_mutex_unlock(&queue->one_big_mutex);
+    rv = queue_trypop(queue, data, 1);
+    if (rv == OGS_RETRY) {
+        if (!timeout)
             return OGS_RETRY;
-        }
-        if (!queue->terminated) {
-            queue->empty_waiters++;
+
+        ogs_thread_mutex_lock(&queue->one_big_mutex);
+
+        /* Keep waiting until we wake up and find that the queue is not empty. */
+        __atomic_add_fetch(&queue->empty_waiters, 1, __ATOMIC_SEQ_CST);
+        rv = queue_trypop(queue, data, 1);
+        if (rv == OGS_RETRY && !queue->terminated) {
             if (timeout > 0) {
                 rv = ogs_thread_cond_timedwait(&queue->not_empty,
                                                &queue->one_big_mutex,
@@ -231,36 +348,30 @@ static int queue_pop(ogs_queue_t *queue, void **data, ogs_time_t timeout)
                 rv = ogs_thread_cond_wait(&queue->not_empty,
                                           &queue->one_big_mutex);
             }
-            queue->empty_waiters--;
-            if (rv != OGS_OK) {
-                ogs_thread_mutex_unlock(&queue->one_big_mutex);
-                return rv;
-            }
+            if (rv == OGS_OK)
+                rv = queue_trypop(queue, data, 1);
+            else
+                rv = rv == OGS_RETRY ? OGS_ERROR : rv;
         }
+        __atomic_sub_fetch(&queue->empty_waiters, 1, __ATOMIC_SEQ_CST);
+
+        ogs_thread_mutex_unlock(&queue->one_big_mutex);
+
         /* If we wake up and it's still empty, then we were interrupted */
-        if (ogs_queue_empty(queue)) {
+        if (rv == OGS_RETRY) {
             ogs_warn("queue empty (intr)");
-            ogs_thread_mutex_unlock(&queue->one_big_mutex);
             if (queue->terminated) {
                 return OGS_DONE; /* no more elements ever again */
             } else {
                 return OGS_ERROR;
             }
         }
-    } 
-
-    *data = queue->data[queue->out];
-    queue->nelts--;
-
-    queue->out++;
-    if (queue->out >= queue->bounds)
-        queue->out -= queue->bounds;
-    if (queue->full_waiters) {
-        ogs_trace("signal !full");
-        ogs_thread_cond_signal(&queue->not_full);
+        if (rv < 0)
+            return rv;
     }
 
-    ogs_thread_mutex_unlock(&queue->one_big_mutex);
+    queue_signal(queue, &queue->full_waiters, &queue->not_full);
+
     return OGS_OK;
 }
 
@@ -279,6 +390,40 @@ int ogs_queue_timedpop(ogs_queue_t *queue, void **data, ogs_time_t timeout)
     return queue_pop(queue, data, timeout);
 }
 
+/**
+ * Retrieves up to 'max' items without waiting. Returns the number of
+ * items placed into 'data', OGS_RETRY if the queue is empty, or
+ * OGS_DONE once the queue is terminated.
+ */
+int ogs_queue_trypop_batch(ogs_queue_t *queue, void **data, int max)
+{
+    int n;
+
+    ogs_assert(data);
+    ogs_assert(max > 0);
+
+    if (__atomic_load_n(&queue->terminated, __ATOMIC_ACQUIRE)) {
+        return OGS_DONE; /* no more elements ever again */
+    }
+
+    n = queue_trypop(queue, data, max);
+    if (n > 0)
+        queue_signal(queue, &queue->full_waiters, &queue->not_full);
+
+    return n;
+}
+
+void ogs_queue_stat(ogs_queue_t *queue, ogs_queue_stat_t *stat)
+{
+    ogs_assert(queue);
+    ogs_assert(stat);
+
+    stat->size = queue_size(queue);
+    stat->capacity = queue->bounds;
+    stat->high_water = __atomic_load_n(&queue->high_water, __ATOMIC_RELAXED);
+    stat->full = __atomic_load_n(&queue->full, __ATOMIC_RELAXED);
+}
+
 int ogs_queue_interrupt_all(ogs_queue_t *queue)
 {
     ogs_debug("interrupt all");
@@ -300,9 +445,8 @@ int ogs_queue_term(ogs_queue_t *queue)
      * we could end up setting it and waking everybody up just after a 
      * would-be popper checks it but right before they block
      */
-    queue->terminated = 1;
+    __atomic_store_n(&queue->terminated, 1, __ATOMIC_RELEASE);
     ogs_thread_mutex_unlock(&queue->one_big_mutex);
 
     return ogs_queue_interrupt_all(queue);
 }
-
@@ -57,8 +57,20 @@ int ogs_queue_trypop(ogs_queue_t *queue, void **data);
 int ogs_queue_timedpush(ogs_queue_t *queue, void *data, ogs_time_t timeout);
 int ogs_queue_timedpop(ogs_queue_t *queue, void **data, ogs_time_t timeout);
 
+#define OGS_QUEUE_MAX_BATCH 32
+int ogs_queue_trypop_batch(ogs_queue_t *queue, void **data, int max);
+
 unsigned int ogs_queue_size(ogs_queue_t *queue);
 
+typedef struct ogs_queue_stat_s {
+    unsigned int size;
+    unsigned int capacity;
+    unsigned int high_water; /* Largest size seen after a push */
+    uint64_t full;           /* Pushes that found the queue full */
+} ogs_queue_stat_t;
+
+void ogs_queue_stat(ogs_queue_t *queue, ogs_queue_stat_t *stat);
+
 int ogs_queue_interrupt_all(ogs_queue_t *queue);
 int ogs_queue_term(ogs_queue_t *queue);
 
@@ -31,6 +31,7 @@ static void select_cleanup(ogs_pollset_t *pollset);
 static int select_add(ogs_poll_t *poll);
 static int select_remove(ogs_poll_t *poll);
 static int select_process(ogs_pollset_t *pollset, ogs_time_t timeout);
+static int select_rearm(ogs_poll_t *poll);
 
 const ogs_pollset_actions_t ogs_select_actions = {
     select_init,
@@ -41,6 +42,7 @@ const ogs_pollset_actions_t ogs_select_actions = {
     select_process,
 
     ogs_notify_pollset,
+    select_rearm,
 };
 
 struct select_context_s {
@@ -136,6 +138,12 @@ static int select_remove(ogs_poll_t *poll)
     return OGS_OK;
 }
 
+/* select() is always level-triggered */
+static int select_rearm(ogs_poll_t *poll)
+{
+    return OGS_OK;
+}
+
 static int select_process(ogs_pollset_t *pollset, ogs_time_t timeout)
 {
     struct select_context_s *context = NULL;
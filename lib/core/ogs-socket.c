@@ -19,6 +19,11 @@
 
 #include "core-config-private.h"
 
+/* recvmmsg(2) and sendmmsg(2) are GNU extensions */
+#if (HAVE_RECVMMSG || HAVE_SENDMMSG) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
 #if HAVE_FCNTL_H
 #include <fcntl.h>
 #endif
@@ -245,6 +250,124 @@ ssize_t ogs_recvfrom(ogs_socket_t fd,
     return recvfrom(fd, buf, len, flags, &from->sa, &addrlen);
 }
 
+/*
+ * Receive up to 'vlen' datagrams with a single system call.
+ * It blocks only until the first datagram is available (MSG_WAITFORONE).
+ *
+ * Returns the number of messages received, or -1 on error
+ * with ogs_socket_errno set. If recvmmsg(2) is not available,
+ * at most one datagram is read per call.
+ */
+int ogs_recvmmsg(ogs_socket_t fd, ogs_sockmsg_t *msg, int vlen, int flags)
+{
+#if HAVE_RECVMMSG
+    struct mmsghdr hdr[OGS_MAX_NUM_OF_SOCKMSG];
+    struct iovec iov[OGS_MAX_NUM_OF_SOCKMSG];
+    int i, n;
+
+    ogs_assert(fd != INVALID_SOCKET);
+    ogs_assert(msg);
+    ogs_assert(vlen > 0);
+
+    if (vlen > OGS_MAX_NUM_OF_SOCKMSG)
+        vlen = OGS_MAX_NUM_OF_SOCKMSG;
+
+    memset(hdr, 0, sizeof(hdr[0]) * vlen);
+    for (i = 0; i < vlen; i++) {
+        iov[i].iov_base = msg[i].buf;
+        iov[i].iov_len = msg[i].len;
+
+        hdr[i].msg_hdr.msg_iov = &iov[i];
+        hdr[i].msg_hdr.msg_iovlen = 1;
+        if (msg[i].addr) {
+            memset(msg[i].addr, 0, sizeof *msg[i].addr);
+            hdr[i].msg_hdr.msg_name = &msg[i].addr->sa;
+            hdr[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
+        }
+    }
+
+    n = recvmmsg(fd, hdr, vlen, flags | MSG_WAITFORONE, NULL);
+    for (i = 0; i < n; i++)
+        msg[i].len = hdr[i].msg_len;
+
+    return n;
+#else
+    ssize_t size;
+
+    ogs_assert(fd != INVALID_SOCKET);
+    ogs_assert(msg);
+    ogs_assert(vlen > 0);
+    ogs_assert(msg[0].addr);
+
+    size = ogs_recvfrom(fd, msg[0].buf, msg[0].len, flags, msg[0].addr);
+    if (size < 0)
+        return -1;
+
+    msg[0].len = size;
+
+    return 1;
+#endif
+}
+
+/*
+ * Send 'vlen' datagrams with as few system calls as possible.
+ *
+ * Returns the number of messages sent. A short count means
+ * the remaining messages were dropped and ogs_socket_errno is set.
+ */
+int ogs_sendmmsg(ogs_socket_t fd, ogs_sockmsg_t *msg, int vlen, int flags)
+{
+#if HAVE_SENDMMSG
+    struct mmsghdr hdr[OGS_MAX_NUM_OF_SOCKMSG];
+    struct iovec iov[OGS_MAX_NUM_OF_SOCKMSG];
+    int i, n, sent = 0;
+
+    ogs_assert(fd != INVALID_SOCKET);
+    ogs_assert(msg);
+
+    while (sent < vlen) {
+        int num = ogs_min(vlen - sent, OGS_MAX_NUM_OF_SOCKMSG);
+
+        memset(hdr, 0, sizeof(hdr[0]) * num);
+        for (i = 0; i < num; i++) {
+            ogs_sockmsg_t *m = &msg[sent + i];
+
+            ogs_assert(m->addr);
+
+            iov[i].iov_base = m->buf;
+            iov[i].iov_len = m->len;
+
+            hdr[i].msg_hdr.msg_iov = &iov[i];
+            hdr[i].msg_hdr.msg_iovlen = 1;
+            hdr[i].msg_hdr.msg_name = &m->addr->sa;
+            hdr[i].msg_hdr.msg_namelen = ogs_sockaddr_len(m->addr);
+        }
+
+        n = sendmmsg(fd, hdr, num, flags);
+        if (n <= 0)
+            break;
+
+        sent += n;
+    }
+
+    return sent;
+#else
+    int i;
+
+    ogs_assert(fd != INVALID_SOCKET);
+    ogs_assert(msg);
+
+    for (i = 0; i < vlen; i++) {
+        ssize_t size = ogs_sendto(fd, msg[i].buf, msg[i].len,
+                flags, msg[i].addr);
+        if (size < 0 || size != msg[i].len)
+            break;
+    }
+
+    return i;
+#endif
+}
+
 int ogs_closesocket(ogs_socket_t fd)
 {
     int r;
@@ -46,6 +46,20 @@ typedef struct ogs_sock_s {
     ogs_sockaddr_t remote_addr;
 } ogs_sock_t;
 
+/*
+ * One datagram of a multi-message receive/send.
+ *
+ * ogs_recvmmsg() : 'len' is the size of 'buf' on input and is replaced
+ *                  with the number of bytes received on output.
+ * ogs_sendmmsg() : 'len' is the number of bytes to send from 'buf'.
+ */
+#define OGS_MAX_NUM_OF_SOCKMSG 64
+typedef struct ogs_sockmsg_s {
+    void *buf;
+    size_t len;
+    ogs_sockaddr_t *addr;
+} ogs_sockmsg_t;
+
 void ogs_socket_init(void);
 void ogs_socket_final(void);
 
@@ -69,6 +83,9 @@ ssize_t ogs_recv(ogs_socket_t fd, void *buf, size_t len, int flags);
 ssize_t ogs_recvfrom(ogs_socket_t fd,
         void *buf, size_t len, int flags, ogs_sockaddr_t *from);
 
+int ogs_recvmmsg(ogs_socket_t fd, ogs_sockmsg_t *msg, int vlen, int flags);
+int ogs_sendmmsg(ogs_socket_t fd, ogs_sockmsg_t *msg, int vlen, int flags);
+
 int ogs_closesocket(ogs_socket_t fd);
 
 #ifdef __cplusplus
@@ -40,6 +40,8 @@ typedef struct ogs_socknode_s {
     ogs_sock_t *sock;
     void (*cleanup)(ogs_sock_t *sock);
     ogs_poll_t *poll;
+    /* Packet ring polled instead of the socket, e.g. ogs_gtp_ring_t */
+    void *ring;
 
     ogs_sockopt_t *option;
 } ogs_socknode_t;
@@ -51,6 +51,17 @@ typedef struct ogs_sockopt_s {
     } so_linger;
 
     const char *so_bindtodevice;
+
+    /* Allow several UDP sockets to bind the same address (SO_REUSEPORT) */
+    bool so_reuseport;
+
+    /* Number of datagrams per recvmmsg()/sendmmsg(), 0 or 1 to disable */
+    int mmsg_batch;
+
+    /* Receive from a memory-mapped packet ring instead of the socket */
+#define OGS_PACKET_RING_NONE        0
+#define OGS_PACKET_RING_TPACKET     1
+    int packet_ring;
 } ogs_sockopt_t;
 
 void ogs_sockopt_init(ogs_sockopt_t *option);
@@ -58,6 +69,7 @@ void ogs_sockopt_init(ogs_sockopt_t *option);
 int ogs_nonblocking(ogs_socket_t fd);
 int ogs_closeonexec(ogs_socket_t fd);
 int ogs_listen_reusable(ogs_socket_t fd, int on);
+int ogs_so_reuseport(ogs_socket_t fd, int on);
 int ogs_tcp_nodelay(ogs_socket_t fd, int on);
 int ogs_so_linger(ogs_socket_t fd, int l_linger);
 int ogs_bind_to_device(ogs_socket_t fd, const char *device);
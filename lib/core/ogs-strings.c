@@ -224,9 +224,15 @@ char *ogs_talloc_asprintf_append(char *s, const char *fmt, ...)
 
 
 /*****************************************
- * Memory Pool - Use pkbuf library
+ * Memory Pool - Use ogs_malloc()
  *****************************************/
 
+#if OGS_USE_TALLOC == 1
+#define mem_alloc(size, file_line) ogs_mem_malloc(size, file_line)
+#else
+#define mem_alloc(size, file_line) ogs_malloc_debug(size, file_line)
+#endif
+
 char *ogs_strdup_debug(const char *s, const char *file_line)
 {
     char *res;
@@ -256,9 +262,9 @@ char *ogs_strndup_debug(
     end = memchr(s, '\0', n);
     if (end != NULL)
         n = end - s;
-    res = ogs_malloc_debug(n + 1, file_line);
+    res = mem_alloc(n + 1, file_line);
     if (!res) {
-        ogs_error("ogs_malloc_debug[n:%d] failed", (int)n);
+        ogs_error("mem_alloc[n:%d] failed", (int)n);
         return res;
     }
     memcpy(res, s, n);
@@ -274,9 +280,9 @@ void *ogs_memdup_debug(
     if (m == NULL)
         return NULL;
 
-    res = ogs_malloc_debug(n, file_line);
+    res = mem_alloc(n, file_line);
     if (!res) {
-        ogs_error("ogs_malloc_debug[n:%d] failed", (int)n);
+        ogs_error("mem_alloc[n:%d] failed", (int)n);
         return res;
     }
     memcpy(res, m, n);
@@ -305,7 +311,7 @@ char *ogs_msprintf_debug(
                                     in some architectures,
                                     vsnprintf can modify argp */
         out_len = vsnprintf(NULL, 0, message, argp);
-        out = ogs_malloc_debug(out_len + sizeof(char), file_line);
+        out = mem_alloc(out_len + sizeof(char), file_line);
         if (out == NULL) {
             va_end(argp);
             va_end(argp_cpy);
@@ -349,7 +355,7 @@ char *ogs_mstrcatf_debug(
                                         in some architectures,
                                         vsnprintf can modify argp */
             out_len = vsnprintf(NULL, 0, message, argp);
-            out = ogs_malloc_debug(out_len+sizeof(char), file_line);
+            out = mem_alloc(out_len+sizeof(char), file_line);
             if (out != NULL) {
                 vsnprintf(out, (out_len+sizeof(char)), message, argp_cpy);
             }
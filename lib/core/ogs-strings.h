@@ -110,29 +110,6 @@ char *ogs_mstrcatf_debug(
     char *source, const char *file_line, const char *message, ...)
     OGS_GNUC_PRINTF(3, 4);
 
-#if OGS_USE_TALLOC == 1
-
-/*****************************************
- * Memory Pool - Use talloc library
- *****************************************/
-
-#define ogs_strdup(p) \
-    ogs_talloc_strdup(__ogs_talloc_core, p)
-#define ogs_strndup(p, n) \
-    ogs_talloc_strndup(__ogs_talloc_core, p, n)
-#define ogs_memdup(p, size) \
-    ogs_talloc_memdup(__ogs_talloc_core, p, size)
-#define ogs_msprintf(...) \
-    ogs_talloc_asprintf(__ogs_talloc_core, __VA_ARGS__)
-#define ogs_mstrcatf(s, ...) \
-    ogs_talloc_asprintf_append(s, __VA_ARGS__)
-
-#else
-
-/*****************************************
- * Memory Pool - Use pkbuf library
- *****************************************/
-
 #define ogs_strdup(s) ogs_strdup_debug(s, OGS_FILE_LINE)
 #define ogs_strndup(s, n) ogs_strndup_debug(s, n, OGS_FILE_LINE)
 #define ogs_memdup(m, n) ogs_memdup_debug(m, n, OGS_FILE_LINE)
@@ -140,8 +117,6 @@ char *ogs_mstrcatf_debug(
 #define ogs_mstrcatf(source, ...) \
     ogs_mstrcatf_debug(source, OGS_FILE_LINE, __VA_ARGS__)
 
-#endif
-
 
 char *ogs_trimwhitespace(char *str);
 
@@ -22,9 +22,52 @@
 #undef OGS_LOG_DOMAIN
 #define OGS_LOG_DOMAIN __ogs_event_domain
 
+/*
+ * Hierarchical timing wheel with a resolution of one millisecond.
+ *
+ * Level 0 has a slot for each of the next 256 ticks. Each of the four
+ * upper levels has 64 slots, each covering 64 times the range of a
+ * slot of the level below, so the wheel reaches 2^32 ticks (49 days)
+ * ahead. Timers further away are put in the last slot and moved
+ * again when it comes round.
+ *
+ * When level 0 wraps, the timers of the current slot of level 1 are
+ * cascaded down, and so on up the levels. Starting, stopping and
+ * expiring a timer are O(1). ogs_timer_mgr_next() does not look into
+ * the upper levels, so it may also wake up for a cascade with nothing
+ * to expire.
+ */
+#define OGS_TIMER_WHEEL_ROOT_BITS   8
+#define OGS_TIMER_WHEEL_ROOT_SIZE   (1 << OGS_TIMER_WHEEL_ROOT_BITS)
+#define OGS_TIMER_WHEEL_LEVEL_BITS  6
+#define OGS_TIMER_WHEEL_LEVEL_SIZE  (1 << OGS_TIMER_WHEEL_LEVEL_BITS)
+#define OGS_TIMER_WHEEL_NUM_OF_LEVEL 5
+
+#define OGS_TIMER_WHEEL_NUM_OF_SLOT (OGS_TIMER_WHEEL_ROOT_SIZE + \
+        (OGS_TIMER_WHEEL_NUM_OF_LEVEL - 1) * OGS_TIMER_WHEEL_LEVEL_SIZE)
+
+/* timer->slot while waiting to run in ogs_timer_mgr_expire() */
+#define OGS_TIMER_WHEEL_EXPIRED     -1
+
+#define OGS_TIMER_WHEEL_TICK        1000 /* usec */
+
+typedef struct ogs_timer_wheel_s {
+    /* The next tick to run */
+    int64_t tick;
+
+    ogs_list_t slot[OGS_TIMER_WHEEL_NUM_OF_SLOT];
+    /* Non-empty slots; level 0 takes the first four words */
+    uint64_t bitmap[OGS_TIMER_WHEEL_NUM_OF_SLOT / 64];
+
+    ogs_list_t expired;
+} ogs_timer_wheel_t;
+
 typedef struct ogs_timer_mgr_s {
     OGS_POOL(pool, ogs_timer_t);
     ogs_rbtree_t tree;
+
+    /* NULL when the timers are kept in the tree */
+    ogs_timer_wheel_t *wheel;
 } ogs_timer_mgr_t;
 
 static void add_timer_node(
@@ -52,6 +95,237 @@ static void add_timer_node(
     ogs_rbtree_insert_color(tree, timer);
 }
 
+static int wheel_first_level_slot(int level)
+{
+    return level ? OGS_TIMER_WHEEL_ROOT_SIZE +
+        (level - 1) * OGS_TIMER_WHEEL_LEVEL_SIZE : 0;
+}
+
+static int wheel_level_shift(int level)
+{
+    return level ? OGS_TIMER_WHEEL_ROOT_BITS +
+        (level - 1) * OGS_TIMER_WHEEL_LEVEL_BITS : 0;
+}
+
+static int wheel_level_index(int64_t tick, int level)
+{
+    return (tick >> wheel_level_shift(level)) &
+        ((level ? OGS_TIMER_WHEEL_LEVEL_SIZE : OGS_TIMER_WHEEL_ROOT_SIZE) - 1);
+}
+
+/* First set bit at or after 'from' in a word of the bitmap, or -1 */
+static int wheel_find_bit(uint64_t word, int from)
+{
+    if (from >= 64)
+        return -1;
+
+    word &= ~(uint64_t)0 << from;
+    if (!word)
+        return -1;
+
+#if defined(__GNUC__)
+    return __builtin_ctzll(word);
+#else
+    {
+        int i;
+
+        for (i = from; !(word & ((uint64_t)1 << i)); i++)
+            ;
+        return i;
+    }
+#endif
+}
+
+/* First non-empty slot of level 0 at or after 'from', or -1 */
+static int wheel_find_root_slot(ogs_timer_wheel_t *wheel, int from)
+{
+    int i, bit;
+
+    for (i = from / 64; i < OGS_TIMER_WHEEL_ROOT_SIZE / 64; i++) {
+        bit = wheel_find_bit(wheel->bitmap[i], i == from / 64 ? from % 64 : 0);
+        if (bit >= 0)
+            return i * 64 + bit;
+    }
+
+    return -1;
+}
+
+static void wheel_link(ogs_timer_wheel_t *wheel, ogs_timer_t *timer)
+{
+    int64_t expires, delta;
+    int level, slot;
+
+    /* Round up so that a timer never runs early */
+    expires = (timer->timeout + OGS_TIMER_WHEEL_TICK - 1) /
+        OGS_TIMER_WHEEL_TICK;
+    delta = expires - wheel->tick;
+
+    if (delta < 0) {
+        /* Already expired; run it on the next tick */
+        expires = wheel->tick;
+        delta = 0;
+    } else if (delta > 0xffffffff) {
+        expires = wheel->tick + 0xffffffff;
+        delta = 0xffffffff;
+    }
+
+    for (level = 0; level < OGS_TIMER_WHEEL_NUM_OF_LEVEL - 1; level++) {
+        if (delta < (int64_t)1 << wheel_level_shift(level + 1))
+            break;
+    }
+
+    slot = wheel_first_level_slot(level) + wheel_level_index(expires, level);
+
+    ogs_list_add(&wheel->slot[slot], &timer->lnode);
+    wheel->bitmap[slot / 64] |= (uint64_t)1 << (slot % 64);
+    timer->slot = slot;
+}
+
+static void wheel_unlink(ogs_timer_wheel_t *wheel, ogs_timer_t *timer)
+{
+    int slot = timer->slot;
+
+    if (slot == OGS_TIMER_WHEEL_EXPIRED) {
+        ogs_list_remove(&wheel->expired, &timer->lnode);
+        return;
+    }
+
+    ogs_list_remove(&wheel->slot[slot], &timer->lnode);
+    if (!ogs_list_first(&wheel->slot[slot]))
+        wheel->bitmap[slot / 64] &= ~((uint64_t)1 << (slot % 64));
+}
+
+/* Move the timers of a slot of an upper level down; returns its index */
+static int wheel_cascade(ogs_timer_wheel_t *wheel, int level)
+{
+    OGS_LIST(list);
+    ogs_lnode_t *lnode = NULL;
+    int index, slot;
+
+    index = wheel_level_index(wheel->tick, level);
+    slot = wheel_first_level_slot(level) + index;
+
+    if (ogs_list_first(&wheel->slot[slot])) {
+        ogs_list_copy(&list, &wheel->slot[slot]);
+        ogs_list_init(&wheel->slot[slot]);
+        wheel->bitmap[slot / 64] &= ~((uint64_t)1 << (slot % 64));
+
+        while ((lnode = ogs_list_first(&list))) {
+            ogs_list_remove(&list, lnode);
+            wheel_link(wheel, ogs_list_entry(lnode, ogs_timer_t, lnode));
+        }
+    }
+
+    return index;
+}
+
+static void wheel_expire(ogs_timer_mgr_t *manager)
+{
+    ogs_timer_wheel_t *wheel = manager->wheel;
+    ogs_lnode_t *lnode = NULL;
+    ogs_timer_t *this = NULL;
+    int64_t current;
+    int index, level, next;
+
+    current = ogs_get_monotonic_time() / OGS_TIMER_WHEEL_TICK;
+
+    while (wheel->tick <= current) {
+        index = wheel_level_index(wheel->tick, 0);
+
+        if (!index) {
+            for (level = 1; level < OGS_TIMER_WHEEL_NUM_OF_LEVEL; level++) {
+                if (wheel_cascade(wheel, level))
+                    break;
+            }
+        }
+
+        if (!ogs_list_first(&wheel->slot[index])) {
+            /* Skip empty slots, but not the next wrap of level 0 */
+            next = wheel_find_root_slot(wheel, index);
+            if (next < 0)
+                next = OGS_TIMER_WHEEL_ROOT_SIZE;
+            wheel->tick = ogs_min(
+                    wheel->tick + (next - index), current + 1);
+            continue;
+        }
+
+        wheel->tick++;
+
+        ogs_list_copy(&wheel->expired, &wheel->slot[index]);
+        ogs_list_init(&wheel->slot[index]);
+        wheel->bitmap[index / 64] &= ~((uint64_t)1 << (index % 64));
+
+        ogs_list_for_each(&wheel->expired, lnode) {
+            this = ogs_list_entry(lnode, ogs_timer_t, lnode);
+            this->slot = OGS_TIMER_WHEEL_EXPIRED;
+        }
+
+        /*
+         * A callback may stop or restart any timer, including
+         * one that is still waiting here.
+         */
+        while ((lnode = ogs_list_first(&wheel->expired))) {
+            ogs_list_remove(&wheel->expired, lnode);
+            this = ogs_list_entry(lnode, ogs_timer_t, lnode);
+            this->running = false;
+            if (this->cb)
+                this->cb(this->data);
+        }
+    }
+}
+
+static ogs_time_t wheel_next(ogs_timer_mgr_t *manager)
+{
+    ogs_timer_wheel_t *wheel = manager->wheel;
+    ogs_time_t current;
+    int64_t next = -1, tick;
+    int level, index, shift, slot, delta;
+    uint64_t word;
+
+    index = wheel_level_index(wheel->tick, 0);
+    slot = wheel_find_root_slot(wheel, index);
+    if (slot < 0)
+        slot = wheel_find_root_slot(wheel, 0);
+    if (slot >= 0)
+        next = wheel->tick +
+            ((slot - index) & (OGS_TIMER_WHEEL_ROOT_SIZE - 1));
+
+    /* Timers of upper levels are due no earlier than their cascade */
+    for (level = 1; level < OGS_TIMER_WHEEL_NUM_OF_LEVEL; level++) {
+        word = wheel->bitmap[wheel_first_level_slot(level) / 64];
+        if (!word)
+            continue;
+
+        shift = wheel_level_shift(level);
+        index = wheel_level_index(wheel->tick, level);
+
+        delta = OGS_TIMER_WHEEL_LEVEL_SIZE;
+        if (word & ((uint64_t)1 << index) &&
+            !(wheel->tick & (((int64_t)1 << shift) - 1)))
+            delta = 0;
+
+        slot = wheel_find_bit(word, index + 1);
+        if (slot < 0)
+            slot = wheel_find_bit(word, 0);
+        if (slot >= 0 && slot != index)
+            delta = ogs_min(delta,
+                    (slot - index) & (OGS_TIMER_WHEEL_LEVEL_SIZE - 1));
+
+        tick = ((wheel->tick >> shift) + delta) << shift;
+        if (next < 0 || tick < next)
+            next = tick;
+    }
+
+    if (next < 0)
+        return OGS_INFINITE_TIME;
+
+    current = ogs_get_monotonic_time();
+    if (next * OGS_TIMER_WHEEL_TICK > current)
+        return next * OGS_TIMER_WHEEL_TICK - current;
+
+    return OGS_NO_WAIT_TIME;
+}
+
 ogs_timer_mgr_t *ogs_timer_mgr_create(unsigned int capacity)
 {
     ogs_timer_mgr_t *manager = ogs_calloc(1, sizeof *manager);
@@ -65,11 +339,34 @@ ogs_timer_mgr_t *ogs_timer_mgr_create(unsigned int capacity)
     return manager;
 }
 
+ogs_timer_mgr_t *ogs_timer_mgr_create_wheel(unsigned int capacity)
+{
+    ogs_timer_mgr_t *manager = NULL;
+
+    manager = ogs_timer_mgr_create(capacity);
+    if (!manager)
+        return NULL;
+
+    manager->wheel = ogs_calloc(1, sizeof(*manager->wheel));
+    if (!manager->wheel) {
+        ogs_error("ogs_calloc() failed");
+        ogs_timer_mgr_destroy(manager);
+        return NULL;
+    }
+
+    manager->wheel->tick =
+        ogs_get_monotonic_time() / OGS_TIMER_WHEEL_TICK;
+
+    return manager;
+}
+
 void ogs_timer_mgr_destroy(ogs_timer_mgr_t *manager)
 {
     ogs_assert(manager);
 
     ogs_pool_final(&manager->pool);
+    if (manager->wheel)
+        ogs_free(manager->wheel);
     ogs_free(manager);
 }
 
@@ -132,6 +429,16 @@ void ogs_timer_start_debug(
         ogs_assert_if_reached();
     }
 
+    if (manager->wheel) {
+        if (timer->running == true)
+            wheel_unlink(manager->wheel, timer);
+
+        timer->running = true;
+        timer->timeout = ogs_get_monotonic_time() + duration;
+        wheel_link(manager->wheel, timer);
+        return;
+    }
+
     if (timer->running == true)
         ogs_rbtree_delete(&manager->tree, timer);
 
@@ -155,7 +462,10 @@ void ogs_timer_stop_debug(ogs_timer_t *timer, const char *file_line)
         return;
 
     timer->running = false;
-    ogs_rbtree_delete(&manager->tree, timer);
+    if (manager->wheel)
+        wheel_unlink(manager->wheel, timer);
+    else
+        ogs_rbtree_delete(&manager->tree, timer);
 }
 
 ogs_time_t ogs_timer_mgr_next(ogs_timer_mgr_t *manager)
@@ -164,6 +474,9 @@ ogs_time_t ogs_timer_mgr_next(ogs_timer_mgr_t *manager)
     ogs_rbnode_t *rbnode = NULL;
     ogs_assert(manager);
 
+    if (manager->wheel)
+        return wheel_next(manager);
+
     current = ogs_get_monotonic_time();
     rbnode = ogs_rbtree_first(&manager->tree);
     if (rbnode) {
@@ -188,6 +501,11 @@ void ogs_timer_mgr_expire(ogs_timer_mgr_t *manager)
     ogs_timer_t *this;
     ogs_assert(manager);
 
+    if (manager->wheel) {
+        wheel_expire(manager);
+        return;
+    }
+
     current = ogs_get_monotonic_time();
 
     ogs_rbtree_for_each(&manager->tree, rbnode) {
@@ -95,10 +95,70 @@ static uint8_t tlv_ctype2mode(ogs_tlv_type_e ctype, uint8_t msg_mode)
     }
 }
 
-static ogs_tlv_t *tlv_add_leaf(
-        ogs_tlv_t *parent_tlv, ogs_tlv_t *tlv, ogs_tlv_desc_t *desc, void *msg, uint8_t msg_mode)
+static int tlv_header_len(uint8_t mode)
+{
+    switch (mode) {
+    case OGS_TLV_MODE_T1_L1:
+        return 2;
+    case OGS_TLV_MODE_T1_L2:
+        return 3;
+    case OGS_TLV_MODE_T1_L2_I1:
+    case OGS_TLV_MODE_T2_L2:
+        return 4;
+    case OGS_TLV_MODE_T1:
+        return 1;
+    default:
+        ogs_assert_if_reached();
+        return 0;
+    }
+}
+
+static void tlv_put_header(uint8_t *pos, uint8_t mode,
+        uint16_t type, uint32_t length, uint8_t instance)
+{
+    switch (mode) {
+    case OGS_TLV_MODE_T1_L1:
+        pos[0] = type;
+        pos[1] = length;
+        break;
+    case OGS_TLV_MODE_T1_L2:
+        pos[0] = type;
+        pos[1] = length >> 8;
+        pos[2] = length;
+        break;
+    case OGS_TLV_MODE_T1_L2_I1:
+        pos[0] = type;
+        pos[1] = length >> 8;
+        pos[2] = length;
+        pos[3] = instance;
+        break;
+    case OGS_TLV_MODE_T2_L2:
+        pos[0] = type >> 8;
+        pos[1] = type;
+        pos[2] = length >> 8;
+        pos[3] = length;
+        break;
+    case OGS_TLV_MODE_T1:
+        pos[0] = type;
+        break;
+    default:
+        ogs_assert_if_reached();
+        break;
+    }
+}
+
+/*
+ * Returns OGS_OK, OGS_RETRY if the IE does not fit before 'end',
+ * or OGS_ERROR.
+ */
+static int tlv_encode_leaf(uint8_t **pos, uint8_t *end,
+        ogs_tlv_desc_t *desc, void *msg, uint8_t msg_mode)
 {
     uint8_t tlv_mode = tlv_ctype2mode(desc->ctype, msg_mode);
+    uint8_t buf[4];
+    const void *value = buf;
+    uint32_t length;
+    int header_len;
 
     switch (desc->ctype) {
     case OGS_TLV_UINT8:
@@ -107,21 +167,9 @@ static ogs_tlv_t *tlv_add_leaf(
     case OGS_TV_INT8:
     {
         ogs_tlv_uint8_t *v = (ogs_tlv_uint8_t *)msg;
-        if (parent_tlv) {
-            tlv = ogs_tlv_embed(parent_tlv, tlv_mode,
-                    desc->type, 1, desc->instance, &v->u8);
-            if (!tlv) {
-                ogs_error("ogs_tlv_embed()");
-                return NULL;
-            }
-        } else {
-            tlv = ogs_tlv_add(tlv, tlv_mode,
-                    desc->type, 1, desc->instance, &v->u8);
-            if (!tlv) {
-                ogs_error("ogs_tlv_add()");
-                return NULL;
-            }
-        }
+
+        buf[0] = v->u8;
+        length = 1;
         break;
     }
     case OGS_TLV_UINT16:
@@ -131,23 +179,9 @@ static ogs_tlv_t *tlv_add_leaf(
     {
         ogs_tlv_uint16_t *v = (ogs_tlv_uint16_t *)msg;
 
-        v->u16 = htobe16(v->u16);
-
-        if (parent_tlv) {
-            tlv = ogs_tlv_embed(parent_tlv, tlv_mode,
-                    desc->type, 2, desc->instance, &v->u16);
-            if (!tlv) {
-                ogs_error("ogs_tlv_embed()");
-                return NULL;
-            }
-        } else {
-            tlv = ogs_tlv_add(tlv, tlv_mode,
-                    desc->type, 2, desc->instance, &v->u16);
-            if (!tlv) {
-                ogs_error("ogs_tlv_add()");
-                return NULL;
-            }
-        }
+        buf[0] = v->u16 >> 8;
+        buf[1] = v->u16;
+        length = 2;
         break;
     }
     case OGS_TLV_UINT24:
@@ -157,24 +191,10 @@ static ogs_tlv_t *tlv_add_leaf(
     {
         ogs_tlv_uint24_t *v = (ogs_tlv_uint24_t *)msg;
 
-        v->u24 = v->u24 << 8;
-        v->u24 = htobe32(v->u24);
-
-        if (parent_tlv) {
-            tlv = ogs_tlv_embed(parent_tlv, tlv_mode,
-                    desc->type, 3, desc->instance, &v->u24);
-            if (!tlv) {
-                ogs_error("ogs_tlv_embed()");
-                return NULL;
-            }
-        } else {
-            tlv = ogs_tlv_add(tlv, tlv_mode,
-                    desc->type, 3, desc->instance, &v->u24);
-            if (!tlv) {
-                ogs_error("ogs_tlv_add()");
-                return NULL;
-            }
-        }
+        buf[0] = v->u24 >> 16;
+        buf[1] = v->u24 >> 8;
+        buf[2] = v->u24;
+        length = 3;
         break;
     }
     case OGS_TLV_UINT32:
@@ -184,23 +204,11 @@ static ogs_tlv_t *tlv_add_leaf(
     {
         ogs_tlv_uint32_t *v = (ogs_tlv_uint32_t *)msg;
 
-        v->u32 = htobe32(v->u32);
-
-        if (parent_tlv) {
-            tlv = ogs_tlv_embed(parent_tlv, tlv_mode,
-                    desc->type, 4, desc->instance, &v->u32);
-            if (!tlv) {
-                ogs_error("ogs_tlv_embed()");
-                return NULL;
-            }
-        } else {
-            tlv = ogs_tlv_add(tlv, tlv_mode,
-                    desc->type, 4, desc->instance, &v->u32);
-            if (!tlv) {
-                ogs_error("ogs_tlv_add()");
-                return NULL;
-            }
-        }
+        buf[0] = v->u32 >> 24;
+        buf[1] = v->u32 >> 16;
+        buf[2] = v->u32 >> 8;
+        buf[3] = v->u32;
+        length = 4;
         break;
     }
     case OGS_TLV_FIXED_STR:
@@ -208,21 +216,8 @@ static ogs_tlv_t *tlv_add_leaf(
     {
         ogs_tlv_octet_t *v = (ogs_tlv_octet_t *)msg;
 
-        if (parent_tlv) {
-            tlv = ogs_tlv_embed(parent_tlv, tlv_mode,
-                    desc->type, desc->length, desc->instance, v->data);
-            if (!tlv) {
-                ogs_error("ogs_tlv_embed()");
-                return NULL;
-            }
-        } else {
-            tlv = ogs_tlv_add(tlv, tlv_mode,
-                    desc->type, desc->length, desc->instance, v->data);
-            if (!tlv) {
-                ogs_error("ogs_tlv_add()");
-                return NULL;
-            }
-        }
+        value = v->data;
+        length = desc->length;
         break;
     }
     case OGS_TLV_VAR_STR:
@@ -232,176 +227,126 @@ static ogs_tlv_t *tlv_add_leaf(
         if (v->len == 0) {
             ogs_error("No TLV length - [%s] T:%d I:%d (vsz=%d)",
                     desc->name, desc->type, desc->instance, desc->vsize);
-            return NULL;
+            return OGS_ERROR;
         }
 
-        if (parent_tlv) {
-            tlv = ogs_tlv_embed(parent_tlv, tlv_mode,
-                    desc->type, v->len, desc->instance, v->data);
-            if (!tlv) {
-                ogs_error("ogs_tlv_embed()");
-                return NULL;
-            }
-        } else {
-            tlv = ogs_tlv_add(tlv, tlv_mode,
-                    desc->type, v->len, desc->instance, v->data);
-            if (!tlv) {
-                ogs_error("ogs_tlv_add()");
-                return NULL;
-            }
-        }
+        value = v->data;
+        length = v->len;
         break;
     }
     case OGS_TLV_NULL:
     case OGS_TV_NULL:
-    {
-        if (parent_tlv) {
-            tlv = ogs_tlv_embed(parent_tlv, tlv_mode,
-                    desc->type, 0, desc->instance, NULL);
-            if (!tlv) {
-                ogs_error("ogs_tlv_embed()");
-                return NULL;
-            }
-        } else {
-            tlv = ogs_tlv_add(tlv, tlv_mode,
-                    desc->type, 0, desc->instance, NULL);
-            if (!tlv) {
-                ogs_error("ogs_tlv_add()");
-                return NULL;
-            }
-        }
+        length = 0;
         break;
-    }
     default:
         ogs_error("Unknown type [%d]", desc->ctype);
-        return NULL;
+        return OGS_ERROR;
+    }
+
+    if (length)
+        ogs_assert(value);
+
+    header_len = tlv_header_len(tlv_mode);
+    if ((size_t)(end - *pos) < header_len + length)
+        return OGS_RETRY;
+
+    tlv_put_header(*pos, tlv_mode,
+            desc->type, length, desc->instance);
+    *pos += header_len;
+    if (length) {
+        memcpy(*pos, value, length);
+        *pos += length;
     }
 
-    return tlv;
+    return OGS_OK;
 }
 
-static uint32_t tlv_add_compound(ogs_tlv_t **root, ogs_tlv_t *parent_tlv,
+/*
+ * Writes the IEs present in 'msg' at '*pos' and returns how many,
+ * OGS_RETRY if they do not fit before 'end', or OGS_ERROR.
+ * The length of a grouped IE is filled in once its IEs are written.
+ */
+static int tlv_encode_compound(uint8_t **pos, uint8_t *end,
         ogs_tlv_desc_t *parent_desc, void *msg, int depth, uint8_t mode)
 {
     ogs_tlv_presence_t *presence_p;
     ogs_tlv_desc_t *desc = NULL, *next_desc = NULL;
-    ogs_tlv_t *tlv = NULL, *emb_tlv = NULL;
-    uint8_t *p = msg;
-    uint32_t offset = 0, count = 0;
-    int i, j, r;
+    uint8_t *p = msg, *header;
+    uint32_t offset = 0, offset2;
+    int count = 0, i, j, num, header_len, r;
+    bool more;
     char indent[17] = "                "; /* 16 spaces */
 
-    ogs_assert(root);
+    ogs_assert(pos);
     ogs_assert(parent_desc);
     ogs_assert(msg);
 
     ogs_assert(depth <= 8);
     indent[depth*2] = 0;
 
-    *root = NULL;
-
     for (i = 0, desc = parent_desc->child_descs[i]; desc != NULL;
             i++, desc = parent_desc->child_descs[i]) {
         next_desc = parent_desc->child_descs[i+1];
-        if (next_desc != NULL && next_desc->ctype == OGS_TLV_MORE) {
-            int offset2 = offset;
-            for (j = 0; j < next_desc->length; j++) {
-                presence_p = (ogs_tlv_presence_t *)(p + offset2);
-
-                if (*presence_p == 0)
-                    break;
-
-                if (desc->ctype == OGS_TLV_COMPOUND) {
-                    ogs_trace("BUILD %sC#%d [%s] T:%d I:%d (vsz=%d) off:%p ",
-                            indent, i, desc->name, desc->type, desc->instance,
-                            desc->vsize, p + offset2);
-
-                    if (parent_tlv)
-                        tlv = ogs_tlv_embed(parent_tlv,
-                                tlv_ctype2mode(desc->ctype, mode),
-                                desc->type, 0, desc->instance, NULL);
-                    else
-                        tlv = ogs_tlv_add(tlv,
-                                tlv_ctype2mode(desc->ctype, mode),
-                                desc->type, 0, desc->instance, NULL);
-
-                    r = tlv_add_compound(&emb_tlv, tlv, desc,
-                            p + offset2 + sizeof(ogs_tlv_presence_t),
-                            depth + 1, mode);
-                    if (r <= 0 || !emb_tlv) {
-                        ogs_error("tlv_add_compound() failed");
-                        return 0;
-                    }
-                    count += 1 + r;
-                } else {
-                    ogs_trace("BUILD %sL#%d [%s] T:%d L:%d I:%d "
-                            "(cls:%d vsz:%d) off:%p ",
-                            indent, i, desc->name, desc->type, desc->length,
-                            desc->instance, desc->ctype, desc->vsize,
-                            p + offset2);
-
-                    tlv = tlv_add_leaf(parent_tlv, tlv, desc,
-                            p + offset2, mode);
-                    if (!tlv) {
-                        ogs_error("tlv_add_leaf() failed");
-                        return 0;
-                    }
-                    count++;
-                }
 
-                if (*root == NULL)
-                    *root = tlv;
+        /* An IE followed by OGS_TLV_MORE is an array of them */
+        more = next_desc != NULL && next_desc->ctype == OGS_TLV_MORE;
+        num = more ? next_desc->length : 1;
 
-                offset2 += desc->vsize;
-            }
-            offset += desc->vsize * next_desc->length;
-            i++;
-        } else {
-            presence_p = (ogs_tlv_presence_t *)(p + offset);
-
-            if (*presence_p) {
-                if (desc->ctype == OGS_TLV_COMPOUND) {
-                    ogs_trace("BUILD %sC#%d [%s] T:%d I:%d (vsz=%d) off:%p ",
-                            indent, i, desc->name, desc->type, desc->instance,
-                            desc->vsize, p + offset);
-
-                    if (parent_tlv)
-                        tlv = ogs_tlv_embed(parent_tlv,
-                                tlv_ctype2mode(desc->ctype, mode),
-                                desc->type, 0, desc->instance, NULL);
-                    else
-                        tlv = ogs_tlv_add(tlv,
-                                tlv_ctype2mode(desc->ctype, mode),
-                                desc->type, 0, desc->instance, NULL);
-
-                    r = tlv_add_compound(&emb_tlv, tlv, desc,
-                            p + offset + sizeof(ogs_tlv_presence_t),
-                            depth + 1, mode);
-                    if (r <= 0 || !emb_tlv) {
-                        ogs_error("tlv_add_compound() failed");
-                        return 0;
-                    }
-                    count += 1 + r;
-                } else {
-                    ogs_trace("BUILD %sL#%d [%s] T:%d L:%d I:%d "
-                            "(cls:%d vsz:%d) off:%p ",
-                            indent, i, desc->name, desc->type, desc->length,
-                            desc->instance, desc->ctype, desc->vsize,
-                            p + offset);
-
-                    tlv = tlv_add_leaf(parent_tlv, tlv, desc, p + offset, mode);
-                    if (!tlv) {
-                        ogs_error("tlv_add_leaf() failed");
-                        return 0;
-                    }
-                    count++;
+        for (j = 0, offset2 = offset; j < num; j++) {
+            presence_p = (ogs_tlv_presence_t *)(p + offset2);
+
+            if (*presence_p == 0)
+                break;
+
+            if (desc->ctype == OGS_TLV_COMPOUND) {
+                ogs_trace("BUILD %sC#%d [%s] T:%d I:%d (vsz=%d) off:%p ",
+                        indent, i, desc->name, desc->type, desc->instance,
+                        desc->vsize, p + offset2);
+
+                header_len = tlv_header_len(tlv_ctype2mode(desc->ctype, mode));
+                if ((size_t)(end - *pos) < header_len)
+                    return OGS_RETRY;
+
+                header = *pos;
+                *pos += header_len;
+
+                r = tlv_encode_compound(pos, end, desc,
+                        p + offset2 + sizeof(ogs_tlv_presence_t),
+                        depth + 1, mode);
+                if (r == OGS_RETRY)
+                    return r;
+                if (r <= 0) {
+                    ogs_error("tlv_encode_compound() failed");
+                    return OGS_ERROR;
                 }
 
-                if (*root == NULL)
-                    *root = tlv;
+                tlv_put_header(header, tlv_ctype2mode(desc->ctype, mode),
+                        desc->type, *pos - header - header_len,
+                        desc->instance);
+                count += 1 + r;
+            } else {
+                ogs_trace("BUILD %sL#%d [%s] T:%d L:%d I:%d "
+                        "(cls:%d vsz:%d) off:%p ",
+                        indent, i, desc->name, desc->type, desc->length,
+                        desc->instance, desc->ctype, desc->vsize,
+                        p + offset2);
+
+                r = tlv_encode_leaf(pos, end, desc, p + offset2, mode);
+                if (r == OGS_RETRY)
+                    return r;
+                if (r != OGS_OK) {
+                    ogs_error("tlv_encode_leaf() failed");
+                    return OGS_ERROR;
+                }
+                count++;
             }
-            offset += desc->vsize;
+
+            offset2 += desc->vsize;
         }
+
+        offset += desc->vsize * num;
+        if (more)
+            i++;
     }
 
     return count;
@@ -409,44 +354,53 @@ static uint32_t tlv_add_compound(ogs_tlv_t **root, ogs_tlv_t *parent_tlv,
 
 ogs_pkbuf_t *ogs_tlv_build_msg(ogs_tlv_desc_t *desc, void *msg, int mode)
 {
-    ogs_tlv_t *root = NULL;
-    uint32_t r, length, rendlen;
+    uint8_t buf[OGS_HUGE_LEN], *data = buf, *pos = buf;
+    uint32_t size = sizeof(buf), length = 0;
     ogs_pkbuf_t *pkbuf = NULL;
+    int r;
 
     ogs_assert(desc);
     ogs_assert(msg);
 
     ogs_assert(desc->ctype == OGS_TLV_MESSAGE);
 
+    /*
+     * The IEs are written into a buffer on the stack, and into one on
+     * the heap only if the message is larger. The pkbuf is then allocated
+     * with the exact length, as before.
+     */
     if (desc->child_descs[0]) {
-        r = tlv_add_compound(&root, NULL, desc, msg, 0, mode);
-        if (r <= 0 || !root) {
-            ogs_error("tlv_add_compound() failed");
-            return NULL;
+        r = tlv_encode_compound(&pos, data + size, desc, msg, 0, mode);
+        if (r == OGS_RETRY) {
+            size = OGS_TLV_MAX_MSG_LEN;
+            data = pos = ogs_malloc(size);
+            if (!data) {
+                ogs_error("ogs_malloc() failed");
+                return NULL;
+            }
+            r = tlv_encode_compound(&pos, data + size, desc, msg, 0, mode);
+            if (r == OGS_RETRY)
+                ogs_error("Message too long [%s]", desc->name);
+        }
+        if (r <= 0) {
+            ogs_error("tlv_encode_compound() failed");
+            goto out;
         }
 
-        length = ogs_tlv_calc_length(root);
-    } else {
-        length = 0;
+        length = pos - data;
     }
+
     pkbuf = ogs_pkbuf_alloc(NULL, OGS_TLV_MAX_HEADROOM+length);
     if (!pkbuf) {
         ogs_error("ogs_pkbuf_alloc() failed");
-        return NULL;
+        goto out;
     }
     ogs_pkbuf_reserve(pkbuf, OGS_TLV_MAX_HEADROOM);
-    ogs_pkbuf_put(pkbuf, length);
-
-    if (desc->child_descs[0]) {
-        rendlen = ogs_tlv_render(root, pkbuf->data, length);
-        if (rendlen != length) {
-            ogs_error("ogs_tlv_render[rendlen:%d != length:%d] failed",
-                    rendlen, length);
-            return NULL;
-        }
+    ogs_pkbuf_put_data(pkbuf, data, length);
 
-        ogs_tlv_free_all(root);
-    }
+out:
+    if (data != buf)
+        ogs_free(data);
 
     return pkbuf;
 }
@@ -484,11 +438,11 @@ static ogs_tlv_desc_t* tlv_find_desc_by_type_inst(uint8_t *desc_index,
     return desc;
 }
 
-static int tlv_parse_leaf(void *msg, ogs_tlv_desc_t *desc, ogs_tlv_t *tlv)
+static int tlv_parse_leaf(void *msg, ogs_tlv_desc_t *desc, ogs_tlv_ie_t *ie)
 {
     ogs_assert(msg);
     ogs_assert(desc);
-    ogs_assert(tlv);
+    ogs_assert(ie);
 
     switch (desc->ctype) {
     case OGS_TV_UINT8:
@@ -498,11 +452,11 @@ static int tlv_parse_leaf(void *msg, ogs_tlv_desc_t *desc, ogs_tlv_t *tlv)
     {
         ogs_tlv_uint8_t *v = (ogs_tlv_uint8_t *)msg;
 
-        if (tlv->length != 1) {
-            ogs_error("Invalid TLV length %d. It should be 1", tlv->length);
+        if (ie->length != 1) {
+            ogs_error("Invalid TLV length %d. It should be 1", ie->length);
             return OGS_ERROR;
         }
-        v->u8 = *(uint8_t*)(tlv->value);
+        v->u8 = *(uint8_t*)(ie->value);
         break;
     }
     case OGS_TV_UINT16:
@@ -512,12 +466,12 @@ static int tlv_parse_leaf(void *msg, ogs_tlv_desc_t *desc, ogs_tlv_t *tlv)
     {
         ogs_tlv_uint16_t *v = (ogs_tlv_uint16_t *)msg;
 
-        if (tlv->length < 1 || tlv->length > 2) {
-            ogs_error("Invalid TLV length %d.", tlv->length);
+        if (ie->length < 1 || ie->length > 2) {
+            ogs_error("Invalid TLV length %d.", ie->length);
             return OGS_ERROR;
         }
-        v->u16 = ((((uint8_t*)tlv->value)[0]<< 8)&0xff00) |
-               ((((uint8_t*)tlv->value)[1]    )&0x00ff);
+        v->u16 = ((((uint8_t*)ie->value)[0]<< 8)&0xff00) |
+               ((((uint8_t*)ie->value)[1]    )&0x00ff);
         break;
     }
     case OGS_TV_UINT24:
@@ -527,13 +481,13 @@ static int tlv_parse_leaf(void *msg, ogs_tlv_desc_t *desc, ogs_tlv_t *tlv)
     {
         ogs_tlv_uint24_t *v = (ogs_tlv_uint24_t *)msg;
 
-        if (tlv->length < 1 || tlv->length > 3) {
-            ogs_error("Invalid TLV length %d.", tlv->length);
+        if (ie->length < 1 || ie->length > 3) {
+            ogs_error("Invalid TLV length %d.", ie->length);
             return OGS_ERROR;
         }
-        v->u24 = ((((uint8_t*)tlv->value)[0]<<16)&0x00ff0000) |
-               ((((uint8_t*)tlv->value)[1]<< 8)&0x0000ff00) |
-               ((((uint8_t*)tlv->value)[2]    )&0x000000ff);
+        v->u24 = ((((uint8_t*)ie->value)[0]<<16)&0x00ff0000) |
+               ((((uint8_t*)ie->value)[1]<< 8)&0x0000ff00) |
+               ((((uint8_t*)ie->value)[2]    )&0x000000ff);
         break;
     }
     case OGS_TV_UINT32:
@@ -543,14 +497,14 @@ static int tlv_parse_leaf(void *msg, ogs_tlv_desc_t *desc, ogs_tlv_t *tlv)
     {
         ogs_tlv_uint32_t *v = (ogs_tlv_uint32_t *)msg;
 
-        if (tlv->length < 1 || tlv->length > 4) {
-            ogs_error("Invalid TLV length %d.", tlv->length);
+        if (ie->length < 1 || ie->length > 4) {
+            ogs_error("Invalid TLV length %d.", ie->length);
             return OGS_ERROR;
         }
-        v->u32 = ((((uint8_t*)tlv->value)[0]<<24)&0xff000000) |
-               ((((uint8_t*)tlv->value)[1]<<16)&0x00ff0000) |
-               ((((uint8_t*)tlv->value)[2]<< 8)&0x0000ff00) |
-               ((((uint8_t*)tlv->value)[3]    )&0x000000ff);
+        v->u32 = ((((uint8_t*)ie->value)[0]<<24)&0xff000000) |
+               ((((uint8_t*)ie->value)[1]<<16)&0x00ff0000) |
+               ((((uint8_t*)ie->value)[2]<< 8)&0x0000ff00) |
+               ((((uint8_t*)ie->value)[3]    )&0x000000ff);
         break;
     }
     case OGS_TV_FIXED_STR:
@@ -558,30 +512,30 @@ static int tlv_parse_leaf(void *msg, ogs_tlv_desc_t *desc, ogs_tlv_t *tlv)
     {
         ogs_tlv_octet_t *v = (ogs_tlv_octet_t *)msg;
 
-        if (tlv->length != desc->length)
+        if (ie->length != desc->length)
         {
             ogs_error("Invalid TLV length %d. It should be %d",
-                    tlv->length, desc->length);
+                    ie->length, desc->length);
             return OGS_ERROR;
         }
 
-        v->data = tlv->value;
-        v->len = tlv->length;
+        v->data = ie->value;
+        v->len = ie->length;
         break;
     }
     case OGS_TLV_VAR_STR:
     {
         ogs_tlv_octet_t *v = (ogs_tlv_octet_t *)msg;
 
-        v->data = tlv->value;
-        v->len = tlv->length;
+        v->data = ie->value;
+        v->len = ie->length;
         break;
     }
     case OGS_TV_NULL:
     case OGS_TLV_NULL:
     {
-        if (tlv->length != 0) {
-            ogs_error("Invalid TLV length %d. It should be 0", tlv->length);
+        if (ie->length != 0) {
+            ogs_error("Invalid TLV length %d. It should be 0", ie->length);
             return OGS_ERROR;
         }
         break;
@@ -594,111 +548,205 @@ static int tlv_parse_leaf(void *msg, ogs_tlv_desc_t *desc, ogs_tlv_t *tlv)
     return OGS_OK;
 }
 
-/* rbtree structure used to keep track count of TLVs with given <type,instance>
- * while parsing. This is used to link it to the matching nth field in a
- * ogs_tlv_desc_t struct */
-typedef struct tlv_count_node_s {
-    ogs_rbnode_t node;
-    uint32_t key; /* type<<8 + instance */
-    unsigned count;
-} tlv_count_node_t;
-
-static tlv_count_node_t *tlv_count_node_find(ogs_rbtree_t *tree, tlv_count_node_t *count_node_arr, unsigned count_node_arr_len,
-        unsigned *count_alloc_next, uint16_t type, uint8_t instance)
+static uint16_t parse_get_element_type(uint8_t *pos, uint8_t mode)
 {
-    ogs_rbnode_t **new = NULL;
-    ogs_rbnode_t *parent = NULL;
-    tlv_count_node_t *this;
-
-    uint64_t key = (((uint32_t)type)<<8) | instance;
-
-    new = &tree->root;
-    while (*new) {
-        this = ogs_rb_entry(*new, tlv_count_node_t, node);
-        parent = *new;
-        if (key < this->key) {
-            new = &(*new)->left;
-        } else if (key > this->key) {
-            new = &(*new)->right;
-        } else { /* found entry: */
-            return this;
-        }
+    uint16_t type;
+
+    switch(mode) {
+    case OGS_TLV_MODE_T1_L1:
+    case OGS_TLV_MODE_T1_L2:
+    case OGS_TLV_MODE_T1_L2_I1:
+    case OGS_TLV_MODE_T1:
+        type = *pos;
+        break;
+    case OGS_TLV_MODE_T2_L2:
+        type = *(pos++) << 8;
+        type += *(pos++);
+        break;
+    default:
+        ogs_assert_if_reached();
+        break;
+    }
+
+    return type;
+}
+
+/* Read the IE header at "pos". A TV element carries no length, so it is
+ * given by "fixed_length". Returns the start of the next IE, or NULL if
+ * this one does not fit before "end". */
+static uint8_t *tlv_get_ie(ogs_tlv_ie_t *ie, uint8_t *pos, uint8_t *end,
+        uint8_t mode, uint32_t fixed_length)
+{
+    if (end - pos < tlv_header_len(mode))
+        return NULL;
+
+    ie->instance = 0;
+
+    switch (mode) {
+    case OGS_TLV_MODE_T1_L1:
+        ie->type = pos[0];
+        ie->length = pos[1];
+        break;
+    case OGS_TLV_MODE_T1_L2:
+        ie->type = pos[0];
+        ie->length = (pos[1] << 8) | pos[2];
+        break;
+    case OGS_TLV_MODE_T1_L2_I1:
+        ie->type = pos[0];
+        ie->length = (pos[1] << 8) | pos[2];
+        ie->instance = pos[3] & 0x0f;
+        break;
+    case OGS_TLV_MODE_T2_L2:
+        ie->type = (pos[0] << 8) | pos[1];
+        ie->length = (pos[2] << 8) | pos[3];
+        break;
+    case OGS_TLV_MODE_T1:
+        ie->type = pos[0];
+        ie->length = fixed_length;
+        break;
+    default:
+        ogs_assert_if_reached();
+        break;
     }
 
-    /* No entry, need to add one: */
-    if (*count_alloc_next == count_node_arr_len) {
-        ogs_error("This TLV has to many entries, can't parse");
+    pos += tlv_header_len(mode);
+    if ((uint32_t)(end - pos) < ie->length)
         return NULL;
+
+    ie->value = pos;
+
+    return pos + ie->length;
+}
+
+/* Same as tlv_get_ie(), but the IE format (TLV or TV, and the length of
+ * a TV element) is taken from the matching child of "parent_desc". */
+static uint8_t *tlv_get_ie_by_desc(ogs_tlv_ie_t *ie, uint8_t *pos,
+        uint8_t *end, uint8_t msg_mode, ogs_tlv_desc_t *parent_desc)
+{
+    ogs_tlv_desc_t *desc = NULL;
+    uint8_t desc_index = 0;
+    uint32_t offset = 0;
+    uint16_t type;
+    uint8_t mode;
+
+    if (end - pos < (msg_mode == OGS_TLV_MODE_T2_L2 ? 2 : 1))
+        return NULL;
+
+    /* All tags with same instance should use the same tlv_desc,
+     * so take the first one */
+    type = parse_get_element_type(pos, msg_mode);
+    desc = tlv_find_desc_by_type_inst(
+            &desc_index, &offset, parent_desc, type, 0, 0);
+    if (!desc) {
+        ogs_error("Can't parse find TLV description for type %u", type);
+        return NULL;
+    }
+
+    mode = tlv_ctype2mode(desc->ctype, msg_mode);
+    return tlv_get_ie(ie, pos, end, mode,
+            mode == OGS_TLV_MODE_T1 ? desc->length : 0);
+}
+
+/* Find the child of "parent_desc" that receives "ie". The n-th IE with a
+ * given <type,instance> goes to the n-th child declared with it, except
+ * that a child followed by OGS_TLV_MORE takes all of them. "count" keeps
+ * how many IEs each child already holds. */
+static ogs_tlv_desc_t *tlv_find_child_desc(ogs_tlv_desc_t *parent_desc,
+        uint8_t *count, ogs_tlv_ie_t *ie, uint8_t *desc_index,
+        uint32_t *offset)
+{
+    ogs_tlv_desc_t *prev_desc = NULL, *desc = NULL, *next_desc = NULL;
+    uint32_t off = 0;
+    int i;
+
+    for (i = 0, desc = parent_desc->child_descs[i]; desc != NULL;
+            i++, desc = parent_desc->child_descs[i]) {
+        if (desc->type == ie->type && desc->instance == ie->instance &&
+            desc->ctype != OGS_TLV_MORE) {
+            next_desc = parent_desc->child_descs[i+1];
+            if (count[i] == 0 ||
+                (next_desc && next_desc->ctype == OGS_TLV_MORE)) {
+                *desc_index = i;
+                *offset = off;
+                return desc;
+            }
+        }
+
+        if (desc->ctype == OGS_TLV_MORE) {
+            ogs_assert(prev_desc && prev_desc->ctype != OGS_TLV_MORE);
+            off += prev_desc->vsize * (desc->length - 1);
+        } else {
+            off += desc->vsize;
+        }
+
+        prev_desc = desc;
     }
-    this = &count_node_arr[(*count_alloc_next)++];
-    this->key = key;
-    this->count = 0;
-    ogs_rbtree_link_node(&this->node, parent, new);
-    ogs_rbtree_insert_color(tree, &this->node);
-    return this;
+
+    return NULL;
 }
 
+/* Decode the IEs in [data, data+length) straight into "msg". Nothing is
+ * allocated: the IE headers are read in place and octet strings point
+ * into the buffer. "by_desc" selects tlv_get_ie_by_desc() for the
+ * message level of ogs_tlv_parse_msg_desc(). */
 static int tlv_parse_compound(void *msg, ogs_tlv_desc_t *parent_desc,
-        ogs_tlv_t *parent_tlv, int depth, int mode)
+        uint8_t *data, uint32_t length, int depth, int mode, bool by_desc)
 {
     int rv;
-    ogs_tlv_presence_t *presence_p = (ogs_tlv_presence_t *)msg;
+    ogs_tlv_presence_t *presence_p = NULL;
     ogs_tlv_desc_t *desc = NULL, *next_desc = NULL;
-    ogs_tlv_t *tlv = NULL, *emb_tlv = NULL;
+    ogs_tlv_ie_t ie;
     uint8_t *p = msg;
+    uint8_t *pos = data, *end = data + length, *next = NULL;
     uint32_t offset = 0;
     uint8_t index = 0;
-    int i = 0, j;
-    OGS_RBTREE(tree);
-    tlv_count_node_t count_node[OGS_TLV_MAX_CHILD_DESC];
-    unsigned count_node_alloc_next = 0;
+    uint8_t count[OGS_TLV_MAX_CHILD_DESC];
+    int i = 0;
     char indent[17] = "                "; /* 16 spaces */
 
     ogs_assert(msg);
     ogs_assert(parent_desc);
-    ogs_assert(parent_tlv);
+    ogs_assert(data);
 
     ogs_assert(depth <= 8);
     indent[depth*2] = 0;
 
-    tlv = parent_tlv;
-    while (tlv) {
-        tlv_count_node_t *curr_count = tlv_count_node_find(&tree, &count_node[0],
-                OGS_ARRAY_SIZE(count_node), &count_node_alloc_next, tlv->type, tlv->instance);
-        if (!curr_count)
+    memset(count, 0, sizeof(count));
+
+    while (pos < end) {
+        if (by_desc)
+            next = tlv_get_ie_by_desc(&ie, pos, end, mode, parent_desc);
+        else
+            next = tlv_get_ie(&ie, pos, end, mode, 0);
+        if (!next) {
+            ogs_error("Invalid TLV block [LEN:%d,MODE:%d,POS:%d]",
+                    length, mode, (int)(pos - data));
+            ogs_log_hexdump(OGS_LOG_ERROR, data, length);
             return OGS_ERROR;
-        desc = tlv_find_desc_by_type_inst(&index, &offset, parent_desc, tlv->type, tlv->instance, curr_count->count);
+        }
+        pos = next;
+
+        desc = tlv_find_child_desc(parent_desc, count, &ie, &index, &offset);
         if (desc == NULL) {
-            ogs_warn("Unknown TLV type [%d]", tlv->type);
-            tlv = tlv->next;
+            ogs_warn("Unknown TLV type [%d]", ie.type);
             continue;
         }
 
-        presence_p = (ogs_tlv_presence_t *)(p + offset);
-
         /* Multiple of the same type TLV may be included */
         next_desc = parent_desc->child_descs[index+1];
         if (next_desc != NULL && next_desc->ctype == OGS_TLV_MORE) {
-            for (j = 0; j < next_desc->length; j++) {
-                presence_p =
-                    (ogs_tlv_presence_t *)(p + offset + desc->vsize * j);
-                if (*presence_p == 0) {
-                    offset += desc->vsize * j;
-                    break;
-                }
-            }
-            if (j == next_desc->length) {
+            if (count[index] == next_desc->length) {
                 ogs_fatal("Multiple of the same type TLV need more room");
-                tlv = tlv->next;
                 continue;
             }
-        } else {
-            curr_count->count++;
+            offset += desc->vsize * count[index];
         }
+        count[index]++;
+
+        presence_p = (ogs_tlv_presence_t *)(p + offset);
 
         if (desc->ctype == OGS_TLV_COMPOUND) {
-            emb_tlv = ogs_tlv_parse_embedded_block(tlv, mode);
-            if (emb_tlv == NULL) {
+            if (ie.length == 0) {
                 ogs_error("Error while parse TLV");
                 return OGS_ERROR;
             }
@@ -707,10 +755,9 @@ static int tlv_parse_compound(void *msg, ogs_tlv_desc_t *parent_desc,
                     indent, i++, desc->name, desc->type, desc->instance,
                     desc->vsize, p + offset);
 
-            offset += sizeof(ogs_tlv_presence_t);
-
             rv = tlv_parse_compound(
-                    p + offset, desc, emb_tlv, depth + 1, mode);
+                    p + offset + sizeof(ogs_tlv_presence_t), desc,
+                    ie.value, ie.length, depth + 1, mode, false);
             if (rv != OGS_OK) {
                 ogs_error("Can't parse compound TLV");
                 return OGS_ERROR;
@@ -723,7 +770,7 @@ static int tlv_parse_compound(void *msg, ogs_tlv_desc_t *parent_desc,
                     indent, i++, desc->name, desc->type, desc->length,
                     desc->instance, desc->ctype, desc->vsize, p + offset);
 
-            rv = tlv_parse_leaf(p + offset, desc, tlv);
+            rv = tlv_parse_leaf(p + offset, desc, &ie);
             if (rv != OGS_OK) {
                 ogs_error("Can't parse leaf TLV");
                 return OGS_ERROR;
@@ -731,8 +778,6 @@ static int tlv_parse_compound(void *msg, ogs_tlv_desc_t *parent_desc,
 
             *presence_p = 1;
         }
-
-        tlv = tlv->next;
     }
 
     return OGS_OK;
@@ -741,9 +786,6 @@ static int tlv_parse_compound(void *msg, ogs_tlv_desc_t *parent_desc,
 int ogs_tlv_parse_msg(void *msg, ogs_tlv_desc_t *desc, ogs_pkbuf_t *pkbuf,
         int mode)
 {
-    int rv;
-    ogs_tlv_t *root;
-
     ogs_assert(msg);
     ogs_assert(desc);
     ogs_assert(pkbuf);
@@ -754,137 +796,121 @@ int ogs_tlv_parse_msg(void *msg, ogs_tlv_desc_t *desc, ogs_pkbuf_t *pkbuf,
         ogs_assert_if_reached();
     }
 
-    root = ogs_tlv_parse_block(pkbuf->len, pkbuf->data, mode);
-    if (root == NULL) {
+    if (pkbuf->len == 0) {
         ogs_error("Can't parse TLV message");
         return OGS_ERROR;
     }
 
-    rv = tlv_parse_compound(msg, desc, root, 0, mode);
-
-    ogs_tlv_free_all(root);
-
-    return rv;
+    return tlv_parse_compound(
+            msg, desc, pkbuf->data, pkbuf->len, 0, mode, false);
 }
 
-static uint16_t parse_get_element_type(uint8_t *pos, uint8_t mode)
+/* Similar to ogs_tlv_parse_msg(), but takes each TLV type from the desc
+ * defintion. This allows parsing messages which have different types of TLVs in
+ * it (for instance GTPv1-C). */
+int ogs_tlv_parse_msg_desc(
+        void *msg, ogs_tlv_desc_t *desc, ogs_pkbuf_t *pkbuf, int msg_mode)
 {
-    uint16_t type;
-
-    switch(mode) {
-    case OGS_TLV_MODE_T1_L1:
-    case OGS_TLV_MODE_T1_L2:
-    case OGS_TLV_MODE_T1_L2_I1:
-    case OGS_TLV_MODE_T1:
-        type = *pos;
-        break;
-    case OGS_TLV_MODE_T2_L2:
-        type = *(pos++) << 8;
-        type += *(pos++);
-        break;
-    default:
-        ogs_assert_if_reached();
-        break;
-    }
+    ogs_assert(msg);
+    ogs_assert(desc);
+    ogs_assert(pkbuf);
 
-    return type;
-}
+    ogs_assert(desc->ctype == OGS_TLV_MESSAGE);
+    ogs_assert(desc->child_descs[0]);
 
-/* Get TLV element taking into account msg_mode (to know TLV tag length) +
- * specific TLV information from "desc" (to know whether the specific IE is TLV
- * or TV, and its expected length in the later case). */
-static uint8_t *tlv_get_element_desc(ogs_tlv_t *tlv, uint8_t *blk, uint8_t msg_mode, ogs_tlv_desc_t *desc)
-{
-    uint8_t instance;
-    unsigned tlv_tag_pos;
-    uint8_t desc_index = 0;
-    uint32_t tlv_offset = 0;
-    uint16_t tlv_tag;
-    uint8_t tlv_mode;
-    static ogs_tlv_desc_t* tlv_desc;
-
-    tlv_tag = parse_get_element_type(blk, msg_mode);
-    instance = 0;  /* TODO: support instance != 0 if ever really needed by looking it up in pos */
-    tlv_tag_pos = 0; /* All tags with same instance should use the same tlv_desc, so take the first one */
-    tlv_desc = tlv_find_desc_by_type_inst(&desc_index, &tlv_offset, desc, tlv_tag, instance, tlv_tag_pos);
-    if (!tlv_desc) {
-        ogs_error("Can't parse find TLV description for type %u", tlv_tag);
-        return NULL;
+    if (pkbuf->len == 0) {
+        ogs_error("Can't parse TLV message");
+        return OGS_ERROR;
     }
-    tlv_mode = tlv_ctype2mode(tlv_desc->ctype, msg_mode);
 
-    if (tlv_mode == OGS_TLV_MODE_T1)
-        return tlv_get_element_fixed(tlv, blk, tlv_mode, tlv_desc->length);
-    return tlv_get_element(tlv, blk, tlv_mode);
+    return tlv_parse_compound(
+            msg, desc, pkbuf->data, pkbuf->len, 0, msg_mode, true);
 }
 
-/* Similar to ogs_tlv_parse_block(), but taking into account each TLV format from "desc". */
-static ogs_tlv_t *ogs_tlv_parse_block_desc(uint32_t length, void *data, uint8_t msg_mode, ogs_tlv_desc_t *desc)
+int ogs_tlv_index_msg(ogs_tlv_index_t *index, ogs_pkbuf_t *pkbuf, int mode)
 {
-    uint8_t *pos = data;
-    uint8_t *blk = data;
-
-    ogs_tlv_t *root = NULL;
-    ogs_tlv_t *prev = NULL;
-    ogs_tlv_t *curr = NULL;
+    uint8_t *pos = NULL, *end = NULL;
 
-    root = curr = ogs_tlv_get();
+    ogs_assert(index);
+    ogs_assert(pkbuf);
 
-    ogs_assert(curr);
+    index->mode = mode;
+    index->num_of_ie = 0;
 
-    pos = tlv_get_element_desc(curr, pos, msg_mode, desc);
+    pos = pkbuf->data;
+    end = pos + pkbuf->len;
 
-    ogs_assert(pos);
+    while (pos < end) {
+        if (index->num_of_ie == OGS_TLV_MAX_INDEX) {
+            ogs_error("Too many IEs [%d]", index->num_of_ie);
+            return OGS_ERROR;
+        }
 
-    while(pos - blk < length) {
-        prev = curr;
+        pos = tlv_get_ie(&index->ie[index->num_of_ie], pos, end, mode, 0);
+        if (!pos) {
+            ogs_error("Invalid TLV message [LEN:%d,MODE:%d]",
+                    pkbuf->len, mode);
+            return OGS_ERROR;
+        }
+        index->num_of_ie++;
+    }
 
-        curr = ogs_tlv_get();
-        ogs_assert(curr);
-        prev->next = curr;
+    return OGS_OK;
+}
 
-        pos = tlv_get_element_desc(curr, pos, msg_mode, desc);
-        ogs_assert(pos);
-    }
+ogs_tlv_ie_t *ogs_tlv_index_find(ogs_tlv_index_t *index,
+        uint16_t type, uint8_t instance, int n)
+{
+    int i;
 
-    if (length != (pos - blk)) {
-        ogs_error("ogs_tlv_parse_block() failed[LEN:%d,MODE:%d]",
-                length, msg_mode);
-        ogs_error("POS[%p] BLK[%p] POS-BLK[%d]", pos, blk, (int)(pos - blk));
-        ogs_log_hexdump(OGS_LOG_FATAL, data, length);
+    ogs_assert(index);
 
-        ogs_tlv_free_all(root);
-        return NULL;
+    for (i = 0; i < index->num_of_ie; i++) {
+        if (index->ie[i].type == type && index->ie[i].instance == instance) {
+            if (n == 0)
+                return &index->ie[i];
+            n--;
+        }
     }
 
-    return root;
+    return NULL;
 }
 
-/* Similar to ogs_tlv_parse_msg(), but takes each TLV type from the desc
- * defintion. This allows parsing messages which have different types of TLVs in
- * it (for instance GTPv1-C). */
-int ogs_tlv_parse_msg_desc(
-        void *msg, ogs_tlv_desc_t *desc, ogs_pkbuf_t *pkbuf, int msg_mode)
+int ogs_tlv_parse_ie(void *ie, ogs_tlv_desc_t *desc,
+        ogs_tlv_index_t *index, int n)
 {
     int rv;
-    ogs_tlv_t *root;
+    ogs_tlv_ie_t *found = NULL;
 
-    ogs_assert(msg);
+    ogs_assert(ie);
     ogs_assert(desc);
-    ogs_assert(pkbuf);
+    ogs_assert(index);
+    ogs_assert(desc->ctype != OGS_TLV_MESSAGE);
+    ogs_assert(desc->ctype != OGS_TLV_MORE);
 
-    ogs_assert(desc->ctype == OGS_TLV_MESSAGE);
-    ogs_assert(desc->child_descs[0]);
+    memset(ie, 0, desc->vsize);
 
-    root = ogs_tlv_parse_block_desc(pkbuf->len, pkbuf->data, msg_mode, desc);
-    if (root == NULL) {
-        ogs_error("Can't parse TLV message");
+    found = ogs_tlv_index_find(index, desc->type, desc->instance, n);
+    if (!found)
+        return OGS_NOTFOUND;
+
+    if (desc->ctype == OGS_TLV_COMPOUND) {
+        if (found->length == 0) {
+            ogs_error("Error while parse TLV");
+            return OGS_ERROR;
+        }
+        rv = tlv_parse_compound(
+                (uint8_t *)ie + sizeof(ogs_tlv_presence_t), desc,
+                found->value, found->length, 1, index->mode, false);
+    } else {
+        rv = tlv_parse_leaf(ie, desc, found);
+    }
+    if (rv != OGS_OK) {
+        ogs_error("Can't parse [%s]", desc->name);
         return OGS_ERROR;
     }
 
-    rv = tlv_parse_compound(msg, desc, root, 0, msg_mode);
+    *(ogs_tlv_presence_t *)ie = 1;
 
-    ogs_tlv_free_all(root);
-
-    return rv;
+    return OGS_OK;
 }
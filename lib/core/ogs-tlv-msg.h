@@ -30,11 +30,13 @@ extern "C" {
 #endif
 
 #define OGS_TLV_MAX_HEADROOM 16
+#define OGS_TLV_MAX_MSG_LEN 65535
 #define OGS_TLV_VARIABLE_LEN 0
 #define OGS_TLV_MAX_MORE 16
 #define OGS_TLV_1_OR_MORE(__v) __v[OGS_TLV_MAX_MORE]
 
 #define OGS_TLV_MAX_CHILD_DESC 128
+#define OGS_TLV_MAX_INDEX 256
 
 typedef enum {
     OGS_TLV_UINT8,
@@ -182,6 +184,38 @@ int ogs_tlv_parse_msg(
 int ogs_tlv_parse_msg_desc(
         void *msg, ogs_tlv_desc_t *desc, ogs_pkbuf_t *pkbuf, int msg_mode);
 
+/*
+ * Lazy decoding
+ *
+ * ogs_tlv_index_msg() walks the message once and records where each
+ * top-level IE is, without decoding anything. ogs_tlv_parse_ie() then
+ * decodes the n-th IE matching an IE desc (e.g. one Update FAR) into a
+ * structure of that IE's type, so a handler that needs a few IEs does
+ * not have to fill and clear the whole message structure.
+ *
+ * Only messages where every IE has a length field are supported
+ * (PFCP, GTPv2-C). Decoded octet strings point into the pkbuf, which
+ * must stay alive as long as they are used.
+ */
+typedef struct ogs_tlv_ie_s {
+    uint16_t type;
+    uint8_t instance;
+    uint32_t length;
+    uint8_t *value;
+} ogs_tlv_ie_t;
+
+typedef struct ogs_tlv_index_s {
+    int mode;
+    int num_of_ie;
+    ogs_tlv_ie_t ie[OGS_TLV_MAX_INDEX];
+} ogs_tlv_index_t;
+
+int ogs_tlv_index_msg(ogs_tlv_index_t *index, ogs_pkbuf_t *pkbuf, int mode);
+ogs_tlv_ie_t *ogs_tlv_index_find(ogs_tlv_index_t *index,
+        uint16_t type, uint8_t instance, int n);
+int ogs_tlv_parse_ie(void *ie, ogs_tlv_desc_t *desc,
+        ogs_tlv_index_t *index, int n);
+
 #ifdef __cplusplus
 }
 #endif
@@ -41,6 +41,7 @@
 #include "gtp/v1/path.h"
 #include "gtp/v2/path.h"
 #include "gtp/path.h"
+#include "gtp/ring.h"
 #include "gtp/xact.h"
 #include "gtp/util.h"
 
@@ -19,6 +19,20 @@
 
 #include "ogs-gtp.h"
 
+/* Each data plane thread owns its own batch */
+static OGS_THREAD_LOCAL struct {
+    bool active;
+
+    int num;
+    struct {
+        ogs_socket_t fd;
+        ogs_sockaddr_t addr;
+        ogs_pkbuf_t *pkbuf;
+    } entry[OGS_MAX_NUM_OF_SOCKMSG];
+
+    ogs_gtp_batch_stat_t stat;
+} tx_batch;
+
 ogs_sock_t *ogs_gtp_server(ogs_socknode_t *node)
 {
     char buf[OGS_ADDRSTRLEN];
@@ -129,6 +143,98 @@ int ogs_gtp_sendto(ogs_gtp_node_t *gnode, ogs_pkbuf_t *pkbuf)
     return OGS_OK;
 }
 
+void ogs_gtp_tx_batch_begin(void)
+{
+    ogs_assert(tx_batch.active == false);
+    ogs_assert(tx_batch.num == 0);
+
+    memset(&tx_batch.stat, 0, sizeof(tx_batch.stat));
+    tx_batch.active = true;
+}
+
+bool ogs_gtp_tx_batch_is_active(void)
+{
+    return tx_batch.active;
+}
+
+static void tx_batch_send(void)
+{
+    ogs_sockmsg_t msg[OGS_MAX_NUM_OF_SOCKMSG];
+    bool done[OGS_MAX_NUM_OF_SOCKMSG];
+    int i, j, n, sent;
+
+    memset(done, 0, sizeof(done));
+
+    /* Group the queued packets by socket, keeping the order per socket */
+    for (i = 0; i < tx_batch.num; i++) {
+        ogs_socket_t fd;
+
+        if (done[i])
+            continue;
+
+        fd = tx_batch.entry[i].fd;
+
+        n = 0;
+        for (j = i; j < tx_batch.num; j++) {
+            if (done[j] || tx_batch.entry[j].fd != fd)
+                continue;
+
+            msg[n].buf = tx_batch.entry[j].pkbuf->data;
+            msg[n].len = tx_batch.entry[j].pkbuf->len;
+            msg[n].addr = &tx_batch.entry[j].addr;
+            n++;
+
+            done[j] = true;
+        }
+
+        sent = ogs_sendmmsg(fd, msg, n, 0);
+        if (sent != n) {
+            if (ogs_socket_errno != OGS_EAGAIN) {
+                ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
+                        "ogs_sendmmsg(%u, %d) failed [%d sent]", fd, n, sent);
+            }
+        }
+
+        tx_batch.stat.syscalls++;
+        tx_batch.stat.packets += sent;
+    }
+
+    for (i = 0; i < tx_batch.num; i++)
+        ogs_pkbuf_free(tx_batch.entry[i].pkbuf);
+
+    tx_batch.num = 0;
+}
+
+void ogs_gtp_tx_batch_add(ogs_gtp_node_t *gnode, ogs_pkbuf_t *pkbuf)
+{
+    ogs_assert(tx_batch.active == true);
+    ogs_assert(gnode);
+    ogs_assert(gnode->sock);
+    ogs_assert(pkbuf);
+
+    if (tx_batch.num == OGS_MAX_NUM_OF_SOCKMSG)
+        tx_batch_send();
+
+    tx_batch.entry[tx_batch.num].fd = gnode->sock->fd;
+    memcpy(&tx_batch.entry[tx_batch.num].addr,
+            &gnode->addr, sizeof(gnode->addr));
+    tx_batch.entry[tx_batch.num].pkbuf = pkbuf;
+    tx_batch.num++;
+}
+
+void ogs_gtp_tx_batch_flush(ogs_gtp_batch_stat_t *stat)
+{
+    ogs_assert(tx_batch.active == true);
+
+    if (tx_batch.num)
+        tx_batch_send();
+
+    if (stat)
+        memcpy(stat, &tx_batch.stat, sizeof(*stat));
+
+    tx_batch.active = false;
+}
+
 void ogs_gtp_send_error_message(
         ogs_gtp_xact_t *xact, uint32_t teid, uint8_t type, uint8_t cause_value)
 {
@@ -62,12 +62,30 @@ extern "C" {
                 &ogs_gtp_self()->gtpu_ip); \
     } while(0)
 
+typedef struct ogs_gtp_batch_stat_s {
+    int syscalls;
+    int packets;
+} ogs_gtp_batch_stat_t;
+
 ogs_sock_t *ogs_gtp_server(ogs_socknode_t *node);
 int ogs_gtp_connect(ogs_sock_t *ipv4, ogs_sock_t *ipv6, ogs_gtp_node_t *gnode);
 
 int ogs_gtp_send(ogs_gtp_node_t *gnode, ogs_pkbuf_t *pkbuf);
 int ogs_gtp_sendto(ogs_gtp_node_t *gnode, ogs_pkbuf_t *pkbuf);
 
+/*
+ * G-PDU transmit batching
+ *
+ * Between ogs_gtp_tx_batch_begin() and ogs_gtp_tx_batch_flush(),
+ * ogs_gtp2_send_user_plane() queues packets instead of sending them.
+ * ogs_gtp_tx_batch_flush() sends the queue with one sendmmsg()
+ * per socket and frees the queued packets.
+ */
+void ogs_gtp_tx_batch_begin(void);
+bool ogs_gtp_tx_batch_is_active(void);
+void ogs_gtp_tx_batch_add(ogs_gtp_node_t *gnode, ogs_pkbuf_t *pkbuf);
+void ogs_gtp_tx_batch_flush(ogs_gtp_batch_stat_t *stat);
+
 void ogs_gtp_send_error_message(
         ogs_gtp_xact_t *xact, uint32_t teid, uint8_t type, uint8_t cause_value);
 
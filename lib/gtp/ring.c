@@ -0,0 +1,513 @@
+/*
+ * Copyright (C) 2019-2023 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ogs-gtp.h"
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <net/if.h>
+#include <sys/mman.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <linux/filter.h>
+
+/* 16 blocks of 256KB, each filled with as many packets as fit */
+#define RING_BLOCK_SIZE         (1 << 18)
+#define RING_BLOCK_NR           16
+#define RING_FRAME_SIZE         2048
+/* Hand over a partially filled block after 1 ms */
+#define RING_BLOCK_TIMEOUT      1
+
+/* Room in front of the IP header to push a new GTP-U/Ethernet header */
+#define RING_HEADROOM           64
+
+struct ogs_gtp_ring_s {
+    ogs_socket_t fd;
+    int family;
+
+    uint8_t *map;
+    size_t map_len;
+
+    unsigned int block;         /* Block being read */
+    unsigned int num_of_pkt;    /* Packets left in the block */
+    struct tpacket3_hdr *pkt;   /* Next packet in the block */
+
+    unsigned int release;       /* First block not yet given back */
+    unsigned int num_of_release;
+};
+
+static struct tpacket_block_desc *block_desc(
+        ogs_gtp_ring_t *ring, unsigned int block)
+{
+    return (struct tpacket_block_desc *)
+        (ring->map + (size_t)block * RING_BLOCK_SIZE);
+}
+
+static int attach_filter(ogs_socket_t fd, struct sock_filter *code, int len)
+{
+    struct sock_fprog prog = {
+        .len = len,
+        .filter = code,
+    };
+
+    if (setsockopt(fd, SOL_SOCKET, SO_ATTACH_FILTER,
+                &prog, sizeof(prog)) != 0) {
+        ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
+                "setsockopt(SO_ATTACH_FILTER) failed");
+        return OGS_ERROR;
+    }
+
+    return OGS_OK;
+}
+
+/*
+ * Accept unfragmented UDP to the GTP-U socket address.
+ * The program sees the packet from the IP header.
+ */
+static int attach_gtpu_filter(ogs_gtp_ring_t *ring, ogs_sockaddr_t *addr)
+{
+    uint16_t port = OGS_PORT(addr);
+    struct sock_filter nop = BPF_JUMP(BPF_JMP | BPF_JA, 0, 0, 0);
+
+    if (addr->ogs_sa_family == AF_INET) {
+        uint32_t ip = be32toh(addr->sin.sin_addr.s_addr);
+        struct sock_filter code[] = {
+            BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 9),
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, IPPROTO_UDP, 0, 8),
+            BPF_STMT(BPF_LD | BPF_H | BPF_ABS, 6),
+            BPF_JUMP(BPF_JMP | BPF_JSET | BPF_K, 0x3fff, 6, 0),
+            BPF_STMT(BPF_LDX | BPF_B | BPF_MSH, 0),
+            BPF_STMT(BPF_LD | BPF_H | BPF_IND, 2),
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, port, 0, 3),
+            BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 16),
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, ip, 0, 1),
+            BPF_STMT(BPF_RET | BPF_K, 0xffffffff),
+            BPF_STMT(BPF_RET | BPF_K, 0),
+        };
+
+        /* Bound to INADDR_ANY */
+        if (ip == INADDR_ANY)
+            code[7] = code[8] = nop;
+
+        return attach_filter(ring->fd, code, OGS_ARRAY_SIZE(code));
+    } else {
+        uint32_t ip[4];
+        struct sock_filter code[] = {
+            BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 6),
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, IPPROTO_UDP, 0, 11),
+            BPF_STMT(BPF_LD | BPF_H | BPF_ABS, 42),
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, port, 0, 9),
+            BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 24),
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0, 0, 7),
+            BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 28),
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0, 0, 5),
+            BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 32),
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0, 0, 3),
+            BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 36),
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0, 0, 1),
+            BPF_STMT(BPF_RET | BPF_K, 0xffffffff),
+            BPF_STMT(BPF_RET | BPF_K, 0),
+        };
+        int i;
+
+        memcpy(ip, addr->sin6.sin6_addr.s6_addr, sizeof(ip));
+        for (i = 0; i < 4; i++)
+            code[5 + i * 2].k = be32toh(ip[i]);
+
+        /* Bound to in6addr_any */
+        if (!ip[0] && !ip[1] && !ip[2] && !ip[3]) {
+            for (i = 4; i < 12; i++)
+                code[i] = nop;
+        }
+
+        return attach_filter(ring->fd, code, OGS_ARRAY_SIZE(code));
+    }
+}
+
+/*
+ * All G-PDUs from one peer share the same UDP 4-tuple, so the fanout
+ * program selects the ring by TEID rather than by flow.
+ */
+static int join_fanout(ogs_gtp_ring_t *ring, ogs_sockaddr_t *addr)
+{
+#if defined(PACKET_FANOUT_CBPF)
+    struct sock_filter code4[] = {
+        BPF_STMT(BPF_LDX | BPF_B | BPF_MSH, 0),
+        BPF_STMT(BPF_LD | BPF_W | BPF_IND, 12),     /* A = TEID */
+        BPF_STMT(BPF_RET | BPF_A, 0),
+    };
+    struct sock_filter code6[] = {
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 52),     /* A = TEID */
+        BPF_STMT(BPF_RET | BPF_A, 0),
+    };
+    struct sock_fprog prog;
+    int klen = ogs_sockaddr_len(addr);
+    uint16_t id;
+    int fanout;
+
+    /* The same group for every ring of this process and address */
+    id = ogs_hashfunc_default((const char *)addr, &klen) ^ getpid();
+    fanout = id | (PACKET_FANOUT_CBPF << 16);
+
+    if (setsockopt(ring->fd, SOL_PACKET, PACKET_FANOUT,
+                &fanout, sizeof(fanout)) != 0) {
+        ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
+                "setsockopt(PACKET_FANOUT) failed");
+        return OGS_ERROR;
+    }
+
+    if (addr->ogs_sa_family == AF_INET) {
+        prog.len = OGS_ARRAY_SIZE(code4);
+        prog.filter = code4;
+    } else {
+        prog.len = OGS_ARRAY_SIZE(code6);
+        prog.filter = code6;
+    }
+
+    if (setsockopt(ring->fd, SOL_PACKET, PACKET_FANOUT_DATA,
+                &prog, sizeof(prog)) != 0) {
+        ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
+                "setsockopt(PACKET_FANOUT_DATA) failed");
+        return OGS_ERROR;
+    }
+
+    return OGS_OK;
+#else
+    ogs_error("PACKET_FANOUT_CBPF is not supported");
+    return OGS_ERROR;
+#endif
+}
+
+static int ring_open(ogs_gtp_ring_t *ring,
+        ogs_sockaddr_t *addr, const char *ifname, int num_of_ring)
+{
+    struct tpacket_req3 req;
+    struct sockaddr_ll sll;
+    int version = TPACKET_V3;
+    int reserve = RING_HEADROOM;
+    unsigned int ifindex = 0;
+
+    if (ifname) {
+        ifindex = if_nametoindex(ifname);
+        if (!ifindex) {
+            ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
+                    "if_nametoindex(%s) failed", ifname);
+            return OGS_ERROR;
+        }
+    }
+
+    /* No packets until bind() */
+    ring->fd = socket(AF_PACKET, SOCK_DGRAM, 0);
+    if (ring->fd == INVALID_SOCKET) {
+        ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
+                "socket(AF_PACKET) failed");
+        return OGS_ERROR;
+    }
+    ogs_closeonexec(ring->fd);
+
+    if (setsockopt(ring->fd, SOL_PACKET, PACKET_VERSION,
+                &version, sizeof(version)) != 0 ||
+        setsockopt(ring->fd, SOL_PACKET, PACKET_RESERVE,
+                &reserve, sizeof(reserve)) != 0) {
+        ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
+                "setsockopt(PACKET_VERSION) failed");
+        return OGS_ERROR;
+    }
+
+    if (attach_gtpu_filter(ring, addr) != OGS_OK)
+        return OGS_ERROR;
+
+    memset(&req, 0, sizeof(req));
+    req.tp_block_size = RING_BLOCK_SIZE;
+    req.tp_block_nr = RING_BLOCK_NR;
+    req.tp_frame_size = RING_FRAME_SIZE;
+    req.tp_frame_nr = (RING_BLOCK_SIZE / RING_FRAME_SIZE) * RING_BLOCK_NR;
+    req.tp_retire_blk_tov = RING_BLOCK_TIMEOUT;
+
+    if (setsockopt(ring->fd, SOL_PACKET, PACKET_RX_RING,
+                &req, sizeof(req)) != 0) {
+        ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
+                "setsockopt(PACKET_RX_RING) failed");
+        return OGS_ERROR;
+    }
+
+    ring->map_len = (size_t)RING_BLOCK_SIZE * RING_BLOCK_NR;
+    ring->map = mmap(NULL, ring->map_len, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_LOCKED, ring->fd, 0);
+    if (ring->map == MAP_FAILED) {
+        /* MAP_LOCKED may exceed RLIMIT_MEMLOCK */
+        ring->map = mmap(NULL, ring->map_len, PROT_READ | PROT_WRITE,
+                MAP_SHARED, ring->fd, 0);
+        if (ring->map == MAP_FAILED) {
+            ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
+                    "mmap(%zu) failed", ring->map_len);
+            ring->map = NULL;
+            return OGS_ERROR;
+        }
+    }
+
+    memset(&sll, 0, sizeof(sll));
+    sll.sll_family = AF_PACKET;
+    sll.sll_protocol = htobe16(
+            addr->ogs_sa_family == AF_INET ? ETH_P_IP : ETH_P_IPV6);
+    /* 0 receives from every interface */
+    sll.sll_ifindex = ifindex;
+
+    if (bind(ring->fd, (struct sockaddr *)&sll, sizeof(sll)) != 0) {
+        ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
+                "bind(AF_PACKET) failed");
+        return OGS_ERROR;
+    }
+
+#if defined(PACKET_IGNORE_OUTGOING)
+    {
+        int on = 1;
+        /* Not fatal, outgoing packets are skipped in ogs_gtp_ring_recv() */
+        setsockopt(ring->fd, SOL_PACKET, PACKET_IGNORE_OUTGOING,
+                &on, sizeof(on));
+    }
+#endif
+
+    if (num_of_ring > 1 && join_fanout(ring, addr) != OGS_OK)
+        return OGS_ERROR;
+
+    return OGS_OK;
+}
+
+ogs_gtp_ring_t *ogs_gtp_ring_create(ogs_sock_t *sock,
+        int type, const char *ifname, int num_of_ring)
+{
+    ogs_gtp_ring_t *ring = NULL;
+    struct sock_filter drop[] = {
+        BPF_STMT(BPF_RET | BPF_K, 0),
+    };
+    char buf[OGS_ADDRSTRLEN];
+
+    ogs_assert(sock);
+    ogs_assert(type == OGS_PACKET_RING_TPACKET);
+
+    ring = ogs_calloc(1, sizeof(*ring));
+    ogs_assert(ring);
+
+    ring->fd = INVALID_SOCKET;
+    ring->family = sock->family;
+
+    if (ring_open(ring, &sock->local_addr, ifname, num_of_ring) != OGS_OK)
+        goto fallback;
+
+    /* From now on, G-PDUs are received only from the ring */
+    if (attach_filter(sock->fd, drop, OGS_ARRAY_SIZE(drop)) != OGS_OK)
+        goto fallback;
+
+    ogs_info("gtp_ring() [%s]:%d dev:%s",
+            OGS_ADDR(&sock->local_addr, buf), OGS_PORT(&sock->local_addr),
+            ifname ? ifname : "any");
+
+    return ring;
+
+fallback:
+    ogs_warn("TPACKET_V3 ring is not available, use the socket [%s]:%d",
+            OGS_ADDR(&sock->local_addr, buf), OGS_PORT(&sock->local_addr));
+    ogs_gtp_ring_destroy(ring);
+
+    return NULL;
+}
+
+void ogs_gtp_ring_destroy(ogs_gtp_ring_t *ring)
+{
+    ogs_assert(ring);
+
+    if (ring->map)
+        munmap(ring->map, ring->map_len);
+    if (ring->fd != INVALID_SOCKET)
+        ogs_closesocket(ring->fd);
+
+    ogs_free(ring);
+}
+
+ogs_socket_t ogs_gtp_ring_fd(ogs_gtp_ring_t *ring)
+{
+    ogs_assert(ring);
+    return ring->fd;
+}
+
+/* Returns the UDP payload, or NULL if the packet is to be skipped */
+static uint8_t *parse_packet(ogs_gtp_ring_t *ring,
+        struct tpacket3_hdr *pkt, ogs_sockaddr_t *from, unsigned int *len)
+{
+    struct sockaddr_ll *sll = NULL;
+    uint8_t *ip = NULL, *udp = NULL;
+    unsigned int caplen, iphlen, udplen;
+
+    sll = (struct sockaddr_ll *)
+        ((uint8_t *)pkt + TPACKET_ALIGN(sizeof(struct tpacket3_hdr)));
+    if (sll->sll_pkttype == PACKET_OUTGOING)
+        return NULL;
+
+    ip = (uint8_t *)pkt + pkt->tp_net;
+    caplen = pkt->tp_snaplen - (pkt->tp_net - pkt->tp_mac);
+
+    memset(from, 0, sizeof(*from));
+    if (ring->family == AF_INET) {
+        if (caplen < 20)
+            return NULL;
+        iphlen = (ip[0] & 0x0f) << 2;
+
+        from->ogs_sa_family = AF_INET;
+        memcpy(&from->sin.sin_addr, ip + 12, 4);
+    } else {
+        iphlen = 40;
+
+        from->ogs_sa_family = AF_INET6;
+        memcpy(&from->sin6.sin6_addr, ip + 8, 16);
+    }
+
+    if (caplen < iphlen + 8)
+        return NULL;
+
+    udp = ip + iphlen;
+    memcpy(&from->sin.sin_port, udp, 2);
+
+    udplen = (udp[4] << 8) | udp[5];
+    if (udplen < 8 || udplen > caplen - iphlen)
+        return NULL;
+
+    *len = udplen - 8;
+    return udp + 8;
+}
+
+int ogs_gtp_ring_recv(ogs_gtp_ring_t *ring, ogs_pkbuf_pool_t *pool,
+        ogs_pkbuf_t **pkbuf, ogs_sockaddr_t *from, int max)
+{
+    int n = 0;
+
+    ogs_assert(ring);
+    ogs_assert(pkbuf);
+    ogs_assert(from);
+
+    while (n < max) {
+        struct tpacket3_hdr *pkt = NULL;
+        uint8_t *payload = NULL;
+        unsigned int len = 0;
+
+        if (!ring->pkt) {
+            struct tpacket_block_desc *desc = block_desc(ring, ring->block);
+
+            /* Every block was handed out and none given back yet */
+            if (ring->num_of_release == RING_BLOCK_NR)
+                break;
+            if (!(desc->hdr.bh1.block_status & TP_STATUS_USER))
+                break;
+            __sync_synchronize();
+
+            ring->num_of_pkt = desc->hdr.bh1.num_pkts;
+            ring->pkt = (struct tpacket3_hdr *)
+                ((uint8_t *)desc + desc->hdr.bh1.offset_to_first_pkt);
+        }
+
+        if (ring->num_of_pkt) {
+            pkt = ring->pkt;
+            ring->pkt = (struct tpacket3_hdr *)
+                ((uint8_t *)pkt + pkt->tp_next_offset);
+            ring->num_of_pkt--;
+
+            payload = parse_packet(ring, pkt, &from[n], &len);
+        }
+
+        if (!ring->num_of_pkt) {
+            /* The block goes back to the kernel in ogs_gtp_ring_release() */
+            ring->pkt = NULL;
+            ring->block = (ring->block + 1) % RING_BLOCK_NR;
+            ring->num_of_release++;
+        }
+
+        if (!payload)
+            continue;
+
+        /* The pkbuf borrows the ring frame */
+        pkbuf[n] = ogs_pkbuf_alloc(pool, 0);
+        ogs_assert(pkbuf[n]);
+        pkbuf[n]->head = (uint8_t *)pkt + TPACKET3_HDRLEN;
+        pkbuf[n]->data = payload;
+        pkbuf[n]->tail = payload + len;
+        pkbuf[n]->end = pkbuf[n]->tail;
+        pkbuf[n]->len = len;
+
+        n++;
+    }
+
+    return n;
+}
+
+void ogs_gtp_ring_release(ogs_gtp_ring_t *ring)
+{
+    ogs_assert(ring);
+
+    if (!ring->num_of_release)
+        return;
+
+    __sync_synchronize();
+    while (ring->num_of_release) {
+        block_desc(ring, ring->release)->hdr.bh1.block_status =
+            TP_STATUS_KERNEL;
+
+        ring->release = (ring->release + 1) % RING_BLOCK_NR;
+        ring->num_of_release--;
+    }
+}
+
+#else /* !defined(__linux__) */
+
+ogs_gtp_ring_t *ogs_gtp_ring_create(ogs_sock_t *sock,
+        int type, const char *ifname, int num_of_ring)
+{
+    char buf[OGS_ADDRSTRLEN];
+
+    ogs_assert(sock);
+
+    ogs_warn("Packet ring is not supported, use the socket [%s]:%d",
+            OGS_ADDR(&sock->local_addr, buf), OGS_PORT(&sock->local_addr));
+
+    return NULL;
+}
+
+void ogs_gtp_ring_destroy(ogs_gtp_ring_t *ring)
+{
+    ogs_assert_if_reached();
+}
+
+ogs_socket_t ogs_gtp_ring_fd(ogs_gtp_ring_t *ring)
+{
+    ogs_assert_if_reached();
+    return INVALID_SOCKET;
+}
+
+int ogs_gtp_ring_recv(ogs_gtp_ring_t *ring, ogs_pkbuf_pool_t *pool,
+        ogs_pkbuf_t **pkbuf, ogs_sockaddr_t *from, int max)
+{
+    ogs_assert_if_reached();
+    return 0;
+}
+
+void ogs_gtp_ring_release(ogs_gtp_ring_t *ring)
+{
+    ogs_assert_if_reached();
+}
+
+#endif
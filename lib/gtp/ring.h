@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2019-2023 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined(OGS_GTP_INSIDE) && !defined(OGS_GTP_COMPILATION)
+#error "This header cannot be included directly."
+#endif
+
+#ifndef OGS_GTP_RING_H
+#define OGS_GTP_RING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * GTP-U receive ring
+ *
+ * G-PDUs for a GTP-U socket are received from a memory-mapped
+ * AF_PACKET TPACKET_V3 ring instead of the socket itself. The kernel
+ * fills whole blocks of packets, so there is no system call per packet,
+ * and the received pkbufs point straight into the ring.
+ *
+ * The socket stays open for transmission, but a filter drops
+ * everything it would receive. IP fragments are not delivered.
+ *
+ * A pkbuf from ogs_gtp_ring_recv() is valid until the next
+ * ogs_gtp_ring_release(). Anything kept longer must be copied.
+ *
+ * With several rings for the same socket address (one per thread),
+ * the kernel distributes G-PDUs among them by TEID.
+ */
+typedef struct ogs_gtp_ring_s ogs_gtp_ring_t;
+
+ogs_gtp_ring_t *ogs_gtp_ring_create(ogs_sock_t *sock,
+        int type, const char *ifname, int num_of_ring);
+void ogs_gtp_ring_destroy(ogs_gtp_ring_t *ring);
+
+ogs_socket_t ogs_gtp_ring_fd(ogs_gtp_ring_t *ring);
+
+int ogs_gtp_ring_recv(ogs_gtp_ring_t *ring, ogs_pkbuf_pool_t *pool,
+        ogs_pkbuf_t **pkbuf, ogs_sockaddr_t *from, int max);
+void ogs_gtp_ring_release(ogs_gtp_ring_t *ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OGS_GTP_RING_H */
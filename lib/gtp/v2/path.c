@@ -71,6 +71,12 @@ int ogs_gtp2_send_user_plane(
             header_desc->type,
             OGS_ADDR(&gnode->addr, buf), header_desc->teid);
 
+    if (ogs_gtp_tx_batch_is_active() == true) {
+        /* The batch owns pkbuf and frees it on flush */
+        ogs_gtp_tx_batch_add(gnode, pkbuf);
+        return OGS_OK;
+    }
+
     rv = ogs_gtp_sendto(gnode, pkbuf);
     if (rv != OGS_OK) {
         if (ogs_socket_errno != OGS_EAGAIN) {
@@ -36,11 +36,19 @@ typedef enum ogs_metrics_metric_type_s  {
     OGS_METRICS_METRIC_TYPE_HISTOGRAM,
 } ogs_metrics_metric_type_t;
 
+/*
+ * Called right before the metrics are exported, so that an NF can fold
+ * counters it keeps on its own (e.g. per data plane thread) into them.
+ */
+typedef void (*ogs_metrics_collect_f)(void);
+
 typedef struct ogs_metrics_context_s {
     ogs_list_t  server_list;
     ogs_list_t  spec_list;
 
     uint16_t    metrics_port;
+
+    ogs_metrics_collect_f collect;
 } ogs_metrics_context_t;
 
 typedef enum ogs_metrics_histogram_bucket_type_s  {
@@ -207,6 +207,8 @@ static _MHD_Result mhd_server_access_handler(void *cls, struct MHD_Connection *c
         return ret;
     }
     if (strcmp(url, "/metrics") == 0) {
+        if (ogs_metrics_self()->collect)
+            ogs_metrics_self()->collect();
         buf = prom_collector_registry_bridge(PROM_COLLECTOR_REGISTRY_DEFAULT);
         rsp = MHD_create_response_from_buffer(strlen(buf), (void *)buf, MHD_RESPMEM_MUST_FREE);
         ret = MHD_queue_response(connection, MHD_HTTP_OK, rsp);
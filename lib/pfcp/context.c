@@ -1061,6 +1061,7 @@ void ogs_pfcp_sess_clear(ogs_pfcp_sess_t *sess)
     ogs_pfcp_urr_remove_all(sess);
     ogs_pfcp_qer_remove_all(sess);
     if (sess->bar) ogs_pfcp_bar_delete(sess->bar);
+    ogs_pfcp_sess_classifier_free(sess);
 }
 
 static int precedence_compare(ogs_pfcp_pdr_t *pdr1, ogs_pfcp_pdr_t *pdr2)
@@ -1108,6 +1109,7 @@ ogs_pfcp_pdr_t *ogs_pfcp_pdr_add(ogs_pfcp_sess_t *sess)
 
     pdr->sess = sess;
     ogs_list_add(&sess->pdr_list, pdr);
+    ogs_pfcp_sess_classifier_invalidate(sess);
 
     return pdr;
 }
@@ -1172,6 +1174,10 @@ void ogs_pfcp_object_teid_hash_set(
 {
     ogs_assert(type);
     ogs_assert(pdr);
+    ogs_assert(pdr->sess);
+
+    /* F-TEID may be chosen here */
+    ogs_pfcp_sess_classifier_invalidate(pdr->sess);
 
     if (ogs_pfcp_self()->up_function_features.ftup && pdr->f_teid.ch) {
 
@@ -1294,6 +1300,7 @@ void ogs_pfcp_pdr_reorder_by_precedence(
 
     pdr->precedence = precedence;
     ogs_list_insert_sorted(&sess->pdr_list, pdr, precedence_compare);
+    ogs_pfcp_sess_classifier_invalidate(sess);
 }
 
 void ogs_pfcp_pdr_associate_far(ogs_pfcp_pdr_t *pdr, ogs_pfcp_far_t *far)
@@ -1334,6 +1341,7 @@ void ogs_pfcp_pdr_remove(ogs_pfcp_pdr_t *pdr)
     ogs_assert(pdr->sess);
 
     ogs_list_remove(&pdr->sess->pdr_list, pdr);
+    ogs_pfcp_sess_classifier_invalidate(pdr->sess);
 
     ogs_pfcp_rule_remove_all(pdr);
 
@@ -1824,6 +1832,14 @@ void ogs_pfcp_qer_remove(ogs_pfcp_qer_t *qer)
 
     ogs_list_remove(&sess->qer_list, qer);
 
+    if (qer->bucket.uplink.dropped_pkts || qer->bucket.downlink.dropped_pkts)
+        ogs_debug("QER[%d] dropped UL %llu/%llu DL %llu/%llu pkts/octets",
+                qer->id,
+                (unsigned long long)qer->bucket.uplink.dropped_pkts,
+                (unsigned long long)qer->bucket.uplink.dropped_octets,
+                (unsigned long long)qer->bucket.downlink.dropped_pkts,
+                (unsigned long long)qer->bucket.downlink.dropped_octets);
+
     if (qer->id_node)
         ogs_pool_free(&qer->sess->qer_id_pool, qer->id_node);
 
@@ -1892,6 +1908,7 @@ ogs_pfcp_rule_t *ogs_pfcp_rule_add(ogs_pfcp_pdr_t *pdr)
 
     rule->pdr = pdr;
     ogs_list_add(&pdr->rule_list, rule);
+    ogs_pfcp_sess_classifier_invalidate(pdr->sess);
 
     return rule;
 }
@@ -1924,6 +1941,7 @@ void ogs_pfcp_rule_remove(ogs_pfcp_rule_t *rule)
 
     ogs_list_remove(&pdr->rule_list, rule);
     ogs_pool_free(&ogs_pfcp_rule_pool, rule);
+    ogs_pfcp_sess_classifier_invalidate(pdr->sess);
 }
 
 void ogs_pfcp_rule_remove_all(ogs_pfcp_pdr_t *pdr)
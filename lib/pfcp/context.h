@@ -284,6 +284,20 @@ typedef struct ogs_pfcp_urr_s {
     ogs_pfcp_sess_t         *sess;
 } ogs_pfcp_urr_t;
 
+/*
+ * MBR policing state of one direction.
+ * Tokens are refilled lazily from the elapsed time when a packet arrives,
+ * so an idle bucket costs nothing.
+ */
+typedef struct ogs_pfcp_qer_bucket_s {
+    uint64_t                tokens;         /* Octets */
+    ogs_time_t              last;           /* 0 : refill to the burst size */
+
+    /* Dropped by the gate or MBR */
+    uint64_t                dropped_pkts;
+    uint64_t                dropped_octets;
+} ogs_pfcp_qer_bucket_t;
+
 typedef struct ogs_pfcp_qer_s {
     ogs_lnode_t             lnode;
 
@@ -296,6 +310,11 @@ typedef struct ogs_pfcp_qer_s {
 
     uint8_t                 qfi;
 
+    struct {
+        ogs_pfcp_qer_bucket_t uplink;
+        ogs_pfcp_qer_bucket_t downlink;
+    } bucket;
+
     ogs_pfcp_sess_t         *sess;
 } ogs_pfcp_qer_t;
 
@@ -308,6 +327,22 @@ typedef struct ogs_pfcp_bar_s {
     ogs_pfcp_sess_t         *sess;
 } ogs_pfcp_bar_t;
 
+/* PDR classifier of a session, see rule-match.h */
+typedef struct ogs_pfcp_classifier_entry_s ogs_pfcp_classifier_entry_t;
+typedef struct ogs_pfcp_classifier_tuple_s ogs_pfcp_classifier_tuple_t;
+typedef struct ogs_pfcp_classifier_s {
+    bool compiled;          /* false : match by walking pdr_list */
+
+    int num_of_entry, max_entry;
+    ogs_pfcp_classifier_entry_t *entry;
+    int num_of_tuple, max_tuple;
+    ogs_pfcp_classifier_tuple_t *tuple;
+    int num_of_any, max_any;
+    int *any;               /* Entries of PDRs without SDF filter */
+    int bucket_mask, max_bucket;
+    int *bucket;            /* Hash of entries, -1 : empty */
+} ogs_pfcp_classifier_t;
+
 typedef struct ogs_pfcp_sess_s {
     ogs_pfcp_object_t   obj;
 
@@ -317,6 +352,8 @@ typedef struct ogs_pfcp_sess_s {
     ogs_list_t          qer_list;       /* QER List */
     ogs_pfcp_bar_t      *bar;           /* BAR Item */
 
+    ogs_pfcp_classifier_t classifier;   /* SDF filters of all PDRs */
+
     OGS_POOL(pdr_id_pool, uint8_t);
     OGS_POOL(far_id_pool, uint8_t);
     OGS_POOL(urr_id_pool, uint8_t);
@@ -341,6 +378,7 @@ typedef struct ogs_pfcp_dev_s {
 
     ogs_poll_t      *poll;
     bool            is_tap;
+    bool            offload;        /* IFF_VNET_HDR, see ogs-tun.h */
     uint8_t         mac_addr[6];
 } ogs_pfcp_dev_t;
 
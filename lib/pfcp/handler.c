@@ -244,11 +244,11 @@ bool ogs_pfcp_up_handle_pdr(
 
     memset(report, 0, sizeof(*report));
 
-    sendbuf = ogs_pkbuf_copy(recvbuf);
-    if (!sendbuf) {
-        ogs_error("ogs_pkbuf_copy() failed");
-        return false;
-    }
+    /*
+     * The receive buffer is forwarded as it is.
+     * The GTP-U header is pushed into its headroom.
+     */
+    sendbuf = recvbuf;
 
     buffering = false;
 
@@ -298,6 +298,17 @@ bool ogs_pfcp_up_handle_pdr(
         }
 
         if (far->num_of_buffered_packet < OGS_MAX_NUM_OF_PACKET_BUFFER) {
+            /*
+             * Buffered packets may be kept until paging completes.
+             * Copy them out so that they do not pin the receive pool.
+             */
+            sendbuf = ogs_pkbuf_copy(recvbuf);
+            ogs_pkbuf_free(recvbuf);
+            if (!sendbuf) {
+                ogs_error("ogs_pkbuf_copy() failed");
+                return false;
+            }
+
             far->buffered_packet[far->num_of_buffered_packet++] = sendbuf;
         } else {
             ogs_pkbuf_free(sendbuf);
@@ -307,6 +318,82 @@ bool ogs_pfcp_up_handle_pdr(
     return true;
 }
 
+/*
+ * A bucket holds at most 100ms worth of MBR,
+ * but never less than one maximum sized packet.
+ */
+#define OGS_PFCP_QER_BURST_MSEC 100
+
+bool ogs_pfcp_up_handle_qer(ogs_pfcp_qer_t *qer,
+        bool uplink, ogs_pkbuf_t *recvbuf, ogs_time_t now)
+{
+    ogs_pfcp_qer_bucket_t *bucket = NULL;
+    uint8_t gate;
+    uint64_t mbr, rate, burst, refill;
+    ogs_time_t elapsed;
+
+    ogs_assert(qer);
+    ogs_assert(recvbuf);
+
+    if (uplink) {
+        bucket = &qer->bucket.uplink;
+        gate = qer->gate_status.uplink;
+        mbr = qer->mbr.uplink;
+    } else {
+        bucket = &qer->bucket.downlink;
+        gate = qer->gate_status.downlink;
+        mbr = qer->mbr.downlink;
+    }
+
+    if (gate == OGS_PFCP_GATE_CLOSE)
+        goto drop;
+
+    /*
+     * GBR is what the QoS flow is guaranteed, not a limit.
+     * Only MBR is policed, and no MBR means no limit.
+     */
+    if (mbr == 0)
+        return true;
+
+    rate = mbr / 8; /* Octets per second */
+    burst = ogs_max(rate * OGS_PFCP_QER_BURST_MSEC / 1000, OGS_MAX_PKT_LEN);
+
+    elapsed = now - bucket->last;
+
+    if (bucket->last == 0 ||
+        elapsed >= ogs_time_from_msec(OGS_PFCP_QER_BURST_MSEC)) {
+        bucket->tokens = burst;
+        bucket->last = now;
+    } else if (elapsed > 0) {
+        /*
+         * Threads cache the clock per batch,
+         * so 'now' may be a little behind 'last'.
+         */
+        refill = elapsed * rate / OGS_USEC_PER_SEC;
+        /*
+         * Only the time worth of the refilled octets is consumed,
+         * so the fraction is kept for the next packet instead of lost.
+         */
+        if (refill) {
+            bucket->tokens = ogs_min(bucket->tokens + refill, burst);
+            bucket->last += refill * OGS_USEC_PER_SEC / rate;
+        }
+    }
+
+    if (bucket->tokens < recvbuf->len)
+        goto drop;
+
+    bucket->tokens -= recvbuf->len;
+
+    return true;
+
+drop:
+    bucket->dropped_pkts++;
+    bucket->dropped_octets += recvbuf->len;
+
+    return false;
+}
+
 bool ogs_pfcp_up_handle_error_indication(
         ogs_pfcp_far_t *far, ogs_pfcp_user_plane_report_t *report)
 {
@@ -373,6 +460,8 @@ ogs_pfcp_pdr_t *ogs_pfcp_handle_create_pdr(ogs_pfcp_sess_t *sess,
     pdr = ogs_pfcp_pdr_find_or_add(sess, message->pdr_id.u16);
     ogs_assert(pdr);
 
+    ogs_pfcp_sess_classifier_invalidate(sess);
+
     if (message->precedence.presence) {
         ogs_pfcp_pdr_reorder_by_precedence(pdr, message->precedence.u32);
         pdr->precedence = message->precedence.u32;
@@ -741,6 +830,8 @@ ogs_pfcp_pdr_t *ogs_pfcp_handle_update_pdr(ogs_pfcp_sess_t *sess,
         return NULL;
     }
 
+    ogs_pfcp_sess_classifier_invalidate(sess);
+
     if (message->pdi.presence) {
         if (message->pdi.source_interface.presence == 0) {
             ogs_error("No Source Interface in PDI");
@@ -1231,6 +1322,9 @@ ogs_pfcp_qer_t *ogs_pfcp_handle_update_qer(ogs_pfcp_sess_t *sess,
         return NULL;
     }
 
+    if (message->gate_status.presence)
+        qer->gate_status.value = message->gate_status.u8;
+
     if (message->maximum_bitrate.presence)
         ogs_pfcp_parse_bitrate(&qer->mbr, &message->maximum_bitrate);
     if (message->guaranteed_bitrate.presence)
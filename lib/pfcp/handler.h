@@ -45,10 +45,14 @@ bool ogs_pfcp_up_handle_association_setup_response(
         ogs_pfcp_node_t *node, ogs_pfcp_xact_t *xact,
         ogs_pfcp_association_setup_response_t *req);
 
+/* recvbuf is consumed: it is forwarded, buffered or freed */
 bool ogs_pfcp_up_handle_pdr(
         ogs_pfcp_pdr_t *pdr, uint8_t type,
         ogs_gtp2_header_desc_t *recvhdr, ogs_pkbuf_t *recvbuf,
         ogs_pfcp_user_plane_report_t *report);
+/* 'now' is a monotonic time, which the caller may cache per batch */
+bool ogs_pfcp_up_handle_qer(ogs_pfcp_qer_t *qer,
+        bool uplink, ogs_pkbuf_t *recvbuf, ogs_time_t now);
 bool ogs_pfcp_up_handle_error_indication(
         ogs_pfcp_far_t *far, ogs_pfcp_user_plane_report_t *report);
 
@@ -4691,43 +4691,53 @@ ogs_tlv_desc_t ogs_pfcp_msg_desc_pfcp_session_report_response =
 }};
 
 
+static int pfcp_parse_header(ogs_pfcp_header_t *h, ogs_pkbuf_t *pkbuf)
+{
+    uint16_t size = 0;
+
+    ogs_assert(h);
+    ogs_assert(pkbuf);
+    ogs_assert(pkbuf->len);
+
+    if (((ogs_pfcp_header_t *)pkbuf->data)->seid_presence)
+        size = OGS_PFCP_HEADER_LEN;
+    else
+        size = OGS_PFCP_HEADER_LEN-OGS_PFCP_SEID_LEN;
+
+    if (ogs_pkbuf_pull(pkbuf, size) == NULL) {
+        ogs_error("ogs_pkbuf_pull() failed [len:%d]", pkbuf->len);
+        return OGS_ERROR;
+    }
+    memcpy(h, pkbuf->data - size, size);
+
+    if (h->seid_presence) {
+        h->seid = be64toh(h->seid);
+    } else {
+        h->sqn = h->sqn_only;
+    }
+
+    return OGS_OK;
+}
+
 ogs_pfcp_message_t *ogs_pfcp_parse_msg(ogs_pkbuf_t *pkbuf)
 {
     int rv = OGS_ERROR;
-    ogs_pfcp_header_t *h = NULL;
-    uint16_t size = 0;
 
     ogs_pfcp_message_t *pfcp_message = NULL;
 
     ogs_assert(pkbuf);
     ogs_assert(pkbuf->len);
 
-    h = (ogs_pfcp_header_t *)pkbuf->data;
-    ogs_assert(h);
-
     pfcp_message = ogs_calloc(1, sizeof(*pfcp_message));
     if (!pfcp_message) {
         ogs_error("No memory");
         return NULL;
     }
 
-    if (h->seid_presence)
-        size = OGS_PFCP_HEADER_LEN;
-    else
-        size = OGS_PFCP_HEADER_LEN-OGS_PFCP_SEID_LEN;
-
-    if (ogs_pkbuf_pull(pkbuf, size) == NULL) {
-        ogs_error("ogs_pkbuf_pull() failed [len:%d]", pkbuf->len);
+    if (pfcp_parse_header(&pfcp_message->h, pkbuf) != OGS_OK) {
         ogs_pfcp_message_free(pfcp_message);
         return NULL;
     }
-    memcpy(&pfcp_message->h, pkbuf->data - size, size);
-
-    if (h->seid_presence) {
-        pfcp_message->h.seid = be64toh(pfcp_message->h.seid);
-    } else {
-        pfcp_message->h.sqn = pfcp_message->h.sqn_only;
-    }
 
     if (pkbuf->len == 0)
         return pfcp_message;
@@ -4872,6 +4882,50 @@ void ogs_pfcp_message_free(ogs_pfcp_message_t *pfcp_message)
     ogs_free(pfcp_message);
 }
 
+ogs_pfcp_index_message_t *ogs_pfcp_index_msg(ogs_pkbuf_t *pkbuf)
+{
+    ogs_pfcp_index_message_t *index_message = NULL;
+
+    ogs_assert(pkbuf);
+    ogs_assert(pkbuf->len);
+
+    /* Only the header and the IE index are written, so no need to clear */
+    index_message = ogs_malloc(sizeof(*index_message));
+    if (!index_message) {
+        ogs_error("No memory");
+        return NULL;
+    }
+    memset(&index_message->h, 0, sizeof(index_message->h));
+
+    if (pfcp_parse_header(&index_message->h, pkbuf) != OGS_OK) {
+        ogs_pfcp_index_message_free(index_message);
+        return NULL;
+    }
+
+    if (ogs_tlv_index_msg(&index_message->index,
+                pkbuf, OGS_TLV_MODE_T2_L2) != OGS_OK) {
+        ogs_error("ogs_tlv_index_msg() failed [type:%d]",
+                index_message->h.type);
+        ogs_pfcp_index_message_free(index_message);
+        return NULL;
+    }
+
+    return index_message;
+}
+
+void ogs_pfcp_index_message_free(ogs_pfcp_index_message_t *index_message)
+{
+    ogs_assert(index_message);
+    ogs_free(index_message);
+}
+
+int ogs_pfcp_parse_ie(void *ie, ogs_tlv_desc_t *desc,
+        ogs_pfcp_index_message_t *index_message, int n)
+{
+    ogs_assert(index_message);
+    return ogs_tlv_parse_ie(ie, desc, &index_message->index, n);
+}
+
 ogs_pkbuf_t *ogs_pfcp_build_msg(ogs_pfcp_message_t *pfcp_message)
 {
     ogs_pkbuf_t *pkbuf = NULL;
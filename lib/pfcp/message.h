@@ -2189,6 +2189,21 @@ ogs_pfcp_message_t *ogs_pfcp_parse_msg(ogs_pkbuf_t *pkbuf);
 void ogs_pfcp_message_free(ogs_pfcp_message_t *pfcp_message);
 ogs_pkbuf_t *ogs_pfcp_build_msg(ogs_pfcp_message_t *pfcp_message);
 
+/*
+ * Index-only variant of ogs_pfcp_parse_msg() : the header is decoded and
+ * the IEs are located, but none of them is decoded. Use ogs_pfcp_parse_ie()
+ * to decode the IEs the handler actually needs.
+ */
+typedef struct ogs_pfcp_index_message_s {
+    ogs_pfcp_header_t h;
+    ogs_tlv_index_t index;
+} ogs_pfcp_index_message_t;
+
+ogs_pfcp_index_message_t *ogs_pfcp_index_msg(ogs_pkbuf_t *pkbuf);
+void ogs_pfcp_index_message_free(ogs_pfcp_index_message_t *index_message);
+int ogs_pfcp_parse_ie(void *ie, ogs_tlv_desc_t *desc,
+        ogs_pfcp_index_message_t *index_message, int n);
+
 #ifdef __cplusplus
 }
 #endif
@@ -109,23 +109,106 @@ static int decode_ipv6_header(
     return OGS_OK;
 }
 
-ogs_pfcp_rule_t *ogs_pfcp_pdr_rule_find_by_packet(
-                    ogs_pfcp_pdr_t *pdr, ogs_pkbuf_t *pkbuf)
+void ogs_pfcp_packet_key_init(ogs_pfcp_packet_key_t *key, ogs_pkbuf_t *pkbuf)
+{
+    ogs_assert(key);
+    ogs_assert(pkbuf);
+
+    key->pkbuf = pkbuf;
+    key->parsed = false;
+}
+
+int ogs_pfcp_packet_key_parse(ogs_pfcp_packet_key_t *key)
 {
     struct ip *ip_h =  NULL;
     struct ip6_hdr *ip6_h = NULL;
-    uint32_t *src_addr = NULL;
-    uint32_t *dst_addr = NULL;
-    int addr_len = 0;
-    uint8_t proto = 0;
-    uint16_t ip_hlen = 0;
-
-    ogs_pfcp_rule_t *rule = NULL;
+    ogs_pkbuf_t *pkbuf = NULL;
 
+    ogs_assert(key);
+    pkbuf = key->pkbuf;
     ogs_assert(pkbuf);
     ogs_assert(pkbuf->len);
     ogs_assert(pkbuf->data);
 
+    if (key->parsed)
+        return key->addr_len ? OGS_OK : OGS_ERROR;
+
+    key->parsed = true;
+    key->addr_len = 0;
+    key->proto = 0;
+    key->ip_hlen = 0;
+    memset(key->src_addr, 0, sizeof(key->src_addr));
+    memset(key->dst_addr, 0, sizeof(key->dst_addr));
+    key->src_port = 0;
+    key->dst_port = 0;
+
+    ip_h = (struct ip *)pkbuf->data;
+    if (ip_h->ip_v == 4) {
+        key->proto = ip_h->ip_p;
+        key->ip_hlen = (ip_h->ip_hl)*4;
+
+        memcpy(key->src_addr, &ip_h->ip_src.s_addr, OGS_IPV4_LEN);
+        memcpy(key->dst_addr, &ip_h->ip_dst.s_addr, OGS_IPV4_LEN);
+        key->addr_len = OGS_IPV4_LEN;
+    } else if (ip_h->ip_v == 6) {
+        ip6_h = (struct ip6_hdr *)pkbuf->data;
+
+        decode_ipv6_header(ip6_h, &key->proto, &key->ip_hlen);
+
+        memcpy(key->src_addr, ip6_h->ip6_src.s6_addr, OGS_IPV6_LEN);
+        memcpy(key->dst_addr, ip6_h->ip6_dst.s6_addr, OGS_IPV6_LEN);
+        key->addr_len = OGS_IPV6_LEN;
+    } else {
+        ogs_error("Invalid packet [IP version:%d, Packet Length:%d]",
+                ip_h->ip_v, pkbuf->len);
+        ogs_log_hexdump(OGS_LOG_ERROR, pkbuf->data, pkbuf->len);
+        return OGS_ERROR;
+    }
+
+    /* Source and destination ports are at the same offset in TCP and UDP */
+    if ((key->proto == IPPROTO_TCP || key->proto == IPPROTO_UDP) &&
+        pkbuf->len >= key->ip_hlen + sizeof(struct udphdr)) {
+        struct udphdr *udph =
+            (struct udphdr *)((char *)pkbuf->data + key->ip_hlen);
+
+        key->src_port = be16toh(udph->uh_sport);
+        key->dst_port = be16toh(udph->uh_dport);
+    }
+
+    ogs_trace("PROTO:%d SRC:%08x %08x %08x %08x",
+            key->proto, be32toh(key->src_addr[0]), be32toh(key->src_addr[1]),
+            be32toh(key->src_addr[2]), be32toh(key->src_addr[3]));
+    ogs_trace("HLEN:%d  DST:%08x %08x %08x %08x",
+            key->ip_hlen, be32toh(key->dst_addr[0]), be32toh(key->dst_addr[1]),
+            be32toh(key->dst_addr[2]), be32toh(key->dst_addr[3]));
+
+    return OGS_OK;
+}
+
+static bool port_match(uint16_t port, uint16_t low, uint16_t high)
+{
+    if (low && port < low)
+        return false;
+    if (high && port > high)
+        return false;
+
+    return true;
+}
+
+ogs_pfcp_rule_t *ogs_pfcp_pdr_rule_find_by_key(
+                    ogs_pfcp_pdr_t *pdr, ogs_pfcp_packet_key_t *key)
+{
+    ogs_pfcp_rule_t *rule = NULL;
+
+    ogs_assert(pdr);
+    ogs_assert(key);
+
+    if (!ogs_list_first(&pdr->rule_list))
+        return NULL;
+
+    if (ogs_pfcp_packet_key_parse(key) != OGS_OK)
+        return NULL;
+
     ogs_list_for_each(&pdr->rule_list, rule) {
         int k;
         uint32_t src_mask[4];
@@ -135,146 +218,388 @@ ogs_pfcp_rule_t *ogs_pfcp_pdr_rule_find_by_packet(
         ipfw = &rule->ipfw;
         ogs_assert(ipfw);
 
-        ip_h = (struct ip *)pkbuf->data;
-        if (ip_h->ip_v == 4) {
-            ip_h = (struct ip *)pkbuf->data;
-            ip6_h = NULL;
-
-            proto = ip_h->ip_p;
-            ip_hlen = (ip_h->ip_hl)*4;
-
-            src_addr = (void *)&ip_h->ip_src.s_addr;
-            dst_addr = (void *)&ip_h->ip_dst.s_addr;
-            addr_len = OGS_IPV4_LEN;
-        } else if (ip_h->ip_v == 6) {
-            ip_h = NULL;
-            ip6_h = (struct ip6_hdr *)pkbuf->data;
-
-            decode_ipv6_header(ip6_h, &proto, &ip_hlen);
-
-            src_addr = (void *)ip6_h->ip6_src.s6_addr;
-            dst_addr = (void *)ip6_h->ip6_dst.s6_addr;
-            addr_len = OGS_IPV6_LEN;
-        } else {
-            ogs_error("Invalid packet [IP version:%d, Packet Length:%d]",
-                    ip_h->ip_v, pkbuf->len);
-            ogs_log_hexdump(OGS_LOG_ERROR, pkbuf->data, pkbuf->len);
-            continue;
-        }
-
-        ogs_trace("PROTO:%d SRC:%08x %08x %08x %08x",
-                proto, be32toh(src_addr[0]), be32toh(src_addr[1]),
-                be32toh(src_addr[2]), be32toh(src_addr[3]));
-        ogs_trace("HLEN:%d  DST:%08x %08x %08x %08x",
-                ip_hlen, be32toh(dst_addr[0]), be32toh(dst_addr[1]),
-                be32toh(dst_addr[2]), be32toh(dst_addr[3]));
-
         ogs_trace("PROTO:%d SRC:%d-%d DST:%d-%d",
                 ipfw->proto,
                 ipfw->port.src.low,
                 ipfw->port.src.high,
                 ipfw->port.dst.low,
                 ipfw->port.dst.high);
-        ogs_trace("SRC:%08x %08x %08x %08x/%08x %08x %08x %08x",
-                be32toh(ipfw->ip.src.addr[0]),
-                be32toh(ipfw->ip.src.addr[1]),
-                be32toh(ipfw->ip.src.addr[2]),
-                be32toh(ipfw->ip.src.addr[3]),
-                be32toh(ipfw->ip.src.mask[0]),
-                be32toh(ipfw->ip.src.mask[1]),
-                be32toh(ipfw->ip.src.mask[2]),
-                be32toh(ipfw->ip.src.mask[3]));
-        ogs_trace("DST:%08x %08x %08x %08x/%08x %08x %08x %08x",
-                be32toh(ipfw->ip.dst.addr[0]),
-                be32toh(ipfw->ip.dst.addr[1]),
-                be32toh(ipfw->ip.dst.addr[2]),
-                be32toh(ipfw->ip.dst.addr[3]),
-                be32toh(ipfw->ip.dst.mask[0]),
-                be32toh(ipfw->ip.dst.mask[1]),
-                be32toh(ipfw->ip.dst.mask[2]),
-                be32toh(ipfw->ip.dst.mask[3]));
 
         for (k = 0; k < 4; k++) {
-            src_mask[k] = src_addr[k] & ipfw->ip.src.mask[k];
-            dst_mask[k] = dst_addr[k] & ipfw->ip.dst.mask[k];
+            src_mask[k] = key->src_addr[k] & ipfw->ip.src.mask[k];
+            dst_mask[k] = key->dst_addr[k] & ipfw->ip.dst.mask[k];
         }
 
-        if (memcmp(src_mask, ipfw->ip.src.addr, addr_len) == 0 &&
-            memcmp(dst_mask, ipfw->ip.dst.addr, addr_len) == 0) {
-            /* Protocol match */
-            if (ipfw->proto == 0) { /* IP */
-                /* No need to match port */
-                return rule;
+        if (memcmp(src_mask, ipfw->ip.src.addr, key->addr_len) != 0 ||
+            memcmp(dst_mask, ipfw->ip.dst.addr, key->addr_len) != 0)
+            continue;
+
+        /* Protocol match */
+        if (ipfw->proto == 0) { /* IP */
+            /* No need to match port */
+            return rule;
+        }
+
+        if (ipfw->proto != key->proto)
+            continue;
+
+        if (ipfw->proto == IPPROTO_TCP || ipfw->proto == IPPROTO_UDP) {
+            if (!port_match(key->src_port,
+                        ipfw->port.src.low, ipfw->port.src.high))
+                continue;
+            if (!port_match(key->dst_port,
+                        ipfw->port.dst.low, ipfw->port.dst.high))
+                continue;
+        }
+
+        /* Matched */
+        return rule;
+    }
+
+    return NULL;
+}
+
+ogs_pfcp_rule_t *ogs_pfcp_pdr_rule_find_by_packet(
+                    ogs_pfcp_pdr_t *pdr, ogs_pkbuf_t *pkbuf)
+{
+    ogs_pfcp_packet_key_t key;
+
+    ogs_pfcp_packet_key_init(&key, pkbuf);
+
+    return ogs_pfcp_pdr_rule_find_by_key(pdr, &key);
+}
+
+static bool classifier_pdr_fits(ogs_pfcp_pdr_match_t *match,
+        ogs_pfcp_interface_t src_if, uint32_t teid, uint8_t qfi)
+{
+    if (!(match->src_if & OGS_PFCP_PDR_MATCH_IF(src_if)))
+        return false;
+    if (match->teid_presence && match->teid != teid)
+        return false;
+    if (match->qfi && match->qfi != qfi)
+        return false;
+
+    return true;
+}
+
+static uint32_t classifier_hash(int tuple, int addr_len,
+        uint32_t *src_addr, uint32_t *dst_addr, uint8_t proto)
+{
+    uint32_t hash = (tuple << 8) ^ (addr_len << 4) ^ proto;
+    int k;
+
+    for (k = 0; k < addr_len / 4; k++) {
+        hash = (hash ^ src_addr[k]) * 0x9e3779b1;
+        hash = (hash ^ dst_addr[k]) * 0x9e3779b1;
+    }
+
+    return hash ^ (hash >> 16);
+}
+
+static int classifier_reserve(void **array, int *max, int num, size_t size)
+{
+    void *p = NULL;
+
+    if (num <= *max)
+        return OGS_OK;
+
+    p = ogs_realloc(*array, num * size);
+    if (!p) {
+        ogs_error("ogs_realloc() failed [%d]", num);
+        return OGS_ERROR;
+    }
+    *array = p;
+    *max = num;
+
+    return OGS_OK;
+}
+
+static int classifier_tuple_find_or_add(
+        ogs_pfcp_classifier_t *classifier, ogs_ipfw_rule_t *ipfw, int order)
+{
+    ogs_pfcp_classifier_tuple_t *tuple = NULL;
+    int i;
+
+    for (i = 0; i < classifier->num_of_tuple; i++) {
+        tuple = &classifier->tuple[i];
+        if (tuple->proto == (ipfw->proto != 0) &&
+            memcmp(tuple->src_mask, ipfw->ip.src.mask,
+                sizeof(tuple->src_mask)) == 0 &&
+            memcmp(tuple->dst_mask, ipfw->ip.dst.mask,
+                sizeof(tuple->dst_mask)) == 0)
+            return i;
+    }
+
+    /* PDRs are added in order, so the first one is the best of the tuple */
+    tuple = &classifier->tuple[classifier->num_of_tuple];
+    memcpy(tuple->src_mask, ipfw->ip.src.mask, sizeof(tuple->src_mask));
+    memcpy(tuple->dst_mask, ipfw->ip.dst.mask, sizeof(tuple->dst_mask));
+    tuple->proto = (ipfw->proto != 0);
+    tuple->order = order;
+
+    return classifier->num_of_tuple++;
+}
+
+int ogs_pfcp_sess_classifier_build(ogs_pfcp_sess_t *sess)
+{
+    ogs_pfcp_classifier_t *classifier = NULL;
+    ogs_pfcp_classifier_entry_t *entry = NULL;
+    ogs_pfcp_pdr_t *pdr = NULL;
+    ogs_pfcp_rule_t *rule = NULL;
+    int num_of_rule = 0, num_of_any = 0, num_of_bucket;
+    int order, tuple, i, k;
+    uint32_t hash;
+
+    static const uint8_t addr_len[] = { OGS_IPV4_LEN, OGS_IPV6_LEN };
+
+    ogs_assert(sess);
+    classifier = &sess->classifier;
+
+    classifier->compiled = false;
+
+    ogs_list_for_each(&sess->pdr_list, pdr) {
+        int n = ogs_list_count(&pdr->rule_list);
+        if (n)
+            num_of_rule += n;
+        else
+            num_of_any++;
+    }
+
+    num_of_bucket = 1;
+    while (num_of_bucket < 4 * num_of_rule)
+        num_of_bucket <<= 1;
+
+    /* Each SDF filter is hashed for IPv4 and for IPv6 */
+    if (classifier_reserve((void **)&classifier->entry,
+                &classifier->max_entry, 2 * num_of_rule + num_of_any,
+                sizeof(*classifier->entry)) != OGS_OK ||
+        classifier_reserve((void **)&classifier->tuple,
+                &classifier->max_tuple, num_of_rule,
+                sizeof(*classifier->tuple)) != OGS_OK ||
+        classifier_reserve((void **)&classifier->any,
+                &classifier->max_any, num_of_any,
+                sizeof(*classifier->any)) != OGS_OK ||
+        classifier_reserve((void **)&classifier->bucket,
+                &classifier->max_bucket, num_of_bucket,
+                sizeof(*classifier->bucket)) != OGS_OK)
+        return OGS_ERROR;
+
+    classifier->num_of_entry = 0;
+    classifier->num_of_tuple = 0;
+    classifier->num_of_any = 0;
+    classifier->bucket_mask = num_of_bucket - 1;
+    for (i = 0; i < num_of_bucket; i++)
+        classifier->bucket[i] = -1;
+
+    order = 0;
+    ogs_list_for_each(&sess->pdr_list, pdr) {
+        if (!ogs_list_first(&pdr->rule_list)) {
+            entry = &classifier->entry[classifier->num_of_entry];
+            memset(entry, 0, sizeof(*entry));
+            entry->pdr = pdr;
+            entry->order = order;
+            entry->tuple = -1;
+            entry->chain = -1;
+            entry->src_if = pdr->src_if;
+            entry->qfi = pdr->qfi;
+            entry->teid = pdr->f_teid.teid;
+
+            classifier->any[classifier->num_of_any++] =
+                classifier->num_of_entry++;
+        }
+
+        ogs_list_for_each(&pdr->rule_list, rule) {
+            ogs_ipfw_rule_t *ipfw = &rule->ipfw;
+
+            tuple = classifier_tuple_find_or_add(classifier, ipfw, order);
+
+            for (k = 0; k < OGS_ARRAY_SIZE(addr_len); k++) {
+                entry = &classifier->entry[classifier->num_of_entry];
+                memset(entry, 0, sizeof(*entry));
+                entry->pdr = pdr;
+                entry->order = order;
+                entry->tuple = tuple;
+                entry->src_if = pdr->src_if;
+                entry->qfi = pdr->qfi;
+                entry->teid = pdr->f_teid.teid;
+
+                /*
+                 * An address that has bits outside of its mask never
+                 * matches, and it never will here either
+                 */
+                entry->addr_len = addr_len[k];
+                entry->proto = ipfw->proto;
+                memcpy(entry->src_addr, ipfw->ip.src.addr,
+                        sizeof(entry->src_addr));
+                memcpy(entry->dst_addr, ipfw->ip.dst.addr,
+                        sizeof(entry->dst_addr));
+                entry->src_port_low = ipfw->port.src.low;
+                entry->src_port_high = ipfw->port.src.high;
+                entry->dst_port_low = ipfw->port.dst.low;
+                entry->dst_port_high = ipfw->port.dst.high;
+
+                hash = classifier_hash(tuple, entry->addr_len,
+                        entry->src_addr, entry->dst_addr, entry->proto);
+                entry->chain =
+                    classifier->bucket[hash & classifier->bucket_mask];
+                classifier->bucket[hash & classifier->bucket_mask] =
+                    classifier->num_of_entry++;
             }
+        }
+
+        order++;
+    }
+    ogs_assert(classifier->num_of_entry == 2 * num_of_rule + num_of_any);
+
+    classifier->compiled = true;
+
+    return OGS_OK;
+}
+
+void ogs_pfcp_sess_classifier_invalidate(ogs_pfcp_sess_t *sess)
+{
+    ogs_assert(sess);
+    sess->classifier.compiled = false;
+}
+
+void ogs_pfcp_sess_classifier_free(ogs_pfcp_sess_t *sess)
+{
+    ogs_assert(sess);
+
+    if (sess->classifier.entry)
+        ogs_free(sess->classifier.entry);
+    if (sess->classifier.tuple)
+        ogs_free(sess->classifier.tuple);
+    if (sess->classifier.any)
+        ogs_free(sess->classifier.any);
+    if (sess->classifier.bucket)
+        ogs_free(sess->classifier.bucket);
+    memset(&sess->classifier, 0, sizeof(sess->classifier));
+}
+
+static bool classifier_entry_match(ogs_pfcp_classifier_entry_t *entry,
+        ogs_pfcp_packet_key_t *key, uint32_t *src_addr, uint32_t *dst_addr)
+{
+    int k;
+
+    if (entry->addr_len != key->addr_len)
+        return false;
+
+    for (k = 0; k < key->addr_len / 4; k++) {
+        if (src_addr[k] != entry->src_addr[k] ||
+            dst_addr[k] != entry->dst_addr[k])
+            return false;
+    }
+
+    if (entry->proto == 0) /* IP */
+        return true;
+
+    if (entry->proto != key->proto)
+        return false;
+
+    if (entry->proto == IPPROTO_TCP || entry->proto == IPPROTO_UDP) {
+        if (!port_match(key->src_port,
+                    entry->src_port_low, entry->src_port_high))
+            return false;
+        if (!port_match(key->dst_port,
+                    entry->dst_port_low, entry->dst_port_high))
+            return false;
+    }
+
+    return true;
+}
 
-            if (ipfw->proto == proto) {
-                if (ipfw->proto == IPPROTO_TCP) {
-                    struct tcphdr *tcph =
-                        (struct tcphdr *)((char *)pkbuf->data + ip_hlen);
-
-                    /* Source port */
-                    if (ipfw->port.src.low &&
-                          be16toh(tcph->th_sport) < ipfw->port.src.low) {
-                        continue;
-                    }
-
-                    if (ipfw->port.src.high &&
-                          be16toh(tcph->th_sport) > ipfw->port.src.high) {
-                        continue;
-                    }
-
-                    /* Dst Port*/
-                    if (ipfw->port.dst.low &&
-                          be16toh(tcph->th_dport) < ipfw->port.dst.low) {
-                        continue;
-                    }
-
-                    if (ipfw->port.dst.high &&
-                          be16toh(tcph->th_dport) > ipfw->port.dst.high) {
-                        continue;
-                    }
-
-                    /* Matched */
-                    return rule;
-
-                } else if (ipfw->proto == IPPROTO_UDP) {
-                    struct udphdr *udph =
-                        (struct udphdr *)((char *)pkbuf->data + ip_hlen);
-
-                    /* Source port */
-                    if (ipfw->port.src.low &&
-                          be16toh(udph->uh_sport) < ipfw->port.src.low) {
-                        continue;
-                    }
-
-                    if (ipfw->port.src.high &&
-                          be16toh(udph->uh_sport) > ipfw->port.src.high) {
-                        continue;
-                    }
-
-                    /* Dst Port*/
-                    if (ipfw->port.dst.low &&
-                          be16toh(udph->uh_dport) < ipfw->port.dst.low) {
-                        continue;
-                    }
-
-                    if (ipfw->port.dst.high &&
-                          be16toh(udph->uh_dport) > ipfw->port.dst.high) {
-                        continue;
-                    }
-
-                    /* Matched */
-                    return rule;
-
-                } else {
-
-                    /* No need to match port */
-                    return rule;
-
-                }
+ogs_pfcp_pdr_t *ogs_pfcp_sess_pdr_find_by_key(ogs_pfcp_sess_t *sess,
+        ogs_pfcp_pdr_match_t *match, ogs_pfcp_packet_key_t *key, int *pos)
+{
+    ogs_pfcp_classifier_t *classifier = NULL;
+    ogs_pfcp_classifier_entry_t *entry = NULL;
+    ogs_pfcp_pdr_t *pdr = NULL, *found = NULL;
+    uint32_t src_addr[4], dst_addr[4], hash;
+    int i, k, e, best;
+
+    ogs_assert(sess);
+    ogs_assert(match);
+    ogs_assert(key);
+    ogs_assert(pos);
+
+    classifier = &sess->classifier;
+
+    if (!classifier->compiled) {
+        /* *pos counts the PDRs already returned or skipped */
+        i = 0;
+        ogs_list_for_each(&sess->pdr_list, pdr) {
+            if (i++ < *pos)
+                continue;
+
+            if (!classifier_pdr_fits(match,
+                        pdr->src_if, pdr->f_teid.teid, pdr->qfi))
+                continue;
+
+            if (ogs_list_first(&pdr->rule_list) &&
+                ogs_pfcp_pdr_rule_find_by_key(pdr, key) == NULL)
+                continue;
+
+            *pos = i;
+            return pdr;
+        }
+
+        *pos = i;
+        return NULL;
+    }
+
+    best = classifier->num_of_entry;      /* Past the last PDR */
+
+    /* PDRs without SDF filter, in order */
+    for (i = 0; i < classifier->num_of_any; i++) {
+        entry = &classifier->entry[classifier->any[i]];
+        if (entry->order < *pos)
+            continue;
+        if (classifier_pdr_fits(match,
+                    entry->src_if, entry->teid, entry->qfi)) {
+            best = entry->order;
+            found = entry->pdr;
+            break;
+        }
+    }
+
+    if (classifier->num_of_tuple && ogs_pfcp_packet_key_parse(key) == OGS_OK) {
+        for (i = 0; i < classifier->num_of_tuple; i++) {
+            ogs_pfcp_classifier_tuple_t *tuple = &classifier->tuple[i];
+
+            /* Tuples are in order of their best PDR */
+            if (tuple->order >= best)
+                break;
+
+            for (k = 0; k < key->addr_len / 4; k++) {
+                src_addr[k] = key->src_addr[k] & tuple->src_mask[k];
+                dst_addr[k] = key->dst_addr[k] & tuple->dst_mask[k];
+            }
+            hash = classifier_hash(i, key->addr_len, src_addr, dst_addr,
+                    tuple->proto ? key->proto : 0);
+
+            for (e = classifier->bucket[hash & classifier->bucket_mask];
+                    e >= 0; e = entry->chain) {
+                entry = &classifier->entry[e];
+
+                if (entry->tuple != i ||
+                    entry->order < *pos || entry->order >= best)
+                    continue;
+                if (!classifier_entry_match(entry, key, src_addr, dst_addr))
+                    continue;
+                if (!classifier_pdr_fits(match,
+                            entry->src_if, entry->teid, entry->qfi))
+                    continue;
+
+                best = entry->order;
+                found = entry->pdr;
             }
         }
     }
 
-    return NULL;
+    if (!found)
+        return NULL;
+
+    *pos = best + 1;
+    return found;
 }
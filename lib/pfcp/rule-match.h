@@ -28,9 +28,114 @@
 extern "C" {
 #endif
 
+/*
+ * The 5-tuple of a packet, parsed at most once per packet
+ * no matter how many PDRs and SDF filters it is matched against.
+ *
+ * ogs_pfcp_packet_key_t key;
+ * ogs_pfcp_packet_key_init(&key, pkbuf);
+ * ogs_list_for_each(&sess->pdr_list, pdr) {
+ *     ...
+ *     if (ogs_list_first(&pdr->rule_list) &&
+ *         ogs_pfcp_pdr_rule_find_by_key(pdr, &key) == NULL)
+ *         continue;
+ * }
+ */
+typedef struct ogs_pfcp_packet_key_s {
+    ogs_pkbuf_t *pkbuf;
+    bool parsed;
+
+    int addr_len;       /* 0 if not an IP packet */
+    uint8_t proto;
+    uint16_t ip_hlen;
+    uint32_t src_addr[4];
+    uint32_t dst_addr[4];
+    uint16_t src_port;  /* TCP/UDP only, host byte order */
+    uint16_t dst_port;
+} ogs_pfcp_packet_key_t;
+
+void ogs_pfcp_packet_key_init(ogs_pfcp_packet_key_t *key, ogs_pkbuf_t *pkbuf);
+int ogs_pfcp_packet_key_parse(ogs_pfcp_packet_key_t *key);
+
+ogs_pfcp_rule_t *ogs_pfcp_pdr_rule_find_by_key(
+                    ogs_pfcp_pdr_t *pdr, ogs_pfcp_packet_key_t *key);
 ogs_pfcp_rule_t *ogs_pfcp_pdr_rule_find_by_packet(
                     ogs_pfcp_pdr_t *pdr, ogs_pkbuf_t *pkbuf);
 
+/*
+ * Session-wide PDR classifier
+ *
+ * ogs_pfcp_sess_classifier_build() compiles the SDF filters of all PDRs
+ * of a session for tuple space search. Filters with the same source and
+ * destination masks, and either a protocol or none, share a tuple. Each
+ * filter is hashed on its tuple, its addresses and its protocol, once
+ * for IPv4 packets and once for IPv6 packets, since a packet is only
+ * compared on the length of its own addresses. A lookup then costs one
+ * hash probe per tuple, instead of one comparison per filter; ports are
+ * ranges, so they are checked on the filters found by the probe.
+ *
+ * Every entry carries the position of its PDR in pdr_list, which is
+ * kept in precedence order, and the lowest position wins. Tuples are
+ * kept in the order of their first PDR, so the search stops at the first
+ * tuple that cannot hold a better PDR. PDRs without SDF filter match any
+ * packet and are kept aside in precedence order.
+ *
+ * Any change to the PDRs or SDF filters of a session marks the table
+ * as not compiled, and ogs_pfcp_sess_pdr_find_by_key() falls back to
+ * walking pdr_list until the owner of the session rebuilds it. The table
+ * is only read while matching, so it must be rebuilt from the control
+ * plane once the PFCP message has been handled.
+ *
+ * ogs_pfcp_pdr_match_t match;
+ * int pos = 0;
+ * match.src_if = OGS_PFCP_PDR_MATCH_IF(OGS_PFCP_INTERFACE_CORE);
+ * ...
+ * while ((pdr = ogs_pfcp_sess_pdr_find_by_key(sess, &match, &key, &pos))) {
+ *     if (pdr->far is not usable)
+ *         continue;
+ *     break;
+ * }
+ */
+typedef struct ogs_pfcp_classifier_tuple_s {
+    uint32_t src_mask[4];
+    uint32_t dst_mask[4];
+    bool proto;             /* false : any protocol */
+    int order;              /* of the first PDR in this tuple */
+} ogs_pfcp_classifier_tuple_t;
+
+typedef struct ogs_pfcp_classifier_entry_s {
+    ogs_pfcp_pdr_t *pdr;
+    int order;              /* of the PDR in pdr_list */
+    int tuple;              /* -1 : PDR without SDF filter */
+    int chain;              /* Next entry in the same bucket, or -1 */
+
+    ogs_pfcp_interface_t src_if;
+    uint8_t qfi;
+    uint32_t teid;
+
+    uint8_t addr_len;       /* of the packets hashed to this entry */
+    uint8_t proto;          /* 0 : any protocol, ports are not checked */
+    uint32_t src_addr[4];
+    uint32_t dst_addr[4];
+    uint16_t src_port_low, src_port_high;
+    uint16_t dst_port_low, dst_port_high;
+} ogs_pfcp_classifier_entry_t;
+
+#define OGS_PFCP_PDR_MATCH_IF(__iF) (1 << (__iF))
+typedef struct ogs_pfcp_pdr_match_s {
+    uint32_t src_if;        /* OGS_PFCP_PDR_MATCH_IF() bits */
+    bool teid_presence;
+    uint32_t teid;
+    uint8_t qfi;            /* 0 : any QFI */
+} ogs_pfcp_pdr_match_t;
+
+int ogs_pfcp_sess_classifier_build(ogs_pfcp_sess_t *sess);
+void ogs_pfcp_sess_classifier_invalidate(ogs_pfcp_sess_t *sess);
+void ogs_pfcp_sess_classifier_free(ogs_pfcp_sess_t *sess);
+
+ogs_pfcp_pdr_t *ogs_pfcp_sess_pdr_find_by_key(ogs_pfcp_sess_t *sess,
+        ogs_pfcp_pdr_match_t *match, ogs_pfcp_packet_key_t *key, int *pos);
+
 #ifdef __cplusplus
 }
 #endif
@@ -34,10 +34,9 @@ typedef struct connection_s {
 
     void *data;
 
-    char *method;
+    const char *method;     /* OGS_SBI_HTTP_METHOD_XXX or method_buf */
+    char *method_buf;
 
-    int num_of_header;
-    char **headers;
     struct curl_slist *header_list;
     struct curl_slist *resolve_list;
 
@@ -57,6 +56,8 @@ typedef struct connection_s {
 
     ogs_sbi_client_t *client;
     ogs_sbi_client_cb_f client_cb;
+
+    bool pending;           /* waiting in client->pending_list */
 } connection_t;
 
 static OGS_POOL(client_pool, ogs_sbi_client_t);
@@ -77,6 +78,15 @@ static void connection_free(connection_t *conn);
 static void connection_remove_all(ogs_sbi_client_t *client);
 static void connection_timer_expired(void *data);
 
+static const char *http_methods[] = {
+    OGS_SBI_HTTP_METHOD_DELETE,
+    OGS_SBI_HTTP_METHOD_GET,
+    OGS_SBI_HTTP_METHOD_PATCH,
+    OGS_SBI_HTTP_METHOD_POST,
+    OGS_SBI_HTTP_METHOD_PUT,
+    OGS_SBI_HTTP_METHOD_OPTIONS,
+};
+
 void ogs_sbi_client_init(int num_of_sockinfo_pool, int num_of_connection_pool)
 {
     curl_global_init(CURL_GLOBAL_DEFAULT);
@@ -106,6 +116,7 @@ ogs_sbi_client_t *ogs_sbi_client_add(
 {
     ogs_sbi_client_t *client = NULL;
     CURLM *multi = NULL;
+    int max_connections;
 
     ogs_assert(scheme);
     ogs_assert(fqdn || addr || addr6);
@@ -149,18 +160,33 @@ ogs_sbi_client_t *ogs_sbi_client_add(
         return NULL;
     }
 
+    max_connections = ogs_sbi_self()->client.max_connections;
+    ogs_assert(max_connections > 0);
+    client->max_stream = ogs_sbi_self()->client.max_concurrent_streams;
+    ogs_assert(client->max_stream > 0);
+
     multi = client->multi = curl_multi_init();
     ogs_assert(multi);
     curl_multi_setopt(multi, CURLMOPT_SOCKETFUNCTION, sock_cb);
     curl_multi_setopt(multi, CURLMOPT_SOCKETDATA, client);
     curl_multi_setopt(multi, CURLMOPT_TIMERFUNCTION, multi_timer_cb);
     curl_multi_setopt(multi, CURLMOPT_TIMERDATA, client);
-#ifdef CURLMOPT_MAX_CONCURRENT_STREAMS
+
+    /*
+     * Requests to this peer are multiplexed over at most 'max_connections'
+     * HTTP/2 connections. CURL opens another one only when the current
+     * ones carry as many streams as the peer allows.
+     */
+    curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS,
+                        (long)max_connections);
+#if LIBCURL_VERSION_NUM >= 0x074300 /* CURLMOPT_MAX_CONCURRENT_STREAMS */
     curl_multi_setopt(multi, CURLMOPT_MAX_CONCURRENT_STREAMS,
-                        ogs_app()->pool.stream);
+                        (long)client->max_stream);
 #endif
 
     ogs_list_init(&client->connection_list);
+    ogs_list_init(&client->pending_list);
 
     ogs_list_add(&ogs_sbi_self()->client_list, client);
 
@@ -199,6 +225,9 @@ void ogs_sbi_client_remove(ogs_sbi_client_t *client)
 
     connection_remove_all(client);
 
+    while (client->num_of_idle_easy)
+        curl_easy_cleanup(client->idle_easy[--client->num_of_idle_easy]);
+
     ogs_assert(client->t_curl);
     ogs_timer_delete(client->t_curl);
     client->t_curl = NULL;
@@ -283,6 +312,10 @@ void ogs_sbi_client_stop(ogs_sbi_client_t *client)
         ogs_assert(conn->client_cb);
         conn->client_cb(OGS_DONE, NULL, conn->data);
     }
+    ogs_list_for_each(&client->pending_list, conn) {
+        ogs_assert(conn->client_cb);
+        conn->client_cb(OGS_DONE, NULL, conn->data);
+    }
 }
 
 void ogs_sbi_client_stop_all(void)
@@ -363,14 +396,55 @@ static char *add_params_to_uri(CURL *easy, char *uri, ogs_hash_t *params)
     return uri;
 }
 
+static CURL *easy_get(ogs_sbi_client_t *client)
+{
+    ogs_assert(client);
+
+    if (client->num_of_idle_easy)
+        return client->idle_easy[--client->num_of_idle_easy];
+
+    return curl_easy_init();
+}
+
+static void easy_put(ogs_sbi_client_t *client, CURL *easy)
+{
+    ogs_assert(client);
+    ogs_assert(easy);
+
+    if (client->num_of_idle_easy < OGS_SBI_CLIENT_MAX_IDLE_EASY) {
+        /* Live connections and caches are kept by the multi handle */
+        curl_easy_reset(easy);
+        client->idle_easy[client->num_of_idle_easy++] = easy;
+    } else {
+        curl_easy_cleanup(easy);
+    }
+}
+
+static void connection_start(connection_t *conn)
+{
+    ogs_sbi_client_t *client = NULL;
+    CURLMcode rc;
+
+    ogs_assert(conn);
+    client = conn->client;
+    ogs_assert(client);
+
+    conn->pending = false;
+    ogs_list_add(&client->connection_list, conn);
+    client->num_of_stream++;
+
+    ogs_assert(client->multi);
+    rc = curl_multi_add_handle(client->multi, conn->easy);
+    mcode_or_die("connection_start: curl_multi_add_handle", rc);
+}
+
 static connection_t *connection_add(
         ogs_sbi_client_t *client, ogs_sbi_client_cb_f client_cb,
         ogs_sbi_request_t *request, void *data)
 {
     ogs_hash_index_t *hi;
-    int i;
+    unsigned int i;
     connection_t *conn = NULL;
-    CURLMcode rc;
 
     ogs_assert(client);
     ogs_assert(client_cb);
@@ -388,35 +462,49 @@ static connection_t *connection_add(
     conn->client_cb = client_cb;
     conn->data = data;
 
-    conn->method = ogs_strdup(request->h.method);
-    if (!conn->method) {
-        ogs_error("conn->method is NULL");
-        connection_free(conn);
-        return NULL;
+    for (i = 0; i < OGS_ARRAY_SIZE(http_methods); i++) {
+        if (strcmp(request->h.method, http_methods[i]) == 0) {
+            conn->method = http_methods[i];
+            break;
+        }
     }
-
-    conn->num_of_header = ogs_hash_count(request->http.headers);
-    if (conn->num_of_header) {
-        conn->headers = ogs_calloc(conn->num_of_header, sizeof(char *));
-        if (!conn->headers) {
-            ogs_error("conn->headers is NULL");
+    if (!conn->method) {
+        conn->method = conn->method_buf = ogs_strdup(request->h.method);
+        if (!conn->method) {
+            ogs_error("conn->method is NULL");
             connection_free(conn);
             return NULL;
         }
-        for (hi = ogs_hash_first(request->http.headers), i = 0;
-                hi && i < conn->num_of_header; hi = ogs_hash_next(hi), i++) {
-            const char *key = ogs_hash_this_key(hi);
-            char *val = ogs_hash_this_val(hi);
-
-            conn->headers[i] = ogs_msprintf("%s: %s", key, val);
-            if (!conn->headers[i]) {
-                ogs_error("conn->headers[i=%d] is NULL", i);
+    }
+
+    for (hi = ogs_hash_first(request->http.headers);
+            hi; hi = ogs_hash_next(hi)) {
+        const char *key = ogs_hash_this_key(hi);
+        char *val = ogs_hash_this_val(hi);
+        char buf[OGS_HUGE_LEN];
+        char *header = buf;
+        struct curl_slist *header_list = NULL;
+
+        /* curl_slist_append() keeps its own copy of the header */
+        if (ogs_snprintf(buf, sizeof(buf), "%s: %s", key, val) >=
+                (int)sizeof(buf)) {
+            header = ogs_msprintf("%s: %s", key, val);
+            if (!header) {
+                ogs_error("ogs_msprintf() failed [%s]", key);
                 connection_free(conn);
                 return NULL;
             }
-            conn->header_list = curl_slist_append(
-                    conn->header_list, conn->headers[i]);
         }
+
+        header_list = curl_slist_append(conn->header_list, header);
+        if (header != buf)
+            ogs_free(header);
+        if (!header_list) {
+            ogs_error("curl_slist_append() failed [%s]", key);
+            connection_free(conn);
+            return NULL;
+        }
+        conn->header_list = header_list;
     }
 
     conn->timer = ogs_timer_add(
@@ -432,7 +520,7 @@ static connection_t *connection_add(
     ogs_timer_start(conn->timer,
             ogs_local_conf()->time.message.sbi.connection_deadline);
 
-    conn->easy = curl_easy_init();
+    conn->easy = easy_get(client);
     if (!conn->easy) {
         ogs_error("conn->easy is NULL");
         connection_free(conn);
@@ -505,10 +593,10 @@ static connection_t *connection_add(
 #if 1 /* Use HTTP2 */
     curl_easy_setopt(conn->easy,
             CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE);
+    /* Wait for a connection that can multiplex rather than open a new one */
+    curl_easy_setopt(conn->easy, CURLOPT_PIPEWAIT, 1L);
 #endif
 
-    ogs_list_add(&client->connection_list, conn);
-
     curl_easy_setopt(conn->easy, CURLOPT_URL, request->h.uri);
 
     if (client->resolve) {
@@ -523,9 +611,19 @@ static connection_t *connection_add(
     curl_easy_setopt(conn->easy, CURLOPT_HEADERDATA, conn);
     curl_easy_setopt(conn->easy, CURLOPT_ERRORBUFFER, conn->error);
 
-    ogs_assert(client->multi);
-    rc = curl_multi_add_handle(client->multi, conn->easy);
-    mcode_or_die("connection_add: curl_multi_add_handle", rc);
+    /*
+     * Once the stream budget of this peer is used up, the request waits
+     * in the pending list until an earlier one completes. The deadline
+     * timer is already running, so a request can also expire there.
+     */
+    if (client->num_of_stream < client->max_stream) {
+        connection_start(conn);
+    } else {
+        ogs_debug("[%s] %s pending [%d streams]",
+                conn->method, request->h.uri, client->num_of_stream);
+        conn->pending = true;
+        ogs_list_add(&client->pending_list, conn);
+    }
 
     return conn;
 }
@@ -533,23 +631,37 @@ static connection_t *connection_add(
 static void connection_remove(connection_t *conn)
 {
     ogs_sbi_client_t *client = NULL;
+    connection_t *next_conn = NULL;
 
     ogs_assert(conn);
     client = conn->client;
     ogs_assert(client);
 
+    if (conn->pending) {
+        ogs_list_remove(&client->pending_list, conn);
+        connection_free(conn);
+        return;
+    }
+
     ogs_list_remove(&client->connection_list, conn);
 
     ogs_assert(client->multi);
     curl_multi_remove_handle(client->multi, conn->easy);
+    ogs_assert(client->num_of_stream > 0);
+    client->num_of_stream--;
 
     connection_free(conn);
+
+    /* Hand the released stream to the oldest pending request */
+    next_conn = ogs_list_first(&client->pending_list);
+    if (next_conn) {
+        ogs_list_remove(&client->pending_list, next_conn);
+        connection_start(next_conn);
+    }
 }
 
 static void connection_free(connection_t *conn)
 {
-    int i;
-
     ogs_assert(conn);
 
     if (conn->content)
@@ -564,23 +676,17 @@ static void connection_free(connection_t *conn)
         ogs_free(conn->memory);
 
     if (conn->easy)
-        curl_easy_cleanup(conn->easy);
+        easy_put(conn->client, conn->easy);
 
     if (conn->timer)
         ogs_timer_delete(conn->timer);
 
-    if (conn->num_of_header) {
-        for (i = 0; i < conn->num_of_header; i++)
-            if (conn->headers[i])
-                ogs_free(conn->headers[i]);
-        ogs_free(conn->headers);
-    }
     curl_slist_free_all(conn->header_list);
 
     curl_slist_free_all(conn->resolve_list);
 
-    if (conn->method)
-        ogs_free(conn->method);
+    if (conn->method_buf)
+        ogs_free(conn->method_buf);
 
     ogs_pool_free(&connection_pool, conn);
 }
@@ -591,6 +697,9 @@ static void connection_remove_all(ogs_sbi_client_t *client)
 
     ogs_assert(client);
 
+    /* Pending requests first, so that none of them is started */
+    ogs_list_for_each_safe(&client->pending_list, next_conn, conn)
+        connection_remove(conn);
     ogs_list_for_each_safe(&client->connection_list, next_conn, conn)
         connection_remove(conn);
 }
@@ -872,7 +981,9 @@ static void event_cb(short when, ogs_socket_t fd, void *data)
     mcode_or_die("event_cb: curl_multi_socket_action", rc);
 
     check_multi_info(client);
-    if (client->still_running <= 0) {
+
+    /* A pending request may have been started by check_multi_info() */
+    if (client->still_running <= 0 && client->num_of_stream == 0) {
         ogs_timer_t *timer;
 
         timer = client->t_curl;
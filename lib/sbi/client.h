@@ -72,6 +72,10 @@ extern "C" {
         } \
     } while(0)
 
+#define OGS_SBI_CLIENT_MAX_CONNECTIONS 4
+#define OGS_SBI_CLIENT_MAX_CONCURRENT_STREAMS 1000
+#define OGS_SBI_CLIENT_MAX_IDLE_EASY 32
+
 typedef int (*ogs_sbi_client_cb_f)(
         int status, ogs_sbi_response_t *response, void *data);
 
@@ -91,10 +95,18 @@ typedef struct ogs_sbi_client_s {
 
     ogs_timer_t     *t_curl;            /* timer for CURL */
     ogs_list_t      connection_list;    /* CURL connection list */
+    ogs_list_t      pending_list;       /* waiting for a free stream */
 
     void            *multi;             /* CURL multi handle */
     int             still_running;      /* number of running CURL handle */
 
+    int             num_of_stream;      /* requests handed to CURL */
+    int             max_stream;         /* stream budget for this peer */
+
+    /* CURL easy handles kept for the next request */
+    void            *idle_easy[OGS_SBI_CLIENT_MAX_IDLE_EASY];
+    int             num_of_idle_easy;
+
     unsigned int    reference_count;    /* reference count for memory free */
 } ogs_sbi_client_t;
 
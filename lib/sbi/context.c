@@ -49,7 +49,15 @@ void ogs_sbi_context_init(OpenAPI_nf_type_e nf_type)
     ogs_sbi_server_init(ogs_app()->pool.event, ogs_app()->pool.event);
     ogs_sbi_client_init(ogs_app()->pool.event, ogs_app()->pool.event);
 
+    self.client.max_connections = OGS_SBI_CLIENT_MAX_CONNECTIONS;
+    self.client.max_concurrent_streams =
+        OGS_SBI_CLIENT_MAX_CONCURRENT_STREAMS;
+
     ogs_list_init(&self.nf_instance_list);
+    self.nf_instance_id_hash = ogs_hash_make();
+    ogs_assert(self.nf_instance_id_hash);
+    self.nf_instance_index = ogs_hash_make();
+    ogs_assert(self.nf_instance_index);
     ogs_pool_init(&nf_instance_pool, ogs_app()->pool.nf);
     ogs_pool_init(&nf_service_pool, ogs_app()->pool.nf_service);
 
@@ -106,6 +114,11 @@ void ogs_sbi_context_final(void)
 
     ogs_sbi_nf_instance_remove_all();
 
+    ogs_assert(self.nf_instance_id_hash);
+    ogs_hash_destroy(self.nf_instance_id_hash);
+    ogs_assert(self.nf_instance_index);
+    ogs_hash_destroy(self.nf_instance_index);
+
     ogs_pool_final(&nf_instance_pool);
     ogs_pool_final(&nf_service_pool);
     ogs_pool_final(&smf_info_pool);
@@ -146,6 +159,15 @@ static int ogs_sbi_context_validation(
         return OGS_ERROR;
     }
 
+    if (self.client.max_connections <= 0 ||
+        self.client.max_concurrent_streams <= 0) {
+        ogs_error("Invalid default.client [max_connections:%d, "
+                "max_concurrent_streams:%d] in '%s'",
+                self.client.max_connections,
+                self.client.max_concurrent_streams, ogs_app()->file);
+        return OGS_ERROR;
+    }
+
     ogs_assert(context_initialized == 1);
     switch (self.discovery_config.delegated) {
     case OGS_SBI_DISCOVERY_DELEGATED_AUTO:
@@ -342,6 +364,28 @@ int ogs_sbi_context_parse_config(
                                     }
                                 }
                             }
+                        } else if (!strcmp(default_key, "client")) {
+                            ogs_yaml_iter_t client_iter;
+                            ogs_yaml_iter_recurse(&default_iter, &client_iter);
+                            while (ogs_yaml_iter_next(&client_iter)) {
+                                const char *client_key =
+                                    ogs_yaml_iter_key(&client_iter);
+                                ogs_assert(client_key);
+                                if (!strcmp(client_key, "max_connections")) {
+                                    const char *v =
+                                        ogs_yaml_iter_value(&client_iter);
+                                    if (v)
+                                        self.client.max_connections = atoi(v);
+                                } else if (!strcmp(client_key,
+                                            "max_concurrent_streams")) {
+                                    const char *v =
+                                        ogs_yaml_iter_value(&client_iter);
+                                    if (v)
+                                        self.client.max_concurrent_streams =
+                                            atoi(v);
+                                } else
+                                    ogs_warn("unknown key `%s`", client_key);
+                            }
                         }
                     }
                 }
@@ -543,6 +587,10 @@ int ogs_sbi_context_parse_config(
                                     self.discovery_config.
                                         prefer_requester_nf_instance_id =
                                             ogs_yaml_iter_bool(&option_iter);
+                                } else if (!strcmp(option_key,
+                                        "sticky_supi")) {
+                                    self.discovery_config.sticky_supi =
+                                        ogs_yaml_iter_bool(&option_iter);
                                 } else
                                     ogs_warn("unknown key `%s`", option_key);
                             }
@@ -1077,6 +1125,336 @@ bool ogs_sbi_nf_service_is_available(const char *name)
     return false;
 }
 
+/*
+ * Discovery index
+ *
+ * Every NF Instance is posted under its NF type, its PLMNs, and the
+ * nf_info attributes that discovery compares: GUAMI for AMF, S-NSSAI
+ * with DNN and TAI for SMF. An NF Instance that does not restrict an
+ * attribute (no nf_info, no TAI, or a TAC range) is posted under the
+ * wildcard of that attribute instead, as it can match any value.
+ *
+ * Posting lists only narrow down the candidates. Each of them is still
+ * checked by the full matching, so the index never decides on its own.
+ *
+ * nf_info is filled in field by field after ogs_sbi_nf_info_add(),
+ * so a changed NF Instance is only marked with
+ * ogs_sbi_nf_instance_reindex() and posted again before the next lookup.
+ */
+typedef enum {
+    NF_INDEX_TYPE = 1,
+    NF_INDEX_PLMN,
+    NF_INDEX_GUAMI,
+    NF_INDEX_ANY_GUAMI,
+    NF_INDEX_SLICE,
+    NF_INDEX_ANY_SLICE,
+    NF_INDEX_TAI,
+    NF_INDEX_ANY_TAI,
+} nf_index_kind_e;
+
+typedef struct nf_index_key_s {
+    nf_index_kind_e kind;
+    OpenAPI_nf_type_e nf_type;
+    union {
+        ogs_plmn_id_t plmn_id;
+        struct {
+            ogs_plmn_id_t plmn_id;
+            ogs_amf_id_t amf_id;
+        } guami;
+        struct {
+            uint8_t sst;
+            uint32_t sd;
+            char dnn[OGS_MAX_DNN_LEN+1];
+        } slice;
+        struct {
+            ogs_plmn_id_t plmn_id;
+            uint32_t tac;
+        } tai;
+    };
+} nf_index_key_t;
+
+typedef struct nf_index_s {
+    nf_index_key_t key;
+
+    ogs_list_t list;    /* ogs_sbi_nf_posting_t, ordered by index.seq */
+    int count;
+} nf_index_t;
+
+typedef struct ogs_sbi_nf_posting_s {
+    ogs_lnode_t lnode;
+
+    nf_index_t *index;
+    ogs_sbi_nf_instance_t *nf_instance;
+
+    struct ogs_sbi_nf_posting_s *next;  /* next posting of nf_instance */
+} ogs_sbi_nf_posting_t;
+
+static void nf_index_key_init(nf_index_key_t *key,
+        nf_index_kind_e kind, OpenAPI_nf_type_e nf_type)
+{
+    /* The key is hashed as raw bytes, including padding */
+    memset(key, 0, sizeof(*key));
+    key->kind = kind;
+    key->nf_type = nf_type;
+}
+
+static void nf_index_key_set_dnn(nf_index_key_t *key, const char *dnn)
+{
+    int i;
+
+    /* DNNs are compared case-insensitively */
+    for (i = 0; dnn[i] && i < OGS_MAX_DNN_LEN; i++)
+        key->slice.dnn[i] = (dnn[i] >= 'A' && dnn[i] <= 'Z') ?
+            dnn[i] - 'A' + 'a' : dnn[i];
+}
+
+static nf_index_t *nf_index_find(nf_index_key_t *key)
+{
+    return ogs_hash_get(self.nf_instance_index, key, sizeof(*key));
+}
+
+static void nf_index_post(
+        ogs_sbi_nf_instance_t *nf_instance, nf_index_key_t *key)
+{
+    nf_index_t *index = NULL;
+    ogs_sbi_nf_posting_t *posting = NULL, *prev = NULL;
+
+    for (posting = nf_instance->index.posting;
+            posting; posting = posting->next) {
+        if (memcmp(&posting->index->key, key, sizeof(*key)) == 0)
+            return;
+    }
+
+    index = nf_index_find(key);
+    if (!index) {
+        index = ogs_calloc(1, sizeof(*index));
+        ogs_assert(index);
+        memcpy(&index->key, key, sizeof(*key));
+        ogs_list_init(&index->list);
+        ogs_hash_set(self.nf_instance_index,
+                &index->key, sizeof(index->key), index);
+    }
+
+    posting = ogs_calloc(1, sizeof(*posting));
+    ogs_assert(posting);
+    posting->index = index;
+    posting->nf_instance = nf_instance;
+
+    /* Keep the order of nf_instance_list */
+    prev = ogs_list_last(&index->list);
+    while (prev && prev->nf_instance->index.seq > nf_instance->index.seq)
+        prev = ogs_list_prev(prev);
+    if (prev)
+        ogs_list_insert_next(&index->list, prev, posting);
+    else
+        ogs_list_prepend(&index->list, posting);
+    index->count++;
+
+    posting->next = nf_instance->index.posting;
+    nf_instance->index.posting = posting;
+}
+
+static void nf_index_unpost_all(ogs_sbi_nf_instance_t *nf_instance)
+{
+    ogs_sbi_nf_posting_t *posting = NULL, *next = NULL;
+    nf_index_t *index = NULL;
+
+    for (posting = nf_instance->index.posting; posting; posting = next) {
+        next = posting->next;
+
+        index = posting->index;
+        ogs_list_remove(&index->list, posting);
+        if (--index->count == 0) {
+            ogs_hash_set(self.nf_instance_index,
+                    &index->key, sizeof(index->key), NULL);
+            ogs_free(index);
+        }
+
+        ogs_free(posting);
+    }
+
+    nf_instance->index.posting = NULL;
+}
+
+static void nf_index_build(ogs_sbi_nf_instance_t *nf_instance)
+{
+    nf_index_key_t key;
+    ogs_sbi_nf_info_t *nf_info = NULL;
+    OpenAPI_nf_type_e nf_type;
+    bool amf_info = false, smf_info = false, any_tai = false;
+    int i, j;
+
+    nf_index_unpost_all(nf_instance);
+
+    nf_type = nf_instance->nf_type;
+    if (!nf_type)
+        return;
+
+    nf_index_key_init(&key, NF_INDEX_TYPE, nf_type);
+    nf_index_post(nf_instance, &key);
+
+    for (i = 0; i < nf_instance->num_of_plmn_id; i++) {
+        nf_index_key_init(&key, NF_INDEX_PLMN, nf_type);
+        memcpy(&key.plmn_id, &nf_instance->plmn_id[i], OGS_PLMN_ID_LEN);
+        nf_index_post(nf_instance, &key);
+    }
+
+    ogs_list_for_each(&nf_instance->nf_info_list, nf_info) {
+        if (nf_info->nf_type != nf_type)
+            continue;
+
+        switch (nf_info->nf_type) {
+        case OpenAPI_nf_type_AMF:
+            amf_info = true;
+            for (i = 0; i < nf_info->amf.num_of_guami; i++) {
+                nf_index_key_init(&key, NF_INDEX_GUAMI, nf_type);
+                memcpy(&key.guami.plmn_id,
+                        &nf_info->amf.guami[i].plmn_id, OGS_PLMN_ID_LEN);
+                memcpy(&key.guami.amf_id,
+                        &nf_info->amf.guami[i].amf_id, sizeof(ogs_amf_id_t));
+                nf_index_post(nf_instance, &key);
+            }
+            break;
+        case OpenAPI_nf_type_SMF:
+            smf_info = true;
+            for (i = 0; i < nf_info->smf.num_of_slice; i++) {
+                for (j = 0; j < nf_info->smf.slice[i].num_of_dnn; j++) {
+                    if (!nf_info->smf.slice[i].dnn[j])
+                        continue;
+                    nf_index_key_init(&key, NF_INDEX_SLICE, nf_type);
+                    key.slice.sst = nf_info->smf.slice[i].s_nssai.sst;
+                    key.slice.sd = nf_info->smf.slice[i].s_nssai.sd.v;
+                    nf_index_key_set_dnn(&key, nf_info->smf.slice[i].dnn[j]);
+                    nf_index_post(nf_instance, &key);
+                }
+            }
+            if (nf_info->smf.num_of_nr_tai == 0 ||
+                nf_info->smf.num_of_nr_tai_range != 0)
+                any_tai = true;
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (!amf_info) {
+        nf_index_key_init(&key, NF_INDEX_ANY_GUAMI, nf_type);
+        nf_index_post(nf_instance, &key);
+    }
+    if (!smf_info) {
+        nf_index_key_init(&key, NF_INDEX_ANY_SLICE, nf_type);
+        nf_index_post(nf_instance, &key);
+        any_tai = true;
+    }
+
+    if (any_tai) {
+        nf_index_key_init(&key, NF_INDEX_ANY_TAI, nf_type);
+        nf_index_post(nf_instance, &key);
+    } else {
+        ogs_list_for_each(&nf_instance->nf_info_list, nf_info) {
+            if (nf_info->nf_type != nf_type ||
+                nf_info->nf_type != OpenAPI_nf_type_SMF)
+                continue;
+            for (i = 0; i < nf_info->smf.num_of_nr_tai; i++) {
+                nf_index_key_init(&key, NF_INDEX_TAI, nf_type);
+                memcpy(&key.tai.plmn_id,
+                        &nf_info->smf.nr_tai[i].plmn_id, OGS_PLMN_ID_LEN);
+                key.tai.tac = nf_info->smf.nr_tai[i].tac.v;
+                nf_index_post(nf_instance, &key);
+            }
+        }
+    }
+}
+
+static void nf_index_flush(void)
+{
+    ogs_sbi_nf_instance_t *nf_instance = NULL;
+
+    while (self.nf_instance_dirty) {
+        nf_instance = self.nf_instance_dirty;
+        self.nf_instance_dirty = nf_instance->index.next_dirty;
+
+        nf_instance->index.next_dirty = NULL;
+        nf_instance->index.dirty = false;
+
+        nf_index_build(nf_instance);
+    }
+}
+
+static void nf_index_remove(ogs_sbi_nf_instance_t *nf_instance)
+{
+    ogs_sbi_nf_instance_t **p = NULL;
+
+    if (nf_instance->index.dirty) {
+        for (p = &self.nf_instance_dirty; *p; p = &(*p)->index.next_dirty) {
+            if (*p == nf_instance) {
+                *p = nf_instance->index.next_dirty;
+                break;
+            }
+        }
+        nf_instance->index.dirty = false;
+    }
+
+    nf_index_unpost_all(nf_instance);
+}
+
+/*
+ * The id hash points at the first NF Instance in nf_instance_list with
+ * that id, which is the one the list scan used to find. The others with
+ * the same id follow it on index.next_same_id in the list order. The key
+ * is the id string of the first NF Instance, so the entry is deleted
+ * before it is pointed at another NF Instance.
+ */
+static void nf_id_hash_add(ogs_sbi_nf_instance_t *nf_instance)
+{
+    ogs_sbi_nf_instance_t *first = NULL, **p = NULL;
+
+    first = ogs_hash_get(self.nf_instance_id_hash,
+            nf_instance->id, OGS_HASH_KEY_STRING);
+    if (first && first->index.seq < nf_instance->index.seq) {
+        p = &first->index.next_same_id;
+        while (*p && (*p)->index.seq < nf_instance->index.seq)
+            p = &(*p)->index.next_same_id;
+        nf_instance->index.next_same_id = *p;
+        *p = nf_instance;
+        return;
+    }
+
+    if (first)
+        ogs_hash_set(self.nf_instance_id_hash,
+                first->id, OGS_HASH_KEY_STRING, NULL);
+    nf_instance->index.next_same_id = first;
+    ogs_hash_set(self.nf_instance_id_hash,
+            nf_instance->id, OGS_HASH_KEY_STRING, nf_instance);
+}
+
+static void nf_id_hash_remove(ogs_sbi_nf_instance_t *nf_instance)
+{
+    ogs_sbi_nf_instance_t *first = NULL, *next = NULL, **p = NULL;
+
+    first = ogs_hash_get(self.nf_instance_id_hash,
+            nf_instance->id, OGS_HASH_KEY_STRING);
+    next = nf_instance->index.next_same_id;
+    nf_instance->index.next_same_id = NULL;
+
+    if (first == nf_instance) {
+        ogs_hash_set(self.nf_instance_id_hash,
+                nf_instance->id, OGS_HASH_KEY_STRING, NULL);
+        if (next)
+            ogs_hash_set(self.nf_instance_id_hash,
+                    next->id, OGS_HASH_KEY_STRING, next);
+        return;
+    }
+
+    for (p = first ? &first->index.next_same_id : NULL;
+            p && *p; p = &(*p)->index.next_same_id) {
+        if (*p == nf_instance) {
+            *p = next;
+            break;
+        }
+    }
+}
+
 ogs_sbi_nf_instance_t *ogs_sbi_nf_instance_add(void)
 {
     ogs_sbi_nf_instance_t *nf_instance = NULL;
@@ -1094,6 +1472,9 @@ ogs_sbi_nf_instance_t *ogs_sbi_nf_instance_add(void)
 
     ogs_list_add(&ogs_sbi_self()->nf_instance_list, nf_instance);
 
+    nf_instance->index.seq = self.nf_instance_seq++;
+    ogs_sbi_nf_instance_reindex(nf_instance);
+
     ogs_debug("[%s] NFInstance added with Ref [%s]",
             nf_instance->nf_type ?
                 OpenAPI_nf_type_ToString(nf_instance->nf_type) : "NULL",
@@ -1107,8 +1488,15 @@ void ogs_sbi_nf_instance_set_id(ogs_sbi_nf_instance_t *nf_instance, char *id)
     ogs_assert(nf_instance);
     ogs_assert(id);
 
+    if (nf_instance->id) {
+        nf_id_hash_remove(nf_instance);
+        ogs_free(nf_instance->id);
+    }
+
     nf_instance->id = ogs_strdup(id);
     ogs_assert(nf_instance->id);
+
+    nf_id_hash_add(nf_instance);
 }
 
 void ogs_sbi_nf_instance_set_type(
@@ -1118,6 +1506,7 @@ void ogs_sbi_nf_instance_set_type(
     ogs_assert(nf_type);
 
     nf_instance->nf_type = nf_type;
+    ogs_sbi_nf_instance_reindex(nf_instance);
 }
 
 void ogs_sbi_nf_instance_set_status(
@@ -1188,6 +1577,8 @@ void ogs_sbi_nf_instance_clear(ogs_sbi_nf_instance_t *nf_instance)
     nf_instance->num_of_ipv6 = 0;
 
     nf_instance->num_of_allowed_nf_type = 0;
+
+    ogs_sbi_nf_instance_invalidate_nf_profile_json(nf_instance);
 }
 
 void ogs_sbi_nf_instance_remove(ogs_sbi_nf_instance_t *nf_instance)
@@ -1200,6 +1591,7 @@ void ogs_sbi_nf_instance_remove(ogs_sbi_nf_instance_t *nf_instance)
             nf_instance->id);
 
     ogs_list_remove(&ogs_sbi_self()->nf_instance_list, nf_instance);
+    nf_index_remove(nf_instance);
 
     ogs_sbi_nf_info_remove_all(&nf_instance->nf_info_list);
 
@@ -1208,6 +1600,7 @@ void ogs_sbi_nf_instance_remove(ogs_sbi_nf_instance_t *nf_instance)
     ogs_sbi_nf_instance_clear(nf_instance);
 
     if (nf_instance->id) {
+        nf_id_hash_remove(nf_instance);
         ogs_sbi_subscription_data_remove_all_by_nf_instance_id(nf_instance->id);
         ogs_free(nf_instance->id);
     }
@@ -1229,38 +1622,162 @@ void ogs_sbi_nf_instance_remove_all(void)
 
 ogs_sbi_nf_instance_t *ogs_sbi_nf_instance_find(char *id)
 {
-    ogs_sbi_nf_instance_t *nf_instance = NULL;
-
     ogs_assert(id);
 
-    ogs_list_for_each(&ogs_sbi_self()->nf_instance_list, nf_instance) {
-        if (nf_instance->id && strcmp(nf_instance->id, id) == 0)
-            break;
+    return ogs_hash_get(self.nf_instance_id_hash, id, OGS_HASH_KEY_STRING);
+}
+
+/*
+ * NF Selection
+ *
+ * Only the NF Instances with the best (lowest) priority are considered.
+ * Among them, one is picked at random with a weight of its capacity
+ * scaled by the spare part of its reported load (TS29.510 NFProfile).
+ *
+ * With a sticky key (e.g. SUPI), the random draw is replaced with
+ * weighted rendezvous hashing on the key and the NF Instance ID, using
+ * the capacity alone, so that the same key keeps landing on the same
+ * NF Instance while the load goes up and down, and only the keys of
+ * a removed NF Instance move elsewhere.
+ */
+static uint64_t nf_select_weight(
+        ogs_sbi_nf_instance_t *nf_instance, bool sticky)
+{
+    uint64_t weight;
+    int load;
+
+    weight = nf_instance->capacity > 0 ? nf_instance->capacity : 0;
+
+    if (sticky == false) {
+        load = ogs_max(ogs_min(nf_instance->load, 100), 0);
+        weight *= (100 - load);
     }
 
-    return nf_instance;
+    return weight ? weight : 1;
 }
 
-ogs_sbi_nf_instance_t *ogs_sbi_nf_instance_find_by_discovery_param(
+/* -log2(u / 2^32) in Q16 fixed point, u > 0 */
+static uint32_t nf_select_neg_log2(uint32_t u)
+{
+    uint32_t shift = 0, frac = 0;
+    uint64_t y;
+    int i;
+
+    ogs_assert(u);
+
+    while (!(u & 0x80000000)) {
+        u <<= 1;
+        shift++;
+    }
+
+    /* u/2^31 is in [1,2), so log2() of it is in [0,1) */
+    y = u;
+    for (i = 0; i < 16; i++) {
+        y = (y * y) >> 31;
+        frac <<= 1;
+        if (y >= ((uint64_t)1 << 32)) {
+            y >>= 1;
+            frac |= 1;
+        }
+    }
+
+    return ((shift + 1) << 16) - frac;
+}
+
+static uint32_t nf_select_hash(uint32_t key_hash, const char *id)
+{
+    int klen = OGS_HASH_KEY_STRING;
+    uint32_t h;
+
+    h = key_hash ^ (ogs_hashfunc_default(id, &klen) * 0x9e3779b1);
+
+    /* MurmurHash3 finalizer */
+    h ^= h >> 16;
+    h *= 0x85ebca6b;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35;
+    h ^= h >> 16;
+
+    return h ? h : 1;
+}
+
+ogs_sbi_nf_instance_t *ogs_sbi_nf_instance_select(
         OpenAPI_nf_type_e target_nf_type,
         OpenAPI_nf_type_e requester_nf_type,
-        ogs_sbi_discovery_option_t *discovery_option)
+        ogs_sbi_discovery_option_t *discovery_option,
+        const char *sticky_key)
 {
-    ogs_sbi_nf_instance_t *nf_instance = NULL;
+    ogs_sbi_nf_instance_t *nf_instance = NULL, *selected = NULL;
+    ogs_sbi_nf_instance_cursor_t cursor;
+    uint64_t weight, total = 0, score, best_weight = 0, best_score = 0;
+    uint32_t key_hash = 0;
+    int klen = OGS_HASH_KEY_STRING;
+    bool sticky = false;
 
     ogs_assert(target_nf_type);
     ogs_assert(requester_nf_type);
 
-    ogs_list_for_each(&ogs_sbi_self()->nf_instance_list, nf_instance) {
+    if (sticky_key) {
+        sticky = true;
+        key_hash = ogs_hashfunc_default(sticky_key, &klen);
+    }
+
+    ogs_sbi_nf_instance_cursor_init(&cursor,
+            target_nf_type, requester_nf_type, discovery_option);
+    while ((nf_instance = ogs_sbi_nf_instance_cursor_next(&cursor))) {
         if (ogs_sbi_discovery_param_is_matched(
                     nf_instance, target_nf_type, requester_nf_type,
                     discovery_option) == false)
             continue;
 
-        return nf_instance;
+        if (selected && nf_instance->priority > selected->priority)
+            continue;
+
+        if (selected && nf_instance->priority < selected->priority)
+            selected = NULL;
+
+        weight = nf_select_weight(nf_instance, sticky);
+
+        if (sticky == true) {
+            /* Pick the smallest -ln(u)/weight, cross-multiplied */
+            score = nf_select_neg_log2(nf_select_hash(
+                        key_hash, nf_instance->id ? nf_instance->id : ""));
+            if (!selected || score * best_weight < best_score * weight) {
+                selected = nf_instance;
+                best_score = score;
+                best_weight = weight;
+            }
+        } else {
+            /* Weighted reservoir sampling, a single pass */
+            if (!selected)
+                total = 0;
+            total += weight;
+            if (((((uint64_t)ogs_random32()) << 32) |
+                        ogs_random32()) % total < weight)
+                selected = nf_instance;
+        }
     }
 
-    return NULL;
+    if (selected) {
+        selected->selection_count++;
+        ogs_debug("[%s] NF selected [%s:%s] priority[%d] capacity[%d] "
+                "load[%d] count[%llu]", selected->id,
+                OpenAPI_nf_type_ToString(target_nf_type),
+                sticky_key ? sticky_key : "random",
+                selected->priority, selected->capacity, selected->load,
+                (unsigned long long)selected->selection_count);
+    }
+
+    return selected;
+}
+
+ogs_sbi_nf_instance_t *ogs_sbi_nf_instance_find_by_discovery_param(
+        OpenAPI_nf_type_e target_nf_type,
+        OpenAPI_nf_type_e requester_nf_type,
+        ogs_sbi_discovery_option_t *discovery_option)
+{
+    return ogs_sbi_nf_instance_select(target_nf_type, requester_nf_type,
+            discovery_option, NULL);
 }
 
 ogs_sbi_nf_instance_t *ogs_sbi_nf_instance_find_by_service_type(
@@ -1297,6 +1814,152 @@ bool ogs_sbi_nf_instance_maximum_number_is_reached(void)
     return nf_instance_pool.avail <= 0;
 }
 
+void ogs_sbi_nf_instance_reindex(ogs_sbi_nf_instance_t *nf_instance)
+{
+    ogs_assert(nf_instance);
+
+    if (nf_instance->index.dirty)
+        return;
+
+    nf_instance->index.dirty = true;
+    nf_instance->index.next_dirty = self.nf_instance_dirty;
+    self.nf_instance_dirty = nf_instance;
+}
+
+void ogs_sbi_nf_instance_invalidate_nf_profile_json(
+        ogs_sbi_nf_instance_t *nf_instance)
+{
+    int i;
+
+    ogs_assert(nf_instance);
+
+    for (i = 0; i < OGS_ARRAY_SIZE(nf_instance->nf_profile_json); i++) {
+        if (nf_instance->nf_profile_json[i])
+            ogs_free(nf_instance->nf_profile_json[i]);
+        nf_instance->nf_profile_json[i] = NULL;
+    }
+}
+
+static void cursor_narrow(ogs_sbi_nf_instance_cursor_t *cursor, int *count,
+        nf_index_key_t *key, nf_index_kind_e any_kind)
+{
+    nf_index_key_t any_key;
+    nf_index_t *index = NULL, *any = NULL;
+    int n = 0;
+
+    index = nf_index_find(key);
+    if (index)
+        n += index->count;
+
+    if (any_kind) {
+        nf_index_key_init(&any_key, any_kind, key->nf_type);
+        any = nf_index_find(&any_key);
+        if (any)
+            n += any->count;
+    }
+
+    if (*count < 0 || n < *count) {
+        *count = n;
+        cursor->posting[0] = index ? ogs_list_first(&index->list) : NULL;
+        cursor->posting[1] = any ? ogs_list_first(&any->list) : NULL;
+    }
+}
+
+void ogs_sbi_nf_instance_cursor_init(ogs_sbi_nf_instance_cursor_t *cursor,
+        OpenAPI_nf_type_e target_nf_type,
+        OpenAPI_nf_type_e requester_nf_type,
+        ogs_sbi_discovery_option_t *discovery_option)
+{
+    nf_index_key_t key;
+    int count = -1;
+
+    ogs_assert(cursor);
+    ogs_assert(target_nf_type);
+
+    memset(cursor, 0, sizeof(*cursor));
+
+    nf_index_flush();
+
+    if (discovery_option && discovery_option->target_nf_instance_id) {
+        cursor->nf_instance = ogs_sbi_nf_instance_find(
+                discovery_option->target_nf_instance_id);
+        return;
+    }
+
+    nf_index_key_init(&key, NF_INDEX_TYPE, target_nf_type);
+    cursor_narrow(cursor, &count, &key, 0);
+
+    if (!discovery_option)
+        return;
+
+    if (target_nf_type == OpenAPI_nf_type_AMF &&
+        requester_nf_type == OpenAPI_nf_type_AMF &&
+        discovery_option->guami_presence) {
+        nf_index_key_init(&key, NF_INDEX_GUAMI, target_nf_type);
+        memcpy(&key.guami.plmn_id,
+                &discovery_option->guami.plmn_id, OGS_PLMN_ID_LEN);
+        memcpy(&key.guami.amf_id,
+                &discovery_option->guami.amf_id, sizeof(ogs_amf_id_t));
+        cursor_narrow(cursor, &count, &key, NF_INDEX_ANY_GUAMI);
+    }
+
+    if (target_nf_type == OpenAPI_nf_type_SMF) {
+        if (discovery_option->num_of_snssais && discovery_option->dnn) {
+            nf_index_key_init(&key, NF_INDEX_SLICE, target_nf_type);
+            key.slice.sst = discovery_option->snssais[0].sst;
+            key.slice.sd = discovery_option->snssais[0].sd.v;
+            nf_index_key_set_dnn(&key, discovery_option->dnn);
+            cursor_narrow(cursor, &count, &key, NF_INDEX_ANY_SLICE);
+        }
+        if (discovery_option->tai_presence) {
+            nf_index_key_init(&key, NF_INDEX_TAI, target_nf_type);
+            memcpy(&key.tai.plmn_id,
+                    &discovery_option->tai.plmn_id, OGS_PLMN_ID_LEN);
+            key.tai.tac = discovery_option->tai.tac.v;
+            cursor_narrow(cursor, &count, &key, NF_INDEX_ANY_TAI);
+        }
+    }
+
+    if (discovery_option->num_of_target_plmn_list == 1) {
+        nf_index_key_init(&key, NF_INDEX_PLMN, target_nf_type);
+        memcpy(&key.plmn_id,
+                &discovery_option->target_plmn_list[0], OGS_PLMN_ID_LEN);
+        cursor_narrow(cursor, &count, &key, 0);
+    }
+}
+
+ogs_sbi_nf_instance_t *ogs_sbi_nf_instance_cursor_next(
+        ogs_sbi_nf_instance_cursor_t *cursor)
+{
+    ogs_sbi_nf_instance_t *nf_instance = NULL;
+    ogs_sbi_nf_posting_t *posting = NULL;
+    int i;
+
+    ogs_assert(cursor);
+
+    if (cursor->nf_instance) {
+        nf_instance = cursor->nf_instance;
+        cursor->nf_instance = nf_instance->index.next_same_id;
+        return nf_instance;
+    }
+
+    /* Merge the two posting lists by their order in nf_instance_list */
+    if (cursor->posting[0] && cursor->posting[1])
+        i = cursor->posting[0]->nf_instance->index.seq <
+            cursor->posting[1]->nf_instance->index.seq ? 0 : 1;
+    else if (cursor->posting[0])
+        i = 0;
+    else if (cursor->posting[1])
+        i = 1;
+    else
+        return NULL;
+
+    posting = cursor->posting[i];
+    cursor->posting[i] = ogs_list_next(posting);
+
+    return posting->nf_instance;
+}
+
 ogs_sbi_nf_service_t *ogs_sbi_nf_service_add(
         ogs_sbi_nf_instance_t *nf_instance,
         char *id, const char *name, OpenAPI_uri_scheme_e scheme)
@@ -45,6 +45,7 @@ typedef struct ogs_sbi_discovery_config_s {
     ogs_sbi_discovery_delegated_mode delegated;
     bool no_service_names;
     bool prefer_requester_nf_instance_id;
+    bool sticky_supi;
 } ogs_sbi_discovery_config_t;
 
 typedef struct ogs_sbi_context_s {
@@ -80,12 +81,22 @@ typedef struct ogs_sbi_context_s {
         } client;
     } tls;
 
+    struct {
+        int max_connections;        /* HTTP/2 connections per NF */
+        int max_concurrent_streams; /* requests in flight per NF */
+    } client;
+
     ogs_list_t server_list;
     ogs_list_t client_list;
 
     ogs_uuid_t uuid;
 
     ogs_list_t nf_instance_list;
+    ogs_hash_t *nf_instance_id_hash;        /* hash table (NF Instance ID) */
+    ogs_hash_t *nf_instance_index;          /* discovery index */
+    ogs_sbi_nf_instance_t *nf_instance_dirty; /* waiting to be re-indexed */
+    uint64_t nf_instance_seq;
+
     ogs_list_t subscription_spec_list;
     ogs_list_t subscription_data_list;
 
@@ -169,14 +180,41 @@ typedef struct ogs_sbi_nf_instance_s {
     int capacity;
     int load;
 
+    /* Times picked by ogs_sbi_nf_instance_select() */
+    uint64_t selection_count;
+
     ogs_list_t nf_service_list;
     ogs_list_t nf_info_list;
 
 #define NF_INSTANCE_CLIENT(__nFInstance) \
     ((__nFInstance) ? ((__nFInstance)->client) : NULL)
     void *client;                       /* only used in CLIENT */
+
+    /* Discovery index, see ogs_sbi_nf_instance_reindex() */
+    struct {
+        uint64_t seq;                   /* order in nf_instance_list */
+        bool dirty;
+        ogs_sbi_nf_instance_t *next_dirty;
+        struct ogs_sbi_nf_posting_s *posting;
+        ogs_sbi_nf_instance_t *next_same_id;
+    } index;
+
+    /* NFProfile JSON cached by the NRF for discovery responses,
+     * [0] with nfServices, [1] with nfServiceList (service-map) */
+    char *nf_profile_json[2];
 } ogs_sbi_nf_instance_t;
 
+/*
+ * Walks the NF Instances that may match a discovery, in the order
+ * of nf_instance_list. The candidates still have to be checked with
+ * ogs_sbi_discovery_param_is_matched() or equivalent, and
+ * NF Instances must not be added or removed while walking.
+ */
+typedef struct ogs_sbi_nf_instance_cursor_s {
+    ogs_sbi_nf_instance_t *nf_instance;
+    struct ogs_sbi_nf_posting_s *posting[2];
+} ogs_sbi_nf_instance_cursor_t;
+
 typedef enum {
     OGS_SBI_OBJ_BASE = 0,
 
@@ -417,10 +455,24 @@ ogs_sbi_nf_instance_t *ogs_sbi_nf_instance_find_by_discovery_param(
         OpenAPI_nf_type_e nf_type,
         OpenAPI_nf_type_e requester_nf_type,
         ogs_sbi_discovery_option_t *discovery_option);
+ogs_sbi_nf_instance_t *ogs_sbi_nf_instance_select(
+        OpenAPI_nf_type_e nf_type,
+        OpenAPI_nf_type_e requester_nf_type,
+        ogs_sbi_discovery_option_t *discovery_option,
+        const char *sticky_key);
 ogs_sbi_nf_instance_t *ogs_sbi_nf_instance_find_by_service_type(
         ogs_sbi_service_type_e service_type,
         OpenAPI_nf_type_e requester_nf_type);
 bool ogs_sbi_nf_instance_maximum_number_is_reached(void);
+void ogs_sbi_nf_instance_reindex(ogs_sbi_nf_instance_t *nf_instance);
+void ogs_sbi_nf_instance_invalidate_nf_profile_json(
+        ogs_sbi_nf_instance_t *nf_instance);
+void ogs_sbi_nf_instance_cursor_init(ogs_sbi_nf_instance_cursor_t *cursor,
+        OpenAPI_nf_type_e target_nf_type,
+        OpenAPI_nf_type_e requester_nf_type,
+        ogs_sbi_discovery_option_t *discovery_option);
+ogs_sbi_nf_instance_t *ogs_sbi_nf_instance_cursor_next(
+        ogs_sbi_nf_instance_cursor_t *cursor);
 
 ogs_sbi_nf_service_t *ogs_sbi_nf_service_add(
         ogs_sbi_nf_instance_t *nf_instance,
@@ -1151,11 +1151,13 @@ static char *build_json(ogs_sbi_message_t *message)
     ogs_assert(message);
 
     if (message->ProblemDetails) {
-        item = OpenAPI_problem_details_convertToJSON(message->ProblemDetails);
-        ogs_assert(item);
+        content = OpenAPI_stream_print(&OpenAPI_problem_details_stream,
+                message->ProblemDetails);
+        ogs_assert(content);
     } else if (message->NFProfile) {
-        item = OpenAPI_nf_profile_convertToJSON(message->NFProfile);
-        ogs_assert(item);
+        content = OpenAPI_stream_print(&OpenAPI_nf_profile_stream,
+                message->NFProfile);
+        ogs_assert(content);
     } else if (message->PatchItemList) {
         OpenAPI_lnode_t *node = NULL;
 
@@ -1168,105 +1170,116 @@ static char *build_json(ogs_sbi_message_t *message)
             cJSON_AddItemToArray(item, patchItem);
         }
     } else if (message->SubscriptionData) {
-        item = OpenAPI_subscription_data_convertToJSON(
+        content = OpenAPI_stream_print(&OpenAPI_subscription_data_stream,
                 message->SubscriptionData);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->NotificationData) {
-        item = OpenAPI_notification_data_convertToJSON(
+        content = OpenAPI_stream_print(&OpenAPI_notification_data_stream,
                 message->NotificationData);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->SearchResult) {
-        item = OpenAPI_search_result_convertToJSON(message->SearchResult);
-        ogs_assert(item);
+        content = OpenAPI_stream_print(&OpenAPI_search_result_stream,
+                message->SearchResult);
+        ogs_assert(content);
     } else if (message->links) {
         item = ogs_sbi_links_convertToJSON(message->links);
         ogs_assert(item);
     } else if (message->AuthenticationInfo) {
-        item = OpenAPI_authentication_info_convertToJSON(
+        content = OpenAPI_stream_print(&OpenAPI_authentication_info_stream,
                 message->AuthenticationInfo);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->AuthenticationInfoRequest) {
-        item = OpenAPI_authentication_info_request_convertToJSON(
+        content = OpenAPI_stream_print(
+                &OpenAPI_authentication_info_request_stream,
                 message->AuthenticationInfoRequest);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->AuthenticationInfoResult) {
-        item = OpenAPI_authentication_info_result_convertToJSON(
+        content = OpenAPI_stream_print(
+                &OpenAPI_authentication_info_result_stream,
                 message->AuthenticationInfoResult);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->AuthenticationSubscription) {
-        item = OpenAPI_authentication_subscription_convertToJSON(
+        content = OpenAPI_stream_print(
+                &OpenAPI_authentication_subscription_stream,
                 message->AuthenticationSubscription);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->UeAuthenticationCtx) {
-        item = OpenAPI_ue_authentication_ctx_convertToJSON(
+        content = OpenAPI_stream_print(&OpenAPI_ue_authentication_ctx_stream,
                 message->UeAuthenticationCtx);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->ConfirmationData) {
-        item = OpenAPI_confirmation_data_convertToJSON(
+        content = OpenAPI_stream_print(&OpenAPI_confirmation_data_stream,
                 message->ConfirmationData);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->ConfirmationDataResponse) {
-        item = OpenAPI_confirmation_data_response_convertToJSON(
+        content = OpenAPI_stream_print(
+                &OpenAPI_confirmation_data_response_stream,
                 message->ConfirmationDataResponse);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->AuthEvent) {
-        item = OpenAPI_auth_event_convertToJSON(message->AuthEvent);
-        ogs_assert(item);
+        content = OpenAPI_stream_print(&OpenAPI_auth_event_stream,
+                message->AuthEvent);
+        ogs_assert(content);
     } else if (message->Amf3GppAccessRegistration) {
-        item = OpenAPI_amf3_gpp_access_registration_convertToJSON(
+        content = OpenAPI_stream_print(
+                &OpenAPI_amf3_gpp_access_registration_stream,
                 message->Amf3GppAccessRegistration);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->Amf3GppAccessRegistrationModification) {
-        item = OpenAPI_amf3_gpp_access_registration_modification_convertToJSON(
+        content = OpenAPI_stream_print(
+                &OpenAPI_amf3_gpp_access_registration_modification_stream,
                 message->Amf3GppAccessRegistrationModification);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->SmfRegistration) {
-        item = OpenAPI_smf_registration_convertToJSON(message->SmfRegistration);
-        ogs_assert(item);
+        content = OpenAPI_stream_print(&OpenAPI_smf_registration_stream,
+                message->SmfRegistration);
+        ogs_assert(content);
     } else if (message->AccessAndMobilitySubscriptionData) {
-        item = OpenAPI_access_and_mobility_subscription_data_convertToJSON(
+        content = OpenAPI_stream_print(
+                &OpenAPI_access_and_mobility_subscription_data_stream,
                 message->AccessAndMobilitySubscriptionData);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->SmfSelectionSubscriptionData) {
-        item = OpenAPI_smf_selection_subscription_data_convertToJSON(
+        content = OpenAPI_stream_print(
+                &OpenAPI_smf_selection_subscription_data_stream,
                 message->SmfSelectionSubscriptionData);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->UeContextInSmfData) {
-        item = OpenAPI_ue_context_in_smf_data_convertToJSON(
+        content = OpenAPI_stream_print(&OpenAPI_ue_context_in_smf_data_stream,
                 message->UeContextInSmfData);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->SmContextCreateData) {
-        item = OpenAPI_sm_context_create_data_convertToJSON(
+        content = OpenAPI_stream_print(&OpenAPI_sm_context_create_data_stream,
                 message->SmContextCreateData);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->SmContextCreatedData) {
-        item = OpenAPI_sm_context_created_data_convertToJSON(
+        content = OpenAPI_stream_print(&OpenAPI_sm_context_created_data_stream,
                 message->SmContextCreatedData);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->SmContextCreateError) {
-        item = OpenAPI_sm_context_create_error_convertToJSON(
+        content = OpenAPI_stream_print(&OpenAPI_sm_context_create_error_stream,
                 message->SmContextCreateError);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->SmContextUpdateData) {
-        item = OpenAPI_sm_context_update_data_convertToJSON(
+        content = OpenAPI_stream_print(&OpenAPI_sm_context_update_data_stream,
                 message->SmContextUpdateData);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->SmContextUpdatedData) {
-        item = OpenAPI_sm_context_updated_data_convertToJSON(
+        content = OpenAPI_stream_print(&OpenAPI_sm_context_updated_data_stream,
                 message->SmContextUpdatedData);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->SmContextUpdateError) {
-        item = OpenAPI_sm_context_update_error_convertToJSON(
+        content = OpenAPI_stream_print(&OpenAPI_sm_context_update_error_stream,
                 message->SmContextUpdateError);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->SmContextReleaseData) {
-        item = OpenAPI_sm_context_release_data_convertToJSON(
+        content = OpenAPI_stream_print(&OpenAPI_sm_context_release_data_stream,
                 message->SmContextReleaseData);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->SmContextReleasedData) {
-        item = OpenAPI_sm_context_released_data_convertToJSON(
+        content = OpenAPI_stream_print(&OpenAPI_sm_context_released_data_stream,
                 message->SmContextReleasedData);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->SessionManagementSubscriptionDataList) {
         OpenAPI_lnode_t *node = NULL;
 
@@ -1280,110 +1293,154 @@ static char *build_json(ogs_sbi_message_t *message)
             cJSON_AddItemToArray(item, smSubDataItem);
         }
     } else if (message->N1N2MessageTransferReqData) {
-        item = OpenAPI_n1_n2_message_transfer_req_data_convertToJSON(
+        content = OpenAPI_stream_print(
+                &OpenAPI_n1_n2_message_transfer_req_data_stream,
                 message->N1N2MessageTransferReqData);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->N1N2MessageTransferRspData) {
-        item = OpenAPI_n1_n2_message_transfer_rsp_data_convertToJSON(
+        content = OpenAPI_stream_print(
+                &OpenAPI_n1_n2_message_transfer_rsp_data_stream,
                 message->N1N2MessageTransferRspData);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->N1N2MsgTxfrFailureNotification) {
-        item = OpenAPI_n1_n2_msg_txfr_failure_notification_convertToJSON(
+        content = OpenAPI_stream_print(
+                &OpenAPI_n1_n2_msg_txfr_failure_notification_stream,
                 message->N1N2MsgTxfrFailureNotification);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->SmContextStatusNotification) {
-        item = OpenAPI_sm_context_status_notification_convertToJSON(
+        content = OpenAPI_stream_print(
+                &OpenAPI_sm_context_status_notification_stream,
                 message->SmContextStatusNotification);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->PolicyAssociationRequest) {
-        item = OpenAPI_policy_association_request_convertToJSON(
+        content = OpenAPI_stream_print(
+                &OpenAPI_policy_association_request_stream,
                 message->PolicyAssociationRequest);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->PolicyAssociation) {
-        item = OpenAPI_policy_association_convertToJSON(
+        content = OpenAPI_stream_print(&OpenAPI_policy_association_stream,
                 message->PolicyAssociation);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->AmPolicyData) {
-        item = OpenAPI_am_policy_data_convertToJSON(message->AmPolicyData);
-        ogs_assert(item);
+        content = OpenAPI_stream_print(&OpenAPI_am_policy_data_stream,
+                message->AmPolicyData);
+        ogs_assert(content);
     } else if (message->SmPolicyContextData) {
-        item = OpenAPI_sm_policy_context_data_convertToJSON(
+        content = OpenAPI_stream_print(&OpenAPI_sm_policy_context_data_stream,
                 message->SmPolicyContextData);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->SmPolicyDecision) {
-        item = OpenAPI_sm_policy_decision_convertToJSON(
+        content = OpenAPI_stream_print(&OpenAPI_sm_policy_decision_stream,
                 message->SmPolicyDecision);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->SmPolicyData) {
-        item = OpenAPI_sm_policy_data_convertToJSON(message->SmPolicyData);
-        ogs_assert(item);
+        content = OpenAPI_stream_print(&OpenAPI_sm_policy_data_stream,
+                message->SmPolicyData);
+        ogs_assert(content);
     } else if (message->SmPolicyDeleteData) {
-        item = OpenAPI_sm_policy_delete_data_convertToJSON(
+        content = OpenAPI_stream_print(&OpenAPI_sm_policy_delete_data_stream,
                 message->SmPolicyDeleteData);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->AuthorizedNetworkSliceInfo) {
-        item = OpenAPI_authorized_network_slice_info_convertToJSON(
+        content = OpenAPI_stream_print(
+                &OpenAPI_authorized_network_slice_info_stream,
                 message->AuthorizedNetworkSliceInfo);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->PcfBinding) {
-        item = OpenAPI_pcf_binding_convertToJSON(message->PcfBinding);
-        ogs_assert(item);
+        content = OpenAPI_stream_print(&OpenAPI_pcf_binding_stream,
+                message->PcfBinding);
+        ogs_assert(content);
     } else if (message->AppSessionContext) {
-        item = OpenAPI_app_session_context_convertToJSON(
+        content = OpenAPI_stream_print(&OpenAPI_app_session_context_stream,
                 message->AppSessionContext);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->AppSessionContextUpdateDataPatch) {
-        item = OpenAPI_app_session_context_update_data_patch_convertToJSON(
+        content = OpenAPI_stream_print(
+                &OpenAPI_app_session_context_update_data_patch_stream,
                 message->AppSessionContextUpdateDataPatch);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->SmPolicyNotification) {
-        item = OpenAPI_sm_policy_notification_convertToJSON(
+        content = OpenAPI_stream_print(&OpenAPI_sm_policy_notification_stream,
                 message->SmPolicyNotification);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->TerminationNotification) {
-        item = OpenAPI_termination_notification_convertToJSON(
+        content = OpenAPI_stream_print(&OpenAPI_termination_notification_stream,
                 message->TerminationNotification);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->DeregistrationData) {
-        item = OpenAPI_deregistration_data_convertToJSON(
+        content = OpenAPI_stream_print(&OpenAPI_deregistration_data_stream,
                 message->DeregistrationData);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->SDMSubscription) {
-        item = OpenAPI_sdm_subscription_convertToJSON(
+        content = OpenAPI_stream_print(&OpenAPI_sdm_subscription_stream,
                 message->SDMSubscription);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->ModificationNotification) {
-        item = OpenAPI_modification_notification_convertToJSON(
-            message->ModificationNotification);
-        ogs_assert(item);
+        content = OpenAPI_stream_print(
+                &OpenAPI_modification_notification_stream,
+                message->ModificationNotification);
+        ogs_assert(content);
     } else if (message->SecNegotiateReqData) {
-        item = OpenAPI_sec_negotiate_req_data_convertToJSON(
-            message->SecNegotiateReqData);
-        ogs_assert(item);
+        content = OpenAPI_stream_print(&OpenAPI_sec_negotiate_req_data_stream,
+                message->SecNegotiateReqData);
+        ogs_assert(content);
     } else if (message->SecNegotiateRspData) {
-        item = OpenAPI_sec_negotiate_rsp_data_convertToJSON(
-            message->SecNegotiateRspData);
-        ogs_assert(item);
+        content = OpenAPI_stream_print(&OpenAPI_sec_negotiate_rsp_data_stream,
+                message->SecNegotiateRspData);
+        ogs_assert(content);
     } else if (message->UeContextTransferReqData) {
-        item = OpenAPI_ue_context_transfer_req_data_convertToJSON(
+        content = OpenAPI_stream_print(
+                &OpenAPI_ue_context_transfer_req_data_stream,
                 message->UeContextTransferReqData);
-        ogs_assert(item);
+        ogs_assert(content);
     } else if (message->UeContextTransferRspData) {
-        item = OpenAPI_ue_context_transfer_rsp_data_convertToJSON(
+        content = OpenAPI_stream_print(
+                &OpenAPI_ue_context_transfer_rsp_data_stream,
                 message->UeContextTransferRspData);
-        ogs_assert(item);
+        ogs_assert(content);
     }
 
     if (item) {
         content = cJSON_PrintUnformatted(item);
         ogs_assert(content);
-        ogs_log_print(OGS_LOG_TRACE, "%s", content);
         cJSON_Delete(item);
     }
 
+    if (content)
+        ogs_log_print(OGS_LOG_TRACE, "%s", content);
+
     return content;
 }
 
+/*
+ * The JSON body is decoded straight into the model when the table-driven
+ * codec accepts it. Otherwise the cJSON tree is built once, on first use,
+ * and handed to the generated OpenAPI_xxx_parseFromJSON().
+ */
+static void *parse_model(const OpenAPI_stream_model_t *model,
+        char *json, cJSON **item)
+{
+    void *data = NULL;
+
+    ogs_assert(model);
+    ogs_assert(json);
+    ogs_assert(item);
+
+    if (!*item) {
+        data = OpenAPI_stream_parse(model, json);
+        if (data)
+            return data;
+
+        *item = cJSON_Parse(json);
+        if (!*item) {
+            ogs_error("JSON parse error [%s]", json);
+            return NULL;
+        }
+    }
+
+    return model->parseFromJSON(*item);
+}
+
 static int parse_json(ogs_sbi_message_t *message,
         char *content_type, char *json)
 {
@@ -1401,19 +1458,24 @@ static int parse_json(ogs_sbi_message_t *message,
     }
 
     ogs_log_print(OGS_LOG_TRACE, "%s", json);
-    item = cJSON_Parse(json);
-    if (!item) {
-        ogs_error("JSON parse error [%s]", json);
-        return OGS_ERROR;
+    if (OpenAPI_stream_validate(json) == false) {
+        item = cJSON_Parse(json);
+        if (!item) {
+            ogs_error("JSON parse error [%s]", json);
+            return OGS_ERROR;
+        }
     }
 
     if (content_type &&
         !strncmp(content_type, OGS_SBI_CONTENT_PROBLEM_TYPE,
             strlen(OGS_SBI_CONTENT_PROBLEM_TYPE))) {
-        message->ProblemDetails = OpenAPI_problem_details_parseFromJSON(item);
+        message->ProblemDetails = parse_model(&OpenAPI_problem_details_stream,
+                json, &item);
     } else if (content_type &&
                 !strncmp(content_type, OGS_SBI_CONTENT_PATCH_TYPE,
                     strlen(OGS_SBI_CONTENT_PATCH_TYPE))) {
+        if (!item)
+            item = cJSON_Parse(json);
         if (item) {
             OpenAPI_patch_item_t *patch_item = NULL;
             cJSON *patchJSON = NULL;
@@ -1442,7 +1504,7 @@ static int parse_json(ogs_sbi_message_t *message,
             CASE(OGS_SBI_RESOURCE_NAME_NF_INSTANCES)
                 if (message->res_status < 300) {
                     message->NFProfile =
-                        OpenAPI_nf_profile_parseFromJSON(item);
+                        parse_model(&OpenAPI_nf_profile_stream, json, &item);
                     if (!message->NFProfile) {
                         rv = OGS_ERROR;
                         ogs_error("JSON parse error");
@@ -1455,7 +1517,8 @@ static int parse_json(ogs_sbi_message_t *message,
             CASE(OGS_SBI_RESOURCE_NAME_SUBSCRIPTIONS)
                 if (message->res_status < 300) {
                     message->SubscriptionData =
-                        OpenAPI_subscription_data_parseFromJSON(item);
+                        parse_model(&OpenAPI_subscription_data_stream,
+                                json, &item);
                     if (!message->SubscriptionData) {
                         rv = OGS_ERROR;
                         ogs_error("JSON parse error");
@@ -1468,7 +1531,8 @@ static int parse_json(ogs_sbi_message_t *message,
             CASE(OGS_SBI_RESOURCE_NAME_NF_STATUS_NOTIFY)
                 if (message->res_status < 300) {
                     message->NotificationData =
-                        OpenAPI_notification_data_parseFromJSON(item);
+                        parse_model(&OpenAPI_notification_data_stream,
+                                json, &item);
                     if (!message->NotificationData) {
                         rv = OGS_ERROR;
                         ogs_error("JSON parse error");
@@ -1490,7 +1554,7 @@ static int parse_json(ogs_sbi_message_t *message,
             CASE(OGS_SBI_RESOURCE_NAME_NF_INSTANCES)
                 if (message->res_status < 300) {
                     message->SearchResult =
-                        OpenAPI_search_result_parseFromJSON(item);
+                        parse_model(&OpenAPI_search_result_stream, json, &item);
                     if (!message->SearchResult) {
                         rv = OGS_ERROR;
                         ogs_error("JSON parse error");
@@ -1514,7 +1578,8 @@ static int parse_json(ogs_sbi_message_t *message,
                 CASE(OGS_SBI_HTTP_METHOD_POST)
                     if (message->res_status == 0) {
                         message->AuthenticationInfo =
-                            OpenAPI_authentication_info_parseFromJSON(item);
+                            parse_model(&OpenAPI_authentication_info_stream,
+                                    json, &item);
                         if (!message->AuthenticationInfo) {
                             rv = OGS_ERROR;
                             ogs_error("JSON parse error");
@@ -1522,7 +1587,8 @@ static int parse_json(ogs_sbi_message_t *message,
                     } else if (message->res_status ==
                             OGS_SBI_HTTP_STATUS_CREATED) {
                         message->UeAuthenticationCtx =
-                        OpenAPI_ue_authentication_ctx_parseFromJSON(item);
+                        parse_model(&OpenAPI_ue_authentication_ctx_stream,
+                                json, &item);
                         if (!message->UeAuthenticationCtx) {
                             rv = OGS_ERROR;
                             ogs_error("JSON parse error");
@@ -1532,15 +1598,16 @@ static int parse_json(ogs_sbi_message_t *message,
                 CASE(OGS_SBI_HTTP_METHOD_PUT)
                     if (message->res_status == 0) {
                         message->ConfirmationData =
-                            OpenAPI_confirmation_data_parseFromJSON(item);
+                            parse_model(&OpenAPI_confirmation_data_stream,
+                                    json, &item);
                         if (!message->ConfirmationData) {
                             rv = OGS_ERROR;
                             ogs_error("JSON parse error");
                         }
                     } else if (message->res_status == OGS_SBI_HTTP_STATUS_OK) {
                         message->ConfirmationDataResponse =
-                            OpenAPI_confirmation_data_response_parseFromJSON(
-                                    item);
+                            parse_model(&OpenAPI_confirmation_data_response_stream,
+                                    json, &item);
                         if (!message->ConfirmationDataResponse) {
                             rv = OGS_ERROR;
                             ogs_error("JSON parse error");
@@ -1567,16 +1634,16 @@ static int parse_json(ogs_sbi_message_t *message,
                 CASE(OGS_SBI_RESOURCE_NAME_GENERATE_AUTH_DATA)
                     if (message->res_status == 0) {
                         message->AuthenticationInfoRequest =
-                        OpenAPI_authentication_info_request_parseFromJSON(
-                                item);
+                        parse_model(&OpenAPI_authentication_info_request_stream,
+                                json, &item);
                         if (!message->AuthenticationInfoRequest) {
                             rv = OGS_ERROR;
                             ogs_error("JSON parse error");
                         }
                     } else if (message->res_status == OGS_SBI_HTTP_STATUS_OK) {
                         message->AuthenticationInfoResult =
-                        OpenAPI_authentication_info_result_parseFromJSON(
-                                item);
+                        parse_model(&OpenAPI_authentication_info_result_stream,
+                                json, &item);
                         if (!message->AuthenticationInfoResult) {
                             rv = OGS_ERROR;
                             ogs_error("JSON parse error");
@@ -1592,7 +1659,8 @@ static int parse_json(ogs_sbi_message_t *message,
 
             CASE(OGS_SBI_RESOURCE_NAME_AUTH_EVENTS)
                 if (message->res_status < 300) {
-                    message->AuthEvent = OpenAPI_auth_event_parseFromJSON(item);
+                    message->AuthEvent = parse_model(&OpenAPI_auth_event_stream,
+                            json, &item);
                     if (!message->AuthEvent) {
                         rv = OGS_ERROR;
                         ogs_error("JSON parse error");
@@ -1618,8 +1686,8 @@ static int parse_json(ogs_sbi_message_t *message,
                     CASE(OGS_SBI_HTTP_METHOD_PUT)
                         if (message->res_status < 300) {
                             message->Amf3GppAccessRegistration =
-                                OpenAPI_amf3_gpp_access_registration_parseFromJSON(
-                                        item);
+                                parse_model(&OpenAPI_amf3_gpp_access_registration_stream,
+                                        json, &item);
                             if (!message->Amf3GppAccessRegistration) {
                                 rv = OGS_ERROR;
                                 ogs_error("JSON parse error");
@@ -1632,8 +1700,8 @@ static int parse_json(ogs_sbi_message_t *message,
                     CASE(OGS_SBI_HTTP_METHOD_PATCH)
                         if (message->res_status < 300) {
                             message->Amf3GppAccessRegistrationModification =
-                                OpenAPI_amf3_gpp_access_registration_modification_parseFromJSON(
-                                        item);
+                                parse_model(&OpenAPI_amf3_gpp_access_registration_modification_stream,
+                                        json, &item);
                             if (!message->Amf3GppAccessRegistrationModification) {
                                 rv = OGS_ERROR;
                                 ogs_error("JSON parse error");
@@ -1652,7 +1720,8 @@ static int parse_json(ogs_sbi_message_t *message,
                 CASE(OGS_SBI_RESOURCE_NAME_SMF_REGISTRATIONS)
                     if (message->res_status < 300) {
                         message->SmfRegistration =
-                            OpenAPI_smf_registration_parseFromJSON(item);
+                            parse_model(&OpenAPI_smf_registration_stream,
+                                    json, &item);
                         if (!message->SmfRegistration) {
                             rv = OGS_ERROR;
                             ogs_error("JSON parse error");
@@ -1682,8 +1751,8 @@ static int parse_json(ogs_sbi_message_t *message,
             CASE(OGS_SBI_RESOURCE_NAME_AM_DATA)
                 if (message->res_status < 300) {
                     message->AccessAndMobilitySubscriptionData =
-                        OpenAPI_access_and_mobility_subscription_data_parseFromJSON(
-                                item);
+                        parse_model(&OpenAPI_access_and_mobility_subscription_data_stream,
+                                json, &item);
                     if (!message->AccessAndMobilitySubscriptionData) {
                         rv = OGS_ERROR;
                         ogs_error("JSON parse error");
@@ -1696,8 +1765,8 @@ static int parse_json(ogs_sbi_message_t *message,
             CASE(OGS_SBI_RESOURCE_NAME_SMF_SELECT_DATA)
                 if (message->res_status < 300) {
                     message->SmfSelectionSubscriptionData =
-                        OpenAPI_smf_selection_subscription_data_parseFromJSON(
-                                item);
+                        parse_model(&OpenAPI_smf_selection_subscription_data_stream,
+                                json, &item);
                     if (!message->SmfSelectionSubscriptionData) {
                         rv = OGS_ERROR;
                         ogs_error("JSON parse error");
@@ -1710,7 +1779,8 @@ static int parse_json(ogs_sbi_message_t *message,
             CASE(OGS_SBI_RESOURCE_NAME_UE_CONTEXT_IN_SMF_DATA)
                 if (message->res_status < 300) {
                     message->UeContextInSmfData =
-                        OpenAPI_ue_context_in_smf_data_parseFromJSON(item);
+                        parse_model(&OpenAPI_ue_context_in_smf_data_stream,
+                                json, &item);
                     if (!message->UeContextInSmfData) {
                         rv = OGS_ERROR;
                         ogs_error("JSON parse error");
@@ -1722,6 +1792,8 @@ static int parse_json(ogs_sbi_message_t *message,
 
             CASE(OGS_SBI_RESOURCE_NAME_SM_DATA)
                 if (message->res_status < 300) {
+                    if (!item)
+                        item = cJSON_Parse(json);
                     if (item) {
                         OpenAPI_session_management_subscription_data_t
                             *smsub_item = NULL;
@@ -1752,7 +1824,8 @@ static int parse_json(ogs_sbi_message_t *message,
             CASE(OGS_SBI_RESOURCE_NAME_SDM_SUBSCRIPTIONS)
                 if (message->res_status < 300) {
                     message->SDMSubscription =
-                        OpenAPI_sdm_subscription_parseFromJSON(item);
+                        parse_model(&OpenAPI_sdm_subscription_stream,
+                                json, &item);
                     if (!message->SDMSubscription) {
                         rv = OGS_ERROR;
                         ogs_error("JSON parse error");
@@ -1778,7 +1851,8 @@ static int parse_json(ogs_sbi_message_t *message,
                     CASE(OGS_SBI_RESOURCE_NAME_AUTHENTICATION_SUBSCRIPTION)
                         if (message->res_status == OGS_SBI_HTTP_STATUS_OK) {
                             message->AuthenticationSubscription =
-                                OpenAPI_authentication_subscription_parseFromJSON(item);
+                                parse_model(&OpenAPI_authentication_subscription_stream,
+                                        json, &item);
                             if (!message->AuthenticationSubscription) {
                                 rv = OGS_ERROR;
                                 ogs_error("JSON parse error");
@@ -1788,7 +1862,8 @@ static int parse_json(ogs_sbi_message_t *message,
                     CASE(OGS_SBI_RESOURCE_NAME_AUTHENTICATION_STATUS)
                         if (message->res_status < 300) {
                             message->AuthEvent =
-                                OpenAPI_auth_event_parseFromJSON(item);
+                                parse_model(&OpenAPI_auth_event_stream,
+                                        json, &item);
                             if (!message->AuthEvent) {
                                 rv = OGS_ERROR;
                                 ogs_error("JSON parse error");
@@ -1810,8 +1885,8 @@ static int parse_json(ogs_sbi_message_t *message,
                     CASE(OGS_SBI_RESOURCE_NAME_AMF_3GPP_ACCESS)
                         if (message->res_status < 300) {
                             message->Amf3GppAccessRegistration =
-                                OpenAPI_amf3_gpp_access_registration_parseFromJSON(
-                                        item);
+                                parse_model(&OpenAPI_amf3_gpp_access_registration_stream,
+                                        json, &item);
                             if (!message->Amf3GppAccessRegistration) {
                                 rv = OGS_ERROR;
                                 ogs_error("JSON parse error");
@@ -1824,7 +1899,8 @@ static int parse_json(ogs_sbi_message_t *message,
                     CASE(OGS_SBI_RESOURCE_NAME_SMF_REGISTRATIONS)
                         if (message->res_status < 300) {
                             message->SmfRegistration =
-                                OpenAPI_smf_registration_parseFromJSON(item);
+                                parse_model(&OpenAPI_smf_registration_stream,
+                                        json, &item);
                             if (!message->SmfRegistration) {
                                 rv = OGS_ERROR;
                                 ogs_error("JSON parse error");
@@ -1848,7 +1924,8 @@ static int parse_json(ogs_sbi_message_t *message,
                         CASE(OGS_SBI_RESOURCE_NAME_AM_DATA)
                             if (message->res_status < 300) {
                                 message->AccessAndMobilitySubscriptionData =
-                                    OpenAPI_access_and_mobility_subscription_data_parseFromJSON(item);
+                                    parse_model(&OpenAPI_access_and_mobility_subscription_data_stream,
+                                            json, &item);
                                 if (!message->
                                         AccessAndMobilitySubscriptionData) {
                                     rv = OGS_ERROR;
@@ -1863,7 +1940,8 @@ static int parse_json(ogs_sbi_message_t *message,
                         CASE(OGS_SBI_RESOURCE_NAME_SMF_SELECTION_SUBSCRIPTION_DATA)
                             if (message->res_status < 300) {
                                 message->SmfSelectionSubscriptionData =
-                                    OpenAPI_smf_selection_subscription_data_parseFromJSON(item);
+                                    parse_model(&OpenAPI_smf_selection_subscription_data_stream,
+                                            json, &item);
                                 if (!message->SmfSelectionSubscriptionData) {
                                     rv = OGS_ERROR;
                                     ogs_error("JSON parse error");
@@ -1877,8 +1955,8 @@ static int parse_json(ogs_sbi_message_t *message,
                         CASE(OGS_SBI_RESOURCE_NAME_UE_CONTEXT_IN_SMF_DATA)
                             if (message->res_status < 300) {
                                 message->UeContextInSmfData =
-                                    OpenAPI_ue_context_in_smf_data_parseFromJSON(
-                                            item);
+                                    parse_model(&OpenAPI_ue_context_in_smf_data_stream,
+                                            json, &item);
                                 if (!message->UeContextInSmfData) {
                                     rv = OGS_ERROR;
                                     ogs_error("JSON parse error");
@@ -1891,6 +1969,8 @@ static int parse_json(ogs_sbi_message_t *message,
 
                         CASE(OGS_SBI_RESOURCE_NAME_SM_DATA)
                             if (message->res_status < 300) {
+                                if (!item)
+                                    item = cJSON_Parse(json);
                                 if (item) {
                                     OpenAPI_session_management_subscription_data_t *smsub_item = NULL;
                                     cJSON *smsubJSON = NULL;
@@ -1939,7 +2019,8 @@ static int parse_json(ogs_sbi_message_t *message,
                     CASE(OGS_SBI_RESOURCE_NAME_AM_DATA)
                         if (message->res_status < 300) {
                             message->AmPolicyData =
-                                OpenAPI_am_policy_data_parseFromJSON(item);
+                                parse_model(&OpenAPI_am_policy_data_stream,
+                                        json, &item);
                             if (!message->AmPolicyData) {
                                 rv = OGS_ERROR;
                                 ogs_error("JSON parse error");
@@ -1953,7 +2034,8 @@ static int parse_json(ogs_sbi_message_t *message,
                     CASE(OGS_SBI_RESOURCE_NAME_SM_DATA)
                         if (message->res_status < 300) {
                             message->SmPolicyData =
-                                OpenAPI_sm_policy_data_parseFromJSON(item);
+                                parse_model(&OpenAPI_sm_policy_data_stream,
+                                        json, &item);
                             if (!message->SmPolicyData) {
                                 rv = OGS_ERROR;
                                 ogs_error("JSON parse error");
@@ -1992,14 +2074,16 @@ static int parse_json(ogs_sbi_message_t *message,
                 CASE(OGS_SBI_RESOURCE_NAME_MODIFY)
                     if (message->res_status == 0) {
                         message->SmContextUpdateData =
-                            OpenAPI_sm_context_update_data_parseFromJSON(item);
+                            parse_model(&OpenAPI_sm_context_update_data_stream,
+                                    json, &item);
                         if (!message->SmContextUpdateData) {
                             rv = OGS_ERROR;
                             ogs_error("JSON parse error");
                         }
                     } else if (message->res_status == OGS_SBI_HTTP_STATUS_OK) {
                         message->SmContextUpdatedData =
-                            OpenAPI_sm_context_updated_data_parseFromJSON(item);
+                            parse_model(&OpenAPI_sm_context_updated_data_stream,
+                                    json, &item);
                         if (!message->SmContextUpdatedData) {
                             rv = OGS_ERROR;
                             ogs_error("JSON parse error");
@@ -2017,7 +2101,8 @@ static int parse_json(ogs_sbi_message_t *message,
                                 message->res_status ==
                                     OGS_SBI_HTTP_STATUS_GATEWAY_TIMEOUT) {
                         message->SmContextUpdateError =
-                            OpenAPI_sm_context_update_error_parseFromJSON(item);
+                            parse_model(&OpenAPI_sm_context_update_error_stream,
+                                    json, &item);
                         if (!message->SmContextUpdateError) {
                             rv = OGS_ERROR;
                             ogs_error("JSON parse error");
@@ -2027,7 +2112,8 @@ static int parse_json(ogs_sbi_message_t *message,
                 CASE(OGS_SBI_RESOURCE_NAME_RELEASE)
                     if (message->res_status == 0) {
                         message->SmContextReleaseData =
-                            OpenAPI_sm_context_release_data_parseFromJSON(item);
+                            parse_model(&OpenAPI_sm_context_release_data_stream,
+                                    json, &item);
                         if (!message->SmContextReleaseData) {
                             rv = OGS_ERROR;
                             ogs_error("JSON parse error");
@@ -2036,8 +2122,8 @@ static int parse_json(ogs_sbi_message_t *message,
                             OGS_SBI_HTTP_STATUS_NO_CONTENT) {
                     } else if (message->res_status == OGS_SBI_HTTP_STATUS_OK) {
                         message->SmContextReleasedData =
-                            OpenAPI_sm_context_released_data_parseFromJSON(
-                                    item);
+                            parse_model(&OpenAPI_sm_context_released_data_stream,
+                                    json, &item);
                         if (!message->SmContextReleasedData) {
                             rv = OGS_ERROR;
                             ogs_error("JSON parse error");
@@ -2047,7 +2133,8 @@ static int parse_json(ogs_sbi_message_t *message,
                 DEFAULT
                     if (message->res_status == 0) {
                         message->SmContextCreateData =
-                            OpenAPI_sm_context_create_data_parseFromJSON(item);
+                            parse_model(&OpenAPI_sm_context_create_data_stream,
+                                    json, &item);
                         if (!message->SmContextCreateData) {
                             rv = OGS_ERROR;
                             ogs_error("JSON parse error");
@@ -2055,7 +2142,8 @@ static int parse_json(ogs_sbi_message_t *message,
                     } else if (message->res_status ==
                             OGS_SBI_HTTP_STATUS_CREATED) {
                         message->SmContextCreatedData =
-                            OpenAPI_sm_context_created_data_parseFromJSON(item);
+                            parse_model(&OpenAPI_sm_context_created_data_stream,
+                                    json, &item);
                         if (!message->SmContextCreatedData) {
                             rv = OGS_ERROR;
                             ogs_error("JSON parse error");
@@ -2073,7 +2161,8 @@ static int parse_json(ogs_sbi_message_t *message,
                                 message->res_status ==
                                     OGS_SBI_HTTP_STATUS_GATEWAY_TIMEOUT) {
                         message->SmContextCreateError =
-                            OpenAPI_sm_context_create_error_parseFromJSON(item);
+                            parse_model(&OpenAPI_sm_context_create_error_stream,
+                                    json, &item);
                         if (!message->SmContextCreateError) {
                             rv = OGS_ERROR;
                             ogs_error("JSON parse error");
@@ -2096,7 +2185,8 @@ static int parse_json(ogs_sbi_message_t *message,
                 CASE(OGS_SBI_RESOURCE_NAME_N1_N2_MESSAGES)
                     if (message->res_status == 0) {
                         message->N1N2MessageTransferReqData =
-                            OpenAPI_n1_n2_message_transfer_req_data_parseFromJSON(item);
+                            parse_model(&OpenAPI_n1_n2_message_transfer_req_data_stream,
+                                    json, &item);
                         if (!message->N1N2MessageTransferReqData) {
                             rv = OGS_ERROR;
                             ogs_error("JSON parse error");
@@ -2106,7 +2196,8 @@ static int parse_json(ogs_sbi_message_t *message,
                                 message->res_status ==
                                     OGS_SBI_HTTP_STATUS_ACCEPTED) {
                         message->N1N2MessageTransferRspData =
-                            OpenAPI_n1_n2_message_transfer_rsp_data_parseFromJSON(item);
+                            parse_model(&OpenAPI_n1_n2_message_transfer_rsp_data_stream,
+                                    json, &item);
                         if (!message->N1N2MessageTransferRspData) {
                             rv = OGS_ERROR;
                             ogs_error("JSON parse error");
@@ -2117,14 +2208,16 @@ static int parse_json(ogs_sbi_message_t *message,
                 CASE(OGS_SBI_RESOURCE_NAME_TRANSFER)
                     if (message->res_status == 0) {
                         message->UeContextTransferReqData =
-                            OpenAPI_ue_context_transfer_req_data_parseFromJSON(item);
+                            parse_model(&OpenAPI_ue_context_transfer_req_data_stream,
+                                    json, &item);
                         if (!message->UeContextTransferReqData) {
                             rv = OGS_ERROR;
                             ogs_error("JSON parse error");
                         }
                     } else if (message->res_status == OGS_SBI_HTTP_STATUS_OK) {
                         message->UeContextTransferRspData =
-                            OpenAPI_ue_context_transfer_rsp_data_parseFromJSON(item);
+                            parse_model(&OpenAPI_ue_context_transfer_rsp_data_stream,
+                                    json, &item);
                         if (!message->UeContextTransferRspData) {
                             rv = OGS_ERROR;
                             ogs_error("JSON parse error");
@@ -2153,7 +2246,8 @@ static int parse_json(ogs_sbi_message_t *message,
             CASE(OGS_SBI_RESOURCE_NAME_POLICIES)
                 if (message->res_status == 0) {
                     message->PolicyAssociationRequest =
-                        OpenAPI_policy_association_request_parseFromJSON(item);
+                        parse_model(&OpenAPI_policy_association_request_stream,
+                                json, &item);
                     if (!message->PolicyAssociationRequest) {
                         rv = OGS_ERROR;
                         ogs_error("JSON parse error");
@@ -2161,7 +2255,8 @@ static int parse_json(ogs_sbi_message_t *message,
                 } else if (message->res_status ==
                         OGS_SBI_HTTP_STATUS_CREATED) {
                     message->PolicyAssociation =
-                        OpenAPI_policy_association_parseFromJSON(item);
+                        parse_model(&OpenAPI_policy_association_stream,
+                                json, &item);
                     if (!message->PolicyAssociation) {
                         rv = OGS_ERROR;
                         ogs_error("JSON parse error");
@@ -2181,7 +2276,8 @@ static int parse_json(ogs_sbi_message_t *message,
                 if (!message->h.resource.component[1]) {
                     if (message->res_status == 0) {
                         message->SmPolicyContextData =
-                            OpenAPI_sm_policy_context_data_parseFromJSON(item);
+                            parse_model(&OpenAPI_sm_policy_context_data_stream,
+                                    json, &item);
                         if (!message->SmPolicyContextData) {
                             rv = OGS_ERROR;
                             ogs_error("JSON parse error");
@@ -2189,7 +2285,8 @@ static int parse_json(ogs_sbi_message_t *message,
                     } else if (message->res_status ==
                             OGS_SBI_HTTP_STATUS_CREATED) {
                         message->SmPolicyDecision =
-                            OpenAPI_sm_policy_decision_parseFromJSON(item);
+                            parse_model(&OpenAPI_sm_policy_decision_stream,
+                                    json, &item);
                         if (!message->SmPolicyDecision) {
                             rv = OGS_ERROR;
                             ogs_error("JSON parse error");
@@ -2200,8 +2297,8 @@ static int parse_json(ogs_sbi_message_t *message,
                     CASE(OGS_SBI_RESOURCE_NAME_DELETE)
                         if (message->res_status == 0) {
                             message->SmPolicyDeleteData =
-                                OpenAPI_sm_policy_delete_data_parseFromJSON(
-                                        item);
+                                parse_model(&OpenAPI_sm_policy_delete_data_stream,
+                                        json, &item);
                             if (!message->SmPolicyDeleteData) {
                                 rv = OGS_ERROR;
                                 ogs_error("JSON parse error");
@@ -2228,8 +2325,8 @@ static int parse_json(ogs_sbi_message_t *message,
             CASE(OGS_SBI_RESOURCE_NAME_NETWORK_SLICE_INFORMATION)
                 if (message->res_status == OGS_SBI_HTTP_STATUS_OK) {
                     message->AuthorizedNetworkSliceInfo =
-                        OpenAPI_authorized_network_slice_info_parseFromJSON(
-                                item);
+                        parse_model(&OpenAPI_authorized_network_slice_info_stream,
+                                json, &item);
                     if (!message->AuthorizedNetworkSliceInfo) {
                         rv = OGS_ERROR;
                         ogs_error("JSON parse error");
@@ -2250,7 +2347,8 @@ static int parse_json(ogs_sbi_message_t *message,
                 if (message->h.resource.component[1]) {
                     if (message->res_status == OGS_SBI_HTTP_STATUS_OK) {
                         message->PcfBinding =
-                            OpenAPI_pcf_binding_parseFromJSON(item);
+                            parse_model(&OpenAPI_pcf_binding_stream,
+                                    json, &item);
                         if (!message->PcfBinding) {
                             rv = OGS_ERROR;
                             ogs_error("JSON parse error");
@@ -2264,7 +2362,8 @@ static int parse_json(ogs_sbi_message_t *message,
                             message->res_status ==
                                 OGS_SBI_HTTP_STATUS_CREATED) {
                             message->PcfBinding =
-                                OpenAPI_pcf_binding_parseFromJSON(item);
+                                parse_model(&OpenAPI_pcf_binding_stream,
+                                        json, &item);
                             if (!message->PcfBinding) {
                                 rv = OGS_ERROR;
                                 ogs_error("JSON parse error");
@@ -2275,7 +2374,8 @@ static int parse_json(ogs_sbi_message_t *message,
                     CASE(OGS_SBI_HTTP_METHOD_GET)
                         if (message->res_status == OGS_SBI_HTTP_STATUS_OK) {
                             message->PcfBinding =
-                                OpenAPI_pcf_binding_parseFromJSON(item);
+                                parse_model(&OpenAPI_pcf_binding_stream,
+                                        json, &item);
                             if (!message->PcfBinding) {
                                 rv = OGS_ERROR;
                                 ogs_error("JSON parse error");
@@ -2314,7 +2414,8 @@ static int parse_json(ogs_sbi_message_t *message,
                         CASE(OGS_SBI_HTTP_METHOD_PATCH)
                             if (message->res_status < 300) {
                                 message->AppSessionContextUpdateDataPatch =
-                                    OpenAPI_app_session_context_update_data_patch_parseFromJSON(item);
+                                    parse_model(&OpenAPI_app_session_context_update_data_patch_stream,
+                                            json, &item);
                                 if (!message->AppSessionContextUpdateDataPatch) {
                                     rv = OGS_ERROR;
                                     ogs_error("JSON parse error");
@@ -2336,7 +2437,8 @@ static int parse_json(ogs_sbi_message_t *message,
                             message->res_status ==
                                 OGS_SBI_HTTP_STATUS_CREATED) {
                             message->AppSessionContext =
-                                OpenAPI_app_session_context_parseFromJSON(item);
+                                parse_model(&OpenAPI_app_session_context_stream,
+                                        json, &item);
                             if (!message->AppSessionContext) {
                                 rv = OGS_ERROR;
                                 ogs_error("JSON parse error");
@@ -2363,14 +2465,16 @@ static int parse_json(ogs_sbi_message_t *message,
                 CASE(OGS_SBI_HTTP_METHOD_POST)
                     if (message->res_status == 0) {
                         message->SecNegotiateReqData =
-                            OpenAPI_sec_negotiate_req_data_parseFromJSON(item);
+                            parse_model(&OpenAPI_sec_negotiate_req_data_stream,
+                                    json, &item);
                         if (!message->SecNegotiateReqData) {
                             rv = OGS_ERROR;
                             ogs_error("JSON parse error");
                         }
                     } else if (message->res_status == OGS_SBI_HTTP_STATUS_OK) {
                         message->SecNegotiateRspData =
-                            OpenAPI_sec_negotiate_rsp_data_parseFromJSON(item);
+                            parse_model(&OpenAPI_sec_negotiate_rsp_data_stream,
+                                    json, &item);
                         if (!message->SecNegotiateRspData) {
                             rv = OGS_ERROR;
                             ogs_error("JSON parse error");
@@ -2394,8 +2498,8 @@ static int parse_json(ogs_sbi_message_t *message,
             CASE(OGS_SBI_RESOURCE_NAME_SM_CONTEXT_STATUS)
                 if (message->res_status < 300) {
                     message->SmContextStatusNotification =
-                        OpenAPI_sm_context_status_notification_parseFromJSON(
-                                item);
+                        parse_model(&OpenAPI_sm_context_status_notification_stream,
+                                json, &item);
                     if (!message->SmContextStatusNotification) {
                         rv = OGS_ERROR;
                         ogs_error("JSON parse error");
@@ -2408,7 +2512,8 @@ static int parse_json(ogs_sbi_message_t *message,
             CASE(OGS_SBI_RESOURCE_NAME_DEREG_NOTIFY)
                 if (message->res_status < 300) {
                     message->DeregistrationData =
-                        OpenAPI_deregistration_data_parseFromJSON(item);
+                        parse_model(&OpenAPI_deregistration_data_stream,
+                                json, &item);
                     if (!message->DeregistrationData) {
                         rv = OGS_ERROR;
                         ogs_error("JSON parse error");
@@ -2421,7 +2526,8 @@ static int parse_json(ogs_sbi_message_t *message,
             CASE(OGS_SBI_RESOURCE_NAME_SDMSUBSCRIPTION_NOTIFY)
                 if (message->res_status < 300) {
                     message->ModificationNotification =
-                        OpenAPI_modification_notification_parseFromJSON(item);
+                        parse_model(&OpenAPI_modification_notification_stream,
+                                json, &item);
                     if (!message->ModificationNotification) {
                         rv = OGS_ERROR;
                         ogs_error("JSON parse error");
@@ -2443,8 +2549,8 @@ static int parse_json(ogs_sbi_message_t *message,
             CASE(OGS_SBI_RESOURCE_NAME_N1_N2_FAILURE_NOTIFY)
                 if (message->res_status < 300) {
                     message->N1N2MsgTxfrFailureNotification =
-                        OpenAPI_n1_n2_msg_txfr_failure_notification_parseFromJSON(
-                                item);
+                        parse_model(&OpenAPI_n1_n2_msg_txfr_failure_notification_stream,
+                                json, &item);
                     if (!message->N1N2MsgTxfrFailureNotification) {
                         rv = OGS_ERROR;
                         ogs_error("JSON parse error");
@@ -2459,7 +2565,8 @@ static int parse_json(ogs_sbi_message_t *message,
                 CASE(OGS_SBI_RESOURCE_NAME_UPDATE)
                     if (message->res_status < 300) {
                         message->SmPolicyNotification =
-                            OpenAPI_sm_policy_notification_parseFromJSON(item);
+                            parse_model(&OpenAPI_sm_policy_notification_stream,
+                                    json, &item);
                         if (!message->SmPolicyNotification) {
                             rv = OGS_ERROR;
                             ogs_error("JSON parse error");
@@ -2472,7 +2579,8 @@ static int parse_json(ogs_sbi_message_t *message,
                 CASE(OGS_SBI_RESOURCE_NAME_TERMINATE)
                     if (message->res_status < 300) {
                         message->TerminationNotification =
-                            OpenAPI_termination_notification_parseFromJSON(item);
+                            parse_model(&OpenAPI_termination_notification_stream,
+                                    json, &item);
                         if (!message->TerminationNotification) {
                             rv = OGS_ERROR;
                             ogs_error("JSON parse error");
@@ -481,6 +481,99 @@ void ogs_nnrf_nfm_free_nf_profile(OpenAPI_nf_profile_t *NFProfile)
     ogs_free(NFProfile);
 }
 
+char *ogs_nnrf_nfm_build_nf_profile_json(
+        ogs_sbi_nf_instance_t *nf_instance,
+        ogs_sbi_discovery_option_t *discovery_option,
+        bool service_map)
+{
+    OpenAPI_nf_profile_t *NFProfile = NULL;
+    cJSON *item = NULL;
+    char *json = NULL;
+
+    ogs_assert(nf_instance);
+
+    NFProfile = ogs_nnrf_nfm_build_nf_profile(
+            nf_instance, NULL, discovery_option, service_map);
+    if (!NFProfile) {
+        ogs_error("ogs_nnrf_nfm_build_nf_profile() failed");
+        return NULL;
+    }
+
+    item = OpenAPI_nf_profile_convertToJSON(NFProfile);
+    ogs_nnrf_nfm_free_nf_profile(NFProfile);
+    if (!item) {
+        ogs_error("OpenAPI_nf_profile_convertToJSON() failed");
+        return NULL;
+    }
+
+    json = cJSON_PrintUnformatted(item);
+    cJSON_Delete(item);
+    if (!json) {
+        ogs_error("cJSON_PrintUnformatted() failed");
+        return NULL;
+    }
+
+    return json;
+}
+
+char *ogs_nnrf_nfm_cached_nf_profile_json(
+        ogs_sbi_nf_instance_t *nf_instance, bool service_map)
+{
+    ogs_assert(nf_instance);
+
+    if (!nf_instance->nf_profile_json[service_map])
+        nf_instance->nf_profile_json[service_map] =
+            ogs_nnrf_nfm_build_nf_profile_json(
+                    nf_instance, NULL, service_map);
+
+    return nf_instance->nf_profile_json[service_map];
+}
+
+char *ogs_nnrf_disc_build_search_result(
+        OpenAPI_list_t *NFProfileList, int validity_period)
+{
+    OpenAPI_lnode_t *node = NULL;
+    char head[64], *content = NULL, *p = NULL;
+    size_t length, size;
+
+    ogs_assert(NFProfileList);
+
+    if (validity_period)
+        ogs_snprintf(head, sizeof(head),
+                "{\"validityPeriod\":%d,\"nfInstances\":[", validity_period);
+    else
+        ogs_snprintf(head, sizeof(head), "{\"nfInstances\":[");
+
+    length = strlen(head) + NFProfileList->count + 2;
+    OpenAPI_list_for_each(NFProfileList, node)
+        length += strlen(node->data);
+
+    content = ogs_malloc(length);
+    if (!content) {
+        ogs_error("ogs_malloc() failed");
+        return NULL;
+    }
+
+    p = content;
+    size = strlen(head);
+    memcpy(p, head, size);
+    p += size;
+
+    OpenAPI_list_for_each(NFProfileList, node) {
+        if (node != NFProfileList->first)
+            *p++ = ',';
+        size = strlen(node->data);
+        memcpy(p, node->data, size);
+        p += size;
+    }
+
+    *p++ = ']';
+    *p++ = '}';
+    *p = 0;
+
+    return content;
+}
+
 static OpenAPI_nf_service_t *build_nf_service(
         ogs_sbi_nf_service_t *nf_service)
 {
@@ -31,6 +31,18 @@ OpenAPI_nf_profile_t *ogs_nnrf_nfm_build_nf_profile(
         bool service_map);
 void ogs_nnrf_nfm_free_nf_profile(OpenAPI_nf_profile_t *NFProfile);
 
+/*
+ * NFProfile JSON as printed from OpenAPI_nf_profile_convertToJSON().
+ * The cached one is kept in the NF Instance, and must not be freed,
+ * until ogs_sbi_nf_instance_invalidate_nf_profile_json().
+ */
+char *ogs_nnrf_nfm_build_nf_profile_json(
+        ogs_sbi_nf_instance_t *nf_instance,
+        ogs_sbi_discovery_option_t *discovery_option,
+        bool service_map);
+char *ogs_nnrf_nfm_cached_nf_profile_json(
+        ogs_sbi_nf_instance_t *nf_instance, bool service_map);
+
 ogs_sbi_request_t *ogs_nnrf_nfm_build_register(void);
 ogs_sbi_request_t *ogs_nnrf_nfm_build_update(void);
 ogs_sbi_request_t *ogs_nnrf_nfm_build_de_register(void);
@@ -48,6 +60,13 @@ ogs_sbi_request_t *ogs_nnrf_disc_build_discover(
         OpenAPI_nf_type_e requester_nf_type,
         ogs_sbi_discovery_option_t *discovery_option);
 
+/*
+ * SearchResult JSON from NFProfile JSON strings, in the same layout as
+ * OpenAPI_search_result_convertToJSON() would produce.
+ */
+char *ogs_nnrf_disc_build_search_result(
+        OpenAPI_list_t *NFProfileList, int validity_period);
+
 #ifdef __cplusplus
 }
 #endif
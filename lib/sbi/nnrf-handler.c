@@ -286,6 +286,8 @@ void ogs_nnrf_nfm_handle_nf_profile(
         handle_scp_info(nf_instance, NFProfile->scp_info);
     if (NFProfile->sepp_info)
         handle_sepp_info(nf_instance, NFProfile->sepp_info);
+
+    ogs_sbi_nf_instance_reindex(nf_instance);
 }
 
 static void handle_nf_service(
@@ -850,6 +852,34 @@ static void handle_validity_time(
             (int)ogs_time_sec(patch), (int)ogs_time_usec(patch));
 }
 
+void ogs_nnrf_nfm_handle_nf_patch_item(
+        ogs_sbi_nf_instance_t *nf_instance, OpenAPI_patch_item_t *PatchItem)
+{
+    ogs_assert(nf_instance);
+    ogs_assert(PatchItem);
+
+    if (PatchItem->op != OpenAPI_patch_operation_replace) {
+        ogs_error("Unknown PatchItem.Operation [%s]",
+                OpenAPI_patch_operation_ToString(PatchItem->op));
+        return;
+    }
+
+    SWITCH(PatchItem->path)
+    CASE(OGS_SBI_PATCH_PATH_NF_STATUS)
+        ogs_sbi_nf_instance_invalidate_nf_profile_json(nf_instance);
+        break;
+    CASE(OGS_SBI_PATCH_PATH_LOAD)
+        if (PatchItem->value && OpenAPI_IsNumber(PatchItem->value)) {
+            nf_instance->load = ogs_max(ogs_min(
+                PatchItem->value->json->valueint, 100), 0);
+            ogs_sbi_nf_instance_invalidate_nf_profile_json(nf_instance);
+        }
+        break;
+    DEFAULT
+        ogs_error("Unknown PatchItem.Path [%s]", PatchItem->path);
+    END
+}
+
 void ogs_nnrf_nfm_handle_nf_status_subscribe(
         ogs_sbi_subscription_data_t *subscription_data,
         ogs_sbi_message_t *recvmsg)
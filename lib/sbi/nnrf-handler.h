@@ -28,6 +28,8 @@ void ogs_nnrf_nfm_handle_nf_register(
         ogs_sbi_nf_instance_t *nf_instance, ogs_sbi_message_t *recvmsg);
 void ogs_nnrf_nfm_handle_nf_profile(
         ogs_sbi_nf_instance_t *nf_instance, OpenAPI_nf_profile_t *NFProfile);
+void ogs_nnrf_nfm_handle_nf_patch_item(
+        ogs_sbi_nf_instance_t *nf_instance, OpenAPI_patch_item_t *PatchItem);
 
 void ogs_nnrf_nfm_handle_nf_status_subscribe(
         ogs_sbi_subscription_data_t *subscription_data,
@@ -86,6 +86,7 @@
 #include "model/ue_authentication_ctx.h"
 #include "model/ue_context_transfer_req_data.h"
 #include "model/ue_context_transfer_rsp_data.h"
+#include "model/stream_model.h"
 
 #include "custom/links.h"
 
@@ -0,0 +1,113 @@
+#ifndef OGS_SBI_STREAM_H
+#define OGS_SBI_STREAM_H
+
+#include "../external/cJSON.h"
+#include "ogs-core.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Table-driven JSON codec for the generated OpenAPI models.
+ *
+ * Each model gets a descriptor (model/stream_model.c, produced by
+ * support/.../stream-generator.py) listing its members in the same order
+ * as OpenAPI_xxx_convertToJSON() emits them. OpenAPI_stream_print() writes
+ * JSON text straight from the C struct and OpenAPI_stream_parse() fills the
+ * C struct straight from JSON text, so no cJSON tree is built.
+ *
+ * The output of OpenAPI_stream_print() is byte-for-byte identical to
+ * cJSON_PrintUnformatted(OpenAPI_xxx_convertToJSON()). Whenever the struct
+ * holds something the generated code would treat specially (a missing
+ * mandatory member, a NULL list entry, ...) the codec falls back to the
+ * generated function so that the result stays the same.
+ *
+ * OpenAPI_stream_parse() only accepts input that cJSON and the generated
+ * OpenAPI_xxx_parseFromJSON() are known to accept with the same result.
+ * It returns NULL for anything else, and the caller is expected to retry
+ * with cJSON_Parse() + OpenAPI_xxx_parseFromJSON().
+ */
+
+typedef enum {
+    OpenAPI_STREAM_STRING = 1,
+    OpenAPI_STREAM_BOOL,
+    OpenAPI_STREAM_NUMBER,
+    OpenAPI_STREAM_ENUM,
+    OpenAPI_STREAM_MODEL,
+} OpenAPI_stream_type_e;
+
+typedef enum {
+    OpenAPI_STREAM_SCALAR = 0,
+    OpenAPI_STREAM_LIST,
+    OpenAPI_STREAM_MAP,
+} OpenAPI_stream_container_e;
+
+typedef enum {
+    OpenAPI_STREAM_INT = 0,
+    OpenAPI_STREAM_LONG,
+    OpenAPI_STREAM_FLOAT,
+    OpenAPI_STREAM_DOUBLE,
+    OpenAPI_STREAM_BOOLEAN,
+} OpenAPI_stream_ctype_e;
+
+/* Mandatory member */
+#define OpenAPI_STREAM_REQUIRED     0x01
+/* 'null' is accepted and recorded in the is_xxx_null member */
+#define OpenAPI_STREAM_NULLABLE     0x02
+/* Mandatory string member that also accepts 'null' (date-time) */
+#define OpenAPI_STREAM_NULL_OK      0x04
+/* Presence is tracked by the is_xxx member (bool and number) */
+#define OpenAPI_STREAM_IS_SET       0x08
+
+typedef struct OpenAPI_stream_model_s OpenAPI_stream_model_t;
+
+typedef struct OpenAPI_stream_enum_s {
+    char *(*to_string)(int value);
+    int (*from_string)(char *string);
+} OpenAPI_stream_enum_t;
+
+typedef struct OpenAPI_stream_field_s {
+    const char *key;
+
+    uint8_t type;                   /* OpenAPI_stream_type_e */
+    uint8_t container;              /* OpenAPI_stream_container_e */
+    uint8_t flags;
+    uint8_t ctype;                  /* C type of a bool or number member */
+
+    size_t offset;
+    size_t is_set_offset;
+    size_t is_null_offset;
+
+    const OpenAPI_stream_enum_t *enumeration;
+    const OpenAPI_stream_model_t *model;
+} OpenAPI_stream_field_t;
+
+struct OpenAPI_stream_model_s {
+    const char *name;
+    size_t size;
+
+    /*
+     * num_of_fields < 0 : no descriptor could be derived for this model,
+     *                     always use the generated functions.
+     */
+    const OpenAPI_stream_field_t *fields;
+    int num_of_fields;
+
+    cJSON *(*convertToJSON)(void *data);
+    void *(*parseFromJSON)(cJSON *json);
+    void (*free)(void *data);
+};
+
+#define OpenAPI_STREAM_MAX_FIELDS   256
+
+char *OpenAPI_stream_print(const OpenAPI_stream_model_t *model, void *data);
+void *OpenAPI_stream_parse(const OpenAPI_stream_model_t *model,
+        const char *json);
+bool OpenAPI_stream_validate(const char *json);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OGS_SBI_STREAM_H */
@@ -0,0 +1,1094 @@
+/*
+ * Generated by stream-generator.py. DO NOT EDIT.
+ */
+
+#ifndef _OpenAPI_stream_model_H_
+#define _OpenAPI_stream_model_H_
+
+#include "../include/stream.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern const OpenAPI_stream_model_t OpenAPI__application_data_influence_data_subs_to_notify_post_request_inner_stream;
+extern const OpenAPI_stream_model_t OpenAPI_aanf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_abnormal_behaviour_stream;
+extern const OpenAPI_stream_model_t OpenAPI_acc_net_ch_id_stream;
+extern const OpenAPI_stream_model_t OpenAPI_acc_net_charging_address_stream;
+extern const OpenAPI_stream_model_t OpenAPI_acceptable_service_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_access_and_mobility_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_access_and_mobility_subscription_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_access_and_mobility_subscription_data_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_access_net_charging_identifier_stream;
+extern const OpenAPI_stream_model_t OpenAPI_access_right_status_stream;
+extern const OpenAPI_stream_model_t OpenAPI_access_tech_stream;
+extern const OpenAPI_stream_model_t OpenAPI_access_token_err_stream;
+extern const OpenAPI_stream_model_t OpenAPI_access_token_req_stream;
+extern const OpenAPI_stream_model_t OpenAPI_access_type_rm_stream;
+extern const OpenAPI_stream_model_t OpenAPI_accu_usage_report_stream;
+extern const OpenAPI_stream_model_t OpenAPI_accumulated_usage_stream;
+extern const OpenAPI_stream_model_t OpenAPI_accuracy_stream;
+extern const OpenAPI_stream_model_t OpenAPI_acknowledge_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_acs_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_acs_info_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_acs_info_rm_stream;
+extern const OpenAPI_stream_model_t OpenAPI_additional_access_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_additional_ee_subs_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_additional_measurement_stream;
+extern const OpenAPI_stream_model_t OpenAPI_additional_snssai_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_additional_snssai_data_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_addr_fqdn_stream;
+extern const OpenAPI_stream_model_t OpenAPI_address_list_stream;
+extern const OpenAPI_stream_model_t OpenAPI_aerial_ue_subscription_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_aerial_ue_subscription_info_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_af_coordination_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_af_event_exposure_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_af_event_notification_stream;
+extern const OpenAPI_stream_model_t OpenAPI_af_event_subscription_stream;
+extern const OpenAPI_stream_model_t OpenAPI_af_external_stream;
+extern const OpenAPI_stream_model_t OpenAPI_af_routing_requirement_stream;
+extern const OpenAPI_stream_model_t OpenAPI_af_routing_requirement_rm_stream;
+extern const OpenAPI_stream_model_t OpenAPI_allowed_mtc_provider_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_allowed_nssai_stream;
+extern const OpenAPI_stream_model_t OpenAPI_allowed_snssai_stream;
+extern const OpenAPI_stream_model_t OpenAPI_alternative_qos_profile_stream;
+extern const OpenAPI_stream_model_t OpenAPI_alternative_service_requirements_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_am_influ_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_am_influ_event_stream;
+extern const OpenAPI_stream_model_t OpenAPI_am_policy_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_am_requested_value_rep_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ambr_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ambr_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ambr_rm_stream;
+extern const OpenAPI_stream_model_t OpenAPI_amf3_gpp_access_registration_stream;
+extern const OpenAPI_stream_model_t OpenAPI_amf3_gpp_access_registration_modification_stream;
+extern const OpenAPI_stream_model_t OpenAPI_amf_cond_stream;
+extern const OpenAPI_stream_model_t OpenAPI_amf_dereg_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_amf_event_stream;
+extern const OpenAPI_stream_model_t OpenAPI_amf_event_area_stream;
+extern const OpenAPI_stream_model_t OpenAPI_amf_event_mode_stream;
+extern const OpenAPI_stream_model_t OpenAPI_amf_event_subscription_stream;
+extern const OpenAPI_stream_model_t OpenAPI_amf_event_subscription_add_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_amf_event_trigger_stream;
+extern const OpenAPI_stream_model_t OpenAPI_amf_event_type_stream;
+extern const OpenAPI_stream_model_t OpenAPI_amf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_amf_non3_gpp_access_registration_stream;
+extern const OpenAPI_stream_model_t OpenAPI_amf_non3_gpp_access_registration_modification_stream;
+extern const OpenAPI_stream_model_t OpenAPI_amf_status_change_notification_stream;
+extern const OpenAPI_stream_model_t OpenAPI_amf_status_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_amf_subscription_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_an_gw_address_stream;
+extern const OpenAPI_stream_model_t OpenAPI_analytics_metadata_stream;
+extern const OpenAPI_stream_model_t OpenAPI_analytics_metadata_indication_stream;
+extern const OpenAPI_stream_model_t OpenAPI_analytics_metadata_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_analytics_subscription_stream;
+extern const OpenAPI_stream_model_t OpenAPI_analytics_subset_stream;
+extern const OpenAPI_stream_model_t OpenAPI_anchor_smf_features_stream;
+extern const OpenAPI_stream_model_t OpenAPI_any_type_stream;
+extern const OpenAPI_stream_model_t OpenAPI_api_ie_mapping_stream;
+extern const OpenAPI_stream_model_t OpenAPI_api_signature_stream;
+extern const OpenAPI_stream_model_t OpenAPI_apn_rate_status_stream;
+extern const OpenAPI_stream_model_t OpenAPI_app_descriptor_stream;
+extern const OpenAPI_stream_model_t OpenAPI_app_descriptor_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_app_detection_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_app_detection_report_stream;
+extern const OpenAPI_stream_model_t OpenAPI_app_list_for_ue_comm_stream;
+extern const OpenAPI_stream_model_t OpenAPI_app_port_id_stream;
+extern const OpenAPI_stream_model_t OpenAPI_app_session_context_stream;
+extern const OpenAPI_stream_model_t OpenAPI_app_session_context_req_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_app_session_context_resp_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_app_session_context_update_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_app_session_context_update_data_patch_stream;
+extern const OpenAPI_stream_model_t OpenAPI_application_data_change_notif_stream;
+extern const OpenAPI_stream_model_t OpenAPI_application_data_subs_stream;
+extern const OpenAPI_stream_model_t OpenAPI_application_volume_stream;
+extern const OpenAPI_stream_model_t OpenAPI_area_stream;
+extern const OpenAPI_stream_model_t OpenAPI_area_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_area_of_interest_event_state_stream;
+extern const OpenAPI_stream_model_t OpenAPI_area_of_validity_stream;
+extern const OpenAPI_stream_model_t OpenAPI_area_scope_stream;
+extern const OpenAPI_stream_model_t OpenAPI_arp_stream;
+extern const OpenAPI_stream_model_t OpenAPI_arp_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_as_time_distribution_param_stream;
+extern const OpenAPI_stream_model_t OpenAPI_assign_ebi_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_assign_ebi_error_stream;
+extern const OpenAPI_stream_model_t OpenAPI_assign_ebi_failed_stream;
+extern const OpenAPI_stream_model_t OpenAPI_assigned_ebi_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_association_type_stream;
+extern const OpenAPI_stream_model_t OpenAPI_atom_stream;
+extern const OpenAPI_stream_model_t OpenAPI_atsss_capability_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ausf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_auth_event_stream;
+extern const OpenAPI_stream_model_t OpenAPI_authentication_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_authentication_info_request_stream;
+extern const OpenAPI_stream_model_t OpenAPI_authentication_info_result_stream;
+extern const OpenAPI_stream_model_t OpenAPI_authentication_subscription_stream;
+extern const OpenAPI_stream_model_t OpenAPI_authentication_vector_stream;
+extern const OpenAPI_stream_model_t OpenAPI_authorization_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_authorization_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_authorized_default_qos_stream;
+extern const OpenAPI_stream_model_t OpenAPI_authorized_network_slice_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_av5_ghe_aka_stream;
+extern const OpenAPI_stream_model_t OpenAPI_av5g_aka_stream;
+extern const OpenAPI_stream_model_t OpenAPI_av_eap_aka_prime_stream;
+extern const OpenAPI_stream_model_t OpenAPI_av_eps_aka_stream;
+extern const OpenAPI_stream_model_t OpenAPI_av_ims_gba_eap_aka_stream;
+extern const OpenAPI_stream_model_t OpenAPI_backup_amf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_battery_indication_stream;
+extern const OpenAPI_stream_model_t OpenAPI_battery_indication_rm_stream;
+extern const OpenAPI_stream_model_t OpenAPI_bdt_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_bdt_data_patch_stream;
+extern const OpenAPI_stream_model_t OpenAPI_bdt_policy_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_bdt_policy_data_patch_stream;
+extern const OpenAPI_stream_model_t OpenAPI_bdt_policy_status_stream;
+extern const OpenAPI_stream_model_t OpenAPI_binding_resp_stream;
+extern const OpenAPI_stream_model_t OpenAPI_bridge_management_container_stream;
+extern const OpenAPI_stream_model_t OpenAPI_bsf_event_notification_stream;
+extern const OpenAPI_stream_model_t OpenAPI_bsf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_bsf_notification_stream;
+extern const OpenAPI_stream_model_t OpenAPI_bsf_subscription_stream;
+extern const OpenAPI_stream_model_t OpenAPI_bsf_subscription_resp_stream;
+extern const OpenAPI_stream_model_t OpenAPI_bw_requirement_stream;
+extern const OpenAPI_stream_model_t OpenAPI_cag_ack_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_cag_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_cag_data_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_cag_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_cag_info_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_callback_name_stream;
+extern const OpenAPI_stream_model_t OpenAPI_cancel_relocate_ue_context_request_stream;
+extern const OpenAPI_stream_model_t OpenAPI_candidate_for_replacement_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ce_mode_b_ind_stream;
+extern const OpenAPI_stream_model_t OpenAPI_cell_global_id_stream;
+extern const OpenAPI_stream_model_t OpenAPI_change_item_stream;
+extern const OpenAPI_stream_model_t OpenAPI_charging_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_charging_information_stream;
+extern const OpenAPI_stream_model_t OpenAPI_chf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_circumstance_description_stream;
+extern const OpenAPI_stream_model_t OpenAPI_civic_address_stream;
+extern const OpenAPI_stream_model_t OpenAPI_class_criterion_stream;
+extern const OpenAPI_stream_model_t OpenAPI_cm_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_cm_state_stream;
+extern const OpenAPI_stream_model_t OpenAPI_cn_assisted_ran_para_stream;
+extern const OpenAPI_stream_model_t OpenAPI_cnf_stream;
+extern const OpenAPI_stream_model_t OpenAPI_cnf_unit_stream;
+extern const OpenAPI_stream_model_t OpenAPI_collocated_nf_instance_stream;
+extern const OpenAPI_stream_model_t OpenAPI_communication_characteristics_stream;
+extern const OpenAPI_stream_model_t OpenAPI_communication_characteristics_af_stream;
+extern const OpenAPI_stream_model_t OpenAPI_complex_query_stream;
+extern const OpenAPI_stream_model_t OpenAPI_condition_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_configured_snssai_stream;
+extern const OpenAPI_stream_model_t OpenAPI_confirmation_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_confirmation_data_response_stream;
+extern const OpenAPI_stream_model_t OpenAPI_congestion_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_congestion_type_stream;
+extern const OpenAPI_stream_model_t OpenAPI_connection_capabilities_stream;
+extern const OpenAPI_stream_model_t OpenAPI_consumer_nf_information_stream;
+extern const OpenAPI_stream_model_t OpenAPI_context_data_sets_stream;
+extern const OpenAPI_stream_model_t OpenAPI_context_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_create_ue_context_201_response_stream;
+extern const OpenAPI_stream_model_t OpenAPI_create_ue_context_403_response_stream;
+extern const OpenAPI_stream_model_t OpenAPI_create_ue_context_request_stream;
+extern const OpenAPI_stream_model_t OpenAPI_data_change_notify_stream;
+extern const OpenAPI_stream_model_t OpenAPI_data_filter_stream;
+extern const OpenAPI_stream_model_t OpenAPI_data_ind_stream;
+extern const OpenAPI_stream_model_t OpenAPI_data_restoration_notification_stream;
+extern const OpenAPI_stream_model_t OpenAPI_datalink_reporting_configuration_stream;
+extern const OpenAPI_stream_model_t OpenAPI_datalink_reporting_configuration_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_dataset_statistical_property_stream;
+extern const OpenAPI_stream_model_t OpenAPI_dccf_cond_stream;
+extern const OpenAPI_stream_model_t OpenAPI_dccf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ddd_traffic_descriptor_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ddd_traffic_descriptor_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ddn_failure_sub_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ddn_failure_subs_stream;
+extern const OpenAPI_stream_model_t OpenAPI_def_sub_service_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_default_notification_subscription_stream;
+extern const OpenAPI_stream_model_t OpenAPI_default_unrelated_class_stream;
+extern const OpenAPI_stream_model_t OpenAPI_deregistration_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_deregistration_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_dispersion_area_stream;
+extern const OpenAPI_stream_model_t OpenAPI_dispersion_class_stream;
+extern const OpenAPI_stream_model_t OpenAPI_dispersion_collection_stream;
+extern const OpenAPI_stream_model_t OpenAPI_dispersion_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_dispersion_ordering_criterion_stream;
+extern const OpenAPI_stream_model_t OpenAPI_dispersion_requirement_stream;
+extern const OpenAPI_stream_model_t OpenAPI_dispersion_type_stream;
+extern const OpenAPI_stream_model_t OpenAPI_dn_perf_stream;
+extern const OpenAPI_stream_model_t OpenAPI_dn_perf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_dn_perf_ordering_criterion_stream;
+extern const OpenAPI_stream_model_t OpenAPI_dn_performance_req_stream;
+extern const OpenAPI_stream_model_t OpenAPI_dnai_information_stream;
+extern const OpenAPI_stream_model_t OpenAPI_dnf_stream;
+extern const OpenAPI_stream_model_t OpenAPI_dnf_unit_stream;
+extern const OpenAPI_stream_model_t OpenAPI_dnn_configuration_stream;
+extern const OpenAPI_stream_model_t OpenAPI_dnn_configuration_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_dnn_easdf_info_item_stream;
+extern const OpenAPI_stream_model_t OpenAPI_dnn_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_dnn_info_item_stream;
+extern const OpenAPI_stream_model_t OpenAPI_dnn_mb_smf_info_item_stream;
+extern const OpenAPI_stream_model_t OpenAPI_dnn_route_selection_descriptor_stream;
+extern const OpenAPI_stream_model_t OpenAPI_dnn_smf_info_item_stream;
+extern const OpenAPI_stream_model_t OpenAPI_dnn_smf_info_item_dnai_list_inner_stream;
+extern const OpenAPI_stream_model_t OpenAPI_dnn_snssai_information_stream;
+extern const OpenAPI_stream_model_t OpenAPI_dnn_tsctsf_info_item_stream;
+extern const OpenAPI_stream_model_t OpenAPI_dnn_upf_info_item_stream;
+extern const OpenAPI_stream_model_t OpenAPI_domain_name_protocol_stream;
+extern const OpenAPI_stream_model_t OpenAPI_downlink_data_notification_control_stream;
+extern const OpenAPI_stream_model_t OpenAPI_downlink_data_notification_control_rm_stream;
+extern const OpenAPI_stream_model_t OpenAPI_dynamic5_qi_stream;
+extern const OpenAPI_stream_model_t OpenAPI_eap_auth_method_200_response_stream;
+extern const OpenAPI_stream_model_t OpenAPI_eap_session_stream;
+extern const OpenAPI_stream_model_t OpenAPI_eas_ip_replacement_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_eas_server_address_stream;
+extern const OpenAPI_stream_model_t OpenAPI_easdf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ebi_arp_mapping_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ec_restriction_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ec_restriction_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ec_restriction_data_wb_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ecgi_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ecgi_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ecs_addr_config_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ecs_addr_config_info_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ecs_server_addr_stream;
+extern const OpenAPI_stream_model_t OpenAPI_edrx_parameters_stream;
+extern const OpenAPI_stream_model_t OpenAPI_edrx_parameters_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ee_group_profile_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ee_profile_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ee_subscription_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ee_subscription_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ee_subscription_ext_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ellipsoid_arc_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ellipsoid_arc_all_of_stream;
+extern const OpenAPI_stream_model_t OpenAPI_emergency_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_enhanced_coverage_restriction_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_eps_bearer_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_eps_interworking_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_eps_iwk_pgw_stream;
+extern const OpenAPI_stream_model_t OpenAPI_eps_nas_security_mode_stream;
+extern const OpenAPI_stream_model_t OpenAPI_eps_pdn_cnx_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_error_report_stream;
+extern const OpenAPI_stream_model_t OpenAPI_eth_flow_description_stream;
+extern const OpenAPI_stream_model_t OpenAPI_eutra_location_stream;
+extern const OpenAPI_stream_model_t OpenAPI_event_stream;
+extern const OpenAPI_stream_model_t OpenAPI_event_id_stream;
+extern const OpenAPI_stream_model_t OpenAPI_event_notification_stream;
+extern const OpenAPI_stream_model_t OpenAPI_event_report_mode_stream;
+extern const OpenAPI_stream_model_t OpenAPI_event_reporting_requirement_stream;
+extern const OpenAPI_stream_model_t OpenAPI_event_subscription_stream;
+extern const OpenAPI_stream_model_t OpenAPI_event_type_stream;
+extern const OpenAPI_stream_model_t OpenAPI_events_notification_stream;
+extern const OpenAPI_stream_model_t OpenAPI_events_subsc_put_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_events_subsc_req_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_events_subsc_req_data_rm_stream;
+extern const OpenAPI_stream_model_t OpenAPI_exception_stream;
+extern const OpenAPI_stream_model_t OpenAPI_exception_id_stream;
+extern const OpenAPI_stream_model_t OpenAPI_exception_trend_stream;
+extern const OpenAPI_stream_model_t OpenAPI_exemption_ind_stream;
+extern const OpenAPI_stream_model_t OpenAPI_expected_analytics_type_stream;
+extern const OpenAPI_stream_model_t OpenAPI_expected_ue_behavior_stream;
+extern const OpenAPI_stream_model_t OpenAPI_expected_ue_behaviour_stream;
+extern const OpenAPI_stream_model_t OpenAPI_expected_ue_behaviour_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_expected_ue_behaviour_data_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_exposure_data_change_notification_stream;
+extern const OpenAPI_stream_model_t OpenAPI_exposure_data_subscription_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ext_amf_event_subscription_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ext_problem_details_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ext_snssai_stream;
+extern const OpenAPI_stream_model_t OpenAPI_extended_problem_details_stream;
+extern const OpenAPI_stream_model_t OpenAPI_extended_problem_details_all_of_stream;
+extern const OpenAPI_stream_model_t OpenAPI_extended_sm_subs_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_external_client_type_stream;
+extern const OpenAPI_stream_model_t OpenAPI_external_unrelated_class_stream;
+extern const OpenAPI_stream_model_t OpenAPI_failed_modification_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_failure_event_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_final_unit_action_stream;
+extern const OpenAPI_stream_model_t OpenAPI_flow_direction_rm_stream;
+extern const OpenAPI_stream_model_t OpenAPI_flow_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_flow_information_stream;
+extern const OpenAPI_stream_model_t OpenAPI_flows_stream;
+extern const OpenAPI_stream_model_t OpenAPI_fqdn_rm_stream;
+extern const OpenAPI_stream_model_t OpenAPI_frame_route_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_frame_route_info_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_gad_shape_stream;
+extern const OpenAPI_stream_model_t OpenAPI_gba_authentication_info_request_stream;
+extern const OpenAPI_stream_model_t OpenAPI_gba_authentication_info_result_stream;
+extern const OpenAPI_stream_model_t OpenAPI_gbr_qos_flow_information_stream;
+extern const OpenAPI_stream_model_t OpenAPI_geo_service_area_stream;
+extern const OpenAPI_stream_model_t OpenAPI_geo_service_area_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_geographic_area_stream;
+extern const OpenAPI_stream_model_t OpenAPI_geographical_area_stream;
+extern const OpenAPI_stream_model_t OpenAPI_geographical_coordinates_stream;
+extern const OpenAPI_stream_model_t OpenAPI_gera_location_stream;
+extern const OpenAPI_stream_model_t OpenAPI_get_multiple_pp_data_entries_ue_id_parameter_stream;
+extern const OpenAPI_stream_model_t OpenAPI_global_ran_node_id_stream;
+extern const OpenAPI_stream_model_t OpenAPI_global_ran_node_id_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_gmlc_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_gnb_id_stream;
+extern const OpenAPI_stream_model_t OpenAPI_group_identifiers_stream;
+extern const OpenAPI_stream_model_t OpenAPI_guami_stream;
+extern const OpenAPI_stream_model_t OpenAPI_guami_list_cond_stream;
+extern const OpenAPI_stream_model_t OpenAPI_hfc_node_id_stream;
+extern const OpenAPI_stream_model_t OpenAPI_hsmf_update_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_hsmf_update_error_stream;
+extern const OpenAPI_stream_model_t OpenAPI_hsmf_updated_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_hss_authentication_info_request_stream;
+extern const OpenAPI_stream_model_t OpenAPI_hss_authentication_info_result_stream;
+extern const OpenAPI_stream_model_t OpenAPI_hss_authentication_vectors_stream;
+extern const OpenAPI_stream_model_t OpenAPI_hss_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_hss_subscription_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_hss_subscription_item_stream;
+extern const OpenAPI_stream_model_t OpenAPI_id_translation_result_stream;
+extern const OpenAPI_stream_model_t OpenAPI_identity_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_identity_range_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ie_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_immediate_mdt_conf_stream;
+extern const OpenAPI_stream_model_t OpenAPI_immediate_report_stream;
+extern const OpenAPI_stream_model_t OpenAPI_imsi_range_stream;
+extern const OpenAPI_stream_model_t OpenAPI_indirect_data_forwarding_tunnel_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_intended_n32_purpose_stream;
+extern const OpenAPI_stream_model_t OpenAPI_inter_freq_target_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_inter_freq_target_info_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_interface_upf_info_item_stream;
+extern const OpenAPI_stream_model_t OpenAPI_internal_group_id_range_stream;
+extern const OpenAPI_stream_model_t OpenAPI_invalid_param_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ip_addr_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ip_addr_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ip_address_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ip_address_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ip_end_point_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ip_eth_flow_description_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ip_index_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ip_multicast_address_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ip_sm_gw_guidance_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ip_sm_gw_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ip_sm_gw_registration_stream;
+extern const OpenAPI_stream_model_t OpenAPI_iptv_config_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_iptv_config_data_patch_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ipv4_address_range_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ipv6_prefix_range_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ipx_provider_sec_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_iwmsc_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_key_amf_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ladn_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_lcs_broadcast_assistance_types_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_lcs_client_external_stream;
+extern const OpenAPI_stream_model_t OpenAPI_lcs_client_group_external_stream;
+extern const OpenAPI_stream_model_t OpenAPI_lcs_mo_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_lcs_privacy_stream;
+extern const OpenAPI_stream_model_t OpenAPI_lcs_privacy_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_limit_id_to_monitoring_key_stream;
+extern const OpenAPI_stream_model_t OpenAPI_link_stream;
+extern const OpenAPI_stream_model_t OpenAPI_links_value_schema_stream;
+extern const OpenAPI_stream_model_t OpenAPI_lmf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_local2d_point_uncertainty_ellipse_stream;
+extern const OpenAPI_stream_model_t OpenAPI_local2d_point_uncertainty_ellipse_all_of_stream;
+extern const OpenAPI_stream_model_t OpenAPI_local3d_point_uncertainty_ellipsoid_stream;
+extern const OpenAPI_stream_model_t OpenAPI_local3d_point_uncertainty_ellipsoid_all_of_stream;
+extern const OpenAPI_stream_model_t OpenAPI_local_origin_stream;
+extern const OpenAPI_stream_model_t OpenAPI_location_accuracy_stream;
+extern const OpenAPI_stream_model_t OpenAPI_location_area_stream;
+extern const OpenAPI_stream_model_t OpenAPI_location_area_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_location_area_id_stream;
+extern const OpenAPI_stream_model_t OpenAPI_location_filter_stream;
+extern const OpenAPI_stream_model_t OpenAPI_location_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_location_reporting_configuration_stream;
+extern const OpenAPI_stream_model_t OpenAPI_location_reporting_configuration_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_loss_connectivity_cfg_stream;
+extern const OpenAPI_stream_model_t OpenAPI_loss_connectivity_cfg_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_lpi_stream;
+extern const OpenAPI_stream_model_t OpenAPI_lte_m_ind_stream;
+extern const OpenAPI_stream_model_t OpenAPI_lte_v2x_auth_stream;
+extern const OpenAPI_stream_model_t OpenAPI_mapping_of_snssai_stream;
+extern const OpenAPI_stream_model_t OpenAPI_matching_direction_stream;
+extern const OpenAPI_stream_model_t OpenAPI_mb_smf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_mb_upf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_mbs_binding_resp_stream;
+extern const OpenAPI_stream_model_t OpenAPI_mbs_ext_problem_details_stream;
+extern const OpenAPI_stream_model_t OpenAPI_mbs_service_area_stream;
+extern const OpenAPI_stream_model_t OpenAPI_mbs_service_area_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_mbs_session_stream;
+extern const OpenAPI_stream_model_t OpenAPI_mbs_session_id_stream;
+extern const OpenAPI_stream_model_t OpenAPI_mbs_session_id_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_mbs_subscription_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_mbs_subscription_data_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_mbsfn_area_stream;
+extern const OpenAPI_stream_model_t OpenAPI_mdt_configuration_stream;
+extern const OpenAPI_stream_model_t OpenAPI_mdt_configuration_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_media_component_stream;
+extern const OpenAPI_stream_model_t OpenAPI_media_component_rm_stream;
+extern const OpenAPI_stream_model_t OpenAPI_media_sub_component_stream;
+extern const OpenAPI_stream_model_t OpenAPI_media_sub_component_rm_stream;
+extern const OpenAPI_stream_model_t OpenAPI_message_waiting_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_mfaf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ml_analytics_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_mm_context_stream;
+extern const OpenAPI_stream_model_t OpenAPI_mme_capabilities_stream;
+extern const OpenAPI_stream_model_t OpenAPI_mnpf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_mo_exp_data_counter_stream;
+extern const OpenAPI_stream_model_t OpenAPI_model_3_g_aka_av_stream;
+extern const OpenAPI_stream_model_t OpenAPI_model_5_g_ddnmf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_model_5_gvn_group_configuration_stream;
+extern const OpenAPI_stream_model_t OpenAPI_model_5_gvn_group_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_model_5_mbs_authorization_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_modification_notification_stream;
+extern const OpenAPI_stream_model_t OpenAPI_modify_200_response_stream;
+extern const OpenAPI_stream_model_t OpenAPI_modifysubscription_data_subscription_200_response_stream;
+extern const OpenAPI_stream_model_t OpenAPI_monitoring_configuration_stream;
+extern const OpenAPI_stream_model_t OpenAPI_monitoring_configuration_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_mtc_provider_stream;
+extern const OpenAPI_stream_model_t OpenAPI_multicast_access_control_stream;
+extern const OpenAPI_stream_model_t OpenAPI_n1_message_container_stream;
+extern const OpenAPI_stream_model_t OpenAPI_n1_message_notification_stream;
+extern const OpenAPI_stream_model_t OpenAPI_n1_n2_message_transfer_error_stream;
+extern const OpenAPI_stream_model_t OpenAPI_n1_n2_message_transfer_req_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_n1_n2_message_transfer_rsp_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_n1_n2_msg_txfr_err_detail_stream;
+extern const OpenAPI_stream_model_t OpenAPI_n1_n2_msg_txfr_failure_notification_stream;
+extern const OpenAPI_stream_model_t OpenAPI_n2_info_container_stream;
+extern const OpenAPI_stream_model_t OpenAPI_n2_info_content_stream;
+extern const OpenAPI_stream_model_t OpenAPI_n2_info_notification_rsp_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_n2_info_notify_handover_complete_200_response_stream;
+extern const OpenAPI_stream_model_t OpenAPI_n2_info_notify_request_stream;
+extern const OpenAPI_stream_model_t OpenAPI_n2_information_notification_stream;
+extern const OpenAPI_stream_model_t OpenAPI_n2_information_transfer_error_stream;
+extern const OpenAPI_stream_model_t OpenAPI_n2_information_transfer_req_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_n2_information_transfer_rsp_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_n2_interface_amf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_n2_ran_information_stream;
+extern const OpenAPI_stream_model_t OpenAPI_n2_sm_information_stream;
+extern const OpenAPI_stream_model_t OpenAPI_n32f_context_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_n32f_error_detail_stream;
+extern const OpenAPI_stream_model_t OpenAPI_n32f_error_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_n3ga_location_stream;
+extern const OpenAPI_stream_model_t OpenAPI_n4_information_stream;
+extern const OpenAPI_stream_model_t OpenAPI_namf_subscription_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nas_security_mode_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ncgi_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ncgi_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ncgi_tai_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nef_cond_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nef_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_network_area_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_network_area_info_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_network_area_info_2_stream;
+extern const OpenAPI_stream_model_t OpenAPI_network_node_diameter_address_stream;
+extern const OpenAPI_stream_model_t OpenAPI_network_node_diameter_address_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_network_perf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_network_perf_requirement_stream;
+extern const OpenAPI_stream_model_t OpenAPI_network_perf_type_stream;
+extern const OpenAPI_stream_model_t OpenAPI_network_slice_cond_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nf_group_cond_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nf_group_list_cond_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nf_identifier_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nf_instance_id_cond_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nf_instance_id_list_cond_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nf_instance_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nf_load_level_information_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nf_profile_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nf_service_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nf_service_instance_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nf_service_set_cond_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nf_service_version_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nf_set_cond_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nf_type_cond_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ng_ap_cause_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ng_ksi_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ng_ran_target_id_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nidd_authorization_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nidd_information_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nidd_information_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nnwdaf_events_subscription_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nnwdaf_nf_status_stream;
+extern const OpenAPI_stream_model_t OpenAPI_no_profile_match_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_no_profile_match_reason_stream;
+extern const OpenAPI_stream_model_t OpenAPI_non_dynamic5_qi_stream;
+extern const OpenAPI_stream_model_t OpenAPI_non_ue_n2_info_notify_request_stream;
+extern const OpenAPI_stream_model_t OpenAPI_non_ue_n2_info_subscription_create_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_non_ue_n2_info_subscription_created_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_non_ue_n2_message_transfer_request_stream;
+extern const OpenAPI_stream_model_t OpenAPI_notif_condition_stream;
+extern const OpenAPI_stream_model_t OpenAPI_notification_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_notification_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_notification_item_stream;
+extern const OpenAPI_stream_model_t OpenAPI_notification_method_stream;
+extern const OpenAPI_stream_model_t OpenAPI_notification_method_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_notify_item_stream;
+extern const OpenAPI_stream_model_t OpenAPI_npn_access_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nr_location_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nr_v2x_auth_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nrf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nrf_info_served_aanf_info_list_value_value_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nrf_info_served_amf_info_value_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nrf_info_served_ausf_info_value_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nrf_info_served_bsf_info_value_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nrf_info_served_chf_info_value_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nrf_info_served_gmlc_info_value_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nrf_info_served_hss_info_list_value_value_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nrf_info_served_lmf_info_value_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nrf_info_served_mb_smf_info_list_value_value_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nrf_info_served_nef_info_value_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nrf_info_served_nwdaf_info_value_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nrf_info_served_pcf_info_value_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nrf_info_served_pcscf_info_list_value_value_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nrf_info_served_scp_info_list_value_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nrf_info_served_sepp_info_list_value_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nrf_info_served_smf_info_value_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nrf_info_served_udm_info_value_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nrf_info_served_udr_info_value_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nrf_info_served_udsf_info_value_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nrf_info_served_upf_info_value_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nrppa_information_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nsacf_capability_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nsacf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nsag_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nsi_id_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nsi_information_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nsi_load_level_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nssaa_status_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nssaaf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nssai_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nssai_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nssai_ack_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nssai_mapping_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nudm_amf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_number_average_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nwdaf_capability_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nwdaf_cond_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nwdaf_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nwdaf_event_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nwdaf_failure_code_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nwdaf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nwdaf_registration_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nwdaf_registration_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nwdaf_registration_modification_stream;
+extern const OpenAPI_stream_model_t OpenAPI_nwdaf_subscription_stream;
+extern const OpenAPI_stream_model_t OpenAPI_object_stream;
+extern const OpenAPI_stream_model_t OpenAPI_observed_redundant_trans_exp_stream;
+extern const OpenAPI_stream_model_t OpenAPI_odb_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_operator_specific_data_container_stream;
+extern const OpenAPI_stream_model_t OpenAPI_operator_specific_data_container_value_stream;
+extern const OpenAPI_stream_model_t OpenAPI_options_response_stream;
+extern const OpenAPI_stream_model_t OpenAPI_out_of_credit_information_stream;
+extern const OpenAPI_stream_model_t OpenAPI_output_strategy_stream;
+extern const OpenAPI_stream_model_t OpenAPI_packet_filter_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_parameter_combination_stream;
+extern const OpenAPI_stream_model_t OpenAPI_partial_record_method_stream;
+extern const OpenAPI_stream_model_t OpenAPI_partial_success_report_stream;
+extern const OpenAPI_stream_model_t OpenAPI_patch_item_stream;
+extern const OpenAPI_stream_model_t OpenAPI_patch_result_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pc5_flow_bit_rates_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pc5_qo_s_para_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pc5_qos_flow_item_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pcc_rule_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pcf_addressing_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pcf_binding_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pcf_binding_patch_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pcf_for_pdu_session_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pcf_for_ue_binding_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pcf_for_ue_binding_patch_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pcf_for_ue_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pcf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pcf_mbs_binding_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pcf_mbs_binding_patch_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pcf_selection_assistance_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pcf_selection_assistance_info_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pcf_ue_callback_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pcscf_address_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pcscf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pcscf_restoration_notification_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pcscf_restoration_request_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pdu_session_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pdu_session_context_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pdu_session_create_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pdu_session_create_error_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pdu_session_created_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pdu_session_event_notification_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pdu_session_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pdu_session_management_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pdu_session_notify_item_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pdu_session_status_cfg_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pdu_session_status_cfg_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pdu_session_tsn_bridge_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pdu_session_types_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pdu_session_types_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pei_update_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_perf_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_periodicity_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pfd_change_notification_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pfd_content_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pfd_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pfd_data_for_app_ext_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pgw_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_plmn_ec_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_plmn_ec_info_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_plmn_id_stream;
+extern const OpenAPI_stream_model_t OpenAPI_plmn_id_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_plmn_id_nid_stream;
+extern const OpenAPI_stream_model_t OpenAPI_plmn_id_nid_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_plmn_oauth2_stream;
+extern const OpenAPI_stream_model_t OpenAPI_plmn_operator_class_stream;
+extern const OpenAPI_stream_model_t OpenAPI_plmn_range_stream;
+extern const OpenAPI_stream_model_t OpenAPI_plmn_restriction_stream;
+extern const OpenAPI_stream_model_t OpenAPI_plmn_restriction_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_plmn_route_selection_descriptor_stream;
+extern const OpenAPI_stream_model_t OpenAPI_plmn_snssai_stream;
+extern const OpenAPI_stream_model_t OpenAPI_point_stream;
+extern const OpenAPI_stream_model_t OpenAPI_point_all_of_stream;
+extern const OpenAPI_stream_model_t OpenAPI_point_altitude_stream;
+extern const OpenAPI_stream_model_t OpenAPI_point_altitude_all_of_stream;
+extern const OpenAPI_stream_model_t OpenAPI_point_altitude_uncertainty_stream;
+extern const OpenAPI_stream_model_t OpenAPI_point_altitude_uncertainty_all_of_stream;
+extern const OpenAPI_stream_model_t OpenAPI_point_uncertainty_circle_stream;
+extern const OpenAPI_stream_model_t OpenAPI_point_uncertainty_circle_all_of_stream;
+extern const OpenAPI_stream_model_t OpenAPI_point_uncertainty_ellipse_stream;
+extern const OpenAPI_stream_model_t OpenAPI_point_uncertainty_ellipse_all_of_stream;
+extern const OpenAPI_stream_model_t OpenAPI_policy_association_stream;
+extern const OpenAPI_stream_model_t OpenAPI_policy_association_request_stream;
+extern const OpenAPI_stream_model_t OpenAPI_policy_association_update_request_stream;
+extern const OpenAPI_stream_model_t OpenAPI_policy_data_change_notification_stream;
+extern const OpenAPI_stream_model_t OpenAPI_policy_data_for_individual_ue_stream;
+extern const OpenAPI_stream_model_t OpenAPI_policy_data_subscription_stream;
+extern const OpenAPI_stream_model_t OpenAPI_policy_data_subset_stream;
+extern const OpenAPI_stream_model_t OpenAPI_policy_update_stream;
+extern const OpenAPI_stream_model_t OpenAPI_polygon_stream;
+extern const OpenAPI_stream_model_t OpenAPI_polygon_all_of_stream;
+extern const OpenAPI_stream_model_t OpenAPI_port_management_container_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pp5g_vn_group_profile_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pp_active_time_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pp_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pp_data_entry_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pp_data_entry_list_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pp_dl_packet_count_ext_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pp_maximum_latency_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pp_maximum_response_time_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pp_profile_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pp_subs_reg_timer_stream;
+extern const OpenAPI_stream_model_t OpenAPI_preemption_capability_rm_stream;
+extern const OpenAPI_stream_model_t OpenAPI_preemption_control_information_rm_stream;
+extern const OpenAPI_stream_model_t OpenAPI_preemption_vulnerability_rm_stream;
+extern const OpenAPI_stream_model_t OpenAPI_preferred_search_stream;
+extern const OpenAPI_stream_model_t OpenAPI_presence_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_presence_info_rm_stream;
+extern const OpenAPI_stream_model_t OpenAPI_prev_sub_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pro_se_allowed_plmn_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pro_se_auth_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pro_se_authentication_ctx_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pro_se_authentication_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pro_se_authentication_info_request_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pro_se_authentication_info_result_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pro_se_authentication_result_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pro_se_authentication_vectors_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pro_se_capability_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pro_se_eap_session_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pro_se_information_stream;
+extern const OpenAPI_stream_model_t OpenAPI_problem_details_stream;
+extern const OpenAPI_stream_model_t OpenAPI_problem_details_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_problem_details_add_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_prose_context_stream;
+extern const OpenAPI_stream_model_t OpenAPI_prose_service_auth_stream;
+extern const OpenAPI_stream_model_t OpenAPI_prose_subscription_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_protection_policy_stream;
+extern const OpenAPI_stream_model_t OpenAPI_provisioned_data_sets_stream;
+extern const OpenAPI_stream_model_t OpenAPI_psa_information_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ptw_parameters_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ptw_parameters_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pws_error_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pws_information_stream;
+extern const OpenAPI_stream_model_t OpenAPI_pws_response_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_qos_characteristics_stream;
+extern const OpenAPI_stream_model_t OpenAPI_qos_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_qos_flow_add_modify_request_item_stream;
+extern const OpenAPI_stream_model_t OpenAPI_qos_flow_item_stream;
+extern const OpenAPI_stream_model_t OpenAPI_qos_flow_notify_item_stream;
+extern const OpenAPI_stream_model_t OpenAPI_qos_flow_profile_stream;
+extern const OpenAPI_stream_model_t OpenAPI_qos_flow_release_request_item_stream;
+extern const OpenAPI_stream_model_t OpenAPI_qos_flow_setup_item_stream;
+extern const OpenAPI_stream_model_t OpenAPI_qos_flow_tunnel_stream;
+extern const OpenAPI_stream_model_t OpenAPI_qos_flow_usage_report_stream;
+extern const OpenAPI_stream_model_t OpenAPI_qos_monitoring_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_qos_monitoring_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_qos_monitoring_information_stream;
+extern const OpenAPI_stream_model_t OpenAPI_qos_monitoring_information_rm_stream;
+extern const OpenAPI_stream_model_t OpenAPI_qos_monitoring_report_stream;
+extern const OpenAPI_stream_model_t OpenAPI_qos_notification_control_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_qos_requirement_stream;
+extern const OpenAPI_stream_model_t OpenAPI_qos_sustainability_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_query_param_combination_stream;
+extern const OpenAPI_stream_model_t OpenAPI_query_parameter_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ran_nas_rel_cause_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ranking_criterion_stream;
+extern const OpenAPI_stream_model_t OpenAPI_rat_freq_information_stream;
+extern const OpenAPI_stream_model_t OpenAPI_reachability_filter_stream;
+extern const OpenAPI_stream_model_t OpenAPI_reachability_for_data_configuration_stream;
+extern const OpenAPI_stream_model_t OpenAPI_reachability_for_data_configuration_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_reachability_for_data_report_config_stream;
+extern const OpenAPI_stream_model_t OpenAPI_reachability_for_sms_configuration_stream;
+extern const OpenAPI_stream_model_t OpenAPI_red_trans_exp_ordering_criterion_stream;
+extern const OpenAPI_stream_model_t OpenAPI_redirect_information_stream;
+extern const OpenAPI_stream_model_t OpenAPI_redirect_response_stream;
+extern const OpenAPI_stream_model_t OpenAPI_redundant_pdu_session_information_stream;
+extern const OpenAPI_stream_model_t OpenAPI_redundant_transmission_exp_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_redundant_transmission_exp_per_ts_stream;
+extern const OpenAPI_stream_model_t OpenAPI_redundant_transmission_exp_req_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ref_to_binary_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_registration_context_container_stream;
+extern const OpenAPI_stream_model_t OpenAPI_registration_data_sets_stream;
+extern const OpenAPI_stream_model_t OpenAPI_registration_location_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_relative_cartesian_location_stream;
+extern const OpenAPI_stream_model_t OpenAPI_release_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_release_pdu_session_200_response_stream;
+extern const OpenAPI_stream_model_t OpenAPI_release_pdu_session_request_stream;
+extern const OpenAPI_stream_model_t OpenAPI_release_session_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_release_sm_context_request_stream;
+extern const OpenAPI_stream_model_t OpenAPI_released_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_relocate_ue_context_request_stream;
+extern const OpenAPI_stream_model_t OpenAPI_report_item_stream;
+extern const OpenAPI_stream_model_t OpenAPI_reporting_information_stream;
+extern const OpenAPI_stream_model_t OpenAPI_reporting_options_stream;
+extern const OpenAPI_stream_model_t OpenAPI_reporting_options_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_requested_qos_stream;
+extern const OpenAPI_stream_model_t OpenAPI_requested_rule_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_requested_usage_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_resource_item_stream;
+extern const OpenAPI_stream_model_t OpenAPI_resource_usage_stream;
+extern const OpenAPI_stream_model_t OpenAPI_resources_allocation_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_resynchronization_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_resynchronization_info_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_retainability_threshold_stream;
+extern const OpenAPI_stream_model_t OpenAPI_retrieve_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_retrieved_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_rg_auth_ctx_stream;
+extern const OpenAPI_stream_model_t OpenAPI_rg_authentication_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_rm_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_rm_state_stream;
+extern const OpenAPI_stream_model_t OpenAPI_roaming_charging_profile_stream;
+extern const OpenAPI_stream_model_t OpenAPI_roaming_info_update_stream;
+extern const OpenAPI_stream_model_t OpenAPI_roaming_restrictions_stream;
+extern const OpenAPI_stream_model_t OpenAPI_route_information_stream;
+extern const OpenAPI_stream_model_t OpenAPI_route_selection_parameter_set_stream;
+extern const OpenAPI_stream_model_t OpenAPI_route_to_location_stream;
+extern const OpenAPI_stream_model_t OpenAPI_routing_area_id_stream;
+extern const OpenAPI_stream_model_t OpenAPI_routing_info_sm_request_stream;
+extern const OpenAPI_stream_model_t OpenAPI_routing_info_sm_response_stream;
+extern const OpenAPI_stream_model_t OpenAPI_rule_report_stream;
+extern const OpenAPI_stream_model_t OpenAPI_scheduled_communication_time_stream;
+extern const OpenAPI_stream_model_t OpenAPI_scheduled_communication_time_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_scheduled_communication_time_rm_stream;
+extern const OpenAPI_stream_model_t OpenAPI_scheduled_communication_type_rm_stream;
+extern const OpenAPI_stream_model_t OpenAPI_scp_domain_cond_stream;
+extern const OpenAPI_stream_model_t OpenAPI_scp_domain_connectivity_stream;
+extern const OpenAPI_stream_model_t OpenAPI_scp_domain_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_scp_domain_routing_info_notification_stream;
+extern const OpenAPI_stream_model_t OpenAPI_scp_domain_routing_info_subscription_stream;
+extern const OpenAPI_stream_model_t OpenAPI_scp_domain_routing_information_stream;
+extern const OpenAPI_stream_model_t OpenAPI_scp_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sd_range_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sdm_subs_modification_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sdm_subscription_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sdm_subscription_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_seaf_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_search_result_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sec_negotiate_req_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sec_negotiate_rsp_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sec_param_exch_req_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sec_param_exch_rsp_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_secondary_rat_usage_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_secondary_rat_usage_report_stream;
+extern const OpenAPI_stream_model_t OpenAPI_security_result_stream;
+extern const OpenAPI_stream_model_t OpenAPI_send_mo_data_req_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_send_mo_data_request_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sepp_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sequence_number_stream;
+extern const OpenAPI_stream_model_t OpenAPI_server_addressing_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_service_area_coverage_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_service_area_id_stream;
+extern const OpenAPI_stream_model_t OpenAPI_service_area_restriction_stream;
+extern const OpenAPI_stream_model_t OpenAPI_service_area_restriction_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_service_experience_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_service_experience_type_stream;
+extern const OpenAPI_stream_model_t OpenAPI_service_name_cond_stream;
+extern const OpenAPI_stream_model_t OpenAPI_service_name_list_cond_stream;
+extern const OpenAPI_stream_model_t OpenAPI_service_parameter_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_service_parameter_data_patch_stream;
+extern const OpenAPI_stream_model_t OpenAPI_service_specific_authorization_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_service_type_stream;
+extern const OpenAPI_stream_model_t OpenAPI_service_type_unrelated_class_stream;
+extern const OpenAPI_stream_model_t OpenAPI_serving_nf_identity_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sess_inact_timer_for_ue_comm_stream;
+extern const OpenAPI_stream_model_t OpenAPI_session_management_subscription_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_session_management_subscription_data_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_session_rule_stream;
+extern const OpenAPI_stream_model_t OpenAPI_session_rule_report_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sgsn_address_stream;
+extern const OpenAPI_stream_model_t OpenAPI_shared_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_shared_data_id_range_stream;
+extern const OpenAPI_stream_model_t OpenAPI_slice_info_for_pdu_session_stream;
+extern const OpenAPI_stream_model_t OpenAPI_slice_info_for_registration_stream;
+extern const OpenAPI_stream_model_t OpenAPI_slice_info_for_ue_configuration_update_stream;
+extern const OpenAPI_stream_model_t OpenAPI_slice_load_level_information_stream;
+extern const OpenAPI_stream_model_t OpenAPI_slice_mbr_stream;
+extern const OpenAPI_stream_model_t OpenAPI_slice_mbr_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_slice_mbr_rm_stream;
+extern const OpenAPI_stream_model_t OpenAPI_slice_policy_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sm_context_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sm_context_create_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sm_context_create_error_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sm_context_created_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sm_context_release_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sm_context_released_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sm_context_retrieve_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sm_context_retrieved_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sm_context_status_notification_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sm_context_update_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sm_context_update_error_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sm_context_updated_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sm_policy_context_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sm_policy_control_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sm_policy_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sm_policy_data_patch_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sm_policy_decision_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sm_policy_delete_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sm_policy_dnn_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sm_policy_dnn_data_patch_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sm_policy_notification_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sm_policy_snssai_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sm_policy_snssai_data_patch_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sm_policy_update_context_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sm_subs_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_small_data_rate_status_stream;
+extern const OpenAPI_stream_model_t OpenAPI_small_data_rate_status_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_smcce_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_smcce_ue_list_stream;
+extern const OpenAPI_stream_model_t OpenAPI_smf_change_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_smf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_smf_registration_stream;
+extern const OpenAPI_stream_model_t OpenAPI_smf_registration_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_smf_registration_modification_stream;
+extern const OpenAPI_stream_model_t OpenAPI_smf_selection_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_smf_selection_subscription_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_smf_subscription_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_smf_subscription_item_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sms_management_subscription_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sms_management_subscription_data_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sms_router_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sms_subscription_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sms_subscription_data_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_smsc_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_smsf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_smsf_registration_stream;
+extern const OpenAPI_stream_model_t OpenAPI_snssai_stream;
+extern const OpenAPI_stream_model_t OpenAPI_snssai_dnn_pair_stream;
+extern const OpenAPI_stream_model_t OpenAPI_snssai_easdf_info_item_stream;
+extern const OpenAPI_stream_model_t OpenAPI_snssai_extension_stream;
+extern const OpenAPI_stream_model_t OpenAPI_snssai_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_snssai_info_item_stream;
+extern const OpenAPI_stream_model_t OpenAPI_snssai_mb_smf_info_item_stream;
+extern const OpenAPI_stream_model_t OpenAPI_snssai_route_selection_descriptor_stream;
+extern const OpenAPI_stream_model_t OpenAPI_snssai_smf_info_item_stream;
+extern const OpenAPI_stream_model_t OpenAPI_snssai_tsctsf_info_item_stream;
+extern const OpenAPI_stream_model_t OpenAPI_snssai_upf_info_item_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sor_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sor_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sor_info_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sor_update_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_spatial_validity_stream;
+extern const OpenAPI_stream_model_t OpenAPI_spatial_validity_cond_stream;
+extern const OpenAPI_stream_model_t OpenAPI_spatial_validity_cond_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_spatial_validity_rm_stream;
+extern const OpenAPI_stream_model_t OpenAPI_sponsor_connectivity_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ssc_modes_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ssc_modes_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ssm_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ssm_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_stationary_indication_rm_stream;
+extern const OpenAPI_stream_model_t OpenAPI_status_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_status_notification_stream;
+extern const OpenAPI_stream_model_t OpenAPI_steering_container_stream;
+extern const OpenAPI_stream_model_t OpenAPI_steering_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_steering_mode_stream;
+extern const OpenAPI_stream_model_t OpenAPI_stored_search_result_stream;
+extern const OpenAPI_stream_model_t OpenAPI_subscr_cond_stream;
+extern const OpenAPI_stream_model_t OpenAPI_subscribed_default_qos_stream;
+extern const OpenAPI_stream_model_t OpenAPI_subscribed_default_qos_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_subscribed_event_stream;
+extern const OpenAPI_stream_model_t OpenAPI_subscribed_snssai_stream;
+extern const OpenAPI_stream_model_t OpenAPI_subscription_context_stream;
+extern const OpenAPI_stream_model_t OpenAPI_subscription_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_subscription_data_sets_stream;
+extern const OpenAPI_stream_model_t OpenAPI_subscription_data_subscriptions_stream;
+extern const OpenAPI_stream_model_t OpenAPI_suci_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_suggested_packet_num_dl_stream;
+extern const OpenAPI_stream_model_t OpenAPI_suggested_packet_num_dl_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_supi_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_supi_range_stream;
+extern const OpenAPI_stream_model_t OpenAPI_supported_gad_shapes_stream;
+extern const OpenAPI_stream_model_t OpenAPI_svc_experience_stream;
+extern const OpenAPI_stream_model_t OpenAPI_tac_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_tac_range_stream;
+extern const OpenAPI_stream_model_t OpenAPI_tai_stream;
+extern const OpenAPI_stream_model_t OpenAPI_tai_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_tai_range_stream;
+extern const OpenAPI_stream_model_t OpenAPI_target_area_stream;
+extern const OpenAPI_stream_model_t OpenAPI_target_dnai_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_target_ue_information_stream;
+extern const OpenAPI_stream_model_t OpenAPI_temporal_validity_stream;
+extern const OpenAPI_stream_model_t OpenAPI_termination_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_termination_notification_stream;
+extern const OpenAPI_stream_model_t OpenAPI_threshold_level_stream;
+extern const OpenAPI_stream_model_t OpenAPI_threshold_value_stream;
+extern const OpenAPI_stream_model_t OpenAPI_time_period_stream;
+extern const OpenAPI_stream_model_t OpenAPI_time_unit_stream;
+extern const OpenAPI_stream_model_t OpenAPI_time_window_stream;
+extern const OpenAPI_stream_model_t OpenAPI_tmgi_stream;
+extern const OpenAPI_stream_model_t OpenAPI_tmgi_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_tmgi_range_stream;
+extern const OpenAPI_stream_model_t OpenAPI_tnap_id_stream;
+extern const OpenAPI_stream_model_t OpenAPI_tngf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_top_application_stream;
+extern const OpenAPI_stream_model_t OpenAPI_trace_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_trace_data_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_trace_data_response_stream;
+extern const OpenAPI_stream_model_t OpenAPI_traffic_characterization_stream;
+extern const OpenAPI_stream_model_t OpenAPI_traffic_control_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_traffic_descriptor_stream;
+extern const OpenAPI_stream_model_t OpenAPI_traffic_descriptor_components_stream;
+extern const OpenAPI_stream_model_t OpenAPI_traffic_influ_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_traffic_influ_data_notif_stream;
+extern const OpenAPI_stream_model_t OpenAPI_traffic_influ_data_patch_stream;
+extern const OpenAPI_stream_model_t OpenAPI_traffic_influ_sub_stream;
+extern const OpenAPI_stream_model_t OpenAPI_traffic_information_stream;
+extern const OpenAPI_stream_model_t OpenAPI_traffic_profile_rm_stream;
+extern const OpenAPI_stream_model_t OpenAPI_transfer_mo_data_req_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_transfer_mo_data_request_stream;
+extern const OpenAPI_stream_model_t OpenAPI_transfer_mt_data_add_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_transfer_mt_data_error_stream;
+extern const OpenAPI_stream_model_t OpenAPI_transfer_mt_data_ismf_request_stream;
+extern const OpenAPI_stream_model_t OpenAPI_transfer_mt_data_req_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_transfer_policy_stream;
+extern const OpenAPI_stream_model_t OpenAPI_trigger_stream;
+extern const OpenAPI_stream_model_t OpenAPI_trigger_category_stream;
+extern const OpenAPI_stream_model_t OpenAPI_trigger_request_stream;
+extern const OpenAPI_stream_model_t OpenAPI_trigger_type_stream;
+extern const OpenAPI_stream_model_t OpenAPI_trust_af_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_tscai_input_container_stream;
+extern const OpenAPI_stream_model_t OpenAPI_tsctsf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_tsn_bridge_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_tsn_qos_container_stream;
+extern const OpenAPI_stream_model_t OpenAPI_tsn_qos_container_rm_stream;
+extern const OpenAPI_stream_model_t OpenAPI_tunnel_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_twap_id_stream;
+extern const OpenAPI_stream_model_t OpenAPI_twif_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_uc_subscription_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_udm_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_udr_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_udsf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_analytics_context_descriptor_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_authentication_ctx_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_authentication_ctx_5g_auth_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_camping_rep_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_communication_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_context_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_context_cancel_relocate_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_context_create_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_context_create_error_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_context_created_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_context_in_amf_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_context_in_smf_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_context_in_smf_data_sub_filter_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_context_in_smf_data_sub_filter_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_context_in_smsf_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_context_release_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_context_relocate_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_context_relocated_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_context_transfer_200_response_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_context_transfer_req_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_context_transfer_request_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_context_transfer_rsp_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_differentiation_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_id_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_identity_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_in_area_filter_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_initiated_resource_request_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_mobility_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_n1_n2_info_subscription_create_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_n1_n2_info_subscription_created_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_policy_section_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_policy_set_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_policy_set_patch_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_reachability_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_reg_status_update_req_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_reg_status_update_rsp_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_slice_mbr_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ue_type_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ulcl_bp_information_stream;
+extern const OpenAPI_stream_model_t OpenAPI_umt_time_stream;
+extern const OpenAPI_stream_model_t OpenAPI_umt_time_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_un_trust_af_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_uncertainty_ellipse_stream;
+extern const OpenAPI_stream_model_t OpenAPI_uncertainty_ellipsoid_stream;
+extern const OpenAPI_stream_model_t OpenAPI_unrelated_class_stream;
+extern const OpenAPI_stream_model_t OpenAPI_up_path_chg_event_stream;
+extern const OpenAPI_stream_model_t OpenAPI_up_security_stream;
+extern const OpenAPI_stream_model_t OpenAPI_up_security_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_up_security_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_update_nwdaf_registration_200_response_stream;
+extern const OpenAPI_stream_model_t OpenAPI_update_pdu_session_200_response_stream;
+extern const OpenAPI_stream_model_t OpenAPI_update_pdu_session_400_response_stream;
+extern const OpenAPI_stream_model_t OpenAPI_update_pdu_session_request_stream;
+extern const OpenAPI_stream_model_t OpenAPI_update_sm_context_200_response_stream;
+extern const OpenAPI_stream_model_t OpenAPI_update_sm_context_400_response_stream;
+extern const OpenAPI_stream_model_t OpenAPI_update_sm_context_request_stream;
+extern const OpenAPI_stream_model_t OpenAPI_updated_item_stream;
+extern const OpenAPI_stream_model_t OpenAPI_updp_subscription_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_upf_cond_stream;
+extern const OpenAPI_stream_model_t OpenAPI_upf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_upf_information_stream;
+extern const OpenAPI_stream_model_t OpenAPI_upu_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_upu_data_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_upu_data_2_stream;
+extern const OpenAPI_stream_model_t OpenAPI_upu_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_upu_info_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_uri_list_stream;
+extern const OpenAPI_stream_model_t OpenAPI_ursp_rule_request_stream;
+extern const OpenAPI_stream_model_t OpenAPI_usage_mon_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_usage_mon_data_limit_stream;
+extern const OpenAPI_stream_model_t OpenAPI_usage_mon_data_scope_stream;
+extern const OpenAPI_stream_model_t OpenAPI_usage_mon_level_stream;
+extern const OpenAPI_stream_model_t OpenAPI_usage_monitoring_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_usage_threshold_stream;
+extern const OpenAPI_stream_model_t OpenAPI_usage_threshold_rm_stream;
+extern const OpenAPI_stream_model_t OpenAPI_user_data_congestion_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_user_identifier_stream;
+extern const OpenAPI_stream_model_t OpenAPI_user_location_stream;
+extern const OpenAPI_stream_model_t OpenAPI_utra_location_stream;
+extern const OpenAPI_stream_model_t OpenAPI_v2x_capability_stream;
+extern const OpenAPI_stream_model_t OpenAPI_v2x_context_stream;
+extern const OpenAPI_stream_model_t OpenAPI_v2x_information_stream;
+extern const OpenAPI_stream_model_t OpenAPI_v2x_subscription_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_valid_time_period_stream;
+extern const OpenAPI_stream_model_t OpenAPI_vendor_specific_feature_stream;
+extern const OpenAPI_stream_model_t OpenAPI_vgmlc_address_stream;
+extern const OpenAPI_stream_model_t OpenAPI_vn_group_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_volume_timed_report_stream;
+extern const OpenAPI_stream_model_t OpenAPI_vplmn_qos_stream;
+extern const OpenAPI_stream_model_t OpenAPI_vsmf_update_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_vsmf_update_error_stream;
+extern const OpenAPI_stream_model_t OpenAPI_vsmf_updated_data_stream;
+extern const OpenAPI_stream_model_t OpenAPI_w_agf_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_wireline_area_stream;
+extern const OpenAPI_stream_model_t OpenAPI_wireline_area_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_wireline_service_area_restriction_stream;
+extern const OpenAPI_stream_model_t OpenAPI_wireline_service_area_restriction_1_stream;
+extern const OpenAPI_stream_model_t OpenAPI_wlan_ordering_criterion_stream;
+extern const OpenAPI_stream_model_t OpenAPI_wlan_per_ss_id_performance_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_wlan_per_ts_performance_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_wlan_performance_info_stream;
+extern const OpenAPI_stream_model_t OpenAPI_wlan_performance_req_stream;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OpenAPI_stream_model_H_ */
@@ -0,0 +1,1188 @@
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/stream.h"
+#include "../include/list.h"
+#include "../include/keyValuePair.h"
+
+#define STREAM_MAX_DEPTH 64
+
+#define MEMBER(__tYPE, __dATA, __oFFSET) \
+    (*(__tYPE *)((char *)(__dATA) + (__oFFSET)))
+
+/*
+ * Writer
+ */
+typedef struct stream_writer_s {
+    char *buf;
+    size_t len;
+    size_t size;
+} stream_writer_t;
+
+static void writer_reserve(stream_writer_t *w, size_t n)
+{
+    size_t size;
+
+    if (w->len + n < w->size)
+        return;
+
+    size = w->size ? w->size : 256;
+    while (size <= w->len + n)
+        size *= 2;
+
+    w->buf = ogs_realloc(w->buf, size);
+    ogs_assert(w->buf);
+    w->size = size;
+}
+
+static void write_raw(stream_writer_t *w, const char *s, size_t n)
+{
+    writer_reserve(w, n);
+    memcpy(w->buf + w->len, s, n);
+    w->len += n;
+}
+
+static void write_char(stream_writer_t *w, char c)
+{
+    writer_reserve(w, 1);
+    w->buf[w->len++] = c;
+}
+
+/* Same escaping rules as print_string_ptr() in cJSON */
+static void write_string(stream_writer_t *w, const char *s)
+{
+    const unsigned char *p = NULL;
+    const unsigned char *run = NULL;
+
+    if (!s) {
+        write_raw(w, "\"\"", 2);
+        return;
+    }
+
+    write_char(w, '\"');
+
+    run = (const unsigned char *)s;
+    for (p = run; *p; p++) {
+        if (*p > 31 && *p != '\"' && *p != '\\')
+            continue;
+
+        write_raw(w, (const char *)run, p - run);
+        run = p + 1;
+
+        switch (*p) {
+        case '\\':
+            write_raw(w, "\\\\", 2);
+            break;
+        case '\"':
+            write_raw(w, "\\\"", 2);
+            break;
+        case '\b':
+            write_raw(w, "\\b", 2);
+            break;
+        case '\f':
+            write_raw(w, "\\f", 2);
+            break;
+        case '\n':
+            write_raw(w, "\\n", 2);
+            break;
+        case '\r':
+            write_raw(w, "\\r", 2);
+            break;
+        case '\t':
+            write_raw(w, "\\t", 2);
+            break;
+        default:
+            {
+                char escaped[7];
+                ogs_snprintf(escaped, sizeof(escaped), "\\u%04x", *p);
+                write_raw(w, escaped, 6);
+            }
+            break;
+        }
+    }
+    write_raw(w, (const char *)run, p - run);
+
+    write_char(w, '\"');
+}
+
+/* Same rendering as cJSON_CreateNumber() followed by print_number() */
+static bool write_number(stream_writer_t *w, double d)
+{
+    char number[26];
+    int valueint;
+    int length;
+    double test = 0.0;
+
+    if (isnan(d) || isinf(d)) {
+        write_raw(w, "null", 4);
+        return true;
+    }
+
+    if (d >= INT_MAX)
+        valueint = INT_MAX;
+    else if (d <= (double)INT_MIN)
+        valueint = INT_MIN;
+    else
+        valueint = (int)d;
+
+    if (d == (double)valueint) {
+        length = sprintf(number, "%d", valueint);
+    } else {
+        length = sprintf(number, "%1.15g", d);
+        if (sscanf(number, "%lg", &test) != 1 ||
+            !(fabs(test - d) <=
+                (fabs(test) > fabs(d) ? fabs(test) : fabs(d)) * DBL_EPSILON))
+            length = sprintf(number, "%1.17g", d);
+    }
+
+    if (length < 0 || length > (int)(sizeof(number) - 1))
+        return false;
+
+    write_raw(w, number, length);
+    return true;
+}
+
+static bool write_model(stream_writer_t *w,
+        const OpenAPI_stream_model_t *model, void *data, int depth);
+
+static double member_number(const OpenAPI_stream_field_t *field, void *data)
+{
+    switch (field->ctype) {
+    case OpenAPI_STREAM_LONG:
+        return MEMBER(long, data, field->offset);
+    case OpenAPI_STREAM_FLOAT:
+        return MEMBER(float, data, field->offset);
+    case OpenAPI_STREAM_DOUBLE:
+        return MEMBER(double, data, field->offset);
+    default:
+        return MEMBER(int, data, field->offset);
+    }
+}
+
+static bool member_bool(const OpenAPI_stream_field_t *field, void *data)
+{
+    if (field->ctype == OpenAPI_STREAM_INT)
+        return MEMBER(int, data, field->offset) != 0;
+
+    return MEMBER(bool, data, field->offset);
+}
+
+static void write_key(stream_writer_t *w, const char *key, bool *first)
+{
+    if (*first == false)
+        write_char(w, ',');
+    *first = false;
+
+    write_string(w, key);
+    write_char(w, ':');
+}
+
+static bool write_null(stream_writer_t *w,
+        const OpenAPI_stream_field_t *field, void *data, bool *first)
+{
+    if (field->flags & OpenAPI_STREAM_REQUIRED)
+        return false;
+
+    if ((field->flags & OpenAPI_STREAM_NULLABLE) &&
+        MEMBER(bool, data, field->is_null_offset)) {
+        write_key(w, field->key, first);
+        write_raw(w, "null", 4);
+    }
+
+    return true;
+}
+
+static bool write_list(stream_writer_t *w,
+        const OpenAPI_stream_field_t *field, OpenAPI_list_t *list, int depth)
+{
+    OpenAPI_lnode_t *node = NULL;
+
+    write_char(w, '[');
+    OpenAPI_list_for_each(list, node) {
+        if (node != list->first)
+            write_char(w, ',');
+
+        switch (field->type) {
+        case OpenAPI_STREAM_STRING:
+            if (!node->data)
+                return false;
+            write_string(w, node->data);
+            break;
+        case OpenAPI_STREAM_ENUM:
+            write_string(w, field->enumeration->to_string(
+                        (intptr_t)node->data));
+            break;
+        case OpenAPI_STREAM_NUMBER:
+            if (!node->data)
+                return false;
+            if (write_number(w, *(double *)node->data) == false)
+                return false;
+            break;
+        case OpenAPI_STREAM_MODEL:
+            if (!node->data)
+                return false;
+            if (write_model(w, field->model, node->data, depth) == false)
+                return false;
+            break;
+        default:
+            return false;
+        }
+    }
+    write_char(w, ']');
+
+    return true;
+}
+
+static bool write_map(stream_writer_t *w,
+        const OpenAPI_stream_field_t *field, OpenAPI_list_t *list, int depth)
+{
+    OpenAPI_lnode_t *node = NULL;
+
+    write_char(w, '{');
+    OpenAPI_list_for_each(list, node) {
+        OpenAPI_map_t *map = node->data;
+
+        if (!map || !map->key)
+            return false;
+
+        if (node != list->first)
+            write_char(w, ',');
+
+        write_string(w, map->key);
+        write_char(w, ':');
+
+        if (field->type == OpenAPI_STREAM_STRING) {
+            if (!map->value)
+                return false;
+            write_string(w, map->value);
+        } else if (field->type == OpenAPI_STREAM_BOOL) {
+            /* As the generated code does, the pointer itself is printed */
+            if ((cJSON_bool)(uintptr_t)map->value)
+                write_raw(w, "true", 4);
+            else
+                write_raw(w, "false", 5);
+        } else if (!map->value) {
+            write_raw(w, "null", 4);
+        } else if (write_model(w, field->model, map->value, depth) == false) {
+            return false;
+        }
+    }
+    write_char(w, '}');
+
+    return true;
+}
+
+static bool write_field(stream_writer_t *w,
+        const OpenAPI_stream_field_t *field, void *data, bool *first,
+        int depth)
+{
+    if (field->container == OpenAPI_STREAM_LIST ||
+        field->container == OpenAPI_STREAM_MAP) {
+        OpenAPI_list_t *list = MEMBER(OpenAPI_list_t *, data, field->offset);
+
+        if (!list)
+            return write_null(w, field, data, first);
+
+        write_key(w, field->key, first);
+        if (field->container == OpenAPI_STREAM_LIST)
+            return write_list(w, field, list, depth);
+        else
+            return write_map(w, field, list, depth);
+    }
+
+    switch (field->type) {
+    case OpenAPI_STREAM_STRING:
+        {
+            char *s = MEMBER(char *, data, field->offset);
+            if (!s)
+                return write_null(w, field, data, first);
+
+            write_key(w, field->key, first);
+            write_string(w, s);
+        }
+        return true;
+
+    case OpenAPI_STREAM_BOOL:
+    case OpenAPI_STREAM_NUMBER:
+        if ((field->flags & OpenAPI_STREAM_IS_SET) &&
+            !MEMBER(bool, data, field->is_set_offset))
+            return write_null(w, field, data, first);
+
+        write_key(w, field->key, first);
+        if (field->type == OpenAPI_STREAM_NUMBER)
+            return write_number(w, member_number(field, data));
+
+        if (member_bool(field, data))
+            write_raw(w, "true", 4);
+        else
+            write_raw(w, "false", 5);
+        return true;
+
+    case OpenAPI_STREAM_ENUM:
+        {
+            int value = MEMBER(int, data, field->offset);
+            if (!value)
+                return write_null(w, field, data, first);
+
+            write_key(w, field->key, first);
+            write_string(w, field->enumeration->to_string(value));
+        }
+        return true;
+
+    case OpenAPI_STREAM_MODEL:
+        {
+            void *nested = MEMBER(void *, data, field->offset);
+            if (!nested)
+                return write_null(w, field, data, first);
+
+            write_key(w, field->key, first);
+            return write_model(w, field->model, nested, depth);
+        }
+
+    default:
+        break;
+    }
+
+    return false;
+}
+
+static bool write_model(stream_writer_t *w,
+        const OpenAPI_stream_model_t *model, void *data, int depth)
+{
+    int i;
+    bool first = true;
+
+    ogs_assert(model);
+    ogs_assert(data);
+
+    if (depth >= STREAM_MAX_DEPTH)
+        return false;
+
+    if (model->num_of_fields < 0) {
+        cJSON *item = NULL;
+        char *content = NULL;
+
+        item = model->convertToJSON(data);
+        if (!item)
+            return false;
+
+        content = cJSON_PrintUnformatted(item);
+        cJSON_Delete(item);
+        if (!content)
+            return false;
+
+        write_raw(w, content, strlen(content));
+        ogs_free(content);
+
+        return true;
+    }
+
+    write_char(w, '{');
+    for (i = 0; i < model->num_of_fields; i++) {
+        if (write_field(w, &model->fields[i], data, &first, depth + 1) ==
+                false)
+            return false;
+    }
+    write_char(w, '}');
+
+    return true;
+}
+
+char *OpenAPI_stream_print(const OpenAPI_stream_model_t *model, void *data)
+{
+    stream_writer_t w;
+    cJSON *item = NULL;
+    char *content = NULL;
+
+    ogs_assert(model);
+
+    if (data && model->num_of_fields >= 0) {
+        memset(&w, 0, sizeof(w));
+
+        if (write_model(&w, model, data, 0) == true) {
+            write_char(&w, '\0');
+            return w.buf;
+        }
+
+        if (w.buf)
+            ogs_free(w.buf);
+    }
+
+    /*
+     * Let the generated code deal with anything unusual,
+     * so that the result is exactly what it used to be.
+     */
+    item = model->convertToJSON(data);
+    if (!item)
+        return NULL;
+
+    content = cJSON_PrintUnformatted(item);
+    cJSON_Delete(item);
+
+    return content;
+}
+
+/*
+ * Reader
+ */
+typedef struct stream_reader_s {
+    const char *p;
+} stream_reader_t;
+
+static void skip_whitespace(stream_reader_t *r)
+{
+    /* cJSON treats every control character as whitespace */
+    while (*r->p && (unsigned char)*r->p <= 32)
+        r->p++;
+}
+
+static int hex4(const char *p)
+{
+    int i, value = 0;
+
+    for (i = 0; i < 4; i++) {
+        value <<= 4;
+        if (p[i] >= '0' && p[i] <= '9')
+            value |= p[i] - '0';
+        else if (p[i] >= 'a' && p[i] <= 'f')
+            value |= p[i] - 'a' + 10;
+        else if (p[i] >= 'A' && p[i] <= 'F')
+            value |= p[i] - 'A' + 10;
+        else
+            return -1;
+    }
+
+    return value;
+}
+
+/*
+ * Decodes a \uXXXX (or a surrogate pair) at p and returns the number of
+ * input bytes consumed, or 0 if cJSON would reject it or produce
+ * an embedded NUL.
+ */
+static int read_unicode(const char *p, unsigned int *codepoint)
+{
+    int first, second;
+
+    first = hex4(p + 2);
+    if (first <= 0 || (first >= 0xDC00 && first <= 0xDFFF))
+        return 0;
+
+    if (first < 0xD800 || first > 0xDBFF) {
+        *codepoint = first;
+        return 6;
+    }
+
+    if (p[6] != '\\' || p[7] != 'u')
+        return 0;
+
+    second = hex4(p + 8);
+    if (second < 0xDC00 || second > 0xDFFF)
+        return 0;
+
+    *codepoint = 0x10000 + (((first & 0x3FF) << 10) | (second & 0x3FF));
+    return 12;
+}
+
+/*
+ * Validates a string token. On return, *start and *len describe the raw
+ * contents between the quotes and *escaped tells whether decoding is needed.
+ */
+static bool scan_string(stream_reader_t *r,
+        const char **start, size_t *len, bool *escaped)
+{
+    const char *p = r->p;
+    unsigned int codepoint;
+    int n;
+
+    if (*p != '\"')
+        return false;
+
+    *start = ++p;
+    *escaped = false;
+
+    while (*p != '\"') {
+        if (*p == '\0')
+            return false;
+
+        if (*p != '\\') {
+            p++;
+            continue;
+        }
+
+        *escaped = true;
+        switch (p[1]) {
+        case 'b':
+        case 'f':
+        case 'n':
+        case 'r':
+        case 't':
+        case '\"':
+        case '\\':
+        case '/':
+            p += 2;
+            break;
+        case 'u':
+            n = read_unicode(p, &codepoint);
+            if (!n)
+                return false;
+            p += n;
+            break;
+        default:
+            return false;
+        }
+    }
+
+    *len = p - *start;
+    r->p = p + 1;
+
+    return true;
+}
+
+/* Decodes a string validated by scan_string(); out needs len + 1 bytes */
+static void decode_string(const char *p, size_t len, char *out)
+{
+    const char *end = p + len;
+    unsigned int codepoint;
+    int n;
+
+    while (p < end) {
+        if (*p != '\\') {
+            *out++ = *p++;
+            continue;
+        }
+
+        switch (p[1]) {
+        case 'b': *out++ = '\b'; p += 2; break;
+        case 'f': *out++ = '\f'; p += 2; break;
+        case 'n': *out++ = '\n'; p += 2; break;
+        case 'r': *out++ = '\r'; p += 2; break;
+        case 't': *out++ = '\t'; p += 2; break;
+        case 'u':
+            n = read_unicode(p, &codepoint);
+            ogs_assert(n);
+            p += n;
+
+            if (codepoint < 0x80) {
+                *out++ = codepoint;
+            } else if (codepoint < 0x800) {
+                *out++ = 0xC0 | (codepoint >> 6);
+                *out++ = 0x80 | (codepoint & 0x3F);
+            } else if (codepoint < 0x10000) {
+                *out++ = 0xE0 | (codepoint >> 12);
+                *out++ = 0x80 | ((codepoint >> 6) & 0x3F);
+                *out++ = 0x80 | (codepoint & 0x3F);
+            } else {
+                *out++ = 0xF0 | (codepoint >> 18);
+                *out++ = 0x80 | ((codepoint >> 12) & 0x3F);
+                *out++ = 0x80 | ((codepoint >> 6) & 0x3F);
+                *out++ = 0x80 | (codepoint & 0x3F);
+            }
+            break;
+        default:
+            *out++ = p[1];
+            p += 2;
+            break;
+        }
+    }
+    *out = '\0';
+}
+
+static char *read_string(stream_reader_t *r)
+{
+    const char *start = NULL;
+    size_t len;
+    bool escaped;
+    char *s = NULL;
+
+    if (scan_string(r, &start, &len, &escaped) == false)
+        return NULL;
+
+    s = ogs_malloc(len + 1);
+    ogs_assert(s);
+
+    if (escaped) {
+        decode_string(start, len, s);
+    } else {
+        memcpy(s, start, len);
+        s[len] = '\0';
+    }
+
+    return s;
+}
+
+static bool is_number_char(char c)
+{
+    return (c >= '0' && c <= '9') ||
+        c == '+' || c == '-' || c == 'e' || c == 'E' || c == '.';
+}
+
+/*
+ * Only strict JSON numbers are accepted. cJSON hands the longest run of
+ * number characters (at most 63) to strtod(), so the token must end exactly
+ * where that run ends for both to read the same value.
+ */
+static bool read_number(stream_reader_t *r, double *number)
+{
+    const char *p = r->p;
+    char buf[64];
+    char *end = NULL;
+    size_t len;
+
+    if (*p == '-')
+        p++;
+
+    if (*p == '0')
+        p++;
+    else if (*p >= '1' && *p <= '9')
+        while (*p >= '0' && *p <= '9') p++;
+    else
+        return false;
+
+    if (*p == '.') {
+        p++;
+        if (*p < '0' || *p > '9')
+            return false;
+        while (*p >= '0' && *p <= '9') p++;
+    }
+
+    if (*p == 'e' || *p == 'E') {
+        p++;
+        if (*p == '+' || *p == '-')
+            p++;
+        if (*p < '0' || *p > '9')
+            return false;
+        while (*p >= '0' && *p <= '9') p++;
+    }
+
+    len = p - r->p;
+    if (is_number_char(*p) || len >= sizeof(buf))
+        return false;
+
+    memcpy(buf, r->p, len);
+    buf[len] = '\0';
+
+    *number = strtod(buf, &end);
+    if (end != buf + len)
+        return false;
+
+    r->p = p;
+    return true;
+}
+
+static bool read_literal(stream_reader_t *r, const char *literal)
+{
+    size_t len = strlen(literal);
+
+    if (strncmp(r->p, literal, len) != 0)
+        return false;
+
+    r->p += len;
+    return true;
+}
+
+static bool skip_value(stream_reader_t *r, int depth)
+{
+    const char *start = NULL;
+    size_t len;
+    bool escaped;
+    double number;
+    char close;
+
+    switch (*r->p) {
+    case '\"':
+        return scan_string(r, &start, &len, &escaped);
+    case 't':
+        return read_literal(r, "true");
+    case 'f':
+        return read_literal(r, "false");
+    case 'n':
+        return read_literal(r, "null");
+    case '{':
+    case '[':
+        break;
+    default:
+        return read_number(r, &number);
+    }
+
+    if (depth >= STREAM_MAX_DEPTH)
+        return false;
+
+    close = (*r->p == '{') ? '}' : ']';
+
+    r->p++;
+    skip_whitespace(r);
+    if (*r->p == close) {
+        r->p++;
+        return true;
+    }
+
+    for ( ;; ) {
+        skip_whitespace(r);
+        if (close == '}') {
+            if (scan_string(r, &start, &len, &escaped) == false)
+                return false;
+            skip_whitespace(r);
+            if (*r->p != ':')
+                return false;
+            r->p++;
+            skip_whitespace(r);
+        }
+
+        if (skip_value(r, depth + 1) == false)
+            return false;
+
+        skip_whitespace(r);
+        if (*r->p == ',') {
+            r->p++;
+            continue;
+        }
+        if (*r->p == close) {
+            r->p++;
+            return true;
+        }
+        return false;
+    }
+}
+
+static void *read_model(stream_reader_t *r,
+        const OpenAPI_stream_model_t *model, int depth);
+
+static bool read_null(const OpenAPI_stream_field_t *field, void *data)
+{
+    if (field->container == OpenAPI_STREAM_MAP) {
+        /* A map is left empty for 'null', whether it is mandatory or not */
+    } else if (field->type == OpenAPI_STREAM_STRING &&
+            field->container == OpenAPI_STREAM_SCALAR) {
+        if ((field->flags & OpenAPI_STREAM_REQUIRED) &&
+            !(field->flags & OpenAPI_STREAM_NULL_OK))
+            return false;
+    } else if (!(field->flags & OpenAPI_STREAM_NULLABLE)) {
+        return false;
+    }
+
+    if (field->flags & OpenAPI_STREAM_NULLABLE)
+        MEMBER(bool, data, field->is_null_offset) = true;
+    if (field->flags & OpenAPI_STREAM_IS_SET)
+        MEMBER(bool, data, field->is_set_offset) = true;
+
+    return true;
+}
+
+static bool read_enum(stream_reader_t *r,
+        const OpenAPI_stream_field_t *field, int *value)
+{
+    const char *start = NULL;
+    size_t len;
+    bool escaped;
+    char buf[64];
+    char *s = buf;
+
+    if (scan_string(r, &start, &len, &escaped) == false)
+        return false;
+
+    if (len >= sizeof(buf)) {
+        s = ogs_malloc(len + 1);
+        ogs_assert(s);
+    }
+    decode_string(start, len, s);
+
+    *value = field->enumeration->from_string(s);
+
+    if (s != buf)
+        ogs_free(s);
+
+    return true;
+}
+
+static bool read_list(stream_reader_t *r,
+        const OpenAPI_stream_field_t *field, OpenAPI_list_t *list, int depth)
+{
+    double number;
+
+    if (*r->p != '[')
+        return false;
+
+    r->p++;
+    skip_whitespace(r);
+    if (*r->p == ']') {
+        r->p++;
+        return true;
+    }
+
+    for ( ;; ) {
+        void *item = NULL;
+
+        skip_whitespace(r);
+        switch (field->type) {
+        case OpenAPI_STREAM_STRING:
+            item = read_string(r);
+            break;
+        case OpenAPI_STREAM_ENUM:
+            {
+                int value = 0;
+                /*
+                 * Unknown values are dropped with a log message by the
+                 * generated code. Leave that to it.
+                 */
+                if (read_enum(r, field, &value) == false || !value)
+                    return false;
+                item = (void *)(intptr_t)value;
+            }
+            break;
+        case OpenAPI_STREAM_NUMBER:
+            if (read_number(r, &number) == false)
+                return false;
+            item = ogs_calloc(1, sizeof(double));
+            ogs_assert(item);
+            *(double *)item = number;
+            break;
+        case OpenAPI_STREAM_MODEL:
+            if (*r->p != '{')
+                return false;
+            item = read_model(r, field->model, depth);
+            break;
+        default:
+            break;
+        }
+        if (!item)
+            return false;
+
+        OpenAPI_list_add(list, item);
+
+        skip_whitespace(r);
+        if (*r->p == ',') {
+            r->p++;
+            continue;
+        }
+        if (*r->p == ']') {
+            r->p++;
+            return true;
+        }
+        return false;
+    }
+}
+
+static bool read_map(stream_reader_t *r,
+        const OpenAPI_stream_field_t *field, OpenAPI_list_t *list, int depth)
+{
+    if (*r->p != '{')
+        return false;
+
+    r->p++;
+    skip_whitespace(r);
+    if (*r->p == '}') {
+        r->p++;
+        return true;
+    }
+
+    for ( ;; ) {
+        char *key = NULL;
+        void *value = NULL;
+
+        skip_whitespace(r);
+        key = read_string(r);
+        if (!key)
+            return false;
+
+        skip_whitespace(r);
+        if (*r->p != ':') {
+            ogs_free(key);
+            return false;
+        }
+        r->p++;
+        skip_whitespace(r);
+
+        if (field->type == OpenAPI_STREAM_STRING) {
+            value = read_string(r);
+            if (!value) {
+                ogs_free(key);
+                return false;
+            }
+        } else if (field->type == OpenAPI_STREAM_BOOL) {
+            int boolean;
+
+            if (read_literal(r, "true") == true) {
+                boolean = 1;
+            } else if (read_literal(r, "false") == true) {
+                boolean = 0;
+            } else {
+                ogs_free(key);
+                return false;
+            }
+
+            value = ogs_calloc(1, sizeof(int));
+            ogs_assert(value);
+            *(int *)value = boolean;
+        } else if (*r->p == '{') {
+            value = read_model(r, field->model, depth);
+            if (!value) {
+                ogs_free(key);
+                return false;
+            }
+        } else if (read_literal(r, "null") == false) {
+            ogs_free(key);
+            return false;
+        }
+
+        OpenAPI_list_add(list, OpenAPI_map_create(key, value));
+
+        skip_whitespace(r);
+        if (*r->p == ',') {
+            r->p++;
+            continue;
+        }
+        if (*r->p == '}') {
+            r->p++;
+            return true;
+        }
+        return false;
+    }
+}
+
+static bool read_field(stream_reader_t *r,
+        const OpenAPI_stream_field_t *field, void *data, int depth)
+{
+    double number;
+    bool boolean;
+
+    if (read_literal(r, "null") == true)
+        return read_null(field, data);
+
+    if (field->container == OpenAPI_STREAM_LIST ||
+        field->container == OpenAPI_STREAM_MAP) {
+        OpenAPI_list_t *list = OpenAPI_list_create();
+        ogs_assert(list);
+
+        /* Attach it first so that model->free() releases it on failure */
+        MEMBER(OpenAPI_list_t *, data, field->offset) = list;
+
+        if (field->container == OpenAPI_STREAM_MAP)
+            return read_map(r, field, list, depth);
+
+        if (read_list(r, field, list, depth) == false)
+            return false;
+
+        if (field->type == OpenAPI_STREAM_ENUM && list->count == 0)
+            return false;
+
+        return true;
+    }
+
+    switch (field->type) {
+    case OpenAPI_STREAM_STRING:
+        MEMBER(char *, data, field->offset) = read_string(r);
+        return MEMBER(char *, data, field->offset) != NULL;
+
+    case OpenAPI_STREAM_BOOL:
+        if (read_literal(r, "true") == true)
+            boolean = true;
+        else if (read_literal(r, "false") == true)
+            boolean = false;
+        else
+            return false;
+
+        if (field->ctype == OpenAPI_STREAM_INT)
+            MEMBER(int, data, field->offset) = boolean;
+        else
+            MEMBER(bool, data, field->offset) = boolean;
+        break;
+
+    case OpenAPI_STREAM_NUMBER:
+        if (read_number(r, &number) == false)
+            return false;
+
+        switch (field->ctype) {
+        case OpenAPI_STREAM_LONG:
+            MEMBER(long, data, field->offset) = number;
+            break;
+        case OpenAPI_STREAM_FLOAT:
+            MEMBER(float, data, field->offset) = number;
+            break;
+        case OpenAPI_STREAM_DOUBLE:
+            MEMBER(double, data, field->offset) = number;
+            break;
+        default:
+            MEMBER(int, data, field->offset) = number;
+            break;
+        }
+        break;
+
+    case OpenAPI_STREAM_ENUM:
+        return read_enum(r, field, &MEMBER(int, data, field->offset));
+
+    case OpenAPI_STREAM_MODEL:
+        if (*r->p != '{')
+            return false;
+        MEMBER(void *, data, field->offset) =
+            read_model(r, field->model, depth);
+        return MEMBER(void *, data, field->offset) != NULL;
+
+    default:
+        return false;
+    }
+
+    if (field->flags & OpenAPI_STREAM_IS_SET)
+        MEMBER(bool, data, field->is_set_offset) = true;
+
+    return true;
+}
+
+static const OpenAPI_stream_field_t *find_field(
+        const OpenAPI_stream_model_t *model, int hint,
+        const char *key, size_t len)
+{
+    int i, n = model->num_of_fields;
+
+    /* Members usually arrive in the order they are printed */
+    for (i = 0; i < n; i++) {
+        const OpenAPI_stream_field_t *field = &model->fields[(hint + i) % n];
+        if (strncmp(field->key, key, len) == 0 && field->key[len] == '\0')
+            return field;
+    }
+
+    return NULL;
+}
+
+static void *read_model(stream_reader_t *r,
+        const OpenAPI_stream_model_t *model, int depth)
+{
+    void *data = NULL;
+    uint8_t seen[OpenAPI_STREAM_MAX_FIELDS / 8];
+    int i, hint = 0;
+
+    if (depth >= STREAM_MAX_DEPTH || *r->p != '{')
+        return NULL;
+
+    if (model->num_of_fields < 0) {
+        /* No descriptor: hand just this object over to the generated code */
+        const char *start = r->p;
+        cJSON *item = NULL;
+
+        if (skip_value(r, depth) == false)
+            return NULL;
+
+        item = cJSON_ParseWithLength(start, r->p - start);
+        if (!item)
+            return NULL;
+
+        data = model->parseFromJSON(item);
+        cJSON_Delete(item);
+
+        return data;
+    }
+
+    ogs_assert(model->num_of_fields <= OpenAPI_STREAM_MAX_FIELDS);
+    memset(seen, 0, sizeof(seen));
+
+    data = ogs_calloc(1, model->size);
+    ogs_assert(data);
+
+    r->p++;
+    skip_whitespace(r);
+    if (*r->p == '}') {
+        r->p++;
+        goto done;
+    }
+
+    for ( ;; ) {
+        const OpenAPI_stream_field_t *field = NULL;
+        const char *key = NULL;
+        char buf[64];
+        size_t len;
+        bool escaped;
+
+        skip_whitespace(r);
+        if (scan_string(r, &key, &len, &escaped) == false)
+            goto fail;
+
+        if (escaped) {
+            if (len >= sizeof(buf))
+                goto fail;
+            decode_string(key, len, buf);
+            key = buf;
+            len = strlen(buf);
+        }
+
+        skip_whitespace(r);
+        if (*r->p != ':')
+            goto fail;
+        r->p++;
+        skip_whitespace(r);
+
+        field = find_field(model, hint, key, len);
+        if (field) {
+            i = field - model->fields;
+
+            /* cJSON would pick the first one. Not worth the trouble */
+            if (seen[i / 8] & (1 << (i % 8)))
+                goto fail;
+            seen[i / 8] |= 1 << (i % 8);
+            hint = i + 1;
+
+            if (read_field(r, field, data, depth + 1) == false)
+                goto fail;
+        } else {
+            if (skip_value(r, depth + 1) == false)
+                goto fail;
+        }
+
+        skip_whitespace(r);
+        if (*r->p == ',') {
+            r->p++;
+            continue;
+        }
+        if (*r->p == '}') {
+            r->p++;
+            break;
+        }
+        goto fail;
+    }
+
+done:
+    for (i = 0; i < model->num_of_fields; i++) {
+        if ((model->fields[i].flags & OpenAPI_STREAM_REQUIRED) &&
+            !(seen[i / 8] & (1 << (i % 8))))
+            goto fail;
+    }
+
+    return data;
+
+fail:
+    model->free(data);
+    return NULL;
+}
+
+void *OpenAPI_stream_parse(const OpenAPI_stream_model_t *model,
+        const char *json)
+{
+    stream_reader_t r;
+
+    ogs_assert(model);
+
+    if (!json || model->num_of_fields < 0)
+        return NULL;
+
+    r.p = json;
+    skip_whitespace(&r);
+
+    return read_model(&r, model, 0);
+}
+
+bool OpenAPI_stream_validate(const char *json)
+{
+    stream_reader_t r;
+
+    if (!json)
+        return false;
+
+    r.p = json;
+    skip_whitespace(&r);
+
+    /* Anything after the first value is ignored, as cJSON_Parse() does */
+    return skip_value(&r, 0);
+}
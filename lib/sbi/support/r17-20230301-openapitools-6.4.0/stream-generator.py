@@ -0,0 +1,373 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2023 by Sukchan Lee <acetcom@gmail.com>
+#
+# This file is part of Open5GS.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Affero General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+"""
+Generates model/stream_model.[ch] for the table-driven JSON codec
+(include/stream.h) from the models openapi-generator wrote.
+
+Each member block of OpenAPI_xxx_convertToJSON(), OpenAPI_xxx_parseFromJSON()
+and its OpenAPI_xxx_create() argument(s) is normalized and compared with the
+shapes listed in stream-templates.txt. A model gets a field table only when
+every member matches one of those shapes exactly. Any other model keeps a
+descriptor without fields, and the codec calls the generated functions for it.
+
+Usage: ./stream-generator.py ../../openapi
+"""
+
+import glob
+import os
+import re
+import sys
+
+TEMPLATES = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                         'stream-templates.txt')
+
+CTYPES = {
+    'int': 'OpenAPI_STREAM_INT',
+    'long': 'OpenAPI_STREAM_LONG',
+    'float': 'OpenAPI_STREAM_FLOAT',
+    'double': 'OpenAPI_STREAM_DOUBLE',
+}
+
+
+def reduce(text):
+    """Drops indentation, blank lines, log calls and unused locals."""
+    lines = []
+    in_log = False
+    for line in text.split('\n'):
+        s = line.strip()
+        if in_log:
+            in_log = not s.endswith(');')
+            continue
+        if s.startswith(('ogs_error(', 'ogs_info(')):
+            in_log = not s.endswith(');')
+            continue
+        if s in ('', 'double *localDouble = NULL;', 'int *localInt = NULL;'):
+            continue
+        lines.append(s)
+    return '\n'.join(lines)
+
+
+def normalize(text, name):
+    """Replaces the member name, JSON keys and type names by placeholders."""
+    types = set()
+
+    def typename(m):
+        types.add((m.group(1), m.group(2)))
+        return 'OpenAPI_T_' + m.group(2)
+
+    text = re.sub(r'\b(is_)?' + re.escape(name) +
+                  r'(_null|_local_nonprim|_local_map|_local_object|'
+                  r'_local_JSON|_local|List|Item|Variable)?\b',
+                  lambda m: (m.group(1) or '') + 'F' + (m.group(2) or ''),
+                  text)
+    text = re.sub(r'\b(encoded|decoded)_str_' + re.escape(name) + r'\b',
+                  r'\1_str_F', text)
+    text = re.sub(r'"[^"]*"', '"K"', text)
+    text = re.sub(r'OpenAPI_(?!list_create|list_add|map_create|base64decode|'
+                  r'base64encode|list_free|list_for_each|map_t|any_type)'
+                  r'(\w+?)_(parseFromJSON|FromString|convertToJSON|ToString|'
+                  r'free|e)\b', typename, text)
+    text = re.sub(r'OpenAPI_\w+_NULL\b', 'OpenAPI_T_NULL', text)
+    text = re.sub(r'OpenAPI_\w+_t \*FItem\b', 'OpenAPI_T_t *FItem', text)
+    text = re.sub(r'\[\w+\]', '[F]', text)
+    return reduce(text), types
+
+
+def load_templates():
+    templates = {}
+    with open(TEMPLATES) as f:
+        for chunk in re.split(r'^@@ ', f.read(), flags=re.M)[1:]:
+            header, body = chunk.split('\n', 1)
+            conv, parse, args = [p.strip('\n') for p in body.split('\n--\n')]
+            kind = header.split()
+            templates[(conv, parse, args)] = (
+                kind[0], kind[1],
+                [] if kind[2] == '-' else kind[2].split('|'))
+    return templates
+
+
+def parse_struct(source, name):
+    m = re.search(r'typedef struct OpenAPI_' + name + r'_s \{\n(.*?)\n\} '
+                  r'OpenAPI_' + name + r'_t;', source, re.S)
+    if not m:
+        return None
+    members = {}
+    for line in m.group(1).split('\n'):
+        d = re.match(r'\s*(.*?)\s*\b(\w+);$', line)
+        if d:
+            members[d.group(2)] = d.group(1)
+    return members
+
+
+def analyze(name, source, header):
+    """Returns the list of fields, or None if the model is not supported."""
+    conv = re.search(
+        r'\ncJSON \*OpenAPI_' + name + r'_convertToJSON\(OpenAPI_' + name +
+        r'_t \*(\w+)\)\n\{\n    cJSON \*item = NULL;\n'
+        r'    OpenAPI_lnode_t \*node = NULL;\n\n'
+        r'    if \(\1 == NULL\) \{\n        ogs_error\([^\n]*\);\n'
+        r'        return NULL;\n    \}\n\n'
+        r'    item = cJSON_CreateObject\(\);\n'
+        r'(.*?)end:\n    return item;\n\}\n',
+        source, re.S)
+    parse = re.search(
+        r'\nOpenAPI_' + name + r'_t \*OpenAPI_' + name +
+        r'_parseFromJSON\(cJSON \*(\w+)\)\n\{\n(.*?)\n'
+        r'    ' + name + r'_local_var = OpenAPI_' + name + r'_create \(\n'
+        r'(.*?)    \);\n\n    return ' + name + r'_local_var;\nend:\n',
+        source, re.S)
+    members = parse_struct(header, name)
+    if not conv or not parse or members is None:
+        return None
+
+    var = conv.group(1)
+    blocks = [b for b in conv.group(2).strip('\n').split('\n\n') if b]
+    json = parse.group(1)
+    segments = re.split(r'\n(?=    \w+ = cJSON_GetObjectItemCaseSensitive\()',
+                        parse.group(2))
+    segments = [
+        s for s in segments
+        if re.match(r'    \w+ = cJSON_GetObjectItemCaseSensitive\(', s)]
+    args = [a.strip() for a in parse.group(3).split('\n') if a.strip()]
+
+    if len(blocks) != len(segments):
+        return None
+
+    fields = []
+    for block, segment in zip(blocks, segments):
+        m = re.match(r'    (\w+) = cJSON_GetObjectItemCaseSensitive\(' +
+                     re.escape(json) + r', "([^"]*)"\);', segment)
+        member, key = m.group(1), m.group(2)
+        if member == 'end' or member not in members:
+            return None
+        if re.findall(r'ToObject\(item, "([^"]*)"', block)[:1] != [key]:
+            return None
+
+        used = []
+        while args and re.search(
+                r'\b' + re.escape(member) +
+                r'(_local_nonprim|List|Variable|_local_object)?\b', args[0]):
+            used.append(args.pop(0).rstrip(','))
+        if not used:
+            return None
+
+        c, ctypes = normalize(block.replace(var + '->', 'V->'), member)
+        p, ptypes = normalize(segment.replace(json, 'JSON'), member)
+        a, _ = normalize('\n'.join(used), member)
+
+        kind = TEMPLATES.get((c, p, a))
+        if not kind:
+            return None
+        type_, container, flags = kind
+
+        # The same model or enum must be used in both directions
+        models = set(t for t, f in ctypes | ptypes
+                     if f in ('convertToJSON', 'parseFromJSON'))
+        enums = set(t for t, f in ctypes | ptypes
+                    if f in ('ToString', 'FromString'))
+        target = None
+        if type_ == 'MODEL':
+            if len(models) != 1 or enums:
+                return None
+            target = models.pop()
+        elif type_ == 'ENUM':
+            if len(enums) != 1 or models:
+                return None
+            target = enums.pop()
+        elif models or enums:
+            return None
+
+        ctype = 'OpenAPI_STREAM_INT'
+        if container == 'SCALAR':
+            if type_ == 'NUMBER':
+                ctype = CTYPES.get(members[member])
+                if not ctype:
+                    return None
+            elif type_ == 'BOOL':
+                if members[member] == 'bool':
+                    ctype = 'OpenAPI_STREAM_BOOLEAN'
+                elif members[member] != 'int':
+                    return None
+            elif type_ == 'ENUM' and \
+                    not re.match(r'OpenAPI_\w+_e$', members[member]):
+                return None
+        if 'IS_SET' in flags and members.get('is_' + member) != 'bool':
+            return None
+        if 'NULLABLE' in flags and \
+                members.get('is_' + member + '_null') != 'bool':
+            return None
+
+        fields.append(dict(member=member, key=key, type=type_,
+                           container=container, flags=flags,
+                           ctype=ctype, target=target))
+
+    if args:
+        return None
+
+    return fields
+
+
+def c_string(s):
+    return '"' + s.replace('\\', '\\\\').replace('"', '\\"') + '"'
+
+
+def main(openapi):
+    global TEMPLATES
+    TEMPLATES = load_templates()
+
+    models = {}
+    for path in sorted(glob.glob(os.path.join(openapi, 'model', '*.c'))):
+        name = os.path.basename(path)[:-2]
+        if name == 'stream_model':
+            continue
+        source = open(path).read()
+        if not re.search(r'\nvoid OpenAPI_' + name + r'_free\(', source) or \
+           not re.search(r'\ncJSON \*OpenAPI_' + name + r'_convertToJSON\(',
+                         source) or \
+           not re.search(r'_t \*OpenAPI_' + name + r'_parseFromJSON\(',
+                         source):
+            continue
+        header = open(path[:-2] + '.h').read()
+        models[name] = analyze(name, source, header)
+
+    # Enums declared in a header, and inline enums whose functions are
+    # only defined in the model source under another name
+    declared = set()
+    for path in glob.glob(os.path.join(openapi, 'model', '*.h')):
+        declared.update(re.findall(r'\bOpenAPI_(\w+)_ToString\(',
+                                   open(path).read()))
+    undeclared = {}
+    for path in glob.glob(os.path.join(openapi, 'model', '*.c')):
+        source = open(path).read()
+        for enum, type_ in re.findall(
+                r'^char \*OpenAPI_(\w+)_ToString\((OpenAPI_\w+_e) \w+\)$',
+                source, re.M):
+            if enum not in declared and re.search(
+                    r'^' + type_ + r' OpenAPI_' + enum +
+                    r'_FromString\(char\* \w+\)$', source, re.M):
+                undeclared[enum] = type_
+    declared.update(undeclared)
+
+    # Nested models must have a descriptor of their own
+    for name, fields in models.items():
+        if fields and any(f['type'] == 'MODEL' and f['target'] not in models
+                          for f in fields):
+            models[name] = None
+        if fields and any(f['type'] == 'ENUM' and f['target'] not in declared
+                          for f in fields):
+            models[name] = None
+        if fields and len(fields) > 256:
+            models[name] = None
+
+    enums = sorted(set(f['target'] for fields in models.values() if fields
+                       for f in fields if f['type'] == 'ENUM'))
+
+    banner = ('/*\n'
+              ' * Generated by stream-generator.py. DO NOT EDIT.\n'
+              ' */\n\n')
+
+    with open(os.path.join(openapi, 'model', 'stream_model.h'), 'w') as h:
+        h.write(banner)
+        h.write('#ifndef _OpenAPI_stream_model_H_\n'
+                '#define _OpenAPI_stream_model_H_\n\n'
+                '#include "../include/stream.h"\n\n'
+                '#ifdef __cplusplus\nextern "C" {\n#endif\n\n')
+        for name in sorted(models):
+            h.write('extern const OpenAPI_stream_model_t '
+                    'OpenAPI_%s_stream;\n' % name)
+        h.write('\n#ifdef __cplusplus\n}\n#endif\n\n'
+                '#endif /* _OpenAPI_stream_model_H_ */\n')
+
+    with open(os.path.join(openapi, 'model', 'stream_model.c'), 'w') as c:
+        c.write(banner)
+        c.write('#include <stddef.h>\n\n#include "stream_model.h"\n')
+        for name in sorted(models):
+            c.write('#include "%s.h"\n' % name)
+        c.write('\n')
+
+        for enum in enums:
+            if enum in undeclared:
+                c.write('char *OpenAPI_%s_ToString(%s value);\n' %
+                        (enum, undeclared[enum]))
+                c.write('%s OpenAPI_%s_FromString(char *value);\n' %
+                        (undeclared[enum], enum))
+        c.write('\n')
+
+        for enum in enums:
+            c.write('static const OpenAPI_stream_enum_t '
+                    'OpenAPI_%s_stream_enum = {\n' % enum)
+            c.write('    (char *(*)(int))OpenAPI_%s_ToString,\n' % enum)
+            c.write('    (int (*)(char *))OpenAPI_%s_FromString,\n};\n\n'
+                    % enum)
+
+        for name in sorted(models):
+            fields = models[name]
+            if fields:
+                c.write('static const OpenAPI_stream_field_t '
+                        'OpenAPI_%s_stream_fields[] = {\n' % name)
+                for f in fields:
+                    flags = ' | '.join('OpenAPI_STREAM_' + x
+                                       for x in f['flags']) or '0'
+                    c.write('    { %s, OpenAPI_STREAM_%s, '
+                            'OpenAPI_STREAM_%s,\n' %
+                            (c_string(f['key']), f['type'], f['container']))
+                    c.write('        %s, %s,\n' % (flags, f['ctype']))
+                    c.write('        offsetof(OpenAPI_%s_t, %s),\n' %
+                            (name, f['member']))
+                    c.write('        %s,\n' % (
+                        'offsetof(OpenAPI_%s_t, is_%s)' % (name, f['member'])
+                        if 'IS_SET' in f['flags'] else '0'))
+                    c.write('        %s,\n' % (
+                        'offsetof(OpenAPI_%s_t, is_%s_null)' %
+                        (name, f['member'])
+                        if 'NULLABLE' in f['flags'] else '0'))
+                    c.write('        %s, %s },\n' % (
+                        '&OpenAPI_%s_stream_enum' % f['target']
+                        if f['type'] == 'ENUM' else 'NULL',
+                        '&OpenAPI_%s_stream' % f['target']
+                        if f['type'] == 'MODEL' else 'NULL'))
+                c.write('};\n\n')
+
+            c.write('const OpenAPI_stream_model_t OpenAPI_%s_stream = {\n'
+                    % name)
+            c.write('    "%s", sizeof(OpenAPI_%s_t),\n' % (name, name))
+            if fields:
+                c.write('    OpenAPI_%s_stream_fields, %d,\n' %
+                        (name, len(fields)))
+            elif fields is None:
+                c.write('    NULL, -1,\n')
+            else:
+                c.write('    NULL, 0,\n')
+            c.write('    (cJSON *(*)(void *))OpenAPI_%s_convertToJSON,\n'
+                    % name)
+            c.write('    (void *(*)(cJSON *))OpenAPI_%s_parseFromJSON,\n'
+                    % name)
+            c.write('    (void (*)(void *))OpenAPI_%s_free,\n};\n\n' % name)
+
+    supported = sum(1 for f in models.values() if f is not None)
+    print('stream-generator: %d of %d models have a field table' %
+          (supported, len(models)))
+
+
+if __name__ == '__main__':
+    if len(sys.argv) != 2:
+        print(__doc__.strip(), file=sys.stderr)
+        sys.exit(1)
+    main(sys.argv[1])
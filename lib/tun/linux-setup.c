@@ -34,7 +34,8 @@
 #define IFNAMSIZ 32
 #endif
 
-ogs_socket_t ogs_tun_open(char *ifname, int len, int is_tap)
+static ogs_socket_t tun_open(
+        char *ifname, int is_tap, int multi_queue, int offload)
 {
     ogs_socket_t fd = INVALID_SOCKET;
 
@@ -45,6 +46,24 @@ ogs_socket_t ogs_tun_open(char *ifname, int len, int is_tap)
 
     ogs_assert(ifname);
 
+    if (multi_queue) {
+#if defined(IFF_MULTI_QUEUE)
+        flags |= IFF_MULTI_QUEUE;
+#else
+        ogs_error("IFF_MULTI_QUEUE is not supported : dev[%s]", ifname);
+        return INVALID_SOCKET;
+#endif
+    }
+
+    if (offload) {
+#if defined(IFF_VNET_HDR) && defined(TUNSETOFFLOAD)
+        flags |= IFF_VNET_HDR;
+#else
+        ogs_error("IFF_VNET_HDR is not supported : dev[%s]", ifname);
+        return INVALID_SOCKET;
+#endif
+    }
+
     fd = open(dev, O_RDWR);
     if (fd < 0) {
         ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
@@ -64,6 +83,26 @@ ogs_socket_t ogs_tun_open(char *ifname, int len, int is_tap)
         goto cleanup;
     }
 
+#if defined(IFF_VNET_HDR) && defined(TUNSETOFFLOAD)
+    if (offload) {
+        int hdr_len = sizeof(ogs_tun_vnet_hdr_t);
+        unsigned int offloads = TUN_F_CSUM | TUN_F_TSO4 | TUN_F_TSO6;
+
+        rc = ioctl(fd, TUNSETVNETHDRSZ, &hdr_len);
+        if (rc < 0) {
+            ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
+                    "ioctl(TUNSETVNETHDRSZ) failed : dev[%s]", ifname);
+            goto cleanup;
+        }
+        rc = ioctl(fd, TUNSETOFFLOAD, offloads);
+        if (rc < 0) {
+            ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
+                    "ioctl(TUNSETOFFLOAD) failed : dev[%s]", ifname);
+            goto cleanup;
+        }
+    }
+#endif
+
     return fd;
 
 cleanup:
@@ -71,6 +110,32 @@ cleanup:
     return INVALID_SOCKET;
 }
 
+ogs_socket_t ogs_tun_open(char *ifname, int len, int is_tap)
+{
+    return tun_open(ifname, is_tap, false, false);
+}
+
+/*
+ * Each call attaches one more queue to the same interface.
+ * All queues of an interface must be opened with this function,
+ * and a persistent interface must be created with `multi_queue`.
+ *
+ * $ sudo ip tuntap add name ogstun mode tun multi_queue
+ */
+ogs_socket_t ogs_tun_open_multi_queue(char *ifname, int len, int is_tap)
+{
+    return tun_open(ifname, is_tap, true, false);
+}
+
+/*
+ * TUN (not TAP) with IFF_VNET_HDR, checksum and TCP segmentation offload.
+ * All queues of a multi-queue interface must use the same mode.
+ */
+ogs_socket_t ogs_tun_open_offload(char *ifname, int len, int multi_queue)
+{
+    return tun_open(ifname, false, multi_queue, true);
+}
+
 int ogs_tun_set_ip(char *ifname, ogs_ipsubnet_t *gw, ogs_ipsubnet_t *sub)
 {
     return OGS_OK;
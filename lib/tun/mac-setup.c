@@ -110,6 +110,18 @@ ogs_socket_t ogs_tun_open(char *ifname, int maxlen, int is_tap)
     return fd;
 }
 
+ogs_socket_t ogs_tun_open_multi_queue(char *ifname, int maxlen, int is_tap)
+{
+    ogs_error("Multi-queue TUN is not supported in this platform");
+    return INVALID_SOCKET;
+}
+
+ogs_socket_t ogs_tun_open_offload(char *ifname, int maxlen, int multi_queue)
+{
+    ogs_error("TUN offload is not supported in this platform");
+    return INVALID_SOCKET;
+}
+
 #define TUN_ALIGN(size, boundary) \
         (((size) + ((boundary) - 1)) & ~((boundary) - 1))
 
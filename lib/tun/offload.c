@@ -0,0 +1,590 @@
+/*
+ * Copyright (C) 2019-2023 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ogs-tun.h"
+
+#if defined(__linux__)
+#include <sys/uio.h>
+#include <pthread.h>
+#endif
+
+#undef OGS_LOG_DOMAIN
+#define OGS_LOG_DOMAIN __ogs_sock_domain
+
+/* Offsets in the IP and TCP headers */
+#define IPV4_TOT_LEN        2
+#define IPV4_ID             4
+#define IPV4_FRAG_OFF       6
+#define IPV4_PROTO          9
+#define IPV4_CHECK          10
+#define IPV4_SADDR          12
+#define IPV4_HLEN           20
+
+#define IPV6_PAYLOAD_LEN    4
+#define IPV6_NEXTHDR        6
+#define IPV6_SADDR          8
+#define IPV6_HLEN           40
+
+#define TCP_SEQ             4
+#define TCP_ACK             8
+#define TCP_DOFF            12
+#define TCP_FLAGS           13
+#define TCP_CHECK           16
+#define TCP_HLEN            20
+
+#define TCP_FLAG_FIN        0x01
+#define TCP_FLAG_PSH        0x08
+#define TCP_FLAG_ACK        0x10
+#define TCP_FLAG_CWR        0x80
+
+static uint16_t get16(const uint8_t *p)
+{
+    return (p[0] << 8) | p[1];
+}
+
+static void put16(uint8_t *p, uint16_t v)
+{
+    p[0] = v >> 8;
+    p[1] = v;
+}
+
+static uint32_t get32(const uint8_t *p)
+{
+    return ((uint32_t)get16(p) << 16) | get16(p + 2);
+}
+
+static void put32(uint8_t *p, uint32_t v)
+{
+    put16(p, v >> 16);
+    put16(p + 2, v);
+}
+
+static uint32_t csum_add(uint32_t sum, const uint8_t *p, int len)
+{
+    while (len > 1) {
+        sum += get16(p);
+        p += 2;
+        len -= 2;
+    }
+    if (len)
+        sum += p[0] << 8;
+
+    return sum;
+}
+
+static uint16_t csum_fold(uint32_t sum)
+{
+    while (sum >> 16)
+        sum = (sum & 0xffff) + (sum >> 16);
+
+    return sum;
+}
+
+static uint32_t pseudo_sum(const uint8_t *ip, int l4_len)
+{
+    uint32_t sum = 0;
+
+    if ((ip[0] >> 4) == 4)
+        sum = csum_add(sum, ip + IPV4_SADDR, 8);
+    else
+        sum = csum_add(sum, ip + IPV6_SADDR, 32);
+
+    return sum + 6 /* TCP */ + l4_len;
+}
+
+static void ipv4_set_check(uint8_t *ip)
+{
+    int ihl = (ip[0] & 0x0f) << 2;
+
+    put16(ip + IPV4_CHECK, 0);
+    put16(ip + IPV4_CHECK, ~csum_fold(csum_add(0, ip, ihl)));
+}
+
+static void ip_set_len(uint8_t *ip, int len)
+{
+    if ((ip[0] >> 4) == 4) {
+        put16(ip + IPV4_TOT_LEN, len);
+        ipv4_set_check(ip);
+    } else {
+        put16(ip + IPV6_PAYLOAD_LEN, len - IPV6_HLEN);
+    }
+}
+
+#if defined(__linux__)
+
+/*
+ * A super-packet is read into a buffer of the reading thread and only
+ * the segments are copied into pkbufs, which keeps the reads out of
+ * the 64KB allocations.
+ */
+typedef struct offload_buf_s {
+    ogs_tun_vnet_hdr_t vnet_hdr;
+    uint8_t data[OGS_TUN_MAX_GSO_LEN];
+} offload_buf_t;
+
+static OGS_THREAD_LOCAL offload_buf_t *self_buf = NULL;
+static pthread_key_t buf_key;
+static pthread_once_t buf_key_once = PTHREAD_ONCE_INIT;
+
+static void buf_exit(void *data)
+{
+    free(data);
+    self_buf = NULL;
+}
+
+static void buf_key_create(void)
+{
+    ogs_assert(pthread_key_create(&buf_key, buf_exit) == 0);
+}
+
+static offload_buf_t *buf_self(void)
+{
+    if (ogs_likely(self_buf))
+        return self_buf;
+
+    pthread_once(&buf_key_once, buf_key_create);
+
+    self_buf = malloc(sizeof(*self_buf));
+    if (!self_buf)
+        return NULL;
+    pthread_setspecific(buf_key, self_buf);
+
+    return self_buf;
+}
+
+int ogs_tun_read_offload(ogs_socket_t fd,
+        ogs_tun_vnet_hdr_t *vnet_hdr, uint8_t **data)
+{
+    offload_buf_t *buf = NULL;
+    int n;
+
+    ogs_assert(fd != INVALID_SOCKET);
+    ogs_assert(vnet_hdr);
+    ogs_assert(data);
+
+    buf = buf_self();
+    if (!buf) {
+        ogs_error("malloc() failed");
+        return OGS_ERROR;
+    }
+
+    n = ogs_read(fd, buf, sizeof(*buf));
+    if (n <= (int)sizeof(*vnet_hdr)) {
+        ogs_log_message(OGS_LOG_WARN, ogs_socket_errno, "ogs_read() failed");
+        return OGS_ERROR;
+    }
+
+    memcpy(vnet_hdr, &buf->vnet_hdr, sizeof(*vnet_hdr));
+    *data = buf->data;
+
+    return n - sizeof(*vnet_hdr);
+}
+
+static int write_vnet_hdr(ogs_socket_t fd,
+        ogs_tun_vnet_hdr_t *vnet_hdr, struct iovec *iov, int iovcnt)
+{
+    iov[0].iov_base = vnet_hdr;
+    iov[0].iov_len = sizeof(*vnet_hdr);
+
+    if (writev(fd, iov, iovcnt) <= 0) {
+        ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno, "writev() failed");
+        return OGS_ERROR;
+    }
+
+    return OGS_OK;
+}
+
+int ogs_tun_write_offload(ogs_socket_t fd, ogs_pkbuf_t *pkbuf)
+{
+    ogs_tun_vnet_hdr_t vnet_hdr;
+    struct iovec iov[2];
+
+    ogs_assert(fd != INVALID_SOCKET);
+    ogs_assert(pkbuf);
+
+    memset(&vnet_hdr, 0, sizeof(vnet_hdr));
+    iov[1].iov_base = pkbuf->data;
+    iov[1].iov_len = pkbuf->len;
+
+    return write_vnet_hdr(fd, &vnet_hdr, iov, 2);
+}
+
+#else
+
+int ogs_tun_read_offload(ogs_socket_t fd,
+        ogs_tun_vnet_hdr_t *vnet_hdr, uint8_t **data)
+{
+    ogs_error("TUN offload is not supported in this platform");
+    return OGS_ERROR;
+}
+
+int ogs_tun_write_offload(ogs_socket_t fd, ogs_pkbuf_t *pkbuf)
+{
+    ogs_error("TUN offload is not supported in this platform");
+    return OGS_ERROR;
+}
+
+#endif
+
+int ogs_tun_gso_init(ogs_tun_gso_t *gso,
+        uint8_t *data, int len, ogs_tun_vnet_hdr_t *vnet_hdr)
+{
+    uint8_t *ip = NULL;
+    int version, gso_type;
+
+    ogs_assert(gso);
+    ogs_assert(data);
+    ogs_assert(vnet_hdr);
+
+    memset(gso, 0, sizeof(*gso));
+    memcpy(&gso->vnet_hdr, vnet_hdr, sizeof(*vnet_hdr));
+
+    ip = data;
+    version = len > 0 ? ip[0] >> 4 : 0;
+    gso_type = vnet_hdr->gso_type & ~OGS_TUN_VNET_HDR_GSO_ECN;
+
+    if (len <= 0 || len > OGS_TUN_MAX_GSO_LEN) {
+        ogs_error("Invalid packet [len:%d]", len);
+        return OGS_ERROR;
+    }
+
+    if (vnet_hdr->flags & OGS_TUN_VNET_HDR_F_NEEDS_CSUM) {
+        if (vnet_hdr->csum_start + vnet_hdr->csum_offset + 2 > len) {
+            ogs_error("Invalid checksum offset [%d:%d, len:%d]",
+                    vnet_hdr->csum_start, vnet_hdr->csum_offset, len);
+            return OGS_ERROR;
+        }
+    }
+
+    if (gso_type == OGS_TUN_VNET_HDR_GSO_NONE) {
+        gso->data = data;
+        gso->len = len;
+        return OGS_OK;
+    }
+
+    if (!(gso_type == OGS_TUN_VNET_HDR_GSO_TCPV4 && version == 4) &&
+        !(gso_type == OGS_TUN_VNET_HDR_GSO_TCPV6 && version == 6)) {
+        ogs_error("Not supported GSO [type:%d, IP version:%d]",
+                vnet_hdr->gso_type, version);
+        return OGS_ERROR;
+    }
+
+    /* The kernel always asks for the TCP checksum with GSO */
+    if (!(vnet_hdr->flags & OGS_TUN_VNET_HDR_F_NEEDS_CSUM) ||
+        vnet_hdr->csum_offset != TCP_CHECK ||
+        vnet_hdr->csum_start + TCP_HLEN > len ||
+        vnet_hdr->gso_size == 0) {
+        ogs_error("Invalid GSO packet [csum:%d:%d, gso_size:%d, len:%d]",
+                vnet_hdr->csum_start, vnet_hdr->csum_offset,
+                vnet_hdr->gso_size, len);
+        return OGS_ERROR;
+    }
+
+    gso->l4_offset = vnet_hdr->csum_start;
+    gso->hdr_len = gso->l4_offset +
+        ((ip[gso->l4_offset + TCP_DOFF] >> 4) << 2);
+    if (gso->hdr_len < gso->l4_offset + TCP_HLEN || gso->hdr_len > len) {
+        ogs_error("Invalid TCP header [len:%d]", len);
+        return OGS_ERROR;
+    }
+    gso->offset = gso->hdr_len;
+
+    gso->data = data;
+    gso->len = len;
+
+    return OGS_OK;
+}
+
+/* Small packets come from the pkbuf cache */
+static ogs_pkbuf_t *gso_alloc(ogs_pkbuf_pool_t *packet_pool, int len)
+{
+    ogs_pkbuf_t *pkbuf = NULL;
+
+    pkbuf = ogs_pkbuf_alloc(packet_pool,
+            ogs_max(OGS_MAX_PKT_LEN, OGS_TUN_MAX_HEADROOM + len));
+    ogs_assert(pkbuf);
+    ogs_pkbuf_reserve(pkbuf, OGS_TUN_MAX_HEADROOM);
+
+    return pkbuf;
+}
+
+static ogs_pkbuf_t *gso_next_segment(
+        ogs_tun_gso_t *gso, ogs_pkbuf_pool_t *packet_pool)
+{
+    ogs_pkbuf_t *segbuf = NULL;
+    uint8_t *ip = NULL, *tcp = NULL;
+    int seg_len, payload, last;
+    uint8_t flags;
+
+    payload = ogs_min(gso->vnet_hdr.gso_size, gso->len - gso->offset);
+    last = gso->offset + payload == gso->len;
+    seg_len = gso->hdr_len + payload;
+
+    segbuf = gso_alloc(packet_pool, seg_len);
+    ogs_pkbuf_put_data(segbuf, gso->data, gso->hdr_len);
+    ogs_pkbuf_put_data(segbuf, gso->data + gso->offset, payload);
+
+    ip = segbuf->data;
+    tcp = ip + gso->l4_offset;
+
+    if ((ip[0] >> 4) == 4)
+        put16(ip + IPV4_ID, get16(ip + IPV4_ID) + gso->index);
+    ip_set_len(ip, seg_len);
+
+    put32(tcp + TCP_SEQ,
+            get32(tcp + TCP_SEQ) + (gso->offset - gso->hdr_len));
+
+    flags = tcp[TCP_FLAGS];
+    if (!last)
+        flags &= ~(TCP_FLAG_FIN | TCP_FLAG_PSH);
+    if (gso->index)
+        flags &= ~TCP_FLAG_CWR;
+    tcp[TCP_FLAGS] = flags;
+
+    put16(tcp + TCP_CHECK, 0);
+    put16(tcp + TCP_CHECK, ~csum_fold(csum_add(
+                pseudo_sum(ip, seg_len - gso->l4_offset),
+                tcp, seg_len - gso->l4_offset)));
+
+    gso->offset += payload;
+    gso->index++;
+
+    return segbuf;
+}
+
+ogs_pkbuf_t *ogs_tun_gso_next(ogs_tun_gso_t *gso,
+        ogs_pkbuf_pool_t *packet_pool)
+{
+    ogs_pkbuf_t *pkbuf = NULL;
+
+    ogs_assert(gso);
+
+    if (!gso->data)
+        return NULL;
+
+    /* Segment while there is payload left, or copy the packet as is */
+    if (gso->hdr_len) {
+        pkbuf = gso_next_segment(gso, packet_pool);
+        if (gso->offset == gso->len)
+            gso->data = NULL;
+        return pkbuf;
+    }
+
+    pkbuf = gso_alloc(packet_pool, gso->len);
+    ogs_pkbuf_put_data(pkbuf, gso->data, gso->len);
+
+    if (gso->vnet_hdr.flags & OGS_TUN_VNET_HDR_F_NEEDS_CSUM) {
+        /* The checksum field holds the pseudo header sum */
+        int start = gso->vnet_hdr.csum_start;
+        uint8_t *p = pkbuf->data;
+
+        put16(p + start + gso->vnet_hdr.csum_offset,
+                ~csum_fold(csum_add(0, p + start, pkbuf->len - start)));
+    }
+
+    gso->data = NULL;
+
+    return pkbuf;
+}
+
+/*
+ * Return the offset of the TCP header if the packet may be coalesced:
+ * an unfragmented TCP segment with payload and only ACK or ACK|PSH.
+ */
+static int gro_l4_offset(ogs_pkbuf_t *pkbuf)
+{
+    uint8_t *ip = pkbuf->data;
+    int l4_offset;
+
+    if (pkbuf->len < IPV4_HLEN)
+        return -1;
+
+    if ((ip[0] >> 4) == 4) {
+        if ((ip[0] & 0x0f) != 5 || ip[IPV4_PROTO] != 6 ||
+            (get16(ip + IPV4_FRAG_OFF) & 0x3fff) != 0 ||
+            get16(ip + IPV4_TOT_LEN) != pkbuf->len)
+            return -1;
+        l4_offset = IPV4_HLEN;
+    } else if ((ip[0] >> 4) == 6) {
+        if (pkbuf->len < IPV6_HLEN || ip[IPV6_NEXTHDR] != 6 ||
+            get16(ip + IPV6_PAYLOAD_LEN) + IPV6_HLEN != pkbuf->len)
+            return -1;
+        l4_offset = IPV6_HLEN;
+    } else {
+        return -1;
+    }
+
+    if (pkbuf->len < l4_offset + TCP_HLEN ||
+        (ip[l4_offset + TCP_FLAGS] & ~TCP_FLAG_PSH) != TCP_FLAG_ACK ||
+        pkbuf->len <= l4_offset + ((ip[l4_offset + TCP_DOFF] >> 4) << 2))
+        return -1;
+
+    return l4_offset;
+}
+
+static bool gro_can_merge(ogs_tun_gro_t *gro,
+        ogs_socket_t fd, ogs_pkbuf_t *pkbuf, int l4_offset)
+{
+    uint8_t *ip0 = gro->seg[0]->data;
+    uint8_t *ip = pkbuf->data;
+    uint8_t *tcp = ip + l4_offset;
+    int payload = pkbuf->len - gro->hdr_len;
+
+    if (fd != gro->fd || l4_offset != gro->l4_offset ||
+        pkbuf->len <= gro->hdr_len || payload > gro->mss ||
+        gro->len + payload > OGS_TUN_MAX_GSO_LEN)
+        return false;
+
+    if ((ip[0] >> 4) == 4) {
+        /* Everything but the length, ID and checksum */
+        if (memcmp(ip0, ip, 2) || memcmp(ip0 + IPV4_FRAG_OFF,
+                    ip + IPV4_FRAG_OFF, IPV4_CHECK - IPV4_FRAG_OFF) ||
+            memcmp(ip0 + IPV4_SADDR, ip + IPV4_SADDR, 8))
+            return false;
+    } else {
+        if (memcmp(ip0, ip, IPV6_PAYLOAD_LEN) ||
+            memcmp(ip0 + IPV6_NEXTHDR, ip + IPV6_NEXTHDR,
+                IPV6_HLEN - IPV6_NEXTHDR))
+            return false;
+    }
+
+    /* Ports, ACK, header length and options must match */
+    if (get32(tcp + TCP_SEQ) != gro->next_seq ||
+        memcmp(ip0 + l4_offset, tcp, TCP_SEQ) ||
+        memcmp(ip0 + l4_offset + TCP_ACK, tcp + TCP_ACK, 5) ||
+        memcmp(ip0 + l4_offset + TCP_HLEN, tcp + TCP_HLEN,
+            gro->hdr_len - l4_offset - TCP_HLEN))
+        return false;
+
+    return true;
+}
+
+int ogs_tun_gro_write(ogs_tun_gro_t *gro, ogs_socket_t fd, ogs_pkbuf_t *pkbuf)
+{
+    uint8_t *tcp = NULL;
+    int l4_offset, payload, rv = OGS_OK;
+
+    ogs_assert(gro);
+    ogs_assert(fd != INVALID_SOCKET);
+    ogs_assert(pkbuf);
+
+    l4_offset = gro_l4_offset(pkbuf);
+
+    if (gro->num_of_seg && l4_offset > 0 &&
+        gro_can_merge(gro, fd, pkbuf, l4_offset)) {
+        payload = pkbuf->len - gro->hdr_len;
+    } else {
+        rv = ogs_tun_gro_flush(gro);
+
+        if (l4_offset < 0) {
+            if (ogs_tun_write_offload(fd, pkbuf) != OGS_OK)
+                rv = OGS_ERROR;
+            ogs_pkbuf_free(pkbuf);
+            return rv;
+        }
+
+        tcp = (uint8_t *)pkbuf->data + l4_offset;
+
+        gro->fd = fd;
+        gro->l4_offset = l4_offset;
+        gro->hdr_len = l4_offset + ((tcp[TCP_DOFF] >> 4) << 2);
+        gro->mss = pkbuf->len - gro->hdr_len;
+        gro->len = gro->hdr_len;
+        gro->next_seq = get32(tcp + TCP_SEQ);
+
+        payload = gro->mss;
+    }
+
+    tcp = (uint8_t *)pkbuf->data + l4_offset;
+
+    gro->seg[gro->num_of_seg++] = pkbuf;
+    gro->len += payload;
+    gro->next_seq += payload;
+
+    /* A short or pushed segment ends the super-packet */
+    if (payload < gro->mss || (tcp[TCP_FLAGS] & TCP_FLAG_PSH) ||
+        gro->num_of_seg == OGS_TUN_MAX_GRO_SEGS)
+        rv = ogs_tun_gro_flush(gro);
+
+    return rv;
+}
+
+int ogs_tun_gro_flush(ogs_tun_gro_t *gro)
+{
+#if defined(__linux__)
+    ogs_tun_vnet_hdr_t vnet_hdr;
+    struct iovec iov[OGS_TUN_MAX_GRO_SEGS + 1];
+    uint8_t *ip = NULL, *tcp = NULL;
+    int i, rv;
+
+    ogs_assert(gro);
+
+    if (!gro->num_of_seg)
+        return OGS_OK;
+
+    memset(&vnet_hdr, 0, sizeof(vnet_hdr));
+
+    if (gro->num_of_seg > 1) {
+        ip = gro->seg[0]->data;
+        tcp = ip + gro->l4_offset;
+
+        ip_set_len(ip, gro->len);
+        tcp[TCP_FLAGS] |=
+            ((uint8_t *)gro->seg[gro->num_of_seg-1]->data)[
+                gro->l4_offset + TCP_FLAGS] & TCP_FLAG_PSH;
+
+        /* The kernel completes the checksum from the pseudo header sum */
+        put16(tcp + TCP_CHECK,
+                csum_fold(pseudo_sum(ip, gro->len - gro->l4_offset)));
+
+        vnet_hdr.flags = OGS_TUN_VNET_HDR_F_NEEDS_CSUM;
+        vnet_hdr.gso_type = (ip[0] >> 4) == 4 ?
+            OGS_TUN_VNET_HDR_GSO_TCPV4 : OGS_TUN_VNET_HDR_GSO_TCPV6;
+        vnet_hdr.hdr_len = gro->hdr_len;
+        vnet_hdr.gso_size = gro->mss;
+        vnet_hdr.csum_start = gro->l4_offset;
+        vnet_hdr.csum_offset = TCP_CHECK;
+    }
+
+    iov[1].iov_base = gro->seg[0]->data;
+    iov[1].iov_len = gro->seg[0]->len;
+    for (i = 1; i < gro->num_of_seg; i++) {
+        iov[i+1].iov_base = (uint8_t *)gro->seg[i]->data + gro->hdr_len;
+        iov[i+1].iov_len = gro->seg[i]->len - gro->hdr_len;
+    }
+
+    rv = write_vnet_hdr(gro->fd, &vnet_hdr, iov, gro->num_of_seg + 1);
+
+    for (i = 0; i < gro->num_of_seg; i++)
+        ogs_pkbuf_free(gro->seg[i]);
+    gro->num_of_seg = 0;
+
+    return rv;
+#else
+    int i;
+
+    ogs_assert(gro);
+
+    for (i = 0; i < gro->num_of_seg; i++)
+        ogs_pkbuf_free(gro->seg[i]);
+    gro->num_of_seg = 0;
+
+    return OGS_ERROR;
+#endif
+}
@@ -46,11 +46,88 @@ extern "C" {
 #define OGS_TUN_MAX_HEADROOM 16
 
 ogs_socket_t ogs_tun_open(char *ifname, int maxlen, int is_tap);
+ogs_socket_t ogs_tun_open_multi_queue(char *ifname, int maxlen, int is_tap);
 int ogs_tun_set_ip(char *ifname, ogs_ipsubnet_t *gw,  ogs_ipsubnet_t *sub);
 
 ogs_pkbuf_t *ogs_tun_read(ogs_socket_t fd, ogs_pkbuf_pool_t *packet_pool);
 int ogs_tun_write(ogs_socket_t fd, ogs_pkbuf_t *pkbuf);
 
+/*
+ * TUN offload (Linux only)
+ *
+ * The device is opened with IFF_VNET_HDR and TCP segmentation offload,
+ * so every packet read or written is preceded by ogs_tun_vnet_hdr_t.
+ *
+ * - Read : The kernel may hand over a TCP super-packet of up to 64KB
+ *          (GSO) with the checksum left undone. It is read into a
+ *          buffer of the calling thread, which holds it until the
+ *          thread reads again. ogs_tun_gso_next() copies it out into
+ *          MTU-sized packets with valid checksums.
+ * - Write: ogs_tun_gro_write() coalesces consecutive TCP segments of
+ *          one flow into a single super-packet (GRO) and the kernel
+ *          segments it again if it has to.
+ *
+ * $ sudo ip tuntap add name ogstun mode tun vnet_hdr
+ */
+#define OGS_TUN_MAX_GSO_LEN                 65535
+#define OGS_TUN_MAX_GRO_SEGS                64
+
+typedef struct ogs_tun_vnet_hdr_s {
+#define OGS_TUN_VNET_HDR_F_NEEDS_CSUM       1
+    uint8_t flags;
+#define OGS_TUN_VNET_HDR_GSO_NONE           0
+#define OGS_TUN_VNET_HDR_GSO_TCPV4          1
+#define OGS_TUN_VNET_HDR_GSO_TCPV6          4
+#define OGS_TUN_VNET_HDR_GSO_ECN            0x80
+    uint8_t gso_type;
+    /* Host byte order */
+    uint16_t hdr_len;
+    uint16_t gso_size;
+    uint16_t csum_start;
+    uint16_t csum_offset;
+} ogs_tun_vnet_hdr_t;
+
+ogs_socket_t ogs_tun_open_offload(char *ifname, int maxlen, int multi_queue);
+
+/* Returns the length of the packet at '*data', or OGS_ERROR */
+int ogs_tun_read_offload(ogs_socket_t fd,
+        ogs_tun_vnet_hdr_t *vnet_hdr, uint8_t **data);
+int ogs_tun_write_offload(ogs_socket_t fd, ogs_pkbuf_t *pkbuf);
+
+typedef struct ogs_tun_gso_s {
+    uint8_t *data;          /* NULL : nothing left */
+    int len;
+    ogs_tun_vnet_hdr_t vnet_hdr;
+
+    int l4_offset;
+    int hdr_len;
+    int offset;
+    int index;
+} ogs_tun_gso_t;
+
+/* 'data' must stay until ogs_tun_gso_next() returns NULL */
+int ogs_tun_gso_init(ogs_tun_gso_t *gso,
+        uint8_t *data, int len, ogs_tun_vnet_hdr_t *vnet_hdr);
+ogs_pkbuf_t *ogs_tun_gso_next(ogs_tun_gso_t *gso,
+        ogs_pkbuf_pool_t *packet_pool);
+
+typedef struct ogs_tun_gro_s {
+    ogs_socket_t fd;
+
+    int num_of_seg;
+    ogs_pkbuf_t *seg[OGS_TUN_MAX_GRO_SEGS];
+
+    int len;
+    int l4_offset;
+    int hdr_len;
+    int mss;
+    uint32_t next_seq;
+} ogs_tun_gro_t;
+
+/* pkbuf is consumed */
+int ogs_tun_gro_write(ogs_tun_gro_t *gro, ogs_socket_t fd, ogs_pkbuf_t *pkbuf);
+int ogs_tun_gro_flush(ogs_tun_gro_t *gro);
+
 #ifdef __cplusplus
 }
 #endif
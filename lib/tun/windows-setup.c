@@ -29,6 +29,20 @@ ogs_socket_t ogs_tun_open(char *ifname, int len, int is_tap)
     return INVALID_SOCKET;
 }
 
+ogs_socket_t ogs_tun_open_multi_queue(char *ifname, int len, int is_tap)
+{
+    ogs_error("Not implemented");
+    ogs_assert_if_reached();
+    return INVALID_SOCKET;
+}
+
+ogs_socket_t ogs_tun_open_offload(char *ifname, int len, int multi_queue)
+{
+    ogs_error("Not implemented");
+    ogs_assert_if_reached();
+    return INVALID_SOCKET;
+}
+
 int ogs_tun_set_ip(char *ifname, ogs_ipsubnet_t *gw, ogs_ipsubnet_t *sub)
 {
     ogs_error("Not implemented");
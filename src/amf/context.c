@@ -2320,6 +2320,7 @@ void amf_sbi_select_nf(
 {
     OpenAPI_nf_type_e target_nf_type = OpenAPI_nf_type_NULL;
     ogs_sbi_nf_instance_t *nf_instance = NULL;
+    amf_ue_t *amf_ue = NULL;
     amf_sess_t *sess = NULL;
 
     ogs_assert(sbi_object);
@@ -2330,8 +2331,13 @@ void amf_sbi_select_nf(
 
     switch(sbi_object->type) {
     case OGS_SBI_OBJ_UE_TYPE:
-        nf_instance = ogs_sbi_nf_instance_find_by_discovery_param(
-                        target_nf_type, requester_nf_type, discovery_option);
+        amf_ue = (amf_ue_t *)sbi_object;
+        ogs_assert(amf_ue);
+
+        nf_instance = ogs_sbi_nf_instance_select(
+                        target_nf_type, requester_nf_type, discovery_option,
+                        ogs_sbi_self()->discovery_config.sticky_supi ?
+                            amf_ue->supi : NULL);
         if (nf_instance)
             OGS_SBI_SETUP_NF_INSTANCE(
                     sbi_object->service_type_array[service_type], nf_instance);
@@ -2339,18 +2345,16 @@ void amf_sbi_select_nf(
     case OGS_SBI_OBJ_SESS_TYPE:
         sess = (amf_sess_t *)sbi_object;
         ogs_assert(sess);
+        amf_ue = sess->amf_ue;
+        ogs_assert(amf_ue);
 
-        ogs_list_for_each(&ogs_sbi_self()->nf_instance_list, nf_instance) {
-            if (ogs_sbi_discovery_param_is_matched(
-                    nf_instance,
-                    target_nf_type, requester_nf_type, discovery_option) ==
-                        false)
-                continue;
-
+        nf_instance = ogs_sbi_nf_instance_select(
+                        target_nf_type, requester_nf_type, discovery_option,
+                        ogs_sbi_self()->discovery_config.sticky_supi ?
+                            amf_ue->supi : NULL);
+        if (nf_instance)
             OGS_SBI_SETUP_NF_INSTANCE(
                     sbi_object->service_type_array[service_type], nf_instance);
-            break;
-        }
         break;
     default:
         ogs_fatal("(NF discover search result) Not implemented [%d]",
@@ -118,22 +118,9 @@ static void bsf_main(void *data)
          */
         ogs_timer_mgr_expire(ogs_app()->timer_mgr);
 
-        for ( ;; ) {
-            bsf_event_t *e = NULL;
-
-            rv = ogs_queue_trypop(ogs_app()->queue, (void**)&e);
-            ogs_assert(rv != OGS_ERROR);
-
-            if (rv == OGS_DONE)
-                goto done;
-
-            if (rv == OGS_RETRY)
-                break;
-
-            ogs_assert(e);
-            ogs_fsm_dispatch(&bsf_sm, e);
-            ogs_event_free(e);
-        }
+        rv = ogs_fsm_dispatch_queue(&bsf_sm, ogs_app()->queue, ogs_event_free);
+        if (rv == OGS_DONE)
+            goto done;
     }
 done:
 
@@ -109,22 +109,9 @@ static void hss_main(void *data)
          */
         ogs_timer_mgr_expire(ogs_app()->timer_mgr);
 
-        for ( ;; ) {
-            hss_event_t *e = NULL;
-
-            rv = ogs_queue_trypop(ogs_app()->queue, (void**)&e);
-            ogs_assert(rv != OGS_ERROR);
-
-            if (rv == OGS_DONE)
-                goto done;
-
-            if (rv == OGS_RETRY)
-                break;
-
-            ogs_assert(e);
-            ogs_fsm_dispatch(&hss_sm, e);
-            hss_event_free(e);
-        }
+        rv = ogs_fsm_dispatch_queue(&hss_sm, ogs_app()->queue, hss_event_free);
+        if (rv == OGS_DONE)
+            goto done;
     }
 done:
 
@@ -64,6 +64,11 @@ static int check_signal(int signum)
                 signum, ogs_signal_description_get(signum));
         break;
     case SIGUSR1:
+        fprintf(stderr,
+                "%*s%-30s contains %6lu bytes in %3lu blocks\n",
+                0, "", "ogs_malloc",
+                (unsigned long)ogs_mem_total_size(),
+                (unsigned long)ogs_mem_total_blocks());
         fprintf(stderr,
                 "%*s%-30s contains %6lu bytes in %3lu blocks (ref %d) %p\n",
                 0, "", "core",
@@ -71,9 +76,21 @@ static int check_signal(int signum)
                 (unsigned long)talloc_total_blocks(__ogs_talloc_core),
                 (int)talloc_reference_count(__ogs_talloc_core),
                 __ogs_talloc_core);
+        if (ogs_app()->queue) {
+            ogs_queue_stat_t stat;
+
+            ogs_queue_stat(ogs_app()->queue, &stat);
+            fprintf(stderr,
+                    "%*s%-30s holds %u of %u events "
+                    "(high water %u, full %llu)\n",
+                    0, "", "event queue",
+                    stat.size, stat.capacity, stat.high_water,
+                    (unsigned long long)stat.full);
+        }
         break;
 
     case SIGUSR2:
+        ogs_mem_report_full(stderr);
         talloc_report_full(__ogs_talloc_core, stderr);
         break;
 
@@ -100,6 +100,7 @@ bool nrf_nnrf_handle_nf_register(ogs_sbi_nf_instance_t *nf_instance,
         memcpy(nf_instance->plmn_id, ogs_local_conf()->serving_plmn_id,
                 sizeof(nf_instance->plmn_id));
         nf_instance->num_of_plmn_id = ogs_local_conf()->num_of_serving_plmn_id;
+        ogs_sbi_nf_instance_reindex(nf_instance);
     }
 
     if (OGS_FSM_CHECK(&nf_instance->sm, nrf_nf_state_will_register)) {
@@ -235,20 +236,7 @@ bool nrf_nnrf_handle_nf_update(ogs_sbi_nf_instance_t *nf_instance,
                 return false;
             }
 
-            if (patch_item->op != OpenAPI_patch_operation_replace) {
-                ogs_error("Unknown PatchItem.Operation [%s]",
-                        OpenAPI_patch_operation_ToString(patch_item->op));
-                continue;
-            }
-
-            SWITCH(patch_item->path)
-            CASE(OGS_SBI_PATCH_PATH_NF_STATUS)
-                break;
-            CASE(OGS_SBI_PATCH_PATH_LOAD)
-                break;
-            DEFAULT
-                ogs_error("Unknown PatchItem.Path [%s]", patch_item->path);
-            END
+            ogs_nnrf_nfm_handle_nf_patch_item(nf_instance, patch_item);
         }
 
         response = ogs_sbi_build_response(
@@ -768,17 +756,60 @@ bool nrf_nnrf_handle_nf_profile_retrieval(
     return true;
 }
 
+static ogs_sbi_response_t *build_search_result_response(
+        OpenAPI_list_t *NFProfileList, int validity_period)
+{
+    ogs_sbi_response_t *response = NULL;
+    char *content = NULL;
+    char *cache_control = NULL;
+
+    ogs_assert(NFProfileList);
+
+    content = ogs_nnrf_disc_build_search_result(
+            NFProfileList, validity_period);
+    if (!content) {
+        ogs_error("ogs_nnrf_disc_build_search_result() failed");
+        return NULL;
+    }
+
+    ogs_log_print(OGS_LOG_TRACE, "%s", content);
+
+    response = ogs_sbi_response_new();
+    if (!response) {
+        ogs_error("ogs_sbi_response_new() failed");
+        ogs_free(content);
+        return NULL;
+    }
+
+    response->status = OGS_SBI_HTTP_STATUS_OK;
+    response->http.content = content;
+    response->http.content_length = strlen(content);
+    ogs_sbi_header_set(response->http.headers,
+            OGS_SBI_CONTENT_TYPE, OGS_SBI_CONTENT_JSON_TYPE);
+
+    if (validity_period) {
+        cache_control = ogs_msprintf("max-age=%d", validity_period);
+        ogs_assert(cache_control);
+        ogs_sbi_header_set(response->http.headers,
+                "Cache-Control", cache_control);
+        ogs_free(cache_control);
+    }
+
+    return response;
+}
+
 bool nrf_nnrf_handle_nf_discover(
         ogs_sbi_stream_t *stream, ogs_sbi_message_t *recvmsg)
 {
-    ogs_sbi_message_t sendmsg;
     ogs_sbi_response_t *response = NULL;
     ogs_sbi_nf_instance_t *nf_instance = NULL;
+    ogs_sbi_nf_instance_cursor_t cursor;
     ogs_sbi_discovery_option_t *discovery_option = NULL;
 
-    OpenAPI_search_result_t *SearchResult = NULL;
-    OpenAPI_nf_profile_t *NFProfile = NULL;
+    OpenAPI_list_t *NFProfileList = NULL;
     OpenAPI_lnode_t *node = NULL;
+    char *nf_profile = NULL;
+    bool cached, service_map;
     int i;
 
     ogs_assert(stream);
@@ -864,14 +895,24 @@ bool nrf_nnrf_handle_nf_discover(
         }
     }
 
-    SearchResult = ogs_calloc(1, sizeof(*SearchResult));
-    ogs_assert(SearchResult);
+    /*
+     * Unless service-names are given, the NFProfile does not depend
+     * on the query, so the JSON cached in the NF Instance is reused.
+     */
+    cached = !(discovery_option && discovery_option->num_of_service_names);
+    service_map = discovery_option &&
+        OGS_SBI_FEATURES_IS_SET(
+            discovery_option->requester_features,
+            OGS_SBI_NNRF_DISC_SERVICE_MAP) ? true : false;
 
-    SearchResult->nf_instances = OpenAPI_list_create();
-    ogs_assert(SearchResult->nf_instances);
+    NFProfileList = OpenAPI_list_create();
+    ogs_assert(NFProfileList);
 
     i = 0;
-    ogs_list_for_each(&ogs_sbi_self()->nf_instance_list, nf_instance) {
+    ogs_sbi_nf_instance_cursor_init(&cursor,
+            recvmsg->param.target_nf_type, recvmsg->param.requester_nf_type,
+            discovery_option);
+    while ((nf_instance = ogs_sbi_nf_instance_cursor_next(&cursor))) {
         if (NF_INSTANCE_EXCLUDED_FROM_DISCOVERY(nf_instance))
             continue;
 
@@ -898,42 +939,29 @@ bool nrf_nnrf_handle_nf_discover(
                 OpenAPI_nf_status_ToString(nf_instance->nf_status),
                 nf_instance->num_of_ipv4, nf_instance->num_of_ipv6);
 
-        NFProfile = ogs_nnrf_nfm_build_nf_profile(
-                nf_instance, NULL, discovery_option,
-                discovery_option &&
-                OGS_SBI_FEATURES_IS_SET(
-                    discovery_option->requester_features,
-                    OGS_SBI_NNRF_DISC_SERVICE_MAP) ? true : false);
+        if (cached)
+            nf_profile = ogs_nnrf_nfm_cached_nf_profile_json(
+                    nf_instance, service_map);
+        else
+            nf_profile = ogs_nnrf_nfm_build_nf_profile_json(
+                    nf_instance, discovery_option, service_map);
 
-        if (!NFProfile) {
+        if (!nf_profile) {
             ogs_error("No NFProfile");
             continue;
         }
 
-        OpenAPI_list_add(SearchResult->nf_instances, NFProfile);
+        OpenAPI_list_add(NFProfileList, nf_profile);
 
         i++;
     }
 
-    if (recvmsg->param.limit) SearchResult->num_nf_inst_complete = i;
-
-    memset(&sendmsg, 0, sizeof(sendmsg));
-
-    if (SearchResult->nf_instances->count) {
+    if (NFProfileList->count) {
 
         /* NF-Instances are Discovered */
 
-        SearchResult->is_validity_period = true;
-        SearchResult->validity_period =
-            ogs_local_conf()->time.nf_instance.validity_duration;
-        ogs_assert(SearchResult->validity_period);
-
-        sendmsg.SearchResult = SearchResult;
-        sendmsg.http.cache_control =
-            ogs_msprintf("max-age=%d", SearchResult->validity_period);
-        ogs_assert(sendmsg.http.cache_control);
-
-        response = ogs_sbi_build_response(&sendmsg, OGS_SBI_HTTP_STATUS_OK);
+        response = build_search_result_response(NFProfileList,
+                ogs_local_conf()->time.nf_instance.validity_duration);
         ogs_assert(response);
         ogs_assert(true == ogs_sbi_server_send_response(stream, response));
 
@@ -952,7 +980,9 @@ bool nrf_nnrf_handle_nf_discover(
 
         nrf_assoc_t *assoc = NULL;
 
-        ogs_list_for_each(&ogs_sbi_self()->nf_instance_list, nf_instance) {
+        ogs_sbi_nf_instance_cursor_init(&cursor,
+                OpenAPI_nf_type_NRF, OpenAPI_nf_type_NRF, NULL);
+        while ((nf_instance = ogs_sbi_nf_instance_cursor_next(&cursor))) {
             if (NF_INSTANCE_ID_IS_SELF(nf_instance->id))
                 continue;
 
@@ -1046,9 +1076,7 @@ bool nrf_nnrf_handle_nf_discover(
 
         /* No Discovery */
 
-        sendmsg.SearchResult = SearchResult;
-
-        response = ogs_sbi_build_response(&sendmsg, OGS_SBI_HTTP_STATUS_OK);
+        response = build_search_result_response(NFProfileList, 0);
         ogs_assert(response);
         ogs_assert(true == ogs_sbi_server_send_response(stream, response));
 
@@ -1056,16 +1084,13 @@ bool nrf_nnrf_handle_nf_discover(
     }
 
 cleanup:
-    OpenAPI_list_for_each(SearchResult->nf_instances, node) {
-        NFProfile = node->data;
-        if (NFProfile) ogs_nnrf_nfm_free_nf_profile(NFProfile);
+    if (cached == false) {
+        OpenAPI_list_for_each(NFProfileList, node) {
+            nf_profile = node->data;
+            if (nf_profile) ogs_free(nf_profile);
+        }
     }
-    OpenAPI_list_free(SearchResult->nf_instances);
-
-    if (sendmsg.http.cache_control)
-        ogs_free(sendmsg.http.cache_control);
-
-    ogs_free(SearchResult);
+    OpenAPI_list_free(NFProfileList);
 
     return true;
 }
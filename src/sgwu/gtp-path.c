@@ -24,40 +24,22 @@
 
 static ogs_pkbuf_pool_t *packet_pool = NULL;
 
-static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
+/* pkbuf is consumed */
+static void _gtpv1_u_handle_pkbuf(
+        ogs_sock_t *sock, ogs_sockaddr_t *from, ogs_pkbuf_t *pkbuf)
 {
     int len;
-    ssize_t size;
     char buf1[OGS_ADDRSTRLEN];
     char buf2[OGS_ADDRSTRLEN];
 
     sgwu_sess_t *sess = NULL;
 
-    ogs_pkbuf_t *pkbuf = NULL;
-    ogs_sock_t *sock = NULL;
-    ogs_sockaddr_t from;
-
     ogs_gtp2_header_t *gtp_h = NULL;
     ogs_gtp2_header_desc_t header_desc;
     ogs_pfcp_user_plane_report_t report;
 
-    ogs_assert(fd != INVALID_SOCKET);
-    sock = data;
     ogs_assert(sock);
-
-    pkbuf = ogs_pkbuf_alloc(packet_pool, OGS_MAX_PKT_LEN);
-    ogs_assert(pkbuf);
-    ogs_pkbuf_put(pkbuf, OGS_MAX_PKT_LEN);
-
-    size = ogs_recvfrom(fd, pkbuf->data, pkbuf->len, 0, &from);
-    if (size <= 0) {
-        ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
-                "ogs_recv() failed");
-        goto cleanup;
-    }
-
-    ogs_pkbuf_trim(pkbuf, size);
-
+    ogs_assert(from);
     ogs_assert(pkbuf);
     ogs_assert(pkbuf->len);
 
@@ -77,16 +59,17 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
     if (header_desc.type == OGS_GTPU_MSGTYPE_ECHO_REQ) {
         ogs_pkbuf_t *echo_rsp;
 
-        ogs_debug("[RECV] Echo Request from [%s]", OGS_ADDR(&from, buf1));
+        ogs_debug("[RECV] Echo Request from [%s]", OGS_ADDR(from, buf1));
         echo_rsp = ogs_gtp2_handle_echo_req(pkbuf);
         ogs_expect(echo_rsp);
         if (echo_rsp) {
             ssize_t sent;
 
             /* Echo reply */
-            ogs_debug("[SEND] Echo Response to [%s]", OGS_ADDR(&from, buf1));
+            ogs_debug("[SEND] Echo Response to [%s]", OGS_ADDR(from, buf1));
 
-            sent = ogs_sendto(fd, echo_rsp->data, echo_rsp->len, 0, &from);
+            sent = ogs_sendto(sock->fd,
+                    echo_rsp->data, echo_rsp->len, 0, from);
             if (sent < 0 || sent != echo_rsp->len) {
                 ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
                         "ogs_sendto() failed");
@@ -104,7 +87,7 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
     }
 
     ogs_trace("[RECV] GPU-U Type [%d] from [%s] : TEID[0x%x]",
-            header_desc.type, OGS_ADDR(&from, buf1), header_desc.teid);
+            header_desc.type, OGS_ADDR(from, buf1), header_desc.teid);
 
     /* Remove GTP header and send packets to peer NF */
     ogs_assert(ogs_pkbuf_pull(pkbuf, len));
@@ -113,7 +96,6 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
         ogs_pfcp_object_t *pfcp_object = NULL;
         ogs_pfcp_pdr_t *pdr = NULL;
         ogs_gtp2_header_desc_t sendhdr;
-        ogs_pkbuf_t *sendbuf = NULL;
 
         pfcp_object = ogs_pfcp_object_find_by_teid(header_desc.teid);
         if (!pfcp_object) {
@@ -135,9 +117,9 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
                 ogs_error("[%s] Send Error Indication [TEID:0x%x] to [%s]",
                         OGS_ADDR(&sock->local_addr, buf1),
                         header_desc.teid,
-                        OGS_ADDR(&from, buf2));
+                        OGS_ADDR(from, buf2));
                 ogs_gtp1_send_error_indication(
-                        sock, header_desc.teid, 0, &from);
+                        sock, header_desc.teid, 0, from);
             }
             goto cleanup;
         }
@@ -154,14 +136,12 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
 
         ogs_assert(pdr);
 
-        sendbuf = ogs_pkbuf_copy(pkbuf);
-        ogs_assert(sendbuf);
-
         /* Forward packet */
         memset(&sendhdr, 0, sizeof(sendhdr));
         sendhdr.type = header_desc.type;
 
-        ogs_pfcp_send_g_pdu(pdr, &sendhdr, sendbuf);
+        ogs_pfcp_send_g_pdu(pdr, &sendhdr, pkbuf);
+        pkbuf = NULL;
 
     } else if (header_desc.type == OGS_GTPU_MSGTYPE_ERR_IND) {
         ogs_pfcp_far_t *far = NULL;
@@ -188,6 +168,7 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
         ogs_pfcp_object_t *pfcp_object = NULL;
         ogs_pfcp_sess_t *pfcp_sess = NULL;
         ogs_pfcp_pdr_t *pdr = NULL;
+        ogs_pfcp_packet_key_t key;
 
         ip_h = (struct ip *)pkbuf->data;
         ogs_assert(ip_h);
@@ -212,9 +193,9 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
                 ogs_error("[%s] Send Error Indication [TEID:0x%x] to [%s]",
                         OGS_ADDR(&sock->local_addr, buf1),
                         header_desc.teid,
-                        OGS_ADDR(&from, buf2));
+                        OGS_ADDR(from, buf2));
                 ogs_gtp1_send_error_indication(
-                        sock, header_desc.teid, 0, &from);
+                        sock, header_desc.teid, 0, from);
             }
             goto cleanup;
         }
@@ -230,6 +211,8 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
             pfcp_sess = (ogs_pfcp_sess_t *)pfcp_object;
             ogs_assert(pfcp_sess);
 
+            ogs_pfcp_packet_key_init(&key, pkbuf);
+
             ogs_list_for_each(&pfcp_sess->pdr_list, pdr) {
                 /* Check if TEID */
                 if (header_desc.teid != pdr->f_teid.teid)
@@ -242,7 +225,7 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
 
                 /* Check if Rule List in PDR */
                 if (ogs_list_first(&pdr->rule_list) &&
-                    ogs_pfcp_pdr_rule_find_by_packet(pdr, pkbuf) == NULL)
+                    ogs_pfcp_pdr_rule_find_by_key(pdr, &key) == NULL)
                     continue;
 
                 break;
@@ -262,6 +245,7 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
         ogs_assert(pdr);
         ogs_assert(true == ogs_pfcp_up_handle_pdr(
                     pdr, header_desc.type, &header_desc, pkbuf, &report));
+        pkbuf = NULL;
 
         if (report.type.downlink_data_report) {
             ogs_assert(pdr->sess);
@@ -282,7 +266,67 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
     }
 
 cleanup:
-    ogs_pkbuf_free(pkbuf);
+    if (pkbuf)
+        ogs_pkbuf_free(pkbuf);
+}
+
+static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
+{
+    ssize_t size;
+
+    ogs_pkbuf_t *pkbuf = NULL;
+    ogs_sock_t *sock = NULL;
+    ogs_sockaddr_t from;
+
+    ogs_assert(fd != INVALID_SOCKET);
+    sock = data;
+    ogs_assert(sock);
+
+    /* Keep headroom so the packet can be forwarded without a copy */
+    pkbuf = ogs_pkbuf_alloc(packet_pool, OGS_MAX_PKT_LEN);
+    ogs_assert(pkbuf);
+    ogs_pkbuf_reserve(pkbuf, OGS_GTPV1U_5GC_HEADER_LEN);
+    ogs_pkbuf_put(pkbuf, OGS_MAX_PKT_LEN-OGS_GTPV1U_5GC_HEADER_LEN);
+
+    size = ogs_recvfrom(fd, pkbuf->data, pkbuf->len, 0, &from);
+    if (size <= 0) {
+        ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
+                "ogs_recv() failed");
+        ogs_pkbuf_free(pkbuf);
+        return;
+    }
+
+    ogs_pkbuf_trim(pkbuf, size);
+
+    _gtpv1_u_handle_pkbuf(sock, &from, pkbuf);
+}
+
+/*
+ * The pkbufs point into the packet ring, so the blocks go back
+ * to the kernel only after the whole batch has been forwarded.
+ */
+static void _gtpv1_u_recv_ring_cb(short when, ogs_socket_t fd, void *data)
+{
+    int i, n;
+
+    ogs_pkbuf_t *pkbuf[OGS_MAX_NUM_OF_SOCKMSG];
+    ogs_sockaddr_t from[OGS_MAX_NUM_OF_SOCKMSG];
+    ogs_socknode_t *node = NULL;
+
+    node = data;
+    ogs_assert(node);
+    ogs_assert(node->sock);
+    ogs_assert(node->ring);
+
+    do {
+        n = ogs_gtp_ring_recv(node->ring, packet_pool,
+                pkbuf, from, OGS_MAX_NUM_OF_SOCKMSG);
+
+        for (i = 0; i < n; i++)
+            _gtpv1_u_handle_pkbuf(node->sock, &from[i], pkbuf[i]);
+
+        ogs_gtp_ring_release(node->ring);
+    } while (n == OGS_MAX_NUM_OF_SOCKMSG);
 }
 
 int sgwu_gtp_init(void)
@@ -323,8 +367,20 @@ int sgwu_gtp_open(void)
         else if (sock->family == AF_INET6)
             ogs_gtp_self()->gtpu_sock6 = sock;
 
-        node->poll = ogs_pollset_add(ogs_app()->pollset,
-                OGS_POLLIN, sock->fd, _gtpv1_u_recv_cb, sock);
+        if (node->option && node->option->packet_ring) {
+            /* Falls back to the socket if the ring is not available */
+            node->ring = ogs_gtp_ring_create(sock,
+                    node->option->packet_ring,
+                    node->option->so_bindtodevice, 1);
+        }
+
+        if (node->ring)
+            node->poll = ogs_pollset_add(ogs_app()->pollset,
+                    OGS_POLLIN, ogs_gtp_ring_fd(node->ring),
+                    _gtpv1_u_recv_ring_cb, node);
+        else
+            node->poll = ogs_pollset_add(ogs_app()->pollset,
+                    OGS_POLLIN, sock->fd, _gtpv1_u_recv_cb, sock);
         ogs_assert(node->poll);
     }
 
@@ -335,5 +391,16 @@ int sgwu_gtp_open(void)
 
 void sgwu_gtp_close(void)
 {
+    ogs_socknode_t *node = NULL;
+
+    ogs_list_for_each(&ogs_gtp_self()->gtpu_list, node) {
+        if (node->ring) {
+            ogs_pollset_remove(node->poll);
+            node->poll = NULL;
+            ogs_gtp_ring_destroy(node->ring);
+            node->ring = NULL;
+        }
+    }
+
     ogs_socknode_remove_all(&ogs_gtp_self()->gtpu_list);
 }
@@ -117,22 +117,10 @@ static void sgwu_main(void *data)
          */
         ogs_timer_mgr_expire(ogs_app()->timer_mgr);
 
-        for ( ;; ) {
-            sgwu_event_t *e = NULL;
-
-            rv = ogs_queue_trypop(ogs_app()->queue, (void**)&e);
-            ogs_assert(rv != OGS_ERROR);
-
-            if (rv == OGS_DONE)
-                goto done;
-
-            if (rv == OGS_RETRY)
-                break;
-
-            ogs_assert(e);
-            ogs_fsm_dispatch(&sgwu_sm, e);
-            sgwu_event_free(e);
-        }
+        rv = ogs_fsm_dispatch_queue(
+                &sgwu_sm, ogs_app()->queue, sgwu_event_free);
+        if (rv == OGS_DONE)
+            goto done;
     }
 done:
 
@@ -33,6 +33,7 @@ typedef struct ogs_gtp2_message_s ogs_gtp2_message_t;
 typedef struct ogs_pfcp_node_s ogs_pfcp_node_t;
 typedef struct ogs_pfcp_xact_s ogs_pfcp_xact_t;
 typedef struct ogs_pfcp_message_s ogs_pfcp_message_t;
+typedef struct ogs_pfcp_index_message_s ogs_pfcp_index_message_t;
 typedef struct ogs_diam_gx_message_s ogs_diam_gx_message_t;
 typedef struct ogs_diam_gy_message_s ogs_diam_gy_message_t;
 typedef struct ogs_diam_s6b_message_s ogs_diam_s6b_message_t;
@@ -77,6 +78,7 @@ typedef struct smf_event_s {
     ogs_pfcp_node_t *pfcp_node;
     ogs_pfcp_xact_t *pfcp_xact;
     ogs_pfcp_message_t *pfcp_message;
+    ogs_pfcp_index_message_t *pfcp_index_message;
 
     union {
         ogs_gtp1_message_t *gtp1_message;
@@ -593,7 +593,9 @@ void smf_gsm_state_wait_pfcp_establishment(ogs_fsm_t *s, smf_event_t *e)
     smf_n1_n2_message_transfer_param_t param;
 
     ogs_pfcp_xact_t *pfcp_xact = NULL;
+    ogs_pfcp_header_t *pfcp_h = NULL;
     ogs_pfcp_message_t *pfcp_message = NULL;
+    ogs_pfcp_index_message_t *pfcp_index_message = NULL;
     int rv;
 
     ogs_assert(s);
@@ -612,17 +614,18 @@ void smf_gsm_state_wait_pfcp_establishment(ogs_fsm_t *s, smf_event_t *e)
         pfcp_xact = e->pfcp_xact;
         ogs_assert(pfcp_xact);
         pfcp_message = e->pfcp_message;
-        ogs_assert(pfcp_message);
+        pfcp_index_message = e->pfcp_index_message;
+        ogs_assert(pfcp_message || pfcp_index_message);
+        pfcp_h = pfcp_message ? &pfcp_message->h : &pfcp_index_message->h;
 
-        switch (pfcp_message->h.type) {
+        switch (pfcp_h->type) {
         case OGS_PFCP_SESSION_ESTABLISHMENT_RESPONSE_TYPE:
             if (pfcp_xact->epc) {
                 ogs_gtp_xact_t *gtp_xact = pfcp_xact->assoc_xact;
                 ogs_assert(gtp_xact);
 
                 pfcp_cause = smf_epc_n4_handle_session_establishment_response(
-                        sess, pfcp_xact,
-                        &pfcp_message->pfcp_session_establishment_response);
+                        sess, pfcp_xact, pfcp_index_message);
                 if (pfcp_cause != OGS_PFCP_CAUSE_REQUEST_ACCEPTED) {
                     /* FIXME: tear down Gy and Gx */
                     gtp_cause = gtp_cause_from_pfcp(
@@ -671,8 +674,7 @@ void smf_gsm_state_wait_pfcp_establishment(ogs_fsm_t *s, smf_event_t *e)
                 smf_bearer_binding(sess);
             } else {
                 pfcp_cause = smf_5gc_n4_handle_session_establishment_response(
-                        sess, pfcp_xact,
-                        &pfcp_message->pfcp_session_establishment_response);
+                        sess, pfcp_xact, pfcp_index_message);
                 if (pfcp_cause != OGS_PFCP_CAUSE_REQUEST_ACCEPTED) {
                     OGS_FSM_TRAN(s, smf_gsm_state_5gc_n1_n2_reject);
                     return;
@@ -694,7 +696,7 @@ void smf_gsm_state_wait_pfcp_establishment(ogs_fsm_t *s, smf_event_t *e)
 
         default:
             ogs_error("cannot handle PFCP message type[%d]",
-                    pfcp_message->h.type);
+                    pfcp_h->type);
         }
         break;
 
@@ -726,7 +728,9 @@ void smf_gsm_state_operational(ogs_fsm_t *s, smf_event_t *e)
     ogs_pkbuf_t *pkbuf = NULL;
 
     ogs_pfcp_xact_t *pfcp_xact = NULL;
+    ogs_pfcp_header_t *pfcp_h = NULL;
     ogs_pfcp_message_t *pfcp_message = NULL;
+    ogs_pfcp_index_message_t *pfcp_index_message = NULL;
     uint8_t pfcp_cause;
 
     ogs_diam_gy_message_t *gy_message = NULL;
@@ -812,21 +816,27 @@ void smf_gsm_state_operational(ogs_fsm_t *s, smf_event_t *e)
         pfcp_xact = e->pfcp_xact;
         ogs_assert(pfcp_xact);
         pfcp_message = e->pfcp_message;
-        ogs_assert(pfcp_message);
+        pfcp_index_message = e->pfcp_index_message;
+        ogs_assert(pfcp_message || pfcp_index_message);
+        pfcp_h = pfcp_message ? &pfcp_message->h : &pfcp_index_message->h;
 
-        switch (pfcp_message->h.type) {
+        switch (pfcp_h->type) {
         case OGS_PFCP_SESSION_ESTABLISHMENT_RESPONSE_TYPE:
             if ((pfcp_xact->create_flags &
                         OGS_PFCP_CREATE_RESTORATION_INDICATION)) {
-                ogs_pfcp_session_establishment_response_t *rsp = NULL;
+                ogs_pfcp_tlv_f_seid_t up_f_seid_ie;
                 ogs_pfcp_f_seid_t *up_f_seid = NULL;
 
-                rsp = &pfcp_message->pfcp_session_establishment_response;
-                if (rsp->up_f_seid.presence == 0) {
+                ogs_assert(pfcp_index_message);
+                if (smf_n4_parse_ie(&up_f_seid_ie,
+                            &ogs_pfcp_tlv_desc_f_seid,
+                            pfcp_index_message, 0, NULL) == false)
+                    break;
+                if (up_f_seid_ie.presence == 0) {
                     ogs_error("No UP F-SEID");
                     break;
                 }
-                up_f_seid = rsp->up_f_seid.data;
+                up_f_seid = up_f_seid_ie.data;
                 ogs_assert(up_f_seid);
                 sess->upf_n4_seid = be64toh(up_f_seid->seid);
             } else {
@@ -849,7 +859,7 @@ void smf_gsm_state_operational(ogs_fsm_t *s, smf_event_t *e)
 
         default:
             ogs_error("cannot handle PFCP message type[%d]",
-                    pfcp_message->h.type);
+                    pfcp_h->type);
         }
         break;
 
@@ -1266,7 +1276,9 @@ void smf_gsm_state_wait_pfcp_deletion(ogs_fsm_t *s, smf_event_t *e)
     ogs_sbi_message_t *sbi_message = NULL;
 
     ogs_pfcp_xact_t *pfcp_xact = NULL;
+    ogs_pfcp_header_t *pfcp_h = NULL;
     ogs_pfcp_message_t *pfcp_message = NULL;
+    ogs_pfcp_index_message_t *pfcp_index_message = NULL;
 
     uint8_t pfcp_cause, gtp_cause;
     ogs_gtp_xact_t *gtp_xact = NULL;
@@ -1309,9 +1321,11 @@ void smf_gsm_state_wait_pfcp_deletion(ogs_fsm_t *s, smf_event_t *e)
         pfcp_xact = e->pfcp_xact;
         ogs_assert(pfcp_xact);
         pfcp_message = e->pfcp_message;
-        ogs_assert(pfcp_message);
+        pfcp_index_message = e->pfcp_index_message;
+        ogs_assert(pfcp_message || pfcp_index_message);
+        pfcp_h = pfcp_message ? &pfcp_message->h : &pfcp_index_message->h;
 
-        switch (pfcp_message->h.type) {
+        switch (pfcp_h->type) {
         case OGS_PFCP_SESSION_DELETION_RESPONSE_TYPE:
             if (pfcp_xact->epc) {
                 gtp_xact = pfcp_xact->assoc_xact;
@@ -1415,7 +1429,7 @@ void smf_gsm_state_wait_pfcp_deletion(ogs_fsm_t *s, smf_event_t *e)
 
         default:
             ogs_error("cannot handle PFCP message type[%d]",
-                    pfcp_message->h.type);
+                    pfcp_h->type);
         }
         break;
     case OGS_EVENT_SBI_CLIENT:
@@ -108,6 +108,23 @@ uint8_t gtp_cause_from_pfcp(uint8_t pfcp_cause, uint8_t gtp_version)
     return OGS_GTP2_CAUSE_SYSTEM_FAILURE;
 }
 
+/*
+ * Decode the n-th IE of the indexed response. A missing IE is not an error :
+ * the IE is left with presence 0. A malformed one is rejected
+ * with Mandatory IE incorrect, as the UPF does with requests.
+ */
+bool smf_n4_parse_ie(void *ie, ogs_tlv_desc_t *desc,
+        ogs_pfcp_index_message_t *rsp, int n, uint8_t *cause_value)
+{
+    if (ogs_pfcp_parse_ie(ie, desc, rsp, n) != OGS_ERROR)
+        return true;
+
+    ogs_error("Invalid %s [%d]", desc->name, n);
+    if (cause_value)
+        *cause_value = OGS_PFCP_CAUSE_MANDATORY_IE_INCORRECT;
+    return false;
+}
+
 static int sbi_status_from_pfcp(uint8_t pfcp_cause)
 {
     switch (pfcp_cause) {
@@ -144,13 +161,15 @@ static int sbi_status_from_pfcp(uint8_t pfcp_cause)
  * other cause value on failure */
 uint8_t smf_5gc_n4_handle_session_establishment_response(
         smf_sess_t *sess, ogs_pfcp_xact_t *xact,
-        ogs_pfcp_session_establishment_response_t *rsp)
+        ogs_pfcp_index_message_t *rsp)
 {
     int i;
 
     uint8_t cause_value = OGS_PFCP_CAUSE_REQUEST_ACCEPTED;
     uint8_t offending_ie_value = 0;
 
+    ogs_pfcp_tlv_cause_t cause;
+    ogs_pfcp_tlv_f_seid_t up_f_seid_ie;
     ogs_pfcp_f_seid_t *up_f_seid = NULL;
 
     ogs_pfcp_pdr_t *pdr = NULL;
@@ -164,15 +183,21 @@ uint8_t smf_5gc_n4_handle_session_establishment_response(
 
     ogs_pfcp_xact_commit(xact);
 
-    if (rsp->up_f_seid.presence == 0) {
+    if (smf_n4_parse_ie(&cause, &ogs_pfcp_tlv_desc_cause,
+                rsp, 0, &cause_value) == false ||
+        smf_n4_parse_ie(&up_f_seid_ie, &ogs_pfcp_tlv_desc_f_seid,
+                rsp, 0, &cause_value) == false)
+        return cause_value;
+
+    if (up_f_seid_ie.presence == 0) {
         ogs_error("No UP F-SEID");
         cause_value = OGS_PFCP_CAUSE_MANDATORY_IE_MISSING;
     }
 
-    if (rsp->cause.presence) {
-        if (rsp->cause.u8 != OGS_PFCP_CAUSE_REQUEST_ACCEPTED) {
-            ogs_error("PFCP Cause [%d] : Not Accepted", rsp->cause.u8);
-            cause_value = rsp->cause.u8;
+    if (cause.presence) {
+        if (cause.u8 != OGS_PFCP_CAUSE_REQUEST_ACCEPTED) {
+            ogs_error("PFCP Cause [%d] : Not Accepted", cause.u8);
+            cause_value = cause.u8;
             smf_metrics_inst_by_cause_add(cause_value,
                     SMF_METR_CTR_SM_N4SESSIONESTABFAIL, 1);
         }
@@ -185,8 +210,13 @@ uint8_t smf_5gc_n4_handle_session_establishment_response(
         return cause_value;
 
     for (i = 0; i < OGS_MAX_NUM_OF_PDR; i++) {
+        ogs_pfcp_tlv_created_pdr_t created_pdr;
+
+        if (smf_n4_parse_ie(&created_pdr, &ogs_pfcp_tlv_desc_created_pdr,
+                    rsp, i, &cause_value) == false)
+            break;
         pdr = ogs_pfcp_handle_created_pdr(
-                &sess->pfcp, &rsp->created_pdr[i],
+                &sess->pfcp, &created_pdr,
                 &cause_value, &offending_ie_value);
 
         if (!pdr)
@@ -231,7 +261,7 @@ uint8_t smf_5gc_n4_handle_session_establishment_response(
     }
 
     /* UP F-SEID */
-    up_f_seid = rsp->up_f_seid.data;
+    up_f_seid = up_f_seid_ie.data;
     ogs_assert(up_f_seid);
     sess->upf_n4_seid = be64toh(up_f_seid->seid);
 
@@ -240,13 +270,15 @@ uint8_t smf_5gc_n4_handle_session_establishment_response(
 
 void smf_5gc_n4_handle_session_modification_response(
         smf_sess_t *sess, ogs_pfcp_xact_t *xact,
-        ogs_pfcp_session_modification_response_t *rsp)
+        ogs_pfcp_index_message_t *rsp)
 {
     int status = 0;
     uint64_t flags = 0;
     ogs_sbi_stream_t *stream = NULL;
     smf_bearer_t *qos_flow = NULL;
 
+    ogs_pfcp_tlv_cause_t cause;
+
     OGS_LIST(pdr_to_create_list);
 
     ogs_debug("Session Modification Response [5gc]");
@@ -280,10 +312,13 @@ void smf_5gc_n4_handle_session_modification_response(
         status = OGS_SBI_HTTP_STATUS_NOT_FOUND;
     }
 
-    if (rsp->cause.presence) {
-        if (rsp->cause.u8 != OGS_PFCP_CAUSE_REQUEST_ACCEPTED) {
-            ogs_warn("PFCP Cause [%d] : Not Accepted", rsp->cause.u8);
-            status = sbi_status_from_pfcp(rsp->cause.u8);
+    if (smf_n4_parse_ie(&cause, &ogs_pfcp_tlv_desc_cause,
+                rsp, 0, NULL) == false) {
+        status = sbi_status_from_pfcp(OGS_PFCP_CAUSE_MANDATORY_IE_INCORRECT);
+    } else if (cause.presence) {
+        if (cause.u8 != OGS_PFCP_CAUSE_REQUEST_ACCEPTED) {
+            ogs_warn("PFCP Cause [%d] : Not Accepted", cause.u8);
+            status = sbi_status_from_pfcp(cause.u8);
         }
     } else {
         ogs_error("No Cause");
@@ -301,8 +336,14 @@ void smf_5gc_n4_handle_session_modification_response(
 
         ogs_assert(sess);
         for (i = 0; i < OGS_MAX_NUM_OF_PDR; i++) {
+            ogs_pfcp_tlv_created_pdr_t created_pdr;
+
+            if (smf_n4_parse_ie(&created_pdr,
+                        &ogs_pfcp_tlv_desc_created_pdr,
+                        rsp, i, &pfcp_cause_value) == false)
+                break;
             pdr = ogs_pfcp_handle_created_pdr(
-                    &sess->pfcp, &rsp->created_pdr[i],
+                    &sess->pfcp, &created_pdr,
                     &pfcp_cause_value, &offending_ie_value);
 
             if (!pdr)
@@ -356,7 +397,7 @@ void smf_5gc_n4_handle_session_modification_response(
 
     if (status != OGS_SBI_HTTP_STATUS_OK) {
         char *strerror = ogs_msprintf(
-                "PFCP Cause [%d] : Not Accepted", rsp->cause.u8);
+                "PFCP Cause [%d] : Not Accepted", cause.u8);
         if (stream)
             smf_sbi_send_sm_context_update_error_log(
                     stream, status, strerror, NULL);
@@ -725,12 +766,14 @@ int smf_5gc_n4_handle_session_deletion_response(
  * other cause value on failure */
 uint8_t smf_epc_n4_handle_session_establishment_response(
         smf_sess_t *sess, ogs_pfcp_xact_t *xact,
-        ogs_pfcp_session_establishment_response_t *rsp)
+        ogs_pfcp_index_message_t *rsp)
 {
     uint8_t cause_value = OGS_PFCP_CAUSE_REQUEST_ACCEPTED;
 
     smf_bearer_t *bearer = NULL;
 
+    ogs_pfcp_tlv_cause_t cause;
+    ogs_pfcp_tlv_f_seid_t up_f_seid_ie;
     ogs_pfcp_f_seid_t *up_f_seid = NULL;
 
     ogs_assert(sess);
@@ -741,15 +784,21 @@ uint8_t smf_epc_n4_handle_session_establishment_response(
 
     ogs_pfcp_xact_commit(xact);
 
-    if (rsp->up_f_seid.presence == 0) {
+    if (smf_n4_parse_ie(&cause, &ogs_pfcp_tlv_desc_cause,
+                rsp, 0, &cause_value) == false ||
+        smf_n4_parse_ie(&up_f_seid_ie, &ogs_pfcp_tlv_desc_f_seid,
+                rsp, 0, &cause_value) == false)
+        return cause_value;
+
+    if (up_f_seid_ie.presence == 0) {
         ogs_error("No UP F-SEID");
         cause_value = OGS_PFCP_CAUSE_MANDATORY_IE_MISSING;
     }
 
-    if (rsp->cause.presence) {
-        if (rsp->cause.u8 != OGS_PFCP_CAUSE_REQUEST_ACCEPTED) {
-            ogs_warn("PFCP Cause [%d] : Not Accepted", rsp->cause.u8);
-            cause_value = rsp->cause.u8;
+    if (cause.presence) {
+        if (cause.u8 != OGS_PFCP_CAUSE_REQUEST_ACCEPTED) {
+            ogs_warn("PFCP Cause [%d] : Not Accepted", cause.u8);
+            cause_value = cause.u8;
         }
     } else {
         ogs_error("No Cause");
@@ -764,8 +813,14 @@ uint8_t smf_epc_n4_handle_session_establishment_response(
         ogs_pfcp_far_t *far = NULL;
 
         for (i = 0; i < OGS_MAX_NUM_OF_PDR; i++) {
+            ogs_pfcp_tlv_created_pdr_t created_pdr;
+
+            if (smf_n4_parse_ie(&created_pdr,
+                        &ogs_pfcp_tlv_desc_created_pdr,
+                        rsp, i, &cause_value) == false)
+                break;
             pdr = ogs_pfcp_handle_created_pdr(
-                    &sess->pfcp, &rsp->created_pdr[i],
+                    &sess->pfcp, &created_pdr,
                     &cause_value, &offending_ie_value);
 
             if (!pdr)
@@ -819,7 +874,7 @@ uint8_t smf_epc_n4_handle_session_establishment_response(
     }
 
     /* UP F-SEID */
-    up_f_seid = rsp->up_f_seid.data;
+    up_f_seid = up_f_seid_ie.data;
     ogs_assert(up_f_seid);
     sess->upf_n4_seid = be64toh(up_f_seid->seid);
     return OGS_PFCP_CAUSE_REQUEST_ACCEPTED;
@@ -828,7 +883,7 @@ uint8_t smf_epc_n4_handle_session_establishment_response(
 void smf_epc_n4_handle_session_modification_response(
         smf_sess_t *sess, ogs_pfcp_xact_t *xact,
         ogs_gtp2_message_t *recv_message,
-        ogs_pfcp_session_modification_response_t *rsp)
+        ogs_pfcp_index_message_t *rsp)
 {
     int i;
 
@@ -844,6 +899,8 @@ void smf_epc_n4_handle_session_modification_response(
     ogs_pfcp_pdr_t *pdr = NULL;
     ogs_pfcp_far_t *far = NULL;
 
+    ogs_pfcp_tlv_cause_t cause;
+
     OGS_LIST(pdr_to_create_list);
 
     ogs_assert(xact);
@@ -879,9 +936,12 @@ void smf_epc_n4_handle_session_modification_response(
         return;
     }
 
-    if (rsp->cause.presence) {
-        if (rsp->cause.u8 != OGS_PFCP_CAUSE_REQUEST_ACCEPTED) {
-            ogs_error("PFCP Cause [%d] : Not Accepted", rsp->cause.u8);
+    if (smf_n4_parse_ie(&cause, &ogs_pfcp_tlv_desc_cause,
+                rsp, 0, NULL) == false)
+        return;
+    if (cause.presence) {
+        if (cause.u8 != OGS_PFCP_CAUSE_REQUEST_ACCEPTED) {
+            ogs_error("PFCP Cause [%d] : Not Accepted", cause.u8);
             return;
         }
     } else {
@@ -893,8 +953,13 @@ void smf_epc_n4_handle_session_modification_response(
 
     pfcp_cause_value = OGS_PFCP_CAUSE_REQUEST_ACCEPTED;
     for (i = 0; i < OGS_MAX_NUM_OF_PDR; i++) {
+        ogs_pfcp_tlv_created_pdr_t created_pdr;
+
+        if (smf_n4_parse_ie(&created_pdr, &ogs_pfcp_tlv_desc_created_pdr,
+                    rsp, i, &pfcp_cause_value) == false)
+            break;
         pdr = ogs_pfcp_handle_created_pdr(
-                &sess->pfcp, &rsp->created_pdr[i],
+                &sess->pfcp, &created_pdr,
                 &pfcp_cause_value, &offending_ie_value);
 
         if (!pdr)
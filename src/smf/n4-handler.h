@@ -26,23 +26,26 @@
 extern "C" {
 #endif
 
+bool smf_n4_parse_ie(void *ie, ogs_tlv_desc_t *desc,
+        ogs_pfcp_index_message_t *rsp, int n, uint8_t *cause_value);
+
 uint8_t smf_5gc_n4_handle_session_establishment_response(
         smf_sess_t *sess, ogs_pfcp_xact_t *xact,
-        ogs_pfcp_session_establishment_response_t *rsp);
+        ogs_pfcp_index_message_t *rsp);
 void smf_5gc_n4_handle_session_modification_response(
         smf_sess_t *sess, ogs_pfcp_xact_t *xact,
-        ogs_pfcp_session_modification_response_t *rsp);
+        ogs_pfcp_index_message_t *rsp);
 int smf_5gc_n4_handle_session_deletion_response(
         smf_sess_t *sess, ogs_sbi_stream_t *stream, int trigger,
         ogs_pfcp_session_deletion_response_t *rsp);
 
 uint8_t smf_epc_n4_handle_session_establishment_response(
         smf_sess_t *sess, ogs_pfcp_xact_t *xact,
-        ogs_pfcp_session_establishment_response_t *rsp);
+        ogs_pfcp_index_message_t *rsp);
 void smf_epc_n4_handle_session_modification_response(
         smf_sess_t *sess, ogs_pfcp_xact_t *xact,
         ogs_gtp2_message_t *recv_message,
-        ogs_pfcp_session_modification_response_t *rsp);
+        ogs_pfcp_index_message_t *rsp);
 uint8_t smf_epc_n4_handle_session_deletion_response(
         smf_sess_t *sess, ogs_pfcp_xact_t *xact,
         ogs_pfcp_session_deletion_response_t *rsp);
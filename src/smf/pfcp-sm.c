@@ -70,7 +70,9 @@ void smf_pfcp_state_will_associate(ogs_fsm_t *s, smf_event_t *e)
 
     ogs_pfcp_node_t *node = NULL;
     ogs_pfcp_xact_t *xact = NULL;
+    ogs_pfcp_header_t *h = NULL;
     ogs_pfcp_message_t *message = NULL;
+    ogs_pfcp_index_message_t *index_message = NULL;
 
     ogs_sockaddr_t *addr = NULL;
     smf_sess_t *sess;
@@ -140,11 +142,13 @@ void smf_pfcp_state_will_associate(ogs_fsm_t *s, smf_event_t *e)
         break;
     case SMF_EVT_N4_MESSAGE:
         message = e->pfcp_message;
-        ogs_assert(message);
+        index_message = e->pfcp_index_message;
+        ogs_assert(message || index_message);
+        h = message ? &message->h : &index_message->h;
         xact = e->pfcp_xact;
         ogs_assert(xact);
 
-        switch (message->h.type) {
+        switch (h->type) {
         case OGS_PFCP_HEARTBEAT_REQUEST_TYPE:
             ogs_expect(true ==
                 ogs_pfcp_handle_heartbeat_request(node, xact,
@@ -166,8 +170,7 @@ void smf_pfcp_state_will_associate(ogs_fsm_t *s, smf_event_t *e)
             OGS_FSM_TRAN(s, smf_pfcp_state_associated);
             break;
         default:
-            ogs_warn("cannot handle PFCP message type[%d]",
-                    message->h.type);
+            ogs_warn("cannot handle PFCP message type[%d]", h->type);
             break;
         }
         break;
@@ -183,7 +186,9 @@ void smf_pfcp_state_associated(ogs_fsm_t *s, smf_event_t *e)
 
     ogs_pfcp_node_t *node = NULL;
     ogs_pfcp_xact_t *xact = NULL;
+    ogs_pfcp_header_t *h = NULL;
     ogs_pfcp_message_t *message = NULL;
+    ogs_pfcp_index_message_t *index_message = NULL;
 
     ogs_sockaddr_t *addr = NULL;
     smf_sess_t *sess = NULL;
@@ -222,12 +227,14 @@ void smf_pfcp_state_associated(ogs_fsm_t *s, smf_event_t *e)
         break;
     case SMF_EVT_N4_MESSAGE:
         message = e->pfcp_message;
-        ogs_assert(message);
+        index_message = e->pfcp_index_message;
+        ogs_assert(message || index_message);
+        h = message ? &message->h : &index_message->h;
         xact = e->pfcp_xact;
         ogs_assert(xact);
 
-        if (message->h.seid_presence && message->h.seid != 0) {
-               sess = smf_sess_find_by_seid(message->h.seid);
+        if (h->seid_presence && h->seid != 0) {
+               sess = smf_sess_find_by_seid(h->seid);
         } else if (xact->local_seid) { /* rx no SEID or SEID=0 */
             /* 3GPP TS 29.244 7.2.2.4.2: we receive SEID=0 under some
              * conditions, such as cause "Session context not found". In those
@@ -239,7 +246,7 @@ void smf_pfcp_state_associated(ogs_fsm_t *s, smf_event_t *e)
         if (sess)
             e->sess = sess;
 
-        switch (message->h.type) {
+        switch (h->type) {
         case OGS_PFCP_HEARTBEAT_REQUEST_TYPE:
             ogs_expect(true ==
                 ogs_pfcp_handle_heartbeat_request(node, xact,
@@ -310,7 +317,7 @@ void smf_pfcp_state_associated(ogs_fsm_t *s, smf_event_t *e)
                     &message->pfcp_association_setup_response);
             break;
         case OGS_PFCP_SESSION_ESTABLISHMENT_RESPONSE_TYPE:
-            if (!message->h.seid_presence) ogs_error("No SEID");
+            if (!h->seid_presence) ogs_error("No SEID");
 
             if (!sess) {
                 ogs_gtp_xact_t *gtp_xact = xact->assoc_xact;
@@ -333,19 +340,18 @@ void smf_pfcp_state_associated(ogs_fsm_t *s, smf_event_t *e)
             break;
 
         case OGS_PFCP_SESSION_MODIFICATION_RESPONSE_TYPE:
-            if (!message->h.seid_presence) ogs_error("No SEID");
+            if (!h->seid_presence) ogs_error("No SEID");
 
             if (xact->epc)
                 smf_epc_n4_handle_session_modification_response(
-                    sess, xact, e->gtp2_message,
-                    &message->pfcp_session_modification_response);
+                    sess, xact, e->gtp2_message, index_message);
             else
                 smf_5gc_n4_handle_session_modification_response(
-                    sess, xact, &message->pfcp_session_modification_response);
+                    sess, xact, index_message);
             break;
 
         case OGS_PFCP_SESSION_DELETION_RESPONSE_TYPE:
-            if (!message->h.seid_presence) ogs_error("No SEID");
+            if (!h->seid_presence) ogs_error("No SEID");
 
             if (!sess) {
                 ogs_gtp_xact_t *gtp_xact = xact->assoc_xact;
@@ -368,7 +374,7 @@ void smf_pfcp_state_associated(ogs_fsm_t *s, smf_event_t *e)
             break;
 
         case OGS_PFCP_SESSION_REPORT_REQUEST_TYPE:
-            if (!message->h.seid_presence) ogs_error("No SEID");
+            if (!h->seid_presence) ogs_error("No SEID");
 
             if (!sess) {
                     ogs_error("No Session");
@@ -381,8 +387,7 @@ void smf_pfcp_state_associated(ogs_fsm_t *s, smf_event_t *e)
             break;
 
         default:
-            ogs_error("Not implemented PFCP message type[%d]",
-                    message->h.type);
+            ogs_error("Not implemented PFCP message type[%d]", h->type);
             break;
         }
 
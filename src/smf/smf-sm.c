@@ -67,7 +67,9 @@ void smf_state_operational(ogs_fsm_t *s, smf_event_t *e)
 
     ogs_pfcp_node_t *pfcp_node = NULL;
     ogs_pfcp_xact_t *pfcp_xact = NULL;
+    ogs_pfcp_header_t *pfcp_h = NULL;
     ogs_pfcp_message_t *pfcp_message = NULL;
+    ogs_pfcp_index_message_t *pfcp_index_message = NULL;
 
     ogs_sbi_stream_t *stream = NULL;
     ogs_sbi_request_t *sbi_request = NULL;
@@ -399,26 +401,51 @@ void smf_state_operational(ogs_fsm_t *s, smf_event_t *e)
         ogs_assert(OGS_FSM_STATE(&pfcp_node->sm));
 
         /*
-         * Issue #1911
+         * Session Establishment/Modification Response are indexed only,
+         * and the handlers decode the IEs they need.
          *
-         * Because ogs_pfcp_message_t is over 80kb in size,
-         * it can cause stack overflow.
-         * To avoid this, the pfcp_message structure uses heap memory.
+         * Anything shorter than a session header is left to
+         * ogs_pfcp_parse_msg(), which validates it.
          */
-        if ((pfcp_message = ogs_pfcp_parse_msg(recvbuf)) == NULL) {
-            ogs_error("ogs_pfcp_parse_msg() failed");
-            ogs_pkbuf_free(recvbuf);
-            break;
+        pfcp_h = (ogs_pfcp_header_t *)recvbuf->data;
+        if (recvbuf->len >= OGS_PFCP_HEADER_LEN &&
+            (pfcp_h->type == OGS_PFCP_SESSION_ESTABLISHMENT_RESPONSE_TYPE ||
+             pfcp_h->type == OGS_PFCP_SESSION_MODIFICATION_RESPONSE_TYPE)) {
+            pfcp_index_message = ogs_pfcp_index_msg(recvbuf);
+            if (!pfcp_index_message) {
+                ogs_error("ogs_pfcp_index_msg() failed");
+                ogs_pkbuf_free(recvbuf);
+                break;
+            }
+            pfcp_h = &pfcp_index_message->h;
+        } else {
+            /*
+             * Issue #1911
+             *
+             * Because ogs_pfcp_message_t is over 80kb in size,
+             * it can cause stack overflow.
+             * To avoid this, the pfcp_message structure uses heap memory.
+             */
+            if ((pfcp_message = ogs_pfcp_parse_msg(recvbuf)) == NULL) {
+                ogs_error("ogs_pfcp_parse_msg() failed");
+                ogs_pkbuf_free(recvbuf);
+                break;
+            }
+            pfcp_h = &pfcp_message->h;
         }
 
-        rv = ogs_pfcp_xact_receive(pfcp_node, &pfcp_message->h, &pfcp_xact);
+        rv = ogs_pfcp_xact_receive(pfcp_node, pfcp_h, &pfcp_xact);
         if (rv != OGS_OK) {
             ogs_pkbuf_free(recvbuf);
-            ogs_pfcp_message_free(pfcp_message);
+            if (pfcp_message)
+                ogs_pfcp_message_free(pfcp_message);
+            if (pfcp_index_message)
+                ogs_pfcp_index_message_free(pfcp_index_message);
             break;
         }
 
         e->pfcp_message = pfcp_message;
+        e->pfcp_index_message = pfcp_index_message;
         e->pfcp_xact = pfcp_xact;
 
         e->gtp2_message = NULL;
@@ -433,7 +460,10 @@ void smf_state_operational(ogs_fsm_t *s, smf_event_t *e)
         }
 
         ogs_pkbuf_free(recvbuf);
-        ogs_pfcp_message_free(pfcp_message);
+        if (pfcp_message)
+            ogs_pfcp_message_free(pfcp_message);
+        if (pfcp_index_message)
+            ogs_pfcp_index_message_free(pfcp_index_message);
         break;
     case SMF_EVT_N4_TIMER:
     case SMF_EVT_N4_NO_HEARTBEAT:
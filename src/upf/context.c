@@ -19,6 +19,7 @@
 
 #include "context.h"
 #include "pfcp-path.h"
+#include "worker.h"
 
 static upf_context_t self;
 
@@ -59,23 +60,14 @@ void upf_context_init(void)
     ogs_assert(self.smf_n4_seid_hash);
     self.smf_n4_f_seid_hash = ogs_hash_make();
     ogs_assert(self.smf_n4_f_seid_hash);
-    self.ipv4_hash = ogs_hash_make();
-    ogs_assert(self.ipv4_hash);
-    self.ipv6_hash = ogs_hash_make();
-    ogs_assert(self.ipv6_hash);
+    self.ipv4_lpm = ogs_lpm_create(OGS_IPV4_LEN << 3);
+    ogs_assert(self.ipv4_lpm);
+    self.ipv6_lpm = ogs_lpm_create(OGS_IPV6_LEN << 3);
+    ogs_assert(self.ipv6_lpm);
 
     context_initialized = 1;
 }
 
-static void free_upf_route_trie_node(struct upf_route_trie_node *node)
-{
-    if (!node)
-        return;
-    free_upf_route_trie_node(node->left);
-    free_upf_route_trie_node(node->right);
-    ogs_free(node);
-}
-
 void upf_context_final(void)
 {
     ogs_assert(context_initialized == 1);
@@ -88,13 +80,10 @@ void upf_context_final(void)
     ogs_hash_destroy(self.smf_n4_seid_hash);
     ogs_assert(self.smf_n4_f_seid_hash);
     ogs_hash_destroy(self.smf_n4_f_seid_hash);
-    ogs_assert(self.ipv4_hash);
-    ogs_hash_destroy(self.ipv4_hash);
-    ogs_assert(self.ipv6_hash);
-    ogs_hash_destroy(self.ipv6_hash);
-
-    free_upf_route_trie_node(self.ipv4_framed_routes);
-    free_upf_route_trie_node(self.ipv6_framed_routes);
+    ogs_assert(self.ipv4_lpm);
+    ogs_lpm_destroy(self.ipv4_lpm);
+    ogs_assert(self.ipv6_lpm);
+    ogs_lpm_destroy(self.ipv6_lpm);
 
     ogs_pool_final(&upf_sess_pool);
     ogs_pool_final(&upf_n4_seid_pool);
@@ -157,6 +146,17 @@ int upf_context_parse_config(void)
                     /* handle config in pfcp library */
                 } else if (!strcmp(upf_key, "metrics")) {
                     /* handle config in metrics library */
+                } else if (!strcmp(upf_key, "worker")) {
+                    const char *v = ogs_yaml_iter_value(&upf_iter);
+                    if (v) self.num_of_worker = atoi(v);
+                    if (self.num_of_worker < 0 ||
+                        self.num_of_worker > UPF_MAX_NUM_OF_WORKER) {
+                        ogs_error("upf.worker must be in 0..%d [%d]",
+                                UPF_MAX_NUM_OF_WORKER, self.num_of_worker);
+                        return OGS_ERROR;
+                    }
+                } else if (!strcmp(upf_key, "tun_offload")) {
+                    self.tun_offload = ogs_yaml_iter_bool(&upf_iter);
                 } else
                     ogs_warn("unknown key `%s`", upf_key);
             }
@@ -169,6 +169,42 @@ int upf_context_parse_config(void)
     return OGS_OK;
 }
 
+/*
+ * UE addresses and framed routes share one longest prefix match table
+ * per family. An entry is removed only by the session that owns it,
+ * so a session going away never hides the route of another one.
+ */
+static void lpm_remove_sess(ogs_lpm_t *lpm,
+        const void *addr, int prefixlen, upf_sess_t *sess)
+{
+    if (ogs_lpm_get(lpm, addr, prefixlen) == sess)
+        ogs_assert(OGS_OK == ogs_lpm_remove(lpm, addr, prefixlen));
+}
+
+static void ue_ipv4_add(upf_sess_t *sess)
+{
+    ogs_assert(OGS_OK == ogs_lpm_add(self.ipv4_lpm,
+                sess->ipv4->addr, OGS_IPV4_LEN << 3, sess));
+}
+
+static void ue_ipv4_remove(upf_sess_t *sess)
+{
+    lpm_remove_sess(self.ipv4_lpm,
+            sess->ipv4->addr, OGS_IPV4_LEN << 3, sess);
+}
+
+static void ue_ipv6_add(upf_sess_t *sess)
+{
+    ogs_assert(OGS_OK == ogs_lpm_add(self.ipv6_lpm,
+                sess->ipv6->addr, OGS_IPV6_DEFAULT_PREFIX_LEN, sess));
+}
+
+static void ue_ipv6_remove(upf_sess_t *sess)
+{
+    lpm_remove_sess(self.ipv6_lpm,
+            sess->ipv6->addr, OGS_IPV6_DEFAULT_PREFIX_LEN, sess);
+}
+
 upf_sess_t *upf_sess_add(ogs_pfcp_f_seid_t *cp_f_seid)
 {
     upf_sess_t *sess = NULL;
@@ -181,6 +217,8 @@ upf_sess_t *upf_sess_add(ogs_pfcp_f_seid_t *cp_f_seid)
 
     ogs_pfcp_pool_init(&sess->pfcp);
 
+    ogs_thread_mutex_init(&sess->dp_mutex);
+
     /* Set UPF-N4-SEID */
     ogs_pool_alloc(&upf_n4_seid_pool, &sess->upf_n4_seid_node);
     ogs_assert(sess->upf_n4_seid_node);
@@ -229,12 +267,11 @@ int upf_sess_remove(upf_sess_t *sess)
             sizeof(sess->smf_n4_f_seid), NULL);
 
     if (sess->ipv4) {
-        ogs_hash_set(self.ipv4_hash, sess->ipv4->addr, OGS_IPV4_LEN, NULL);
+        ue_ipv4_remove(sess);
         ogs_pfcp_ue_ip_free(sess->ipv4);
     }
     if (sess->ipv6) {
-        ogs_hash_set(self.ipv6_hash,
-                sess->ipv6->addr, OGS_IPV6_DEFAULT_PREFIX_LEN >> 3, NULL);
+        ue_ipv6_remove(sess);
         ogs_pfcp_ue_ip_free(sess->ipv6);
     }
 
@@ -243,6 +280,8 @@ int upf_sess_remove(upf_sess_t *sess)
 
     ogs_pfcp_pool_final(&sess->pfcp);
 
+    ogs_thread_mutex_destroy(&sess->dp_mutex);
+
     ogs_pool_free(&upf_n4_seid_pool, sess->upf_n4_seid_node);
     ogs_pool_free(&upf_sess_pool, sess);
     if (sess->apn_dnn)
@@ -290,78 +329,33 @@ upf_sess_t *upf_sess_find_by_upf_n4_seid(uint64_t seid)
 
 upf_sess_t *upf_sess_find_by_ipv4(uint32_t addr)
 {
-    upf_sess_t *ret;
-    struct upf_route_trie_node *trie = self.ipv4_framed_routes;
-    const int nbits = sizeof(addr) << 3;
-    int i;
-
-    ogs_assert(self.ipv4_hash);
-
-    ret = ogs_hash_get(self.ipv4_hash, &addr, OGS_IPV4_LEN);
-    if (ret)
-        return ret;
-
-    for (i =  0; i <= nbits; i++) {
-        int bit = nbits - i - 1;
-
-        if (!trie)
-            break;
-        if (trie->sess)
-            ret = trie->sess;
-        if (i == nbits)
-            break;
-
-        if ((1 << bit) & be32toh(addr))
-            trie = trie->right;
-        else
-            trie = trie->left;
-    }
-    return ret;
+    ogs_assert(self.ipv4_lpm);
+    return ogs_lpm_find(self.ipv4_lpm, &addr);
 }
 
 upf_sess_t *upf_sess_find_by_ipv6(uint32_t *addr6)
 {
-    upf_sess_t *ret = NULL;
-    struct upf_route_trie_node *trie = self.ipv6_framed_routes;
-    int i;
-    const int chunk_size = sizeof(*addr6) << 3;
-
-    ogs_assert(self.ipv6_hash);
+    ogs_assert(self.ipv6_lpm);
     ogs_assert(addr6);
-    ret = ogs_hash_get(
-            self.ipv6_hash, addr6, OGS_IPV6_DEFAULT_PREFIX_LEN >> 3);
-    if (ret)
-        return ret;
-
-    for (i = 0; i <= OGS_IPV6_128_PREFIX_LEN; i++) {
-        int part = i / chunk_size;
-        int bit = (OGS_IPV6_128_PREFIX_LEN - i - 1) % chunk_size;
-
-        if (!trie)
-            break;
-        if (trie->sess)
-            ret = trie->sess;
-        if (i == OGS_IPV6_128_PREFIX_LEN)
-            break;
-
-        if ((1 << bit) & be32toh(addr6[part]))
-            trie = trie->right;
-        else
-            trie = trie->left;
-    }
-    return ret;
+    return ogs_lpm_find(self.ipv6_lpm, addr6);
 }
 
-upf_sess_t *upf_sess_add_by_message(ogs_pfcp_message_t *message)
+upf_sess_t *upf_sess_add_by_message(ogs_pfcp_index_message_t *req)
 {
     upf_sess_t *sess = NULL;
     ogs_pfcp_f_seid_t *f_seid = NULL;
+    ogs_pfcp_tlv_f_seid_t cp_f_seid;
+
+    ogs_assert(req);
 
-    ogs_pfcp_session_establishment_request_t *req =
-        &message->pfcp_session_establishment_request;;
+    if (ogs_pfcp_parse_ie(&cp_f_seid,
+                &ogs_pfcp_tlv_desc_f_seid, req, 0) == OGS_ERROR) {
+        ogs_error("Invalid CP F-SEID");
+        return NULL;
+    }
 
-    f_seid = req->cp_f_seid.data;
-    if (req->cp_f_seid.presence == 0 || f_seid == NULL) {
+    f_seid = cp_f_seid.data;
+    if (cp_f_seid.presence == 0 || f_seid == NULL) {
         ogs_error("No CP F-SEID");
         return NULL;
     }
@@ -401,13 +395,11 @@ uint8_t upf_sess_set_ue_ip(upf_sess_t *sess,
     ogs_assert(ue_ip);
 
     if (sess->ipv4) {
-        ogs_hash_set(self.ipv4_hash,
-                sess->ipv4->addr, OGS_IPV4_LEN, NULL);
+        ue_ipv4_remove(sess);
         ogs_pfcp_ue_ip_free(sess->ipv4);
     }
     if (sess->ipv6) {
-        ogs_hash_set(self.ipv6_hash,
-                sess->ipv6->addr, OGS_IPV6_DEFAULT_PREFIX_LEN >> 3, NULL);
+        ue_ipv6_remove(sess);
         ogs_pfcp_ue_ip_free(sess->ipv6);
     }
 
@@ -421,7 +413,7 @@ uint8_t upf_sess_set_ue_ip(upf_sess_t *sess,
                 ogs_assert(cause_value != OGS_PFCP_CAUSE_REQUEST_ACCEPTED);
                 return cause_value;
             }
-            ogs_hash_set(self.ipv4_hash, sess->ipv4->addr, OGS_IPV4_LEN, sess);
+            ue_ipv4_add(sess);
         } else {
             ogs_warn("Cannot support PDN-Type[%d], [IPv4:%d IPv6:%d DNN:%s]",
                 session_type, ue_ip->ipv4, ue_ip->ipv6,
@@ -436,8 +428,7 @@ uint8_t upf_sess_set_ue_ip(upf_sess_t *sess,
                 ogs_assert(cause_value != OGS_PFCP_CAUSE_REQUEST_ACCEPTED);
                 return cause_value;
             }
-            ogs_hash_set(self.ipv6_hash, sess->ipv6->addr,
-                    OGS_IPV6_DEFAULT_PREFIX_LEN >> 3, sess);
+            ue_ipv6_add(sess);
         } else {
             ogs_warn("Cannot support PDN-Type[%d], [IPv4:%d IPv6:%d DNN:%s]",
                 session_type, ue_ip->ipv4, ue_ip->ipv6,
@@ -452,7 +443,7 @@ uint8_t upf_sess_set_ue_ip(upf_sess_t *sess,
                 ogs_assert(cause_value != OGS_PFCP_CAUSE_REQUEST_ACCEPTED);
                 return cause_value;
             }
-            ogs_hash_set(self.ipv4_hash, sess->ipv4->addr, OGS_IPV4_LEN, sess);
+            ue_ipv4_add(sess);
         } else {
             ogs_warn("Cannot support PDN-Type[%d], [IPv4:%d IPv6:%d DNN:%s]",
                 session_type, ue_ip->ipv4, ue_ip->ipv6,
@@ -466,15 +457,13 @@ uint8_t upf_sess_set_ue_ip(upf_sess_t *sess,
                 ogs_error("ogs_pfcp_ue_ip_alloc() failed[%d]", cause_value);
                 ogs_assert(cause_value != OGS_PFCP_CAUSE_REQUEST_ACCEPTED);
                 if (sess->ipv4) {
-                    ogs_hash_set(self.ipv4_hash,
-                            sess->ipv4->addr, OGS_IPV4_LEN, NULL);
+                    ue_ipv4_remove(sess);
                     ogs_pfcp_ue_ip_free(sess->ipv4);
                     sess->ipv4 = NULL;
                 }
                 return cause_value;
             }
-            ogs_hash_set(self.ipv6_hash, sess->ipv6->addr,
-                    OGS_IPV6_DEFAULT_PREFIX_LEN >> 3, sess);
+            ue_ipv6_add(sess);
         } else {
             ogs_warn("Cannot support PDN-Type[%d], [IPv4:%d IPv6:%d DNN:%s]",
                 session_type, ue_ip->ipv4, ue_ip->ipv6,
@@ -496,83 +485,36 @@ uint8_t upf_sess_set_ue_ip(upf_sess_t *sess,
     return cause_value;
 }
 
-/* Remove amd free framed ROUTE from TRIE. It isn't an error if the framed
-   route doesn't exist in TRIE. */
-static void free_framed_route_from_trie(ogs_ipsubnet_t *route)
+static int framed_route_prefixlen(ogs_ipsubnet_t *route)
 {
-    const int chunk_size = sizeof(route->sub[0]) << 3;
-    const int is_ipv4 = route->family == AF_INET;
-    const int nbits = is_ipv4 ? chunk_size : OGS_IPV6_128_PREFIX_LEN;
-    struct upf_route_trie_node **trie =
-        is_ipv4 ? &self.ipv4_framed_routes : &self.ipv6_framed_routes;
-
-    struct upf_route_trie_node **to_free_tries[OGS_IPV6_128_PREFIX_LEN + 1];
-    int free_from = 0;
-    int i = 0;
-
-    for (i = 0; i <= nbits; i++) {
-        int part = i / chunk_size;
-        int bit = (nbits - i - 1) % chunk_size;
+    int n = route->family == AF_INET ? 1 : 4;
+    int i, prefixlen = 0;
 
-        if (!*trie)
-            break;
-        to_free_tries[i] = trie;
-
-        if (i == nbits ||
-            ((1 << bit) & be32toh(route->mask[part])) == 0) {
-            (*trie)->sess = NULL;
-            if ((*trie)->left || (*trie)->right)
-                free_from = i + 1;
-            i++;
-            break;
-        }
+    for (i = 0; i < n; i++) {
+        uint32_t mask = be32toh(route->mask[i]);
 
-        if ((1 << bit) & be32toh(route->sub[part])) {
-            if ((*trie)->left || (*trie)->sess)
-                free_from = i + 1;
-            trie = &(*trie)->right;
-        } else {
-            if ((*trie)->right || (*trie)->sess)
-                free_from = i + 1;
-            trie = &(*trie)->left;
+        while (mask & 0x80000000) {
+            prefixlen++;
+            mask <<= 1;
         }
     }
 
-    for (i = i - 1; i >= free_from; i--) {
-        trie = to_free_tries[i];
-        ogs_free(*trie);
-        *trie = NULL;
-    }
+    return prefixlen;
 }
 
-static void add_framed_route_to_trie(ogs_ipsubnet_t *route, upf_sess_t *sess)
+/* It isn't an error if the framed route doesn't exist */
+static void framed_route_remove(ogs_ipsubnet_t *route, upf_sess_t *sess)
 {
-    const int chunk_size = sizeof(route->sub[0]) << 3;
-    const int is_ipv4 = route->family == AF_INET;
-    const int nbits = is_ipv4 ? chunk_size : OGS_IPV6_128_PREFIX_LEN;
-    struct upf_route_trie_node **trie =
-        is_ipv4 ? &self.ipv4_framed_routes : &self.ipv6_framed_routes;
-    int i = 0;
-
-    for (i = 0; i <= nbits; i++) {
-        int part = i / chunk_size;
-        int bit = (nbits - i - 1) % chunk_size;
-
-        if (!*trie)
-            *trie = ogs_calloc(1, sizeof(**trie));
-
-        if (i == nbits ||
-            ((1 << bit) & be32toh(route->mask[part])) == 0) {
-            (*trie)->sess = sess;
-            break;
-        }
+    lpm_remove_sess(
+        route->family == AF_INET ? self.ipv4_lpm : self.ipv6_lpm,
+        route->sub, framed_route_prefixlen(route), sess);
+}
 
-        if ((1 << bit) & be32toh(route->sub[part])) {
-            trie = &(*trie)->right;
-        } else {
-            trie = &(*trie)->left;
-        }
-    }
+static void framed_route_add(ogs_ipsubnet_t *route, upf_sess_t *sess)
+{
+    ogs_assert(OGS_OK == ogs_lpm_add(
+        route->family == AF_INET ? self.ipv4_lpm : self.ipv6_lpm,
+        route->sub, framed_route_prefixlen(route), sess));
 }
 
 static int parse_framed_route(ogs_ipsubnet_t *subnet, const char *framed_route)
@@ -597,7 +539,7 @@ uint8_t upf_sess_set_ue_ipv4_framed_routes(upf_sess_t *sess,
     for (i = 0; i < OGS_MAX_NUM_OF_FRAMED_ROUTES_IN_PDI; i++) {
         if (!sess->ipv4_framed_routes || !sess->ipv4_framed_routes[i].family)
             break;
-        free_framed_route_from_trie(&sess->ipv4_framed_routes[i]);
+        framed_route_remove(&sess->ipv4_framed_routes[i], sess);
         memset(&sess->ipv4_framed_routes[i], 0,
                sizeof(sess->ipv4_framed_routes[i]));
     }
@@ -620,7 +562,7 @@ uint8_t upf_sess_set_ue_ipv4_framed_routes(upf_sess_t *sess,
                    sizeof(sess->ipv4_framed_routes[j]));
             continue;
         }
-        add_framed_route_to_trie(&sess->ipv4_framed_routes[j], sess);
+        framed_route_add(&sess->ipv4_framed_routes[j], sess);
         j++;
     }
     if (j == 0 && sess->ipv4_framed_routes) {
@@ -642,7 +584,7 @@ uint8_t upf_sess_set_ue_ipv6_framed_routes(upf_sess_t *sess,
     for (i = 0; i < OGS_MAX_NUM_OF_FRAMED_ROUTES_IN_PDI; i++) {
         if (!sess->ipv6_framed_routes || !sess->ipv6_framed_routes[i].family)
             break;
-        free_framed_route_from_trie(&sess->ipv6_framed_routes[i]);
+        framed_route_remove(&sess->ipv6_framed_routes[i], sess);
     }
 
     for (i = 0, j = 0; i < OGS_MAX_NUM_OF_FRAMED_ROUTES_IN_PDI; i++) {
@@ -663,7 +605,7 @@ uint8_t upf_sess_set_ue_ipv6_framed_routes(upf_sess_t *sess,
                    sizeof(sess->ipv6_framed_routes[j]));
             continue;
         }
-        add_framed_route_to_trie(&sess->ipv6_framed_routes[j], sess);
+        framed_route_add(&sess->ipv6_framed_routes[j], sess);
         j++;
     }
     if (j == 0 && sess->ipv6_framed_routes) {
@@ -674,10 +616,99 @@ uint8_t upf_sess_set_ue_ipv6_framed_routes(upf_sess_t *sess,
     return cause_value;
 }
 
+static bool urr_acc_threshold_reached(
+        upf_sess_urr_acc_t *urr_acc, ogs_pfcp_urr_t *urr)
+{
+    uint64_t vol = urr_acc->total_octets - urr_acc->last_report.total_octets;
+
+    return (urr->rep_triggers.volume_quota && urr->vol_quota.tovol &&
+                vol >= urr->vol_quota.total_volume) ||
+           (urr->rep_triggers.volume_threshold && urr->vol_threshold.tovol &&
+                vol >= urr->vol_threshold.total_volume);
+}
+
+/*
+ * (sess, urr) pairs touched by the current receive batch.
+ * Sessions cannot be removed in the middle of a batch:
+ * PFCP is handled by the main thread between batches,
+ * and while it does, every worker is blocked on its own mutex.
+ */
+#define URR_ACC_MAX_PENDING 64
+
+static OGS_THREAD_LOCAL struct {
+    upf_sess_t *sess;
+    ogs_pfcp_urr_t *urr;
+} urr_acc_pending[URR_ACC_MAX_PENDING];
+static OGS_THREAD_LOCAL int num_of_urr_acc_pending = 0;
+static OGS_THREAD_LOCAL bool urr_acc_in_batch = false;
+
+/*
+ * Packet timestamps of the current poll iteration.
+ * The clocks are read by the first packet after the poll loop wakes up.
+ */
+static OGS_THREAD_LOCAL ogs_time_t urr_acc_now = 0;
+static OGS_THREAD_LOCAL ogs_time_t qer_now = 0;
+
+/* The caller holds the session lock */
+static void urr_acc_check(upf_sess_t *sess, ogs_pfcp_urr_t *urr)
+{
+    upf_sess_urr_acc_t *urr_acc = &sess->urr_acc[urr->id];
+
+    urr_acc->check_pending = false;
+
+    /* Workers cannot send PFCP, the main thread will check it again */
+    if (upf_worker_self()) {
+        if (!urr_acc->threshold_pending &&
+            urr_acc_threshold_reached(urr_acc, urr)) {
+            urr_acc->threshold_pending = true;
+            upf_worker_defer_urr_threshold(sess, urr);
+        }
+        return;
+    }
+
+    upf_sess_urr_acc_check_threshold(sess, urr);
+}
+
+void upf_sess_dp_clock_reset(void)
+{
+    urr_acc_now = 0;
+    qer_now = 0;
+}
+
+ogs_time_t upf_sess_qer_clock(void)
+{
+    if (!qer_now)
+        qer_now = ogs_get_monotonic_time();
+
+    return qer_now;
+}
+
+void upf_sess_urr_acc_batch_begin(void)
+{
+    if (!urr_acc_now)
+        urr_acc_now = ogs_time_now();
+    urr_acc_in_batch = true;
+}
+
+void upf_sess_urr_acc_batch_end(void)
+{
+    int i;
+
+    for (i = 0; i < num_of_urr_acc_pending; i++) {
+        upf_sess_t *sess = urr_acc_pending[i].sess;
+
+        upf_sess_dp_lock(sess);
+        urr_acc_check(sess, urr_acc_pending[i].urr);
+        upf_sess_dp_unlock(sess);
+    }
+
+    num_of_urr_acc_pending = 0;
+    urr_acc_in_batch = false;
+}
+
 void upf_sess_urr_acc_add(upf_sess_t *sess, ogs_pfcp_urr_t *urr, size_t size, bool is_uplink)
 {
     upf_sess_urr_acc_t *urr_acc = &sess->urr_acc[urr->id];
-    uint64_t vol;
 
     /* Increment total & ul octets + pkts */
     urr_acc->total_octets += size;
@@ -690,14 +721,35 @@ void upf_sess_urr_acc_add(upf_sess_t *sess, ogs_pfcp_urr_t *urr, size_t size, bo
         urr_acc->dl_pkts++;
     }
 
-    urr_acc->time_of_last_packet = ogs_time_now();
+    ogs_assert(urr_acc_now);
+    urr_acc->time_of_last_packet = urr_acc_now;
     if (urr_acc->time_of_first_packet == 0)
         urr_acc->time_of_first_packet = urr_acc->time_of_last_packet;
 
+    if (urr_acc->check_pending)
+        return;
+
+    /* Outside of a batch or out of room, check it right away */
+    if (!urr_acc_in_batch ||
+        num_of_urr_acc_pending == URR_ACC_MAX_PENDING) {
+        urr_acc_check(sess, urr);
+        return;
+    }
+
+    urr_acc->check_pending = true;
+    urr_acc_pending[num_of_urr_acc_pending].sess = sess;
+    urr_acc_pending[num_of_urr_acc_pending].urr = urr;
+    num_of_urr_acc_pending++;
+}
+
+void upf_sess_urr_acc_check_threshold(upf_sess_t *sess, ogs_pfcp_urr_t *urr)
+{
+    upf_sess_urr_acc_t *urr_acc = &sess->urr_acc[urr->id];
+
+    urr_acc->threshold_pending = false;
+
     /* generate report if volume threshold/quota is reached */
-    vol = urr_acc->total_octets - urr_acc->last_report.total_octets;
-    if ((urr->rep_triggers.volume_quota && urr->vol_quota.tovol && vol >= urr->vol_quota.total_volume) ||
-        (urr->rep_triggers.volume_threshold && urr->vol_threshold.tovol && vol >= urr->vol_threshold.total_volume)) {
+    if (urr_acc_threshold_reached(urr_acc, urr)) {
         ogs_pfcp_user_plane_report_t report;
         memset(&report, 0, sizeof(report));
         upf_sess_urr_acc_fill_usage_report(sess, urr, &report, 0);
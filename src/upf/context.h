@@ -45,38 +45,27 @@ extern int __upf_log_domain;
 #undef OGS_LOG_DOMAIN
 #define OGS_LOG_DOMAIN __upf_log_domain
 
-struct upf_route_trie_node;
+#define UPF_MAX_NUM_OF_WORKER 64
 
 typedef struct upf_context_s {
     ogs_hash_t *upf_n4_seid_hash;   /* hash table (UPF-N4-SEID) */
     ogs_hash_t *smf_n4_seid_hash;   /* hash table (SMF-N4-SEID) */
     ogs_hash_t *smf_n4_f_seid_hash; /* hash table (SMF-N4-F-SEID) */
-    ogs_hash_t *ipv4_hash;  /* hash table (IPv4 Address) */
-    ogs_hash_t *ipv6_hash;  /* hash table (IPv6 Address) */
 
-    /* IPv4 framed routes trie */
-    struct upf_route_trie_node *ipv4_framed_routes;
-    /* IPv6 framed routes trie */
-    struct upf_route_trie_node *ipv6_framed_routes;
+    /* UE IPv4 address(/32) and IPv4 framed routes */
+    ogs_lpm_t *ipv4_lpm;
+    /* UE IPv6 prefix(/64) and IPv6 framed routes */
+    ogs_lpm_t *ipv6_lpm;
 
     ogs_list_t sess_list;
-} upf_context_t;
 
-/* trie mapping from IP framed routes to session. */
-struct upf_route_trie_node {
-    struct upf_route_trie_node *left;
-    struct upf_route_trie_node *right;
-    upf_sess_t *sess;
-};
+    int num_of_worker;      /* Data plane worker threads, 0 to disable */
+    bool tun_offload;       /* TUN GSO/GRO with IFF_VNET_HDR */
+} upf_context_t;
 
 /* Accounting: */
 typedef struct upf_sess_urr_acc_s {
-    bool reporting_enabled;
-    ogs_timer_t *t_validity_time; /* Quota Validity Time expiration handler */
-    ogs_timer_t *t_time_quota; /* Time Quota expiration handler */
-    ogs_timer_t *t_time_threshold; /* Time Threshold expiration handler */
-    uint32_t time_start; /* When t_time_* started */
-    ogs_pfcp_urr_ur_seqn_t report_seqn; /* Next seqn to use when reporting */
+    /* Updated per packet, kept together at the head */
     uint64_t total_octets;
     uint64_t ul_octets;
     uint64_t dl_octets;
@@ -85,6 +74,15 @@ typedef struct upf_sess_urr_acc_s {
     uint64_t dl_pkts;
     ogs_time_t time_of_first_packet;
     ogs_time_t time_of_last_packet;
+    bool check_pending; /* Queued for the end-of-batch threshold check */
+    bool threshold_pending; /* Threshold report deferred by a worker */
+
+    bool reporting_enabled;
+    ogs_timer_t *t_validity_time; /* Quota Validity Time expiration handler */
+    ogs_timer_t *t_time_quota; /* Time Quota expiration handler */
+    ogs_timer_t *t_time_threshold; /* Time Threshold expiration handler */
+    uint32_t time_start; /* When t_time_* started */
+    ogs_pfcp_urr_ur_seqn_t report_seqn; /* Next seqn to use when reporting */
     /* Snapshot of measurement when last report was sent: */
     struct {
         uint64_t total_octets;
@@ -123,6 +121,9 @@ typedef struct upf_sess_s {
     /* Accounting: */
     upf_sess_urr_acc_t urr_acc[OGS_MAX_NUM_OF_URR]; /* FIXME: This probably needs to be mved to a hashtable or alike */
     char            *apn_dnn;            /* APN/DNN Item */
+
+    /* Serializes data plane workers handling the same session */
+    ogs_thread_mutex_t dp_mutex;
 } upf_sess_t;
 
 void upf_context_init(void);
@@ -131,7 +132,7 @@ upf_context_t *upf_self(void);
 
 int upf_context_parse_config(void);
 
-upf_sess_t *upf_sess_add_by_message(ogs_pfcp_message_t *message);
+upf_sess_t *upf_sess_add_by_message(ogs_pfcp_index_message_t *req);
 
 upf_sess_t *upf_sess_add(ogs_pfcp_f_seid_t *f_seid);
 int upf_sess_remove(upf_sess_t *sess);
@@ -149,7 +150,22 @@ uint8_t upf_sess_set_ue_ipv4_framed_routes(upf_sess_t *sess,
 uint8_t upf_sess_set_ue_ipv6_framed_routes(upf_sess_t *sess,
         char *framed_routes[]);
 
+/*
+ * Per-packet accounting runs between upf_sess_urr_acc_batch_begin()
+ * and upf_sess_urr_acc_batch_end(). It only updates the counters, using
+ * a clock sampled once per poll iteration. Volume thresholds and quotas
+ * are checked at the end of the batch.
+ *
+ * Every thread polling GTP-U sockets calls upf_sess_dp_clock_reset()
+ * before ogs_pollset_poll(). QER policing uses the monotonic clock of
+ * upf_sess_qer_clock(), sampled the same way.
+ */
+void upf_sess_dp_clock_reset(void);
+ogs_time_t upf_sess_qer_clock(void);
+void upf_sess_urr_acc_batch_begin(void);
+void upf_sess_urr_acc_batch_end(void);
 void upf_sess_urr_acc_add(upf_sess_t *sess, ogs_pfcp_urr_t *urr, size_t size, bool is_uplink);
+void upf_sess_urr_acc_check_threshold(upf_sess_t *sess, ogs_pfcp_urr_t *urr);
 void upf_sess_urr_acc_fill_usage_report(upf_sess_t *sess, const ogs_pfcp_urr_t *urr,
                                         ogs_pfcp_user_plane_report_t *report, unsigned int idx);
 void upf_sess_urr_acc_snapshot(upf_sess_t *sess, ogs_pfcp_urr_t *urr);
@@ -29,6 +29,7 @@ extern "C" {
 typedef struct ogs_pfcp_node_s ogs_pfcp_node_t;
 typedef struct ogs_pfcp_xact_s ogs_pfcp_xact_t;
 typedef struct ogs_pfcp_message_s ogs_pfcp_message_t;
+typedef struct ogs_pfcp_index_message_s ogs_pfcp_index_message_t;
 typedef struct upf_sess_s upf_sess_t;
 
 typedef enum {
@@ -51,6 +52,7 @@ typedef struct upf_event_s {
     ogs_pfcp_node_t *pfcp_node;
     ogs_pfcp_xact_t *pfcp_xact;
     ogs_pfcp_message_t *pfcp_message;
+    ogs_pfcp_index_message_t *pfcp_index_message;
 } upf_event_t;
 
 OGS_STATIC_ASSERT(OGS_EVENT_SIZE >= sizeof(upf_event_t));
@@ -52,6 +52,7 @@
 #include "gtp-path.h"
 #include "pfcp-path.h"
 #include "rule-match.h"
+#include "worker.h"
 
 #define UPF_GTP_HANDLED     1
 
@@ -59,6 +60,16 @@ const uint8_t proxy_mac_addr[] = { 0x0e, 0x00, 0x00, 0x00, 0x00, 0x01 };
 
 static ogs_pkbuf_pool_t *packet_pool = NULL;
 
+/* Uplink TCP segments to coalesce before writing to TUN, per thread */
+static OGS_THREAD_LOCAL ogs_tun_gro_t tun_gro;
+
+static void upf_gtp_tun_flush(void)
+{
+    if (ogs_tun_gro_flush(&tun_gro) != OGS_OK)
+        ogs_warn("ogs_tun_gro_flush() failed");
+}
+
+/* recvbuf is consumed */
 static void upf_gtp_handle_multicast(ogs_pkbuf_t *recvbuf);
 
 static int check_framed_routes(upf_sess_t *sess, int family, uint32_t *addr)
@@ -99,23 +110,20 @@ static uint16_t _get_eth_type(uint8_t *data, uint len) {
     return 0;
 }
 
-static void _gtpv1_tun_recv_common_cb(
-        short when, ogs_socket_t fd, bool has_eth, void *data)
+/* recvbuf is consumed */
+static void _gtpv1_tun_handle_pkbuf(
+        ogs_socket_t fd, bool has_eth, ogs_pkbuf_t *recvbuf)
 {
-    ogs_pkbuf_t *recvbuf = NULL;
-
     upf_sess_t *sess = NULL;
     ogs_pfcp_pdr_t *pdr = NULL;
     ogs_pfcp_pdr_t *fallback_pdr = NULL;
     ogs_pfcp_far_t *far = NULL;
+    ogs_pfcp_packet_key_t key;
+    ogs_pfcp_pdr_match_t match;
     ogs_pfcp_user_plane_report_t report;
-    int i;
+    int i, pos;
 
-    recvbuf = ogs_tun_read(fd, packet_pool);
-    if (!recvbuf) {
-        ogs_warn("ogs_tun_read() failed");
-        return;
-    }
+    ogs_assert(recvbuf);
 
     if (has_eth) {
         ogs_pkbuf_t *replybuf = NULL;
@@ -167,16 +175,17 @@ static void _gtpv1_tun_recv_common_cb(
     if (!sess)
         goto cleanup;
 
-    ogs_list_for_each(&sess->pfcp.pdr_list, pdr) {
-        far = pdr->far;
-        ogs_assert(far);
+    ogs_pfcp_packet_key_init(&key, recvbuf);
 
-        /* Check if PDR is Downlink */
-        if (pdr->src_if != OGS_PFCP_INTERFACE_CORE)
-            continue;
+    /* Downlink PDRs whose SDF filters match, in precedence order */
+    memset(&match, 0, sizeof(match));
+    match.src_if = OGS_PFCP_PDR_MATCH_IF(OGS_PFCP_INTERFACE_CORE);
 
-        /* Save the Fallback PDR : Lowest precedence downlink PDR */
-        fallback_pdr = pdr;
+    pos = 0;
+    while ((pdr = ogs_pfcp_sess_pdr_find_by_key(
+                    &sess->pfcp, &match, &key, &pos))) {
+        far = pdr->far;
+        ogs_assert(far);
 
         /* Check if FAR is Downlink */
         if (far->dst_if != OGS_PFCP_INTERFACE_ACCESS)
@@ -191,43 +200,53 @@ static void _gtpv1_tun_recv_common_cb(
             far->outer_header_creation.gtpu6 == 0)
             continue;
 
-        /* Check if Rule List in PDR */
-        if (ogs_list_first(&pdr->rule_list) &&
-            ogs_pfcp_pdr_rule_find_by_packet(pdr, recvbuf) == NULL)
-            continue;
-
         break;
     }
 
-    if (!pdr)
+    if (!pdr) {
+        /* Fallback PDR : Lowest precedence downlink PDR */
+        ogs_list_reverse_for_each(&sess->pfcp.pdr_list, fallback_pdr) {
+            if (fallback_pdr->src_if == OGS_PFCP_INTERFACE_CORE)
+                break;
+        }
+        if (fallback_pdr)
+            ogs_assert(fallback_pdr->far);
         pdr = fallback_pdr;
+    }
 
     if (!pdr) {
         if (ogs_global_conf()->parameter.multicast) {
             upf_gtp_handle_multicast(recvbuf);
+            recvbuf = NULL;
         }
         goto cleanup;
     }
 
+    upf_sess_dp_lock(sess);
+
+    /* MBR and Gate Status */
+    if (pdr->qer && ogs_pfcp_up_handle_qer(pdr->qer, false, recvbuf,
+                upf_sess_qer_clock()) == false) {
+        upf_sess_dp_unlock(sess);
+        upf_metrics_dp_by_qfi_add(pdr->qer->qfi,
+                UPF_METR_CTR_QER_DROPPEDPKT, 1);
+        upf_metrics_dp_by_qfi_add(pdr->qer->qfi,
+                UPF_METR_CTR_QER_DROPPEDVOLUME, recvbuf->len);
+        goto cleanup;
+    }
+
     /* Increment total & dl octets + pkts */
     for (i = 0; i < pdr->num_of_urr; i++)
         upf_sess_urr_acc_add(sess, pdr->urr[i], recvbuf->len, false);
 
+    /* Issue #2210 : Per-thread counters, see metrics.h */
+    upf_metrics_dp_global_inc(UPF_METR_GLOB_CTR_GTP_OUTDATAPKTN3UPF);
+    upf_metrics_dp_by_qfi_add(pdr->qer ? pdr->qer->qfi : 0,
+        UPF_METR_CTR_GTP_OUTDATAVOLUMEQOSLEVELN3UPF, recvbuf->len);
+
     ogs_assert(true == ogs_pfcp_up_handle_pdr(
                 pdr, OGS_GTPU_MSGTYPE_GPDU, NULL, recvbuf, &report));
-
-    /*
-     * Issue #2210, Discussion #2208, #2209
-     *
-     * Metrics reduce data plane performance.
-     * It should not be used on the UPF/SGW-U data plane
-     * until this issue is resolved.
-     */
-#if 0
-    upf_metrics_inst_global_inc(UPF_METR_GLOB_CTR_GTP_OUTDATAPKTN3UPF);
-    upf_metrics_inst_by_qfi_add(pdr->qer->qfi,
-        UPF_METR_CTR_GTP_OUTDATAVOLUMEQOSLEVELN3UPF, recvbuf->len);
-#endif
+    recvbuf = NULL;
 
     if (report.type.downlink_data_report) {
         ogs_assert(pdr->sess);
@@ -242,8 +261,78 @@ static void _gtpv1_tun_recv_common_cb(
             upf_pfcp_send_session_report_request(sess, &report));
     }
 
+    upf_sess_dp_unlock(sess);
+
 cleanup:
-    ogs_pkbuf_free(recvbuf);
+    if (recvbuf)
+        ogs_pkbuf_free(recvbuf);
+}
+
+/*
+ * With TUN offload, one read may return a TCP super-packet of up to 64KB.
+ * It is split into MTU-sized packets here, and the resulting G-PDUs
+ * leave with one sendmmsg() per GTP-U socket.
+ */
+static void _gtpv1_tun_recv_offload(ogs_socket_t fd)
+{
+    ogs_pkbuf_t *pkbuf = NULL;
+    ogs_tun_vnet_hdr_t vnet_hdr;
+    ogs_tun_gso_t gso;
+    ogs_gtp_batch_stat_t stat;
+    uint8_t *data = NULL;
+    int len;
+
+    len = ogs_tun_read_offload(fd, &vnet_hdr, &data);
+    if (len == OGS_ERROR) {
+        ogs_warn("ogs_tun_read_offload() failed");
+        return;
+    }
+
+    if (ogs_tun_gso_init(&gso, data, len, &vnet_hdr) != OGS_OK) {
+        ogs_error("[DROP] Cannot segment TUN packet");
+        return;
+    }
+
+    ogs_gtp_tx_batch_begin();
+    upf_worker_lock();
+    upf_sess_urr_acc_batch_begin();
+
+    while ((pkbuf = ogs_tun_gso_next(&gso, packet_pool)))
+        _gtpv1_tun_handle_pkbuf(fd, false, pkbuf);
+
+    upf_sess_urr_acc_batch_end();
+    upf_worker_unlock();
+    ogs_gtp_tx_batch_flush(&stat);
+
+    upf_metrics_dp_global_add(
+            UPF_METR_GLOB_CTR_GTP_TX_SYSCALL, stat.syscalls);
+    upf_metrics_dp_global_add(UPF_METR_GLOB_CTR_GTP_TX_PKT, stat.packets);
+}
+
+static void _gtpv1_tun_recv_common_cb(
+        short when, ogs_socket_t fd, bool has_eth, void *data)
+{
+    ogs_pfcp_dev_t *dev = data;
+    ogs_pkbuf_t *recvbuf = NULL;
+
+    ogs_assert(dev);
+
+    if (dev->offload) {
+        _gtpv1_tun_recv_offload(fd);
+        return;
+    }
+
+    recvbuf = ogs_tun_read(fd, packet_pool);
+    if (!recvbuf) {
+        ogs_warn("ogs_tun_read() failed");
+        return;
+    }
+
+    upf_worker_lock();
+    upf_sess_urr_acc_batch_begin();
+    _gtpv1_tun_handle_pkbuf(fd, has_eth, recvbuf);
+    upf_sess_urr_acc_batch_end();
+    upf_worker_unlock();
 }
 
 static void _gtpv1_tun_recv_cb(short when, ogs_socket_t fd, void *data)
@@ -256,41 +345,22 @@ static void _gtpv1_tun_recv_eth_cb(short when, ogs_socket_t fd, void *data)
     _gtpv1_tun_recv_common_cb(when, fd, true, data);
 }
 
-static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
+/* pkbuf is consumed */
+static void _gtpv1_u_handle_pkbuf(
+        ogs_sock_t *sock, ogs_sockaddr_t *from, ogs_pkbuf_t *pkbuf)
 {
     int len;
-    ssize_t size;
     char buf1[OGS_ADDRSTRLEN];
     char buf2[OGS_ADDRSTRLEN];
 
     upf_sess_t *sess = NULL;
 
-    ogs_pkbuf_t *pkbuf = NULL;
-    ogs_sock_t *sock = NULL;
-    ogs_sockaddr_t from;
-
     ogs_gtp2_header_t *gtp_h = NULL;
     ogs_gtp2_header_desc_t header_desc;
     ogs_pfcp_user_plane_report_t report;
 
-    ogs_assert(fd != INVALID_SOCKET);
-    sock = data;
     ogs_assert(sock);
-
-    pkbuf = ogs_pkbuf_alloc(packet_pool, OGS_MAX_PKT_LEN);
-    ogs_assert(pkbuf);
-    ogs_pkbuf_reserve(pkbuf, OGS_TUN_MAX_HEADROOM);
-    ogs_pkbuf_put(pkbuf, OGS_MAX_PKT_LEN-OGS_TUN_MAX_HEADROOM);
-
-    size = ogs_recvfrom(fd, pkbuf->data, pkbuf->len, 0, &from);
-    if (size <= 0) {
-        ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
-                "ogs_recv() failed");
-        goto cleanup;
-    }
-
-    ogs_pkbuf_trim(pkbuf, size);
-
+    ogs_assert(from);
     ogs_assert(pkbuf);
     ogs_assert(pkbuf->len);
 
@@ -310,16 +380,17 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
     if (header_desc.type == OGS_GTPU_MSGTYPE_ECHO_REQ) {
         ogs_pkbuf_t *echo_rsp;
 
-        ogs_debug("[RECV] Echo Request from [%s]", OGS_ADDR(&from, buf1));
+        ogs_debug("[RECV] Echo Request from [%s]", OGS_ADDR(from, buf1));
         echo_rsp = ogs_gtp2_handle_echo_req(pkbuf);
         ogs_expect(echo_rsp);
         if (echo_rsp) {
             ssize_t sent;
 
             /* Echo reply */
-            ogs_debug("[SEND] Echo Response to [%s]", OGS_ADDR(&from, buf1));
+            ogs_debug("[SEND] Echo Response to [%s]", OGS_ADDR(from, buf1));
 
-            sent = ogs_sendto(fd, echo_rsp->data, echo_rsp->len, 0, &from);
+            sent = ogs_sendto(sock->fd,
+                    echo_rsp->data, echo_rsp->len, 0, from);
             if (sent < 0 || sent != echo_rsp->len) {
                 ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
                         "ogs_sendto() failed");
@@ -337,7 +408,7 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
     }
 
     ogs_trace("[RECV] GPU-U Type [%d] from [%s] : TEID[0x%x]",
-            header_desc.type, OGS_ADDR(&from, buf1), header_desc.teid);
+            header_desc.type, OGS_ADDR(from, buf1), header_desc.teid);
 
     /* Remove GTP header and send packets to TUN interface */
     ogs_assert(ogs_pkbuf_pull(pkbuf, len));
@@ -374,27 +445,21 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
         ogs_pfcp_object_t *pfcp_object = NULL;
         ogs_pfcp_sess_t *pfcp_sess = NULL;
         ogs_pfcp_pdr_t *pdr = NULL;
+        ogs_pfcp_packet_key_t key;
+        ogs_pfcp_pdr_match_t match;
         ogs_pfcp_far_t *far = NULL;
 
         ogs_pfcp_subnet_t *subnet = NULL;
         ogs_pfcp_dev_t *dev = NULL;
-        int i;
+        int i, pos;
 
         ip_h = (struct ip *)pkbuf->data;
         ogs_assert(ip_h);
 
-        /*
-         * Issue #2210, Discussion #2208, #2209
-         *
-         * Metrics reduce data plane performance.
-         * It should not be used on the UPF/SGW-U data plane
-         * until this issue is resolved.
-         */
-#if 0
-        upf_metrics_inst_global_inc(UPF_METR_GLOB_CTR_GTP_INDATAPKTN3UPF);
-        upf_metrics_inst_by_qfi_add(header_desc.qos_flow_identifier,
+        /* Issue #2210 : Per-thread counters, see metrics.h */
+        upf_metrics_dp_global_inc(UPF_METR_GLOB_CTR_GTP_INDATAPKTN3UPF);
+        upf_metrics_dp_by_qfi_add(header_desc.qos_flow_identifier,
                 UPF_METR_CTR_GTP_INDATAVOLUMEQOSLEVELN3UPF, pkbuf->len);
-#endif
 
         pfcp_object = ogs_pfcp_object_find_by_teid(header_desc.teid);
         if (!pfcp_object) {
@@ -414,10 +479,10 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
                 ogs_error("[%s] Send Error Indication [TEID:0x%x] to [%s]",
                         OGS_ADDR(&sock->local_addr, buf1),
                         header_desc.teid,
-                        OGS_ADDR(&from, buf2));
+                        OGS_ADDR(from, buf2));
                 ogs_gtp1_send_error_indication(
                         sock, header_desc.teid,
-                        header_desc.qos_flow_identifier, &from);
+                        header_desc.qos_flow_identifier, from);
             }
             goto cleanup;
         }
@@ -433,29 +498,20 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
             pfcp_sess = (ogs_pfcp_sess_t *)pfcp_object;
             ogs_assert(pfcp_sess);
 
-            ogs_list_for_each(&pfcp_sess->pdr_list, pdr) {
-
-                /* Check if Source Interface */
-                if (pdr->src_if != OGS_PFCP_INTERFACE_ACCESS &&
-                    pdr->src_if != OGS_PFCP_INTERFACE_CP_FUNCTION)
-                    continue;
+            ogs_pfcp_packet_key_init(&key, pkbuf);
 
-                /* Check if TEID */
-                if (header_desc.teid != pdr->f_teid.teid)
-                    continue;
+            /* Source Interface, TEID, QFI and SDF filters */
+            memset(&match, 0, sizeof(match));
+            match.src_if =
+                OGS_PFCP_PDR_MATCH_IF(OGS_PFCP_INTERFACE_ACCESS) |
+                OGS_PFCP_PDR_MATCH_IF(OGS_PFCP_INTERFACE_CP_FUNCTION);
+            match.teid_presence = true;
+            match.teid = header_desc.teid;
+            match.qfi = header_desc.qos_flow_identifier;
 
-                /* Check if QFI */
-                if (header_desc.qos_flow_identifier &&
-                    pdr->qfi != header_desc.qos_flow_identifier)
-                    continue;
-
-                /* Check if Rule List in PDR */
-                if (ogs_list_first(&pdr->rule_list) &&
-                    ogs_pfcp_pdr_rule_find_by_packet(pdr, pkbuf) == NULL)
-                    continue;
-
-                break;
-            }
+            pos = 0;
+            pdr = ogs_pfcp_sess_pdr_find_by_key(
+                    pfcp_sess, &match, &key, &pos);
 
             if (!pdr) {
                 /*
@@ -475,10 +531,10 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
                             "[%s] Send Error Indication [TEID:0x%x] to [%s]",
                             OGS_ADDR(&sock->local_addr, buf1),
                             header_desc.teid,
-                            OGS_ADDR(&from, buf2));
+                            OGS_ADDR(from, buf2));
                     ogs_gtp1_send_error_indication(
                             sock, header_desc.teid,
-                            header_desc.qos_flow_identifier, &from);
+                            header_desc.qos_flow_identifier, from);
                 }
                 goto cleanup;
             }
@@ -621,6 +677,24 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
             goto cleanup;
         }
 
+        /* MBR and Gate Status */
+        if (pdr->qer) {
+            bool pass;
+
+            upf_sess_dp_lock(sess);
+            pass = ogs_pfcp_up_handle_qer(pdr->qer, true, pkbuf,
+                    upf_sess_qer_clock());
+            upf_sess_dp_unlock(sess);
+
+            if (!pass) {
+                upf_metrics_dp_by_qfi_add(pdr->qer->qfi,
+                        UPF_METR_CTR_QER_DROPPEDPKT, 1);
+                upf_metrics_dp_by_qfi_add(pdr->qer->qfi,
+                        UPF_METR_CTR_QER_DROPPEDVOLUME, pkbuf->len);
+                goto cleanup;
+            }
+        }
+
         if (far->dst_if == OGS_PFCP_INTERFACE_CORE) {
 
             if (!subnet) {
@@ -636,8 +710,10 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
             ogs_assert(dev);
 
             /* Increment total & ul octets + pkts */
+            upf_sess_dp_lock(sess);
             for (i = 0; i < pdr->num_of_urr; i++)
                 upf_sess_urr_acc_add(sess, pdr->urr[i], pkbuf->len, true);
+            upf_sess_dp_unlock(sess);
 
             if (dev->is_tap) {
                 ogs_assert(eth_type);
@@ -651,12 +727,21 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
             }
 
             /* TODO: if destined to another UE, hairpin back out. */
-            if (ogs_tun_write(dev->fd, pkbuf) != OGS_OK)
+            if (dev->offload) {
+                /* Written out by upf_gtp_tun_flush() */
+                if (ogs_tun_gro_write(&tun_gro, dev->fd, pkbuf) != OGS_OK)
+                    ogs_warn("ogs_tun_gro_write() failed");
+                pkbuf = NULL;
+            } else if (ogs_tun_write(dev->fd, pkbuf) != OGS_OK) {
                 ogs_warn("ogs_tun_write() failed");
+            }
 
         } else if (far->dst_if == OGS_PFCP_INTERFACE_ACCESS) {
+            upf_sess_dp_lock(sess);
+
             ogs_assert(true == ogs_pfcp_up_handle_pdr(
                         pdr, header_desc.type, &header_desc, pkbuf, &report));
+            pkbuf = NULL;
 
             if (report.type.downlink_data_report) {
                 ogs_error("Indirect Data Fowarding Buffered");
@@ -669,6 +754,8 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
                     upf_pfcp_send_session_report_request(sess, &report));
             }
 
+            upf_sess_dp_unlock(sess);
+
         } else if (far->dst_if == OGS_PFCP_INTERFACE_CP_FUNCTION) {
 
             if (!far->gnode) {
@@ -682,8 +769,11 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
                 goto cleanup;
             }
 
+            upf_sess_dp_lock(sess);
             ogs_assert(true == ogs_pfcp_up_handle_pdr(
                         pdr, header_desc.type, &header_desc, pkbuf, &report));
+            pkbuf = NULL;
+            upf_sess_dp_unlock(sess);
 
             ogs_assert(report.type.downlink_data_report == 0);
 
@@ -697,7 +787,206 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
     }
 
 cleanup:
-    ogs_pkbuf_free(pkbuf);
+    if (pkbuf)
+        ogs_pkbuf_free(pkbuf);
+}
+
+static void _rxbuf_reset(ogs_pkbuf_t *pkbuf)
+{
+    pkbuf->len = 0;
+    pkbuf->data = pkbuf->head;
+    pkbuf->tail = pkbuf->head;
+
+    ogs_pkbuf_reserve(pkbuf, OGS_TUN_MAX_HEADROOM);
+    ogs_pkbuf_put(pkbuf, OGS_MAX_PKT_LEN-OGS_TUN_MAX_HEADROOM);
+}
+
+/*
+ * Receive up to 'batch' G-PDUs with one recvmmsg() and send
+ * all resulting G-PDUs with one sendmmsg() per socket.
+ * Returns the number of G-PDUs received.
+ *
+ * The handler consumes the buffers it is given. Only those slots
+ * are refilled, the others are rewound before the next recvmmsg().
+ * Each data plane worker has its own set.
+ */
+static ogs_pkbuf_t *main_rx_batch[OGS_MAX_NUM_OF_SOCKMSG];
+
+#define UPF_GTPU_MAX_RECV_ROUND 8
+
+static int _gtpv1_u_recv_batch(ogs_sock_t *sock, int batch)
+{
+    int i, n;
+    char buf[OGS_ADDRSTRLEN];
+
+    ogs_pkbuf_t **rx_batch = NULL;
+    ogs_sockaddr_t from[OGS_MAX_NUM_OF_SOCKMSG];
+    ogs_sockmsg_t msg[OGS_MAX_NUM_OF_SOCKMSG];
+    ogs_gtp_batch_stat_t stat;
+
+    ogs_assert(sock);
+    ogs_assert(batch > 1 && batch <= OGS_MAX_NUM_OF_SOCKMSG);
+
+    rx_batch = upf_worker_self() ?
+        upf_worker_self()->rx_batch : main_rx_batch;
+
+    for (i = 0; i < batch; i++) {
+        if (!rx_batch[i]) {
+            rx_batch[i] = ogs_pkbuf_alloc(packet_pool, OGS_MAX_PKT_LEN);
+            ogs_assert(rx_batch[i]);
+        }
+        _rxbuf_reset(rx_batch[i]);
+
+        msg[i].buf = rx_batch[i]->data;
+        msg[i].len = rx_batch[i]->len;
+        msg[i].addr = &from[i];
+    }
+
+    n = ogs_recvmmsg(sock->fd, msg, batch, 0);
+    if (n <= 0) {
+        if (ogs_socket_errno != OGS_EAGAIN)
+            ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
+                    "ogs_recvmmsg() failed");
+        return 0;
+    }
+
+    ogs_gtp_tx_batch_begin();
+    upf_worker_lock();
+    upf_sess_urr_acc_batch_begin();
+
+    for (i = 0; i < n; i++) {
+        if (msg[i].len == 0) {
+            ogs_error("[DROP] Empty GTPU packet from [%s]",
+                    OGS_ADDR(&from[i], buf));
+            continue;
+        }
+
+        ogs_pkbuf_trim(rx_batch[i], msg[i].len);
+        _gtpv1_u_handle_pkbuf(sock, &from[i], rx_batch[i]);
+        rx_batch[i] = NULL;
+    }
+
+    upf_gtp_tun_flush();
+    upf_sess_urr_acc_batch_end();
+    upf_worker_unlock();
+    ogs_gtp_tx_batch_flush(&stat);
+
+    upf_metrics_dp_global_inc(UPF_METR_GLOB_CTR_GTP_RX_SYSCALL);
+    upf_metrics_dp_global_add(UPF_METR_GLOB_CTR_GTP_RX_PKT, n);
+    upf_metrics_dp_global_add(
+            UPF_METR_GLOB_CTR_GTP_TX_SYSCALL, stat.syscalls);
+    upf_metrics_dp_global_add(UPF_METR_GLOB_CTR_GTP_TX_PKT, stat.packets);
+
+    return n;
+}
+
+static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
+{
+    ssize_t size;
+
+    ogs_pkbuf_t *pkbuf = NULL;
+    ogs_socknode_t *node = NULL;
+    ogs_sock_t *sock = NULL;
+    ogs_sockaddr_t from;
+
+    ogs_assert(fd != INVALID_SOCKET);
+    node = data;
+    ogs_assert(node);
+    sock = node->sock;
+    ogs_assert(sock);
+
+    if (node->option && node->option->mmsg_batch > 1) {
+        int round = 0;
+
+        /*
+         * The socket is edge-triggered, so read until it is empty.
+         * A short batch means nothing was left. After
+         * UPF_GTPU_MAX_RECV_ROUND full batches, the other fds get their
+         * turn and the poll is re-armed for the rest.
+         */
+        while (_gtpv1_u_recv_batch(sock, node->option->mmsg_batch) ==
+                node->option->mmsg_batch) {
+            if (++round == UPF_GTPU_MAX_RECV_ROUND) {
+                ogs_assert(node->poll);
+                ogs_pollset_rearm(node->poll);
+                break;
+            }
+        }
+        return;
+    }
+
+    pkbuf = ogs_pkbuf_alloc(packet_pool, OGS_MAX_PKT_LEN);
+    ogs_assert(pkbuf);
+    ogs_pkbuf_reserve(pkbuf, OGS_TUN_MAX_HEADROOM);
+    ogs_pkbuf_put(pkbuf, OGS_MAX_PKT_LEN-OGS_TUN_MAX_HEADROOM);
+
+    size = ogs_recvfrom(fd, pkbuf->data, pkbuf->len, 0, &from);
+    if (size <= 0) {
+        ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
+                "ogs_recv() failed");
+        ogs_pkbuf_free(pkbuf);
+        return;
+    }
+
+    ogs_pkbuf_trim(pkbuf, size);
+
+    upf_worker_lock();
+    upf_sess_urr_acc_batch_begin();
+    _gtpv1_u_handle_pkbuf(sock, &from, pkbuf);
+    upf_gtp_tun_flush();
+    upf_sess_urr_acc_batch_end();
+    upf_worker_unlock();
+}
+
+/*
+ * G-PDUs from the packet ring are handled in batches of up to
+ * OGS_MAX_NUM_OF_SOCKMSG. The pkbufs point into the ring, so the blocks
+ * go back to the kernel only after the whole batch has been sent.
+ */
+static void _gtpv1_u_recv_ring_cb(short when, ogs_socket_t fd, void *data)
+{
+    int i, n;
+
+    ogs_pkbuf_t *pkbuf[OGS_MAX_NUM_OF_SOCKMSG];
+    ogs_sockaddr_t from[OGS_MAX_NUM_OF_SOCKMSG];
+    ogs_socknode_t *node = NULL;
+    ogs_gtp_ring_t *ring = NULL;
+    ogs_gtp_batch_stat_t stat;
+
+    node = data;
+    ogs_assert(node);
+    ogs_assert(node->sock);
+    ring = node->ring;
+    ogs_assert(ring);
+
+    do {
+        n = ogs_gtp_ring_recv(ring, packet_pool,
+                pkbuf, from, OGS_MAX_NUM_OF_SOCKMSG);
+        if (!n) {
+            ogs_gtp_ring_release(ring);
+            break;
+        }
+
+        ogs_gtp_tx_batch_begin();
+        upf_worker_lock();
+        upf_sess_urr_acc_batch_begin();
+
+        for (i = 0; i < n; i++)
+            _gtpv1_u_handle_pkbuf(node->sock, &from[i], pkbuf[i]);
+
+        upf_gtp_tun_flush();
+        upf_sess_urr_acc_batch_end();
+        upf_worker_unlock();
+        ogs_gtp_tx_batch_flush(&stat);
+
+        ogs_gtp_ring_release(ring);
+
+        upf_metrics_dp_global_add(UPF_METR_GLOB_CTR_GTP_RX_PKT, n);
+        upf_metrics_dp_global_add(
+                UPF_METR_GLOB_CTR_GTP_TX_SYSCALL, stat.syscalls);
+        upf_metrics_dp_global_add(
+                UPF_METR_GLOB_CTR_GTP_TX_PKT, stat.packets);
+    } while (n == OGS_MAX_NUM_OF_SOCKMSG);
 }
 
 int upf_gtp_init(void)
@@ -721,6 +1010,15 @@ int upf_gtp_init(void)
 
 void upf_gtp_final(void)
 {
+    int i;
+
+    for (i = 0; i < OGS_MAX_NUM_OF_SOCKMSG; i++) {
+        if (main_rx_batch[i]) {
+            ogs_pkbuf_free(main_rx_batch[i]);
+            main_rx_batch[i] = NULL;
+        }
+    }
+
     ogs_pkbuf_pool_destroy(packet_pool);
 }
 
@@ -750,6 +1048,60 @@ static void _get_dev_mac_addr(char *ifname, uint8_t *mac_addr)
 #endif
 }
 
+ogs_poll_t *upf_gtp_add_gtpu_poll(
+        ogs_pollset_t *pollset, ogs_socknode_t *node)
+{
+    ogs_assert(pollset);
+    ogs_assert(node);
+    ogs_assert(node->sock);
+
+    if (node->option && node->option->packet_ring) {
+        /* Falls back to the socket if the ring is not available */
+        node->ring = ogs_gtp_ring_create(node->sock,
+                node->option->packet_ring, node->option->so_bindtodevice,
+                upf_self()->num_of_worker);
+        if (node->ring)
+            return ogs_pollset_add(pollset, OGS_POLLIN,
+                    ogs_gtp_ring_fd(node->ring), _gtpv1_u_recv_ring_cb, node);
+    }
+
+    if (node->option && node->option->mmsg_batch > 1)
+        return ogs_pollset_add(pollset, OGS_POLLIN|OGS_POLLET,
+                node->sock->fd, _gtpv1_u_recv_cb, node);
+
+    return ogs_pollset_add(pollset,
+            OGS_POLLIN, node->sock->fd, _gtpv1_u_recv_cb, node);
+}
+
+void upf_gtp_remove_gtpu_poll(ogs_socknode_t *node)
+{
+    ogs_assert(node);
+
+    if (node->poll) {
+        ogs_pollset_remove(node->poll);
+        node->poll = NULL;
+    }
+    if (node->ring) {
+        ogs_gtp_ring_destroy(node->ring);
+        node->ring = NULL;
+    }
+}
+
+ogs_poll_t *upf_gtp_add_tun_poll(
+        ogs_pollset_t *pollset, ogs_pfcp_dev_t *dev, ogs_socket_t fd)
+{
+    ogs_assert(pollset);
+    ogs_assert(dev);
+    ogs_assert(fd != INVALID_SOCKET);
+
+    if (dev->is_tap)
+        return ogs_pollset_add(pollset,
+                OGS_POLLIN, fd, _gtpv1_tun_recv_eth_cb, dev);
+    else
+        return ogs_pollset_add(pollset,
+                OGS_POLLIN, fd, _gtpv1_tun_recv_cb, dev);
+}
+
 int upf_gtp_open(void)
 {
     ogs_pfcp_dev_t *dev = NULL;
@@ -758,7 +1110,20 @@ int upf_gtp_open(void)
     ogs_sock_t *sock = NULL;
     int rc;
 
+    /*
+     * With data plane workers, the sockets and TUN queues opened here
+     * are polled by the first worker, see upf_worker_open().
+     */
     ogs_list_for_each(&ogs_gtp_self()->gtpu_list, node) {
+        if (upf_self()->num_of_worker) {
+            if (!node->option) {
+                node->option = ogs_malloc(sizeof(*node->option));
+                ogs_assert(node->option);
+                ogs_sockopt_init(node->option);
+            }
+            node->option->so_reuseport = true;
+        }
+
         sock = ogs_gtp_server(node);
         if (!sock) return OGS_ERROR;
 
@@ -767,9 +1132,10 @@ int upf_gtp_open(void)
         else if (sock->family == AF_INET6)
             ogs_gtp_self()->gtpu_sock6 = sock;
 
-        node->poll = ogs_pollset_add(ogs_app()->pollset,
-                OGS_POLLIN, sock->fd, _gtpv1_u_recv_cb, sock);
-        ogs_assert(node->poll);
+        if (!upf_self()->num_of_worker) {
+            node->poll = upf_gtp_add_gtpu_poll(ogs_app()->pollset, node);
+            ogs_assert(node->poll);
+        }
     }
 
     OGS_SETUP_GTPU_SERVER;
@@ -788,24 +1154,32 @@ int upf_gtp_open(void)
     /* Open Tun interface */
     ogs_list_for_each(&ogs_pfcp_self()->dev_list, dev) {
         dev->is_tap = strstr(dev->ifname, "tap");
-        dev->fd = ogs_tun_open(dev->ifname, OGS_MAX_IFNAME_LEN, dev->is_tap);
+        if (upf_self()->tun_offload && dev->is_tap)
+            ogs_warn("tun_offload is not supported for TAP(dev:%s)",
+                    dev->ifname);
+
+        dev->offload = upf_self()->tun_offload && !dev->is_tap;
+        if (dev->offload)
+            dev->fd = ogs_tun_open_offload(dev->ifname,
+                    OGS_MAX_IFNAME_LEN, upf_self()->num_of_worker > 0);
+        else if (upf_self()->num_of_worker)
+            dev->fd = ogs_tun_open_multi_queue(
+                    dev->ifname, OGS_MAX_IFNAME_LEN, dev->is_tap);
+        else
+            dev->fd = ogs_tun_open(
+                    dev->ifname, OGS_MAX_IFNAME_LEN, dev->is_tap);
         if (dev->fd == INVALID_SOCKET) {
             ogs_error("tun_open(dev:%s) failed", dev->ifname);
             return OGS_ERROR;
         }
 
-        if (dev->is_tap) {
+        if (dev->is_tap)
             _get_dev_mac_addr(dev->ifname, dev->mac_addr);
-            dev->poll = ogs_pollset_add(ogs_app()->pollset,
-                    OGS_POLLIN, dev->fd, _gtpv1_tun_recv_eth_cb, NULL);
-            ogs_assert(dev->poll);
-        } else {
-            dev->poll = ogs_pollset_add(ogs_app()->pollset,
-                    OGS_POLLIN, dev->fd, _gtpv1_tun_recv_cb, NULL);
+
+        if (!upf_self()->num_of_worker) {
+            dev->poll = upf_gtp_add_tun_poll(ogs_app()->pollset, dev, dev->fd);
             ogs_assert(dev->poll);
         }
-
-        ogs_assert(dev->poll);
     }
 
     /*
@@ -834,7 +1208,10 @@ int upf_gtp_open(void)
 void upf_gtp_close(void)
 {
     ogs_pfcp_dev_t *dev = NULL;
+    ogs_socknode_t *node = NULL;
 
+    ogs_list_for_each(&ogs_gtp_self()->gtpu_list, node)
+        upf_gtp_remove_gtpu_poll(node);
     ogs_socknode_remove_all(&ogs_gtp_self()->gtpu_list);
 
     ogs_list_for_each(&ogs_pfcp_self()->dev_list, dev) {
@@ -872,17 +1249,21 @@ static void upf_gtp_handle_multicast(ogs_pkbuf_t *recvbuf)
 
                     ogs_list_for_each(&sess->pfcp.pdr_list, pdr) {
                         if (pdr->src_if == OGS_PFCP_INTERFACE_CORE) {
+                            upf_sess_dp_lock(sess);
                             ogs_assert(true ==
                                 ogs_pfcp_up_handle_pdr(
                                     pdr, OGS_GTPU_MSGTYPE_GPDU,
                                     NULL, recvbuf, &report));
-                            break;
+                            upf_sess_dp_unlock(sess);
+                            return;
                         }
                     }
 
-                    return;
+                    break;
                 }
             }
         }
     }
+
+    ogs_pkbuf_free(recvbuf);
 }
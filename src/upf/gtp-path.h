@@ -22,6 +22,7 @@
 
 #include "ogs-tun.h"
 #include "ogs-gtp.h"
+#include "ogs-pfcp.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -33,6 +34,12 @@ void upf_gtp_final(void);
 int upf_gtp_open(void);
 void upf_gtp_close(void);
 
+ogs_poll_t *upf_gtp_add_gtpu_poll(
+        ogs_pollset_t *pollset, ogs_socknode_t *node);
+void upf_gtp_remove_gtpu_poll(ogs_socknode_t *node);
+ogs_poll_t *upf_gtp_add_tun_poll(
+        ogs_pollset_t *pollset, ogs_pfcp_dev_t *dev, ogs_socket_t fd);
+
 #ifdef __cplusplus
 }
 #endif
@@ -21,6 +21,7 @@
 #include "gtp-path.h"
 #include "pfcp-path.h"
 #include "metrics.h"
+#include "worker.h"
 
 static ogs_thread_t *thread;
 static void upf_main(void *data);
@@ -74,6 +75,9 @@ int upf_initialize(void)
     rv = upf_gtp_open();
     if (rv != OGS_OK) return rv;
 
+    rv = upf_worker_open();
+    if (rv != OGS_OK) return rv;
+
     thread = ogs_thread_create(upf_main, NULL);
     if (!thread) return OGS_ERROR;
 
@@ -90,6 +94,8 @@ void upf_terminate(void)
 
     ogs_thread_destroy(thread);
 
+    upf_worker_close();
+
     upf_pfcp_close();
     upf_gtp_close();
 
@@ -113,9 +119,13 @@ static void upf_main(void *data)
     ogs_fsm_t upf_sm;
     int rv;
 
+    /* The data plane counters are per thread */
+    upf_metrics_dp_attach(0);
+
     ogs_fsm_init(&upf_sm, upf_state_initial, upf_state_final, 0);
 
     for ( ;; ) {
+        upf_sess_dp_clock_reset();
         ogs_pollset_poll(ogs_app()->pollset,
                 ogs_timer_mgr_next(ogs_app()->timer_mgr));
 
@@ -130,24 +140,19 @@ static void upf_main(void *data)
          * because 'if rv == OGS_DONE' statement is exiting and
          * not calling ogs_timer_mgr_expire().
          */
-        ogs_timer_mgr_expire(ogs_app()->timer_mgr);
+        /* Data plane workers must not run while PFCP state changes */
+        upf_worker_lock_all();
 
-        for ( ;; ) {
-            upf_event_t *e = NULL;
+        ogs_timer_mgr_expire(ogs_app()->timer_mgr);
 
-            rv = ogs_queue_trypop(ogs_app()->queue, (void**)&e);
-            ogs_assert(rv != OGS_ERROR);
+        upf_worker_handle_deferred();
 
-            if (rv == OGS_DONE)
-                goto done;
+        rv = ogs_fsm_dispatch_queue(&upf_sm, ogs_app()->queue, upf_event_free);
 
-            if (rv == OGS_RETRY)
-                break;
+        upf_worker_unlock_all();
 
-            ogs_assert(e);
-            ogs_fsm_dispatch(&upf_sm, e);
-            upf_event_free(e);
-        }
+        if (rv == OGS_DONE)
+            goto done;
     }
 done:
 
@@ -76,6 +76,26 @@ upf_metrics_spec_def_t upf_metrics_spec_def_global[_UPF_METR_GLOB_MAX] = {
     .name = "fivegs_upffunction_sm_n4sessionreportsucc",
     .description = "Number of successful N4 session reports",
 },
+[UPF_METR_GLOB_CTR_GTP_RX_SYSCALL] = {
+    .type = OGS_METRICS_METRIC_TYPE_COUNTER,
+    .name = "upf_gtpu_batch_rx_syscall",
+    .description = "Number of batched GTP-U receive system calls",
+},
+[UPF_METR_GLOB_CTR_GTP_RX_PKT] = {
+    .type = OGS_METRICS_METRIC_TYPE_COUNTER,
+    .name = "upf_gtpu_batch_rx_pkt",
+    .description = "Number of GTP-U packets received by batched system calls",
+},
+[UPF_METR_GLOB_CTR_GTP_TX_SYSCALL] = {
+    .type = OGS_METRICS_METRIC_TYPE_COUNTER,
+    .name = "upf_gtpu_batch_tx_syscall",
+    .description = "Number of batched GTP-U transmit system calls",
+},
+[UPF_METR_GLOB_CTR_GTP_TX_PKT] = {
+    .type = OGS_METRICS_METRIC_TYPE_COUNTER,
+    .name = "upf_gtpu_batch_tx_pkt",
+    .description = "Number of GTP-U packets sent by batched system calls",
+},
 /* Global Gauges: */
 [UPF_METR_GLOB_GAUGE_UPF_SESSIONNBR] = {
     .type = OGS_METRICS_METRIC_TYPE_GAUGE,
@@ -117,6 +137,14 @@ UPF_METR_BY_QFI_CTR_ENTRY(
     UPF_METR_CTR_GTP_OUTDATAVOLUMEQOSLEVELN3UPF,
     "fivegs_ep_n3_gtp_outdatavolumeqosleveln3upf",
     "Data volume of outgoing GTP data packets per QoS level on the N3 interface")
+UPF_METR_BY_QFI_CTR_ENTRY(
+    UPF_METR_CTR_QER_DROPPEDPKT,
+    "upf_qer_droppedpkt",
+    "Number of packets dropped by QER gate status or MBR per QoS level")
+UPF_METR_BY_QFI_CTR_ENTRY(
+    UPF_METR_CTR_QER_DROPPEDVOLUME,
+    "upf_qer_droppedvolume",
+    "Data volume of packets dropped by QER gate status or MBR per QoS level")
 };
 void upf_metrics_init_by_qfi(void);
 int upf_metrics_free_inst_by_qfi(ogs_metrics_inst_t **inst);
@@ -130,8 +158,8 @@ void upf_metrics_init_by_qfi(void)
     metrics_hash_by_qfi = ogs_hash_make();
     ogs_assert(metrics_hash_by_qfi);
 }
-void upf_metrics_inst_by_qfi_add(uint8_t qfi,
-        upf_metric_type_by_qfi_t t, int val)
+static ogs_metrics_inst_t *upf_metrics_inst_by_qfi(uint8_t qfi,
+        upf_metric_type_by_qfi_t t)
 {
     ogs_metrics_inst_t *metrics = NULL;
     upf_metric_key_by_qfi_t *qfi_key;
@@ -160,7 +188,13 @@ void upf_metrics_inst_by_qfi_add(uint8_t qfi,
         ogs_free(qfi_key);
     }
 
-    ogs_metrics_inst_add(metrics, val);
+    return metrics;
+}
+
+void upf_metrics_inst_by_qfi_add(uint8_t qfi,
+        upf_metric_type_by_qfi_t t, int val)
+{
+    ogs_metrics_inst_add(upf_metrics_inst_by_qfi(qfi, t), val);
 }
 
 int upf_metrics_free_inst_by_qfi(ogs_metrics_inst_t **inst)
@@ -168,6 +202,87 @@ int upf_metrics_free_inst_by_qfi(ogs_metrics_inst_t **inst)
     return upf_metrics_free_inst(inst, _UPF_METR_BY_QFI_MAX);
 }
 
+/* DATA PLANE */
+/*
+ * Slot 0 is the main thread, slot N is the data plane worker N-1.
+ * Each slot is padded by at least one cache line
+ * so that two threads never write to the same line.
+ */
+#define UPF_METRICS_DP_ALIGN(__sIZE) (((__sIZE) + 63) & ~((size_t)63))
+
+static union {
+    upf_metrics_dp_t dp;
+    uint8_t pad[UPF_METRICS_DP_ALIGN(sizeof(upf_metrics_dp_t) + 64)];
+} metrics_dp[1 + UPF_MAX_NUM_OF_WORKER];
+OGS_THREAD_LOCAL upf_metrics_dp_t *upf_metrics_dp_local = NULL;
+
+static struct {
+    uint64_t global[_UPF_METR_GLOB_MAX];
+    uint64_t by_qfi[UPF_METRICS_MAX_NUM_OF_QFI][_UPF_METR_BY_QFI_MAX];
+} metrics_dp_exported;
+
+void upf_metrics_dp_attach(int index)
+{
+    ogs_assert(index >= 0 && index < (int)OGS_ARRAY_SIZE(metrics_dp));
+    upf_metrics_dp_local = &metrics_dp[index].dp;
+}
+
+static void upf_metrics_dp_export(ogs_metrics_inst_t *inst,
+        uint64_t *exported, uint64_t total)
+{
+    uint64_t delta;
+
+    if (total <= *exported)
+        return;
+
+    delta = total - *exported;
+    *exported = total;
+
+    while (delta > INT32_MAX) {
+        ogs_metrics_inst_add(inst, INT32_MAX);
+        delta -= INT32_MAX;
+    }
+    ogs_metrics_inst_add(inst, delta);
+}
+
+/*
+ * Called on the main thread when /metrics is scraped.
+ * Workers may be updating their counters meanwhile,
+ * which at worst delays a few packets to the next scrape.
+ */
+static void upf_metrics_dp_collect(void)
+{
+    int i, qfi, n, t;
+
+    n = 1 + upf_self()->num_of_worker;
+
+    for (t = 0; t < _UPF_METR_GLOB_MAX; t++) {
+        uint64_t total = 0;
+
+        for (i = 0; i < n; i++)
+            total += metrics_dp[i].dp.global[t];
+
+        upf_metrics_dp_export(upf_metrics_inst_global[t],
+                &metrics_dp_exported.global[t], total);
+    }
+
+    for (qfi = 0; qfi < UPF_METRICS_MAX_NUM_OF_QFI; qfi++) {
+        for (t = 0; t < _UPF_METR_BY_QFI_MAX; t++) {
+            uint64_t total = 0;
+
+            for (i = 0; i < n; i++)
+                total += metrics_dp[i].dp.by_qfi[qfi][t];
+
+            /* Do not create a QFI label before it has any traffic */
+            if (total <= metrics_dp_exported.by_qfi[qfi][t])
+                continue;
+
+            upf_metrics_dp_export(upf_metrics_inst_by_qfi(qfi, t),
+                    &metrics_dp_exported.by_qfi[qfi][t], total);
+        }
+    }
+}
+
 /* BY_CAUSE */
 const char *labels_cause[] = {
     "cause"
@@ -332,6 +447,8 @@ void upf_metrics_init(void)
 
     upf_metrics_init_inst_global();
     upf_metrics_init_by_qfi();
+
+    ctx->collect = upf_metrics_dp_collect;
     upf_metrics_init_by_cause();
     upf_metrics_init_by_dnn();
 }
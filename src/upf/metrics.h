@@ -14,6 +14,10 @@ typedef enum upf_metric_type_global_s {
     UPF_METR_GLOB_CTR_SM_N4SESSIONESTABREQ,
     UPF_METR_GLOB_CTR_SM_N4SESSIONREPORT,
     UPF_METR_GLOB_CTR_SM_N4SESSIONREPORTSUCC,
+    UPF_METR_GLOB_CTR_GTP_RX_SYSCALL,
+    UPF_METR_GLOB_CTR_GTP_RX_PKT,
+    UPF_METR_GLOB_CTR_GTP_TX_SYSCALL,
+    UPF_METR_GLOB_CTR_GTP_TX_PKT,
     UPF_METR_GLOB_GAUGE_UPF_SESSIONNBR,
     _UPF_METR_GLOB_MAX,
 } upf_metric_type_global_t;
@@ -35,12 +39,54 @@ static inline void upf_metrics_inst_global_dec(upf_metric_type_global_t t)
 typedef enum upf_metric_type_by_qfi_s {
     UPF_METR_CTR_GTP_INDATAVOLUMEQOSLEVELN3UPF = 0,
     UPF_METR_CTR_GTP_OUTDATAVOLUMEQOSLEVELN3UPF,
+    UPF_METR_CTR_QER_DROPPEDPKT,
+    UPF_METR_CTR_QER_DROPPEDVOLUME,
     _UPF_METR_BY_QFI_MAX,
 } upf_metric_type_by_qfi_t;
 
 void upf_metrics_inst_by_qfi_add(
     uint8_t qfi, upf_metric_type_by_qfi_t t, int val);
 
+/*
+ * Data plane counters
+ *
+ * Updating a Prometheus metric takes a lock and a label lookup,
+ * which is too slow for every packet (Issue #2210).
+ * The data plane only bumps plain counters owned by the calling thread.
+ * They are summed up and folded into the metrics above
+ * when /metrics is scraped.
+ */
+#define UPF_METRICS_MAX_NUM_OF_QFI 64 /* QFI is 6 bits */
+
+typedef struct upf_metrics_dp_s {
+    uint64_t global[_UPF_METR_GLOB_MAX];
+    uint64_t by_qfi[UPF_METRICS_MAX_NUM_OF_QFI][_UPF_METR_BY_QFI_MAX];
+} upf_metrics_dp_t;
+
+extern OGS_THREAD_LOCAL upf_metrics_dp_t *upf_metrics_dp_local;
+
+void upf_metrics_dp_attach(int index);
+
+static ogs_inline void upf_metrics_dp_global_add(
+        upf_metric_type_global_t t, int val)
+{
+    ogs_assert(upf_metrics_dp_local);
+    upf_metrics_dp_local->global[t] += val;
+}
+
+static ogs_inline void upf_metrics_dp_global_inc(upf_metric_type_global_t t)
+{
+    ogs_assert(upf_metrics_dp_local);
+    upf_metrics_dp_local->global[t]++;
+}
+
+static ogs_inline void upf_metrics_dp_by_qfi_add(
+        uint8_t qfi, upf_metric_type_by_qfi_t t, int val)
+{
+    ogs_assert(upf_metrics_dp_local);
+    upf_metrics_dp_local->by_qfi[qfi % UPF_METRICS_MAX_NUM_OF_QFI][t] += val;
+}
+
 /* BY CAUSE */
 typedef enum upf_metric_type_by_cause_s {
     UPF_METR_CTR_SM_N4SESSIONESTABFAIL = 0,
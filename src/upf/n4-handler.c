@@ -22,8 +22,26 @@
 #include "gtp-path.h"
 #include "n4-handler.h"
 
-static void upf_n4_handle_create_urr(upf_sess_t *sess, ogs_pfcp_tlv_create_urr_t *create_urr_arr,
-                              uint8_t *cause_value, uint8_t *offending_ie_value)
+/*
+ * Decode the n-th IE of the indexed request. A missing IE is not an error :
+ * the IE is left with presence 0, which ends the ogs_pfcp_handle_*() loops.
+ */
+static bool upf_n4_parse_ie(void *ie, ogs_tlv_desc_t *desc,
+        ogs_pfcp_index_message_t *req, int n,
+        uint8_t *cause_value, uint8_t *offending_ie_value)
+{
+    if (ogs_pfcp_parse_ie(ie, desc, req, n) != OGS_ERROR)
+        return true;
+
+    ogs_error("Invalid %s [%d]", desc->name, n);
+    *cause_value = OGS_PFCP_CAUSE_MANDATORY_IE_INCORRECT;
+    *offending_ie_value = desc->type;
+    return false;
+}
+
+static void upf_n4_handle_create_urr(upf_sess_t *sess,
+        ogs_pfcp_index_message_t *req,
+        uint8_t *cause_value, uint8_t *offending_ie_value)
 {
     int i;
     ogs_pfcp_urr_t *urr;
@@ -31,7 +49,13 @@ static void upf_n4_handle_create_urr(upf_sess_t *sess, ogs_pfcp_tlv_create_urr_t
     *cause_value = OGS_PFCP_CAUSE_REQUEST_ACCEPTED;
 
     for (i = 0; i < OGS_MAX_NUM_OF_URR; i++) {
-        urr = ogs_pfcp_handle_create_urr(&sess->pfcp, &create_urr_arr[i],
+        ogs_pfcp_tlv_create_urr_t create_urr;
+
+        if (upf_n4_parse_ie(&create_urr, &ogs_pfcp_tlv_desc_create_urr,
+                    req, i, cause_value, offending_ie_value) == false)
+            return;
+
+        urr = ogs_pfcp_handle_create_urr(&sess->pfcp, &create_urr,
                     cause_value, offending_ie_value);
         if (!urr)
             return;
@@ -45,7 +69,7 @@ static void upf_n4_handle_create_urr(upf_sess_t *sess, ogs_pfcp_tlv_create_urr_t
 
 void upf_n4_handle_session_establishment_request(
         upf_sess_t *sess, ogs_pfcp_xact_t *xact,
-        ogs_pfcp_session_establishment_request_t *req)
+        ogs_pfcp_index_message_t *req)
 {
     ogs_pfcp_pdr_t *pdr = NULL;
     ogs_pfcp_far_t *far = NULL;
@@ -55,6 +79,11 @@ void upf_n4_handle_session_establishment_request(
     uint8_t offending_ie_value = 0;
     int i;
 
+    ogs_pfcp_tlv_pfcpsereq_flags_t pfcpsereq_flags;
+    ogs_pfcp_tlv_apn_dnn_t apn_dnn;
+    ogs_pfcp_tlv_pdn_type_t pdn_type;
+    ogs_pfcp_tlv_create_bar_t create_bar;
+
     ogs_pfcp_sereq_flags_t sereq_flags;
     bool restoration_indication = false;
 
@@ -78,12 +107,21 @@ void upf_n4_handle_session_establishment_request(
     }
 
     memset(&sereq_flags, 0, sizeof(sereq_flags));
-    if (req->pfcpsereq_flags.presence == 1)
-        sereq_flags.value = req->pfcpsereq_flags.u8;
+    if (upf_n4_parse_ie(&pfcpsereq_flags, &ogs_pfcp_tlv_desc_pfcpsereq_flags,
+                req, 0, &cause_value, &offending_ie_value) == false)
+        goto cleanup;
+    if (pfcpsereq_flags.presence == 1)
+        sereq_flags.value = pfcpsereq_flags.u8;
 
     for (i = 0; i < OGS_MAX_NUM_OF_PDR; i++) {
+        ogs_pfcp_tlv_create_pdr_t create_pdr;
+
+        if (upf_n4_parse_ie(&create_pdr, &ogs_pfcp_tlv_desc_create_pdr,
+                    req, i, &cause_value, &offending_ie_value) == false)
+            goto cleanup;
+
         created_pdr[i] = ogs_pfcp_handle_create_pdr(&sess->pfcp,
-                &req->create_pdr[i], &sereq_flags,
+                &create_pdr, &sereq_flags,
                 &cause_value, &offending_ie_value);
         if (created_pdr[i] == NULL)
             break;
@@ -93,22 +131,31 @@ void upf_n4_handle_session_establishment_request(
         goto cleanup;
 
     for (i = 0; i < OGS_MAX_NUM_OF_FAR; i++) {
-        if (ogs_pfcp_handle_create_far(&sess->pfcp, &req->create_far[i],
+        ogs_pfcp_tlv_create_far_t create_far;
+
+        if (upf_n4_parse_ie(&create_far, &ogs_pfcp_tlv_desc_create_far,
+                    req, i, &cause_value, &offending_ie_value) == false)
+            goto cleanup;
+
+        if (ogs_pfcp_handle_create_far(&sess->pfcp, &create_far,
                     &cause_value, &offending_ie_value) == NULL)
             break;
     }
     if (cause_value != OGS_PFCP_CAUSE_REQUEST_ACCEPTED)
         goto cleanup;
 
-    upf_n4_handle_create_urr(sess, &req->create_urr[0], &cause_value, &offending_ie_value);
+    upf_n4_handle_create_urr(sess, req, &cause_value, &offending_ie_value);
     if (cause_value != OGS_PFCP_CAUSE_REQUEST_ACCEPTED)
         goto cleanup;
 
-    if (req->apn_dnn.presence) {
-        char apn_dnn[OGS_MAX_DNN_LEN+1];
+    if (upf_n4_parse_ie(&apn_dnn, &ogs_pfcp_tlv_desc_apn_dnn,
+                req, 0, &cause_value, &offending_ie_value) == false)
+        goto cleanup;
+    if (apn_dnn.presence) {
+        char dnn[OGS_MAX_DNN_LEN+1];
 
-        if (ogs_fqdn_parse(apn_dnn, req->apn_dnn.data,
-            ogs_min(req->apn_dnn.len, OGS_MAX_DNN_LEN)) <= 0) {
+        if (ogs_fqdn_parse(dnn, apn_dnn.data,
+            ogs_min(apn_dnn.len, OGS_MAX_DNN_LEN)) <= 0) {
             ogs_error("Invalid APN");
             cause_value = OGS_PFCP_CAUSE_MANDATORY_IE_INCORRECT;
             goto cleanup;
@@ -116,12 +163,18 @@ void upf_n4_handle_session_establishment_request(
 
         if (sess->apn_dnn)
             ogs_free(sess->apn_dnn);
-        sess->apn_dnn = ogs_strdup(apn_dnn);
+        sess->apn_dnn = ogs_strdup(dnn);
         ogs_assert(sess->apn_dnn);
     }
 
     for (i = 0; i < OGS_MAX_NUM_OF_QER; i++) {
-        if (ogs_pfcp_handle_create_qer(&sess->pfcp, &req->create_qer[i],
+        ogs_pfcp_tlv_create_qer_t create_qer;
+
+        if (upf_n4_parse_ie(&create_qer, &ogs_pfcp_tlv_desc_create_qer,
+                    req, i, &cause_value, &offending_ie_value) == false)
+            goto cleanup;
+
+        if (ogs_pfcp_handle_create_qer(&sess->pfcp, &create_qer,
                     &cause_value, &offending_ie_value) == NULL)
             break;
         upf_metrics_inst_by_dnn_add(sess->apn_dnn,
@@ -130,11 +183,18 @@ void upf_n4_handle_session_establishment_request(
     if (cause_value != OGS_PFCP_CAUSE_REQUEST_ACCEPTED)
         goto cleanup;
 
-    ogs_pfcp_handle_create_bar(&sess->pfcp, &req->create_bar,
+    if (upf_n4_parse_ie(&create_bar, &ogs_pfcp_tlv_desc_create_bar,
+                req, 0, &cause_value, &offending_ie_value) == false)
+        goto cleanup;
+    ogs_pfcp_handle_create_bar(&sess->pfcp, &create_bar,
                 &cause_value, &offending_ie_value);
     if (cause_value != OGS_PFCP_CAUSE_REQUEST_ACCEPTED)
         goto cleanup;
 
+    if (upf_n4_parse_ie(&pdn_type, &ogs_pfcp_tlv_desc_pdn_type,
+                req, 0, &cause_value, &offending_ie_value) == false)
+        goto cleanup;
+
     /* Setup GTP Node */
     ogs_list_for_each(&sess->pfcp.far_list, far) {
         if (OGS_ERROR == ogs_pfcp_setup_far_gtpu_node(far)) {
@@ -164,8 +224,8 @@ void upf_n4_handle_session_establishment_request(
 
         /* Setup UE IP address */
         if (pdr->ue_ip_addr_len) {
-            if (req->pdn_type.presence == 1) {
-                cause_value = upf_sess_set_ue_ip(sess, req->pdn_type.u8, pdr);
+            if (pdn_type.presence == 1) {
+                cause_value = upf_sess_set_ue_ip(sess, pdn_type.u8, pdr);
                 if (cause_value != OGS_PFCP_CAUSE_REQUEST_ACCEPTED)
                     goto cleanup;
             } else {
@@ -195,6 +255,10 @@ void upf_n4_handle_session_establishment_request(
                     OGS_PFCP_OBJ_SESS_TYPE, pdr, restoration_indication);
     }
 
+    /* Compile PDRs for the data plane, see rule-match.h */
+    if (ogs_pfcp_sess_classifier_build(&sess->pfcp) != OGS_OK)
+        ogs_warn("PDR classifier not compiled, walking PDR list");
+
     /* Send Buffered Packet to gNB/SGW */
     ogs_list_for_each(&sess->pfcp.pdr_list, pdr) {
         if (pdr->src_if == OGS_PFCP_INTERFACE_CORE) { /* Downlink */
@@ -225,7 +289,7 @@ cleanup:
 
 void upf_n4_handle_session_modification_request(
         upf_sess_t *sess, ogs_pfcp_xact_t *xact,
-        ogs_pfcp_session_modification_request_t *req)
+        ogs_pfcp_index_message_t *req)
 {
     ogs_pfcp_pdr_t *pdr = NULL;
     ogs_pfcp_far_t *far = NULL;
@@ -235,6 +299,9 @@ void upf_n4_handle_session_modification_request(
     uint8_t offending_ie_value = 0;
     int i;
 
+    ogs_pfcp_tlv_create_bar_t create_bar;
+    ogs_pfcp_tlv_remove_bar_t remove_bar;
+
     ogs_assert(xact);
     ogs_assert(req);
 
@@ -251,8 +318,14 @@ void upf_n4_handle_session_modification_request(
     }
 
     for (i = 0; i < OGS_MAX_NUM_OF_PDR; i++) {
+        ogs_pfcp_tlv_create_pdr_t create_pdr;
+
+        if (upf_n4_parse_ie(&create_pdr, &ogs_pfcp_tlv_desc_create_pdr,
+                    req, i, &cause_value, &offending_ie_value) == false)
+            goto cleanup;
+
         created_pdr[i] = ogs_pfcp_handle_create_pdr(&sess->pfcp,
-                &req->create_pdr[i], NULL, &cause_value, &offending_ie_value);
+                &create_pdr, NULL, &cause_value, &offending_ie_value);
         if (created_pdr[i] == NULL)
             break;
     }
@@ -261,7 +334,13 @@ void upf_n4_handle_session_modification_request(
         goto cleanup;
 
     for (i = 0; i < OGS_MAX_NUM_OF_PDR; i++) {
-        if (ogs_pfcp_handle_update_pdr(&sess->pfcp, &req->update_pdr[i],
+        ogs_pfcp_tlv_update_pdr_t update_pdr;
+
+        if (upf_n4_parse_ie(&update_pdr, &ogs_pfcp_tlv_desc_update_pdr,
+                    req, i, &cause_value, &offending_ie_value) == false)
+            goto cleanup;
+
+        if (ogs_pfcp_handle_update_pdr(&sess->pfcp, &update_pdr,
                     &cause_value, &offending_ie_value) == NULL)
             break;
     }
@@ -269,7 +348,13 @@ void upf_n4_handle_session_modification_request(
         goto cleanup;
 
     for (i = 0; i < OGS_MAX_NUM_OF_PDR; i++) {
-        if (ogs_pfcp_handle_remove_pdr(&sess->pfcp, &req->remove_pdr[i],
+        ogs_pfcp_tlv_remove_pdr_t remove_pdr;
+
+        if (upf_n4_parse_ie(&remove_pdr, &ogs_pfcp_tlv_desc_remove_pdr,
+                    req, i, &cause_value, &offending_ie_value) == false)
+            goto cleanup;
+
+        if (ogs_pfcp_handle_remove_pdr(&sess->pfcp, &remove_pdr,
                 &cause_value, &offending_ie_value) == false)
             break;
     }
@@ -277,7 +362,13 @@ void upf_n4_handle_session_modification_request(
         goto cleanup;
 
     for (i = 0; i < OGS_MAX_NUM_OF_FAR; i++) {
-        if (ogs_pfcp_handle_create_far(&sess->pfcp, &req->create_far[i],
+        ogs_pfcp_tlv_create_far_t create_far;
+
+        if (upf_n4_parse_ie(&create_far, &ogs_pfcp_tlv_desc_create_far,
+                    req, i, &cause_value, &offending_ie_value) == false)
+            goto cleanup;
+
+        if (ogs_pfcp_handle_create_far(&sess->pfcp, &create_far,
                     &cause_value, &offending_ie_value) == NULL)
             break;
     }
@@ -285,7 +376,13 @@ void upf_n4_handle_session_modification_request(
         goto cleanup;
 
     for (i = 0; i < OGS_MAX_NUM_OF_FAR; i++) {
-        if (ogs_pfcp_handle_update_far_flags(&sess->pfcp, &req->update_far[i],
+        ogs_pfcp_tlv_update_far_t update_far;
+
+        if (upf_n4_parse_ie(&update_far, &ogs_pfcp_tlv_desc_update_far,
+                    req, i, &cause_value, &offending_ie_value) == false)
+            goto cleanup;
+
+        if (ogs_pfcp_handle_update_far_flags(&sess->pfcp, &update_far,
                     &cause_value, &offending_ie_value) == NULL)
             break;
     }
@@ -305,7 +402,13 @@ void upf_n4_handle_session_modification_request(
         far->smreq_flags.value = 0;
 
     for (i = 0; i < OGS_MAX_NUM_OF_FAR; i++) {
-        if (ogs_pfcp_handle_update_far(&sess->pfcp, &req->update_far[i],
+        ogs_pfcp_tlv_update_far_t update_far;
+
+        if (upf_n4_parse_ie(&update_far, &ogs_pfcp_tlv_desc_update_far,
+                    req, i, &cause_value, &offending_ie_value) == false)
+            goto cleanup;
+
+        if (ogs_pfcp_handle_update_far(&sess->pfcp, &update_far,
                     &cause_value, &offending_ie_value) == NULL)
             break;
     }
@@ -313,19 +416,31 @@ void upf_n4_handle_session_modification_request(
         goto cleanup;
 
     for (i = 0; i < OGS_MAX_NUM_OF_FAR; i++) {
-        if (ogs_pfcp_handle_remove_far(&sess->pfcp, &req->remove_far[i],
+        ogs_pfcp_tlv_remove_far_t remove_far;
+
+        if (upf_n4_parse_ie(&remove_far, &ogs_pfcp_tlv_desc_remove_far,
+                    req, i, &cause_value, &offending_ie_value) == false)
+            goto cleanup;
+
+        if (ogs_pfcp_handle_remove_far(&sess->pfcp, &remove_far,
                 &cause_value, &offending_ie_value) == false)
             break;
     }
     if (cause_value != OGS_PFCP_CAUSE_REQUEST_ACCEPTED)
         goto cleanup;
 
-    upf_n4_handle_create_urr(sess, &req->create_urr[0], &cause_value, &offending_ie_value);
+    upf_n4_handle_create_urr(sess, req, &cause_value, &offending_ie_value);
     if (cause_value != OGS_PFCP_CAUSE_REQUEST_ACCEPTED)
         goto cleanup;
 
     for (i = 0; i < OGS_MAX_NUM_OF_URR; i++) {
-        if (ogs_pfcp_handle_update_urr(&sess->pfcp, &req->update_urr[i],
+        ogs_pfcp_tlv_update_urr_t update_urr;
+
+        if (upf_n4_parse_ie(&update_urr, &ogs_pfcp_tlv_desc_update_urr,
+                    req, i, &cause_value, &offending_ie_value) == false)
+            goto cleanup;
+
+        if (ogs_pfcp_handle_update_urr(&sess->pfcp, &update_urr,
                     &cause_value, &offending_ie_value) == NULL)
             break;
     }
@@ -333,7 +448,13 @@ void upf_n4_handle_session_modification_request(
         goto cleanup;
 
     for (i = 0; i < OGS_MAX_NUM_OF_URR; i++) {
-        if (ogs_pfcp_handle_remove_urr(&sess->pfcp, &req->remove_urr[i],
+        ogs_pfcp_tlv_remove_urr_t remove_urr;
+
+        if (upf_n4_parse_ie(&remove_urr, &ogs_pfcp_tlv_desc_remove_urr,
+                    req, i, &cause_value, &offending_ie_value) == false)
+            goto cleanup;
+
+        if (ogs_pfcp_handle_remove_urr(&sess->pfcp, &remove_urr,
                 &cause_value, &offending_ie_value) == false)
             break;
     }
@@ -341,7 +462,13 @@ void upf_n4_handle_session_modification_request(
         goto cleanup;
 
     for (i = 0; i < OGS_MAX_NUM_OF_QER; i++) {
-        if (ogs_pfcp_handle_create_qer(&sess->pfcp, &req->create_qer[i],
+        ogs_pfcp_tlv_create_qer_t create_qer;
+
+        if (upf_n4_parse_ie(&create_qer, &ogs_pfcp_tlv_desc_create_qer,
+                    req, i, &cause_value, &offending_ie_value) == false)
+            goto cleanup;
+
+        if (ogs_pfcp_handle_create_qer(&sess->pfcp, &create_qer,
                     &cause_value, &offending_ie_value) == NULL)
             break;
         upf_metrics_inst_by_dnn_add(sess->apn_dnn,
@@ -351,7 +478,13 @@ void upf_n4_handle_session_modification_request(
         goto cleanup;
 
     for (i = 0; i < OGS_MAX_NUM_OF_QER; i++) {
-        if (ogs_pfcp_handle_update_qer(&sess->pfcp, &req->update_qer[i],
+        ogs_pfcp_tlv_update_qer_t update_qer;
+
+        if (upf_n4_parse_ie(&update_qer, &ogs_pfcp_tlv_desc_update_qer,
+                    req, i, &cause_value, &offending_ie_value) == false)
+            goto cleanup;
+
+        if (ogs_pfcp_handle_update_qer(&sess->pfcp, &update_qer,
                     &cause_value, &offending_ie_value) == NULL)
             break;
     }
@@ -359,7 +492,13 @@ void upf_n4_handle_session_modification_request(
         goto cleanup;
 
     for (i = 0; i < OGS_MAX_NUM_OF_QER; i++) {
-        if (ogs_pfcp_handle_remove_qer(&sess->pfcp, &req->remove_qer[i],
+        ogs_pfcp_tlv_remove_qer_t remove_qer;
+
+        if (upf_n4_parse_ie(&remove_qer, &ogs_pfcp_tlv_desc_remove_qer,
+                    req, i, &cause_value, &offending_ie_value) == false)
+            goto cleanup;
+
+        if (ogs_pfcp_handle_remove_qer(&sess->pfcp, &remove_qer,
                 &cause_value, &offending_ie_value) == false)
             break;
         upf_metrics_inst_by_dnn_add(sess->apn_dnn,
@@ -368,12 +507,18 @@ void upf_n4_handle_session_modification_request(
     if (cause_value != OGS_PFCP_CAUSE_REQUEST_ACCEPTED)
         goto cleanup;
 
-    ogs_pfcp_handle_create_bar(&sess->pfcp, &req->create_bar,
+    if (upf_n4_parse_ie(&create_bar, &ogs_pfcp_tlv_desc_create_bar,
+                req, 0, &cause_value, &offending_ie_value) == false)
+        goto cleanup;
+    ogs_pfcp_handle_create_bar(&sess->pfcp, &create_bar,
                 &cause_value, &offending_ie_value);
     if (cause_value != OGS_PFCP_CAUSE_REQUEST_ACCEPTED)
         goto cleanup;
 
-    ogs_pfcp_handle_remove_bar(&sess->pfcp, &req->remove_bar,
+    if (upf_n4_parse_ie(&remove_bar, &ogs_pfcp_tlv_desc_remove_bar,
+                req, 0, &cause_value, &offending_ie_value) == false)
+        goto cleanup;
+    ogs_pfcp_handle_remove_bar(&sess->pfcp, &remove_bar,
             &cause_value, &offending_ie_value);
     if (cause_value != OGS_PFCP_CAUSE_REQUEST_ACCEPTED)
         goto cleanup;
@@ -398,6 +543,10 @@ void upf_n4_handle_session_modification_request(
             ogs_pfcp_object_teid_hash_set(OGS_PFCP_OBJ_SESS_TYPE, pdr, false);
     }
 
+    /* Compile PDRs for the data plane, see rule-match.h */
+    if (ogs_pfcp_sess_classifier_build(&sess->pfcp) != OGS_OK)
+        ogs_warn("PDR classifier not compiled, walking PDR list");
+
     /* Send Buffered Packet to gNB/SGW */
     ogs_list_for_each(&sess->pfcp.pdr_list, pdr) {
         if (pdr->src_if == OGS_PFCP_INTERFACE_CORE) { /* Downlink */
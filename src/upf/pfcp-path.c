@@ -21,6 +21,7 @@
 
 #include "pfcp-path.h"
 #include "n4-build.h"
+#include "worker.h"
 
 static void pfcp_node_fsm_init(ogs_pfcp_node_t *node, bool try_to_assoicate)
 {
@@ -293,11 +294,15 @@ int upf_pfcp_send_session_report_request(
     ogs_pfcp_header_t h;
     ogs_pfcp_xact_t *xact = NULL;
 
-    upf_metrics_inst_global_inc(UPF_METR_GLOB_CTR_SM_N4SESSIONREPORT);
-
     ogs_assert(sess);
     ogs_assert(report);
 
+    /* PFCP transactions belong to the main thread */
+    if (upf_worker_self())
+        return upf_worker_defer_report(sess, report);
+
+    upf_metrics_inst_global_inc(UPF_METR_GLOB_CTR_SM_N4SESSIONREPORT);
+
     memset(&h, 0, sizeof(ogs_pfcp_header_t));
     h.type = OGS_PFCP_SESSION_REPORT_REQUEST_TYPE;
     h.seid = sess->smf_n4_f_seid.seid;
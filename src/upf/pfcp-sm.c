@@ -72,7 +72,9 @@ void upf_pfcp_state_will_associate(ogs_fsm_t *s, upf_event_t *e)
 
     ogs_pfcp_node_t *node = NULL;
     ogs_pfcp_xact_t *xact = NULL;
+    ogs_pfcp_header_t *h = NULL;
     ogs_pfcp_message_t *message = NULL;
+    ogs_pfcp_index_message_t *index_message = NULL;
     ogs_sockaddr_t *addr = NULL;
     ogs_assert(s);
     ogs_assert(e);
@@ -121,11 +123,13 @@ void upf_pfcp_state_will_associate(ogs_fsm_t *s, upf_event_t *e)
         break;
     case UPF_EVT_N4_MESSAGE:
         message = e->pfcp_message;
-        ogs_assert(message);
+        index_message = e->pfcp_index_message;
+        ogs_assert(message || index_message);
+        h = message ? &message->h : &index_message->h;
         xact = e->pfcp_xact;
         ogs_assert(xact);
 
-        switch (message->h.type) {
+        switch (h->type) {
         case OGS_PFCP_HEARTBEAT_REQUEST_TYPE:
             ogs_expect(true ==
                 ogs_pfcp_handle_heartbeat_request(node, xact,
@@ -147,8 +151,7 @@ void upf_pfcp_state_will_associate(ogs_fsm_t *s, upf_event_t *e)
             OGS_FSM_TRAN(s, upf_pfcp_state_associated);
             break;
         default:
-            ogs_warn("cannot handle PFCP message type[%d]",
-                    message->h.type);
+            ogs_warn("cannot handle PFCP message type[%d]", h->type);
             break;
         }
         break;
@@ -164,7 +167,9 @@ void upf_pfcp_state_associated(ogs_fsm_t *s, upf_event_t *e)
 
     ogs_pfcp_node_t *node = NULL;
     ogs_pfcp_xact_t *xact = NULL;
+    ogs_pfcp_header_t *h = NULL;
     ogs_pfcp_message_t *message = NULL;
+    ogs_pfcp_index_message_t *index_message = NULL;
 
     ogs_sockaddr_t *addr = NULL;
     upf_sess_t *sess = NULL;
@@ -203,14 +208,16 @@ void upf_pfcp_state_associated(ogs_fsm_t *s, upf_event_t *e)
         break;
     case UPF_EVT_N4_MESSAGE:
         message = e->pfcp_message;
-        ogs_assert(message);
+        index_message = e->pfcp_index_message;
+        ogs_assert(message || index_message);
+        h = message ? &message->h : &index_message->h;
         xact = e->pfcp_xact;
         ogs_assert(xact);
 
-        if (message->h.seid_presence && message->h.seid != 0)
-            sess = upf_sess_find_by_upf_n4_seid(message->h.seid);
+        if (h->seid_presence && h->seid != 0)
+            sess = upf_sess_find_by_upf_n4_seid(h->seid);
 
-        switch (message->h.type) {
+        switch (h->type) {
         case OGS_PFCP_HEARTBEAT_REQUEST_TYPE:
             ogs_expect(true ==
                 ogs_pfcp_handle_heartbeat_request(node, xact,
@@ -281,15 +288,17 @@ void upf_pfcp_state_associated(ogs_fsm_t *s, upf_event_t *e)
                     &message->pfcp_association_setup_response);
             break;
         case OGS_PFCP_SESSION_ESTABLISHMENT_REQUEST_TYPE:
-            sess = upf_sess_add_by_message(message);
+            ogs_assert(index_message);
+            sess = upf_sess_add_by_message(index_message);
             if (sess)
                 OGS_SETUP_PFCP_NODE(sess, node);
             upf_n4_handle_session_establishment_request(
-                sess, xact, &message->pfcp_session_establishment_request);
+                sess, xact, index_message);
             break;
         case OGS_PFCP_SESSION_MODIFICATION_REQUEST_TYPE:
+            ogs_assert(index_message);
             upf_n4_handle_session_modification_request(
-                sess, xact, &message->pfcp_session_modification_request);
+                sess, xact, index_message);
             break;
         case OGS_PFCP_SESSION_DELETION_REQUEST_TYPE:
             upf_n4_handle_session_deletion_request(
@@ -300,8 +309,7 @@ void upf_pfcp_state_associated(ogs_fsm_t *s, upf_event_t *e)
                 sess, xact, &message->pfcp_session_report_response);
             break;
         default:
-            ogs_error("Not implemented PFCP message type[%d]",
-                    message->h.type);
+            ogs_error("Not implemented PFCP message type[%d]", h->type);
             break;
         }
 
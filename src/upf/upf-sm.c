@@ -44,7 +44,9 @@ void upf_state_operational(ogs_fsm_t *s, upf_event_t *e)
     int rv;
     ogs_pkbuf_t *recvbuf = NULL;
 
+    ogs_pfcp_header_t *h = NULL;
     ogs_pfcp_message_t *pfcp_message = NULL;
+    ogs_pfcp_index_message_t *pfcp_index_message = NULL;
     ogs_pfcp_node_t *node = NULL;
     ogs_pfcp_xact_t *xact = NULL;
 
@@ -67,26 +69,53 @@ void upf_state_operational(ogs_fsm_t *s, upf_event_t *e)
         ogs_assert(node);
 
         /*
-         * Issue #1911
+         * Session Establishment/Modification Request are indexed only,
+         * and the handlers decode the IEs one at a time. This avoids
+         * clearing and filling the whole ogs_pfcp_message_t for
+         * the most frequent PFCP messages.
          *
-         * Because ogs_pfcp_message_t is over 80kb in size,
-         * it can cause stack overflow.
-         * To avoid this, the pfcp_message structure uses heap memory.
+         * Anything shorter than a session header is left to
+         * ogs_pfcp_parse_msg(), which validates it.
          */
-        if ((pfcp_message = ogs_pfcp_parse_msg(recvbuf)) == NULL) {
-            ogs_error("ogs_pfcp_parse_msg() failed");
-            ogs_pkbuf_free(recvbuf);
-            break;
+        h = (ogs_pfcp_header_t *)recvbuf->data;
+        if (recvbuf->len >= OGS_PFCP_HEADER_LEN &&
+            (h->type == OGS_PFCP_SESSION_ESTABLISHMENT_REQUEST_TYPE ||
+             h->type == OGS_PFCP_SESSION_MODIFICATION_REQUEST_TYPE)) {
+            pfcp_index_message = ogs_pfcp_index_msg(recvbuf);
+            if (!pfcp_index_message) {
+                ogs_error("ogs_pfcp_index_msg() failed");
+                ogs_pkbuf_free(recvbuf);
+                break;
+            }
+            h = &pfcp_index_message->h;
+        } else {
+            /*
+             * Issue #1911
+             *
+             * Because ogs_pfcp_message_t is over 80kb in size,
+             * it can cause stack overflow.
+             * To avoid this, the pfcp_message structure uses heap memory.
+             */
+            if ((pfcp_message = ogs_pfcp_parse_msg(recvbuf)) == NULL) {
+                ogs_error("ogs_pfcp_parse_msg() failed");
+                ogs_pkbuf_free(recvbuf);
+                break;
+            }
+            h = &pfcp_message->h;
         }
 
-        rv = ogs_pfcp_xact_receive(node, &pfcp_message->h, &xact);
+        rv = ogs_pfcp_xact_receive(node, h, &xact);
         if (rv != OGS_OK) {
             ogs_pkbuf_free(recvbuf);
-            ogs_pfcp_message_free(pfcp_message);
+            if (pfcp_message)
+                ogs_pfcp_message_free(pfcp_message);
+            if (pfcp_index_message)
+                ogs_pfcp_index_message_free(pfcp_index_message);
             break;
         }
 
         e->pfcp_message = pfcp_message;
+        e->pfcp_index_message = pfcp_index_message;
         e->pfcp_xact = xact;
         ogs_fsm_dispatch(&node->sm, e);
         if (OGS_FSM_CHECK(&node->sm, upf_pfcp_state_exception)) {
@@ -94,7 +123,10 @@ void upf_state_operational(ogs_fsm_t *s, upf_event_t *e)
         }
 
         ogs_pkbuf_free(recvbuf);
-        ogs_pfcp_message_free(pfcp_message);
+        if (pfcp_message)
+            ogs_pfcp_message_free(pfcp_message);
+        if (pfcp_index_message)
+            ogs_pfcp_index_message_free(pfcp_index_message);
         break;
     case UPF_EVT_N4_TIMER:
     case UPF_EVT_N4_NO_HEARTBEAT:
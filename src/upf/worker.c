@@ -0,0 +1,391 @@
+/*
+ * Copyright (C) 2019-2023 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "worker.h"
+#include "gtp-path.h"
+#include "pfcp-path.h"
+
+#if HAVE_LINUX_FILTER_H
+#include <linux/filter.h>
+#endif
+
+typedef struct upf_worker_deferred_s {
+    ogs_lnode_t lnode;
+
+    uint64_t upf_n4_seid;
+
+    bool urr_threshold;
+    ogs_pfcp_urr_id_t urr_id;
+
+    ogs_pfcp_user_plane_report_t report;
+} upf_worker_deferred_t;
+
+static upf_worker_t *worker_array = NULL;
+static int num_of_worker = 0;
+
+static OGS_THREAD_LOCAL upf_worker_t *self_worker = NULL;
+
+static void worker_main(void *data)
+{
+    upf_worker_t *worker = data;
+    ogs_assert(worker);
+
+    self_worker = worker;
+    upf_metrics_dp_attach(1 + worker->index);
+
+    while (!worker->stop) {
+        upf_sess_dp_clock_reset();
+        ogs_pollset_poll(worker->pollset, OGS_INFINITE_TIME);
+    }
+
+    self_worker = NULL;
+}
+
+/*
+ * All G-PDUs from one gNB share the same UDP 4-tuple, so the default
+ * SO_REUSEPORT hash would put them on a single worker.
+ * Select the socket by TEID instead. The program sees the UDP payload,
+ * and sockets are indexed in bind order, i.e. by worker index.
+ */
+static void steer_by_teid(ogs_sock_t *sock)
+{
+#if HAVE_LINUX_FILTER_H && defined(SO_ATTACH_REUSEPORT_CBPF)
+    struct sock_filter code[] = {
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 4),  /* A = TEID */
+        BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, num_of_worker),
+        BPF_STMT(BPF_RET | BPF_A, 0),
+    };
+    struct sock_fprog prog = {
+        .len = OGS_ARRAY_SIZE(code),
+        .filter = code,
+    };
+
+    ogs_assert(sock);
+
+    if (setsockopt(sock->fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF,
+                &prog, sizeof(prog)) != 0)
+        ogs_log_message(OGS_LOG_WARN, ogs_socket_errno,
+                "setsockopt(SO_ATTACH_REUSEPORT_CBPF) failed, "
+                "use the kernel flow hash");
+#endif
+}
+
+static int worker_open(upf_worker_t *worker)
+{
+    ogs_socknode_t *node = NULL;
+    ogs_pfcp_dev_t *dev = NULL;
+    int i = 0;
+
+    ogs_assert(worker);
+
+    if (worker->index == 0) {
+        ogs_list_for_each(&ogs_gtp_self()->gtpu_list, node) {
+            ogs_assert(node->sock);
+            node->poll = upf_gtp_add_gtpu_poll(worker->pollset, node);
+            ogs_assert(node->poll);
+        }
+        ogs_list_for_each(&ogs_pfcp_self()->dev_list, dev) {
+            dev->poll = upf_gtp_add_tun_poll(worker->pollset, dev, dev->fd);
+            ogs_assert(dev->poll);
+        }
+        return OGS_OK;
+    }
+
+    ogs_list_for_each(&ogs_gtp_self()->gtpu_list, node) {
+        ogs_socknode_t *wnode = NULL;
+        ogs_sockaddr_t addr;
+
+        ogs_assert(node->sock);
+
+        /* Bind exactly the address the first socket was bound to */
+        memcpy(&addr, &node->sock->local_addr, sizeof(addr));
+        addr.fqdn = NULL;
+        addr.next = NULL;
+
+        wnode = ogs_socknode_add(
+                &worker->gtpu_list, AF_UNSPEC, &addr, node->option);
+        ogs_assert(wnode);
+
+        if (!ogs_gtp_server(wnode)) return OGS_ERROR;
+
+        wnode->poll = upf_gtp_add_gtpu_poll(worker->pollset, wnode);
+        ogs_assert(wnode->poll);
+    }
+
+    ogs_list_for_each(&ogs_pfcp_self()->dev_list, dev) {
+        ogs_assert(i < OGS_MAX_NUM_OF_DEV);
+
+        if (dev->offload)
+            worker->tun_fd[i] = ogs_tun_open_offload(
+                    dev->ifname, OGS_MAX_IFNAME_LEN, true);
+        else
+            worker->tun_fd[i] = ogs_tun_open_multi_queue(
+                    dev->ifname, OGS_MAX_IFNAME_LEN, dev->is_tap);
+        if (worker->tun_fd[i] == INVALID_SOCKET) {
+            ogs_error("tun_open(dev:%s) failed", dev->ifname);
+            return OGS_ERROR;
+        }
+
+        worker->tun_poll[i] = upf_gtp_add_tun_poll(
+                worker->pollset, dev, worker->tun_fd[i]);
+        ogs_assert(worker->tun_poll[i]);
+
+        i++;
+    }
+
+    return OGS_OK;
+}
+
+static void worker_close(upf_worker_t *worker)
+{
+    ogs_socknode_t *node = NULL;
+    ogs_pfcp_dev_t *dev = NULL;
+    upf_worker_deferred_t *deferred = NULL, *next_deferred = NULL;
+    int i;
+
+    ogs_assert(worker);
+
+    if (worker->index == 0) {
+        /* The sockets and TUN queues are closed by upf_gtp_close() */
+        ogs_list_for_each(&ogs_gtp_self()->gtpu_list, node)
+            upf_gtp_remove_gtpu_poll(node);
+        ogs_list_for_each(&ogs_pfcp_self()->dev_list, dev) {
+            if (dev->poll) {
+                ogs_pollset_remove(dev->poll);
+                dev->poll = NULL;
+            }
+        }
+    } else {
+        ogs_list_for_each(&worker->gtpu_list, node)
+            upf_gtp_remove_gtpu_poll(node);
+        ogs_socknode_remove_all(&worker->gtpu_list);
+
+        for (i = 0; i < OGS_MAX_NUM_OF_DEV; i++) {
+            if (worker->tun_poll[i])
+                ogs_pollset_remove(worker->tun_poll[i]);
+            if (worker->tun_fd[i] != INVALID_SOCKET)
+                ogs_closesocket(worker->tun_fd[i]);
+        }
+    }
+
+    for (i = 0; i < OGS_MAX_NUM_OF_SOCKMSG; i++) {
+        if (worker->rx_batch[i])
+            ogs_pkbuf_free(worker->rx_batch[i]);
+    }
+
+    ogs_list_for_each_safe(&worker->deferred_list, next_deferred, deferred) {
+        ogs_list_remove(&worker->deferred_list, deferred);
+        ogs_free(deferred);
+    }
+
+    if (worker->pollset)
+        ogs_pollset_destroy(worker->pollset);
+
+    ogs_thread_mutex_destroy(&worker->mutex);
+}
+
+int upf_worker_open(void)
+{
+    ogs_socknode_t *node = NULL;
+    unsigned int capacity;
+    int i, rv;
+
+    num_of_worker = upf_self()->num_of_worker;
+    if (!num_of_worker)
+        return OGS_OK;
+
+    worker_array = ogs_calloc(num_of_worker, sizeof(upf_worker_t));
+    ogs_assert(worker_array);
+
+    /* GTP-U sockets + TUN queues + notify */
+    capacity = ogs_list_count(&ogs_gtp_self()->gtpu_list) +
+                OGS_MAX_NUM_OF_DEV + 1;
+
+    for (i = 0; i < num_of_worker; i++) {
+        upf_worker_t *worker = &worker_array[i];
+        int j;
+
+        worker->index = i;
+        ogs_thread_mutex_init(&worker->mutex);
+        ogs_list_init(&worker->gtpu_list);
+        ogs_list_init(&worker->deferred_list);
+        for (j = 0; j < OGS_MAX_NUM_OF_DEV; j++)
+            worker->tun_fd[j] = INVALID_SOCKET;
+
+        worker->pollset = ogs_pollset_create(capacity);
+        ogs_assert(worker->pollset);
+
+        rv = worker_open(worker);
+        if (rv != OGS_OK) return rv;
+    }
+
+    ogs_list_for_each(&ogs_gtp_self()->gtpu_list, node)
+        steer_by_teid(node->sock);
+
+    for (i = 0; i < num_of_worker; i++) {
+        upf_worker_t *worker = &worker_array[i];
+
+        worker->thread = ogs_thread_create(worker_main, worker);
+        if (!worker->thread) return OGS_ERROR;
+    }
+
+    ogs_info("%d data plane workers started", num_of_worker);
+
+    return OGS_OK;
+}
+
+void upf_worker_close(void)
+{
+    int i;
+
+    if (!worker_array)
+        return;
+
+    for (i = 0; i < num_of_worker; i++) {
+        upf_worker_t *worker = &worker_array[i];
+
+        if (worker->thread) {
+            worker->stop = true;
+            ogs_pollset_notify(worker->pollset);
+        }
+    }
+
+    for (i = 0; i < num_of_worker; i++) {
+        upf_worker_t *worker = &worker_array[i];
+
+        if (worker->thread)
+            ogs_thread_destroy(worker->thread);
+        worker_close(worker);
+    }
+
+    ogs_free(worker_array);
+    worker_array = NULL;
+    num_of_worker = 0;
+}
+
+upf_worker_t *upf_worker_self(void)
+{
+    return self_worker;
+}
+
+void upf_worker_lock(void)
+{
+    if (self_worker)
+        ogs_thread_mutex_lock(&self_worker->mutex);
+}
+
+void upf_worker_unlock(void)
+{
+    if (self_worker)
+        ogs_thread_mutex_unlock(&self_worker->mutex);
+}
+
+void upf_worker_lock_all(void)
+{
+    int i;
+
+    for (i = 0; i < num_of_worker; i++)
+        ogs_thread_mutex_lock(&worker_array[i].mutex);
+}
+
+void upf_worker_unlock_all(void)
+{
+    int i;
+
+    for (i = num_of_worker - 1; i >= 0; i--)
+        ogs_thread_mutex_unlock(&worker_array[i].mutex);
+}
+
+static upf_worker_deferred_t *deferred_add(upf_sess_t *sess)
+{
+    upf_worker_deferred_t *deferred = NULL;
+
+    ogs_assert(self_worker);
+    ogs_assert(sess);
+
+    deferred = ogs_calloc(1, sizeof(*deferred));
+    ogs_assert(deferred);
+
+    deferred->upf_n4_seid = sess->upf_n4_seid;
+
+    /* Protected by the worker mutex held during packet handling */
+    ogs_list_add(&self_worker->deferred_list, deferred);
+    ogs_pollset_notify(ogs_app()->pollset);
+
+    return deferred;
+}
+
+int upf_worker_defer_report(
+        upf_sess_t *sess, ogs_pfcp_user_plane_report_t *report)
+{
+    upf_worker_deferred_t *deferred = NULL;
+
+    ogs_assert(report);
+
+    deferred = deferred_add(sess);
+    memcpy(&deferred->report, report, sizeof(*report));
+
+    return OGS_OK;
+}
+
+void upf_worker_defer_urr_threshold(upf_sess_t *sess, ogs_pfcp_urr_t *urr)
+{
+    upf_worker_deferred_t *deferred = NULL;
+
+    ogs_assert(urr);
+
+    deferred = deferred_add(sess);
+    deferred->urr_threshold = true;
+    deferred->urr_id = urr->id;
+}
+
+/* Called by the main thread with all worker mutexes held */
+void upf_worker_handle_deferred(void)
+{
+    int i;
+
+    ogs_assert(!self_worker);
+
+    for (i = 0; i < num_of_worker; i++) {
+        upf_worker_t *worker = &worker_array[i];
+        upf_worker_deferred_t *deferred = NULL, *next_deferred = NULL;
+
+        ogs_list_for_each_safe(
+                &worker->deferred_list, next_deferred, deferred) {
+            upf_sess_t *sess = NULL;
+
+            ogs_list_remove(&worker->deferred_list, deferred);
+
+            /* The session may be gone by now */
+            sess = upf_sess_find_by_upf_n4_seid(deferred->upf_n4_seid);
+            if (sess && deferred->urr_threshold) {
+                ogs_pfcp_urr_t *urr =
+                    ogs_pfcp_urr_find(&sess->pfcp, deferred->urr_id);
+                if (urr)
+                    upf_sess_urr_acc_check_threshold(sess, urr);
+            } else if (sess) {
+                ogs_assert(OGS_OK ==
+                    upf_pfcp_send_session_report_request(
+                        sess, &deferred->report));
+            }
+
+            ogs_free(deferred);
+        }
+    }
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2019-2023 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPF_WORKER_H
+#define UPF_WORKER_H
+
+#include "context.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Data plane worker
+ *
+ * With `upf.worker: N`, N threads handle GTP-U and TUN traffic
+ * while the main thread keeps PFCP, timers and the event queue.
+ *
+ * - GTP-U : every worker binds its own SO_REUSEPORT socket
+ *           and the kernel steers G-PDUs by TEID.
+ * - TUN   : every worker reads its own IFF_MULTI_QUEUE queue.
+ *
+ * A worker holds its own mutex while handling packets. Before
+ * touching PFCP state, the main thread takes the mutex of all workers,
+ * so workers never see a half-updated PDR/FAR/TEID table.
+ * The mutex is taken once per wakeup, not per packet.
+ *
+ * Workers never send PFCP. Session reports are queued on the worker
+ * and sent by the main thread in upf_worker_handle_deferred().
+ */
+typedef struct upf_worker_s {
+    int index;
+
+    ogs_thread_t *thread;
+    ogs_pollset_t *pollset;
+    volatile bool stop;
+
+    ogs_thread_mutex_t mutex;
+
+    /* Worker 0 uses the sockets and TUN queues opened by upf_gtp_open() */
+    ogs_list_t gtpu_list;
+    ogs_socket_t tun_fd[OGS_MAX_NUM_OF_DEV];
+    ogs_poll_t *tun_poll[OGS_MAX_NUM_OF_DEV];
+
+    ogs_pkbuf_t *rx_batch[OGS_MAX_NUM_OF_SOCKMSG];
+
+    ogs_list_t deferred_list;
+} upf_worker_t;
+
+int upf_worker_open(void);
+void upf_worker_close(void);
+
+upf_worker_t *upf_worker_self(void);
+
+void upf_worker_lock(void);
+void upf_worker_unlock(void);
+void upf_worker_lock_all(void);
+void upf_worker_unlock_all(void);
+
+int upf_worker_defer_report(
+        upf_sess_t *sess, ogs_pfcp_user_plane_report_t *report);
+void upf_worker_defer_urr_threshold(upf_sess_t *sess, ogs_pfcp_urr_t *urr);
+void upf_worker_handle_deferred(void);
+
+/* Two workers may handle the uplink and downlink of the same session */
+static ogs_inline void upf_sess_dp_lock(upf_sess_t *sess)
+{
+    if (upf_worker_self())
+        ogs_thread_mutex_lock(&sess->dp_mutex);
+}
+
+static ogs_inline void upf_sess_dp_unlock(upf_sess_t *sess)
+{
+    if (upf_worker_self())
+        ogs_thread_mutex_unlock(&sess->dp_mutex);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UPF_WORKER_H */
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2019-2023 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "bench.h"
+
+extern int __ogs_gtp_domain;
+extern int __ogs_pfcp_domain;
+
+void bench_pkbuf(void);
+void bench_lpm(void);
+void bench_memory(void);
+void bench_timer(void);
+void bench_hash(void);
+void bench_sbi(void);
+
+const struct benchlist {
+    void (*func)(void);
+} allbenches[] = {
+    {bench_pkbuf},
+    {bench_lpm},
+    {bench_memory},
+    {bench_timer},
+    {bench_hash},
+    {bench_sbi},
+    {NULL},
+};
+
+static const char *filter = NULL;
+
+void bench_run(const char *name,
+        int iterations, bench_func_f func, void *data)
+{
+    ogs_time_t start, elapsed;
+    int i;
+
+    ogs_assert(name);
+    ogs_assert(iterations > 0);
+    ogs_assert(func);
+
+    if (filter && !strstr(name, filter))
+        return;
+
+    /* Warm up caches and pools */
+    for (i = 0; i < iterations / 10; i++)
+        func(data);
+
+    start = ogs_get_monotonic_time();
+    for (i = 0; i < iterations; i++)
+        func(data);
+    elapsed = ogs_get_monotonic_time() - start;
+
+    printf("%-40s %10d iter %10.1f ns/op\n", name, iterations,
+            (double)elapsed * 1000 / iterations);
+}
+
+static void terminate(void)
+{
+    ogs_pkbuf_default_destroy();
+    ogs_core_terminate();
+}
+
+int main(int argc, const char *const argv[])
+{
+    int i;
+    ogs_pkbuf_config_t config;
+
+    if (argc > 1)
+        filter = argv[1];
+
+    ogs_core_initialize();
+    ogs_pkbuf_default_init(&config);
+    ogs_pkbuf_default_create(&config);
+    atexit(terminate);
+
+    ogs_log_install_domain(&__ogs_gtp_domain, "gtp", OGS_LOG_ERROR);
+    ogs_log_install_domain(&__ogs_pfcp_domain, "pfcp", OGS_LOG_ERROR);
+
+    for (i = 0; allbenches[i].func; i++)
+        allbenches[i].func();
+
+    return 0;
+}
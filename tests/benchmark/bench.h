@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2019-2023 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEST_BENCH_H
+#define TEST_BENCH_H
+
+#include "ogs-core.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*bench_func_f)(void *data);
+
+/*
+ * Call func() 'iterations' times and print the cost per call.
+ * Skipped unless the name contains the filter given on the command line.
+ */
+void bench_run(const char *name,
+        int iterations, bench_func_f func, void *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEST_BENCH_H */
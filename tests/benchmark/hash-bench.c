@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2019-2023 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "bench.h"
+
+/*
+ * Lookups of sessions by TEID (4 bytes), SEID (8 bytes) and IMSI
+ * (string), as done for every packet or message, and the insertion and
+ * removal of a session.
+ */
+#define BENCH_NUM_OF_KEY 100000
+
+typedef struct bench_hash_s {
+    ogs_hash_t *hash;
+    int klen;
+    unsigned int next;
+
+    uint32_t teid[BENCH_NUM_OF_KEY];
+    uint64_t seid[BENCH_NUM_OF_KEY];
+    char imsi[BENCH_NUM_OF_KEY][16];
+} bench_hash_t;
+
+static const void *bench_key(bench_hash_t *bench, unsigned int i)
+{
+    switch (bench->klen) {
+    case sizeof(uint32_t):
+        return &bench->teid[i];
+    case sizeof(uint64_t):
+        return &bench->seid[i];
+    default:
+        return bench->imsi[i];
+    }
+}
+
+static void hash_fill(bench_hash_t *bench, int klen)
+{
+    int i;
+
+    bench->hash = ogs_hash_make();
+    ogs_assert(bench->hash);
+    bench->klen = klen;
+
+    /* Every other key is left out for the misses */
+    for (i = 0; i < BENCH_NUM_OF_KEY; i += 2)
+        ogs_hash_set(bench->hash, bench_key(bench, i), klen, bench);
+}
+
+/* Spread the accesses over the table, not to measure the cache only */
+static unsigned int hash_next(bench_hash_t *bench)
+{
+    bench->next = (bench->next + 7919 * 2) % BENCH_NUM_OF_KEY;
+    return bench->next;
+}
+
+static void get_hit(void *data)
+{
+    bench_hash_t *bench = data;
+
+    ogs_assert(ogs_hash_get(bench->hash,
+                bench_key(bench, hash_next(bench)), bench->klen));
+}
+
+static void get_miss(void *data)
+{
+    bench_hash_t *bench = data;
+
+    ogs_assert(!ogs_hash_get(bench->hash,
+                bench_key(bench, hash_next(bench) + 1), bench->klen));
+}
+
+static void set_delete(void *data)
+{
+    bench_hash_t *bench = data;
+    const void *key = bench_key(bench, hash_next(bench) + 1);
+
+    ogs_hash_set(bench->hash, key, bench->klen, bench);
+    ogs_hash_set(bench->hash, key, bench->klen, NULL);
+}
+
+void bench_hash(void)
+{
+    static const struct {
+        const char *name;
+        int klen;
+    } keys[] = {
+        { "teid", sizeof(uint32_t) },
+        { "seid", sizeof(uint64_t) },
+        { "imsi", OGS_HASH_KEY_STRING },
+    };
+    bench_hash_t *bench = NULL;
+    char name[64];
+    unsigned int i;
+
+    bench = ogs_calloc(1, sizeof(*bench));
+    ogs_assert(bench);
+
+    for (i = 0; i < BENCH_NUM_OF_KEY; i++) {
+        /* Scattered, but unique for the misses */
+        bench->teid[i] = i * 2654435761U;
+        bench->seid[i] = ((uint64_t)ogs_random32() << 32) | i;
+        ogs_snprintf(bench->imsi[i], sizeof(bench->imsi[i]),
+                "0010100%08d", i);
+    }
+
+    for (i = 0; i < OGS_ARRAY_SIZE(keys); i++) {
+        hash_fill(bench, keys[i].klen);
+
+        ogs_snprintf(name, sizeof(name), "hash/get-hit-%s-50k", keys[i].name);
+        bench_run(name, 1000000, get_hit, bench);
+        ogs_snprintf(name, sizeof(name), "hash/get-miss-%s-50k", keys[i].name);
+        bench_run(name, 1000000, get_miss, bench);
+        ogs_snprintf(name, sizeof(name), "hash/set-delete-%s-50k",
+                keys[i].name);
+        bench_run(name, 1000000, set_delete, bench);
+
+        ogs_hash_destroy(bench->hash);
+    }
+
+    ogs_free(bench);
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2019-2023 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "bench.h"
+
+/*
+ * Downlink session lookup in the UPF, upf_sess_find_by_ipv4/ipv6():
+ * 1M UEs allocated in order from 10.0.0.0/12 and 2001:db8::/44,
+ * looked up at random. The hash table was used before the LPM table.
+ */
+#define BENCH_NUM_OF_SESS       (1024 * 1024)
+#define BENCH_NUM_OF_LOOKUP     (64 * 1024)
+
+typedef struct bench_lpm_s {
+    ogs_hash_t *hash;
+    ogs_lpm_t *lpm;
+    int klen;
+
+    uint8_t (*key)[16];
+    int next;
+} bench_lpm_t;
+
+static void ue_addr(int family, uint32_t index, uint8_t *addr)
+{
+    memset(addr, 0, 16);
+
+    if (family == AF_INET) {
+        uint32_t addr4 = htobe32(0x0a000000 | index);
+        memcpy(addr, &addr4, sizeof(addr4));
+    } else {
+        /* 2001:db8:0:XXXX::/64 with the high bits of the index in byte 5 */
+        addr[0] = 0x20; addr[1] = 0x01; addr[2] = 0x0d; addr[3] = 0xb8;
+        addr[5] = (index >> 16) & 0x0f;
+        addr[6] = (index >> 8) & 0xff;
+        addr[7] = index & 0xff;
+    }
+}
+
+static void setup(bench_lpm_t *bench, int family)
+{
+    uint8_t addr[16];
+    uint32_t i;
+
+    memset(bench, 0, sizeof(*bench));
+
+    bench->hash = ogs_hash_make();
+    ogs_assert(bench->hash);
+    bench->lpm = ogs_lpm_create(family == AF_INET ? 32 : 128);
+    ogs_assert(bench->lpm);
+    bench->klen = family == AF_INET ? 4 : 8;
+
+    for (i = 0; i < BENCH_NUM_OF_SESS; i++) {
+        /* Any non-NULL value stands for the session */
+        void *sess = (void *)(uintptr_t)(i + 1);
+
+        ue_addr(family, i, addr);
+        /* The key must outlive the hash entry */
+        ogs_hash_set(bench->hash,
+                ogs_memdup(addr, bench->klen), bench->klen, sess);
+        ogs_assert(OGS_OK ==
+                ogs_lpm_add(bench->lpm, addr, bench->klen << 3, sess));
+    }
+
+    bench->key = ogs_calloc(BENCH_NUM_OF_LOOKUP, sizeof(bench->key[0]));
+    ogs_assert(bench->key);
+    for (i = 0; i < BENCH_NUM_OF_LOOKUP; i++) {
+        ue_addr(family, ogs_random32() % BENCH_NUM_OF_SESS, bench->key[i]);
+        /* Interface identifier of the UE */
+        if (family == AF_INET6)
+            bench->key[i][15] = 1;
+    }
+}
+
+static void teardown(bench_lpm_t *bench)
+{
+    ogs_hash_index_t *hi = NULL;
+
+    for (hi = ogs_hash_first(bench->hash); hi; hi = ogs_hash_next(hi))
+        ogs_free((void *)ogs_hash_this_key(hi));
+    ogs_hash_destroy(bench->hash);
+    ogs_lpm_destroy(bench->lpm);
+    ogs_free(bench->key);
+}
+
+static void lookup_hash(void *data)
+{
+    bench_lpm_t *bench = data;
+    uint8_t *key = bench->key[bench->next++ % BENCH_NUM_OF_LOOKUP];
+
+    ogs_assert(ogs_hash_get(bench->hash, key, bench->klen));
+}
+
+static void lookup_lpm(void *data)
+{
+    bench_lpm_t *bench = data;
+    uint8_t *key = bench->key[bench->next++ % BENCH_NUM_OF_LOOKUP];
+
+    ogs_assert(ogs_lpm_find(bench->lpm, key));
+}
+
+void bench_lpm(void)
+{
+    bench_lpm_t bench;
+
+    setup(&bench, AF_INET);
+    bench_run("lpm/ipv4-1M-hash", 10000000, lookup_hash, &bench);
+    bench_run("lpm/ipv4-1M-lpm", 10000000, lookup_lpm, &bench);
+    teardown(&bench);
+
+    setup(&bench, AF_INET6);
+    bench_run("lpm/ipv6-1M-hash", 10000000, lookup_hash, &bench);
+    bench_run("lpm/ipv6-1M-lpm", 10000000, lookup_lpm, &bench);
+    teardown(&bench);
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2019-2023 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "bench.h"
+
+/*
+ * Building and freeing a message the way the SBI and OpenAPI code
+ * does: a burst of small allocations of mixed sizes, then freeing
+ * them all. ogs_malloc() went through talloc and the global mutex
+ * before the per-thread size classes.
+ */
+#define BENCH_BURST 16
+#define BENCH_NUM_OF_THREAD 4
+#define BENCH_THREAD_ITERATIONS 20000
+
+static const size_t burst_size[BENCH_BURST] = {
+    24, 48, 16, 200, 64, 32, 512, 40, 96, 24, 1500, 64, 128, 16, 300, 48
+};
+
+static void burst_talloc(void *data)
+{
+    void *ptr[BENCH_BURST];
+    int i;
+
+    for (i = 0; i < BENCH_BURST; i++) {
+        ptr[i] = ogs_talloc_size(
+                __ogs_talloc_core, burst_size[i], OGS_FILE_LINE);
+        ogs_assert(ptr[i]);
+    }
+    for (i = 0; i < BENCH_BURST; i++)
+        ogs_talloc_free(ptr[i], OGS_FILE_LINE);
+}
+
+static void burst_malloc(void *data)
+{
+    void *ptr[BENCH_BURST];
+    int i;
+
+    for (i = 0; i < BENCH_BURST; i++) {
+        ptr[i] = ogs_malloc(burst_size[i]);
+        ogs_assert(ptr[i]);
+    }
+    for (i = 0; i < BENCH_BURST; i++)
+        ogs_free(ptr[i]);
+}
+
+static void thread_main(void *data)
+{
+    bench_func_f *func = data;
+    int i;
+
+    for (i = 0; i < BENCH_THREAD_ITERATIONS; i++)
+        (*func)(NULL);
+}
+
+/* One iteration is BENCH_THREAD_ITERATIONS bursts in every thread */
+static void threads(void *data)
+{
+    ogs_thread_t *thread[BENCH_NUM_OF_THREAD];
+    int i;
+
+    for (i = 0; i < BENCH_NUM_OF_THREAD; i++) {
+        thread[i] = ogs_thread_create(thread_main, data);
+        ogs_assert(thread[i]);
+    }
+    for (i = 0; i < BENCH_NUM_OF_THREAD; i++)
+        ogs_thread_destroy(thread[i]);
+}
+
+void bench_memory(void)
+{
+    bench_func_f talloc_func = burst_talloc, malloc_func = burst_malloc;
+
+    bench_run("memory/burst-16-talloc", 1000000, burst_talloc, NULL);
+    bench_run("memory/burst-16-malloc", 1000000, burst_malloc, NULL);
+
+    bench_run("memory/4-threads-burst-16-talloc", 10,
+            threads, &talloc_func);
+    bench_run("memory/4-threads-burst-16-malloc", 10,
+            threads, &malloc_func);
+}
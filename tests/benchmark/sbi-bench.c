@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2019-2023 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "bench.h"
+#include "model/stream_model.h"
+
+/*
+ * Decoding and encoding of SBI message bodies, through a cJSON tree
+ * (OpenAPI_xxx_parseFromJSON/convertToJSON) and through the table-driven
+ * codec (OpenAPI_stream_parse/print). The bodies are hand-written after
+ * what the AMF, AUSF, UDM, SMF and PCF exchange for a registration and a PDU
+ * session establishment.
+ */
+typedef struct bench_sbi_s {
+    const char *name;
+    const OpenAPI_stream_model_t *model;
+    const char *json;
+    void *data;
+} bench_sbi_t;
+
+static bench_sbi_t corpus[] = {
+    { "ue-auth-ctx", &OpenAPI_ue_authentication_ctx_stream,
+        "{\"authType\":\"5G_AKA\",\"5gAuthData\":{"
+            "\"rand\":\"4a3d0f53a6e3c6b81db0b3c1e27f4a25\","
+            "\"hxresStar\":\"c3e2a97e0c6d4d0f4e1e86e3b1c2d5f7\","
+            "\"autn\":\"8a7d6d4c3b2a80001f3e5d7c9b1a0e2c\"},"
+        "\"_links\":{\"5g-aka\":{\"href\":\"http://127.0.0.11:7777/"
+            "nausf-auth/v1/ue-authentications/1/5g-aka-confirmation\"}},"
+        "\"servingNetworkName\":\"5G:mnc070.mcc999.3gppnetwork.org\"}",
+        NULL },
+
+    { "auth-info-result", &OpenAPI_authentication_info_result_stream,
+        "{\"authType\":\"5G_AKA\",\"authenticationVector\":{"
+            "\"avType\":\"5G_HE_AKA\","
+            "\"rand\":\"4a3d0f53a6e3c6b81db0b3c1e27f4a25\","
+            "\"xresStar\":\"0d5e1a2b3c4d5e6f708192a3b4c5d6e7\","
+            "\"autn\":\"8a7d6d4c3b2a80001f3e5d7c9b1a0e2c\","
+            "\"kausf\":\"1f2e3d4c5b6a79880f1e2d3c4b5a69788796a5b4c3d2e1f0"
+            "0f1e2d3c4b5a6978\"},"
+        "\"supi\":\"imsi-999700000000001\"}", NULL },
+
+    { "am-data", &OpenAPI_access_and_mobility_subscription_data_stream,
+        "{\"gpsis\":[\"msisdn-0900000000\"],"
+        "\"subscribedUeAmbr\":{\"uplink\":\"1048576 Kbps\","
+            "\"downlink\":\"1048576 Kbps\"},"
+        "\"nssai\":{\"defaultSingleNssais\":[{\"sst\":1},"
+            "{\"sst\":1,\"sd\":\"000080\"}],"
+            "\"singleNssais\":[{\"sst\":2,\"sd\":\"000001\"}]},"
+        "\"ratRestrictions\":[\"EUTRA\"],"
+        "\"rfspIndex\":1,\"subsRegTimer\":3600,\"ueUsageType\":0,"
+        "\"mpsPriority\":false,\"micoAllowed\":true,"
+        "\"subscribedDnnList\":[\"internet\",\"ims\"],"
+        "\"sharedVnGroupDataIds\":{\"1\":\"vn-group-1\"}}", NULL },
+
+    { "sm-context-create", &OpenAPI_sm_context_create_data_stream,
+        "{\"supi\":\"imsi-999700000000001\","
+        "\"pei\":\"imeisv-4370816125816151\","
+        "\"gpsi\":\"msisdn-0900000000\",\"pduSessionId\":5,"
+        "\"dnn\":\"internet\",\"sNssai\":{\"sst\":1,\"sd\":\"000080\"},"
+        "\"servingNfId\":\"6b4d1e3a-b5c2-41ed-9a3b-0242ac120005\","
+        "\"guami\":{\"plmnId\":{\"mcc\":\"999\",\"mnc\":\"70\"},"
+            "\"amfId\":\"020040\"},"
+        "\"servingNetwork\":{\"mcc\":\"999\",\"mnc\":\"70\"},"
+        "\"n1SmMsg\":{\"contentId\":\"5gnas-sm\"},"
+        "\"anType\":\"3GPP_ACCESS\",\"ratType\":\"NR\","
+        "\"ueLocation\":{\"nrLocation\":{"
+            "\"tai\":{\"plmnId\":{\"mcc\":\"999\",\"mnc\":\"70\"},"
+                "\"tac\":\"000001\"},"
+            "\"ncgi\":{\"plmnId\":{\"mcc\":\"999\",\"mnc\":\"70\"},"
+                "\"nrCellId\":\"000000010\"},"
+            "\"ueLocationTimestamp\":\"2023-03-01T09:00:00.000000Z\"}},"
+        "\"ueTimeZone\":\"+09:00\","
+        "\"smContextStatusUri\":\"http://127.0.0.5:7777/namf-callback/v1/"
+            "imsi-999700000000001/sm-context-status/5\","
+        "\"pcfId\":\"6b4d1e3a-b5c2-41ed-9a3b-0242ac120007\"}", NULL },
+
+    { "sm-policy-ctx", &OpenAPI_sm_policy_context_data_stream,
+        "{\"supi\":\"imsi-999700000000001\",\"gpsi\":\"msisdn-0900000000\","
+        "\"pduSessionId\":5,\"pduSessionType\":\"IPV4V6\","
+        "\"dnn\":\"internet\","
+        "\"notificationUri\":\"http://127.0.0.4:7777/nsmf-callback/v1/"
+            "sm-policy-notify/1\","
+        "\"accessType\":\"3GPP_ACCESS\",\"ratType\":\"NR\","
+        "\"servingNetwork\":{\"mcc\":\"999\",\"mnc\":\"70\"},"
+        "\"userLocationInfo\":{\"nrLocation\":{"
+            "\"tai\":{\"plmnId\":{\"mcc\":\"999\",\"mnc\":\"70\"},"
+                "\"tac\":\"000001\"},"
+            "\"ncgi\":{\"plmnId\":{\"mcc\":\"999\",\"mnc\":\"70\"},"
+                "\"nrCellId\":\"000000010\"},"
+            "\"ueLocationTimestamp\":\"2023-03-01T09:00:00.000000Z\"}},"
+        "\"ueTimeZone\":\"+09:00\",\"pei\":\"imeisv-4370816125816151\","
+        "\"ipv4Address\":\"10.45.0.2\","
+        "\"ipv6AddressPrefix\":\"2001:db8:cafe::/64\","
+        "\"subsSessAmbr\":{\"uplink\":\"1048576 Kbps\","
+            "\"downlink\":\"1048576 Kbps\"},"
+        "\"subsDefQos\":{\"5qi\":9,\"arp\":{\"priorityLevel\":8,"
+            "\"preemptCap\":\"NOT_PREEMPT\","
+            "\"preemptVuln\":\"NOT_PREEMPTABLE\"},"
+            "\"priorityLevel\":8},"
+        "\"sliceInfo\":{\"sst\":1,\"sd\":\"000080\"},"
+        "\"suppFeat\":\"4000000\"}", NULL },
+};
+
+static void parse_cjson(void *data)
+{
+    bench_sbi_t *bench = data;
+    cJSON *item = NULL;
+    void *model = NULL;
+
+    item = cJSON_Parse(bench->json);
+    ogs_assert(item);
+    model = bench->model->parseFromJSON(item);
+    ogs_assert(model);
+    cJSON_Delete(item);
+
+    bench->model->free(model);
+}
+
+static void parse_stream(void *data)
+{
+    bench_sbi_t *bench = data;
+    void *model = NULL;
+
+    model = OpenAPI_stream_parse(bench->model, bench->json);
+    ogs_assert(model);
+
+    bench->model->free(model);
+}
+
+static void print_cjson(void *data)
+{
+    bench_sbi_t *bench = data;
+    cJSON *item = NULL;
+    char *json = NULL;
+
+    item = bench->model->convertToJSON(bench->data);
+    ogs_assert(item);
+    json = cJSON_PrintUnformatted(item);
+    ogs_assert(json);
+    cJSON_Delete(item);
+
+    ogs_free(json);
+}
+
+static void print_stream(void *data)
+{
+    bench_sbi_t *bench = data;
+    char *json = NULL;
+
+    json = OpenAPI_stream_print(bench->model, bench->data);
+    ogs_assert(json);
+
+    ogs_free(json);
+}
+
+void bench_sbi(void)
+{
+    char name[64];
+    unsigned int i;
+
+    for (i = 0; i < OGS_ARRAY_SIZE(corpus); i++) {
+        bench_sbi_t *bench = &corpus[i];
+
+        /* Both codecs must take the whole body, not fall back */
+        ogs_assert(bench->model->num_of_fields > 0);
+        bench->data = OpenAPI_stream_parse(bench->model, bench->json);
+        ogs_assert(bench->data);
+
+        ogs_snprintf(name, sizeof(name), "sbi/parse-cjson-%s", bench->name);
+        bench_run(name, 100000, parse_cjson, bench);
+        ogs_snprintf(name, sizeof(name), "sbi/parse-stream-%s", bench->name);
+        bench_run(name, 100000, parse_stream, bench);
+        ogs_snprintf(name, sizeof(name), "sbi/print-cjson-%s", bench->name);
+        bench_run(name, 100000, print_cjson, bench);
+        ogs_snprintf(name, sizeof(name), "sbi/print-stream-%s", bench->name);
+        bench_run(name, 100000, print_stream, bench);
+
+        bench->model->free(bench->data);
+        bench->data = NULL;
+    }
+}
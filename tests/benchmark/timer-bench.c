@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2019-2023 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "bench.h"
+
+/*
+ * Guard timers of many sessions that are restarted on every message
+ * and rarely expire. Every restart removes a timer and inserts it
+ * again, which costs O(log n) in the rbtree and O(1) in the wheel.
+ */
+#define BENCH_NUM_OF_TIMER 100000
+
+typedef struct bench_timer_s {
+    ogs_timer_mgr_t *mgr;
+    ogs_timer_t *timer[BENCH_NUM_OF_TIMER];
+    unsigned int next;
+} bench_timer_t;
+
+static void expire_func(void *data)
+{
+}
+
+static bench_timer_t *timers_create(ogs_timer_mgr_t *mgr)
+{
+    bench_timer_t *bench = NULL;
+    int i;
+
+    ogs_assert(mgr);
+
+    bench = ogs_calloc(1, sizeof(*bench));
+    ogs_assert(bench);
+
+    bench->mgr = mgr;
+    for (i = 0; i < BENCH_NUM_OF_TIMER; i++) {
+        bench->timer[i] = ogs_timer_add(mgr, expire_func, NULL);
+        ogs_assert(bench->timer[i]);
+        ogs_timer_start(bench->timer[i],
+                ogs_time_from_sec(10) + ogs_random32() % ogs_time_from_sec(20));
+    }
+
+    return bench;
+}
+
+static void timers_destroy(bench_timer_t *bench)
+{
+    int i;
+
+    for (i = 0; i < BENCH_NUM_OF_TIMER; i++)
+        ogs_timer_delete(bench->timer[i]);
+    ogs_timer_mgr_destroy(bench->mgr);
+    ogs_free(bench);
+}
+
+/* Restart one timer, as on every message of a session */
+static void restart(void *data)
+{
+    bench_timer_t *bench = data;
+
+    bench->next = (bench->next + 7919) % BENCH_NUM_OF_TIMER;
+    ogs_timer_start(bench->timer[bench->next],
+            ogs_time_from_sec(10) + bench->next % ogs_time_from_sec(20));
+}
+
+/* One turn of the event loop without anything to expire */
+static void next_expire(void *data)
+{
+    bench_timer_t *bench = data;
+
+    restart(bench);
+    ogs_timer_mgr_next(bench->mgr);
+    ogs_timer_mgr_expire(bench->mgr);
+}
+
+void bench_timer(void)
+{
+    bench_timer_t *bench = NULL;
+
+    bench = timers_create(ogs_timer_mgr_create(BENCH_NUM_OF_TIMER));
+    bench_run("timer/restart-100k-rbtree", 1000000, restart, bench);
+    bench_run("timer/next-expire-100k-rbtree", 1000000, next_expire, bench);
+    timers_destroy(bench);
+
+    bench = timers_create(ogs_timer_mgr_create_wheel(BENCH_NUM_OF_TIMER));
+    bench_run("timer/restart-100k-wheel", 1000000, restart, bench);
+    bench_run("timer/next-expire-100k-wheel", 1000000, next_expire, bench);
+    timers_destroy(bench);
+}
@@ -260,12 +260,98 @@ static void test2_func(abts_case *tc, void *data)
     ABTS_INT_EQUAL(tc, 2000, alarm.time);
 }
 
+#define NUM_OF_QUEUED_EVENT (OGS_QUEUE_MAX_BATCH * 2 + 5)
+
+typedef struct counter_s {
+    ogs_fsm_t fsm;
+    int count;
+    int in_order;
+} counter_t;
+
+typedef struct count_event_s {
+    int id;
+    int seq;
+} count_event_t;
+
+static int num_of_freed;
+
+void counter_initial(counter_t *s, count_event_t *e);
+void counter_counting(counter_t *s, count_event_t *e);
+
+void counter_initial(counter_t *s, count_event_t *e)
+{
+    OGS_FSM_TRAN(s, &counter_counting);
+}
+
+void counter_counting(counter_t *s, count_event_t *e)
+{
+    switch (e->id) {
+    case UP_SIG:
+        if (e->seq == s->count)
+            s->in_order++;
+        s->count++;
+        break;
+    }
+}
+
+static void count_event_free(count_event_t *e)
+{
+    num_of_freed++;
+    ogs_free(e);
+}
+
+static void test3_func(abts_case *tc, void *data)
+{
+    counter_t counter;
+    count_event_t *e = NULL;
+    ogs_queue_t *queue = NULL;
+    int i, rv;
+
+    queue = ogs_queue_create(NUM_OF_QUEUED_EVENT);
+    ABTS_PTR_NOTNULL(tc, queue);
+
+    memset(&counter, 0, sizeof(counter));
+    ogs_fsm_init(&counter, &counter_initial, 0, 0);
+    num_of_freed = 0;
+
+    /* Empty queue */
+    rv = ogs_fsm_dispatch_queue(&counter, queue, count_event_free);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    ABTS_INT_EQUAL(tc, 0, counter.count);
+
+    /* More than one batch : every event in order, each freed once */
+    for (i = 0; i < NUM_OF_QUEUED_EVENT; i++) {
+        e = ogs_calloc(1, sizeof(*e));
+        ogs_assert(e);
+        e->id = UP_SIG;
+        e->seq = i;
+        rv = ogs_queue_push(queue, e);
+        ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    }
+
+    rv = ogs_fsm_dispatch_queue(&counter, queue, count_event_free);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    ABTS_INT_EQUAL(tc, NUM_OF_QUEUED_EVENT, counter.count);
+    ABTS_INT_EQUAL(tc, NUM_OF_QUEUED_EVENT, counter.in_order);
+    ABTS_INT_EQUAL(tc, NUM_OF_QUEUED_EVENT, num_of_freed);
+    ABTS_INT_EQUAL(tc, 0, ogs_queue_size(queue));
+
+    /* Terminated queue */
+    ogs_queue_term(queue);
+    rv = ogs_fsm_dispatch_queue(&counter, queue, count_event_free);
+    ABTS_INT_EQUAL(tc, OGS_DONE, rv);
+
+    ogs_fsm_fini(&counter, 0);
+    ogs_queue_destroy(queue);
+}
+
 abts_suite *test_fsm(abts_suite *suite)
 {
     suite = ADD_SUITE(suite)
 
     abts_run_test(suite, test1_func, NULL);
     abts_run_test(suite, test2_func, NULL);
+    abts_run_test(suite, test3_func, NULL);
 
     return suite;
 }
@@ -386,6 +386,74 @@ static void hash_count_5(abts_case *tc, void *data)
     ogs_hash_destroy(h);
 }
 
+#define RANDOM_KEYS 2000
+
+/* Random operations, with many deletions, against a plain array */
+static void hash_random_test(abts_case *tc, void *data)
+{
+    static uint32_t key4[RANDOM_KEYS];
+    static uint64_t key8[RANDOM_KEYS];
+    static char keystr[RANDOM_KEYS][16];
+    static int val[RANDOM_KEYS];
+    static bool present[3][RANDOM_KEYS];
+    ogs_hash_t *h = NULL;
+    ogs_hash_index_t *hi = NULL;
+    const void *key;
+    int klen[3] = { sizeof(key4[0]), sizeof(key8[0]), OGS_HASH_KEY_STRING };
+    int i, j, type, count = 0, deleted;
+
+    h = ogs_hash_make();
+    ABTS_PTR_NOTNULL(tc, h);
+
+    memset(present, 0, sizeof(present));
+    for (i = 0; i < RANDOM_KEYS; i++) {
+        key4[i] = i * 7919;
+        key8[i] = (uint64_t)i << 40;
+        ogs_snprintf(keystr[i], sizeof(keystr[i]), "imsi-%d", i);
+        val[i] = i;
+    }
+
+    for (j = 0; j < 200000; j++) {
+        type = ogs_random32() % 3;
+        i = ogs_random32() % RANDOM_KEYS;
+        key = type == 0 ? (void *)&key4[i] :
+            type == 1 ? (void *)&key8[i] : (void *)keystr[i];
+
+        switch (ogs_random32() % 3) {
+        case 0:
+            if (!present[type][i])
+                count++;
+            ogs_hash_set(h, key, klen[type], &val[i]);
+            present[type][i] = true;
+            break;
+        case 1:
+            if (present[type][i])
+                count--;
+            ogs_hash_set(h, key, klen[type], NULL);
+            present[type][i] = false;
+            break;
+        default:
+            ABTS_PTR_EQUAL(tc, present[type][i] ? &val[i] : NULL,
+                    ogs_hash_get(h, key, klen[type]));
+            break;
+        }
+    }
+    ABTS_INT_EQUAL(tc, count, ogs_hash_count(h));
+
+    /* Deleting the current entry while iterating */
+    deleted = 0;
+    for (hi = ogs_hash_first(h); hi; hi = ogs_hash_next(hi)) {
+        ogs_hash_set(h, ogs_hash_this_key(hi),
+                ogs_hash_this_key_len(hi), NULL);
+        deleted++;
+    }
+    ABTS_INT_EQUAL(tc, count, deleted);
+    ABTS_INT_EQUAL(tc, 0, ogs_hash_count(h));
+    ABTS_PTR_EQUAL(tc, NULL, ogs_hash_first(h));
+
+    ogs_hash_destroy(h);
+}
+
 abts_suite *test_hash(abts_suite *suite)
 {
     suite = ADD_SUITE(suite)
@@ -406,6 +474,7 @@ abts_suite *test_hash(abts_suite *suite)
     abts_run_test(suite, hash_clear_test, NULL);
     abts_run_test(suite, hash_traverse, NULL);
     abts_run_test(suite, summation_test, NULL);
+    abts_run_test(suite, hash_random_test, NULL);
 
     return suite;
 }
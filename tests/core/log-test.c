@@ -103,11 +103,171 @@ static void test_basic(abts_case *tc, void *data)
 #endif
 }
 
+#if !defined(_WIN32)
+#define ASYNC_THREADS 2
+#define ASYNC_LINES 1000
+
+static int async_domain_id;
+
+static void async_main(void *data)
+{
+    int i, id = (intptr_t)data;
+
+    for (i = 0; i < ASYNC_LINES; i++)
+        ogs_log_printf(OGS_LOG_INFO, async_domain_id, 0,
+                __FILE__, __LINE__, OGS_FUNC, 0, "async %d %d", id, i);
+}
+
+static void test_async(abts_case *tc, void *data)
+{
+    char path[] = "/tmp/ogs-log-test-XXXXXX";
+    char line[OGS_HUGE_LEN];
+    int next[ASYNC_THREADS];
+    ogs_thread_t *thread[ASYNC_THREADS];
+    ogs_log_t *log = NULL;
+    FILE *file = NULL;
+    char *p;
+    int i, id, n, fd, saved_stderr, rv;
+
+    memset(next, 0, sizeof(next));
+
+    fd = mkstemp(path);
+    ABTS_TRUE(tc, fd >= 0);
+    close(fd);
+
+    ogs_log_install_domain(&async_domain_id, "async", OGS_LOG_INFO);
+    log = ogs_log_add_file(path);
+    ABTS_PTR_NOTNULL(tc, log);
+
+    /* Keep the messages off the console */
+    saved_stderr = dup(STDERR_FILENO);
+    ABTS_TRUE(tc, saved_stderr >= 0);
+    file = fopen("/dev/null", "w");
+    ABTS_PTR_NOTNULL(tc, file);
+    dup2(fileno(file), STDERR_FILENO);
+    fclose(file);
+
+    rv = ogs_log_async_start();
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+
+    for (i = 0; i < ASYNC_THREADS; i++) {
+        thread[i] = ogs_thread_create(async_main, (void *)(intptr_t)i);
+        ABTS_PTR_NOTNULL(tc, thread[i]);
+    }
+    for (i = 0; i < ASYNC_THREADS; i++)
+        ogs_thread_destroy(thread[i]);
+
+    ogs_log_async_stop();
+
+    dup2(saved_stderr, STDERR_FILENO);
+    close(saved_stderr);
+
+    ogs_log_remove(log);
+    ogs_log_set_domain_level(async_domain_id, OGS_LOG_NONE);
+
+    /* Every line once, and in order for each thread */
+    file = fopen(path, "r");
+    ABTS_PTR_NOTNULL(tc, file);
+    while (fgets(line, sizeof(line), file)) {
+        p = strstr(line, "async ");
+        ABTS_PTR_NOTNULL(tc, p);
+        ABTS_INT_EQUAL(tc, 2, sscanf(p, "async %d %d", &id, &n));
+        ABTS_TRUE(tc, id >= 0 && id < ASYNC_THREADS);
+        ABTS_INT_EQUAL(tc, next[id], n);
+        next[id]++;
+    }
+    fclose(file);
+    unlink(path);
+
+    for (i = 0; i < ASYNC_THREADS; i++)
+        ABTS_INT_EQUAL(tc, ASYNC_LINES, next[i]);
+}
+
+static void test_async_fatal(abts_case *tc, void *data)
+{
+    char path[] = "/tmp/ogs-log-test-XXXXXX";
+    char line[OGS_HUGE_LEN];
+    int next[ASYNC_THREADS];
+    ogs_thread_t *thread[ASYNC_THREADS];
+    ogs_log_t *log = NULL;
+    FILE *file = NULL;
+    char *p;
+    int i, id, n, fd, saved_stderr, rv;
+    bool fatal = false;
+
+    memset(next, 0, sizeof(next));
+
+    fd = mkstemp(path);
+    ABTS_TRUE(tc, fd >= 0);
+    close(fd);
+
+    ogs_log_install_domain(&async_domain_id, "async", OGS_LOG_INFO);
+    log = ogs_log_add_file(path);
+    ABTS_PTR_NOTNULL(tc, log);
+
+    saved_stderr = dup(STDERR_FILENO);
+    ABTS_TRUE(tc, saved_stderr >= 0);
+    file = fopen("/dev/null", "w");
+    ABTS_PTR_NOTNULL(tc, file);
+    dup2(fileno(file), STDERR_FILENO);
+    fclose(file);
+
+    rv = ogs_log_async_start();
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+
+    for (i = 0; i < ASYNC_THREADS; i++) {
+        thread[i] = ogs_thread_create(async_main, (void *)(intptr_t)i);
+        ABTS_PTR_NOTNULL(tc, thread[i]);
+    }
+    for (i = 0; i < ASYNC_THREADS; i++)
+        ogs_thread_destroy(thread[i]);
+
+    /* Written at once, after everything the rings still hold */
+    ogs_log_printf(OGS_LOG_FATAL, async_domain_id, 0,
+            __FILE__, __LINE__, OGS_FUNC, 0, "fatal");
+
+    /* Read before the writer is stopped */
+    file = fopen(path, "r");
+    ABTS_PTR_NOTNULL(tc, file);
+    while (fgets(line, sizeof(line), file)) {
+        ABTS_TRUE(tc, !fatal);
+        if (strstr(line, "fatal")) {
+            fatal = true;
+            continue;
+        }
+        p = strstr(line, "async ");
+        ABTS_PTR_NOTNULL(tc, p);
+        ABTS_INT_EQUAL(tc, 2, sscanf(p, "async %d %d", &id, &n));
+        ABTS_TRUE(tc, id >= 0 && id < ASYNC_THREADS);
+        ABTS_INT_EQUAL(tc, next[id], n);
+        next[id]++;
+    }
+    fclose(file);
+
+    ogs_log_async_stop();
+
+    dup2(saved_stderr, STDERR_FILENO);
+    close(saved_stderr);
+
+    ogs_log_remove(log);
+    ogs_log_set_domain_level(async_domain_id, OGS_LOG_NONE);
+    unlink(path);
+
+    ABTS_TRUE(tc, fatal);
+    for (i = 0; i < ASYNC_THREADS; i++)
+        ABTS_INT_EQUAL(tc, ASYNC_LINES, next[i]);
+}
+#endif
+
 abts_suite *test_log(abts_suite *suite)
 {
     suite = ADD_SUITE(suite)
 
     abts_run_test(suite, test_basic, NULL);
+#if !defined(_WIN32)
+    abts_run_test(suite, test_async, NULL);
+    abts_run_test(suite, test_async_fatal, NULL);
+#endif
 
     return suite;
 }
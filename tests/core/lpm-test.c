@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2019-2023 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ogs-core.h"
+#include "core/abts.h"
+
+static uint32_t ipv4(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+{
+    return htobe32(((uint32_t)a << 24) | (b << 16) | (c << 8) | d);
+}
+
+static void *find4(ogs_lpm_t *lpm, uint32_t addr)
+{
+    return ogs_lpm_find(lpm, &addr);
+}
+
+static void lpm_test1(abts_case *tc, void *data)
+{
+    ogs_lpm_t *lpm = NULL;
+    uint32_t addr;
+    char *a = "a", *b = "b", *c = "c", *d = "d";
+
+    lpm = ogs_lpm_create(32);
+    ABTS_PTR_NOTNULL(tc, lpm);
+
+    ABTS_PTR_EQUAL(tc, NULL, find4(lpm, ipv4(10, 45, 0, 2)));
+
+    addr = ipv4(10, 45, 0, 0);
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_lpm_add(lpm, &addr, 16, a));
+    addr = ipv4(10, 45, 0, 2);
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_lpm_add(lpm, &addr, 32, b));
+    addr = ipv4(10, 45, 128, 0);
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_lpm_add(lpm, &addr, 17, c));
+    addr = ipv4(10, 45, 0, 0);
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_lpm_add(lpm, &addr, 29, d));
+    ABTS_INT_EQUAL(tc, 4, ogs_lpm_count(lpm));
+
+    ABTS_PTR_EQUAL(tc, b, find4(lpm, ipv4(10, 45, 0, 2)));
+    ABTS_PTR_EQUAL(tc, d, find4(lpm, ipv4(10, 45, 0, 3)));
+    ABTS_PTR_EQUAL(tc, d, find4(lpm, ipv4(10, 45, 0, 7)));
+    ABTS_PTR_EQUAL(tc, a, find4(lpm, ipv4(10, 45, 0, 8)));
+    ABTS_PTR_EQUAL(tc, a, find4(lpm, ipv4(10, 45, 127, 255)));
+    ABTS_PTR_EQUAL(tc, c, find4(lpm, ipv4(10, 45, 128, 0)));
+    ABTS_PTR_EQUAL(tc, c, find4(lpm, ipv4(10, 45, 255, 255)));
+    ABTS_PTR_EQUAL(tc, NULL, find4(lpm, ipv4(10, 46, 0, 2)));
+
+    addr = ipv4(10, 45, 0, 0);
+    ABTS_PTR_EQUAL(tc, d, ogs_lpm_get(lpm, &addr, 29));
+    ABTS_PTR_EQUAL(tc, NULL, ogs_lpm_get(lpm, &addr, 28));
+
+    /* Shorter prefixes show through again */
+    addr = ipv4(10, 45, 0, 0);
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_lpm_remove(lpm, &addr, 29));
+    ABTS_INT_EQUAL(tc, OGS_ERROR, ogs_lpm_remove(lpm, &addr, 29));
+    ABTS_PTR_EQUAL(tc, b, find4(lpm, ipv4(10, 45, 0, 2)));
+    ABTS_PTR_EQUAL(tc, a, find4(lpm, ipv4(10, 45, 0, 3)));
+
+    addr = ipv4(10, 45, 0, 2);
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_lpm_remove(lpm, &addr, 32));
+    ABTS_PTR_EQUAL(tc, a, find4(lpm, ipv4(10, 45, 0, 2)));
+
+    /* Replace */
+    addr = ipv4(10, 45, 0, 0);
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_lpm_add(lpm, &addr, 16, d));
+    ABTS_PTR_EQUAL(tc, d, find4(lpm, ipv4(10, 45, 0, 2)));
+    ABTS_PTR_EQUAL(tc, c, find4(lpm, ipv4(10, 45, 200, 1)));
+    ABTS_INT_EQUAL(tc, 2, ogs_lpm_count(lpm));
+
+    /* Default route */
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_lpm_add(lpm, &addr, 0, a));
+    ABTS_PTR_EQUAL(tc, a, find4(lpm, ipv4(192, 168, 0, 1)));
+    ABTS_PTR_EQUAL(tc, d, find4(lpm, ipv4(10, 45, 0, 2)));
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_lpm_remove(lpm, &addr, 0));
+    ABTS_PTR_EQUAL(tc, NULL, find4(lpm, ipv4(192, 168, 0, 1)));
+
+    addr = ipv4(10, 45, 128, 0);
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_lpm_remove(lpm, &addr, 17));
+    addr = ipv4(10, 45, 0, 0);
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_lpm_remove(lpm, &addr, 16));
+    ABTS_INT_EQUAL(tc, 0, ogs_lpm_count(lpm));
+    ABTS_PTR_EQUAL(tc, NULL, find4(lpm, ipv4(10, 45, 0, 2)));
+
+    ogs_lpm_destroy(lpm);
+}
+
+static void lpm_test2(abts_case *tc, void *data)
+{
+    ogs_lpm_t *lpm = NULL;
+    uint8_t addr[16];
+    char *a = "a", *b = "b", *c = "c";
+
+    lpm = ogs_lpm_create(128);
+    ABTS_PTR_NOTNULL(tc, lpm);
+
+    /* 2001:db8:cafe::/48, 2001:db8:cafe:1::/64, 2001:db8:cafe:1::1/128 */
+    memset(addr, 0, sizeof(addr));
+    addr[0] = 0x20; addr[1] = 0x01; addr[2] = 0x0d; addr[3] = 0xb8;
+    addr[4] = 0xca; addr[5] = 0xfe;
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_lpm_add(lpm, addr, 48, a));
+    addr[7] = 0x01;
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_lpm_add(lpm, addr, 64, b));
+    addr[15] = 0x01;
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_lpm_add(lpm, addr, 128, c));
+
+    ABTS_PTR_EQUAL(tc, c, ogs_lpm_find(lpm, addr));
+    addr[15] = 0x02;
+    ABTS_PTR_EQUAL(tc, b, ogs_lpm_find(lpm, addr));
+    addr[7] = 0x02;
+    ABTS_PTR_EQUAL(tc, a, ogs_lpm_find(lpm, addr));
+    addr[5] = 0xff;
+    ABTS_PTR_EQUAL(tc, NULL, ogs_lpm_find(lpm, addr));
+
+    addr[5] = 0xfe; addr[7] = 0x01; addr[15] = 0x00;
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_lpm_remove(lpm, addr, 64));
+    addr[15] = 0x01;
+    ABTS_PTR_EQUAL(tc, c, ogs_lpm_find(lpm, addr));
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_lpm_remove(lpm, addr, 128));
+    ABTS_PTR_EQUAL(tc, a, ogs_lpm_find(lpm, addr));
+    ABTS_INT_EQUAL(tc, 1, ogs_lpm_count(lpm));
+
+    ogs_lpm_destroy(lpm);
+}
+
+#define LPM_TEST_NUM_OF_PREFIX 300
+
+/* Compare against a linear search over random nested prefixes */
+static void lpm_test3(abts_case *tc, void *data)
+{
+    ogs_lpm_t *lpm = NULL;
+    struct {
+        uint32_t addr;
+        int prefixlen;
+        bool added;
+    } prefix[LPM_TEST_NUM_OF_PREFIX];
+    int i, j, n;
+
+    lpm = ogs_lpm_create(32);
+    ABTS_PTR_NOTNULL(tc, lpm);
+
+    for (i = 0; i < LPM_TEST_NUM_OF_PREFIX; i++) {
+        uint32_t mask;
+
+        prefix[i].prefixlen = 8 + ogs_random32() % 25;
+        mask = 0xffffffff << (32 - prefix[i].prefixlen);
+        /* Keep them in 10.45.0.0/16 so that they overlap */
+        prefix[i].addr = (0x0a2d0000 | (ogs_random32() & 0x0000ffff)) & mask;
+        prefix[i].added = false;
+
+        for (j = 0; j < i; j++) {
+            if (prefix[j].added && prefix[j].addr == prefix[i].addr &&
+                prefix[j].prefixlen == prefix[i].prefixlen)
+                break;
+        }
+        if (j == i) {
+            uint32_t addr = htobe32(prefix[i].addr);
+            ABTS_INT_EQUAL(tc, OGS_OK, ogs_lpm_add(
+                        lpm, &addr, prefix[i].prefixlen, &prefix[i]));
+            prefix[i].added = true;
+        }
+    }
+
+    for (n = 0; n < 2; n++) {
+        for (i = 0; i < 2000; i++) {
+            uint32_t addr = 0x0a2d0000 | (ogs_random32() & 0x0000ffff);
+            uint32_t key = htobe32(addr);
+            void *expected = NULL;
+            int best = -1;
+
+            for (j = 0; j < LPM_TEST_NUM_OF_PREFIX; j++) {
+                uint32_t mask;
+
+                if (!prefix[j].added)
+                    continue;
+                mask = 0xffffffff << (32 - prefix[j].prefixlen);
+                if ((addr & mask) == prefix[j].addr &&
+                    prefix[j].prefixlen > best) {
+                    best = prefix[j].prefixlen;
+                    expected = &prefix[j];
+                }
+            }
+
+            ABTS_PTR_EQUAL(tc, expected, ogs_lpm_find(lpm, &key));
+        }
+
+        /* Remove every other prefix and check again */
+        for (i = 0; i < LPM_TEST_NUM_OF_PREFIX; i += 2) {
+            uint32_t addr = htobe32(prefix[i].addr);
+
+            if (!prefix[i].added)
+                continue;
+            ABTS_INT_EQUAL(tc, OGS_OK,
+                    ogs_lpm_remove(lpm, &addr, prefix[i].prefixlen));
+            prefix[i].added = false;
+        }
+    }
+
+    for (i = 0; i < LPM_TEST_NUM_OF_PREFIX; i++) {
+        uint32_t addr = htobe32(prefix[i].addr);
+
+        if (!prefix[i].added)
+            continue;
+        ABTS_INT_EQUAL(tc, OGS_OK,
+                ogs_lpm_remove(lpm, &addr, prefix[i].prefixlen));
+    }
+    ABTS_INT_EQUAL(tc, 0, ogs_lpm_count(lpm));
+
+    ogs_lpm_destroy(lpm);
+}
+
+abts_suite *test_lpm(abts_suite *suite)
+{
+    suite = ADD_SUITE(suite)
+
+    abts_run_test(suite, lpm_test1, NULL);
+    abts_run_test(suite, lpm_test2, NULL);
+    abts_run_test(suite, lpm_test3, NULL);
+
+    return suite;
+}
@@ -74,6 +74,99 @@ static void test4_func(abts_case *tc, void *data)
 #endif
 }
 
+static void test5_func(abts_case *tc, void *data)
+{
+#if OGS_USE_TALLOC == 1
+    size_t blocks = ogs_mem_total_blocks();
+    char *p, *q;
+    int i;
+
+    /* Grows in place up to the size class */
+    p = ogs_malloc(10);
+    ABTS_PTR_NOTNULL(tc, p);
+    memset(p, 1, 10);
+
+    q = ogs_realloc(p, 16);
+    ABTS_PTR_EQUAL(tc, p, q);
+
+    p = ogs_realloc(q, 17);
+    ABTS_TRUE(tc, p != q);
+    for (i = 0; i < 10; i++)
+        ABTS_INT_EQUAL(tc, 1, p[i]);
+
+    /* Larger than the size classes */
+    memset(p, 2, 17);
+    q = ogs_realloc(p, 100000);
+    ABTS_PTR_NOTNULL(tc, q);
+    for (i = 0; i < 17; i++)
+        ABTS_INT_EQUAL(tc, 2, q[i]);
+    memset(q, 3, 100000);
+
+    p = ogs_realloc(q, 20);
+    ABTS_PTR_NOTNULL(tc, p);
+    for (i = 0; i < 20; i++)
+        ABTS_INT_EQUAL(tc, 3, p[i]);
+    ABTS_INT_EQUAL(tc, blocks + 1, ogs_mem_total_blocks());
+
+    ABTS_PTR_EQUAL(tc, NULL, ogs_realloc(p, 0));
+    ABTS_INT_EQUAL(tc, blocks, ogs_mem_total_blocks());
+
+    p = ogs_realloc(NULL, 30);
+    ABTS_PTR_NOTNULL(tc, p);
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_free(p));
+    ABTS_INT_EQUAL(tc, OGS_ERROR, ogs_free(NULL));
+#endif
+}
+
+#define TEST6_NUM_OF_THREAD 4
+#define TEST6_NUM_OF_BLOCK 10000
+
+static char *test6_block[TEST6_NUM_OF_THREAD][TEST6_NUM_OF_BLOCK];
+
+static void test6_main(void *data)
+{
+    char **block = data;
+    int i;
+
+    for (i = 0; i < TEST6_NUM_OF_BLOCK; i++) {
+        int size = 1 + i % 5000;
+
+        block[i] = ogs_malloc(size);
+        ogs_assert(block[i]);
+        memset(block[i], i & 0xff, size);
+    }
+}
+
+/* Allocated in several threads at once and freed in another */
+static void test6_func(abts_case *tc, void *data)
+{
+    ogs_thread_t *thread[TEST6_NUM_OF_THREAD];
+    size_t blocks = ogs_mem_total_blocks();
+    int n, i, j;
+
+    for (n = 0; n < 2; n++) {
+        for (i = 0; i < TEST6_NUM_OF_THREAD; i++) {
+            thread[i] = ogs_thread_create(test6_main, test6_block[i]);
+            ABTS_PTR_NOTNULL(tc, thread[i]);
+        }
+        for (i = 0; i < TEST6_NUM_OF_THREAD; i++)
+            ogs_thread_destroy(thread[i]);
+
+        for (i = 0; i < TEST6_NUM_OF_THREAD; i++) {
+            for (j = 0; j < TEST6_NUM_OF_BLOCK; j++) {
+                int size = 1 + j % 5000;
+
+                ABTS_INT_EQUAL(tc, j & 0xff, (uint8_t)test6_block[i][j][0]);
+                ABTS_INT_EQUAL(tc,
+                        j & 0xff, (uint8_t)test6_block[i][j][size-1]);
+                ogs_free(test6_block[i][j]);
+            }
+        }
+
+        ABTS_INT_EQUAL(tc, blocks, ogs_mem_total_blocks());
+    }
+}
+
 abts_suite *test_memory(abts_suite *suite)
 {
     suite = ADD_SUITE(suite)
@@ -82,6 +175,8 @@ abts_suite *test_memory(abts_suite *suite)
     abts_run_test(suite, test2_func, NULL);
     abts_run_test(suite, test3_func, NULL);
     abts_run_test(suite, test4_func, NULL);
+    abts_run_test(suite, test5_func, NULL);
+    abts_run_test(suite, test6_func, NULL);
 
     return suite;
 }
@@ -70,12 +70,195 @@ static void test2_func(abts_case *tc, void *data)
     ogs_pkbuf_free(p3);
 }
 
+static ogs_pkbuf_pool_t *test_pool_create(void)
+{
+#if OGS_USE_TALLOC == 1
+    return talloc_pool(__ogs_talloc_core, 64*1024);
+#else
+    ogs_pkbuf_config_t config;
+
+    ogs_pkbuf_default_init(&config);
+    return ogs_pkbuf_pool_create(&config);
+#endif
+}
+
+static void test_pool_destroy(ogs_pkbuf_pool_t *pool)
+{
+    ogs_pkbuf_pool_destroy(pool);
+#if OGS_USE_TALLOC == 1
+    ogs_talloc_free(pool, OGS_FILE_LINE);
+#endif
+}
+
+#define TEST3_NUM_OF_PKBUF 100
+
+static void test3_func(abts_case *tc, void *data)
+{
+    ogs_pkbuf_pool_t *pool = NULL;
+    ogs_pkbuf_pool_stat_t stat;
+    ogs_pkbuf_t *pkbuf = NULL, *p2 = NULL;
+    ogs_pkbuf_t *batch[TEST3_NUM_OF_PKBUF];
+    int i;
+
+    pool = test_pool_create();
+    ABTS_PTR_NOTNULL(tc, pool);
+
+    ogs_pkbuf_pool_stat(pool, &stat);
+    ABTS_TRUE(tc, stat.alloc_hit == 0 && stat.alloc_miss == 0);
+
+    /* A freed pkbuf is handed out again in the same size class */
+    pkbuf = ogs_pkbuf_alloc(pool, 100);
+    ABTS_PTR_NOTNULL(tc, pkbuf);
+    ogs_pkbuf_put_u32(pkbuf, 0x12345678);
+    ogs_pkbuf_free(pkbuf);
+
+    p2 = ogs_pkbuf_alloc(pool, 120);
+    ABTS_PTR_EQUAL(tc, pkbuf, p2);
+    ABTS_INT_EQUAL(tc, 0, p2->len);
+    ABTS_INT_EQUAL(tc, 0, ogs_pkbuf_headroom(p2));
+    ABTS_INT_EQUAL(tc, 120, ogs_pkbuf_tailroom(p2));
+    ABTS_PTR_EQUAL(tc, pool, p2->pool);
+
+    ogs_pkbuf_reserve(p2, 20);
+    ogs_pkbuf_put_u32(p2, 0x12345678);
+    pkbuf = ogs_pkbuf_copy(p2);
+    ABTS_PTR_NOTNULL(tc, pkbuf);
+    ABTS_INT_EQUAL(tc, 4, pkbuf->len);
+    ABTS_INT_EQUAL(tc, 20, ogs_pkbuf_headroom(pkbuf));
+    ABTS_TRUE(tc, memcmp(pkbuf->data, p2->data, 4) == 0);
+    ogs_pkbuf_free(pkbuf);
+    ogs_pkbuf_free(p2);
+
+    ogs_pkbuf_pool_stat(pool, &stat);
+    ABTS_TRUE(tc, stat.alloc_hit == 2);
+    ABTS_TRUE(tc, stat.alloc_miss == 1);
+    ABTS_TRUE(tc, stat.free_hit == 2);
+    ABTS_TRUE(tc, stat.free_miss == 0);
+
+    /* More than a magazine holds */
+    ABTS_INT_EQUAL(tc, TEST3_NUM_OF_PKBUF, ogs_pkbuf_alloc_batch(
+                pool, OGS_MAX_PKT_LEN, batch, TEST3_NUM_OF_PKBUF));
+    for (i = 0; i < TEST3_NUM_OF_PKBUF; i++) {
+        ABTS_INT_EQUAL(tc, OGS_MAX_PKT_LEN, ogs_pkbuf_tailroom(batch[i]));
+        memset(ogs_pkbuf_put(batch[i], OGS_MAX_PKT_LEN), i, OGS_MAX_PKT_LEN);
+    }
+    for (i = 0; i < TEST3_NUM_OF_PKBUF; i++)
+        ABTS_INT_EQUAL(tc, i, batch[i]->data[OGS_MAX_PKT_LEN-1]);
+    ogs_pkbuf_free_batch(batch, TEST3_NUM_OF_PKBUF);
+
+    ogs_pkbuf_pool_stat(pool, &stat);
+    ABTS_TRUE(tc, stat.alloc_hit == 2 + TEST3_NUM_OF_PKBUF);
+    ABTS_TRUE(tc, stat.alloc_miss > 1);
+    ABTS_TRUE(tc, stat.free_miss > 0);
+
+    /* Larger than the classes, not cached */
+    pkbuf = ogs_pkbuf_alloc(pool, 8192);
+    ABTS_PTR_NOTNULL(tc, pkbuf);
+    ABTS_INT_EQUAL(tc, 8192, ogs_pkbuf_tailroom(pkbuf));
+    ogs_pkbuf_free(pkbuf);
+
+    test_pool_destroy(pool);
+}
+
+#define TEST4_NUM_OF_PKBUF 10000
+
+static ogs_pkbuf_t *test4_pkbuf[TEST4_NUM_OF_PKBUF];
+
+static void test4_main(void *data)
+{
+    ogs_pkbuf_pool_t *pool = data;
+    int i;
+
+    for (i = 0; i < TEST4_NUM_OF_PKBUF; i++) {
+        test4_pkbuf[i] = ogs_pkbuf_alloc(pool, OGS_MAX_PKT_LEN);
+        ogs_assert(test4_pkbuf[i]);
+        ogs_pkbuf_put_u32(test4_pkbuf[i], i);
+    }
+}
+
+/* Allocated in one thread and freed in another */
+static void test4_func(abts_case *tc, void *data)
+{
+    ogs_pkbuf_pool_t *pool = NULL;
+    ogs_thread_t *thread = NULL;
+    int i, n;
+
+    pool = test_pool_create();
+    ABTS_PTR_NOTNULL(tc, pool);
+
+    for (n = 0; n < 3; n++) {
+        thread = ogs_thread_create(test4_main, pool);
+        ABTS_PTR_NOTNULL(tc, thread);
+        ogs_thread_destroy(thread);
+
+        for (i = 0; i < TEST4_NUM_OF_PKBUF; i++) {
+            uint32_t v;
+
+            memcpy(&v, test4_pkbuf[i]->data, sizeof(v));
+            ABTS_INT_EQUAL(tc, i, be32toh(v));
+            ogs_pkbuf_free(test4_pkbuf[i]);
+        }
+    }
+
+    test_pool_destroy(pool);
+}
+
+#define TEST5_NUM_OF_PKBUF 10
+
+static void test5_main(void *data)
+{
+    ogs_pkbuf_pool_t *pool = data;
+    ogs_pkbuf_t *pkbuf[TEST5_NUM_OF_PKBUF];
+    int i;
+
+    for (i = 0; i < TEST5_NUM_OF_PKBUF; i++) {
+        pkbuf[i] = ogs_pkbuf_alloc(pool, 100);
+        ogs_assert(pkbuf[i]);
+    }
+    for (i = 0; i < TEST5_NUM_OF_PKBUF; i++)
+        ogs_pkbuf_free(pkbuf[i]);
+}
+
+/* An exiting thread gives its cached pkbufs back */
+static void test5_func(abts_case *tc, void *data)
+{
+    ogs_pkbuf_pool_t *pool = NULL;
+    ogs_pkbuf_pool_stat_t stat;
+    ogs_thread_t *thread = NULL;
+#if OGS_USE_TALLOC == 1
+    size_t size;
+#endif
+
+    pool = test_pool_create();
+    ABTS_PTR_NOTNULL(tc, pool);
+#if OGS_USE_TALLOC == 1
+    size = talloc_total_size(pool);
+#endif
+
+    thread = ogs_thread_create(test5_main, pool);
+    ABTS_PTR_NOTNULL(tc, thread);
+    ogs_thread_destroy(thread);
+
+    /* The cache of the thread is gone */
+    ogs_pkbuf_pool_stat(pool, &stat);
+    ABTS_TRUE(tc, stat.alloc_hit == 0 && stat.alloc_miss == 0);
+    ABTS_TRUE(tc, stat.free_hit == 0 && stat.free_miss == 0);
+#if OGS_USE_TALLOC == 1
+    ABTS_TRUE(tc, talloc_total_size(pool) == size);
+#endif
+
+    test_pool_destroy(pool);
+}
+
 abts_suite *test_pkbuf(abts_suite *suite)
 {
     suite = ADD_SUITE(suite)
 
     abts_run_test(suite, test1_func, NULL);
     abts_run_test(suite, test2_func, NULL);
+    abts_run_test(suite, test3_func, NULL);
+    abts_run_test(suite, test4_func, NULL);
+    abts_run_test(suite, test5_func, NULL);
 
     return suite;
 }
@@ -657,6 +657,80 @@ static void test8_func(abts_case *tc, void *data)
     ogs_pollset_destroy(pollset);
 }
 
+#if !defined(_WIN32)
+static int test9_called;
+
+static void test9_handler(short when, ogs_socket_t fd, void *data)
+{
+    abts_case *tc = data;
+    char c;
+
+    ABTS_INT_EQUAL(tc, OGS_POLLIN, when);
+
+    /* Leave the rest of the data in the socket */
+    ABTS_INT_EQUAL(tc, 1, ogs_recv(fd, &c, 1, 0));
+    test9_called++;
+}
+
+/* Edge-triggered poll on an fd beyond the capacity of the pollset */
+static void test9_func(abts_case *tc, void *data)
+{
+    int rv;
+    ogs_socket_t fd[2], high;
+    ogs_poll_t *poll = NULL;
+    ogs_pollset_t *pollset = ogs_pollset_create(16);
+    ABTS_PTR_NOTNULL(tc, pollset);
+
+    rv = ogs_socketpair(AF_SOCKPAIR, SOCK_STREAM, 0, fd);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+
+    high = dup2(fd[1], 1000);
+    ABTS_INT_EQUAL(tc, 1000, high);
+    ogs_closesocket(fd[1]);
+
+    poll = ogs_pollset_add(pollset, OGS_POLLIN|OGS_POLLET,
+            high, test9_handler, tc);
+    ABTS_PTR_NOTNULL(tc, poll);
+
+    ABTS_INT_EQUAL(tc, 2, ogs_send(fd[0], "ab", 2, 0));
+
+    test9_called = 0;
+    rv = ogs_pollset_poll(pollset, ogs_time_from_msec(100));
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    ABTS_INT_EQUAL(tc, 1, test9_called);
+
+    /* No new data, so no new edge */
+    rv = ogs_pollset_poll(pollset, ogs_time_from_msec(100));
+    ABTS_INT_EQUAL(tc, OGS_TIMEUP, rv);
+    ABTS_INT_EQUAL(tc, 1, test9_called);
+
+    /* Re-armed while data is left */
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_pollset_rearm(poll));
+    rv = ogs_pollset_poll(pollset, ogs_time_from_msec(100));
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    ABTS_INT_EQUAL(tc, 2, test9_called);
+
+    /* Re-armed with nothing left */
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_pollset_rearm(poll));
+    rv = ogs_pollset_poll(pollset, ogs_time_from_msec(100));
+    ABTS_INT_EQUAL(tc, OGS_TIMEUP, rv);
+    ABTS_INT_EQUAL(tc, 2, test9_called);
+
+    ABTS_INT_EQUAL(tc, 1, ogs_send(fd[0], "c", 1, 0));
+
+    rv = ogs_pollset_poll(pollset, ogs_time_from_msec(100));
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    ABTS_INT_EQUAL(tc, 3, test9_called);
+
+    ogs_pollset_remove(poll);
+
+    ogs_closesocket(fd[0]);
+    ogs_closesocket(high);
+
+    ogs_pollset_destroy(pollset);
+}
+#endif
+
 abts_suite *test_poll(abts_suite *suite)
 {
     suite = ADD_SUITE(suite)
@@ -672,6 +746,9 @@ abts_suite *test_poll(abts_suite *suite)
     abts_run_test(suite, test6_func, NULL);
     abts_run_test(suite, test7_func, NULL);
     abts_run_test(suite, test8_func, NULL);
+#if !defined(_WIN32) /* select() has no edge-triggered mode */
+    abts_run_test(suite, test9_func, NULL);
+#endif
 
     return suite;
 }
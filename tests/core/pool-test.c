@@ -228,6 +228,97 @@ static void test3_func(abts_case *tc, void *data)
     ogs_pool_final(&testpool);
 }
 
+typedef struct {
+    char data[1024];
+} bignode_t;
+
+static OGS_POOL(bigpool, bignode_t);
+
+#define SIZE_OF_BIGPOOL (1024*1024)
+
+static void test4_func(abts_case *tc, void *data)
+{
+    bignode_t *node[10];
+    ogs_time_t start;
+    int i;
+
+    /* 1GB of slots */
+    start = ogs_get_monotonic_time();
+    ogs_pool_init(&bigpool, SIZE_OF_BIGPOOL);
+    ABTS_TRUE(tc, ogs_get_monotonic_time() - start < ogs_time_from_sec(1));
+
+    ABTS_INT_EQUAL(tc, SIZE_OF_BIGPOOL, ogs_pool_size(&bigpool));
+    ABTS_INT_EQUAL(tc, SIZE_OF_BIGPOOL, ogs_pool_avail(&bigpool));
+
+    /* Slots never used are not found */
+    ABTS_PTR_EQUAL(tc, NULL, ogs_pool_find(&bigpool, 1));
+    ABTS_PTR_EQUAL(tc, NULL, ogs_pool_find(&bigpool, SIZE_OF_BIGPOOL));
+    ABTS_PTR_EQUAL(tc, NULL, ogs_pool_find(&bigpool, SIZE_OF_BIGPOOL+1));
+
+    for (i = 0; i < 10; i++) {
+        ogs_pool_alloc(&bigpool, &node[i]);
+        ABTS_PTR_NOTNULL(tc, node[i]);
+        ABTS_INT_EQUAL(tc, i+1, ogs_pool_index(&bigpool, node[i]));
+        ABTS_PTR_EQUAL(tc, node[i], ogs_pool_find(&bigpool, i+1));
+        memset(node[i], i, sizeof(*node[i]));
+    }
+    ABTS_PTR_EQUAL(tc, NULL, ogs_pool_find(&bigpool, 11));
+
+    /* Unused slots come first, freed ones are not reused right away */
+    ogs_pool_free(&bigpool, node[3]);
+    ABTS_PTR_EQUAL(tc, NULL, ogs_pool_find(&bigpool, 4));
+    ogs_pool_alloc(&bigpool, &node[3]);
+    ABTS_INT_EQUAL(tc, 11, ogs_pool_index(&bigpool, node[3]));
+
+    for (i = 0; i < 10; i++)
+        ogs_pool_free(&bigpool, node[i]);
+    ABTS_INT_EQUAL(tc, SIZE_OF_BIGPOOL, ogs_pool_avail(&bigpool));
+
+    ogs_pool_final(&bigpool);
+}
+
+/* Freed slots are reused in the order they were freed */
+static void test5_func(abts_case *tc, void *data)
+{
+    testnode_t *node[5], *reused[5];
+    int i, n;
+
+    ogs_pool_init(&testpool, 5);
+
+    for (n = 0; n < 3; n++) {
+        for (i = 0; i < 5; i++) {
+            ogs_pool_alloc(&testpool, &node[i]);
+            ABTS_PTR_NOTNULL(tc, node[i]);
+        }
+        ogs_pool_alloc(&testpool, &reused[0]);
+        ABTS_PTR_EQUAL(tc, NULL, reused[0]);
+
+        ogs_pool_free(&testpool, node[2]);
+        ogs_pool_free(&testpool, node[0]);
+        ogs_pool_free(&testpool, node[4]);
+
+        ogs_pool_alloc(&testpool, &reused[0]);
+        ogs_pool_alloc(&testpool, &reused[1]);
+        ABTS_PTR_EQUAL(tc, node[2], reused[0]);
+        ABTS_PTR_EQUAL(tc, node[0], reused[1]);
+
+        ogs_pool_free(&testpool, node[1]);
+        ogs_pool_alloc(&testpool, &reused[2]);
+        ogs_pool_alloc(&testpool, &reused[3]);
+        ABTS_PTR_EQUAL(tc, node[4], reused[2]);
+        ABTS_PTR_EQUAL(tc, node[1], reused[3]);
+        ABTS_PTR_EQUAL(tc, reused[3], ogs_pool_find(&testpool,
+                    ogs_pool_index(&testpool, reused[3])));
+
+        for (i = 0; i < 4; i++)
+            ogs_pool_free(&testpool, reused[i]);
+        ogs_pool_free(&testpool, node[3]);
+        ABTS_INT_EQUAL(tc, 5, ogs_pool_avail(&testpool));
+    }
+
+    ogs_pool_final(&testpool);
+}
+
 abts_suite *test_pool(abts_suite *suite)
 {
     suite = ADD_SUITE(suite)
@@ -235,6 +326,8 @@ abts_suite *test_pool(abts_suite *suite)
     abts_run_test(suite, test1_func, NULL);
     abts_run_test(suite, test2_func, NULL);
     abts_run_test(suite, test3_func, NULL);
+    abts_run_test(suite, test4_func, NULL);
+    abts_run_test(suite, test5_func, NULL);
 
     return suite;
 }
@@ -166,12 +166,87 @@ static void test_queue_timeout(abts_case *tc, void *data)
     ogs_queue_destroy(q);
 }
 
+#define BATCH_PRODUCERS     4
+#define BATCH_ITEMS         100000
+#define BATCH_SIZE          32
+
+static void batch_producer(void *data)
+{
+    uintptr_t id = (uintptr_t)data;
+    int i, rv;
+
+    for (i = 1; i <= BATCH_ITEMS; i++) {
+        do {
+            /* Another producer may take the slot we were woken for */
+            rv = ogs_queue_push(queue, (void *)(id * BATCH_ITEMS + i));
+        } while (rv == OGS_ERROR);
+        ogs_assert(rv == OGS_OK);
+    }
+}
+
+static void test_queue_batch(abts_case *tc, void *data)
+{
+    uintptr_t i, last[BATCH_PRODUCERS], value;
+    int n, j, rv, received = 0, in_order = 1;
+    void *batch[BATCH_SIZE];
+    ogs_thread_t *producer_thread[BATCH_PRODUCERS];
+    ogs_queue_stat_t stat;
+
+    queue = ogs_queue_create(QUEUE_SIZE);
+    ABTS_PTR_NOTNULL(tc, queue);
+
+    rv = ogs_queue_trypop_batch(queue, batch, BATCH_SIZE);
+    ABTS_INT_EQUAL(tc, OGS_RETRY, rv);
+
+    for (i = 0; i < BATCH_PRODUCERS; i++) {
+        last[i] = 0;
+        producer_thread[i] = ogs_thread_create(batch_producer, (void *)i);
+        ABTS_PTR_NOTNULL(tc, producer_thread[i]);
+    }
+
+    /* Each producer's items come out in the order they went in */
+    while (received < BATCH_PRODUCERS * BATCH_ITEMS) {
+        n = ogs_queue_trypop_batch(queue, batch, BATCH_SIZE);
+        if (n == OGS_RETRY)
+            continue;
+        ogs_assert(n > 0 && n <= BATCH_SIZE);
+
+        for (j = 0; j < n; j++) {
+            value = (uintptr_t)batch[j];
+            i = (value - 1) / BATCH_ITEMS;
+            if (value - i * BATCH_ITEMS != last[i] + 1)
+                in_order = 0;
+            last[i] = value - i * BATCH_ITEMS;
+        }
+        received += n;
+    }
+    ABTS_INT_EQUAL(tc, 1, in_order);
+
+    for (i = 0; i < BATCH_PRODUCERS; i++) {
+        ogs_thread_destroy(producer_thread[i]);
+        ABTS_INT_EQUAL(tc, BATCH_ITEMS, last[i]);
+    }
+
+    ogs_queue_stat(queue, &stat);
+    ABTS_INT_EQUAL(tc, 0, stat.size);
+    ABTS_INT_EQUAL(tc, QUEUE_SIZE, stat.capacity);
+    ABTS_TRUE(tc, stat.high_water > 0 && stat.high_water <= QUEUE_SIZE);
+
+    rv = ogs_queue_term(queue);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    rv = ogs_queue_trypop_batch(queue, batch, BATCH_SIZE);
+    ABTS_INT_EQUAL(tc, OGS_DONE, rv);
+
+    ogs_queue_destroy(queue);
+}
+
 abts_suite *test_queue(abts_suite *suite)
 {
     suite = ADD_SUITE(suite)
 
     abts_run_test(suite, test_queue_producer_consumer, NULL);
     abts_run_test(suite, test_queue_timeout, NULL);
+    abts_run_test(suite, test_queue_batch, NULL);
 
     return suite;
 }
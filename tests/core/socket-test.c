@@ -424,6 +424,58 @@ static void test8_func(abts_case *tc, void *data)
     ABTS_INT_EQUAL(tc, OGS_OK, rv);
 }
 
+static void test9_func(abts_case *tc, void *data)
+{
+    int rv, i, n;
+    ogs_sock_t *udp, *client;
+    ogs_sockaddr_t *addr;
+    ogs_sockaddr_t sa[3];
+    ogs_sockmsg_t msg[3];
+    char str[3][STRLEN];
+    char buf[OGS_ADDRSTRLEN];
+    const char *data_str[3] = { "first", "second", "third" };
+
+    rv = ogs_getaddrinfo(&addr, AF_INET, "127.0.0.1", PORT, 0);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    udp = ogs_udp_server(addr, NULL);
+    ABTS_PTR_NOTNULL(tc, udp);
+
+    client = ogs_sock_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    ABTS_PTR_NOTNULL(tc, client);
+
+    for (i = 0; i < 3; i++) {
+        msg[i].buf = (void *)data_str[i];
+        msg[i].len = strlen(data_str[i]);
+        msg[i].addr = addr;
+    }
+    n = ogs_sendmmsg(client->fd, msg, 3, 0);
+    ABTS_INT_EQUAL(tc, 3, n);
+
+    for (i = 0; i < 3; i += n) {
+        int j;
+
+        for (j = i; j < 3; j++) {
+            msg[j].buf = str[j];
+            msg[j].len = STRLEN;
+            msg[j].addr = &sa[j];
+        }
+        n = ogs_recvmmsg(udp->fd, &msg[i], 3 - i, 0);
+        ABTS_TRUE(tc, n > 0);
+    }
+
+    for (i = 0; i < 3; i++) {
+        ABTS_INT_EQUAL(tc, strlen(data_str[i]), msg[i].len);
+        ABTS_TRUE(tc, memcmp(str[i], data_str[i], msg[i].len) == 0);
+        ABTS_STR_EQUAL(tc, "127.0.0.1", OGS_ADDR(&sa[i], buf));
+    }
+
+    ogs_sock_destroy(client);
+    ogs_sock_destroy(udp);
+
+    rv = ogs_freeaddrinfo(addr);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+}
+
 abts_suite *test_socket(abts_suite *suite)
 {
     suite = ADD_SUITE(suite)
@@ -436,6 +488,7 @@ abts_suite *test_socket(abts_suite *suite)
     abts_run_test(suite, test6_func, NULL);
     abts_run_test(suite, test7_func, NULL);
     abts_run_test(suite, test8_func, NULL);
+    abts_run_test(suite, test9_func, NULL);
 
     return suite;
 }
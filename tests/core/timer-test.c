@@ -25,6 +25,7 @@
 #define TEST_DURATION           400000
 
 static uint8_t expire_check[TEST_DURATION/TEST_TIMER_PRECISION];
+static int expire_count;
 static ogs_time_t timer_duration[] = { 500000, 50000, 200000, 90000, 800000 };
 
 void test_expire_func_1(void *data)
@@ -32,6 +33,7 @@ void test_expire_func_1(void *data)
     int index = (uintptr_t)data;
 
     expire_check[index] = TRUE;
+    expire_count++;
 }
 
 void test_expire_func_2(void *data)
@@ -41,6 +43,30 @@ void test_expire_func_2(void *data)
     expire_check[index]++;
 }
 
+/*
+ * A timing wheel may wake up once more, without expiring anything,
+ * when timers are moved down from an upper level.
+ * The rbtree manager must expire on the first wake-up.
+ */
+static void test_poll_expire(
+        ogs_pollset_t *pollset, ogs_timer_mgr_t *timer, void *data)
+{
+    int count = expire_count;
+
+    do {
+        ogs_pollset_poll(pollset, ogs_timer_mgr_next(timer));
+        ogs_timer_mgr_expire(timer);
+    } while (data && expire_count == count);
+}
+
+static ogs_timer_mgr_t *test_timer_mgr_create(void *data)
+{
+    if (data)
+        return ogs_timer_mgr_create_wheel(512);
+    else
+        return ogs_timer_mgr_create(512);
+}
+
 /* basic timer Test */
 static void test1_func(abts_case *tc, void *data)
 {
@@ -51,7 +77,7 @@ static void test1_func(abts_case *tc, void *data)
 
     memset(expire_check, 0, TEST_DURATION/TEST_TIMER_PRECISION);
 
-    timer = ogs_timer_mgr_create(512);
+    timer = test_timer_mgr_create(data);
     pollset = ogs_pollset_create(512);
     ogs_assert(timer);
     for(n = 0; n < sizeof(timer_duration)/sizeof(ogs_time_t); n++) {
@@ -61,8 +87,7 @@ static void test1_func(abts_case *tc, void *data)
         ogs_timer_start(timer_array[n], timer_duration[n]);
     }
 
-    ogs_pollset_poll(pollset, ogs_timer_mgr_next(timer));
-    ogs_timer_mgr_expire(timer);
+    test_poll_expire(pollset, timer, data);
 
     ABTS_INT_EQUAL(tc, 0, expire_check[0]);
     ABTS_INT_EQUAL(tc, 1, expire_check[1]);
@@ -70,8 +95,7 @@ static void test1_func(abts_case *tc, void *data)
     ABTS_INT_EQUAL(tc, 0, expire_check[3]);
     ABTS_INT_EQUAL(tc, 0, expire_check[4]);
 
-    ogs_pollset_poll(pollset, ogs_timer_mgr_next(timer));
-    ogs_timer_mgr_expire(timer);
+    test_poll_expire(pollset, timer, data);
 
     ABTS_INT_EQUAL(tc, 0, expire_check[0]);
     ABTS_INT_EQUAL(tc, 1, expire_check[1]);
@@ -79,8 +103,7 @@ static void test1_func(abts_case *tc, void *data)
     ABTS_INT_EQUAL(tc, 1, expire_check[3]);
     ABTS_INT_EQUAL(tc, 0, expire_check[4]);
 
-    ogs_pollset_poll(pollset, ogs_timer_mgr_next(timer));
-    ogs_timer_mgr_expire(timer);
+    test_poll_expire(pollset, timer, data);
 
     ABTS_INT_EQUAL(tc, 0, expire_check[0]);
     ABTS_INT_EQUAL(tc, 1, expire_check[1]);
@@ -88,8 +111,7 @@ static void test1_func(abts_case *tc, void *data)
     ABTS_INT_EQUAL(tc, 1, expire_check[3]);
     ABTS_INT_EQUAL(tc, 0, expire_check[4]);
 
-    ogs_pollset_poll(pollset, ogs_timer_mgr_next(timer));
-    ogs_timer_mgr_expire(timer);
+    test_poll_expire(pollset, timer, data);
 
     ABTS_INT_EQUAL(tc, 1, expire_check[0]);
     ABTS_INT_EQUAL(tc, 1, expire_check[1]);
@@ -97,8 +119,7 @@ static void test1_func(abts_case *tc, void *data)
     ABTS_INT_EQUAL(tc, 1, expire_check[3]);
     ABTS_INT_EQUAL(tc, 0, expire_check[4]);
 
-    ogs_pollset_poll(pollset, ogs_timer_mgr_next(timer));
-    ogs_timer_mgr_expire(timer);
+    test_poll_expire(pollset, timer, data);
     ABTS_INT_EQUAL(tc, OGS_INFINITE_TIME, ogs_timer_mgr_next(timer));
 
     ABTS_INT_EQUAL(tc, 1, expire_check[0]);
@@ -126,7 +147,7 @@ static void test2_func(abts_case *tc, void *data)
     memset(expire_check, 0, TEST_DURATION/TEST_TIMER_PRECISION);
     memset(tm_num, 0, sizeof(int)*(TEST_DURATION/TEST_TIMER_PRECISION));
 
-    timer = ogs_timer_mgr_create(512);
+    timer = test_timer_mgr_create(data);
     ogs_assert(timer);
 
     for(n = 0; n < TEST_TIMER_NUM; n++) {
@@ -168,7 +189,7 @@ static void test3_func(abts_case *tc, void *data)
     memset(expire_check, 0, TEST_DURATION/TEST_TIMER_PRECISION);
     memset(tm_num, 0, sizeof(int)*(TEST_DURATION/TEST_TIMER_PRECISION));
 
-    timer = ogs_timer_mgr_create(512);
+    timer = test_timer_mgr_create(data);
     ogs_assert(timer);
 
     for(n = 0; n < TEST_TIMER_NUM; n++) {
@@ -208,6 +229,64 @@ static void test3_func(abts_case *tc, void *data)
     ogs_timer_mgr_destroy(timer);
 }
 
+static ogs_timer_t *test4_timer[3];
+static int test4_restart;
+
+static void test4_expire_restart(void *data)
+{
+    expire_check[0]++;
+    if (--test4_restart > 0)
+        ogs_timer_start(test4_timer[0], TEST_TIMER_PRECISION);
+}
+
+static void test4_expire_stop(void *data)
+{
+    int index = (uintptr_t)data;
+
+    expire_check[index]++;
+    ogs_timer_stop(test4_timer[index == 1 ? 2 : 1]);
+}
+
+/* Restart and stop timers from within the callbacks */
+static void test4_func(abts_case *tc, void *data)
+{
+    int n = 0;
+    ogs_timer_mgr_t *timer = NULL;
+
+    memset(expire_check, 0, TEST_DURATION/TEST_TIMER_PRECISION);
+
+    timer = test_timer_mgr_create(data);
+    ogs_assert(timer);
+
+    test4_restart = 3;
+    test4_timer[0] = ogs_timer_add(timer, test4_expire_restart, NULL);
+    ogs_assert(test4_timer[0]);
+    for (n = 1; n < 3; n++) {
+        test4_timer[n] = ogs_timer_add(
+                timer, test4_expire_stop, (void*)(uintptr_t)n);
+        ogs_assert(test4_timer[n]);
+    }
+
+    ogs_timer_start(test4_timer[0], TEST_TIMER_PRECISION);
+    ogs_timer_start(test4_timer[1], TEST_TIMER_PRECISION);
+    ogs_timer_start(test4_timer[2], TEST_TIMER_PRECISION);
+
+    for (n = 0; n < 5; n++) {
+        ogs_usleep(TEST_TIMER_PRECISION + (TEST_TIMER_PRECISION >> 1));
+        ogs_timer_mgr_expire(timer);
+    }
+
+    ABTS_INT_EQUAL(tc, 3, expire_check[0]);
+    /* The tree runs every timer that was due when expiring started */
+    ABTS_INT_EQUAL(tc, data ? 1 : 2, expire_check[1] + expire_check[2]);
+    ABTS_INT_EQUAL(tc, OGS_INFINITE_TIME, ogs_timer_mgr_next(timer));
+
+    for (n = 0; n < 3; n++)
+        ogs_timer_delete(test4_timer[n]);
+
+    ogs_timer_mgr_destroy(timer);
+}
+
 abts_suite *test_timer(abts_suite *suite)
 {
     suite = ADD_SUITE(suite)
@@ -215,6 +294,13 @@ abts_suite *test_timer(abts_suite *suite)
     abts_run_test(suite, test1_func, NULL);
     abts_run_test(suite, test2_func, NULL);
     abts_run_test(suite, test3_func, NULL);
+    abts_run_test(suite, test4_func, NULL);
+
+    /* The same with a timing wheel */
+    abts_run_test(suite, test1_func, (void *)1);
+    abts_run_test(suite, test2_func, (void *)1);
+    abts_run_test(suite, test3_func, (void *)1);
+    abts_run_test(suite, test4_func, (void *)1);
 
     return suite;
 }
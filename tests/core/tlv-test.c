@@ -852,6 +852,278 @@ static void test6_func(abts_case *tc, void *data)
     ogs_pkbuf_free(req);
 }
 
+/* Every kind of IE, in every mode */
+#define TEST_TLV_SESSION_REQ_T1_L1 \
+    "01021122020333445503046677889904" \
+    "01fe0503aabbcc060007dd0801020304" \
+    "09160a0200050b04100000000b041000" \
+    "00010b04100000020c076f70656e3567" \
+    "73"
+#define TEST_TLV_SESSION_REQ_T1_L2 \
+    "01000211220200033344550300046677" \
+    "8899040001fe050003aabbcc06000007" \
+    "dd080102030409001a0a000200050b00" \
+    "04100000000b0004100000010b000410" \
+    "0000020c00076f70656e356773"
+#define TEST_TLV_SESSION_REQ_T1_L2_I1 \
+    "01000200112202000301334455030004" \
+    "006677889904000102fe05000300aabb" \
+    "cc0600000007dd080102030409001e03" \
+    "0a00020000050b000400100000000b00" \
+    "0400100000010b000400100000020c00" \
+    "07006f70656e356773"
+#define TEST_TLV_SESSION_REQ_T2_L2 \
+    "00010002112200020003334455000300" \
+    "046677889900040001fe00050003aabb" \
+    "cc0006000007dd08010203040009001e" \
+    "000a00020005000b000410000000000b" \
+    "000410000001000b000410000002000c" \
+    "00076f70656e356773"
+
+typedef struct _tlv_bearer_t {
+    ogs_tlv_presence_t presence;
+    ogs_tlv_uint16_t id;
+    ogs_tlv_uint32_t OGS_TLV_1_OR_MORE(teid);
+} tlv_bearer_t;
+
+typedef struct _tlv_session_req {
+    ogs_tlv_uint16_t u16;
+    ogs_tlv_uint24_t u24;
+    ogs_tlv_uint32_t u32;
+    ogs_tlv_int8_t i8;
+    ogs_tlv_octet_t fixed;
+    ogs_tlv_null_t null;
+    ogs_tlv_uint8_t tv_u8;
+    ogs_tlv_uint32_t tv_u32;
+    tlv_bearer_t bearer;
+    ogs_tlv_octet_t var;
+} tlv_session_req;
+
+ogs_tlv_desc_t tlv_desc_u16 =
+    { OGS_TLV_UINT16, "U16", 1, 2, 0, sizeof(ogs_tlv_uint16_t), { NULL } };
+ogs_tlv_desc_t tlv_desc_u24 =
+    { OGS_TLV_UINT24, "U24", 2, 3, 1, sizeof(ogs_tlv_uint24_t), { NULL } };
+ogs_tlv_desc_t tlv_desc_u32 =
+    { OGS_TLV_UINT32, "U32", 3, 4, 0, sizeof(ogs_tlv_uint32_t), { NULL } };
+ogs_tlv_desc_t tlv_desc_i8 =
+    { OGS_TLV_INT8, "I8", 4, 1, 2, sizeof(ogs_tlv_int8_t), { NULL } };
+ogs_tlv_desc_t tlv_desc_fixed =
+    { OGS_TLV_FIXED_STR, "Fixed", 5, 3, 0, sizeof(ogs_tlv_octet_t), { NULL } };
+ogs_tlv_desc_t tlv_desc_null =
+    { OGS_TLV_NULL, "Null", 6, 0, 0, sizeof(ogs_tlv_null_t), { NULL } };
+ogs_tlv_desc_t tlv_desc_tv_u8 =
+    { OGS_TV_UINT8, "TV U8", 7, 1, 0, sizeof(ogs_tlv_uint8_t), { NULL } };
+ogs_tlv_desc_t tlv_desc_tv_u32 =
+    { OGS_TV_UINT32, "TV U32", 8, 4, 0, sizeof(ogs_tlv_uint32_t), { NULL } };
+ogs_tlv_desc_t tlv_desc_bearer_id =
+    { OGS_TLV_UINT16, "Bearer ID", 10, 2, 0, sizeof(ogs_tlv_uint16_t),
+      { NULL } };
+ogs_tlv_desc_t tlv_desc_bearer_teid =
+    { OGS_TLV_UINT32, "TEID", 11, 4, 0, sizeof(ogs_tlv_uint32_t), { NULL } };
+ogs_tlv_desc_t tlv_desc_bearer = {
+    OGS_TLV_COMPOUND, "Bearer", 9, 0, 3, sizeof(tlv_bearer_t), {
+    &tlv_desc_bearer_id,
+    &tlv_desc_bearer_teid, &ogs_tlv_desc_more16,
+    NULL,
+}};
+ogs_tlv_desc_t tlv_desc_var =
+    { OGS_TLV_VAR_STR, "Var", 12, 0, 0, sizeof(ogs_tlv_octet_t), { NULL } };
+
+ogs_tlv_desc_t tlv_desc_session_req = {
+    OGS_TLV_MESSAGE, "Session Req", 0, 0, 0, 0, {
+    &tlv_desc_u16,
+    &tlv_desc_u24,
+    &tlv_desc_u32,
+    &tlv_desc_i8,
+    &tlv_desc_fixed,
+    &tlv_desc_null,
+    &tlv_desc_tv_u8,
+    &tlv_desc_tv_u32,
+    &tlv_desc_bearer,
+    &tlv_desc_var,
+    NULL,
+}};
+
+static void test7_func(abts_case *tc, void *data)
+{
+    int mode = (intptr_t)data;
+    tlv_session_req req;
+    ogs_pkbuf_t *pkbuf = NULL, *pkbuf2 = NULL;
+    const char *expected = NULL;
+    char testbuf[1024];
+    int i;
+
+    memset(&req, 0, sizeof(req));
+    req.u16.presence = 1;
+    req.u16.u16 = 0x1122;
+    req.u24.presence = 1;
+    req.u24.u24 = 0x334455;
+    req.u32.presence = 1;
+    req.u32.u32 = 0x66778899;
+    req.i8.presence = 1;
+    req.i8.i8 = -2;
+    req.fixed.presence = 1;
+    req.fixed.data = (uint8_t *)"\xaa\xbb\xcc";
+    req.fixed.len = 3;
+    req.null.presence = 1;
+    req.tv_u8.presence = 1;
+    req.tv_u8.u8 = 0xdd;
+    req.tv_u32.presence = 1;
+    req.tv_u32.u32 = 0x01020304;
+    req.bearer.presence = 1;
+    req.bearer.id.presence = 1;
+    req.bearer.id.u16 = 5;
+    for (i = 0; i < 3; i++) {
+        req.bearer.teid[i].presence = 1;
+        req.bearer.teid[i].u32 = 0x10000000 + i;
+    }
+    req.var.presence = 1;
+    req.var.data = (uint8_t *)"open5gs";
+    req.var.len = 7;
+
+    switch (mode) {
+    case OGS_TLV_MODE_T1_L1:
+        expected = TEST_TLV_SESSION_REQ_T1_L1;
+        break;
+    case OGS_TLV_MODE_T1_L2:
+        expected = TEST_TLV_SESSION_REQ_T1_L2;
+        break;
+    case OGS_TLV_MODE_T1_L2_I1:
+        expected = TEST_TLV_SESSION_REQ_T1_L2_I1;
+        break;
+    case OGS_TLV_MODE_T2_L2:
+        expected = TEST_TLV_SESSION_REQ_T2_L2;
+        break;
+    default:
+        ABTS_TRUE(tc, 0);
+        return;
+    }
+
+    pkbuf = ogs_tlv_build_msg(&tlv_desc_session_req, &req, mode);
+    ABTS_PTR_NOTNULL(tc, pkbuf);
+    ABTS_INT_EQUAL(tc, strlen(expected) / 2, pkbuf->len);
+    ABTS_TRUE(tc, memcmp(pkbuf->data,
+        ogs_hex_from_string(expected, testbuf, sizeof(testbuf)),
+        pkbuf->len) == 0);
+
+    /* The message is left as it was */
+    pkbuf2 = ogs_tlv_build_msg(&tlv_desc_session_req, &req, mode);
+    ABTS_PTR_NOTNULL(tc, pkbuf2);
+    ABTS_INT_EQUAL(tc, pkbuf->len, pkbuf2->len);
+    ABTS_TRUE(tc, memcmp(pkbuf->data, pkbuf2->data, pkbuf->len) == 0);
+    ogs_pkbuf_free(pkbuf2);
+    ogs_pkbuf_free(pkbuf);
+
+    /* An empty grouped IE cannot be built */
+    memset(&req, 0, sizeof(req));
+    req.bearer.presence = 1;
+    pkbuf = ogs_tlv_build_msg(&tlv_desc_session_req, &req, mode);
+    ABTS_PTR_EQUAL(tc, NULL, pkbuf);
+}
+
+typedef struct _tlv_session_mod {
+    ogs_tlv_uint16_t u16;
+    tlv_bearer_t bearer[4];
+    ogs_tlv_octet_t var;
+} tlv_session_mod;
+
+ogs_tlv_desc_t tlv_desc_session_mod = {
+    OGS_TLV_MESSAGE, "Session Mod", 0, 0, 0, 0, {
+    &tlv_desc_u16,
+    &tlv_desc_bearer, &ogs_tlv_desc_more4,
+    &tlv_desc_var,
+    NULL,
+}};
+
+static void test8_func(abts_case *tc, void *data)
+{
+    int mode = (intptr_t)data;
+    int rv, i, j;
+    tlv_session_mod mod, mod2;
+    tlv_bearer_t bearer;
+    ogs_tlv_uint16_t u16;
+    ogs_tlv_index_t index;
+    ogs_tlv_ie_t *ie = NULL;
+    ogs_pkbuf_t *pkbuf = NULL;
+
+    memset(&mod, 0, sizeof(mod));
+    mod.u16.presence = 1;
+    mod.u16.u16 = 0x1122;
+    for (i = 0; i < 3; i++) {
+        mod.bearer[i].presence = 1;
+        mod.bearer[i].id.presence = 1;
+        mod.bearer[i].id.u16 = 5 + i;
+        for (j = 0; j <= i; j++) {
+            mod.bearer[i].teid[j].presence = 1;
+            mod.bearer[i].teid[j].u32 = 0x10000000 + i * 16 + j;
+        }
+    }
+    mod.var.presence = 1;
+    mod.var.data = (uint8_t *)"open5gs";
+    mod.var.len = 7;
+
+    pkbuf = ogs_tlv_build_msg(&tlv_desc_session_mod, &mod, mode);
+    ABTS_PTR_NOTNULL(tc, pkbuf);
+
+    /* Full decode */
+    memset(&mod2, 0, sizeof(mod2));
+    rv = ogs_tlv_parse_msg(&mod2, &tlv_desc_session_mod, pkbuf, mode);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    ABTS_INT_EQUAL(tc, 0x1122, mod2.u16.u16);
+    for (i = 0; i < 3; i++) {
+        ABTS_INT_EQUAL(tc, 1, mod2.bearer[i].presence);
+        ABTS_INT_EQUAL(tc, 5 + i, mod2.bearer[i].id.u16);
+        for (j = 0; j <= i; j++)
+            ABTS_INT_EQUAL(tc, 0x10000000 + i * 16 + j,
+                    mod2.bearer[i].teid[j].u32);
+        ABTS_INT_EQUAL(tc, 0, mod2.bearer[i].teid[j].presence);
+    }
+    ABTS_INT_EQUAL(tc, 0, mod2.bearer[3].presence);
+    ABTS_INT_EQUAL(tc, 7, mod2.var.len);
+    ABTS_TRUE(tc, memcmp(mod2.var.data, "open5gs", 7) == 0);
+
+    /* Lazy decode */
+    rv = ogs_tlv_index_msg(&index, pkbuf, mode);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    ABTS_INT_EQUAL(tc, 5, index.num_of_ie);
+
+    ie = ogs_tlv_index_find(&index, 9, 3, 2);
+    ABTS_PTR_NOTNULL(tc, ie);
+    ABTS_PTR_EQUAL(tc, NULL, ogs_tlv_index_find(&index, 9, 3, 3));
+    ABTS_PTR_EQUAL(tc, NULL, ogs_tlv_index_find(&index, 9, 0, 0));
+
+    rv = ogs_tlv_parse_ie(&bearer, &tlv_desc_bearer, &index, 1);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    ABTS_INT_EQUAL(tc, 1, bearer.presence);
+    ABTS_INT_EQUAL(tc, 6, bearer.id.u16);
+    ABTS_INT_EQUAL(tc, 0x10000010, bearer.teid[0].u32);
+    ABTS_INT_EQUAL(tc, 0x10000011, bearer.teid[1].u32);
+    ABTS_INT_EQUAL(tc, 0, bearer.teid[2].presence);
+
+    rv = ogs_tlv_parse_ie(&bearer, &tlv_desc_bearer, &index, 3);
+    ABTS_INT_EQUAL(tc, OGS_NOTFOUND, rv);
+    ABTS_INT_EQUAL(tc, 0, bearer.presence);
+
+    rv = ogs_tlv_parse_ie(&u16, &tlv_desc_u16, &index, 0);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    ABTS_INT_EQUAL(tc, 0x1122, u16.u16);
+
+    ogs_pkbuf_free(pkbuf);
+
+    /* Truncated message */
+    pkbuf = ogs_tlv_build_msg(&tlv_desc_session_mod, &mod, mode);
+    ABTS_PTR_NOTNULL(tc, pkbuf);
+    ogs_pkbuf_trim(pkbuf, pkbuf->len - 1);
+
+    rv = ogs_tlv_index_msg(&index, pkbuf, mode);
+    ABTS_INT_EQUAL(tc, OGS_ERROR, rv);
+    memset(&mod2, 0, sizeof(mod2));
+    rv = ogs_tlv_parse_msg(&mod2, &tlv_desc_session_mod, pkbuf, mode);
+    ABTS_INT_EQUAL(tc, OGS_ERROR, rv);
+
+    ogs_pkbuf_free(pkbuf);
+}
+
 abts_suite *test_tlv(abts_suite *suite)
 {
     suite = ADD_SUITE(suite)
@@ -875,6 +1147,11 @@ abts_suite *test_tlv(abts_suite *suite)
     abts_run_test(suite, test5_func, (void*)OGS_TLV_MODE_T1_L2_I1);
 
     abts_run_test(suite, test6_func, NULL);
+    abts_run_test(suite, test7_func, (void*)OGS_TLV_MODE_T1_L1);
+    abts_run_test(suite, test7_func, (void*)OGS_TLV_MODE_T1_L2);
+    abts_run_test(suite, test7_func, (void*)OGS_TLV_MODE_T1_L2_I1);
+    abts_run_test(suite, test7_func, (void*)OGS_TLV_MODE_T2_L2);
+    abts_run_test(suite, test8_func, (void*)OGS_TLV_MODE_T1_L2_I1);
 
     return suite;
 }
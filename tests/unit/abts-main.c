@@ -25,6 +25,7 @@ extern int __ogs_ngap_domain;
 extern int __ogs_nas_domain;
 extern int __ogs_gtp_domain;
 extern int __ogs_sbi_domain;
+extern int __ogs_pfcp_domain;
 
 void ogs_sbi_message_init(int num_of_request_pool, int num_of_response_pool);
 void ogs_sbi_message_final(void);
@@ -35,8 +36,14 @@ abts_suite *test_nas_message(abts_suite *suite);
 abts_suite *test_gtp_message(abts_suite *suite);
 abts_suite *test_ngap_message(abts_suite *suite);
 abts_suite *test_sbi_message(abts_suite *suite);
+abts_suite *test_sbi_context(abts_suite *suite);
+abts_suite *test_sbi_client(abts_suite *suite);
 abts_suite *test_security(abts_suite *suite);
 abts_suite *test_crash(abts_suite *suite);
+abts_suite *test_pfcp_rule(abts_suite *suite);
+abts_suite *test_pfcp_qer(abts_suite *suite);
+abts_suite *test_pfcp_message(abts_suite *suite);
+abts_suite *test_tun(abts_suite *suite);
 
 const struct testlist {
     abts_suite *(*func)(abts_suite *suite);
@@ -47,8 +54,14 @@ const struct testlist {
     {test_gtp_message},
     {test_ngap_message},
     {test_sbi_message},
+    {test_sbi_context},
+    {test_sbi_client},
     {test_security},
     {test_crash},
+    {test_pfcp_rule},
+    {test_pfcp_qer},
+    {test_pfcp_message},
+    {test_tun},
     {NULL},
 };
 
@@ -107,6 +120,7 @@ int main(int argc, const char *const argv[])
     ogs_log_install_domain(&__ogs_nas_domain, "nas", OGS_LOG_ERROR);
     ogs_log_install_domain(&__ogs_gtp_domain, "gtp", OGS_LOG_ERROR);
     ogs_log_install_domain(&__ogs_sbi_domain, "sbi", OGS_LOG_ERROR);
+    ogs_log_install_domain(&__ogs_pfcp_domain, "pfcp", OGS_LOG_ERROR);
 
     atexit(terminate);
 
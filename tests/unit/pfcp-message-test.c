@@ -0,0 +1,270 @@
+/*
+ * Copyright (C) 2019-2023 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ogs-pfcp.h"
+#include "core/abts.h"
+
+#define TEST_SEID 0x1122334455667788ULL
+#define TEST_XID 0x123456
+
+static uint8_t f_seid[13] = {
+    0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2a,
+    0x0a, 0x0b, 0x0c, 0x0d };
+static uint8_t f_teid[9] = {
+    0x01, 0x00, 0x00, 0x00, 0x01, 0x0a, 0x00, 0x00, 0x01 };
+
+/* Session Establishment Response with the IEs the SMF decodes */
+static ogs_pkbuf_t *build_response(int num_of_created_pdr)
+{
+    ogs_pfcp_message_t *message = NULL;
+    ogs_pfcp_session_establishment_response_t *rsp = NULL;
+    ogs_pfcp_header_t *h = NULL;
+    ogs_pkbuf_t *pkbuf = NULL;
+    int i;
+
+    message = ogs_calloc(1, sizeof(*message));
+    ogs_assert(message);
+    message->h.type = OGS_PFCP_SESSION_ESTABLISHMENT_RESPONSE_TYPE;
+    rsp = &message->pfcp_session_establishment_response;
+
+    rsp->cause.presence = 1;
+    rsp->cause.u8 = OGS_PFCP_CAUSE_REQUEST_ACCEPTED;
+
+    rsp->up_f_seid.presence = 1;
+    rsp->up_f_seid.data = f_seid;
+    rsp->up_f_seid.len = sizeof(f_seid);
+
+    for (i = 0; i < num_of_created_pdr; i++) {
+        rsp->created_pdr[i].presence = 1;
+        rsp->created_pdr[i].pdr_id.presence = 1;
+        rsp->created_pdr[i].pdr_id.u16 = i + 1;
+        if (i % 2 == 0) {
+            rsp->created_pdr[i].local_f_teid.presence = 1;
+            rsp->created_pdr[i].local_f_teid.data = f_teid;
+            rsp->created_pdr[i].local_f_teid.len = sizeof(f_teid);
+        }
+    }
+
+    pkbuf = ogs_pfcp_build_msg(message);
+    ogs_assert(pkbuf);
+    ogs_free(message);
+
+    ogs_assert(ogs_pkbuf_push(pkbuf, OGS_PFCP_HEADER_LEN));
+    h = (ogs_pfcp_header_t *)pkbuf->data;
+    memset(h, 0, OGS_PFCP_HEADER_LEN);
+    h->version = OGS_PFCP_VERSION;
+    h->seid_presence = 1;
+    h->type = OGS_PFCP_SESSION_ESTABLISHMENT_RESPONSE_TYPE;
+    h->length = htobe16(pkbuf->len - 4);
+    h->seid = htobe64(TEST_SEID);
+    h->sqn = OGS_PFCP_XID_TO_SQN(TEST_XID);
+
+    return pkbuf;
+}
+
+/* Find the n-th top-level IE of the given type after the header */
+static uint8_t *find_ie(ogs_pkbuf_t *pkbuf, uint16_t type, int n)
+{
+    uint8_t *pos = pkbuf->data + OGS_PFCP_HEADER_LEN;
+    uint8_t *end = pkbuf->data + pkbuf->len;
+
+    while (pos + 4 <= end) {
+        if (((pos[0] << 8) | pos[1]) == type && n-- == 0)
+            return pos;
+        pos += 4 + ((pos[2] << 8) | pos[3]);
+    }
+
+    ogs_assert_if_reached();
+    return NULL;
+}
+
+static void pfcp_message_test1(abts_case *tc, void *data)
+{
+    ogs_pkbuf_t *pkbuf = NULL, *copy = NULL;
+    ogs_pfcp_message_t *message = NULL;
+    ogs_pfcp_session_establishment_response_t *rsp = NULL;
+    ogs_pfcp_index_message_t *index_message = NULL;
+    ogs_pfcp_tlv_cause_t cause;
+    ogs_pfcp_tlv_f_seid_t up_f_seid;
+    ogs_pfcp_tlv_created_pdr_t created_pdr;
+    ogs_pfcp_tlv_node_id_t node_id;
+    int i;
+
+    pkbuf = build_response(5);
+    copy = ogs_pkbuf_copy(pkbuf);
+    ogs_assert(copy);
+
+    message = ogs_pfcp_parse_msg(copy);
+    ABTS_PTR_NOTNULL(tc, message);
+    rsp = &message->pfcp_session_establishment_response;
+
+    index_message = ogs_pfcp_index_msg(pkbuf);
+    ABTS_PTR_NOTNULL(tc, index_message);
+
+    /* The header is the same as with the full decode */
+    ABTS_INT_EQUAL(tc, message->h.type, index_message->h.type);
+    ABTS_TRUE(tc, index_message->h.seid == TEST_SEID);
+    ABTS_TRUE(tc, index_message->h.seid == message->h.seid);
+    ABTS_INT_EQUAL(tc, message->h.sqn, index_message->h.sqn);
+    ABTS_INT_EQUAL(tc, TEST_XID, OGS_PFCP_SQN_TO_XID(index_message->h.sqn));
+
+    /* And so is every IE decoded on demand */
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_pfcp_parse_ie(
+                &cause, &ogs_pfcp_tlv_desc_cause, index_message, 0));
+    ABTS_INT_EQUAL(tc, rsp->cause.presence, cause.presence);
+    ABTS_INT_EQUAL(tc, rsp->cause.u8, cause.u8);
+
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_pfcp_parse_ie(
+                &up_f_seid, &ogs_pfcp_tlv_desc_f_seid, index_message, 0));
+    ABTS_INT_EQUAL(tc, 1, up_f_seid.presence);
+    ABTS_INT_EQUAL(tc, rsp->up_f_seid.len, up_f_seid.len);
+    ABTS_TRUE(tc, memcmp(f_seid, up_f_seid.data, sizeof(f_seid)) == 0);
+    ABTS_TRUE(tc, memcmp(rsp->up_f_seid.data,
+                up_f_seid.data, up_f_seid.len) == 0);
+
+    for (i = 0; i < OGS_MAX_NUM_OF_PDR; i++) {
+        int rv = ogs_pfcp_parse_ie(&created_pdr,
+                &ogs_pfcp_tlv_desc_created_pdr, index_message, i);
+
+        ABTS_INT_EQUAL(tc, i < 5 ? OGS_OK : OGS_NOTFOUND, rv);
+        ABTS_INT_EQUAL(tc, rsp->created_pdr[i].presence,
+                created_pdr.presence);
+        if (!created_pdr.presence)
+            continue;
+
+        ABTS_INT_EQUAL(tc, i + 1, created_pdr.pdr_id.u16);
+        ABTS_INT_EQUAL(tc, rsp->created_pdr[i].pdr_id.u16,
+                created_pdr.pdr_id.u16);
+        ABTS_INT_EQUAL(tc, rsp->created_pdr[i].local_f_teid.presence,
+                created_pdr.local_f_teid.presence);
+        ABTS_INT_EQUAL(tc, rsp->created_pdr[i].local_f_teid.len,
+                created_pdr.local_f_teid.len);
+        if (created_pdr.local_f_teid.presence)
+            ABTS_TRUE(tc, memcmp(f_teid, created_pdr.local_f_teid.data,
+                        sizeof(f_teid)) == 0);
+    }
+
+    /* An absent IE is not an error, and is cleared */
+    memset(&node_id, 0xff, sizeof(node_id));
+    ABTS_INT_EQUAL(tc, OGS_NOTFOUND, ogs_pfcp_parse_ie(
+                &node_id, &ogs_pfcp_tlv_desc_node_id, index_message, 0));
+    ABTS_INT_EQUAL(tc, 0, node_id.presence);
+    ABTS_INT_EQUAL(tc, OGS_NOTFOUND, ogs_pfcp_parse_ie(
+                &cause, &ogs_pfcp_tlv_desc_cause, index_message, 1));
+    ABTS_INT_EQUAL(tc, 0, cause.presence);
+
+    ogs_pfcp_index_message_free(index_message);
+    ogs_pfcp_message_free(message);
+    ogs_pkbuf_free(copy);
+    ogs_pkbuf_free(pkbuf);
+}
+
+static void pfcp_message_test2(abts_case *tc, void *data)
+{
+    ogs_pkbuf_t *pkbuf = NULL, *copy = NULL;
+    ogs_pfcp_message_t *message = NULL;
+    ogs_pfcp_index_message_t *index_message = NULL;
+    ogs_pfcp_tlv_cause_t cause;
+    ogs_pfcp_tlv_created_pdr_t created_pdr;
+    uint8_t *ie = NULL;
+
+    /* The PDR ID of the second Created PDR runs past its parent */
+    pkbuf = build_response(3);
+    ie = find_ie(pkbuf, OGS_PFCP_CREATED_PDR_TYPE, 1);
+    ABTS_INT_EQUAL(tc, OGS_PFCP_PDR_ID_TYPE, (ie[4] << 8) | ie[5]);
+    ie[7] = 0x40;
+
+    /* The full decode rejects the whole message */
+    copy = ogs_pkbuf_copy(pkbuf);
+    ogs_assert(copy);
+    message = ogs_pfcp_parse_msg(copy);
+    ABTS_PTR_EQUAL(tc, NULL, message);
+    ogs_pkbuf_free(copy);
+
+    /* The index only locates the top-level IEs */
+    index_message = ogs_pfcp_index_msg(pkbuf);
+    ABTS_PTR_NOTNULL(tc, index_message);
+
+    /* So the malformed IE is caught when it is decoded */
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_pfcp_parse_ie(&created_pdr,
+                &ogs_pfcp_tlv_desc_created_pdr, index_message, 0));
+    ABTS_INT_EQUAL(tc, 1, created_pdr.pdr_id.u16);
+    ABTS_INT_EQUAL(tc, OGS_ERROR, ogs_pfcp_parse_ie(&created_pdr,
+                &ogs_pfcp_tlv_desc_created_pdr, index_message, 1));
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_pfcp_parse_ie(&created_pdr,
+                &ogs_pfcp_tlv_desc_created_pdr, index_message, 2));
+    ABTS_INT_EQUAL(tc, 3, created_pdr.pdr_id.u16);
+
+    /* without spoiling the others */
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_pfcp_parse_ie(
+                &cause, &ogs_pfcp_tlv_desc_cause, index_message, 0));
+    ABTS_INT_EQUAL(tc, OGS_PFCP_CAUSE_REQUEST_ACCEPTED, cause.u8);
+
+    ogs_pfcp_index_message_free(index_message);
+    ogs_pkbuf_free(pkbuf);
+}
+
+static void pfcp_message_test3(abts_case *tc, void *data)
+{
+    ogs_pkbuf_t *pkbuf = NULL;
+    ogs_pfcp_index_message_t *index_message = NULL;
+    ogs_pfcp_tlv_created_pdr_t created_pdr;
+    uint8_t *ie = NULL;
+
+    /* A top-level IE running past the message fails the index */
+    pkbuf = build_response(2);
+    ie = find_ie(pkbuf, OGS_PFCP_CREATED_PDR_TYPE, 1);
+    ie[2] = 0x10;
+    ABTS_PTR_EQUAL(tc, NULL, ogs_pfcp_index_msg(pkbuf));
+    ogs_pkbuf_free(pkbuf);
+
+    /* So does a message cut short in the header */
+    pkbuf = build_response(1);
+    ogs_pkbuf_trim(pkbuf, OGS_PFCP_HEADER_LEN - 1);
+    ABTS_PTR_EQUAL(tc, NULL, ogs_pfcp_index_msg(pkbuf));
+    ogs_pkbuf_free(pkbuf);
+
+    /* A grouped IE without any content is malformed */
+    pkbuf = build_response(2);
+    ie = find_ie(pkbuf, OGS_PFCP_CREATED_PDR_TYPE, 1);
+    ie[2] = 0;
+    ie[3] = 0;
+    ogs_pkbuf_trim(pkbuf, ie + 4 - pkbuf->data);
+
+    index_message = ogs_pfcp_index_msg(pkbuf);
+    ABTS_PTR_NOTNULL(tc, index_message);
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_pfcp_parse_ie(&created_pdr,
+                &ogs_pfcp_tlv_desc_created_pdr, index_message, 0));
+    ABTS_INT_EQUAL(tc, OGS_ERROR, ogs_pfcp_parse_ie(&created_pdr,
+                &ogs_pfcp_tlv_desc_created_pdr, index_message, 1));
+
+    ogs_pfcp_index_message_free(index_message);
+    ogs_pkbuf_free(pkbuf);
+}
+
+abts_suite *test_pfcp_message(abts_suite *suite)
+{
+    suite = ADD_SUITE(suite)
+
+    abts_run_test(suite, pfcp_message_test1, NULL);
+    abts_run_test(suite, pfcp_message_test2, NULL);
+    abts_run_test(suite, pfcp_message_test3, NULL);
+
+    return suite;
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2019-2023 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ogs-pfcp.h"
+#include "core/abts.h"
+
+#define T0 ogs_time_from_sec(1000)
+
+static ogs_pkbuf_t *packet(int len)
+{
+    ogs_pkbuf_t *pkbuf = NULL;
+
+    pkbuf = ogs_pkbuf_alloc(NULL, len);
+    ogs_assert(pkbuf);
+    ogs_pkbuf_put(pkbuf, len);
+
+    return pkbuf;
+}
+
+/* Send 'count' packets and return how many passed */
+static int qer_send(ogs_pfcp_qer_t *qer, bool uplink,
+        int count, int len, ogs_time_t now)
+{
+    ogs_pkbuf_t *pkbuf = packet(len);
+    int i, passed = 0;
+
+    for (i = 0; i < count; i++)
+        if (ogs_pfcp_up_handle_qer(qer, uplink, pkbuf, now) == true)
+            passed++;
+
+    ogs_pkbuf_free(pkbuf);
+
+    return passed;
+}
+
+static void pfcp_qer_test1(abts_case *tc, void *data)
+{
+    ogs_pfcp_qer_t qer;
+
+    /* A closed gate drops whatever the MBR */
+    memset(&qer, 0, sizeof(qer));
+    qer.gate_status.uplink = OGS_PFCP_GATE_CLOSE;
+
+    ABTS_INT_EQUAL(tc, 0, qer_send(&qer, true, 3, 100, T0));
+    ABTS_INT_EQUAL(tc, 3, qer.bucket.uplink.dropped_pkts);
+    ABTS_INT_EQUAL(tc, 300, qer.bucket.uplink.dropped_octets);
+
+    qer.mbr.uplink = 1000000000;
+    ABTS_INT_EQUAL(tc, 0, qer_send(&qer, true, 1, 100, T0));
+    ABTS_INT_EQUAL(tc, 4, qer.bucket.uplink.dropped_pkts);
+    ABTS_INT_EQUAL(tc, 400, qer.bucket.uplink.dropped_octets);
+
+    /* Without MBR an open gate is not policed */
+    ABTS_INT_EQUAL(tc, 100, qer_send(&qer, false, 100, 1500, T0));
+    ABTS_INT_EQUAL(tc, 0, qer.bucket.downlink.dropped_pkts);
+    ABTS_INT_EQUAL(tc, 0, qer.bucket.downlink.tokens);
+
+    /* Opening the gate again */
+    qer.gate_status.uplink = OGS_PFCP_GATE_OPEN;
+    ABTS_INT_EQUAL(tc, 1, qer_send(&qer, true, 1, 100, T0));
+    ABTS_INT_EQUAL(tc, 4, qer.bucket.uplink.dropped_pkts);
+}
+
+static void pfcp_qer_test2(abts_case *tc, void *data)
+{
+    ogs_pfcp_qer_t qer;
+
+    /* 1,000,000 octets/s holds 100,000 octets (100ms) */
+    memset(&qer, 0, sizeof(qer));
+    qer.mbr.downlink = 8000000;
+
+    ABTS_INT_EQUAL(tc, 100, qer_send(&qer, false, 101, 1000, T0));
+    ABTS_INT_EQUAL(tc, 1, qer.bucket.downlink.dropped_pkts);
+    ABTS_INT_EQUAL(tc, 1000, qer.bucket.downlink.dropped_octets);
+
+    /* 1ms refills 1,000 octets */
+    ABTS_INT_EQUAL(tc, 1, qer_send(&qer, false, 2, 1000,
+                T0 + ogs_time_from_msec(1)));
+
+    /* A long idle time does not refill beyond the burst */
+    ABTS_INT_EQUAL(tc, 100, qer_send(&qer, false, 101, 1000,
+                T0 + ogs_time_from_sec(10)));
+    ABTS_INT_EQUAL(tc, 99, qer_send(&qer, false, 101, 1000,
+                T0 + ogs_time_from_sec(10) + ogs_time_from_msec(99)));
+
+    /* Nor within 100ms */
+    memset(&qer.bucket, 0, sizeof(qer.bucket));
+    ABTS_INT_EQUAL(tc, 1, qer_send(&qer, false, 1, 1000, T0));
+    ABTS_INT_EQUAL(tc, 99000, qer.bucket.downlink.tokens);
+    ABTS_INT_EQUAL(tc, 1, qer_send(&qer, false, 1, 0,
+                T0 + ogs_time_from_msec(99)));
+    ABTS_INT_EQUAL(tc, 100000, qer.bucket.downlink.tokens);
+
+    /* A slow flow still passes one maximum sized packet */
+    memset(&qer, 0, sizeof(qer));
+    qer.mbr.uplink = 8000;
+
+    ABTS_INT_EQUAL(tc, 1, qer_send(&qer, true, 1, OGS_MAX_PKT_LEN, T0));
+    ABTS_INT_EQUAL(tc, 0, qer_send(&qer, true, 1, 1, T0));
+
+    memset(&qer.bucket, 0, sizeof(qer.bucket));
+    ABTS_INT_EQUAL(tc, 2, qer_send(&qer, true, 3, 1000, T0));
+    ABTS_INT_EQUAL(tc, 1,
+            qer_send(&qer, true, 1, OGS_MAX_PKT_LEN - 2000, T0));
+    ABTS_INT_EQUAL(tc, 0, qer.bucket.uplink.tokens);
+
+    /* Larger than the bucket never passes */
+    memset(&qer.bucket, 0, sizeof(qer.bucket));
+    ABTS_INT_EQUAL(tc, 0, qer_send(&qer, true, 1, OGS_MAX_PKT_LEN + 1,
+                T0 + ogs_time_from_sec(10)));
+}
+
+static void pfcp_qer_test3(abts_case *tc, void *data)
+{
+    ogs_pfcp_qer_t qer;
+    ogs_time_t now;
+    int passed = 0;
+
+    /* 10,000 octets/s, one octet every 100us */
+    memset(&qer, 0, sizeof(qer));
+    qer.mbr.uplink = 80000;
+
+    ABTS_INT_EQUAL(tc, 1, qer_send(&qer, true, 1, OGS_MAX_PKT_LEN, T0));
+    ABTS_INT_EQUAL(tc, 0, qer.bucket.uplink.tokens);
+
+    /* A clock cached by another thread may be behind */
+    ABTS_INT_EQUAL(tc, 0, qer_send(&qer, true, 1, 1, T0 - 10));
+    ABTS_INT_EQUAL(tc, 0, qer.bucket.uplink.tokens);
+    ABTS_TRUE(tc, qer.bucket.uplink.last == T0);
+
+    /*
+     * 2 octets every 150us for one second. Each packet refills only
+     * 1.5 octets, and the half octets must add up to the full rate.
+     */
+    for (now = T0 + 150; now < T0 + ogs_time_from_sec(1); now += 150)
+        passed += qer_send(&qer, true, 1, 2, now);
+
+    ABTS_TRUE(tc, passed >= 4999);
+    ABTS_TRUE(tc, passed <= 5000);
+}
+
+abts_suite *test_pfcp_qer(abts_suite *suite)
+{
+    suite = ADD_SUITE(suite)
+
+    abts_run_test(suite, pfcp_qer_test1, NULL);
+    abts_run_test(suite, pfcp_qer_test2, NULL);
+    abts_run_test(suite, pfcp_qer_test3, NULL);
+
+    return suite;
+}
@@ -0,0 +1,357 @@
+/*
+ * Copyright (C) 2019-2023 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ogs-pfcp.h"
+#include "core/abts.h"
+
+#include <netinet/ip.h>
+#include <netinet/ip6.h>
+#include <netinet/udp.h>
+
+#define MAX_RESULT OGS_MAX_NUM_OF_PDR
+
+static ogs_pfcp_pdr_t *pdr_add(ogs_pfcp_sess_t *sess,
+        ogs_pfcp_precedence_t precedence, ogs_pfcp_interface_t src_if,
+        uint32_t teid, uint8_t qfi, const char *flow1, const char *flow2)
+{
+    ogs_pfcp_pdr_t *pdr = NULL;
+    ogs_pfcp_rule_t *rule = NULL;
+    const char *flow[2];
+    char buf[OGS_HUGE_LEN];
+    int i;
+
+    pdr = ogs_pfcp_pdr_add(sess);
+    ogs_assert(pdr);
+    ogs_pfcp_pdr_reorder_by_precedence(pdr, precedence);
+
+    pdr->src_if = src_if;
+    pdr->f_teid.teid = teid;
+    pdr->qfi = qfi;
+
+    flow[0] = flow1;
+    flow[1] = flow2;
+    for (i = 0; i < 2; i++) {
+        if (!flow[i])
+            continue;
+        rule = ogs_pfcp_rule_add(pdr);
+        ogs_assert(rule);
+        ogs_cpystrn(buf, flow[i], sizeof(buf));
+        ogs_assert(ogs_ipfw_compile_rule(&rule->ipfw, buf) == OGS_OK);
+    }
+
+    return pdr;
+}
+
+static ogs_pkbuf_t *packet4(uint8_t proto,
+        const char *src, const char *dst, uint16_t sport, uint16_t dport)
+{
+    ogs_pkbuf_t *pkbuf = NULL;
+    struct ip *ip_h = NULL;
+    struct udphdr *udp_h = NULL;
+
+    pkbuf = ogs_pkbuf_alloc(NULL, 64);
+    ogs_assert(pkbuf);
+    ogs_pkbuf_put(pkbuf, sizeof(*ip_h) + sizeof(*udp_h));
+    memset(pkbuf->data, 0, pkbuf->len);
+
+    ip_h = (struct ip *)pkbuf->data;
+    ip_h->ip_v = 4;
+    ip_h->ip_hl = 5;
+    ip_h->ip_p = proto;
+    ip_h->ip_len = htobe16(pkbuf->len);
+    ogs_assert(inet_pton(AF_INET, src, &ip_h->ip_src) == 1);
+    ogs_assert(inet_pton(AF_INET, dst, &ip_h->ip_dst) == 1);
+
+    udp_h = (struct udphdr *)(ip_h + 1);
+    udp_h->uh_sport = htobe16(sport);
+    udp_h->uh_dport = htobe16(dport);
+
+    return pkbuf;
+}
+
+/* With Hop-by-Hop, Destination Options and Fragment headers if 'ext' */
+static ogs_pkbuf_t *packet6(uint8_t proto, bool ext,
+        const char *src, const char *dst, uint16_t sport, uint16_t dport)
+{
+    ogs_pkbuf_t *pkbuf = NULL;
+    struct ip6_hdr *ip6_h = NULL;
+    struct udphdr *udp_h = NULL;
+    uint8_t *p;
+
+    pkbuf = ogs_pkbuf_alloc(NULL, 128);
+    ogs_assert(pkbuf);
+    ogs_pkbuf_put(pkbuf,
+            sizeof(*ip6_h) + (ext ? 8 + 16 + 8 : 0) + sizeof(*udp_h));
+    memset(pkbuf->data, 0, pkbuf->len);
+
+    ip6_h = (struct ip6_hdr *)pkbuf->data;
+    ip6_h->ip6_vfc = 0x60;
+    ip6_h->ip6_plen = htobe16(pkbuf->len - sizeof(*ip6_h));
+    ogs_assert(inet_pton(AF_INET6, src, &ip6_h->ip6_src) == 1);
+    ogs_assert(inet_pton(AF_INET6, dst, &ip6_h->ip6_dst) == 1);
+
+    p = (uint8_t *)(ip6_h + 1);
+    if (ext) {
+        ip6_h->ip6_nxt = IPPROTO_HOPOPTS;
+        p[0] = IPPROTO_DSTOPTS;         /* 8 bytes */
+        p[1] = 0;
+        p += 8;
+        p[0] = IPPROTO_FRAGMENT;        /* 16 bytes */
+        p[1] = 1;
+        p += 16;
+        p[0] = proto;                   /* Fragment, 8 bytes */
+        p += 8;
+    } else {
+        ip6_h->ip6_nxt = proto;
+    }
+
+    udp_h = (struct udphdr *)p;
+    udp_h->uh_sport = htobe16(sport);
+    udp_h->uh_dport = htobe16(dport);
+
+    return pkbuf;
+}
+
+/* What walking pdr_list with ogs_pfcp_pdr_rule_find_by_packet() gives */
+static int find_all_by_list(ogs_pfcp_sess_t *sess,
+        ogs_pfcp_pdr_match_t *match, ogs_pkbuf_t *pkbuf,
+        ogs_pfcp_pdr_t **result)
+{
+    ogs_pfcp_pdr_t *pdr = NULL;
+    int n = 0;
+
+    ogs_list_for_each(&sess->pdr_list, pdr) {
+        if (!(match->src_if & OGS_PFCP_PDR_MATCH_IF(pdr->src_if)))
+            continue;
+        if (match->teid_presence && match->teid != pdr->f_teid.teid)
+            continue;
+        if (match->qfi && match->qfi != pdr->qfi)
+            continue;
+        if (ogs_list_first(&pdr->rule_list) &&
+            ogs_pfcp_pdr_rule_find_by_packet(pdr, pkbuf) == NULL)
+            continue;
+
+        ogs_assert(n < MAX_RESULT);
+        result[n++] = pdr;
+    }
+
+    return n;
+}
+
+static int find_all(ogs_pfcp_sess_t *sess,
+        ogs_pfcp_pdr_match_t *match, ogs_pkbuf_t *pkbuf,
+        ogs_pfcp_pdr_t **result)
+{
+    ogs_pfcp_packet_key_t key;
+    ogs_pfcp_pdr_t *pdr = NULL;
+    int n = 0, pos = 0;
+
+    ogs_pfcp_packet_key_init(&key, pkbuf);
+    while ((pdr = ogs_pfcp_sess_pdr_find_by_key(sess, match, &key, &pos))) {
+        ogs_assert(n < MAX_RESULT);
+        result[n++] = pdr;
+    }
+
+    return n;
+}
+
+static ogs_pkbuf_t *packet[32];
+static int num_of_packet;
+
+static void packet_add_all(void)
+{
+    static const char *addr4[] = {
+        "10.45.0.2", "10.45.1.7", "8.8.8.8", "8.8.4.4", "192.0.2.1",
+    };
+    static const char *addr6[] = {
+        "2001:db8:cafe::2", "2001:db8:cafe:1::9", "2001:4860::8888",
+    };
+    static const uint16_t port[] = { 53, 80, 5060, 20000 };
+    static const uint8_t proto[] = { IPPROTO_UDP, IPPROTO_TCP, IPPROTO_ICMP };
+    int i;
+
+    num_of_packet = 0;
+    for (i = 0; i < 14; i++)
+        packet[num_of_packet++] = packet4(proto[i % 3],
+                addr4[i % 5], addr4[(i * 3 + 2) % 5],
+                port[(i + 1) % 4], port[i % 4]);
+    for (i = 0; i < 14; i++)
+        packet[num_of_packet++] = packet6(proto[i % 3], i & 1,
+                addr6[i % 3], addr6[(i + 1) % 3],
+                port[(i + 3) % 4], port[i % 4]);
+}
+
+static void packet_free_all(void)
+{
+    int i;
+
+    for (i = 0; i < num_of_packet; i++)
+        ogs_pkbuf_free(packet[i]);
+    num_of_packet = 0;
+}
+
+static ogs_pfcp_pdr_match_t match[6];
+static int num_of_match;
+
+static void match_add_all(void)
+{
+    int i;
+
+    memset(match, 0, sizeof(match));
+    num_of_match = 0;
+
+    /* Downlink */
+    match[num_of_match++].src_if =
+        OGS_PFCP_PDR_MATCH_IF(OGS_PFCP_INTERFACE_CORE);
+
+    /* Uplink, by TEID and by TEID and QFI */
+    for (i = 0; i < 5; i++) {
+        match[num_of_match].src_if =
+            OGS_PFCP_PDR_MATCH_IF(OGS_PFCP_INTERFACE_ACCESS) |
+            OGS_PFCP_PDR_MATCH_IF(OGS_PFCP_INTERFACE_CP_FUNCTION);
+        match[num_of_match].teid_presence = true;
+        match[num_of_match].teid = 0x100 + (i & 1);
+        match[num_of_match].qfi = i / 2;
+        num_of_match++;
+    }
+}
+
+/* Every packet and match, both ways, returns the same PDRs in order */
+static void compare_all(abts_case *tc, ogs_pfcp_sess_t *sess, int *found)
+{
+    ogs_pfcp_pdr_t *expected[MAX_RESULT], *result[MAX_RESULT];
+    int i, j, k, n;
+
+    for (i = 0; i < num_of_packet; i++) {
+        for (j = 0; j < num_of_match; j++) {
+            n = find_all_by_list(sess, &match[j], packet[i], expected);
+            ABTS_INT_EQUAL(tc, n,
+                    find_all(sess, &match[j], packet[i], result));
+            for (k = 0; k < n; k++)
+                ABTS_PTR_EQUAL(tc, expected[k], result[k]);
+            *found += n;
+        }
+    }
+}
+
+static void pfcp_rule_test1(abts_case *tc, void *data)
+{
+    ogs_pfcp_sess_t *sess = NULL;
+    ogs_pfcp_pdr_t *pdr = NULL, *tie = NULL;
+    ogs_pfcp_rule_t *rule = NULL;
+    char buf[OGS_HUGE_LEN];
+    int found;
+
+    /* Pools for a single session */
+    ogs_app()->pool.nf = 1;
+    ogs_app()->pool.sess = 1;
+    ogs_pfcp_context_init();
+
+    sess = ogs_calloc(1, sizeof(*sess));
+    ogs_assert(sess);
+    ogs_pfcp_pool_init(sess);
+
+    /* Downlink */
+    pdr_add(sess, 10, OGS_PFCP_INTERFACE_CORE, 0, 1,
+        "permit out udp from 8.8.8.0/24 53 to 10.45.0.0/16",
+        "permit out tcp from any 80 to 10.45.1.0/24 5060-20000");
+    pdr_add(sess, 20, OGS_PFCP_INTERFACE_CORE, 0, 2,
+        "permit out ip from 2001:db8:cafe::/48 to 2001:db8:cafe::2/128",
+        "permit out udp from any to 2001:4860::/32 53");
+    pdr_add(sess, 30, OGS_PFCP_INTERFACE_CORE, 0, 1,
+        "permit out icmp from any to any", NULL);
+    pdr_add(sess, 255, OGS_PFCP_INTERFACE_CORE, 0, 1, NULL, NULL);
+
+    /* Uplink */
+    pdr_add(sess, 10, OGS_PFCP_INTERFACE_ACCESS, 0x100, 1,
+        "permit out udp from 8.8.8.0/24 53 to 10.45.0.0/16", NULL);
+    pdr_add(sess, 20, OGS_PFCP_INTERFACE_ACCESS, 0x101, 2,
+        "permit out tcp from 2001:db8:cafe::/48 to any 80", NULL);
+    pdr_add(sess, 30, OGS_PFCP_INTERFACE_CP_FUNCTION, 0x100, 2,
+        "permit out ip from 10.45.0.0/16 to any", NULL);
+    pdr_add(sess, 255, OGS_PFCP_INTERFACE_ACCESS, 0x100, 1, NULL, NULL);
+    pdr_add(sess, 255, OGS_PFCP_INTERFACE_ACCESS, 0x101, 2, NULL, NULL);
+
+    /* Same precedence and filters as an existing PDR */
+    tie = pdr_add(sess, 20, OGS_PFCP_INTERFACE_CORE, 0, 2,
+        "permit out ip from 2001:db8:cafe::/48 to 2001:db8:cafe::2/128",
+        NULL);
+    pdr_add(sess, 30, OGS_PFCP_INTERFACE_ACCESS, 0x100, 2,
+        "permit out ip from 10.45.0.0/16 to any", NULL);
+
+    packet_add_all();
+    match_add_all();
+
+    /* Walking pdr_list */
+    ABTS_INT_EQUAL(tc, 0, sess->classifier.compiled);
+    found = 0;
+    compare_all(tc, sess, &found);
+
+    /* Compiled */
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_pfcp_sess_classifier_build(sess));
+    ABTS_INT_EQUAL(tc, 1, sess->classifier.compiled);
+    found = 0;
+    compare_all(tc, sess, &found);
+    ABTS_TRUE(tc, found > 0);
+
+    /* A modification makes it stale until the next build */
+    rule = ogs_pfcp_rule_add(tie);
+    ogs_assert(rule);
+    ogs_cpystrn(buf, "permit out udp from any 5060 to 10.45.0.0/16",
+            sizeof(buf));
+    ogs_assert(ogs_ipfw_compile_rule(&rule->ipfw, buf) == OGS_OK);
+    ogs_pfcp_pdr_reorder_by_precedence(tie, 5);
+    pdr = pdr_add(sess, 1, OGS_PFCP_INTERFACE_ACCESS, 0x101, 0,
+        "permit out udp from any to any 20000", NULL);
+
+    ABTS_INT_EQUAL(tc, 0, sess->classifier.compiled);
+    found = 0;
+    compare_all(tc, sess, &found);
+
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_pfcp_sess_classifier_build(sess));
+    found = 0;
+    compare_all(tc, sess, &found);
+
+    ogs_pfcp_pdr_remove(pdr);
+    ogs_pfcp_rule_remove(rule);
+    ABTS_INT_EQUAL(tc, 0, sess->classifier.compiled);
+    found = 0;
+    compare_all(tc, sess, &found);
+
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_pfcp_sess_classifier_build(sess));
+    found = 0;
+    compare_all(tc, sess, &found);
+
+    packet_free_all();
+
+    ogs_pfcp_sess_clear(sess);
+    ogs_pfcp_pool_final(sess);
+    ogs_free(sess);
+
+    ogs_pfcp_context_final();
+}
+
+abts_suite *test_pfcp_rule(abts_suite *suite)
+{
+    suite = ADD_SUITE(suite)
+
+    abts_run_test(suite, pfcp_rule_test1, NULL);
+
+    return suite;
+}
@@ -0,0 +1,305 @@
+/*
+ * Copyright (C) 2019-2023 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ogs-sbi.h"
+#include "core/abts.h"
+
+#define NUM_OF_REQUEST 5
+
+static ogs_sbi_client_t *client;
+
+static struct {
+    int status[NUM_OF_REQUEST];
+    int order[NUM_OF_REQUEST];
+    int num_of_done;
+    int peak;           /* most streams seen in flight */
+    int lost;           /* requests neither started, pending nor done */
+} result;
+
+static void sbi_client_init(int max_stream)
+{
+    /* ogs_sbi_context_init() sets up the message pools by itself */
+    ogs_sbi_message_final();
+
+    ogs_app()->pool.message = 32;
+    ogs_app()->pool.event = 32;
+    ogs_app()->pool.nf = 32;
+    ogs_app()->pool.nf_service = 32;
+    ogs_app()->pool.xact = 32;
+    ogs_app()->pool.subscription = 32;
+
+    ogs_app()->timer_mgr = ogs_timer_mgr_create(64);
+    ogs_assert(ogs_app()->timer_mgr);
+    ogs_app()->pollset = ogs_pollset_create(64);
+    ogs_assert(ogs_app()->pollset);
+
+    ogs_sbi_context_init(OpenAPI_nf_type_NRF);
+
+    ogs_sbi_self()->client.max_concurrent_streams = max_stream;
+
+    memset(&result, 0, sizeof(result));
+}
+
+static void sbi_client_final(void)
+{
+    ogs_sbi_context_final();
+
+    ogs_pollset_destroy(ogs_app()->pollset);
+    ogs_app()->pollset = NULL;
+    ogs_timer_mgr_destroy(ogs_app()->timer_mgr);
+    ogs_app()->timer_mgr = NULL;
+
+    ogs_sbi_message_init(32, 32);
+}
+
+/*
+ * A peer on 127.0.0.1. When listening, it completes the TCP handshake
+ * but never answers. Otherwise every connection is refused.
+ */
+static struct {
+    ogs_sock_t *sock;
+    ogs_sockaddr_t *addr;
+} peer;
+
+static void peer_open(bool listening)
+{
+    socklen_t addrlen;
+
+    ogs_assert(OGS_OK ==
+            ogs_getaddrinfo(&peer.addr, AF_INET, "127.0.0.1", 0, 0));
+    peer.sock = ogs_sock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    ogs_assert(peer.sock);
+    ogs_assert(OGS_OK == ogs_sock_bind(peer.sock, peer.addr));
+
+    /* Port 0 was bound, find out which one the kernel chose */
+    addrlen = sizeof(peer.addr->ss);
+    ogs_assert(getsockname(peer.sock->fd, &peer.addr->sa, &addrlen) == 0);
+
+    if (listening)
+        ogs_assert(OGS_OK == ogs_sock_listen(peer.sock));
+}
+
+static void peer_close(void)
+{
+    ogs_sock_destroy(peer.sock);
+    ogs_freeaddrinfo(peer.addr);
+}
+
+static int client_cb(int status, ogs_sbi_response_t *response, void *data)
+{
+    int i = (intptr_t)data;
+
+    ogs_assert(i >= 0 && i < NUM_OF_REQUEST);
+
+    result.status[i] = status;
+    result.order[result.num_of_done++] = i;
+
+    if (response)
+        ogs_sbi_response_free(response);
+
+    return OGS_OK;
+}
+
+static void send_request(int i, int deadline_msec)
+{
+    char buf[OGS_ADDRSTRLEN];
+    ogs_sbi_request_t *request = NULL;
+
+    /* The deadline is taken when the request is added */
+    ogs_local_conf()->time.message.sbi.connection_deadline =
+        ogs_time_from_msec(deadline_msec);
+
+    request = ogs_sbi_request_new();
+    ogs_assert(request);
+    request->h.method = ogs_strdup(OGS_SBI_HTTP_METHOD_GET);
+    ogs_assert(request->h.method);
+    request->h.uri = ogs_msprintf("http://%s:%d/nnrf-nfm/v1/nf-instances",
+            OGS_ADDR(peer.addr, buf), OGS_PORT(peer.addr));
+    ogs_assert(request->h.uri);
+
+    ogs_assert(true == ogs_sbi_client_send_request(
+                client, client_cb, request, (void *)(intptr_t)i));
+
+    ogs_sbi_request_free(request);
+}
+
+static void check_budget(void)
+{
+    if (!client)
+        return;
+
+    if (client->num_of_stream > result.peak)
+        result.peak = client->num_of_stream;
+
+    if (client->num_of_stream + ogs_list_count(&client->pending_list) +
+            result.num_of_done != NUM_OF_REQUEST)
+        result.lost++;
+}
+
+/* The main loop of a NF, until 'until' requests are done */
+static void run(int until, int duration_msec)
+{
+    ogs_time_t end = ogs_get_monotonic_time() +
+                        ogs_time_from_msec(duration_msec);
+
+    while (result.num_of_done < until && ogs_get_monotonic_time() < end) {
+        ogs_time_t timeout = ogs_timer_mgr_next(ogs_app()->timer_mgr);
+
+        if (timeout == OGS_INFINITE_TIME || timeout > ogs_time_from_msec(10))
+            timeout = ogs_time_from_msec(10);
+
+        ogs_pollset_poll(ogs_app()->pollset, timeout);
+        ogs_timer_mgr_expire(ogs_app()->timer_mgr);
+
+        check_budget();
+    }
+}
+
+static void sbi_client_test1(abts_case *tc, void *data)
+{
+    int i;
+
+    /* Refused peer : the pending requests start one by one, oldest first */
+    sbi_client_init(1);
+    peer_open(false);
+
+    client = ogs_sbi_client_add(
+            OpenAPI_uri_scheme_http, NULL, 0, peer.addr, NULL);
+    ABTS_PTR_NOTNULL(tc, client);
+
+    for (i = 0; i < NUM_OF_REQUEST; i++)
+        send_request(i, 10000);
+    ABTS_INT_EQUAL(tc, 1, client->num_of_stream);
+    ABTS_INT_EQUAL(tc, NUM_OF_REQUEST - 1,
+            ogs_list_count(&client->pending_list));
+
+    run(NUM_OF_REQUEST, 5000);
+
+    ABTS_INT_EQUAL(tc, NUM_OF_REQUEST, result.num_of_done);
+    ABTS_INT_EQUAL(tc, 1, result.peak);
+    ABTS_INT_EQUAL(tc, 0, result.lost);
+    for (i = 0; i < NUM_OF_REQUEST; i++) {
+        ABTS_INT_EQUAL(tc, i, result.order[i]);
+        ABTS_INT_EQUAL(tc, OGS_ERROR, result.status[i]);
+    }
+
+    ABTS_INT_EQUAL(tc, 0, client->num_of_stream);
+    ABTS_INT_EQUAL(tc, 0, ogs_list_count(&client->pending_list));
+    ABTS_INT_EQUAL(tc, 0, ogs_list_count(&client->connection_list));
+
+    ogs_sbi_client_remove(client);
+    client = NULL;
+
+    peer_close();
+    sbi_client_final();
+}
+
+static void sbi_client_test2(abts_case *tc, void *data)
+{
+    int i;
+
+    /* Silent peer : deadlines in flight and in the pending list */
+    sbi_client_init(1);
+    peer_open(true);
+
+    client = ogs_sbi_client_add(
+            OpenAPI_uri_scheme_http, NULL, 0, peer.addr, NULL);
+    ABTS_PTR_NOTNULL(tc, client);
+
+    send_request(0, 200);
+    for (i = 1; i < NUM_OF_REQUEST; i++)
+        send_request(i, 100);
+    ABTS_INT_EQUAL(tc, 1, client->num_of_stream);
+    ABTS_INT_EQUAL(tc, NUM_OF_REQUEST - 1,
+            ogs_list_count(&client->pending_list));
+
+    /* Expired while pending : never started */
+    run(NUM_OF_REQUEST - 1, 5000);
+    ABTS_INT_EQUAL(tc, NUM_OF_REQUEST - 1, result.num_of_done);
+    for (i = 0; i < NUM_OF_REQUEST - 1; i++)
+        ABTS_INT_EQUAL(tc, i + 1, result.order[i]);
+    ABTS_INT_EQUAL(tc, 1, client->num_of_stream);
+    ABTS_INT_EQUAL(tc, 0, ogs_list_count(&client->pending_list));
+
+    /* Expired in flight : the stream is given back */
+    run(NUM_OF_REQUEST, 5000);
+    ABTS_INT_EQUAL(tc, 0, result.order[NUM_OF_REQUEST - 1]);
+
+    ABTS_INT_EQUAL(tc, NUM_OF_REQUEST, result.num_of_done);
+    ABTS_INT_EQUAL(tc, 1, result.peak);
+    ABTS_INT_EQUAL(tc, 0, result.lost);
+    for (i = 0; i < NUM_OF_REQUEST; i++)
+        ABTS_INT_EQUAL(tc, OGS_TIMEUP, result.status[i]);
+
+    ABTS_INT_EQUAL(tc, 0, client->num_of_stream);
+    ABTS_INT_EQUAL(tc, 0, ogs_list_count(&client->connection_list));
+
+    ogs_sbi_client_remove(client);
+    client = NULL;
+
+    peer_close();
+    sbi_client_final();
+}
+
+static void sbi_client_test3(abts_case *tc, void *data)
+{
+    int i;
+
+    /* Stopping and removing a client with requests still pending */
+    sbi_client_init(2);
+    peer_open(true);
+
+    client = ogs_sbi_client_add(
+            OpenAPI_uri_scheme_http, NULL, 0, peer.addr, NULL);
+    ABTS_PTR_NOTNULL(tc, client);
+
+    for (i = 0; i < NUM_OF_REQUEST; i++)
+        send_request(i, 100);
+    ABTS_INT_EQUAL(tc, 2, client->num_of_stream);
+    ABTS_INT_EQUAL(tc, NUM_OF_REQUEST - 2,
+            ogs_list_count(&client->pending_list));
+
+    /* Every request is told, in flight or not */
+    ogs_sbi_client_stop(client);
+    ABTS_INT_EQUAL(tc, NUM_OF_REQUEST, result.num_of_done);
+    for (i = 0; i < NUM_OF_REQUEST; i++)
+        ABTS_INT_EQUAL(tc, OGS_DONE, result.status[i]);
+
+    /* No request is started, and no deadline fires after removal */
+    memset(&result, 0, sizeof(result));
+    ogs_sbi_client_remove(client);
+    client = NULL;
+
+    run(NUM_OF_REQUEST, 300);
+    ABTS_INT_EQUAL(tc, 0, result.num_of_done);
+
+    peer_close();
+    sbi_client_final();
+}
+
+abts_suite *test_sbi_client(abts_suite *suite)
+{
+    suite = ADD_SUITE(suite)
+
+    abts_run_test(suite, sbi_client_test1, NULL);
+    abts_run_test(suite, sbi_client_test2, NULL);
+    abts_run_test(suite, sbi_client_test3, NULL);
+
+    return suite;
+}
@@ -0,0 +1,716 @@
+/*
+ * Copyright (C) 2019-2023 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ogs-sbi.h"
+#include "core/abts.h"
+
+#define NUM_OF_NF 400
+
+static OpenAPI_nf_type_e nf_types[] = {
+    OpenAPI_nf_type_SMF, OpenAPI_nf_type_AMF, OpenAPI_nf_type_UDM };
+static const char *dnns[] = { "internet", "IMS", "ims", "iot" };
+
+/* Same sequence on every run */
+static uint32_t seed;
+static uint32_t rnd(void)
+{
+    seed = seed * 1103515245 + 12345;
+    return seed >> 8;
+}
+
+static void sbi_context_init(void)
+{
+    /* ogs_sbi_context_init() sets up the message pools by itself */
+    ogs_sbi_message_final();
+
+    ogs_app()->pool.message = 32;
+    ogs_app()->pool.event = 32;
+    ogs_app()->pool.nf = 1024;
+    ogs_app()->pool.nf_service = 1024;
+    ogs_app()->pool.xact = 64;
+    ogs_app()->pool.subscription = 64;
+    ogs_sbi_context_init(OpenAPI_nf_type_NRF);
+}
+
+static void sbi_context_final(void)
+{
+    ogs_sbi_context_final();
+
+    ogs_sbi_message_init(32, 32);
+}
+
+static ogs_sbi_nf_instance_t *nf_add(
+        const char *id, OpenAPI_nf_type_e nf_type)
+{
+    ogs_sbi_nf_instance_t *nf_instance = NULL;
+
+    nf_instance = ogs_sbi_nf_instance_add();
+    ogs_assert(nf_instance);
+    if (id)
+        ogs_sbi_nf_instance_set_id(nf_instance, (char *)id);
+    ogs_sbi_nf_instance_set_type(nf_instance, nf_type);
+
+    return nf_instance;
+}
+
+/* What ogs_sbi_nf_instance_find() did before the id hash */
+static ogs_sbi_nf_instance_t *nf_find_by_scan(const char *id)
+{
+    ogs_sbi_nf_instance_t *nf_instance = NULL;
+
+    ogs_list_for_each(&ogs_sbi_self()->nf_instance_list, nf_instance) {
+        if (nf_instance->id && strcmp(nf_instance->id, id) == 0)
+            break;
+    }
+
+    return nf_instance;
+}
+
+/* Random PLMN, S-NSSAI/DNN, TAI and GUAMI to be indexed */
+static void nf_fill(ogs_sbi_nf_instance_t *nf_instance)
+{
+    ogs_sbi_nf_info_t *nf_info = NULL;
+    ogs_sbi_smf_info_t *smf_info = NULL;
+    ogs_sbi_amf_info_t *amf_info = NULL;
+    int i, j, n;
+
+    ogs_sbi_nf_info_remove_all(&nf_instance->nf_info_list);
+
+    nf_instance->num_of_plmn_id = rnd() % 2;
+    if (nf_instance->num_of_plmn_id)
+        ogs_plmn_id_build(&nf_instance->plmn_id[0], 1 + rnd() % 2, 1, 2);
+
+    n = rnd() % 3;
+    for (i = 0; i < n; i++) {
+        if (nf_instance->nf_type == OpenAPI_nf_type_SMF) {
+            nf_info = ogs_sbi_nf_info_add(
+                    &nf_instance->nf_info_list, OpenAPI_nf_type_SMF);
+            ogs_assert(nf_info);
+            smf_info = &nf_info->smf;
+
+            smf_info->num_of_slice = 1 + rnd() % 2;
+            for (j = 0; j < smf_info->num_of_slice; j++) {
+                smf_info->slice[j].s_nssai.sst = 1 + rnd() % 2;
+                smf_info->slice[j].s_nssai.sd.v =
+                    rnd() % 2 ? OGS_S_NSSAI_NO_SD_VALUE : 1;
+                smf_info->slice[j].num_of_dnn = 1;
+                smf_info->slice[j].dnn[0] = ogs_strdup(dnns[rnd() % 4]);
+                ogs_assert(smf_info->slice[j].dnn[0]);
+            }
+
+            smf_info->num_of_nr_tai = rnd() % 3;
+            for (j = 0; j < smf_info->num_of_nr_tai; j++) {
+                ogs_plmn_id_build(&smf_info->nr_tai[j].plmn_id, 1, 1, 2);
+                smf_info->nr_tai[j].tac.v = rnd() % 4;
+            }
+
+            if (rnd() % 5 == 0) {
+                smf_info->num_of_nr_tai_range = 1;
+                ogs_plmn_id_build(
+                        &smf_info->nr_tai_range[0].plmn_id, 1, 1, 2);
+                smf_info->nr_tai_range[0].num_of_tac_range = 1;
+                smf_info->nr_tai_range[0].start[0].v = 2;
+                smf_info->nr_tai_range[0].end[0].v = 3;
+            }
+        } else if (nf_instance->nf_type == OpenAPI_nf_type_AMF) {
+            nf_info = ogs_sbi_nf_info_add(
+                    &nf_instance->nf_info_list, OpenAPI_nf_type_AMF);
+            ogs_assert(nf_info);
+            amf_info = &nf_info->amf;
+
+            amf_info->num_of_guami = rnd() % 3;
+            for (j = 0; j < amf_info->num_of_guami; j++) {
+                ogs_plmn_id_build(&amf_info->guami[j].plmn_id, 1, 1, 2);
+                ogs_amf_id_build(&amf_info->guami[j].amf_id,
+                        2, rnd() % 3, 1);
+            }
+        }
+    }
+
+    ogs_sbi_nf_instance_reindex(nf_instance);
+}
+
+static void nf_query(ogs_sbi_discovery_option_t *discovery_option)
+{
+    memset(discovery_option, 0, sizeof(*discovery_option));
+
+    if (rnd() % 2) {
+        discovery_option->num_of_snssais = 1;
+        discovery_option->snssais[0].sst = 1 + rnd() % 2;
+        discovery_option->snssais[0].sd.v =
+            rnd() % 2 ? OGS_S_NSSAI_NO_SD_VALUE : 1;
+        discovery_option->dnn = (char *)dnns[rnd() % 4];
+    }
+    if (rnd() % 2) {
+        discovery_option->tai_presence = true;
+        ogs_plmn_id_build(&discovery_option->tai.plmn_id, 1, 1, 2);
+        discovery_option->tai.tac.v = rnd() % 4;
+    }
+    if (rnd() % 2) {
+        discovery_option->guami_presence = true;
+        ogs_plmn_id_build(&discovery_option->guami.plmn_id, 1, 1, 2);
+        ogs_amf_id_build(&discovery_option->guami.amf_id, 2, rnd() % 3, 1);
+    }
+    if (rnd() % 3 == 0) {
+        discovery_option->num_of_target_plmn_list = 1;
+        ogs_plmn_id_build(&discovery_option->target_plmn_list[0],
+                1 + rnd() % 2, 1, 2);
+    }
+}
+
+static void sbi_context_test1(abts_case *tc, void *data)
+{
+    ogs_sbi_nf_instance_t *a = NULL, *b = NULL, *c = NULL;
+
+    sbi_context_init();
+
+    /* Two NF Instances with the same id, the first one is found */
+    a = nf_add("nf-x", OpenAPI_nf_type_SMF);
+    b = nf_add("nf-x", OpenAPI_nf_type_SMF);
+    ABTS_PTR_EQUAL(tc, a, ogs_sbi_nf_instance_find((char *)"nf-x"));
+
+    /* The other one is found once the first one is removed */
+    ogs_sbi_nf_instance_remove(a);
+    ABTS_PTR_EQUAL(tc, b, ogs_sbi_nf_instance_find((char *)"nf-x"));
+
+    /* and once the first one changes its id */
+    c = nf_add("nf-x", OpenAPI_nf_type_SMF);
+    ogs_sbi_nf_instance_set_id(b, (char *)"nf-y");
+    ABTS_PTR_EQUAL(tc, c, ogs_sbi_nf_instance_find((char *)"nf-x"));
+    ABTS_PTR_EQUAL(tc, b, ogs_sbi_nf_instance_find((char *)"nf-y"));
+
+    /* An earlier NF Instance taking the id comes first as in the list */
+    ogs_sbi_nf_instance_set_id(b, (char *)"nf-x");
+    ABTS_PTR_EQUAL(tc, b, ogs_sbi_nf_instance_find((char *)"nf-x"));
+    ABTS_PTR_EQUAL(tc, NULL, ogs_sbi_nf_instance_find((char *)"nf-y"));
+
+    ogs_sbi_nf_instance_remove(c);
+    ABTS_PTR_EQUAL(tc, b, ogs_sbi_nf_instance_find((char *)"nf-x"));
+    ogs_sbi_nf_instance_remove(b);
+    ABTS_PTR_EQUAL(tc, NULL, ogs_sbi_nf_instance_find((char *)"nf-x"));
+
+    sbi_context_final();
+}
+
+static void sbi_context_test2(abts_case *tc, void *data)
+{
+    ogs_sbi_nf_instance_t *nf_instance[NUM_OF_NF];
+    ogs_sbi_nf_instance_t *a = NULL, *b = NULL;
+    ogs_sbi_nf_instance_cursor_t cursor;
+    ogs_sbi_discovery_option_t discovery_option, *option = NULL;
+    OpenAPI_nf_type_e target_nf_type, requester_nf_type;
+    char id[32];
+    int i, q, mismatch = 0, matched = 0;
+
+    sbi_context_init();
+    seed = 12345;
+
+    /* Few enough ids that some NF Instances share one */
+    for (i = 0; i < NUM_OF_NF; i++) {
+        if (rnd() % 10) {
+            ogs_snprintf(id, sizeof(id), "id-%d", i % (NUM_OF_NF / 2));
+            nf_instance[i] = nf_add(id, nf_types[rnd() % 3]);
+        } else {
+            nf_instance[i] = nf_add(NULL, nf_types[rnd() % 3]);
+        }
+        nf_fill(nf_instance[i]);
+    }
+
+    /*
+     * The cursor with the matcher must return the same NF Instances
+     * in the same order as the matcher over the whole list.
+     */
+    for (q = 0; q < 20000; q++) {
+        if (q % 50 == 0) {
+            i = rnd() % NUM_OF_NF;
+            if (!nf_instance[i]) {
+                ogs_snprintf(id, sizeof(id), "id-%d", rnd() % NUM_OF_NF);
+                nf_instance[i] = nf_add(id, nf_types[rnd() % 3]);
+                nf_fill(nf_instance[i]);
+            } else if (rnd() % 2) {
+                ogs_sbi_nf_instance_remove(nf_instance[i]);
+                nf_instance[i] = NULL;
+            } else {
+                nf_fill(nf_instance[i]);
+            }
+        }
+
+        target_nf_type = nf_types[rnd() % 3];
+        requester_nf_type =
+            rnd() % 2 ? OpenAPI_nf_type_AMF : OpenAPI_nf_type_SMF;
+
+        option = NULL;
+        if (rnd() % 4) {
+            option = &discovery_option;
+            nf_query(option);
+            if (rnd() % 20 == 0) {
+                ogs_snprintf(id, sizeof(id), "id-%d", rnd() % NUM_OF_NF);
+                option->target_nf_instance_id = id;
+            }
+        }
+
+        a = ogs_list_first(&ogs_sbi_self()->nf_instance_list);
+        ogs_sbi_nf_instance_cursor_init(&cursor,
+                target_nf_type, requester_nf_type, option);
+        for ( ;; ) {
+            while (a && !ogs_sbi_discovery_param_is_matched(
+                        a, target_nf_type, requester_nf_type, option))
+                a = ogs_list_next(a);
+            while ((b = ogs_sbi_nf_instance_cursor_next(&cursor))) {
+                if (ogs_sbi_discovery_param_is_matched(
+                            b, target_nf_type, requester_nf_type, option))
+                    break;
+            }
+            if (a != b) {
+                mismatch++;
+                break;
+            }
+            if (!a)
+                break;
+            matched++;
+            a = ogs_list_next(a);
+        }
+
+        ogs_snprintf(id, sizeof(id), "id-%d", rnd() % NUM_OF_NF);
+        if (ogs_sbi_nf_instance_find(id) != nf_find_by_scan(id))
+            mismatch++;
+    }
+
+    ABTS_INT_EQUAL(tc, 0, mismatch);
+    ABTS_TRUE(tc, matched > 20000);
+
+    sbi_context_final();
+}
+
+static ogs_sbi_nf_instance_t *smf_add(
+        const char *id, int priority, int capacity, int load)
+{
+    ogs_sbi_nf_instance_t *nf_instance = NULL;
+
+    nf_instance = nf_add(id, OpenAPI_nf_type_SMF);
+    nf_instance->priority = priority;
+    nf_instance->capacity = capacity;
+    nf_instance->load = load;
+
+    return nf_instance;
+}
+
+static ogs_sbi_nf_instance_t *smf_select(const char *sticky_key)
+{
+    return ogs_sbi_nf_instance_select(
+            OpenAPI_nf_type_SMF, OpenAPI_nf_type_AMF, NULL, sticky_key);
+}
+
+/* Percentage of the selections, within 'margin' of 'expected' */
+static bool share_is(ogs_sbi_nf_instance_t *nf_instance,
+        int total, int expected, int margin)
+{
+    int share = nf_instance->selection_count * 100 / total;
+
+    return share >= expected - margin && share <= expected + margin;
+}
+
+static void sbi_context_test3(abts_case *tc, void *data)
+{
+    ogs_sbi_nf_instance_t *smf[3];
+    char supi[32];
+    int i;
+
+    sbi_context_init();
+
+    /* Only the best (lowest) priority is ever picked */
+    smf[0] = smf_add("smf-0", 1, 100, 0);
+    smf[1] = smf_add("smf-1", 2, 10000, 0);
+    smf[2] = smf_add("smf-2", 1, 100, 90);
+
+    for (i = 0; i < 10000; i++) {
+        ogs_snprintf(supi, sizeof(supi), "imsi-99970%010d", i);
+        smf_select(NULL);
+        smf_select(supi);
+    }
+    ABTS_INT_EQUAL(tc, 0, smf[1]->selection_count);
+    ABTS_INT_EQUAL(tc, 20000,
+            smf[0]->selection_count + smf[2]->selection_count);
+
+    /* The next priority only when the better ones are gone */
+    ogs_sbi_nf_instance_remove(smf[0]);
+    ogs_sbi_nf_instance_remove(smf[2]);
+    ABTS_PTR_EQUAL(tc, smf[1], smf_select(NULL));
+    ABTS_PTR_EQUAL(tc, smf[1], smf_select("imsi-999700000000001"));
+
+    ogs_sbi_nf_instance_remove(smf[1]);
+    ABTS_PTR_EQUAL(tc, NULL, smf_select(NULL));
+    ABTS_PTR_EQUAL(tc, NULL, smf_select("imsi-999700000000001"));
+
+    sbi_context_final();
+}
+
+static void sbi_context_test4(abts_case *tc, void *data)
+{
+    ogs_sbi_nf_instance_t *smf[3];
+    char supi[32];
+    int i;
+
+    sbi_context_init();
+
+    /* Random draws split by capacity */
+    smf[0] = smf_add("smf-0", 1, 100, 0);
+    smf[1] = smf_add("smf-1", 1, 300, 0);
+
+    for (i = 0; i < 20000; i++)
+        smf_select(NULL);
+    ABTS_TRUE(tc, share_is(smf[0], 20000, 25, 3));
+    ABTS_TRUE(tc, share_is(smf[1], 20000, 75, 3));
+
+    /* scaled by the spare load, 100*100 : 300*50 */
+    smf[0]->selection_count = smf[1]->selection_count = 0;
+    smf[1]->load = 50;
+
+    for (i = 0; i < 20000; i++)
+        smf_select(NULL);
+    ABTS_TRUE(tc, share_is(smf[0], 20000, 40, 3));
+    ABTS_TRUE(tc, share_is(smf[1], 20000, 60, 3));
+
+    /* Sticky keys split by capacity alone */
+    smf[0]->selection_count = smf[1]->selection_count = 0;
+
+    for (i = 0; i < 20000; i++) {
+        ogs_snprintf(supi, sizeof(supi), "imsi-99970%010d", i);
+        smf_select(supi);
+    }
+    ABTS_TRUE(tc, share_is(smf[0], 20000, 25, 3));
+    ABTS_TRUE(tc, share_is(smf[1], 20000, 75, 3));
+
+    /* A fully loaded NF Instance is still picked, but rarely */
+    smf[0]->selection_count = smf[1]->selection_count = 0;
+    smf[0]->load = 100;
+    smf[1]->load = 0;
+    smf[2] = smf_add("smf-2", 1, 0, 0);
+
+    for (i = 0; i < 20000; i++)
+        smf_select(NULL);
+    ABTS_TRUE(tc, smf[0]->selection_count < 100);
+    ABTS_TRUE(tc, smf[2]->selection_count < 100);
+    ABTS_TRUE(tc, share_is(smf[1], 20000, 100, 1));
+
+    sbi_context_final();
+}
+
+#define NUM_OF_KEY 10000
+
+static void sbi_context_test5(abts_case *tc, void *data)
+{
+    ogs_sbi_nf_instance_t *smf[4], *selected = NULL;
+    static ogs_sbi_nf_instance_t *before[NUM_OF_KEY];
+    char supi[32];
+    int i, moved = 0;
+
+    sbi_context_init();
+
+    smf[0] = smf_add("smf-0", 1, 100, 0);
+    smf[1] = smf_add("smf-1", 1, 200, 30);
+    smf[2] = smf_add("smf-2", 1, 100, 60);
+    smf[3] = smf_add("smf-3", 1, 100, 0);
+
+    for (i = 0; i < NUM_OF_KEY; i++) {
+        ogs_snprintf(supi, sizeof(supi), "imsi-99970%010d", i);
+        before[i] = smf_select(supi);
+    }
+    ABTS_INT_EQUAL(tc, NUM_OF_KEY,
+            smf[0]->selection_count + smf[1]->selection_count +
+            smf[2]->selection_count + smf[3]->selection_count);
+
+    /* The same key lands on the same NF Instance whatever the load */
+    smf[0]->load = 90;
+    smf[1]->load = 0;
+    smf[3]->load = 100;
+
+    for (i = 0; i < NUM_OF_KEY; i++) {
+        ogs_snprintf(supi, sizeof(supi), "imsi-99970%010d", i);
+        if (smf_select(supi) != before[i])
+            moved++;
+    }
+    ABTS_INT_EQUAL(tc, 0, moved);
+
+    /* Only the keys of a removed NF Instance move */
+    ogs_sbi_nf_instance_remove(smf[2]);
+
+    for (i = 0; i < NUM_OF_KEY; i++) {
+        ogs_snprintf(supi, sizeof(supi), "imsi-99970%010d", i);
+        selected = smf_select(supi);
+        if (selected == smf[2] ||
+            (before[i] != smf[2] && selected != before[i]))
+            moved++;
+    }
+    ABTS_INT_EQUAL(tc, 0, moved);
+
+    /* and they come back when it registers again */
+    smf[2] = smf_add("smf-2", 1, 100, 0);
+
+    for (i = 0; i < NUM_OF_KEY; i++) {
+        ogs_snprintf(supi, sizeof(supi), "imsi-99970%010d", i);
+        selected = smf_select(supi);
+        if (before[i] == smf[0] || before[i] == smf[1] ||
+            before[i] == smf[3]) {
+            if (selected != before[i])
+                moved++;
+        } else if (selected != smf[2]) {
+            moved++;
+        }
+    }
+    ABTS_INT_EQUAL(tc, 0, moved);
+
+    sbi_context_final();
+}
+
+static ogs_sbi_nf_instance_t *nrf_profile_add(const char *id, int capacity)
+{
+    ogs_sbi_nf_instance_t *nf_instance = NULL;
+    ogs_sbi_nf_service_t *nf_service = NULL;
+    ogs_sbi_nf_info_t *nf_info = NULL;
+    char service_id[64];
+
+    nf_instance = nf_add(id, OpenAPI_nf_type_SMF);
+    ogs_sbi_nf_instance_set_status(
+            nf_instance, OpenAPI_nf_status_REGISTERED);
+    nf_instance->fqdn = ogs_strdup("smf.localdomain");
+    ogs_assert(nf_instance->fqdn);
+    nf_instance->time.heartbeat_interval = 10;
+    nf_instance->capacity = capacity;
+    nf_instance->load = 20;
+    nf_instance->num_of_plmn_id = 1;
+    ogs_plmn_id_build(&nf_instance->plmn_id[0], 999, 70, 2);
+    ogs_sbi_nf_instance_add_allowed_nf_type(
+            nf_instance, OpenAPI_nf_type_AMF);
+
+    ogs_snprintf(service_id, sizeof(service_id), "%s-pdusession", id);
+    nf_service = ogs_sbi_nf_service_add(nf_instance, service_id,
+            OGS_SBI_SERVICE_NAME_NSMF_PDUSESSION, OpenAPI_uri_scheme_http);
+    ogs_assert(nf_service);
+    ogs_sbi_nf_service_add_version(nf_service,
+            OGS_SBI_API_V1, OGS_SBI_API_V1_0_0, NULL);
+
+    nf_info = ogs_sbi_nf_info_add(
+            &nf_instance->nf_info_list, OpenAPI_nf_type_SMF);
+    ogs_assert(nf_info);
+    nf_info->smf.num_of_slice = 1;
+    nf_info->smf.slice[0].s_nssai.sst = 1;
+    nf_info->smf.slice[0].s_nssai.sd.v = OGS_S_NSSAI_NO_SD_VALUE;
+    nf_info->smf.slice[0].num_of_dnn = 1;
+    nf_info->smf.slice[0].dnn[0] = ogs_strdup("internet");
+    ogs_assert(nf_info->smf.slice[0].dnn[0]);
+
+    return nf_instance;
+}
+
+/* SearchResult printed by the OpenAPI model */
+static char *search_result_print(ogs_sbi_nf_instance_t **nf_instance,
+        int num_of_nf_instance, int validity_period, bool service_map)
+{
+    OpenAPI_search_result_t SearchResult;
+    OpenAPI_nf_profile_t *NFProfile = NULL;
+    OpenAPI_lnode_t *node = NULL;
+    cJSON *item = NULL;
+    char *json = NULL;
+    int i;
+
+    memset(&SearchResult, 0, sizeof(SearchResult));
+    if (validity_period) {
+        SearchResult.is_validity_period = true;
+        SearchResult.validity_period = validity_period;
+    }
+    SearchResult.nf_instances = OpenAPI_list_create();
+    ogs_assert(SearchResult.nf_instances);
+
+    for (i = 0; i < num_of_nf_instance; i++) {
+        NFProfile = ogs_nnrf_nfm_build_nf_profile(
+                nf_instance[i], NULL, NULL, service_map);
+        ogs_assert(NFProfile);
+        OpenAPI_list_add(SearchResult.nf_instances, NFProfile);
+    }
+
+    item = OpenAPI_search_result_convertToJSON(&SearchResult);
+    ogs_assert(item);
+    json = cJSON_PrintUnformatted(item);
+    ogs_assert(json);
+    cJSON_Delete(item);
+
+    OpenAPI_list_for_each(SearchResult.nf_instances, node)
+        ogs_nnrf_nfm_free_nf_profile(node->data);
+    OpenAPI_list_free(SearchResult.nf_instances);
+
+    return json;
+}
+
+/* SearchResult assembled from the cached NFProfile JSON, as in the NRF */
+static char *search_result_build(ogs_sbi_nf_instance_t **nf_instance,
+        int num_of_nf_instance, int validity_period, bool service_map)
+{
+    OpenAPI_list_t *NFProfileList = NULL;
+    char *json = NULL;
+    int i;
+
+    NFProfileList = OpenAPI_list_create();
+    ogs_assert(NFProfileList);
+
+    for (i = 0; i < num_of_nf_instance; i++)
+        OpenAPI_list_add(NFProfileList,
+                ogs_nnrf_nfm_cached_nf_profile_json(
+                    nf_instance[i], service_map));
+
+    json = ogs_nnrf_disc_build_search_result(NFProfileList, validity_period);
+    ogs_assert(json);
+    OpenAPI_list_free(NFProfileList);
+
+    return json;
+}
+
+static void sbi_context_test6(abts_case *tc, void *data)
+{
+    ogs_sbi_nf_instance_t *nf_instance[3];
+    char *expected = NULL, *json = NULL;
+    int i, n, validity_period;
+    bool service_map;
+
+    sbi_context_init();
+
+    nf_instance[0] = nrf_profile_add("smf-0", 100);
+    nf_instance[1] = nrf_profile_add("smf-1", 200);
+    nf_instance[2] = nrf_profile_add("smf-2", 300);
+
+    /* Byte for byte, with any number of NFProfiles */
+    for (i = 0; i < 2 * 2 * 4; i++) {
+        service_map = i % 2;
+        validity_period = (i / 2) % 2 ? 3600 : 0;
+        n = i / 4;
+
+        expected = search_result_print(
+                nf_instance, n, validity_period, service_map);
+        json = search_result_build(
+                nf_instance, n, validity_period, service_map);
+        ABTS_STR_EQUAL(tc, expected, json);
+
+        ogs_free(expected);
+        ogs_free(json);
+    }
+
+    /* and the same again from the cache */
+    ABTS_PTR_NOTNULL(tc, nf_instance[0]->nf_profile_json[0]);
+    ABTS_PTR_NOTNULL(tc, nf_instance[0]->nf_profile_json[1]);
+
+    expected = search_result_print(nf_instance, 3, 3600, false);
+    json = search_result_build(nf_instance, 3, 3600, false);
+    ABTS_STR_EQUAL(tc, expected, json);
+    ogs_free(expected);
+    ogs_free(json);
+
+    sbi_context_final();
+}
+
+static void sbi_context_test7(abts_case *tc, void *data)
+{
+    ogs_sbi_nf_instance_t *nf_instance = NULL, *other = NULL;
+    OpenAPI_nf_profile_t *NFProfile = NULL;
+    OpenAPI_patch_item_t PatchItem;
+    char *json = NULL, *expected = NULL;
+
+    sbi_context_init();
+
+    nf_instance = nrf_profile_add("smf-0", 100);
+    json = ogs_nnrf_nfm_cached_nf_profile_json(nf_instance, false);
+    ABTS_PTR_NOTNULL(tc, json);
+    ABTS_PTR_EQUAL(tc, json,
+            ogs_nnrf_nfm_cached_nf_profile_json(nf_instance, false));
+    ABTS_PTR_NOTNULL(tc,
+            ogs_nnrf_nfm_cached_nf_profile_json(nf_instance, true));
+
+    /*
+     * NFRegister and NFUpdate(PUT) both replace the profile
+     * with ogs_nnrf_nfm_handle_nf_profile()
+     */
+    other = nrf_profile_add("smf-1", 500);
+    NFProfile = ogs_nnrf_nfm_build_nf_profile(other, NULL, NULL, false);
+    ABTS_PTR_NOTNULL(tc, NFProfile);
+    NFProfile->nf_instance_id = nf_instance->id;
+    ogs_nnrf_nfm_handle_nf_profile(nf_instance, NFProfile);
+    NFProfile->nf_instance_id = other->id;
+    ogs_nnrf_nfm_free_nf_profile(NFProfile);
+
+    ABTS_PTR_EQUAL(tc, NULL, nf_instance->nf_profile_json[0]);
+    ABTS_PTR_EQUAL(tc, NULL, nf_instance->nf_profile_json[1]);
+    ABTS_INT_EQUAL(tc, 500, nf_instance->capacity);
+
+    expected = ogs_nnrf_nfm_build_nf_profile_json(nf_instance, NULL, false);
+    ABTS_PTR_NOTNULL(tc, expected);
+    json = ogs_nnrf_nfm_cached_nf_profile_json(nf_instance, false);
+    ABTS_STR_EQUAL(tc, expected, json);
+    ABTS_TRUE(tc, strstr(json, "\"capacity\":500") != NULL);
+    ogs_free(expected);
+
+    /* NFUpdate(PATCH) of the load */
+    memset(&PatchItem, 0, sizeof(PatchItem));
+    PatchItem.op = OpenAPI_patch_operation_replace;
+    PatchItem.path = (char *)OGS_SBI_PATCH_PATH_LOAD;
+    PatchItem.value = OpenAPI_any_type_create_number(70);
+    ogs_assert(PatchItem.value);
+
+    ogs_nnrf_nfm_handle_nf_patch_item(nf_instance, &PatchItem);
+    ABTS_PTR_EQUAL(tc, NULL, nf_instance->nf_profile_json[0]);
+    ABTS_INT_EQUAL(tc, 70, nf_instance->load);
+    json = ogs_nnrf_nfm_cached_nf_profile_json(nf_instance, false);
+    ABTS_TRUE(tc, strstr(json, "\"load\":70") != NULL);
+
+    /* Other operations leave the cache as it is */
+    PatchItem.op = OpenAPI_patch_operation_add;
+    ogs_nnrf_nfm_handle_nf_patch_item(nf_instance, &PatchItem);
+    ABTS_PTR_EQUAL(tc, json, nf_instance->nf_profile_json[0]);
+    OpenAPI_any_type_free(PatchItem.value);
+
+    /* NFUpdate(PATCH) of the status */
+    PatchItem.op = OpenAPI_patch_operation_replace;
+    PatchItem.path = (char *)OGS_SBI_PATCH_PATH_NF_STATUS;
+    PatchItem.value = OpenAPI_any_type_create_string("SUSPENDED");
+    ogs_assert(PatchItem.value);
+
+    ogs_nnrf_nfm_handle_nf_patch_item(nf_instance, &PatchItem);
+    ABTS_PTR_EQUAL(tc, NULL, nf_instance->nf_profile_json[0]);
+    OpenAPI_any_type_free(PatchItem.value);
+
+    /* The removal frees the cache */
+    ABTS_PTR_NOTNULL(tc,
+            ogs_nnrf_nfm_cached_nf_profile_json(nf_instance, true));
+    ogs_sbi_nf_instance_remove(nf_instance);
+
+    sbi_context_final();
+}
+
+abts_suite *test_sbi_context(abts_suite *suite)
+{
+    suite = ADD_SUITE(suite)
+
+    abts_run_test(suite, sbi_context_test1, NULL);
+    abts_run_test(suite, sbi_context_test2, NULL);
+    abts_run_test(suite, sbi_context_test3, NULL);
+    abts_run_test(suite, sbi_context_test4, NULL);
+    abts_run_test(suite, sbi_context_test5, NULL);
+    abts_run_test(suite, sbi_context_test6, NULL);
+    abts_run_test(suite, sbi_context_test7, NULL);
+
+    return suite;
+}
@@ -1021,6 +1021,248 @@ static void sbi_message_test10(abts_case *tc, void *param)
     }
 }
 
+typedef struct sbi_stream_body_s {
+    const OpenAPI_stream_model_t *model;
+    const char *json;
+} sbi_stream_body_t;
+
+static char *sbi_stream_cjson_print(
+        const OpenAPI_stream_model_t *model, void *data)
+{
+    cJSON *item = NULL;
+    char *string = NULL;
+
+    item = model->convertToJSON(data);
+    if (!item)
+        return NULL;
+
+    string = cJSON_PrintUnformatted(item);
+    cJSON_Delete(item);
+
+    return string;
+}
+
+/*
+ * The table-driven codec must give the same result as
+ * cJSON_Parse() + parseFromJSON() and convertToJSON() + cJSON_Print,
+ * including a NULL where the generated code cannot print the struct.
+ */
+static void sbi_stream_check(abts_case *tc, const sbi_stream_body_t *body,
+        bool must_accept)
+{
+    cJSON *item = NULL;
+    void *expected = NULL, *parsed = NULL;
+    char *expected_json = NULL, *parsed_json = NULL, *printed = NULL;
+
+    item = cJSON_Parse(body->json);
+    if (item) {
+        expected = body->model->parseFromJSON(item);
+        cJSON_Delete(item);
+    }
+
+    parsed = OpenAPI_stream_parse(body->model, body->json);
+    if (must_accept)
+        ABTS_PTR_NOTNULL(tc, parsed);
+
+    if (expected) {
+        expected_json = sbi_stream_cjson_print(body->model, expected);
+        if (must_accept)
+            ABTS_PTR_NOTNULL(tc, expected_json);
+
+        printed = OpenAPI_stream_print(body->model, expected);
+        ABTS_STR_EQUAL(tc, expected_json, printed);
+        if (printed)
+            ogs_free(printed);
+
+        body->model->free(expected);
+    }
+
+    if (parsed) {
+        /* Accepted by the codec, so it must be accepted by cJSON as well */
+        ABTS_PTR_NOTNULL(tc, expected);
+
+        parsed_json = sbi_stream_cjson_print(body->model, parsed);
+        ABTS_STR_EQUAL(tc, expected_json, parsed_json);
+
+        printed = OpenAPI_stream_print(body->model, parsed);
+        ABTS_STR_EQUAL(tc, parsed_json, printed);
+        if (printed)
+            ogs_free(printed);
+
+        body->model->free(parsed);
+    }
+
+    if (expected_json)
+        ogs_free(expected_json);
+    if (parsed_json)
+        ogs_free(parsed_json);
+}
+
+static void sbi_message_test11(abts_case *tc, void *data)
+{
+    /* Same bodies as tests/benchmark/sbi-bench.c */
+    static const sbi_stream_body_t body[] = {
+        /* ue-auth-ctx */
+        { &OpenAPI_ue_authentication_ctx_stream,
+            "{\"authType\":\"5G_AKA\",\"5gAuthData\":{"
+                "\"rand\":\"4a3d0f53a6e3c6b81db0b3c1e27f4a25\","
+                "\"hxresStar\":\"c3e2a97e0c6d4d0f4e1e86e3b1c2d5f7\","
+                "\"autn\":\"8a7d6d4c3b2a80001f3e5d7c9b1a0e2c\"},"
+            "\"_links\":{\"5g-aka\":{\"href\":\"http://127.0.0.11:7777/"
+                "nausf-auth/v1/ue-authentications/1/5g-aka-confirmation\"}},"
+            "\"servingNetworkName\":\"5G:mnc070.mcc999.3gppnetwork.org\"}" },
+        /* auth-info-result */
+        { &OpenAPI_authentication_info_result_stream,
+            "{\"authType\":\"5G_AKA\",\"authenticationVector\":{"
+                "\"avType\":\"5G_HE_AKA\","
+                "\"rand\":\"4a3d0f53a6e3c6b81db0b3c1e27f4a25\","
+                "\"xresStar\":\"0d5e1a2b3c4d5e6f708192a3b4c5d6e7\","
+                "\"autn\":\"8a7d6d4c3b2a80001f3e5d7c9b1a0e2c\","
+                "\"kausf\":\"1f2e3d4c5b6a79880f1e2d3c4b5a69788796a5b4c3d2e1f0"
+                "0f1e2d3c4b5a6978\"},"
+            "\"supi\":\"imsi-999700000000001\"}" },
+        /* am-data */
+        { &OpenAPI_access_and_mobility_subscription_data_stream,
+            "{\"gpsis\":[\"msisdn-0900000000\"],"
+            "\"subscribedUeAmbr\":{\"uplink\":\"1048576 Kbps\","
+                "\"downlink\":\"1048576 Kbps\"},"
+            "\"nssai\":{\"defaultSingleNssais\":[{\"sst\":1},"
+                "{\"sst\":1,\"sd\":\"000080\"}],"
+                "\"singleNssais\":[{\"sst\":2,\"sd\":\"000001\"}]},"
+            "\"ratRestrictions\":[\"EUTRA\"],"
+            "\"rfspIndex\":1,\"subsRegTimer\":3600,\"ueUsageType\":0,"
+            "\"mpsPriority\":false,\"micoAllowed\":true,"
+            "\"subscribedDnnList\":[\"internet\",\"ims\"],"
+            "\"sharedVnGroupDataIds\":{\"1\":\"vn-group-1\"}}" },
+        /* sm-context-create */
+        { &OpenAPI_sm_context_create_data_stream,
+            "{\"supi\":\"imsi-999700000000001\","
+            "\"pei\":\"imeisv-4370816125816151\","
+            "\"gpsi\":\"msisdn-0900000000\",\"pduSessionId\":5,"
+            "\"dnn\":\"internet\",\"sNssai\":{\"sst\":1,\"sd\":\"000080\"},"
+            "\"servingNfId\":\"6b4d1e3a-b5c2-41ed-9a3b-0242ac120005\","
+            "\"guami\":{\"plmnId\":{\"mcc\":\"999\",\"mnc\":\"70\"},"
+                "\"amfId\":\"020040\"},"
+            "\"servingNetwork\":{\"mcc\":\"999\",\"mnc\":\"70\"},"
+            "\"n1SmMsg\":{\"contentId\":\"5gnas-sm\"},"
+            "\"anType\":\"3GPP_ACCESS\",\"ratType\":\"NR\","
+            "\"ueLocation\":{\"nrLocation\":{"
+                "\"tai\":{\"plmnId\":{\"mcc\":\"999\",\"mnc\":\"70\"},"
+                    "\"tac\":\"000001\"},"
+                "\"ncgi\":{\"plmnId\":{\"mcc\":\"999\",\"mnc\":\"70\"},"
+                    "\"nrCellId\":\"000000010\"},"
+                "\"ueLocationTimestamp\":\"2023-03-01T09:00:00.000000Z\"}},"
+            "\"ueTimeZone\":\"+09:00\","
+            "\"smContextStatusUri\":\"http://127.0.0.5:7777/namf-callback/v1/"
+                "imsi-999700000000001/sm-context-status/5\","
+            "\"pcfId\":\"6b4d1e3a-b5c2-41ed-9a3b-0242ac120007\"}" },
+        /* sm-policy-ctx */
+        { &OpenAPI_sm_policy_context_data_stream,
+            "{\"supi\":\"imsi-999700000000001\",\"gpsi\":\"msisdn-0900000000\","
+            "\"pduSessionId\":5,\"pduSessionType\":\"IPV4V6\","
+            "\"dnn\":\"internet\","
+            "\"notificationUri\":\"http://127.0.0.4:7777/nsmf-callback/v1/"
+                "sm-policy-notify/1\","
+            "\"accessType\":\"3GPP_ACCESS\",\"ratType\":\"NR\","
+            "\"servingNetwork\":{\"mcc\":\"999\",\"mnc\":\"70\"},"
+            "\"userLocationInfo\":{\"nrLocation\":{"
+                "\"tai\":{\"plmnId\":{\"mcc\":\"999\",\"mnc\":\"70\"},"
+                    "\"tac\":\"000001\"},"
+                "\"ncgi\":{\"plmnId\":{\"mcc\":\"999\",\"mnc\":\"70\"},"
+                    "\"nrCellId\":\"000000010\"},"
+                "\"ueLocationTimestamp\":\"2023-03-01T09:00:00.000000Z\"}},"
+            "\"ueTimeZone\":\"+09:00\",\"pei\":\"imeisv-4370816125816151\","
+            "\"ipv4Address\":\"10.45.0.2\","
+            "\"ipv6AddressPrefix\":\"2001:db8:cafe::/64\","
+            "\"subsSessAmbr\":{\"uplink\":\"1048576 Kbps\","
+                "\"downlink\":\"1048576 Kbps\"},"
+            "\"subsDefQos\":{\"5qi\":9,\"arp\":{\"priorityLevel\":8,"
+                "\"preemptCap\":\"NOT_PREEMPT\","
+                "\"preemptVuln\":\"NOT_PREEMPTABLE\"},"
+                "\"priorityLevel\":8},"
+            "\"sliceInfo\":{\"sst\":1,\"sd\":\"000080\"},"
+            "\"suppFeat\":\"4000000\"}" },
+    };
+    int i;
+
+    for (i = 0; i < OGS_ARRAY_SIZE(body); i++)
+        sbi_stream_check(tc, &body[i], true);
+}
+
+static void sbi_message_test12(abts_case *tc, void *data)
+{
+    static const sbi_stream_body_t body[] = {
+        /* Duplicate keys */
+        { &OpenAPI_snssai_stream, "{\"sst\":1,\"sst\":2}" },
+        { &OpenAPI_snssai_stream,
+            "{\"sst\":1,\"sd\":\"000080\",\"sd\":\"000001\"}" },
+        { &OpenAPI_plmn_id_stream,
+            "{\"mcc\":\"999\",\"mnc\":\"70\",\"mcc\":\"001\"}" },
+
+        /* Escapes and surrogate pairs */
+        { &OpenAPI_plmn_id_stream,
+            "{\"mcc\":\"\\u0039\\u0039\\u0039\","
+            "\"mnc\":\"\\\"\\\\\\/\\b\\f\\n\\r\\t\"}" },
+        { &OpenAPI_plmn_id_stream,
+            "{\"mcc\":\"\\u00e9\\ud83d\\ude00\",\"mnc\":\"\xc3\xa9\"}" },
+        { &OpenAPI_plmn_id_stream,
+            "{\"mcc\":\"\\ud800\",\"mnc\":\"70\"}" },
+        { &OpenAPI_plmn_id_stream,
+            "{\"mcc\":\"\\udc00\\ud800\",\"mnc\":\"70\"}" },
+        { &OpenAPI_plmn_id_stream,
+            "{\"mcc\":\"\\u0001\\u001f\",\"mnc\":\"70\"}" },
+
+        /* Fractional and out of range numbers */
+        { &OpenAPI_snssai_stream, "{\"sst\":1.5}" },
+        { &OpenAPI_snssai_stream, "{\"sst\":1e2}" },
+        { &OpenAPI_snssai_stream, "{\"sst\":-0}" },
+        { &OpenAPI_snssai_stream, "{\"sst\":4294967296}" },
+        { &OpenAPI_geographical_coordinates_stream,
+            "{\"lon\":127.0276,\"lat\":-37.4979e-1}" },
+        { &OpenAPI_geographical_coordinates_stream,
+            "{\"lon\":0.1,\"lat\":1e400}" },
+        { &OpenAPI_number_average_stream,
+            "{\"number\":3.14159,\"variance\":0.000001,\"skewness\":-1.5}" },
+
+        /* Unknown enums */
+        { &OpenAPI_ue_authentication_ctx_stream,
+            "{\"authType\":\"BOGUS_VALUE\",\"5gAuthData\":{"
+                "\"rand\":\"4a3d0f53a6e3c6b81db0b3c1e27f4a25\","
+                "\"hxresStar\":\"c3e2a97e0c6d4d0f4e1e86e3b1c2d5f7\","
+                "\"autn\":\"8a7d6d4c3b2a80001f3e5d7c9b1a0e2c\"},"
+            "\"_links\":{\"5g-aka\":{\"href\":\"http://127.0.0.11:7777\"}}}" },
+        { &OpenAPI_access_and_mobility_subscription_data_stream,
+            "{\"ratRestrictions\":[\"EUTRA\",\"BOGUS_VALUE\"]}" },
+        { &OpenAPI_arp_stream,
+            "{\"priorityLevel\":8,\"preemptCap\":\"BOGUS_VALUE\","
+            "\"preemptVuln\":\"NOT_PREEMPTABLE\"}" },
+
+        /* null members */
+        { &OpenAPI_snssai_stream, "{\"sst\":1,\"sd\":null}" },
+        { &OpenAPI_snssai_stream, "{\"sst\":null}" },
+        { &OpenAPI_access_and_mobility_subscription_data_stream,
+            "{\"rfspIndex\":null,\"subsRegTimer\":null}" },
+        { &OpenAPI_access_and_mobility_subscription_data_stream,
+            "{\"gpsis\":null}" },
+        { &OpenAPI_qos_data_stream,
+            "{\"qosId\":\"1\",\"maxbrUl\":null,\"priorityLevel\":null,"
+            "\"averWindow\":null}" },
+        { &OpenAPI_access_and_mobility_subscription_data_stream,
+            "{\"gpsis\":[\"msisdn-0900000000\",null]}" },
+        { &OpenAPI_access_and_mobility_subscription_data_stream,
+            "{\"sharedVnGroupDataIds\":{\"1\":null}}" },
+
+        /* Unknown members and white space */
+        { &OpenAPI_snssai_stream,
+            " {\"x\":{\"a\":[1,{\"b\":null}],\"c\":\"\\\"}\"},"
+            " \"sst\" : 1 }\n" },
+    };
+    int i;
+
+    for (i = 0; i < OGS_ARRAY_SIZE(body); i++)
+        sbi_stream_check(tc, &body[i], false);
+}
+
 abts_suite *test_sbi_message(abts_suite *suite)
 {
     suite = ADD_SUITE(suite)
@@ -1035,6 +1277,8 @@ abts_suite *test_sbi_message(abts_suite *suite)
     abts_run_test(suite, sbi_message_test8, NULL);
     abts_run_test(suite, sbi_message_test9, NULL);
     abts_run_test(suite, sbi_message_test10, NULL);
+    abts_run_test(suite, sbi_message_test11, NULL);
+    abts_run_test(suite, sbi_message_test12, NULL);
 
     return suite;
 }
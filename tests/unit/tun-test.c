@@ -0,0 +1,462 @@
+/*
+ * Copyright (C) 2019-2023 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ogs-tun.h"
+#include "core/abts.h"
+
+#if defined(__linux__)
+
+#include <sys/socket.h>
+#include <fcntl.h>
+
+#define TCP_ACK 0x10
+#define TCP_PSH 0x08
+#define TCP_FIN 0x01
+#define TCP_CWR 0x80
+
+#define SEQ     0x11223344
+
+static uint16_t get16(const uint8_t *p)
+{
+    return (p[0] << 8) | p[1];
+}
+
+static uint32_t get32(const uint8_t *p)
+{
+    return ((uint32_t)get16(p) << 16) | get16(p + 2);
+}
+
+static void put16(uint8_t *p, uint16_t v)
+{
+    p[0] = v >> 8;
+    p[1] = v;
+}
+
+static void put32(uint8_t *p, uint32_t v)
+{
+    put16(p, v >> 16);
+    put16(p + 2, v);
+}
+
+static uint32_t sum16(uint32_t sum, const uint8_t *p, int len)
+{
+    for (; len > 1; p += 2, len -= 2)
+        sum += get16(p);
+    if (len)
+        sum += p[0] << 8;
+
+    return sum;
+}
+
+static uint16_t fold(uint32_t sum)
+{
+    while (sum >> 16)
+        sum = (sum & 0xffff) + (sum >> 16);
+
+    return sum;
+}
+
+static int l4_offset(const uint8_t *ip)
+{
+    return (ip[0] >> 4) == 4 ? 20 : 40;
+}
+
+static uint32_t pseudo(const uint8_t *ip, int len)
+{
+    int l4_len = len - l4_offset(ip);
+
+    if ((ip[0] >> 4) == 4)
+        return sum16(0, ip + 12, 8) + 6 + l4_len;
+    else
+        return sum16(0, ip + 8, 32) + 6 + l4_len;
+}
+
+/* A checksum is valid when the data summed with it folds to 0xffff */
+static bool tcp_csum_ok(const uint8_t *ip, int len)
+{
+    int off = l4_offset(ip);
+
+    return fold(sum16(pseudo(ip, len), ip + off, len - off)) == 0xffff;
+}
+
+static uint8_t payload_byte(int i)
+{
+    return i * 7 + 1;
+}
+
+/*
+ * IPv4 or IPv6 TCP packet with 'optlen' bytes of TCP options.
+ * The TCP checksum holds the pseudo header sum as the kernel leaves it.
+ */
+static int tcp_packet(uint8_t *buf, int version, int optlen,
+        uint32_t seq, uint8_t flags, int payload_offset, int payload)
+{
+    int off = version == 4 ? 20 : 40;
+    int hdr_len = off + 20 + optlen;
+    int len = hdr_len + payload;
+    uint8_t *tcp = buf + off;
+    int i;
+
+    memset(buf, 0, hdr_len);
+    if (version == 4) {
+        buf[0] = 0x45;
+        put16(buf + 2, len);
+        put16(buf + 4, 0x1000);
+        put16(buf + 6, 0x4000);
+        buf[8] = 64;
+        buf[9] = 6;
+        put32(buf + 12, 0x0a2d0001);
+        put32(buf + 16, 0x0a2d0002);
+        put16(buf + 10, ~fold(sum16(0, buf, 20)));
+    } else {
+        buf[0] = 0x60;
+        put16(buf + 4, len - 40);
+        buf[6] = 6;
+        buf[7] = 64;
+        buf[8] = 0x20;
+        buf[9] = 0x01;
+        buf[23] = 1;
+        buf[24] = 0x20;
+        buf[25] = 0x01;
+        buf[39] = 2;
+    }
+
+    put16(tcp, 40000);
+    put16(tcp + 2, 80);
+    put32(tcp + 4, seq);
+    put32(tcp + 8, 0xaabbccdd);
+    tcp[12] = ((20 + optlen) / 4) << 4;
+    tcp[13] = flags;
+    put16(tcp + 14, 65535);
+    for (i = 0; i < optlen; i++)
+        tcp[20 + i] = 1; /* NOP */
+
+    for (i = 0; i < payload; i++)
+        buf[hdr_len + i] = payload_byte(payload_offset + i);
+
+    put16(tcp + 16, fold(pseudo(buf, len)));
+
+    return len;
+}
+
+static void gso_vnet_hdr(ogs_tun_vnet_hdr_t *vnet_hdr,
+        int version, int hdr_len, int gso_size)
+{
+    memset(vnet_hdr, 0, sizeof(*vnet_hdr));
+    vnet_hdr->flags = OGS_TUN_VNET_HDR_F_NEEDS_CSUM;
+    vnet_hdr->gso_type = version == 4 ?
+        OGS_TUN_VNET_HDR_GSO_TCPV4 : OGS_TUN_VNET_HDR_GSO_TCPV6;
+    vnet_hdr->hdr_len = hdr_len;
+    vnet_hdr->gso_size = gso_size;
+    vnet_hdr->csum_start = version == 4 ? 20 : 40;
+    vnet_hdr->csum_offset = 16;
+}
+
+static void check_gso(abts_case *tc, int version, int optlen,
+        int payload, int gso_size)
+{
+    static uint8_t buf[OGS_TUN_MAX_GSO_LEN];
+    ogs_tun_vnet_hdr_t vnet_hdr;
+    ogs_tun_gso_t gso;
+    ogs_pkbuf_t *pkbuf = NULL;
+    int off = version == 4 ? 20 : 40;
+    int hdr_len = off + 20 + optlen;
+    int len, n, seg, i;
+    uint8_t *ip = NULL, *tcp = NULL;
+
+    len = tcp_packet(buf, version, optlen, SEQ,
+            TCP_ACK|TCP_PSH|TCP_FIN|TCP_CWR, 0, payload);
+    gso_vnet_hdr(&vnet_hdr, version, hdr_len, gso_size);
+
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_tun_gso_init(&gso, buf, len, &vnet_hdr));
+
+    for (n = 0; (pkbuf = ogs_tun_gso_next(&gso, NULL)); n++) {
+        seg = ogs_min(gso_size, payload - n * gso_size);
+        ip = pkbuf->data;
+        tcp = ip + off;
+
+        ABTS_INT_EQUAL(tc, hdr_len + seg, pkbuf->len);
+        ABTS_TRUE(tc, ogs_pkbuf_headroom(pkbuf) >= OGS_TUN_MAX_HEADROOM);
+        if (version == 4) {
+            ABTS_INT_EQUAL(tc, hdr_len + seg, get16(ip + 2));
+            ABTS_INT_EQUAL(tc, 0x1000 + n, get16(ip + 4));
+            ABTS_INT_EQUAL(tc, 0xffff, fold(sum16(0, ip, 20)));
+        } else {
+            ABTS_INT_EQUAL(tc, hdr_len + seg - 40, get16(ip + 4));
+        }
+        ABTS_TRUE(tc, get32(tcp + 4) == SEQ + n * gso_size);
+
+        /* FIN and PSH on the last, CWR on the first segment only */
+        if (n * gso_size + seg == payload)
+            ABTS_INT_EQUAL(tc, TCP_ACK|TCP_PSH|TCP_FIN | (n ? 0 : TCP_CWR),
+                    tcp[13]);
+        else
+            ABTS_INT_EQUAL(tc, TCP_ACK | (n ? 0 : TCP_CWR), tcp[13]);
+
+        ABTS_TRUE(tc, tcp_csum_ok(ip, pkbuf->len));
+        for (i = 0; i < seg; i++)
+            if (ip[hdr_len + i] != payload_byte(n * gso_size + i))
+                break;
+        ABTS_INT_EQUAL(tc, seg, i);
+
+        ogs_pkbuf_free(pkbuf);
+    }
+
+    ABTS_INT_EQUAL(tc, (payload + gso_size - 1) / gso_size, n);
+    ABTS_PTR_EQUAL(tc, NULL, ogs_tun_gso_next(&gso, NULL));
+}
+
+static void tun_gso_test1(abts_case *tc, void *data)
+{
+    check_gso(tc, 4, 0, 2500, 1000);
+    check_gso(tc, 4, 12, 3000, 1000);
+    check_gso(tc, 6, 0, 2000, 1400);
+    check_gso(tc, 6, 12, 1400, 1400);
+    check_gso(tc, 4, 0, OGS_TUN_MAX_GSO_LEN - 40, 1448);
+}
+
+static void tun_gso_test2(abts_case *tc, void *data)
+{
+    uint8_t buf[OGS_MAX_PKT_LEN];
+    ogs_tun_vnet_hdr_t vnet_hdr;
+    ogs_tun_gso_t gso;
+    ogs_pkbuf_t *pkbuf = NULL;
+    int len;
+
+    /* Passed through as a copy, with the checksum completed */
+    len = tcp_packet(buf, 4, 0, SEQ, TCP_ACK, 0, 100);
+    gso_vnet_hdr(&vnet_hdr, 4, 40, 0);
+    vnet_hdr.gso_type = OGS_TUN_VNET_HDR_GSO_NONE;
+
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_tun_gso_init(&gso, buf, len, &vnet_hdr));
+    pkbuf = ogs_tun_gso_next(&gso, NULL);
+    ABTS_PTR_NOTNULL(tc, pkbuf);
+    ABTS_TRUE(tc, pkbuf->data != buf);
+    ABTS_INT_EQUAL(tc, len, pkbuf->len);
+    ABTS_TRUE(tc, tcp_csum_ok(pkbuf->data, pkbuf->len));
+    ABTS_TRUE(tc, memcmp(pkbuf->data, buf, 16) == 0);
+    ogs_pkbuf_free(pkbuf);
+    ABTS_PTR_EQUAL(tc, NULL, ogs_tun_gso_next(&gso, NULL));
+
+    /* Without NEEDS_CSUM the packet is copied untouched */
+    vnet_hdr.flags = 0;
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_tun_gso_init(&gso, buf, len, &vnet_hdr));
+    pkbuf = ogs_tun_gso_next(&gso, NULL);
+    ABTS_PTR_NOTNULL(tc, pkbuf);
+    ABTS_INT_EQUAL(tc, len, pkbuf->len);
+    ABTS_TRUE(tc, memcmp(pkbuf->data, buf, len) == 0);
+    ogs_pkbuf_free(pkbuf);
+    ABTS_PTR_EQUAL(tc, NULL, ogs_tun_gso_next(&gso, NULL));
+
+    /* Checksum outside of the packet */
+    gso_vnet_hdr(&vnet_hdr, 4, 40, 0);
+    vnet_hdr.gso_type = OGS_TUN_VNET_HDR_GSO_NONE;
+    vnet_hdr.csum_start = len;
+    ABTS_INT_EQUAL(tc, OGS_ERROR,
+            ogs_tun_gso_init(&gso, buf, len, &vnet_hdr));
+
+    /* GSO type does not match the IP version */
+    gso_vnet_hdr(&vnet_hdr, 6, 40, 1000);
+    ABTS_INT_EQUAL(tc, OGS_ERROR,
+            ogs_tun_gso_init(&gso, buf, len, &vnet_hdr));
+
+    /* No gso_size */
+    gso_vnet_hdr(&vnet_hdr, 4, 40, 0);
+    ABTS_INT_EQUAL(tc, OGS_ERROR,
+            ogs_tun_gso_init(&gso, buf, len, &vnet_hdr));
+
+    /* Empty */
+    gso_vnet_hdr(&vnet_hdr, 4, 40, 1000);
+    ABTS_INT_EQUAL(tc, OGS_ERROR,
+            ogs_tun_gso_init(&gso, buf, 0, &vnet_hdr));
+}
+
+static void tun_gso_test3(abts_case *tc, void *data)
+{
+    static uint8_t buf[sizeof(ogs_tun_vnet_hdr_t) + OGS_TUN_MAX_GSO_LEN];
+    ogs_tun_vnet_hdr_t vnet_hdr, *sent = (ogs_tun_vnet_hdr_t *)buf;
+    uint8_t *packet = NULL, *first = NULL;
+    int fd[2];
+    int len, n;
+
+    ABTS_INT_EQUAL(tc, 0, socketpair(AF_UNIX, SOCK_DGRAM, 0, fd));
+
+    /* Super-packets are read into the same buffer of this thread */
+    for (n = 0; n < 2; n++) {
+        len = tcp_packet(buf + sizeof(*sent), 4, 0, SEQ + n, TCP_ACK, 0,
+                OGS_TUN_MAX_GSO_LEN - 40);
+        gso_vnet_hdr(sent, 4, 40, 1448);
+        ABTS_INT_EQUAL(tc, sizeof(*sent) + len,
+                write(fd[1], buf, sizeof(*sent) + len));
+
+        ABTS_INT_EQUAL(tc, len,
+                ogs_tun_read_offload(fd[0], &vnet_hdr, &packet));
+        ABTS_TRUE(tc, memcmp(&vnet_hdr, sent, sizeof(vnet_hdr)) == 0);
+        ABTS_TRUE(tc, memcmp(packet, buf + sizeof(*sent), len) == 0);
+
+        if (!first)
+            first = packet;
+        ABTS_PTR_EQUAL(tc, first, packet);
+    }
+
+    close(fd[0]);
+    close(fd[1]);
+}
+
+static ogs_pkbuf_t *gro_pkbuf(int version, uint32_t seq, uint8_t flags,
+        int payload_offset, int payload)
+{
+    ogs_pkbuf_t *pkbuf = NULL;
+
+    pkbuf = ogs_pkbuf_alloc(NULL, OGS_TUN_MAX_HEADROOM + OGS_MAX_PKT_LEN);
+    ogs_assert(pkbuf);
+    ogs_pkbuf_reserve(pkbuf, OGS_TUN_MAX_HEADROOM);
+    ogs_pkbuf_put(pkbuf, tcp_packet(pkbuf->data, version, 0,
+                seq, flags, payload_offset, payload));
+
+    return pkbuf;
+}
+
+/* Read one write back and check the vnet header and the payload */
+static int gro_read(abts_case *tc, int fd,
+        int gso_size, uint8_t flags, int payload)
+{
+    static uint8_t buf[sizeof(ogs_tun_vnet_hdr_t) + OGS_TUN_MAX_GSO_LEN];
+    ogs_tun_vnet_hdr_t *vnet_hdr = (ogs_tun_vnet_hdr_t *)buf;
+    uint8_t *ip = buf + sizeof(*vnet_hdr);
+    int off, n, i;
+
+    n = read(fd, buf, sizeof(buf));
+    ABTS_TRUE(tc, n > (int)sizeof(*vnet_hdr));
+    if (n <= (int)sizeof(*vnet_hdr))
+        return 0;
+    n -= sizeof(*vnet_hdr);
+    off = l4_offset(ip);
+
+    ABTS_INT_EQUAL(tc, off + 20 + payload, n);
+    ABTS_INT_EQUAL(tc, flags, ip[off + 13]);
+    if ((ip[0] >> 4) == 4) {
+        ABTS_INT_EQUAL(tc, n, get16(ip + 2));
+        ABTS_INT_EQUAL(tc, 0xffff, fold(sum16(0, ip, 20)));
+    } else {
+        ABTS_INT_EQUAL(tc, n - 40, get16(ip + 4));
+    }
+    for (i = 0; i < payload; i++)
+        if (ip[off + 20 + i] != payload_byte(i))
+            break;
+    ABTS_INT_EQUAL(tc, payload, i);
+
+    if (!gso_size) {
+        ABTS_INT_EQUAL(tc, 0, vnet_hdr->flags);
+        ABTS_INT_EQUAL(tc, OGS_TUN_VNET_HDR_GSO_NONE, vnet_hdr->gso_type);
+        return n;
+    }
+
+    /* The kernel completes the checksum from the pseudo header sum */
+    ABTS_INT_EQUAL(tc, OGS_TUN_VNET_HDR_F_NEEDS_CSUM, vnet_hdr->flags);
+    ABTS_INT_EQUAL(tc, (ip[0] >> 4) == 4 ?
+            OGS_TUN_VNET_HDR_GSO_TCPV4 : OGS_TUN_VNET_HDR_GSO_TCPV6,
+            vnet_hdr->gso_type);
+    ABTS_INT_EQUAL(tc, off + 20, vnet_hdr->hdr_len);
+    ABTS_INT_EQUAL(tc, gso_size, vnet_hdr->gso_size);
+    ABTS_INT_EQUAL(tc, off, vnet_hdr->csum_start);
+    ABTS_INT_EQUAL(tc, 16, vnet_hdr->csum_offset);
+    ABTS_INT_EQUAL(tc, fold(pseudo(ip, n)), get16(ip + off + 16));
+
+    return n;
+}
+
+static void tun_gro_test1(abts_case *tc, void *data)
+{
+    ogs_tun_gro_t gro;
+    int fd[2], version, i;
+    uint8_t buf[1];
+
+    ABTS_INT_EQUAL(tc, 0, socketpair(AF_UNIX, SOCK_DGRAM, 0, fd));
+    ABTS_INT_EQUAL(tc, 0, fcntl(fd[0], F_SETFL, O_NONBLOCK));
+    memset(&gro, 0, sizeof(gro));
+
+    for (version = 4; version <= 6; version += 2) {
+        /* Written out by the pushed segment */
+        for (i = 0; i < 3; i++) {
+            ABTS_INT_EQUAL(tc, OGS_OK, ogs_tun_gro_write(&gro, fd[1],
+                        gro_pkbuf(version, SEQ + i * 1000,
+                            i == 2 ? TCP_ACK|TCP_PSH : TCP_ACK,
+                            i * 1000, 1000)));
+            ABTS_INT_EQUAL(tc, i == 2 ? 0 : i + 1, gro.num_of_seg);
+        }
+        gro_read(tc, fd[0], 1000, TCP_ACK|TCP_PSH, 3000);
+
+        /* Written out by the short segment */
+        ABTS_INT_EQUAL(tc, OGS_OK, ogs_tun_gro_write(&gro, fd[1],
+                    gro_pkbuf(version, SEQ, TCP_ACK, 0, 1000)));
+        ABTS_INT_EQUAL(tc, OGS_OK, ogs_tun_gro_write(&gro, fd[1],
+                    gro_pkbuf(version, SEQ + 1000, TCP_ACK, 1000, 500)));
+        ABTS_INT_EQUAL(tc, 0, gro.num_of_seg);
+        gro_read(tc, fd[0], 1000, TCP_ACK, 1500);
+    }
+
+    /* A sequence gap flushes the first segment on its own */
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_tun_gro_write(&gro, fd[1],
+                gro_pkbuf(4, SEQ, TCP_ACK, 0, 1000)));
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_tun_gro_write(&gro, fd[1],
+                gro_pkbuf(4, SEQ + 999, TCP_ACK, 0, 1000)));
+    ABTS_INT_EQUAL(tc, 1, gro.num_of_seg);
+    gro_read(tc, fd[0], 0, TCP_ACK, 1000);
+
+    /* So does a different IP version, and the pending one waits */
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_tun_gro_write(&gro, fd[1],
+                gro_pkbuf(6, SEQ + 1999, TCP_ACK, 0, 1000)));
+    ABTS_INT_EQUAL(tc, 1, gro.num_of_seg);
+    gro_read(tc, fd[0], 0, TCP_ACK, 1000);
+    ABTS_INT_EQUAL(tc, -1, read(fd[0], buf, sizeof(buf)));
+
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_tun_gro_flush(&gro));
+    ABTS_INT_EQUAL(tc, 0, gro.num_of_seg);
+    gro_read(tc, fd[0], 0, TCP_ACK, 1000);
+
+    /* A FIN is never coalesced and goes out after the pending ones */
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_tun_gro_write(&gro, fd[1],
+                gro_pkbuf(4, SEQ, TCP_ACK, 0, 1000)));
+    ABTS_INT_EQUAL(tc, OGS_OK, ogs_tun_gro_write(&gro, fd[1],
+                gro_pkbuf(4, SEQ + 1000, TCP_ACK|TCP_FIN, 0, 1000)));
+    ABTS_INT_EQUAL(tc, 0, gro.num_of_seg);
+    gro_read(tc, fd[0], 0, TCP_ACK, 1000);
+    gro_read(tc, fd[0], 0, TCP_ACK|TCP_FIN, 1000);
+    ABTS_INT_EQUAL(tc, -1, read(fd[0], buf, sizeof(buf)));
+
+    close(fd[0]);
+    close(fd[1]);
+}
+
+#endif
+
+abts_suite *test_tun(abts_suite *suite)
+{
+    suite = ADD_SUITE(suite)
+
+#if defined(__linux__)
+    abts_run_test(suite, tun_gso_test1, NULL);
+    abts_run_test(suite, tun_gso_test2, NULL);
+    abts_run_test(suite, tun_gso_test3, NULL);
+    abts_run_test(suite, tun_gro_test1, NULL);
+#endif
+
+    return suite;
+}
@@ -0,0 +1,325 @@
+/*
+ * Copyright (C) 2019-2023 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "context.h"
+#include "core/abts.h"
+
+#define NUM_OF_PACKET 100
+#define PACKET_LEN 100
+#define THRESHOLD 1000
+
+/* The SMF receiving the Session Report Requests */
+static struct {
+    ogs_sock_t *sock;
+    ogs_sock_t *upf_sock;
+    ogs_pfcp_node_t *node;
+} smf;
+
+static upf_sess_t *sess;
+static ogs_pfcp_urr_t *urr;
+
+/* Reports seen after each packet */
+static struct {
+    int num_of_report;
+    int packet[NUM_OF_PACKET];          /* the last packet counted */
+    uint64_t total_volume[NUM_OF_PACKET];
+} result;
+
+static ogs_sockaddr_t *udp_bind(ogs_sock_t **sock, const char *addr)
+{
+    ogs_sockaddr_t *sa = NULL;
+    socklen_t addrlen;
+
+    ogs_assert(OGS_OK == ogs_getaddrinfo(&sa, AF_INET, addr, 0, 0));
+    *sock = ogs_sock_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    ogs_assert(*sock);
+    ogs_assert(OGS_OK == ogs_sock_bind(*sock, sa));
+
+    /* Port 0 was bound, find out which one the kernel chose */
+    addrlen = sizeof(sa->ss);
+    ogs_assert(getsockname((*sock)->fd, &sa->sa, &addrlen) == 0);
+
+    return sa;
+}
+
+static void upf_urr_init(void)
+{
+    ogs_sockaddr_t *addr = NULL;
+    ogs_pfcp_f_seid_t f_seid;
+
+    ogs_app()->pool.sess = 16;
+    ogs_app()->pool.nf = 8;
+    ogs_app()->pool.gtp_node = 8;
+    ogs_app()->pool.xact = 64;
+
+    /* The reports are never answered nor retransmitted here */
+    ogs_local_conf()->time.message.pfcp.n1_response_rcount = 3;
+    ogs_local_conf()->time.message.pfcp.t1_response_duration =
+        ogs_time_from_sec(3);
+
+    ogs_app()->timer_mgr = ogs_timer_mgr_create(64);
+    ogs_assert(ogs_app()->timer_mgr);
+
+    upf_metrics_init();
+    ogs_gtp_context_init(OGS_MAX_NUM_OF_GTPU_RESOURCE);
+    ogs_pfcp_context_init();
+    ogs_pfcp_xact_init();
+    upf_context_init();
+
+    addr = udp_bind(&smf.sock, "127.0.0.4");
+    ogs_freeaddrinfo(udp_bind(&smf.upf_sock, "127.0.0.7"));
+
+    smf.node = ogs_pfcp_node_add(&ogs_pfcp_self()->pfcp_peer_list, addr);
+    ogs_assert(smf.node);
+    smf.node->sock = smf.upf_sock;
+    ogs_freeaddrinfo(addr);
+
+    memset(&f_seid, 0, sizeof(f_seid));
+    f_seid.ipv4 = 1;
+    f_seid.seid = 1;
+    f_seid.addr = inet_addr("127.0.0.4");
+
+    sess = upf_sess_add(&f_seid);
+    ogs_assert(sess);
+    sess->pfcp_node = smf.node;
+
+    urr = ogs_pfcp_urr_add(&sess->pfcp);
+    ogs_assert(urr);
+    urr->rep_triggers.volume_threshold = 1;
+    urr->vol_threshold.tovol = 1;
+    urr->vol_threshold.total_volume = THRESHOLD;
+
+    memset(&result, 0, sizeof(result));
+}
+
+static void upf_urr_final(void)
+{
+    upf_sess_remove(sess);
+    sess = NULL;
+
+    upf_context_final();
+    ogs_pfcp_context_final();
+    ogs_pfcp_xact_final();
+    ogs_gtp_context_final();
+    upf_metrics_final();
+
+    ogs_sock_destroy(smf.sock);
+    ogs_sock_destroy(smf.upf_sock);
+
+    ogs_timer_mgr_destroy(ogs_app()->timer_mgr);
+    ogs_app()->timer_mgr = NULL;
+}
+
+/* Session Report Requests waiting at the SMF */
+static int smf_recv(void)
+{
+    ogs_pkbuf_t *pkbuf = NULL;
+    ogs_pfcp_message_t *message = NULL;
+    ssize_t size;
+    int count = 0;
+
+    while (1) {
+        pkbuf = ogs_pkbuf_alloc(NULL, OGS_MAX_SDU_LEN);
+        ogs_assert(pkbuf);
+        ogs_pkbuf_put(pkbuf, OGS_MAX_SDU_LEN);
+
+        size = recv(smf.sock->fd, pkbuf->data, pkbuf->len, MSG_DONTWAIT);
+        if (size <= 0) {
+            ogs_pkbuf_free(pkbuf);
+            break;
+        }
+        ogs_pkbuf_trim(pkbuf, size);
+
+        message = ogs_pfcp_parse_msg(pkbuf);
+        ogs_assert(message);
+        ogs_assert(message->h.type == OGS_PFCP_SESSION_REPORT_REQUEST_TYPE);
+        ogs_assert(message->pfcp_session_report_request.
+                usage_report[0].presence);
+        count++;
+
+        ogs_pfcp_message_free(message);
+        ogs_pkbuf_free(pkbuf);
+    }
+
+    return count;
+}
+
+/*
+ * One poll iteration of the data plane, receiving 'batch' packets
+ * from 'first'. A batch of one is the check after every packet.
+ */
+static void recv_batch(int first, int batch)
+{
+    upf_sess_urr_acc_t *urr_acc = &sess->urr_acc[urr->id];
+    int i;
+
+    upf_sess_dp_clock_reset();
+    upf_sess_urr_acc_batch_begin();
+
+    for (i = first; i < first + batch && i < NUM_OF_PACKET; i++)
+        upf_sess_urr_acc_add(sess, urr, PACKET_LEN, true);
+
+    upf_sess_urr_acc_batch_end();
+
+    if (urr_acc->report_seqn != result.num_of_report) {
+        ogs_assert(urr_acc->report_seqn == result.num_of_report + 1);
+
+        result.packet[result.num_of_report] = i - 1;
+        result.total_volume[result.num_of_report] =
+            urr_acc->last_report.total_octets;
+        result.num_of_report++;
+    }
+}
+
+static void run(int batch)
+{
+    int i;
+
+    for (i = 0; i < NUM_OF_PACKET; i += batch)
+        recv_batch(i, batch);
+}
+
+static void upf_urr_test1(abts_case *tc, void *data)
+{
+    int i;
+
+    /* The check after every packet : 10 packets reach the threshold */
+    upf_urr_init();
+
+    run(1);
+
+    ABTS_INT_EQUAL(tc, 10, result.num_of_report);
+    for (i = 0; i < result.num_of_report; i++) {
+        ABTS_INT_EQUAL(tc, (i + 1) * 10 - 1, result.packet[i]);
+        ABTS_TRUE(tc, (i + 1) * THRESHOLD == result.total_volume[i]);
+    }
+    ABTS_INT_EQUAL(tc, result.num_of_report, smf_recv());
+
+    upf_urr_final();
+}
+
+static void upf_urr_test2(abts_case *tc, void *data)
+{
+    int i;
+
+    /*
+     * The check at the end of a batch ending with the packet
+     * reaching the threshold : the same reports on the same packets
+     */
+    upf_urr_init();
+
+    run(5);
+
+    ABTS_INT_EQUAL(tc, 10, result.num_of_report);
+    for (i = 0; i < result.num_of_report; i++) {
+        ABTS_INT_EQUAL(tc, (i + 1) * 10 - 1, result.packet[i]);
+        ABTS_TRUE(tc, (i + 1) * THRESHOLD == result.total_volume[i]);
+    }
+    ABTS_INT_EQUAL(tc, result.num_of_report, smf_recv());
+
+    upf_urr_final();
+}
+
+static void upf_urr_test3(abts_case *tc, void *data)
+{
+    uint64_t volume = 0, last = 0;
+    int i, expected = 0;
+
+    /*
+     * Any other batch : the report comes at the end of the batch
+     * holding the packet that reached the threshold, and counts
+     * the whole batch. Nothing is reported a batch early or late.
+     */
+    upf_urr_init();
+
+    run(OGS_MAX_NUM_OF_SOCKMSG);
+
+    for (i = 0; i < NUM_OF_PACKET; i++) {
+        volume += PACKET_LEN;
+        if (volume - last >= THRESHOLD &&
+            (i % OGS_MAX_NUM_OF_SOCKMSG == OGS_MAX_NUM_OF_SOCKMSG - 1 ||
+             i == NUM_OF_PACKET - 1)) {
+            ABTS_INT_EQUAL(tc, i, result.packet[expected]);
+            ABTS_TRUE(tc, volume == result.total_volume[expected]);
+            last = volume;
+            expected++;
+        }
+    }
+    ABTS_INT_EQUAL(tc, expected, result.num_of_report);
+    ABTS_INT_EQUAL(tc, result.num_of_report, smf_recv());
+
+    upf_urr_final();
+}
+
+static void upf_urr_test4(abts_case *tc, void *data)
+{
+    upf_sess_urr_acc_t *urr_acc = NULL;
+    ogs_time_t before, after, first;
+    uint32_t time_start;
+
+    /*
+     * The packets of one poll iteration share one timestamp,
+     * and the report starts the next period within that iteration.
+     */
+    upf_urr_init();
+    urr_acc = &sess->urr_acc[urr->id];
+
+    before = ogs_time_now();
+    recv_batch(0, 5);
+    after = ogs_time_now();
+
+    ABTS_INT_EQUAL(tc, 0, result.num_of_report);
+    ABTS_TRUE(tc, urr_acc->time_of_first_packet >= before);
+    ABTS_TRUE(tc, urr_acc->time_of_first_packet <= after);
+    ABTS_TRUE(tc,
+            urr_acc->time_of_last_packet == urr_acc->time_of_first_packet);
+    first = urr_acc->time_of_first_packet;
+
+    /* A new poll iteration reads the clock again */
+    ogs_msleep(2);
+
+    before = ogs_time_now();
+    recv_batch(5, 5);
+    time_start = ogs_time_ntp32_now();
+    after = ogs_time_now();
+
+    ABTS_INT_EQUAL(tc, 1, result.num_of_report);
+    ABTS_TRUE(tc, urr_acc->time_of_first_packet == first);
+    ABTS_TRUE(tc, urr_acc->time_of_last_packet >= before);
+    ABTS_TRUE(tc, urr_acc->time_of_last_packet <= after);
+    ABTS_TRUE(tc, urr_acc->last_report.timestamp >= before);
+    ABTS_TRUE(tc, urr_acc->last_report.timestamp <= after);
+    ABTS_TRUE(tc, urr_acc->time_start <= time_start);
+    ABTS_TRUE(tc, urr_acc->time_start + 1 >= time_start);
+    ABTS_INT_EQUAL(tc, 1, smf_recv());
+
+    upf_urr_final();
+}
+
+abts_suite *test_upf_urr(abts_suite *suite)
+{
+    suite = ADD_SUITE(suite)
+
+    abts_run_test(suite, upf_urr_test1, NULL);
+    abts_run_test(suite, upf_urr_test2, NULL);
+    abts_run_test(suite, upf_urr_test3, NULL);
+    abts_run_test(suite, upf_urr_test4, NULL);
+
+    return suite;
+}
@@ -0,0 +1,451 @@
+/*
+ * Copyright (C) 2019-2023 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "context.h"
+
+#if HAVE_NETINET_IP_H
+#include <netinet/ip.h>
+#endif
+
+#include <poll.h>
+
+#include "gtp-path.h"
+#include "worker.h"
+#include "core/abts.h"
+
+#define NUM_OF_WORKER 2
+
+#define UPF_GTPU_ADDR "127.0.0.7"
+#define GNB_GTPU_ADDR "127.0.0.2"
+#define UE_ADDR "10.45.0.2"
+
+/* Uplink TEIDs, steered to worker 0 and worker 1 */
+#define UL_TEID 0x100
+
+#define GPDU_LEN (OGS_GTPV1U_HEADER_LEN + 28)
+
+/* The gNB : sends to the UPF and receives what the UPF forwards back */
+static struct {
+    ogs_sock_t *sock;
+    ogs_sockaddr_t *upf_addr;
+} gnb;
+
+static struct {
+    int echo;
+    int gpdu;
+    int err_ind;
+    uint32_t teid;      /* of the last G-PDU */
+} recv_stat;
+
+static ogs_pfcp_ue_ip_t ue_ip;
+
+static void upf_worker_init(int mmsg_batch)
+{
+    ogs_sockaddr_t *addr = NULL;
+    ogs_sockopt_t option;
+
+    ogs_app()->pool.sess = 16;
+    ogs_app()->pool.nf = 8;
+    ogs_app()->pool.gtp_node = 8;
+    ogs_app()->pool.packet = 1024;
+
+    /* Workers wake up the main loop for deferred reports */
+    ogs_app()->pollset = ogs_pollset_create(16);
+    ogs_assert(ogs_app()->pollset);
+
+    upf_metrics_init();
+    ogs_gtp_context_init(OGS_MAX_NUM_OF_GTPU_RESOURCE);
+    ogs_pfcp_context_init();
+    upf_context_init();
+    ogs_assert(OGS_OK == upf_gtp_init());
+
+    /* A G-PDU with an unknown TEID is answered with an Error Indication */
+    ogs_pfcp_self()->local_recovery = 0;
+
+    upf_self()->num_of_worker = NUM_OF_WORKER;
+    ogs_gtp_self()->gtpu_port = OGS_GTPV1_U_UDP_PORT;
+
+    ogs_sockopt_init(&option);
+    option.mmsg_batch = mmsg_batch;
+
+    ogs_assert(OGS_OK == ogs_getaddrinfo(&addr, AF_INET,
+                UPF_GTPU_ADDR, OGS_GTPV1_U_UDP_PORT, 0));
+    ogs_assert(ogs_socknode_add(
+                &ogs_gtp_self()->gtpu_list, AF_INET, addr, &option));
+    ogs_freeaddrinfo(addr);
+
+    ogs_assert(OGS_OK == upf_gtp_open());
+    ogs_assert(OGS_OK == upf_worker_open());
+
+    ogs_assert(OGS_OK == ogs_getaddrinfo(&gnb.upf_addr, AF_INET,
+                UPF_GTPU_ADDR, OGS_GTPV1_U_UDP_PORT, 0));
+    ogs_assert(OGS_OK == ogs_getaddrinfo(&addr, AF_INET,
+                GNB_GTPU_ADDR, OGS_GTPV1_U_UDP_PORT, 0));
+    gnb.sock = ogs_sock_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    ogs_assert(gnb.sock);
+    ogs_assert(OGS_OK == ogs_sock_bind(gnb.sock, addr));
+    ogs_freeaddrinfo(addr);
+
+    memset(&recv_stat, 0, sizeof(recv_stat));
+}
+
+static void upf_worker_final(void)
+{
+    ogs_sock_destroy(gnb.sock);
+    ogs_freeaddrinfo(gnb.upf_addr);
+
+    upf_worker_close();
+    upf_gtp_close();
+
+    upf_context_final();
+    ogs_pfcp_context_final();
+    ogs_gtp_context_final();
+
+    upf_gtp_final();
+    upf_metrics_final();
+
+    ogs_pollset_destroy(ogs_app()->pollset);
+    ogs_app()->pollset = NULL;
+}
+
+static void gnb_send(uint8_t type, uint32_t teid)
+{
+    uint8_t buf[GPDU_LEN];
+    ogs_gtp2_header_t *gtp_h = (ogs_gtp2_header_t *)buf;
+    struct ip *ip_h = (struct ip *)(buf + OGS_GTPV1U_HEADER_LEN);
+    int len;
+
+    memset(buf, 0, sizeof(buf));
+    gtp_h->flags = OGS_GTPU_FLAGS_V|OGS_GTPU_FLAGS_PT;
+    gtp_h->type = type;
+    gtp_h->teid = htobe32(teid);
+
+    if (type == OGS_GTPU_MSGTYPE_ECHO_REQ) {
+        /* Sequence Number, N-PDU Number and Next Extension Header */
+        gtp_h->flags |= OGS_GTPU_FLAGS_S;
+        len = OGS_GTPV1U_HEADER_LEN + 4;
+    } else {
+        /* An IPv4/UDP packet from the UE */
+        ip_h->ip_v = 4;
+        ip_h->ip_hl = 5;
+        ip_h->ip_len = htobe16(GPDU_LEN - OGS_GTPV1U_HEADER_LEN);
+        ip_h->ip_ttl = 64;
+        ip_h->ip_p = IPPROTO_UDP;
+        ip_h->ip_src.s_addr = inet_addr(UE_ADDR);
+        ip_h->ip_dst.s_addr = inet_addr("10.45.0.1");
+        len = GPDU_LEN;
+    }
+    gtp_h->length = htobe16(len - OGS_GTPV1U_HEADER_LEN);
+
+    ogs_assert(ogs_sendto(gnb.sock->fd, buf, len, 0, gnb.upf_addr) == len);
+}
+
+/*
+ * Receive until 'echo' Echo Responses came or nothing came for 'msec'.
+ * A worker handles its packets in order, so an Echo Response
+ * also tells everything sent before with the same TEID was handled.
+ */
+static void gnb_recv(int echo, int msec)
+{
+    uint8_t buf[OGS_MAX_PKT_LEN];
+    ogs_gtp2_header_t *gtp_h = (ogs_gtp2_header_t *)buf;
+    struct pollfd pfd;
+    ssize_t size;
+
+    while (recv_stat.echo < echo) {
+        pfd.fd = gnb.sock->fd;
+        pfd.events = POLLIN;
+        if (poll(&pfd, 1, msec) <= 0)
+            break;
+
+        size = recv(gnb.sock->fd, buf, sizeof(buf), 0);
+        ogs_assert(size >= OGS_GTPV1U_HEADER_LEN);
+
+        if (gtp_h->type == OGS_GTPU_MSGTYPE_ECHO_RSP) {
+            recv_stat.echo++;
+        } else if (gtp_h->type == OGS_GTPU_MSGTYPE_GPDU) {
+            recv_stat.gpdu++;
+            recv_stat.teid = be32toh(gtp_h->teid);
+        } else if (gtp_h->type == OGS_GTPU_MSGTYPE_ERR_IND) {
+            recv_stat.err_ind++;
+        }
+    }
+}
+
+/* Both uplink TEIDs, i.e. both workers */
+static void gnb_barrier(void)
+{
+    memset(&recv_stat, 0, sizeof(recv_stat));
+
+    gnb_send(OGS_GTPU_MSGTYPE_ECHO_REQ, UL_TEID);
+    gnb_send(OGS_GTPU_MSGTYPE_ECHO_REQ, UL_TEID + 1);
+    gnb_recv(2, 1000);
+}
+
+/*
+ * A session with two uplink PDRs, one for each worker.
+ * Both forward back to the gNB, i.e. an indirect tunnel.
+ */
+static upf_sess_t *sess_add(uint32_t dl_teid, bool gate_closed)
+{
+    ogs_pfcp_f_seid_t f_seid;
+    upf_sess_t *sess = NULL;
+    ogs_pfcp_pdr_t *pdr = NULL;
+    ogs_pfcp_far_t *far = NULL;
+    ogs_pfcp_qer_t *qer = NULL;
+    int i;
+
+    memset(&f_seid, 0, sizeof(f_seid));
+    f_seid.ipv4 = 1;
+    f_seid.seid = dl_teid;
+    f_seid.addr = inet_addr("127.0.0.4");
+
+    sess = upf_sess_add(&f_seid);
+    ogs_assert(sess);
+
+    /* Without the UE address, no uplink packet is handled */
+    ue_ip.addr[0] = inet_addr(UE_ADDR);
+    sess->ipv4 = &ue_ip;
+
+    far = ogs_pfcp_far_add(&sess->pfcp);
+    ogs_assert(far);
+    far->dst_if = OGS_PFCP_INTERFACE_ACCESS;
+    far->apply_action = OGS_PFCP_APPLY_ACTION_FORW;
+    far->outer_header_creation.gtpu4 = 1;
+    far->outer_header_creation.addr = inet_addr(GNB_GTPU_ADDR);
+    far->outer_header_creation.teid = dl_teid;
+    ogs_assert(OGS_OK == ogs_pfcp_setup_far_gtpu_node(far));
+
+    if (gate_closed) {
+        qer = ogs_pfcp_qer_add(&sess->pfcp);
+        ogs_assert(qer);
+        qer->gate_status.uplink = OGS_PFCP_GATE_CLOSE;
+    }
+
+    for (i = 0; i < NUM_OF_WORKER; i++) {
+        pdr = ogs_pfcp_pdr_add(&sess->pfcp);
+        ogs_assert(pdr);
+        pdr->src_if = OGS_PFCP_INTERFACE_ACCESS;
+        pdr->f_teid.ipv4 = 1;
+        pdr->f_teid.teid = UL_TEID + i;
+        ogs_pfcp_object_teid_hash_set(OGS_PFCP_OBJ_SESS_TYPE, pdr, false);
+
+        ogs_pfcp_pdr_associate_far(pdr, far);
+        if (qer)
+            ogs_pfcp_pdr_associate_qer(pdr, qer);
+    }
+
+    return sess;
+}
+
+static void sess_remove(upf_sess_t *sess)
+{
+    /* Not allocated from the UE IP pool */
+    sess->ipv4 = NULL;
+    upf_sess_remove(sess);
+}
+
+static void upf_worker_test1(abts_case *tc, void *data)
+{
+    int i, round;
+
+    /* Start and stop the workers, with and without recvmmsg() */
+    for (round = 0; round < 4; round++) {
+        upf_worker_init(round % 2 ? OGS_MAX_NUM_OF_SOCKMSG : 0);
+
+        /* The main thread is never taken for a worker */
+        ABTS_PTR_EQUAL(tc, NULL, upf_worker_self());
+
+        for (i = 0; i < 4; i++)
+            gnb_send(OGS_GTPU_MSGTYPE_ECHO_REQ, i);
+        gnb_recv(4, 1000);
+        ABTS_INT_EQUAL(tc, 4, recv_stat.echo);
+
+        upf_worker_final();
+    }
+}
+
+static void upf_worker_test2(abts_case *tc, void *data)
+{
+    /* No worker handles a packet while the main thread holds them all */
+    upf_worker_init(0);
+
+    upf_worker_lock_all();
+
+    gnb_send(OGS_GTPU_MSGTYPE_ECHO_REQ, UL_TEID);
+    gnb_send(OGS_GTPU_MSGTYPE_ECHO_REQ, UL_TEID + 1);
+    gnb_recv(2, 100);
+    ABTS_INT_EQUAL(tc, 0, recv_stat.echo);
+
+    upf_worker_unlock_all();
+
+    gnb_recv(2, 1000);
+    ABTS_INT_EQUAL(tc, 2, recv_stat.echo);
+
+    upf_worker_final();
+}
+
+static volatile bool sender_stop;
+
+static void sender_main(void *data)
+{
+    while (!sender_stop) {
+        gnb_send(OGS_GTPU_MSGTYPE_GPDU, UL_TEID);
+        gnb_send(OGS_GTPU_MSGTYPE_GPDU, UL_TEID + 1);
+        ogs_usleep(50);
+    }
+}
+
+static void upf_worker_test3(abts_case *tc, void *data)
+{
+    ogs_thread_t *sender = NULL;
+    upf_sess_t *sess = NULL;
+    int i;
+
+    /*
+     * The session is replaced over and over under traffic. As the
+     * workers never see the TEID table half-updated, no G-PDU is
+     * ever answered with an Error Indication.
+     */
+    upf_worker_init(OGS_MAX_NUM_OF_SOCKMSG);
+
+    upf_worker_lock_all();
+    sess = sess_add(0x1000, false);
+    upf_worker_unlock_all();
+
+    sender_stop = false;
+    sender = ogs_thread_create(sender_main, NULL);
+    ogs_assert(sender);
+
+    memset(&recv_stat, 0, sizeof(recv_stat));
+    for (i = 1; i <= 200; i++) {
+        upf_worker_lock_all();
+        sess_remove(sess);
+        sess = sess_add(0x1000 + i, false);
+        upf_worker_unlock_all();
+
+        ogs_usleep(500);
+        gnb_recv(1, 0);
+    }
+
+    sender_stop = true;
+    ogs_thread_destroy(sender);
+
+    ABTS_TRUE(tc, recv_stat.gpdu > 0);
+    ABTS_INT_EQUAL(tc, 0, recv_stat.err_ind);
+
+    /* Forwarded with the latest FAR */
+    gnb_barrier();
+    gnb_send(OGS_GTPU_MSGTYPE_GPDU, UL_TEID);
+    gnb_send(OGS_GTPU_MSGTYPE_GPDU, UL_TEID + 1);
+    gnb_barrier();
+    /* G-PDUs go out at the end of a batch, after the Echo Responses */
+    gnb_recv(3, 20);
+    ABTS_INT_EQUAL(tc, 2, recv_stat.echo);
+    ABTS_INT_EQUAL(tc, 2, recv_stat.gpdu);
+    ABTS_INT_EQUAL(tc, 0x1000 + 200, recv_stat.teid);
+
+    /* Removed, no longer forwarded */
+    upf_worker_lock_all();
+    sess_remove(sess);
+    upf_worker_unlock_all();
+
+    gnb_send(OGS_GTPU_MSGTYPE_GPDU, UL_TEID);
+    gnb_send(OGS_GTPU_MSGTYPE_GPDU, UL_TEID + 1);
+    gnb_barrier();
+    ABTS_INT_EQUAL(tc, 2, recv_stat.echo);
+    ABTS_INT_EQUAL(tc, 0, recv_stat.gpdu);
+    ABTS_INT_EQUAL(tc, 2, recv_stat.err_ind);
+
+    upf_worker_final();
+}
+
+static void upf_worker_test4(abts_case *tc, void *data)
+{
+    upf_sess_t *sess = NULL;
+    ogs_pfcp_qer_t *qer = NULL;
+    int i, j, count = 0;
+
+    /*
+     * Both workers drop into the same QER at the same time.
+     * The session mutex keeps every drop counted.
+     */
+    upf_worker_init(OGS_MAX_NUM_OF_SOCKMSG);
+
+    upf_worker_lock_all();
+    sess = sess_add(0x1000, true);
+    qer = ogs_list_first(&sess->pfcp.qer_list);
+    ogs_assert(qer);
+    upf_worker_unlock_all();
+
+    /* Paced by the barrier, so that no socket buffer overflows */
+    for (i = 0; i < 200; i++) {
+        for (j = 0; j < 64; j++) {
+            gnb_send(OGS_GTPU_MSGTYPE_GPDU, UL_TEID);
+            gnb_send(OGS_GTPU_MSGTYPE_GPDU, UL_TEID + 1);
+            count += 2;
+        }
+        gnb_barrier();
+        ABTS_INT_EQUAL(tc, 2, recv_stat.echo);
+    }
+
+    ABTS_INT_EQUAL(tc, count, qer->bucket.uplink.dropped_pkts);
+    ABTS_INT_EQUAL(tc, count * (GPDU_LEN - OGS_GTPV1U_HEADER_LEN),
+            qer->bucket.uplink.dropped_octets);
+
+    /* The QER is not touched by any worker while the session is held */
+    ogs_thread_mutex_lock(&sess->dp_mutex);
+
+    memset(&recv_stat, 0, sizeof(recv_stat));
+    gnb_send(OGS_GTPU_MSGTYPE_GPDU, UL_TEID);
+    gnb_send(OGS_GTPU_MSGTYPE_ECHO_REQ, UL_TEID + 1);
+    gnb_recv(1, 1000);
+
+    /* Worker 1 goes on while worker 0 waits for the session */
+    ABTS_INT_EQUAL(tc, 1, recv_stat.echo);
+
+    gnb_send(OGS_GTPU_MSGTYPE_GPDU, UL_TEID + 1);
+    gnb_barrier();
+    ABTS_INT_EQUAL(tc, 0, recv_stat.echo);
+    ABTS_INT_EQUAL(tc, count, qer->bucket.uplink.dropped_pkts);
+
+    ogs_thread_mutex_unlock(&sess->dp_mutex);
+
+    gnb_recv(2, 1000);
+    ABTS_INT_EQUAL(tc, 2, recv_stat.echo);
+    ABTS_INT_EQUAL(tc, count + 2, qer->bucket.uplink.dropped_pkts);
+
+    upf_worker_lock_all();
+    sess_remove(sess);
+    upf_worker_unlock_all();
+
+    upf_worker_final();
+}
+
+abts_suite *test_upf_worker(abts_suite *suite)
+{
+    suite = ADD_SUITE(suite)
+
+    abts_run_test(suite, upf_worker_test1, NULL);
+    abts_run_test(suite, upf_worker_test2, NULL);
+    abts_run_test(suite, upf_worker_test3, NULL);
+    abts_run_test(suite, upf_worker_test4, NULL);
+
+    return suite;
+}